@@ -226,6 +226,9 @@ acados_size_t dense_qp_qpoases_memory_calculate_size(void *config_, dense_qp_dim
     // size in bytes
     acados_size_t size = sizeof(dense_qp_qpoases_memory);
 
+    size += sizeof(Options);
+    make_int_multiple_of(8, &size);
+
     if (ns > 0)
     {
         dense_qp_stack_slacks_dims_upperbound(dims, &dims_stacked);
@@ -295,6 +298,10 @@ void *dense_qp_qpoases_memory_assign(void *config_, dense_qp_dims *dims, void *o
     mem = (dense_qp_qpoases_memory *) c_ptr;
     c_ptr += sizeof(dense_qp_qpoases_memory);
 
+    mem->options = c_ptr;
+    c_ptr += sizeof(Options);
+    align_char_to(8, &c_ptr);
+
     assert((size_t) c_ptr % 8 == 0 && "memory not 8-byte aligned!");
 
     if (ns > 0)
@@ -459,6 +466,7 @@ int dense_qp_qpoases(void *config_, dense_qp_in *qp_in, dense_qp_out *qp_out, vo
     double *dual_sol = memory->dual_sol;
     QProblemB *QPB = memory->QPB;
     QProblem *QP = memory->QP;
+    Options *options = memory->options;
     dense_qp_in *qp_stacked = memory->qp_stacked;
 
     // extract dense qp size
@@ -547,10 +555,9 @@ int dense_qp_qpoases(void *config_, dense_qp_in *qp_in, dense_qp_out *qp_out, vo
                 // QProblem_setPrintLevel(QP, PL_DEBUG_ITER);
                 if (opts->set_acado_opts)
                 {
-                    static Options options;
-                    Options_setToMPC(&options);
-                    options.terminationTolerance = opts->tolerance;
-                    QProblem_setOptions(QP, options);
+                    Options_setToMPC(options);
+                    options->terminationTolerance = opts->tolerance;
+                    QProblem_setOptions(QP, *options);
                 }
 
                 qpoases_status = (ns > 0) ?
@@ -580,10 +587,9 @@ int dense_qp_qpoases(void *config_, dense_qp_in *qp_in, dense_qp_out *qp_out, vo
                 // QProblemB_setPrintLevel(QPB, PL_DEBUG_ITER);
                 if (opts->set_acado_opts)
                 {
-                    static Options options;
-                    Options_setToMPC(&options);
-                    options.terminationTolerance = opts->tolerance;
-                    QProblem_setOptions(QP, options);
+                    Options_setToMPC(options);
+                    options->terminationTolerance = opts->tolerance;
+                    QProblemB_setOptions(QPB, *options);
                 }
                 QProblemB_init(QPB, H, g, d_lb, d_ub, &nwsr, &cputime);
                 memory->first_it = 0;
@@ -632,10 +638,9 @@ int dense_qp_qpoases(void *config_, dense_qp_in *qp_in, dense_qp_out *qp_out, vo
             {
                 if (opts->set_acado_opts)
                 {
-                    static Options options;
-                    Options_setToMPC(&options);
-                    options.terminationTolerance = opts->tolerance;
-                    QProblem_setOptions(QP, options);
+                    Options_setToMPC(options);
+                    options->terminationTolerance = opts->tolerance;
+                    QProblem_setOptions(QP, *options);
                 }
                 if (opts->warm_start)
                 {
@@ -678,10 +683,9 @@ int dense_qp_qpoases(void *config_, dense_qp_in *qp_in, dense_qp_out *qp_out, vo
             {
                 if (opts->set_acado_opts)
                 {
-                    static Options options;
-                    Options_setToMPC(&options);
-                    options.terminationTolerance = opts->tolerance;
-                    QProblemB_setOptions(QPB, options);
+                    Options_setToMPC(options);
+                    options->terminationTolerance = opts->tolerance;
+                    QProblemB_setOptions(QPB, *options);
                 }
                 if (opts->warm_start)
                 {
@@ -89,6 +89,7 @@ typedef struct dense_qp_qpoases_memory_
     double *dual_sol;
     void *QPB;       // NOTE(giaf): cast to QProblemB to use
     void *QP;        // NOTE(giaf): cast to QProblem to use
+    void *options;   // cast to Options to use; per instance, so that solvers can run concurrently
     double cputime;  // cputime of qpoases
     int nwsr;        // performed number of working set recalculations
     int first_it;    // to be used with hotstart
@@ -1208,6 +1208,12 @@ void ocp_nlp_opts_initialize_default(void *config_, void *dims_, void *opts_)
 #endif
     // printf("\nocp_nlp: openmp threads = %d\n", opts->num_threads);
 
+    opts->thread_pool_num_threads = 0;
+    opts->thread_pool_spin_count = ACADOS_THREAD_POOL_DEFAULT_SPIN_COUNT;
+    for (int i = 0; i < ACADOS_THREAD_POOL_MAX_THREADS; i++)
+        opts->thread_pool_cores[i] = -1;
+    opts->profiling_buffer_size = 100;
+
     opts->print_level = 0;
     opts->levenberg_marquardt = 0.0;
     opts->log_primal_step_norm = 0;
@@ -1378,6 +1384,42 @@ void ocp_nlp_opts_set(void *config_, void *opts_, const char *field, void* value
             int* num_threads = (int *) value;
             opts->num_threads = *num_threads;
         }
+        else if (!strcmp(field, "thread_pool_num_threads"))
+        {
+            int* thread_pool_num_threads = (int *) value;
+            if (*thread_pool_num_threads > ACADOS_THREAD_POOL_MAX_THREADS)
+            {
+                printf("\nerror: ocp_nlp_opts_set: thread_pool_num_threads must be <= %d, got %d.\n",
+                       ACADOS_THREAD_POOL_MAX_THREADS, *thread_pool_num_threads);
+                exit(1);
+            }
+#if !defined(ACADOS_WITH_THREAD_POOL)
+            if (*thread_pool_num_threads > 1)
+                printf("\nocp_nlp_opts_set: acados was compiled without ACADOS_WITH_THREAD_POOL, ignoring thread_pool_num_threads.\n");
+#endif
+            opts->thread_pool_num_threads = *thread_pool_num_threads;
+        }
+        else if (!strcmp(field, "thread_pool_cores"))
+        {
+            // array of length thread_pool_num_threads, set thread_pool_num_threads first
+            int* thread_pool_cores = (int *) value;
+            for (int i = 0; i < opts->thread_pool_num_threads; i++)
+                opts->thread_pool_cores[i] = thread_pool_cores[i];
+        }
+        else if (!strcmp(field, "thread_pool_spin_count"))
+        {
+            int* thread_pool_spin_count = (int *) value;
+            opts->thread_pool_spin_count = *thread_pool_spin_count;
+        }
+        else if (!strcmp(field, "profiling_buffer_size"))
+        {
+            int* profiling_buffer_size = (int *) value;
+#if !defined(ACADOS_WITH_PROFILING)
+            if (*profiling_buffer_size > 0)
+                printf("\nocp_nlp_opts_set: acados was compiled without ACADOS_WITH_PROFILING, ignoring profiling_buffer_size.\n");
+#endif
+            opts->profiling_buffer_size = *profiling_buffer_size;
+        }
         else if (!strcmp(field, "ext_qp_res"))
         {
             int* ext_qp_res = (int *) value;
@@ -1702,6 +1744,21 @@ void ocp_nlp_opts_set_at_stage(void *config_, void *opts_, int stage, const char
  * memory
  ************************************************/
 
+// size of the integrator guess of stage i: xdot and z for IRK, phi for GNSF
+static int ocp_nlp_sim_guess_size(ocp_nlp_config *config, ocp_nlp_dims *dims, int i)
+{
+    int size = dims->nx[i] + dims->nz[i];
+    if (i < dims->N)
+    {
+        int n_guesses;
+        config->dynamics[i]->dims_get(config->dynamics[i], dims->dynamics[i], "n_guesses", &n_guesses);
+        size = n_guesses > size ? n_guesses : size;
+    }
+    return size;
+}
+
+
+
 acados_size_t ocp_nlp_memory_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_opts *opts, ocp_nlp_in *nlp_in)
 {
     ocp_qp_xcond_solver_config *qp_solver = config->qp_solver;
@@ -1800,6 +1857,11 @@ acados_size_t ocp_nlp_memory_calculate_size(ocp_nlp_config *config, ocp_nlp_dims
     // timings
     size += sizeof(struct ocp_nlp_timings);
 
+#if defined(ACADOS_WITH_PROFILING)
+    if (opts->profiling_buffer_size > 0)
+        size += ocp_nlp_profiling_calculate_size(N, opts->profiling_buffer_size);
+#endif
+
     size += (N+1)*sizeof(bool); // set_sim_guess
     // primal step norm
     if (opts->log_primal_step_norm)
@@ -1824,7 +1886,7 @@ acados_size_t ocp_nlp_memory_calculate_size(ocp_nlp_config *config, ocp_nlp_dims
         size += 1*blasfeo_memsize_dvec(nu[i] + nx[i]);  // dyn_adj
         size += 1*blasfeo_memsize_dvec(nx[i + 1]);       // dyn_fun
         size += 1*blasfeo_memsize_dvec(2 * ni[i]);       // ineq_fun
-        size += 1*blasfeo_memsize_dvec(nx[i] + nz[i]); // sim_guess
+        size += 1*blasfeo_memsize_dvec(ocp_nlp_sim_guess_size(config, dims, i)); // sim_guess
     }
     size += 1*blasfeo_memsize_dmat(nu[N]+nx[N], nz[N]); // dzduxt
     size += 1*blasfeo_memsize_dvec(nz[N]); // z_alg
@@ -1973,10 +2035,20 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
     mem->nlp_timings = (ocp_nlp_timings*) c_ptr;
     c_ptr += sizeof(ocp_nlp_timings);
 
+    // profiling
+    mem->profiling = NULL;
+#if defined(ACADOS_WITH_PROFILING)
+    if (opts->profiling_buffer_size > 0)
+    {
+        mem->profiling = ocp_nlp_profiling_assign(N, opts->profiling_buffer_size, c_ptr);
+        c_ptr += ocp_nlp_profiling_calculate_size(N, opts->profiling_buffer_size);
+    }
+#endif
 
     // zero timings
     ocp_nlp_timings_reset(mem->nlp_timings);
     mem->nlp_timings->time_feedback = 0;
+    mem->nlp_timings->time_feedback_rhs = 0;
     mem->nlp_timings->time_preparation = 0;
     mem->nlp_timings->time_solution_sensitivities = 0;
 
@@ -2084,14 +2156,17 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
     // sim_guess
     for (i = 0; i <= N; i++)
     {
-        assign_and_advance_blasfeo_dvec_mem(nx[i] + nz[i], mem->sim_guess + i, &c_ptr);
+        int n_guess = ocp_nlp_sim_guess_size(config, dims, i);
+        assign_and_advance_blasfeo_dvec_mem(n_guess, mem->sim_guess + i, &c_ptr);
         // set to 0;
-        blasfeo_dvecse(nx[i] + nz[i], 0.0, mem->sim_guess+i, 0);
+        blasfeo_dvecse(n_guess, 0.0, mem->sim_guess+i, 0);
         // printf("sim_guess i %d: %p\n", i, mem->sim_guess+i);
     }
     assign_and_advance_blasfeo_dvec_mem(np_global, &mem->out_np_global, &c_ptr);
 
     mem->compute_hess = 1;
+    mem->thread_pool = NULL;
+    mem->qp_capture = NULL;
 
     return mem;
 }
@@ -2102,6 +2177,16 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
  * workspace
  ************************************************/
 
+// stages evaluated by different threads of the worker pool need separate module workspaces
+static int ocp_nlp_opts_reuse_workspace(ocp_nlp_opts *opts)
+{
+#if defined(ACADOS_WITH_THREAD_POOL)
+    if (opts->thread_pool_num_threads > 1)
+        return 0;
+#endif
+    return opts->reuse_workspace;
+}
+
 acados_size_t ocp_nlp_workspace_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_opts *opts, ocp_nlp_in *in)
 {
     ocp_qp_xcond_solver_config *qp_solver = config->qp_solver;
@@ -2177,7 +2262,7 @@ acados_size_t ocp_nlp_workspace_calculate_size(ocp_nlp_config *config, ocp_nlp_d
     size += nv_max * sizeof(double); // tmp_nv_double
 
     // module workspace
-    if (opts->reuse_workspace)
+    if (ocp_nlp_opts_reuse_workspace(opts))
     {
 #if defined(ACADOS_WITH_OPENMP)
         // qp solver
@@ -2261,7 +2346,7 @@ acados_size_t ocp_nlp_workspace_calculate_size(ocp_nlp_config *config, ocp_nlp_d
 
     size += (ni_max + ns_max) * sizeof(int);
     size_t ext_fun_workspace_size = 0;
-    if (opts->reuse_workspace)
+    if (ocp_nlp_opts_reuse_workspace(opts))
     {
 #if defined(ACADOS_WITH_OPENMP)
         // constraints
@@ -2417,7 +2502,7 @@ ocp_nlp_workspace *ocp_nlp_workspace_assign(ocp_nlp_config *config, ocp_nlp_dims
     assign_and_advance_blasfeo_dvec_mem(nx_max, &work->dxnext_dy, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(np_global, &work->tmp_np_global, &c_ptr);
 
-    if (opts->reuse_workspace)
+    if (ocp_nlp_opts_reuse_workspace(opts))
     {
 #if defined(ACADOS_WITH_OPENMP)
         // qp solver
@@ -2510,7 +2595,7 @@ ocp_nlp_workspace *ocp_nlp_workspace_assign(ocp_nlp_config *config, ocp_nlp_dims
     // align for external_function workspace
     align_char_to(64, &c_ptr);
 
-    if (opts->reuse_workspace)
+    if (ocp_nlp_opts_reuse_workspace(opts))
     {
 #if defined(ACADOS_WITH_OPENMP)
         /* dont reuse workspace */
@@ -2746,9 +2831,161 @@ static void ocp_nlp_regularize_set_qp_out_ptrs(ocp_nlp_reg_config *reg_config, o
 }
 
 
+#if defined(ACADOS_WITH_THREAD_POOL)
+/* stage-wise evaluations on the persistent worker pool */
+enum
+{
+    OCP_NLP_POOL_JOB_ALIAS_MEMORY = 0,
+    OCP_NLP_POOL_JOB_APPROXIMATE_QP_MATRICES,
+    OCP_NLP_POOL_JOB_APPROXIMATE_QP_VECTORS,
+    OCP_NLP_POOL_JOB_ZERO_ORDER_QP_UPDATE,
+    OCP_NLP_POOL_NUM_JOBS
+};
+
+typedef struct
+{
+    ocp_nlp_config *config;
+    ocp_nlp_dims *dims;
+    ocp_nlp_in *in;
+    ocp_nlp_out *out;
+    ocp_nlp_opts *opts;
+    ocp_nlp_memory *mem;
+    ocp_nlp_workspace *work;
+} ocp_nlp_pool_args;
+
+// runs task over the stages 0..N
+static void ocp_nlp_pool_run(int job, int num_phases, acados_thread_pool_task task,
+    ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_out *out,
+    ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work)
+{
+    ocp_nlp_pool_args args = {config, dims, in, out, opts, mem, work};
+    acados_thread_pool_run(mem->thread_pool, job, num_phases, dims->N+1, task, &args);
+}
+#endif
+
+
+
+static void ocp_nlp_alias_memory_to_dynamics(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
+         ocp_nlp_out *nlp_out, ocp_nlp_opts *opts, ocp_nlp_memory *nlp_mem, int i)
+{
+    config->dynamics[i]->memory_set_ux_ptr(nlp_out->ux+i, nlp_mem->dynamics[i]);
+    config->dynamics[i]->memory_set_ux1_ptr(nlp_out->ux+i+1, nlp_mem->dynamics[i]);
+    config->dynamics[i]->memory_set_pi_ptr(nlp_out->pi+i, nlp_mem->dynamics[i]);
+    config->dynamics[i]->memory_set_BAbt_ptr(nlp_mem->qp_in->BAbt+i, nlp_mem->dynamics[i]);
+    config->dynamics[i]->memory_set_RSQrq_ptr(nlp_mem->qp_in->RSQrq+i, nlp_mem->dynamics[i]);
+    config->dynamics[i]->memory_set_dzduxt_ptr(nlp_mem->dzduxt+i, nlp_mem->dynamics[i]);
+    config->dynamics[i]->memory_set_sim_guess_ptr(nlp_mem->sim_guess+i, nlp_mem->set_sim_guess+i, nlp_mem->dynamics[i]);
+    // NOTE: no z at terminal stage, since dynamics modules dont compute it.
+    config->dynamics[i]->memory_set_z_alg_ptr(nlp_mem->z_alg+i, nlp_mem->dynamics[i]);
+
+    if (opts->with_solution_sens_wrt_params)
+    {
+        config->dynamics[i]->memory_set_dyn_jac_p_global_ptr(nlp_mem->jac_dyn_p_global+i, nlp_mem->dynamics[i]);
+        config->dynamics[i]->memory_set_jac_lag_stat_p_global_ptr(nlp_mem->jac_lag_stat_p_global+i, nlp_mem->dynamics[i]);
+    }
+
+    int cost_integration;
+    config->dynamics[i]->opts_get(config->dynamics[i], opts->dynamics[i],
+                                "cost_computation", &cost_integration);
+    if (cost_integration)
+    {
+        // set pointers to cost function & gradient in integrator
+        double *cost_fun = config->cost[i]->memory_get_fun_ptr(nlp_mem->cost[i]);
+        struct blasfeo_dvec *cost_grad = config->cost[i]->memory_get_grad_ptr(nlp_mem->cost[i]);
+        struct blasfeo_dvec *y_ref = config->cost[i]->model_get_y_ref_ptr(nlp_in->cost[i]);
+        struct blasfeo_dmat *W_chol = config->cost[i]->memory_get_W_chol_ptr(nlp_mem->cost[i]);
+        struct blasfeo_dvec *W_chol_diag = config->cost[i]->memory_get_W_chol_diag_ptr(nlp_mem->cost[i]);
+        double *outer_hess_is_diag = config->cost[i]->get_outer_hess_is_diag_ptr(nlp_mem->cost[i], nlp_in->cost[i]);
+        double *cost_scaling = config->cost[i]->model_get_scaling_ptr(nlp_in->cost[i]);
+        int *add_cost_hess_contribution = config->cost[i]->opts_get_add_hess_contribution_ptr(config->cost[i], opts->cost[i]);
+
+        config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "cost_grad", cost_grad);
+        config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "cost_fun", cost_fun);
+        config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "y_ref", y_ref);
+        config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "W_chol", W_chol);
+        config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "W_chol_diag", W_chol_diag);
+        config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "outer_hess_is_diag", outer_hess_is_diag);
+        config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "cost_scaling_ptr", cost_scaling);
+        config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "add_cost_hess_contribution_ptr", add_cost_hess_contribution);
+    }
+}
+
+
+
+static void ocp_nlp_alias_memory_to_cost(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
+         ocp_nlp_out *nlp_out, ocp_nlp_opts *opts, ocp_nlp_memory *nlp_mem, int i)
+{
+    if (opts->with_solution_sens_wrt_params)
+    {
+        config->cost[i]->memory_set_jac_lag_stat_p_global_ptr(nlp_mem->jac_lag_stat_p_global+i, nlp_mem->cost[i]);
+    }
+    config->cost[i]->memory_set_ux_ptr(nlp_out->ux+i, nlp_mem->cost[i]);
+    config->cost[i]->memory_set_z_alg_ptr(nlp_mem->z_alg+i, nlp_mem->cost[i]);
+    config->cost[i]->memory_set_dzdux_tran_ptr(nlp_mem->dzduxt+i, nlp_mem->cost[i]);
+    config->cost[i]->memory_set_RSQrq_ptr(nlp_mem->qp_in->RSQrq+i, nlp_mem->cost[i]);
+    config->cost[i]->memory_set_Z_ptr(nlp_mem->qp_in->Z+i, nlp_mem->cost[i]);
+}
+
+
+
+static void ocp_nlp_alias_memory_to_constraints(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
+         ocp_nlp_out *nlp_out, ocp_nlp_opts *opts, ocp_nlp_memory *nlp_mem, int i)
+{
+    config->constraints[i]->memory_set_ux_ptr(nlp_out->ux+i, nlp_mem->constraints[i]);
+    config->constraints[i]->memory_set_lam_ptr(nlp_out->lam+i, nlp_mem->constraints[i]);
+    config->constraints[i]->memory_set_z_alg_ptr(nlp_mem->z_alg+i, nlp_mem->constraints[i]);
+    config->constraints[i]->memory_set_dzdux_tran_ptr(nlp_mem->dzduxt+i, nlp_mem->constraints[i]);
+    config->constraints[i]->memory_set_DCt_ptr(nlp_mem->qp_in->DCt+i, nlp_mem->constraints[i]);
+    config->constraints[i]->memory_set_RSQrq_ptr(nlp_mem->qp_in->RSQrq+i, nlp_mem->constraints[i]);
+    config->constraints[i]->memory_set_idxb_ptr(nlp_mem->qp_in->idxb[i], nlp_mem->constraints[i]);
+    config->constraints[i]->memory_set_idxs_rev_ptr(nlp_mem->qp_in->idxs_rev[i], nlp_mem->constraints[i]);
+    config->constraints[i]->memory_set_idxe_ptr(nlp_mem->qp_in->idxe[i], nlp_mem->constraints[i]);
+    if (opts->with_solution_sens_wrt_params)
+    {
+        config->constraints[i]->memory_set_jac_lag_stat_p_global_ptr(nlp_mem->jac_lag_stat_p_global+i, nlp_mem->constraints[i]);
+        config->constraints[i]->memory_set_jac_ineq_p_global_ptr(nlp_mem->jac_ineq_p_global+i, nlp_mem->constraints[i]);
+    }
+}
+
+
+
+#if defined(ACADOS_WITH_THREAD_POOL)
+static void ocp_nlp_alias_memory_task(void *args_, int phase, int i)
+{
+    ocp_nlp_pool_args *args = args_;
+    int N = args->dims->N;
+
+    if (phase == 0 && i < N)
+    {
+        ocp_nlp_alias_memory_to_dynamics(args->config, args->dims, args->in, args->out, args->opts, args->mem, i);
+        args->config->dynamics[i]->model_set(args->config->dynamics[i], args->dims->dynamics[i],
+                                             args->in->dynamics[i], "T", args->in->Ts+i);
+    }
+    else if (phase == 1)
+    {
+        ocp_nlp_alias_memory_to_cost(args->config, args->dims, args->in, args->out, args->opts, args->mem, i);
+        ocp_nlp_alias_memory_to_constraints(args->config, args->dims, args->in, args->out, args->opts, args->mem, i);
+    }
+}
+#endif
+
+
+
 void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
          ocp_nlp_out *nlp_out, ocp_nlp_opts *opts, ocp_nlp_memory *nlp_mem, ocp_nlp_workspace *nlp_work)
 {
+    // set pointer to dmask in qp_in to dmask in nlp_in
+    nlp_mem->qp_in->d_mask = nlp_in->dmask;
+
+#if defined(ACADOS_WITH_THREAD_POOL)
+    if (nlp_mem->thread_pool != NULL)
+    {
+        ocp_nlp_pool_run(OCP_NLP_POOL_JOB_ALIAS_MEMORY, 2, &ocp_nlp_alias_memory_task,
+                         config, dims, nlp_in, nlp_out, opts, nlp_mem, nlp_work);
+        return;
+    }
+#endif
+
 #if defined(ACADOS_WITH_OPENMP)
     #pragma omp parallel
     { // beginning of parallel region
@@ -2768,46 +3005,7 @@ void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *di
 #endif
     for (int i = 0; i < N; i++)
     {
-        config->dynamics[i]->memory_set_ux_ptr(nlp_out->ux+i, nlp_mem->dynamics[i]);
-        config->dynamics[i]->memory_set_ux1_ptr(nlp_out->ux+i+1, nlp_mem->dynamics[i]);
-        config->dynamics[i]->memory_set_pi_ptr(nlp_out->pi+i, nlp_mem->dynamics[i]);
-        config->dynamics[i]->memory_set_BAbt_ptr(nlp_mem->qp_in->BAbt+i, nlp_mem->dynamics[i]);
-        config->dynamics[i]->memory_set_RSQrq_ptr(nlp_mem->qp_in->RSQrq+i, nlp_mem->dynamics[i]);
-        config->dynamics[i]->memory_set_dzduxt_ptr(nlp_mem->dzduxt+i, nlp_mem->dynamics[i]);
-        config->dynamics[i]->memory_set_sim_guess_ptr(nlp_mem->sim_guess+i, nlp_mem->set_sim_guess+i, nlp_mem->dynamics[i]);
-        // NOTE: no z at terminal stage, since dynamics modules dont compute it.
-        config->dynamics[i]->memory_set_z_alg_ptr(nlp_mem->z_alg+i, nlp_mem->dynamics[i]);
-
-        if (opts->with_solution_sens_wrt_params)
-        {
-            config->dynamics[i]->memory_set_dyn_jac_p_global_ptr(nlp_mem->jac_dyn_p_global+i, nlp_mem->dynamics[i]);
-            config->dynamics[i]->memory_set_jac_lag_stat_p_global_ptr(nlp_mem->jac_lag_stat_p_global+i, nlp_mem->dynamics[i]);
-        }
-
-        int cost_integration;
-        config->dynamics[i]->opts_get(config->dynamics[i], opts->dynamics[i],
-                                    "cost_computation", &cost_integration);
-        if (cost_integration)
-        {
-            // set pointers to cost function & gradient in integrator
-            double *cost_fun = config->cost[i]->memory_get_fun_ptr(nlp_mem->cost[i]);
-            struct blasfeo_dvec *cost_grad = config->cost[i]->memory_get_grad_ptr(nlp_mem->cost[i]);
-            struct blasfeo_dvec *y_ref = config->cost[i]->model_get_y_ref_ptr(nlp_in->cost[i]);
-            struct blasfeo_dmat *W_chol = config->cost[i]->memory_get_W_chol_ptr(nlp_mem->cost[i]);
-            struct blasfeo_dvec *W_chol_diag = config->cost[i]->memory_get_W_chol_diag_ptr(nlp_mem->cost[i]);
-            double *outer_hess_is_diag = config->cost[i]->get_outer_hess_is_diag_ptr(nlp_mem->cost[i], nlp_in->cost[i]);
-            double *cost_scaling = config->cost[i]->model_get_scaling_ptr(nlp_in->cost[i]);
-            int *add_cost_hess_contribution = config->cost[i]->opts_get_add_hess_contribution_ptr(config->cost[i], opts->cost[i]);
-
-            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "cost_grad", cost_grad);
-            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "cost_fun", cost_fun);
-            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "y_ref", y_ref);
-            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "W_chol", W_chol);
-            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "W_chol_diag", W_chol_diag);
-            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "outer_hess_is_diag", outer_hess_is_diag);
-            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "cost_scaling_ptr", cost_scaling);
-            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "add_cost_hess_contribution_ptr", add_cost_hess_contribution);
-        }
+        ocp_nlp_alias_memory_to_dynamics(config, dims, nlp_in, nlp_out, opts, nlp_mem, i);
     }
 
     // alias to cost_memory
@@ -2816,15 +3014,7 @@ void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *di
 #endif
     for (int i = 0; i <= N; i++)
     {
-        if (opts->with_solution_sens_wrt_params)
-        {
-            config->cost[i]->memory_set_jac_lag_stat_p_global_ptr(nlp_mem->jac_lag_stat_p_global+i, nlp_mem->cost[i]);
-        }
-        config->cost[i]->memory_set_ux_ptr(nlp_out->ux+i, nlp_mem->cost[i]);
-        config->cost[i]->memory_set_z_alg_ptr(nlp_mem->z_alg+i, nlp_mem->cost[i]);
-        config->cost[i]->memory_set_dzdux_tran_ptr(nlp_mem->dzduxt+i, nlp_mem->cost[i]);
-        config->cost[i]->memory_set_RSQrq_ptr(nlp_mem->qp_in->RSQrq+i, nlp_mem->cost[i]);
-        config->cost[i]->memory_set_Z_ptr(nlp_mem->qp_in->Z+i, nlp_mem->cost[i]);
+        ocp_nlp_alias_memory_to_cost(config, dims, nlp_in, nlp_out, opts, nlp_mem, i);
     }
 
     // alias to constraints_memory
@@ -2833,25 +3023,9 @@ void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *di
 #endif
     for (int i = 0; i <= N; i++)
     {
-        config->constraints[i]->memory_set_ux_ptr(nlp_out->ux+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_lam_ptr(nlp_out->lam+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_z_alg_ptr(nlp_mem->z_alg+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_dzdux_tran_ptr(nlp_mem->dzduxt+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_DCt_ptr(nlp_mem->qp_in->DCt+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_RSQrq_ptr(nlp_mem->qp_in->RSQrq+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_idxb_ptr(nlp_mem->qp_in->idxb[i], nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_idxs_rev_ptr(nlp_mem->qp_in->idxs_rev[i], nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_idxe_ptr(nlp_mem->qp_in->idxe[i], nlp_mem->constraints[i]);
-        if (opts->with_solution_sens_wrt_params)
-        {
-            config->constraints[i]->memory_set_jac_lag_stat_p_global_ptr(nlp_mem->jac_lag_stat_p_global+i, nlp_mem->constraints[i]);
-            config->constraints[i]->memory_set_jac_ineq_p_global_ptr(nlp_mem->jac_ineq_p_global+i, nlp_mem->constraints[i]);
-        }
+        ocp_nlp_alias_memory_to_constraints(config, dims, nlp_in, nlp_out, opts, nlp_mem, i);
     }
 
-    // set pointer to dmask in qp_in to dmask in nlp_in
-    nlp_mem->qp_in->d_mask = nlp_in->dmask;
-
     // copy sampling times into dynamics model
 #if defined(ACADOS_WITH_OPENMP)
     #pragma omp for nowait
@@ -2963,24 +3137,127 @@ static void collect_integrator_timings(ocp_nlp_config *config, ocp_nlp_dims *dim
     for (int ii=0; ii < dims->N; ii++)
     {
         double tmp_time;
+        int tmp_int;
         config->dynamics[ii]->memory_get(config->dynamics[ii], dims->dynamics[ii], mem->dynamics[ii], "time_sim", &tmp_time);
         nlp_timings->time_sim += tmp_time;
         config->dynamics[ii]->memory_get(config->dynamics[ii], dims->dynamics[ii], mem->dynamics[ii], "time_sim_la", &tmp_time);
         nlp_timings->time_sim_la += tmp_time;
         config->dynamics[ii]->memory_get(config->dynamics[ii], dims->dynamics[ii], mem->dynamics[ii], "time_sim_ad", &tmp_time);
         nlp_timings->time_sim_ad += tmp_time;
+        config->dynamics[ii]->memory_get(config->dynamics[ii], dims->dynamics[ii], mem->dynamics[ii], "num_factorizations", &tmp_int);
+        nlp_timings->sim_num_factorizations += tmp_int;
     }
 }
 
-void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
-    ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
-    ocp_nlp_workspace *work)
+static void ocp_nlp_approximate_qp_matrices_collect_stage(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_memory *mem, int i)
 {
     int N = dims->N;
     int *nv = dims->nv;
     int *nx = dims->nx;
     int *nu = dims->nu;
 
+    // nlp mem: cost_grad
+    struct blasfeo_dvec *cost_grad = config->cost[i]->memory_get_grad_ptr(mem->cost[i]);
+    blasfeo_dveccp(nv[i], cost_grad, 0, mem->cost_grad + i, 0);
+
+    // nlp mem: dyn_fun
+    if (i < N)
+    {
+        struct blasfeo_dvec *dyn_fun
+            = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
+        blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->dyn_fun + i, 0);
+    }
+
+    // nlp mem: dyn_adj
+    if (i < N)
+    {
+        struct blasfeo_dvec *dyn_adj
+            = config->dynamics[i]->memory_get_adj_ptr(mem->dynamics[i]);
+        blasfeo_dveccp(nu[i] + nx[i], dyn_adj, 0, mem->dyn_adj + i, 0);
+    }
+    else
+    {
+        blasfeo_dvecse(nu[N] + nx[N], 0.0, mem->dyn_adj + N, 0);
+    }
+    if (i > 0)
+    {
+        // TODO: this could be simplified by not copying pi in the dynamics module.
+        struct blasfeo_dvec *dyn_adj
+            = config->dynamics[i-1]->memory_get_adj_ptr(mem->dynamics[i-1]);
+        blasfeo_daxpy(nx[i], 1.0, dyn_adj, nu[i-1]+nx[i-1], mem->dyn_adj+i, nu[i],
+            mem->dyn_adj+i, nu[i]);
+    }
+
+    // nlp mem: ineq_adj
+    struct blasfeo_dvec *ineq_adj =
+        config->constraints[i]->memory_get_adj_ptr(mem->constraints[i]);
+    blasfeo_dveccp(nv[i], ineq_adj, 0, mem->ineq_adj + i, 0);
+}
+
+
+
+#if defined(ACADOS_WITH_THREAD_POOL)
+// phases: dynamics, cost, constraints, collect
+static void ocp_nlp_approximate_qp_matrices_task(void *args_, int phase, int i)
+{
+    ocp_nlp_pool_args *args = args_;
+    ocp_nlp_config *config = args->config;
+    ocp_nlp_dims *dims = args->dims;
+    ocp_nlp_in *in = args->in;
+    ocp_nlp_opts *opts = args->opts;
+    ocp_nlp_memory *mem = args->mem;
+    ocp_nlp_workspace *work = args->work;
+
+    OCP_NLP_PROFILING_TIC(timer);
+
+    switch (phase)
+    {
+        case 0:
+            if (i < dims->N)
+            {
+                config->dynamics[i]->update_qp_matrices(config->dynamics[i], dims->dynamics[i],
+                    in->dynamics[i], opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+                OCP_NLP_PROFILING_TOC(mem->profiling, OCP_NLP_PROFILING_DYNAMICS, i, timer);
+            }
+            break;
+        case 1:
+            config->cost[i]->update_qp_matrices(config->cost[i], dims->cost[i], in->cost[i],
+                        opts->cost[i], mem->cost[i], work->cost[i]);
+            OCP_NLP_PROFILING_TOC(mem->profiling, OCP_NLP_PROFILING_COST, i, timer);
+            break;
+        case 2:
+            config->constraints[i]->update_qp_matrices(config->constraints[i], dims->constraints[i],
+                    in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
+            OCP_NLP_PROFILING_TOC(mem->profiling, OCP_NLP_PROFILING_CONSTRAINTS, i, timer);
+            break;
+        default:
+            ocp_nlp_approximate_qp_matrices_collect_stage(config, dims, mem, i);
+    }
+}
+#endif
+
+
+
+void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
+    ocp_nlp_workspace *work)
+{
+    int N = dims->N;
+
+    OCP_NLP_PROFILING_NEW_ITER(mem->profiling, mem->iter);
+
+#if defined(ACADOS_WITH_THREAD_POOL)
+    if (mem->thread_pool != NULL)
+    {
+        // NOTE: phases are separated by a barrier, thus dynamics still precede cost and constraints on every stage.
+        ocp_nlp_pool_run(OCP_NLP_POOL_JOB_APPROXIMATE_QP_MATRICES, 4, &ocp_nlp_approximate_qp_matrices_task,
+                         config, dims, in, out, opts, mem, work);
+        collect_integrator_timings(config, dims, mem);
+        return;
+    }
+#endif
+
     /* stage-wise multiple shooting lagrangian evaluation */
 #if defined(ACADOS_WITH_OPENMP)
     #pragma omp parallel for
@@ -2993,21 +3270,25 @@ void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
         //     blasfeo_dgese(nu[i] + nx[i], nu[i] + nx[i], 0.0, mem->qp_in->RSQrq+i, 0, 0);
         // }
         // NOTE: removed init and directly write cost contribution into Hessian
+        OCP_NLP_PROFILING_TIC(timer);
 
         // dynamics: NOTE: has to be first, as it computes z, which is used in cost and constraints.
         if (i < N)
         {
             config->dynamics[i]->update_qp_matrices(config->dynamics[i], dims->dynamics[i],
                 in->dynamics[i], opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+            OCP_NLP_PROFILING_LAP(mem->profiling, OCP_NLP_PROFILING_DYNAMICS, i, timer);
         }
 
         // cost
         config->cost[i]->update_qp_matrices(config->cost[i], dims->cost[i], in->cost[i],
                     opts->cost[i], mem->cost[i], work->cost[i]);
+        OCP_NLP_PROFILING_LAP(mem->profiling, OCP_NLP_PROFILING_COST, i, timer);
 
         // constraints
         config->constraints[i]->update_qp_matrices(config->constraints[i], dims->constraints[i],
                 in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
+        OCP_NLP_PROFILING_TOC(mem->profiling, OCP_NLP_PROFILING_CONSTRAINTS, i, timer);
     }
 
     /* collect stage-wise evaluations */
@@ -3016,49 +3297,68 @@ void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
 #endif
     for (int i=0; i <= N; i++)
     {
-        // nlp mem: cost_grad
-        struct blasfeo_dvec *cost_grad = config->cost[i]->memory_get_grad_ptr(mem->cost[i]);
-        blasfeo_dveccp(nv[i], cost_grad, 0, mem->cost_grad + i, 0);
+        ocp_nlp_approximate_qp_matrices_collect_stage(config, dims, mem, i);
+    }
 
-        // nlp mem: dyn_fun
-        if (i < N)
-        {
-            struct blasfeo_dvec *dyn_fun
-                = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
-            blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->dyn_fun + i, 0);
-        }
+    collect_integrator_timings(config, dims, mem);
+}
 
-        // nlp mem: dyn_adj
-        if (i < N)
-        {
-            struct blasfeo_dvec *dyn_adj
-                = config->dynamics[i]->memory_get_adj_ptr(mem->dynamics[i]);
-            blasfeo_dveccp(nu[i] + nx[i], dyn_adj, 0, mem->dyn_adj + i, 0);
-        }
-        else
-        {
-            blasfeo_dvecse(nu[N] + nx[N], 0.0, mem->dyn_adj + N, 0);
-        }
-        if (i > 0)
-        {
-            // TODO: this could be simplified by not copying pi in the dynamics module.
-            struct blasfeo_dvec *dyn_adj
-                = config->dynamics[i-1]->memory_get_adj_ptr(mem->dynamics[i-1]);
-            blasfeo_daxpy(nx[i], 1.0, dyn_adj, nu[i-1]+nx[i-1], mem->dyn_adj+i, nu[i],
-                mem->dyn_adj+i, nu[i]);
-        }
 
-        // nlp mem: ineq_adj
-        struct blasfeo_dvec *ineq_adj =
-            config->constraints[i]->memory_get_adj_ptr(mem->constraints[i]);
-        blasfeo_dveccp(nv[i], ineq_adj, 0, mem->ineq_adj + i, 0);
-    }
 
-    collect_integrator_timings(config, dims, mem);
+// update QP rhs of the inequality constraints of one stage from the current bounds,
+// e.g. of stage 0 after x0 has been set in the RTI feedback phase
+void ocp_nlp_approximate_qp_vectors_sqp_constraints(ocp_nlp_config *config,
+    ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_opts *opts,
+    ocp_nlp_memory *mem, ocp_nlp_workspace *work, int stage)
+{
+    int *ni = dims->ni;
+
+    // evaluate constraint residuals
+    config->constraints[stage]->update_qp_vectors(config->constraints[stage], dims->constraints[stage],
+        in->constraints[stage], opts->constraints[stage], mem->constraints[stage], work->constraints[stage]);
+
+    // copy ineq function value into mem, then into QP
+    struct blasfeo_dvec *ineq_fun = config->constraints[stage]->memory_get_fun_ptr(mem->constraints[stage]);
+    blasfeo_dveccp(2 * ni[stage], ineq_fun, 0, mem->ineq_fun + stage, 0);
+
+    // d
+    blasfeo_dveccp(2 * ni[stage], mem->ineq_fun + stage, 0, mem->qp_in->d + stage, 0);
 }
 
 
 
+static void ocp_nlp_approximate_qp_vectors_sqp_stage(ocp_nlp_config *config,
+    ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_opts *opts,
+    ocp_nlp_memory *mem, ocp_nlp_workspace *work, int i)
+{
+    int N = dims->N;
+    int *nv = dims->nv;
+    int *nx = dims->nx;
+
+    // g
+    blasfeo_dveccp(nv[i], mem->cost_grad + i, 0, mem->qp_in->rqz + i, 0);
+
+    // b
+    if (i < N)
+        blasfeo_dveccp(nx[i + 1], mem->dyn_fun + i, 0, mem->qp_in->b + i, 0);
+
+    // d
+    ocp_nlp_approximate_qp_vectors_sqp_constraints(config, dims, in, opts, mem, work, i);
+}
+
+
+
+#if defined(ACADOS_WITH_THREAD_POOL)
+static void ocp_nlp_approximate_qp_vectors_sqp_task(void *args_, int phase, int i)
+{
+    ocp_nlp_pool_args *args = args_;
+    ocp_nlp_approximate_qp_vectors_sqp_stage(args->config, args->dims, args->in, args->opts,
+                                             args->mem, args->work, i);
+}
+#endif
+
+
+
 // update QP rhs for SQP (step prim var, abs dual var)
 // - use cost gradient and dynamics residual from memory
 // - evaluate constraints wrt bounds -> allows to update all bounds between preparation and feedback phase.
@@ -3067,35 +3367,76 @@ void ocp_nlp_approximate_qp_vectors_sqp(ocp_nlp_config *config,
     ocp_nlp_memory *mem, ocp_nlp_workspace *work)
 {
     int N = dims->N;
-    int *nv = dims->nv;
-    int *nx = dims->nx;
-    // int *nu = dims->nu;
-    int *ni = dims->ni;
+
+#if defined(ACADOS_WITH_THREAD_POOL)
+    if (mem->thread_pool != NULL)
+    {
+        ocp_nlp_pool_run(OCP_NLP_POOL_JOB_APPROXIMATE_QP_VECTORS, 1, &ocp_nlp_approximate_qp_vectors_sqp_task,
+                         config, dims, in, out, opts, mem, work);
+        return;
+    }
+#endif
 
 #if defined(ACADOS_WITH_OPENMP)
     #pragma omp parallel for
 #endif
     for (int i = 0; i <= N; i++)
     {
-        // g
-        blasfeo_dveccp(nv[i], mem->cost_grad + i, 0, mem->qp_in->rqz + i, 0);
+        ocp_nlp_approximate_qp_vectors_sqp_stage(config, dims, in, opts, mem, work, i);
+    }
+}
 
-        // b
-        if (i < N)
-            blasfeo_dveccp(nx[i + 1], mem->dyn_fun + i, 0, mem->qp_in->b + i, 0);
 
-        // evaluate constraint residuals
-        config->constraints[i]->update_qp_vectors(config->constraints[i], dims->constraints[i],
-            in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
 
-        // copy ineq function value into mem, then into QP
-        struct blasfeo_dvec *ineq_fun = config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
-        blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->ineq_fun + i, 0);
+static void ocp_nlp_zero_order_qp_update_constraints_stage(ocp_nlp_config *config,
+    ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_opts *opts,
+    ocp_nlp_memory *mem, ocp_nlp_workspace *work, int i)
+{
+    int *ni = dims->ni;
 
-        // d
-        blasfeo_dveccp(2 * ni[i], mem->ineq_fun + i, 0, mem->qp_in->d + i, 0);
-    }
+    // evaluate constraint residuals
+    config->constraints[i]->compute_fun(config->constraints[i], dims->constraints[i],
+        in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
+    // copy ineq function value into QP
+    struct blasfeo_dvec *ineq_fun = config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
+    blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->qp_in->d + i, 0);
+    // copy into nlp_mem
+    blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->ineq_fun + i, 0);
+}
+
+
+
+static void ocp_nlp_zero_order_qp_update_dynamics_stage(ocp_nlp_config *config,
+    ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_opts *opts,
+    ocp_nlp_memory *mem, ocp_nlp_workspace *work, int i)
+{
+    int *nx = dims->nx;
+
+    // dynamics
+    config->dynamics[i]->compute_fun(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
+                                     opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+
+    struct blasfeo_dvec *dyn_fun = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
+    blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->qp_in->b + i, 0);
+    blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->dyn_fun + i, 0);
+}
+
+
+
+#if defined(ACADOS_WITH_THREAD_POOL)
+// constraints and dynamics are independent: a single phase
+static void ocp_nlp_zero_order_qp_update_task(void *args_, int phase, int i)
+{
+    ocp_nlp_pool_args *args = args_;
+    if (i < args->dims->N)
+        ocp_nlp_zero_order_qp_update_dynamics_stage(args->config, args->dims, args->in, args->opts,
+                                                    args->mem, args->work, i);
+    ocp_nlp_zero_order_qp_update_constraints_stage(args->config, args->dims, args->in, args->opts,
+                                                   args->mem, args->work, i);
 }
+#endif
+
+
 
 // zero order update QP: Update all constraint evaluations in QP
 void ocp_nlp_zero_order_qp_update(ocp_nlp_config *config,
@@ -3106,35 +3447,29 @@ void ocp_nlp_zero_order_qp_update(ocp_nlp_config *config,
     // int *nv = dims->nv;
     int *nx = dims->nx;
     int *nu = dims->nu;
-    int *ni = dims->ni;
 
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+#if defined(ACADOS_WITH_THREAD_POOL)
+    if (mem->thread_pool != NULL)
+        ocp_nlp_pool_run(OCP_NLP_POOL_JOB_ZERO_ORDER_QP_UPDATE, 1, &ocp_nlp_zero_order_qp_update_task,
+                         config, dims, in, out, opts, mem, work);
+    else
 #endif
-    for (int i = 0; i <= N; i++)
     {
-        // evaluate constraint residuals
-        config->constraints[i]->compute_fun(config->constraints[i], dims->constraints[i],
-            in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
-        // copy ineq function value into QP
-        struct blasfeo_dvec *ineq_fun = config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
-        blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->qp_in->d + i, 0);
-        // copy into nlp_mem
-        blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->ineq_fun + i, 0);
-    }
-
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+        #pragma omp parallel for
 #endif
-    for (int i=0; i<N; i++)
-    {
-        // dynamics
-        config->dynamics[i]->compute_fun(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
-                                         opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+        for (int i = 0; i <= N; i++)
+        {
+            ocp_nlp_zero_order_qp_update_constraints_stage(config, dims, in, opts, mem, work, i);
+        }
 
-        struct blasfeo_dvec *dyn_fun = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
-        blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->qp_in->b + i, 0);
-        blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->dyn_fun + i, 0);
+#if defined(ACADOS_WITH_OPENMP)
+        #pragma omp parallel for
+#endif
+        for (int i=0; i<N; i++)
+        {
+            ocp_nlp_zero_order_qp_update_dynamics_stage(config, dims, in, opts, mem, work, i);
+        }
     }
 
     // add gradient correction
@@ -3502,6 +3837,24 @@ int ocp_nlp_precompute_common(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nl
                                      opts->constraints[ii], mem->constraints[ii], work->constraints[ii]);
     }
 
+#if defined(ACADOS_WITH_THREAD_POOL)
+    // persistent worker pool for stage-wise evaluations
+    // NOTE: thread_pool_num_threads has to be set before the workspace is created.
+    if (mem->thread_pool != NULL &&
+        acados_thread_pool_get_num_threads(mem->thread_pool) != opts->thread_pool_num_threads)
+    {
+        acados_thread_pool_destroy(mem->thread_pool);
+        mem->thread_pool = NULL;
+    }
+    if (mem->thread_pool == NULL && opts->thread_pool_num_threads > 1)
+    {
+        mem->thread_pool = acados_thread_pool_create(opts->thread_pool_num_threads, opts->thread_pool_cores,
+                                opts->thread_pool_spin_count, OCP_NLP_POOL_NUM_JOBS, N+1);
+        if (mem->thread_pool == NULL)
+            printf("\nocp_nlp_precompute_common: could not create thread pool, using serial evaluation.\n");
+    }
+#endif
+
     ocp_nlp_alias_memory_to_submodules(config, dims, in, out, opts, mem, work);
     if (opts->fixed_hess)
     {
@@ -3526,6 +3879,18 @@ int ocp_nlp_precompute_common(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nl
 
 
 
+void ocp_nlp_terminate_common(ocp_nlp_memory *mem)
+{
+#if defined(ACADOS_WITH_THREAD_POOL)
+    acados_thread_pool_destroy(mem->thread_pool);
+    mem->thread_pool = NULL;
+#endif
+    ocp_qp_capture_free(mem->qp_capture);
+    mem->qp_capture = NULL;
+}
+
+
+
 /************************************************
  * residuals
  ************************************************/
@@ -3872,6 +4237,7 @@ int ocp_nlp_common_setup_qp_matrices_and_factorize(ocp_nlp_config *config, ocp_n
     ocp_qp_xcond_solver_config *qp_solver = config->qp_solver;
     ocp_nlp_timings *nlp_timings = nlp_mem->nlp_timings;
     ocp_nlp_timings_reset(nlp_timings);
+    OCP_NLP_PROFILING_NEW_CALL(nlp_mem->profiling);
 
     ocp_qp_in *qp_in = nlp_mem->qp_in;
     ocp_qp_out *qp_out = nlp_mem->qp_out;
@@ -4477,12 +4843,19 @@ int ocp_nlp_solve_qp_and_correct_dual(ocp_nlp_config *config, ocp_nlp_dims *dims
     }
     // add qp timings
     nlp_timings->time_qp_sol += acados_toc(&timer);
+    OCP_NLP_PROFILING_TOC(nlp_mem->profiling, OCP_NLP_PROFILING_QP_SOLVER, 0, timer);
     // NOTE: timings within qp solver are added internally (lhs+rhs)
     qp_solver->memory_get(qp_solver, qp_mem, "time_qp_solver_call", &tmp_time);
     nlp_timings->time_qp_solver_call += tmp_time;
     qp_solver->memory_get(qp_solver, qp_mem, "time_qp_xcond", &tmp_time);
     nlp_timings->time_qp_xcond += tmp_time;
 
+    // capture the QP as passed to the solver, for offline replay
+    if (nlp_mem->qp_capture != NULL)
+    {
+        ocp_qp_capture_write(nlp_mem->qp_capture, scaled_qp_in, scaled_qp_out, qp_status);
+    }
+
     // evaluate QP residual externally
     if (nlp_opts->ext_qp_res)
     {
@@ -4494,10 +4867,12 @@ int ocp_nlp_solve_qp_and_correct_dual(ocp_nlp_config *config, ocp_nlp_dims *dims
     config->regularize->correct_dual_sol(config->regularize, dims->regularize,
                                             nlp_opts->regularize, nlp_mem->regularize_mem);
     nlp_timings->time_reg += acados_toc(&timer);
+    OCP_NLP_PROFILING_TOC(nlp_mem->profiling, OCP_NLP_PROFILING_REGULARIZE, 0, timer);
 
     acados_tic(&timer);
     ocp_nlp_qpscaling_rescale_solution(dims->qpscaling, nlp_opts->qpscaling, nlp_mem->qpscaling, qp_in, qp_out);
     nlp_timings->time_qpscaling += acados_toc(&timer);
+    OCP_NLP_PROFILING_TOC(nlp_mem->profiling, OCP_NLP_PROFILING_QPSCALING, 0, timer);
 
     // reset regularize pointers if necessary // TODO: check how to do this best with qpscaling
     if (scaled_qp_in_ != NULL)
@@ -4541,6 +4916,7 @@ int ocp_nlp_solve_qp(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_opts *n
                 qp_in, qp_out, qp_opts, qp_mem, qp_work);
     // add qp timings
     nlp_timings->time_qp_sol += acados_toc(&timer);
+    OCP_NLP_PROFILING_TOC(nlp_mem->profiling, OCP_NLP_PROFILING_QP_SOLVER, 0, timer);
     // NOTE: timings within qp solver are added internally (lhs+rhs)
     qp_solver->memory_get(qp_solver, qp_mem, "time_qp_solver_call", &tmp_time);
     nlp_timings->time_qp_solver_call += tmp_time;
@@ -4649,6 +5025,10 @@ void ocp_nlp_timings_get(ocp_nlp_config *config, ocp_nlp_timings *timings, const
     {
         *value = timings->time_preparation;
     }
+    else if (!strcmp("time_feedback_rhs", field))
+    {
+        *value = timings->time_feedback_rhs;
+    }
     else if (!strcmp("time_feedback", field))
     {
         if (config->is_real_time_algorithm())
@@ -4753,6 +5133,16 @@ void ocp_nlp_memory_get(ocp_nlp_config *config, ocp_nlp_memory *nlp_mem, const c
         double *value = return_value_;
         *value = nlp_mem->cost_value;
     }
+    else if (!strcmp("sim_num_factorizations", field))
+    {
+        int *value = return_value_;
+        *value = nlp_mem->nlp_timings->sim_num_factorizations;
+    }
+    else if (!strncmp("profiling_", field, 10))
+    {
+        // profiling_num_records, profiling_num_slots, profiling_start, profiling_duration, ...
+        ocp_nlp_profiling_get(nlp_mem->profiling, field+10, return_value_);
+    }
     else if (!strcmp("primal_step_norm", field))
     {
         if (nlp_mem->primal_step_norm == NULL)
@@ -4835,4 +5225,221 @@ void ocp_nlp_timings_reset(ocp_nlp_timings *timings)
     timings->time_sim = 0.0;
     timings->time_sim_la = 0.0;
     timings->time_sim_ad = 0.0;
+    timings->sim_num_factorizations = 0;
+}
+
+
+
+/************************************************
+ * horizon shifting
+ ************************************************/
+
+static void ocp_nlp_shift_x(ocp_nlp_dims *dims, ocp_nlp_out *out, int i, int j)
+{
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+
+    if (i == j || nx[i] != nx[j])
+        return;
+
+    blasfeo_dveccp(nx[i], out->ux+j, nu[j], out->ux+i, nu[i]);
+}
+
+
+
+// copies all stage variables except x from stage j to stage i,
+// each field only if its dimension agrees, e.g. the x0 bounds change ni[0] but not nu[0]
+static void ocp_nlp_shift_stage_vars(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+            ocp_nlp_memory *mem, int i, int j)
+{
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *nz = dims->nz;
+    int *ns = dims->ns;
+    int *ni = dims->ni;
+
+    ocp_qp_out *qp_out = mem->qp_out;
+
+    if (i == j)
+        return;
+
+    if (nu[i] == nu[j])
+    {
+        blasfeo_dveccp(nu[i], out->ux+j, 0, out->ux+i, 0);
+        blasfeo_dveccp(nu[i], qp_out->ux+j, 0, qp_out->ux+i, 0);
+    }
+    if (nx[i] == nx[j])
+    {
+        // QP warm start, the NLP states are shifted in ocp_nlp_shift_x
+        blasfeo_dveccp(nx[i], qp_out->ux+j, nu[j], qp_out->ux+i, nu[i]);
+    }
+    if (ns[i] == ns[j])
+    {
+        blasfeo_dveccp(2*ns[i], out->ux+j, nu[j]+nx[j], out->ux+i, nu[i]+nx[i]);
+        blasfeo_dveccp(2*ns[i], qp_out->ux+j, nu[j]+nx[j], qp_out->ux+i, nu[i]+nx[i]);
+    }
+    if (nz[i] == nz[j])
+    {
+        blasfeo_dveccp(nz[i], out->z+j, 0, out->z+i, 0);
+    }
+    if (ni[i] == ni[j])
+    {
+        blasfeo_dveccp(2*ni[i], out->lam+j, 0, out->lam+i, 0);
+        blasfeo_dveccp(2*ni[i], qp_out->lam+j, 0, qp_out->lam+i, 0);
+        blasfeo_dveccp(2*ni[i], qp_out->t+j, 0, qp_out->t+i, 0);
+    }
+
+    if (i == N || j == N)
+        return;
+
+    if (nx[i+1] == nx[j+1])
+    {
+        blasfeo_dveccp(nx[i+1], out->pi+j, 0, out->pi+i, 0);
+        blasfeo_dveccp(nx[i+1], qp_out->pi+j, 0, qp_out->pi+i, 0);
+    }
+
+    // integrator guesses, passed to the integrator in the next call via sim_guess
+    int n_guesses_i, n_guesses_j;
+    config->dynamics[i]->dims_get(config->dynamics[i], dims->dynamics[i], "n_guesses", &n_guesses_i);
+    config->dynamics[j]->dims_get(config->dynamics[j], dims->dynamics[j], "n_guesses", &n_guesses_j);
+    if (n_guesses_i == 0 || n_guesses_i != n_guesses_j)
+        return;
+
+    if (mem->set_sim_guess[j])
+    {
+        // guess set by the user and not used yet
+        blasfeo_dveccp(n_guesses_i, mem->sim_guess+j, 0, mem->sim_guess+i, 0);
+    }
+    else
+    {
+        config->dynamics[j]->memory_get(config->dynamics[j], dims->dynamics[j], mem->dynamics[j],
+                                        "guesses_blasfeo", mem->sim_guess+i);
+    }
+    mem->set_sim_guess[i] = true;
+}
+
+
+
+// x_{i+1} = phi_i(x_i, u_i)
+static void ocp_nlp_shift_simulate_stage(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+            ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work, int i)
+{
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+
+    config->dynamics[i]->memory_set_ux_ptr(out->ux+i, mem->dynamics[i]);
+    config->dynamics[i]->memory_set_ux1_ptr(out->ux+i+1, mem->dynamics[i]);
+
+    // dyn_fun = phi(x_i, u_i) - x_{i+1}
+    config->dynamics[i]->compute_fun(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
+                        opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+    struct blasfeo_dvec *dyn_fun = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
+    // x_{i+1} += dyn_fun
+    blasfeo_daxpy(nx[i+1], 1.0, dyn_fun, 0, out->ux+i+1, nu[i+1], out->ux+i+1, nu[i+1]);
+}
+
+
+
+static void ocp_nlp_shift_interpolate(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+            ocp_nlp_out *out, ocp_nlp_memory *mem, int n_shift)
+{
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+
+    double t_shift = 0.0;
+    for (int i = 0; i < n_shift; i++)
+        t_shift += in->Ts[i];
+
+    // since t_i + t_shift >= t_i, the source stages j, j+1 are not overwritten yet
+    int j = 0;
+    double t_i = 0.0;
+    double t_j = 0.0;
+    for (int i = 0; i <= N; i++)
+    {
+        double t = t_i + t_shift;
+        // t_j <= t < t_{j+1}, up to round-off
+        while (j < N && t_j + (1.0 - 1e-10) * in->Ts[j] <= t)
+        {
+            t_j += in->Ts[j];
+            j++;
+        }
+
+        if (j == N)
+        {
+            // beyond the horizon: as SHIFT_REPEAT_LAST
+            ocp_nlp_shift_x(dims, out, i, N);
+            if (i < N)
+                ocp_nlp_shift_stage_vars(config, dims, out, mem, i, N-1);
+        }
+        else
+        {
+            double theta = (t - t_j) / in->Ts[j];
+            ocp_nlp_shift_stage_vars(config, dims, out, mem, i, j);
+            if (nx[i] == nx[j] && nx[j] == nx[j+1])
+            {
+                // x_i = (1 - theta) x_j + theta x_{j+1}
+                blasfeo_daxpby(nx[i], 1.0 - theta, out->ux+j, nu[j], theta, out->ux+j+1, nu[j+1],
+                               out->ux+i, nu[i]);
+            }
+            else
+            {
+                ocp_nlp_shift_x(dims, out, i, j);
+            }
+        }
+
+        if (i < N)
+            t_i += in->Ts[i];
+    }
+}
+
+
+
+void ocp_nlp_shift_iterate(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_out *out,
+            ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work, int n_shift, ocp_nlp_shift_strategy_t strategy)
+{
+    int N = dims->N;
+
+    if (n_shift < 0 || n_shift > N)
+    {
+        printf("\nerror: ocp_nlp_shift_iterate: n_shift = %d, must be in [0, N = %d].\n", n_shift, N);
+        exit(1);
+    }
+    if (n_shift == 0)
+        return;
+
+    if (strategy == SHIFT_INTERPOLATE)
+    {
+        ocp_nlp_shift_interpolate(config, dims, in, out, mem, n_shift);
+    }
+    else if (strategy == SHIFT_REPEAT_LAST || strategy == SHIFT_SIMULATE_TERMINAL)
+    {
+        // stage i <- stage i + n_shift; ascending, so the sources are not overwritten yet
+        for (int i = 0; i <= N - n_shift; i++)
+            ocp_nlp_shift_x(dims, out, i, i + n_shift);
+        for (int i = 0; i < N - n_shift; i++)
+            ocp_nlp_shift_stage_vars(config, dims, out, mem, i, i + n_shift);
+
+        // new tail: repeat the last interval
+        for (int i = N - n_shift; i < N; i++)
+            ocp_nlp_shift_stage_vars(config, dims, out, mem, i, N-1);
+        for (int i = N - n_shift + 1; i < N; i++)
+            ocp_nlp_shift_x(dims, out, i, N);
+
+        if (strategy == SHIFT_SIMULATE_TERMINAL)
+        {
+            for (int i = N - n_shift; i < N; i++)
+                ocp_nlp_shift_simulate_stage(config, dims, in, out, opts, mem, work, i);
+        }
+    }
+    else
+    {
+        printf("\nerror: ocp_nlp_shift_iterate: strategy %d not available.\n", strategy);
+        exit(1);
+    }
+
+    // warm start the next QP from the shifted qp_out
+    bool tmp_bool = true;
+    config->qp_solver->opts_set(config->qp_solver, opts->qp_solver_opts, "initialize_next_xcond_qp_from_qp_out", &tmp_bool);
 }
@@ -60,10 +60,13 @@ extern "C" {
 #include "acados/ocp_nlp/ocp_nlp_reg_common.h"
 #include "acados/ocp_nlp/ocp_nlp_qpscaling.h"
 #include "acados/ocp_nlp/ocp_nlp_globalization_common.h"
+#include "acados/ocp_nlp/ocp_nlp_profiling.h"
+#include "acados/ocp_qp/ocp_qp_capture.h"
 #include "acados/ocp_qp/ocp_qp_common.h"
 #include "acados/ocp_qp/ocp_qp_xcond_solver.h"
 #include "acados/sim/sim_common.h"
 #include "acados/utils/external_function_generic.h"
+#include "acados/utils/thread_pool.h"
 #include "acados/utils/types.h"
 
 
@@ -314,6 +317,10 @@ typedef struct ocp_nlp_opts
     double levenberg_marquardt;  // LM factor to be added to the hessian before regularization
     int reuse_workspace;
     int num_threads;
+    int thread_pool_num_threads; // size of persistent worker pool for stage-wise evaluations, <= 1: no pool
+    int thread_pool_spin_count; // spin iterations before a waiting worker is parked
+    int thread_pool_cores[ACADOS_THREAD_POOL_MAX_THREADS]; // cpu ids the pool workers are pinned to, -1: no pinning, [0]: calling thread, not pinned
+    int profiling_buffer_size; // number of iterations kept in the profiling ring buffer, needs ACADOS_WITH_PROFILING
     int print_level;
     int fixed_hess;
     int log_primal_step_norm; // compute and log the max norm of the primal steps
@@ -417,9 +424,11 @@ typedef struct ocp_nlp_timings
     double time_sim;
     double time_sim_la;
     double time_sim_ad;
+    int sim_num_factorizations;  // not a timing, collected alongside the integrator timings
     // these are not
     double time_solution_sensitivities;
     double time_feedback;
+    double time_feedback_rhs;  // QP rhs update within the last feedback phase
     double time_preparation;
 } ocp_nlp_timings;
 
@@ -453,6 +462,9 @@ typedef struct ocp_nlp_memory
     // timings
     ocp_nlp_timings *nlp_timings;
 
+    // per-stage, per-module timings, NULL if not compiled with ACADOS_WITH_PROFILING
+    ocp_nlp_profiling *profiling;
+
     // qp in & out
     ocp_qp_in *qp_in;
     ocp_qp_out *qp_out;
@@ -501,6 +513,12 @@ typedef struct ocp_nlp_memory
     struct blasfeo_dvec *sim_guess;
     acados_size_t workspace_size;
 
+    // persistent worker pool, created in precompute, freed in terminate
+    acados_thread_pool *thread_pool;
+
+    // binary capture of the solved QPs, NULL if not active, freed in terminate
+    ocp_qp_capture *qp_capture;
+
 } ocp_nlp_memory;
 
 //
@@ -578,6 +596,9 @@ void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
 void ocp_nlp_approximate_qp_vectors_sqp(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
                  ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work);
 //
+void ocp_nlp_approximate_qp_vectors_sqp_constraints(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+                 ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work, int stage);
+//
 void ocp_nlp_zero_order_qp_update(ocp_nlp_config *config,
     ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
     ocp_nlp_memory *mem, ocp_nlp_workspace *work);
@@ -597,6 +618,8 @@ double ocp_nlp_compute_anderson_gamma(ocp_nlp_workspace *work, ocp_qp_out *new_q
 //
 int ocp_nlp_precompute_common(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
             ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work);
+//
+void ocp_nlp_terminate_common(ocp_nlp_memory *mem);
 
 //
 void ocp_nlp_initialize_qp_from_nlp(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_qp_in *qp_in,
@@ -675,6 +698,24 @@ void ocp_nlp_common_print_iteration(int iter_count, ocp_nlp_res *nlp_res);
 void ocp_nlp_update_variables_sqp_delta_primal_dual(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
             ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work, double alpha, ocp_qp_out *step);
 
+
+
+/************************************************
+ * horizon shifting
+ ************************************************/
+
+typedef enum
+{
+    SHIFT_REPEAT_LAST, // = 0, x: repeat x_N, u and multipliers: repeat stage N-1
+    SHIFT_SIMULATE_TERMINAL, // = 1, as SHIFT_REPEAT_LAST, x simulated forward from x_N with the repeated u
+    SHIFT_INTERPOLATE, // = 2, shift by the time of the first n_shift intervals, x linear, others piecewise constant
+} ocp_nlp_shift_strategy_t;
+
+// shifts out, the integrator guesses and the QP warm start by n_shift stages, in place;
+// stages with different dimensions than their source are not changed
+void ocp_nlp_shift_iterate(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_out *out,
+            ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work, int n_shift, ocp_nlp_shift_strategy_t strategy);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
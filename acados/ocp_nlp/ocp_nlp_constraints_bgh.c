@@ -385,8 +385,10 @@ void *ocp_nlp_constraints_bgh_model_assign(void *config, void *dims_, void *raw_
 }
 
 
-void ocp_nlp_constraints_bgh_update_mask_lower(ocp_nlp_constraints_bgh_model *model, int size, int offset)
+void ocp_nlp_constraints_bgh_update_mask_lower(void *model_, int size, int offset)
 {
+    ocp_nlp_constraints_bgh_model *model = model_;
+
     for (int ii = 0; ii < size; ii++)
     {
         if (BLASFEO_DVECEL(&model->d, offset + ii) <= -ACADOS_INFTY)
@@ -397,8 +399,10 @@ void ocp_nlp_constraints_bgh_update_mask_lower(ocp_nlp_constraints_bgh_model *mo
 }
 
 
-void ocp_nlp_constraints_bgh_update_mask_upper(ocp_nlp_constraints_bgh_model *model, int size, int offset)
+void ocp_nlp_constraints_bgh_update_mask_upper(void *model_, int size, int offset)
 {
+    ocp_nlp_constraints_bgh_model *model = model_;
+
     for (int ii = 0; ii < size; ii++)
     {
         if (BLASFEO_DVECEL(&model->d, offset + ii) >= ACADOS_INFTY)
@@ -935,6 +939,15 @@ void ocp_nlp_constraints_bgh_model_set_dmask_ptr(struct blasfeo_dvec *dmask, voi
 
 
 
+struct blasfeo_dvec *ocp_nlp_constraints_bgh_model_get_d_ptr(void *model_)
+{
+    ocp_nlp_constraints_bgh_model *model = model_;
+
+    return &model->d;
+}
+
+
+
 struct blasfeo_dvec *ocp_nlp_constraints_bgh_memory_get_fun_ptr(void *memory_)
 {
     ocp_nlp_constraints_bgh_memory *memory = memory_;
@@ -1851,6 +1864,9 @@ void ocp_nlp_constraints_bgh_config_initialize_default(void *config_, int stage)
     config->model_set = &ocp_nlp_constraints_bgh_model_set;
     config->model_get = &ocp_nlp_constraints_bgh_model_get;
     config->model_set_dmask_ptr = &ocp_nlp_constraints_bgh_model_set_dmask_ptr;
+    config->model_get_d_ptr = &ocp_nlp_constraints_bgh_model_get_d_ptr;
+    config->model_update_mask_lower = &ocp_nlp_constraints_bgh_update_mask_lower;
+    config->model_update_mask_upper = &ocp_nlp_constraints_bgh_update_mask_upper;
     config->opts_calculate_size = &ocp_nlp_constraints_bgh_opts_calculate_size;
     config->opts_assign = &ocp_nlp_constraints_bgh_opts_assign;
     config->opts_initialize_default = &ocp_nlp_constraints_bgh_opts_initialize_default;
@@ -388,8 +388,10 @@ void *ocp_nlp_constraints_bgp_model_assign(void *config, void *dims_, void *raw_
 }
 
 
-void ocp_nlp_constraints_bgp_update_mask_lower(ocp_nlp_constraints_bgp_model *model, int size, int offset)
+void ocp_nlp_constraints_bgp_update_mask_lower(void *model_, int size, int offset)
 {
+    ocp_nlp_constraints_bgp_model *model = model_;
+
     for (int ii = 0; ii < size; ii++)
     {
         if (BLASFEO_DVECEL(&model->d, offset + ii) <= -ACADOS_INFTY)
@@ -400,8 +402,10 @@ void ocp_nlp_constraints_bgp_update_mask_lower(ocp_nlp_constraints_bgp_model *mo
 }
 
 
-void ocp_nlp_constraints_bgp_update_mask_upper(ocp_nlp_constraints_bgp_model *model, int size, int offset)
+void ocp_nlp_constraints_bgp_update_mask_upper(void *model_, int size, int offset)
 {
+    ocp_nlp_constraints_bgp_model *model = model_;
+
     for (int ii = 0; ii < size; ii++)
     {
         if (BLASFEO_DVECEL(&model->d, offset + ii) >= ACADOS_INFTY)
@@ -916,6 +920,13 @@ void ocp_nlp_constraints_bgp_model_set_dmask_ptr(struct blasfeo_dvec *dmask, voi
 }
 
 
+struct blasfeo_dvec *ocp_nlp_constraints_bgp_model_get_d_ptr(void *model_)
+{
+    ocp_nlp_constraints_bgp_model *model = model_;
+    return &model->d;
+}
+
+
 struct blasfeo_dvec *ocp_nlp_constraints_bgp_memory_get_fun_ptr(void *memory_)
 {
     ocp_nlp_constraints_bgp_memory *memory = memory_;
@@ -1618,6 +1629,9 @@ void ocp_nlp_constraints_bgp_config_initialize_default(void *config_, int stage)
     config->model_set = &ocp_nlp_constraints_bgp_model_set;
     config->model_get = &ocp_nlp_constraints_bgp_model_get;
     config->model_set_dmask_ptr = &ocp_nlp_constraints_bgp_model_set_dmask_ptr;
+    config->model_get_d_ptr = &ocp_nlp_constraints_bgp_model_get_d_ptr;
+    config->model_update_mask_lower = &ocp_nlp_constraints_bgp_update_mask_lower;
+    config->model_update_mask_upper = &ocp_nlp_constraints_bgp_update_mask_upper;
     config->opts_calculate_size = &ocp_nlp_constraints_bgp_opts_calculate_size;
     config->opts_assign = &ocp_nlp_constraints_bgp_opts_assign;
     config->opts_initialize_default = &ocp_nlp_constraints_bgp_opts_initialize_default;
@@ -62,6 +62,10 @@ typedef struct
     int (*model_set)(void *config_, void *dims_, void *model_, const char *field, void *value);
     void (*model_get)(void *config_, void *dims_, void *model_, const char *field, void *value);
     void (*model_set_dmask_ptr)(struct blasfeo_dvec *dmask, void *model_);
+    struct blasfeo_dvec *(*model_get_d_ptr)(void *model_);
+    // sets dmask to 0 where the lower (upper) bounds in d[offset:offset+size] are infinite, 1 otherwise
+    void (*model_update_mask_lower)(void *model_, int size, int offset);
+    void (*model_update_mask_upper)(void *model_, int size, int offset);
     acados_size_t (*opts_calculate_size)(void *config, void *dims);
     void *(*opts_assign)(void *config, void *dims, void *raw_memory);
     void (*opts_initialize_default)(void *config, void *dims, void *opts);
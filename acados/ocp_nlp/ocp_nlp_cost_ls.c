@@ -452,6 +452,13 @@ double *ocp_nlp_cost_ls_model_get_scaling_ptr(void *in_)
     return &model->scaling;
 }
 
+
+struct blasfeo_dvec *ocp_nlp_cost_ls_model_get_y_ref_ptr(void *in_)
+{
+    ocp_nlp_cost_ls_model *model = in_;
+    return &model->y_ref;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //                                   options                                  //
 ////////////////////////////////////////////////////////////////////////////////
@@ -1142,6 +1149,7 @@ void ocp_nlp_cost_ls_config_initialize_default(void *config_, int stage)
     config->model_set = &ocp_nlp_cost_ls_model_set;
     config->model_get = &ocp_nlp_cost_ls_model_get;
     config->model_get_scaling_ptr = &ocp_nlp_cost_ls_model_get_scaling_ptr;
+    config->model_get_y_ref_ptr = &ocp_nlp_cost_ls_model_get_y_ref_ptr;
     config->opts_calculate_size = &ocp_nlp_cost_ls_opts_calculate_size;
     config->opts_assign = &ocp_nlp_cost_ls_opts_assign;
     config->opts_initialize_default = &ocp_nlp_cost_ls_opts_initialize_default;
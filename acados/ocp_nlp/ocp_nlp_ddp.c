@@ -572,6 +572,7 @@ int ocp_nlp_ddp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 
     // zero timers
     ocp_nlp_timings_reset(nlp_timings);
+    OCP_NLP_PROFILING_NEW_CALL(nlp_mem->profiling);
 
     int qp_status = 0;
     int qp_iter = 0;
@@ -668,6 +669,7 @@ int ocp_nlp_ddp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
         config->regularize->regularize(config->regularize, dims->regularize,
                                                nlp_opts->regularize, nlp_mem->regularize_mem);
         nlp_timings->time_reg += acados_toc(&timer1);
+        OCP_NLP_PROFILING_TOC(nlp_mem->profiling, OCP_NLP_PROFILING_REGULARIZE, 0, timer1);
 
         // Termination
         if (check_termination(ddp_iter, nlp_res, mem, opts))
@@ -791,6 +793,7 @@ int ocp_nlp_ddp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
             acados_tic(&timer1);
             globalization_status = config->globalization->find_acceptable_iterate(config, dims, nlp_in, nlp_out, nlp_mem, mem, nlp_work, nlp_opts, &mem->alpha);
             nlp_timings->time_glob += acados_toc(&timer1);
+            OCP_NLP_PROFILING_TOC(nlp_mem->profiling, OCP_NLP_PROFILING_GLOBALIZATION, 0, timer1);
 
             if (globalization_status != ACADOS_SUCCESS)
             {
@@ -1056,6 +1059,7 @@ void ocp_nlp_ddp_terminate(void *config_, void *mem_, void *work_)
     ocp_nlp_ddp_workspace *work = work_;
 
     config->qp_solver->terminate(config->qp_solver, mem->nlp_mem->qp_solver_mem, work->nlp_work->qp_work);
+    ocp_nlp_terminate_common(mem->nlp_mem);
 }
 
 
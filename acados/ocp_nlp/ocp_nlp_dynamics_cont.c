@@ -573,7 +573,8 @@ void ocp_nlp_dynamics_cont_memory_get(void *config_, void *dims_, void *mem_, co
 
     sim_config *sim = config->sim_solver;
 
-    if (!strcmp(field, "time_sim") || !strcmp(field, "time_sim_ad") || !strcmp(field, "time_sim_la"))
+    if (!strcmp(field, "time_sim") || !strcmp(field, "time_sim_ad") || !strcmp(field, "time_sim_la") ||
+        !strcmp(field, "num_factorizations") || !strcmp(field, "guesses_blasfeo"))
     {
         sim->memory_get(sim, dims->sim, mem->sim_solver, field, value);
     }
@@ -154,6 +154,11 @@ void ocp_nlp_dynamics_disc_dims_get(void *config_, void *dims_, const char *dim,
     {
         *value = dims->np_global;
     }
+    else if (!strcmp(dim, "n_guesses"))
+    {
+        // no integrator
+        *value = 0;
+    }
     else
     {
         printf("\ndimension type %s not available in module ocp_nlp_dynamics_disc\n", dim);
@@ -458,6 +463,11 @@ void ocp_nlp_dynamics_disc_memory_get(void *config_, void *dims_, void *mem_, co
         double *ptr = value;
         *ptr = 0;
     }
+    else if (!strcmp(field, "num_factorizations"))
+    {
+        int *ptr = value;
+        *ptr = 0;
+    }
     else
     {
         printf("\nerror: ocp_nlp_dynamics_disc_memory_get: field %s not available\n", field);
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "acados/ocp_nlp/ocp_nlp_profiling.h"
+#include "acados/utils/math.h"
+#include "acados/utils/mem.h"
+
+
+
+acados_size_t ocp_nlp_profiling_calculate_size(int N, int capacity)
+{
+    int num_slots = OCP_NLP_PROFILING_NUM_STAGE_MODULES * (N+1)
+                    + OCP_NLP_PROFILING_NUM_MODULES - OCP_NLP_PROFILING_NUM_STAGE_MODULES;
+
+    acados_size_t size = sizeof(ocp_nlp_profiling);
+
+    size += 2 * capacity * num_slots * sizeof(double);  // start, duration
+    size += 2 * capacity * sizeof(int);  // call, iter
+
+    size += 8;  // initial align
+    size += 8;  // double align
+
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+ocp_nlp_profiling *ocp_nlp_profiling_assign(int N, int capacity, void *raw_memory)
+{
+    char *c_ptr = (char *) raw_memory;
+
+    // initial align
+    align_char_to(8, &c_ptr);
+
+    ocp_nlp_profiling *prof = (ocp_nlp_profiling *) c_ptr;
+    c_ptr += sizeof(ocp_nlp_profiling);
+
+    prof->N = N;
+    prof->capacity = capacity;
+    prof->num_slots = OCP_NLP_PROFILING_NUM_STAGE_MODULES * (N+1)
+                      + OCP_NLP_PROFILING_NUM_MODULES - OCP_NLP_PROFILING_NUM_STAGE_MODULES;
+
+    // double align
+    align_char_to(8, &c_ptr);
+
+    assign_and_advance_double(capacity * prof->num_slots, &prof->start, &c_ptr);
+    assign_and_advance_double(capacity * prof->num_slots, &prof->duration, &c_ptr);
+    assign_and_advance_int(capacity, &prof->call, &c_ptr);
+    assign_and_advance_int(capacity, &prof->iter, &c_ptr);
+
+    assert((char *) raw_memory + ocp_nlp_profiling_calculate_size(N, capacity) >= c_ptr);
+
+    prof->num_records = 0;
+    prof->num_calls = 0;
+    prof->current = -1;
+    acados_tic(&prof->origin);
+
+    return prof;
+}
+
+
+
+int ocp_nlp_profiling_slot(ocp_nlp_profiling *prof, ocp_nlp_profiling_module module, int stage)
+{
+    if (module < OCP_NLP_PROFILING_NUM_STAGE_MODULES)
+        return module * (prof->N+1) + stage;
+    else
+        return OCP_NLP_PROFILING_NUM_STAGE_MODULES * (prof->N+1) + module - OCP_NLP_PROFILING_NUM_STAGE_MODULES;
+}
+
+
+
+const char *ocp_nlp_profiling_module_name(ocp_nlp_profiling_module module)
+{
+    switch (module)
+    {
+        case OCP_NLP_PROFILING_DYNAMICS:
+            return "dynamics";
+        case OCP_NLP_PROFILING_COST:
+            return "cost";
+        case OCP_NLP_PROFILING_CONSTRAINTS:
+            return "constraints";
+        case OCP_NLP_PROFILING_REGULARIZE:
+            return "regularize";
+        case OCP_NLP_PROFILING_QPSCALING:
+            return "qpscaling";
+        case OCP_NLP_PROFILING_QP_SOLVER:
+            return "qp_solver";
+        case OCP_NLP_PROFILING_GLOBALIZATION:
+            return "globalization";
+        default:
+            return "unknown";
+    }
+}
+
+
+
+void ocp_nlp_profiling_new_call(ocp_nlp_profiling *prof)
+{
+    if (prof == NULL)
+        return;
+
+    prof->num_calls++;
+    prof->current = -1;
+}
+
+
+
+void ocp_nlp_profiling_new_iter(ocp_nlp_profiling *prof, int iter)
+{
+    if (prof == NULL || prof->capacity <= 0)
+        return;
+
+    int row = prof->num_records % prof->capacity;
+    for (int k = 0; k < prof->num_slots; k++)
+    {
+        prof->start[row*prof->num_slots+k] = 0.0;
+        prof->duration[row*prof->num_slots+k] = 0.0;
+    }
+    prof->call[row] = prof->num_calls;
+    prof->iter[row] = iter;
+
+    prof->num_records++;
+    prof->current = row;
+}
+
+
+
+void ocp_nlp_profiling_record(ocp_nlp_profiling *prof, ocp_nlp_profiling_module module, int stage,
+                              acados_timer *timer)
+{
+    if (prof == NULL || prof->current < 0)
+        return;
+
+    // NOTE: acados_toc writes into the timer, use a local copy of the shared origin.
+    acados_timer origin = prof->origin;
+    double elapsed = acados_toc(timer);
+    double now = acados_toc(&origin);
+
+    int k = prof->current * prof->num_slots + ocp_nlp_profiling_slot(prof, module, stage);
+    if (prof->duration[k] == 0.0)
+        prof->start[k] = now - elapsed;
+    prof->duration[k] += elapsed;
+}
+
+
+
+static int ocp_nlp_profiling_num_kept(ocp_nlp_profiling *prof)
+{
+    if (prof == NULL)
+        return 0;
+    return MIN(prof->num_records, prof->capacity);
+}
+
+
+
+// row of the k-th kept record, oldest first
+static int ocp_nlp_profiling_row(ocp_nlp_profiling *prof, int k)
+{
+    if (prof->num_records <= prof->capacity)
+        return k;
+    return (prof->num_records + k) % prof->capacity;
+}
+
+
+
+void ocp_nlp_profiling_get(ocp_nlp_profiling *prof, const char *field, void *value)
+{
+    int num_kept = ocp_nlp_profiling_num_kept(prof);
+
+    if (!strcmp(field, "num_records"))
+    {
+        int *int_value = value;
+        *int_value = num_kept;
+    }
+    else if (!strcmp(field, "num_slots"))
+    {
+        int *int_value = value;
+        *int_value = prof == NULL ? 0 : prof->num_slots;
+    }
+    else if (!strcmp(field, "capacity"))
+    {
+        int *int_value = value;
+        *int_value = prof == NULL ? 0 : prof->capacity;
+    }
+    else if (!strcmp(field, "start") || !strcmp(field, "duration"))
+    {
+        double *double_value = value;
+        if (num_kept == 0)
+            return;
+        double *src = !strcmp(field, "start") ? prof->start : prof->duration;
+        for (int k = 0; k < num_kept; k++)
+        {
+            int row = ocp_nlp_profiling_row(prof, k);
+            memcpy(double_value + k*prof->num_slots, src + row*prof->num_slots,
+                   prof->num_slots*sizeof(double));
+        }
+    }
+    else if (!strcmp(field, "call") || !strcmp(field, "iter"))
+    {
+        int *int_value = value;
+        if (num_kept == 0)
+            return;
+        int *src = !strcmp(field, "call") ? prof->call : prof->iter;
+        for (int k = 0; k < num_kept; k++)
+        {
+            int_value[k] = src[ocp_nlp_profiling_row(prof, k)];
+        }
+    }
+    else
+    {
+        printf("\nerror: ocp_nlp_profiling_get: field %s not available\n", field);
+        exit(1);
+    }
+}
+
+
+
+int ocp_nlp_profiling_write_trace(ocp_nlp_profiling *prof, const char *filename)
+{
+    FILE *file = fopen(filename, "w");
+    if (file == NULL)
+    {
+        printf("\nocp_nlp_profiling_write_trace: could not open %s\n", filename);
+        return 1;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+
+    // one track per stage, global modules on track N+1
+    int N = prof == NULL ? -1 : prof->N;
+    for (int i = 0; i <= N; i++)
+    {
+        fprintf(file, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %d, "
+                "\"args\": {\"name\": \"stage %d\"}},\n", i, i);
+    }
+    fprintf(file, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %d, "
+            "\"args\": {\"name\": \"solver\"}}", N+1);
+
+    int num_kept = ocp_nlp_profiling_num_kept(prof);
+    for (int k = 0; k < num_kept; k++)
+    {
+        int row = ocp_nlp_profiling_row(prof, k);
+        for (int module = 0; module < OCP_NLP_PROFILING_NUM_MODULES; module++)
+        {
+            int num_stages = module < OCP_NLP_PROFILING_NUM_STAGE_MODULES ? N+1 : 1;
+            for (int i = 0; i < num_stages; i++)
+            {
+                int slot = ocp_nlp_profiling_slot(prof, module, i);
+                double duration = prof->duration[row*prof->num_slots+slot];
+                if (duration == 0.0)
+                    continue;
+                int tid = module < OCP_NLP_PROFILING_NUM_STAGE_MODULES ? i : N+1;
+                // timestamps in microseconds
+                fprintf(file, ",\n{\"name\": \"%s\", \"cat\": \"acados\", \"ph\": \"X\", \"pid\": 0, "
+                        "\"tid\": %d, \"ts\": %.3f, \"dur\": %.3f, "
+                        "\"args\": {\"call\": %d, \"iter\": %d}}",
+                        ocp_nlp_profiling_module_name(module), tid,
+                        1e6*prof->start[row*prof->num_slots+slot], 1e6*duration,
+                        prof->call[row], prof->iter[row]);
+            }
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    return 0;
+}
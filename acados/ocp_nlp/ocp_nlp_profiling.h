@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#ifndef ACADOS_OCP_NLP_OCP_NLP_PROFILING_H_
+#define ACADOS_OCP_NLP_OCP_NLP_PROFILING_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "acados/utils/timing.h"
+#include "acados/utils/types.h"
+
+// Per-stage, per-module timings of the NLP iterations.
+// Compiled in with ACADOS_WITH_PROFILING.
+//
+// Every iteration opens a record in a preallocated ring buffer, which keeps the
+// last `capacity` records. A record holds start time and accumulated duration of
+// every slot, i.e. of the stage-wise modules (dynamics, cost, constraints) on
+// every stage and of the global modules. Start times are relative to the creation
+// of the buffer. Stage slots are only written by the thread evaluating the stage.
+
+typedef enum
+{
+    // stage-wise modules
+    OCP_NLP_PROFILING_DYNAMICS,
+    OCP_NLP_PROFILING_COST,
+    OCP_NLP_PROFILING_CONSTRAINTS,
+    // global modules
+    OCP_NLP_PROFILING_REGULARIZE,
+    OCP_NLP_PROFILING_QPSCALING,
+    OCP_NLP_PROFILING_QP_SOLVER,
+    OCP_NLP_PROFILING_GLOBALIZATION,
+    OCP_NLP_PROFILING_NUM_MODULES
+} ocp_nlp_profiling_module;
+
+#define OCP_NLP_PROFILING_NUM_STAGE_MODULES 3
+
+typedef struct
+{
+    double *start;     // capacity x num_slots, start time [s] of first measurement
+    double *duration;  // capacity x num_slots, accumulated duration [s]
+    int *call;         // capacity, solver call of the record
+    int *iter;         // capacity, iteration within the solver call
+    acados_timer origin;
+    int N;
+    int num_slots;
+    int capacity;
+    int num_records;   // number of records opened since creation
+    int num_calls;
+    int current;       // row of the open record, -1 if none
+} ocp_nlp_profiling;
+
+//
+acados_size_t ocp_nlp_profiling_calculate_size(int N, int capacity);
+//
+ocp_nlp_profiling *ocp_nlp_profiling_assign(int N, int capacity, void *raw_memory);
+//
+int ocp_nlp_profiling_slot(ocp_nlp_profiling *prof, ocp_nlp_profiling_module module, int stage);
+//
+const char *ocp_nlp_profiling_module_name(ocp_nlp_profiling_module module);
+//
+void ocp_nlp_profiling_new_call(ocp_nlp_profiling *prof);
+//
+void ocp_nlp_profiling_new_iter(ocp_nlp_profiling *prof, int iter);
+// adds the time elapsed since acados_tic(timer) to the slot of the open record
+void ocp_nlp_profiling_record(ocp_nlp_profiling *prof, ocp_nlp_profiling_module module, int stage,
+                              acados_timer *timer);
+// fields: num_records, num_slots, capacity, start, duration, call, iter;
+// arrays are returned oldest record first, num_records x num_slots row-major.
+void ocp_nlp_profiling_get(ocp_nlp_profiling *prof, const char *field, void *value);
+// writes the recorded events in Chrome trace event format (JSON), returns 0 on success
+int ocp_nlp_profiling_write_trace(ocp_nlp_profiling *prof, const char *filename);
+
+
+#if defined(ACADOS_WITH_PROFILING)
+
+#define OCP_NLP_PROFILING_NEW_CALL(prof) ocp_nlp_profiling_new_call(prof)
+#define OCP_NLP_PROFILING_NEW_ITER(prof, iter) ocp_nlp_profiling_new_iter(prof, iter)
+// declares and starts a timer
+#define OCP_NLP_PROFILING_TIC(timer) acados_timer timer; acados_tic(&timer)
+#define OCP_NLP_PROFILING_TOC(prof, module, stage, timer) \
+    ocp_nlp_profiling_record(prof, module, stage, &(timer))
+// records and restarts the timer
+#define OCP_NLP_PROFILING_LAP(prof, module, stage, timer) \
+    (ocp_nlp_profiling_record(prof, module, stage, &(timer)), acados_tic(&(timer)))
+
+#else
+
+#define OCP_NLP_PROFILING_NEW_CALL(prof) ((void) 0)
+#define OCP_NLP_PROFILING_NEW_ITER(prof, iter) ((void) 0)
+#define OCP_NLP_PROFILING_TIC(timer)
+#define OCP_NLP_PROFILING_TOC(prof, module, stage, timer) ((void) 0)
+#define OCP_NLP_PROFILING_LAP(prof, module, stage, timer) ((void) 0)
+
+#endif  // ACADOS_WITH_PROFILING
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // ACADOS_OCP_NLP_OCP_NLP_PROFILING_H_
@@ -181,6 +181,35 @@ void acados_reconstruct_A(int dim, double *A, double *V, double *d)
 
 
 
+// returns true if all eigenvalues of the symmetric matrix A are larger than shift,
+// i.e. if the Cholesky factorization A - shift*I = L * L' exists; L has size dim*dim
+bool acados_eig_larger_than(int dim, double *A, double shift, double *L)
+{
+    int i, j, k;
+    double tmp;
+
+    for (j=0; j<dim; j++)
+    {
+        tmp = A[j*dim+j] - shift;
+        for (k=0; k<j; k++)
+            tmp -= L[j*dim+k] * L[j*dim+k];
+        if (!(tmp > 0.0))  // also catches nan
+            return false;
+        L[j*dim+j] = sqrt(tmp);
+        for (i=j+1; i<dim; i++)
+        {
+            tmp = A[i*dim+j];
+            for (k=0; k<j; k++)
+                tmp -= L[i*dim+k] * L[j*dim+k];
+            L[i*dim+j] = tmp / L[j*dim+j];
+        }
+    }
+
+    return true;
+}
+
+
+
 // mirroring regularization
 void acados_mirror(int dim, double *A, double *V, double *d, double *e, double epsilon)
 {
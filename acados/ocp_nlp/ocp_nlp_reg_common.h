@@ -110,6 +110,7 @@ void *ocp_nlp_reg_config_assign(void *raw_memory);
 
 /* regularization help functions */
 void acados_reconstruct_A(int dim, double *A, double *V, double *d);
+bool acados_eig_larger_than(int dim, double *A, double shift, double *L);
 void acados_mirror(int dim, double *A, double *V, double *d, double *e, double epsilon);
 void acados_mirror_adaptive_eps(int dim, double *A, double *V, double *d, double *e, double max_cond_block, double min_eps);
 void acados_project(int dim, double *A, double *V, double *d, double *e, double epsilon);
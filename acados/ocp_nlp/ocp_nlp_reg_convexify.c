@@ -518,7 +518,7 @@ void ocp_nlp_reg_convexify_regularize(void *config, ocp_nlp_reg_dims *dims, void
     ocp_nlp_reg_convexify_memory *mem = mem_;
     ocp_nlp_reg_convexify_opts *opts = opts_;
 
-    int ii, jj;
+    int ii;
 
     int *nx = dims->nx;
     int *nu = dims->nu;
@@ -580,12 +580,9 @@ void ocp_nlp_reg_convexify_regularize(void *config, ocp_nlp_reg_dims *dims, void
         // blasfeo_print_dmat(nx+nu, nx, &BAQ, 0, 0);
 
         blasfeo_unpack_dmat(nu[ii], nu[ii], mem->RSQrq[ii], 0, 0, mem->R, nu[ii]);
-        acados_eigen_decomposition(nu[ii], mem->R, mem->V, mem->d, mem->e);
-
-        bool needs_regularization = false;
-        for (jj = 0; jj < nu[ii]; jj++)
-            if (mem->d[jj] < 1e-10)
-                needs_regularization = true;
+        // R needs regularization if it has an eigenvalue below 1e-10,
+        // checked with a Cholesky factorization of R - 1e-10*I (V as workspace)
+        bool needs_regularization = !acados_eig_larger_than(nu[ii], mem->R, 1e-10, mem->V);
 
         if (needs_regularization)
         {
@@ -657,7 +654,7 @@ void ocp_nlp_reg_convexify_regularize_lhs(void *config, ocp_nlp_reg_dims *dims,
     ocp_nlp_reg_convexify_memory *mem = mem_;
     ocp_nlp_reg_convexify_opts *opts = opts_;
 
-    int ii, jj;
+    int ii;
 
     int *nx = dims->nx;
     int *nu = dims->nu;
@@ -692,12 +689,9 @@ void ocp_nlp_reg_convexify_regularize_lhs(void *config, ocp_nlp_reg_dims *dims,
         // blasfeo_drowex(nu[ii]+nx[ii], 1.0, mem->RSQrq[ii], nu[ii]+nx[ii], 0, mem->rq[ii], 0);
 
         blasfeo_unpack_dmat(nu[ii], nu[ii], mem->RSQrq[ii], 0, 0, mem->R, nu[ii]);
-        acados_eigen_decomposition(nu[ii], mem->R, mem->V, mem->d, mem->e);
-
-        bool needs_regularization = false;
-        for (jj = 0; jj < nu[ii]; jj++)
-            if (mem->d[jj] < 1e-10)
-                needs_regularization = true;
+        // R needs regularization if it has an eigenvalue below 1e-10,
+        // checked with a Cholesky factorization of R - 1e-10*I (V as workspace)
+        bool needs_regularization = !acados_eig_larger_than(nu[ii], mem->R, 1e-10, mem->V);
 
         if (needs_regularization)
         {
@@ -744,7 +738,7 @@ void ocp_nlp_reg_convexify_regularize_rhs(void *config, ocp_nlp_reg_dims *dims,
     ocp_nlp_reg_convexify_memory *mem = mem_;
     ocp_nlp_reg_convexify_opts *opts = opts_;
 
-    int ii, jj;
+    int ii;
 
     int *nx = dims->nx;
     int *nu = dims->nu;
@@ -783,12 +777,9 @@ void ocp_nlp_reg_convexify_regularize_rhs(void *config, ocp_nlp_reg_dims *dims,
         blasfeo_drowex(nu[ii]+nx[ii], 1.0, mem->RSQrq[ii], nu[ii]+nx[ii], 0, mem->rq[ii], 0);
 
         blasfeo_unpack_dmat(nu[ii], nu[ii], mem->RSQrq[ii], 0, 0, mem->R, nu[ii]);
-        acados_eigen_decomposition(nu[ii], mem->R, mem->V, mem->d, mem->e);
-
-        bool needs_regularization = false;
-        for (jj = 0; jj < nu[ii]; jj++)
-            if (mem->d[jj] < 1e-10)
-                needs_regularization = true;
+        // R needs regularization if it has an eigenvalue below 1e-10,
+        // checked with a Cholesky factorization of R - 1e-10*I (V as workspace)
+        bool needs_regularization = !acados_eig_larger_than(nu[ii], mem->R, 1e-10, mem->V);
 
         if (needs_regularization)
         {
@@ -112,6 +112,8 @@ void *ocp_nlp_reg_mirror_memory_assign(void *config, ocp_nlp_reg_dims *dims, voi
 
 //
 void ocp_nlp_reg_mirror_config_initialize_default(ocp_nlp_reg_config *config);
+//
+void ocp_nlp_reg_mirror_regularize(void *config, ocp_nlp_reg_dims *dims, void *opts, void *mem);
 
 
 
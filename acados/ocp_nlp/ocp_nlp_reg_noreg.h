@@ -93,6 +93,8 @@ void *ocp_nlp_reg_noreg_memory_assign(void *config, ocp_nlp_reg_dims *dims, void
 
 //
 void ocp_nlp_reg_noreg_config_initialize_default(ocp_nlp_reg_config *config);
+//
+void ocp_nlp_reg_noreg_regularize(void *config, ocp_nlp_reg_dims *dims, void *opts, void *mem);
 
 
 
@@ -38,6 +38,7 @@
 
 #include "acados/ocp_nlp/ocp_nlp_reg_common.h"
 #include "acados/utils/math.h"
+#include "acados/utils/mem.h"
 
 #include "blasfeo_d_aux.h"
 #include "blasfeo_d_blas.h"
@@ -70,6 +71,8 @@ void ocp_nlp_reg_project_opts_initialize_default(void *config_, ocp_nlp_reg_dims
     opts->min_epsilon = 1e-8;
     opts->adaptive_eps = false;
     opts->max_cond_block = 1e7;
+    opts->warm_start = false;
+    opts->max_sweeps = 3;
 
     return;
 }
@@ -101,6 +104,16 @@ void ocp_nlp_reg_project_opts_set(void *config_, void *opts_, const char *field,
         bool *b_ptr = value;
         opts->adaptive_eps = *b_ptr;
     }
+    else if (!strcmp(field, "warm_start"))
+    {
+        bool *b_ptr = value;
+        opts->warm_start = *b_ptr;
+    }
+    else if (!strcmp(field, "max_sweeps"))
+    {
+        int *i_ptr = value;
+        opts->max_sweeps = *i_ptr;
+    }
     else
     {
         printf("\nerror: field %s not available in ocp_nlp_reg_project_opts_set\n", field);
@@ -122,22 +135,27 @@ acados_size_t ocp_nlp_reg_project_memory_calculate_size(void *config_, ocp_nlp_r
     int *nu = dims->nu;
     int N = dims->N;
 
-    int ii;
-
-    int nuxM = nu[0]+nx[0];
-    for(ii=1; ii<=N; ii++)
-    {
-        nuxM = nu[ii]+nx[ii]>nuxM ? nu[ii]+nx[ii] : nuxM;
-    }
+    int ii, nux;
 
     acados_size_t size = 0;
 
     size += sizeof(ocp_nlp_reg_project_memory);
 
-    size += nuxM*nuxM*sizeof(double);  // reg_hess
-    size += nuxM*nuxM*sizeof(double);  // V
-    size += 2*nuxM*sizeof(double);     // d e
+    size += 5*(N+1)*sizeof(double *);  // reg_hess V d e work
     size += (N+1)*sizeof(struct blasfeo_dmat *); // RSQrq
+    size += (N+1)*sizeof(int);  // V_valid
+
+    for(ii=0; ii<=N; ii++)
+    {
+        nux = nu[ii]+nx[ii];
+        size += nux*nux*sizeof(double);  // reg_hess
+        size += nux*nux*sizeof(double);  // V
+        size += 2*nux*sizeof(double);  // d e
+        size += 2*nux*nux*sizeof(double);  // work
+    }
+
+    size += 8;  // align
+    make_int_multiple_of(8, &size);
 
     return size;
 }
@@ -150,34 +168,38 @@ void *ocp_nlp_reg_project_memory_assign(void *config_, ocp_nlp_reg_dims *dims, v
     int *nu = dims->nu;
     int N = dims->N;
 
-    int ii;
-
-    int nuxM = nu[0]+nx[0];
-    for(ii=1; ii<=N; ii++)
-    {
-        nuxM = nu[ii]+nx[ii]>nuxM ? nu[ii]+nx[ii] : nuxM;
-    }
+    int ii, nux;
 
     char *c_ptr = (char *) raw_memory;
 
     ocp_nlp_reg_project_memory *mem = (ocp_nlp_reg_project_memory *) c_ptr;
     c_ptr += sizeof(ocp_nlp_reg_project_memory);
 
-    mem->reg_hess = (double *) c_ptr;
-    c_ptr += nuxM*nuxM*sizeof(double);  // reg_hess
-
-    mem->V = (double *) c_ptr;
-    c_ptr += nuxM*nuxM*sizeof(double);  // V
+    align_char_to(8, &c_ptr);
 
-    mem->d = (double *) c_ptr;
-    c_ptr += nuxM*sizeof(double); // d
-
-    mem->e = (double *) c_ptr;
-    c_ptr += nuxM*sizeof(double); // e
+    assign_and_advance_double_ptrs(N+1, &mem->reg_hess, &c_ptr);
+    assign_and_advance_double_ptrs(N+1, &mem->V, &c_ptr);
+    assign_and_advance_double_ptrs(N+1, &mem->d, &c_ptr);
+    assign_and_advance_double_ptrs(N+1, &mem->e, &c_ptr);
+    assign_and_advance_double_ptrs(N+1, &mem->work, &c_ptr);
 
     mem->RSQrq = (struct blasfeo_dmat **) c_ptr;
     c_ptr += (N+1)*sizeof(struct blasfeo_dmat *); // RSQrq
 
+    for(ii=0; ii<=N; ii++)
+    {
+        nux = nu[ii]+nx[ii];
+        assign_and_advance_double(nux*nux, &mem->reg_hess[ii], &c_ptr);
+        assign_and_advance_double(nux*nux, &mem->V[ii], &c_ptr);
+        assign_and_advance_double(nux, &mem->d[ii], &c_ptr);
+        assign_and_advance_double(nux, &mem->e[ii], &c_ptr);
+        assign_and_advance_double(2*nux*nux, &mem->work[ii], &c_ptr);
+    }
+
+    assign_and_advance_int(N+1, &mem->V_valid, &c_ptr);
+    for(ii=0; ii<=N; ii++)
+        mem->V_valid[ii] = 0;
+
     assert((char *) mem + ocp_nlp_reg_project_memory_calculate_size(config_, dims, opts_) >= c_ptr);
 
     return mem;
@@ -285,6 +307,68 @@ void ocp_nlp_reg_project_memory_set(void *config_, ocp_nlp_reg_dims *dims, void
  * functions
  ************************************************/
 
+static void ocp_nlp_reg_project_regularize_stage(ocp_nlp_reg_project_opts *opts,
+                                                 ocp_nlp_reg_project_memory *mem, int ii, int nux)
+{
+    int jj;
+    double eps, min_eig, max_eig;
+
+    double *reg_hess = mem->reg_hess[ii];
+    double *V = mem->V[ii];
+    double *d = mem->d[ii];
+
+    // make symmetric
+    blasfeo_dtrtr_l(nux, mem->RSQrq[ii], 0, 0, mem->RSQrq[ii], 0, 0);
+
+    // upper bound on the projection threshold
+    if (opts->adaptive_eps)
+    {
+        compute_gershgorin_max_abs_eig_estimate(nux, mem->RSQrq[ii], &max_eig);
+        eps = MAX(max_eig/opts->max_cond_block, opts->min_epsilon);
+    }
+    else
+    {
+        eps = opts->epsilon;
+    }
+
+    // the projection leaves the block unchanged if all eigenvalues are above eps:
+    // check with Gershgorin discs first, then with a Cholesky factorization
+    compute_gershgorin_min_eig_estimate(nux, mem->RSQrq[ii], &min_eig);
+    if (min_eig > eps)
+        return;
+
+    blasfeo_unpack_dmat(nux, nux, mem->RSQrq[ii], 0, 0, reg_hess, nux);
+    if (acados_eig_larger_than(nux, reg_hess, eps, mem->work[ii]))
+        return;
+
+    // eigen decomposition
+    if (!(opts->warm_start && mem->V_valid[ii] &&
+          acados_eigen_decomposition_warm(nux, reg_hess, V, d, mem->work[ii], opts->max_sweeps, 1e-14) == 0))
+    {
+        acados_eigen_decomposition(nux, reg_hess, V, d, mem->e[ii]);
+    }
+    mem->V_valid[ii] = 1;
+
+    // project
+    if (opts->adaptive_eps)
+    {
+        max_eig = 0.0;
+        for (jj = 0; jj < nux; jj++)
+            max_eig = MAX(max_eig, d[jj]);
+        eps = MAX(max_eig/opts->max_cond_block, opts->min_epsilon);
+    }
+    for (jj = 0; jj < nux; jj++)
+    {
+        if (d[jj] < eps)
+            d[jj] = eps;
+    }
+
+    acados_reconstruct_A(nux, reg_hess, V, d);
+    blasfeo_pack_dmat(nux, nux, reg_hess, nux, mem->RSQrq[ii], 0, 0);
+}
+
+
+
 void ocp_nlp_reg_project_regularize(void *config, ocp_nlp_reg_dims *dims, void *opts_, void *mem_)
 {
     ocp_nlp_reg_project_memory *mem = (ocp_nlp_reg_project_memory *) mem_;
@@ -295,22 +379,13 @@ void ocp_nlp_reg_project_regularize(void *config, ocp_nlp_reg_dims *dims, void *
     int *nx = dims->nx;
     int *nu = dims->nu;
 
+    // stages are independent
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for
+#endif
     for(ii=0; ii<=dims->N; ii++)
     {
-        // make symmetric
-        blasfeo_dtrtr_l(nu[ii]+nx[ii], mem->RSQrq[ii], 0, 0, mem->RSQrq[ii], 0, 0);
-
-        // regularize
-        blasfeo_unpack_dmat(nu[ii]+nx[ii], nu[ii]+nx[ii], mem->RSQrq[ii], 0, 0, mem->reg_hess, nu[ii]+nx[ii]);
-        if (opts->adaptive_eps)
-        {
-            acados_project_adaptive_eps(nu[ii]+nx[ii], mem->reg_hess, mem->V, mem->d, mem->e, opts->max_cond_block, opts->min_epsilon);
-        }
-        else
-        {
-            acados_project(nu[ii]+nx[ii], mem->reg_hess, mem->V, mem->d, mem->e, opts->epsilon);
-        }
-        blasfeo_pack_dmat(nu[ii]+nx[ii], nu[ii]+nx[ii], mem->reg_hess, nu[ii]+nx[ii], mem->RSQrq[ii], 0, 0);
+        ocp_nlp_reg_project_regularize_stage(opts, mem, ii, nu[ii]+nx[ii]);
     }
 }
 
@@ -67,6 +67,8 @@ typedef struct
     double min_epsilon;
     bool adaptive_eps;
     double max_cond_block;
+    bool warm_start;  // start eigen decomposition from the eigenvectors of the previous call
+    int max_sweeps;  // max number of Jacobi sweeps for warm started eigen decomposition
 } ocp_nlp_reg_project_opts;
 
 //
@@ -86,10 +88,13 @@ void ocp_nlp_reg_project_opts_set(void *config_, void *opts_, const char *field,
 
 typedef struct
 {
-    double *reg_hess; // TODO move to workspace
-    double *V; // TODO move to workspace
-    double *d; // TODO move to workspace
-    double *e; // TODO move to workspace
+    // per stage, such that stages can be regularized in parallel
+    double **reg_hess; // TODO move to workspace
+    double **V;  // eigenvectors, kept for warm start
+    double **d; // TODO move to workspace
+    double **e; // TODO move to workspace
+    double **work; // TODO move to workspace
+    int *V_valid;  // V[ii] holds an orthogonal basis from a previous call
 
     // giaf's
     struct blasfeo_dmat **RSQrq;  // pointer to RSQrq in qp_in
@@ -112,6 +117,8 @@ void *ocp_nlp_reg_project_memory_assign(void *config, ocp_nlp_reg_dims *dims, vo
 
 //
 void ocp_nlp_reg_project_config_initialize_default(ocp_nlp_reg_config *config);
+//
+void ocp_nlp_reg_project_regularize(void *config, ocp_nlp_reg_dims *dims, void *opts, void *mem);
 
 
 
@@ -0,0 +1,1146 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#include "acados/ocp_nlp/ocp_nlp_scenario_tree.h"
+
+// external
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(ACADOS_WITH_OPENMP)
+#include <omp.h>
+#endif
+
+// blasfeo
+#include "blasfeo_d_aux.h"
+#include "blasfeo_d_blas.h"
+// hpipm
+#include "hpipm/include/hpipm_d_ocp_qp.h"
+#include "hpipm/include/hpipm_d_ocp_qp_dim.h"
+#include "hpipm/include/hpipm_d_ocp_qp_sol.h"
+// acados
+#include "acados/ocp_nlp/ocp_nlp_reg_common.h"
+#include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/ocp_qp/ocp_qp_xcond_solver.h"
+#include "acados/utils/mem.h"
+#include "acados/utils/timing.h"
+
+
+
+/************************************************
+ * dims
+ ************************************************/
+
+static int ocp_nlp_scenario_tree_num_nodes(int n_realizations, int n_robust, int N)
+{
+    int num_nodes = 0;
+    int num_stage_nodes = 1;
+    for (int k = 0; k <= N; k++)
+    {
+        num_nodes += num_stage_nodes;
+        if (k < n_robust)
+            num_stage_nodes *= n_realizations;
+    }
+    return num_nodes;
+}
+
+
+
+static int ocp_nlp_scenario_tree_num_scenarios(int n_realizations, int n_robust)
+{
+    int num_scenarios = 1;
+    for (int k = 0; k < n_robust; k++)
+        num_scenarios *= n_realizations;
+    return num_scenarios;
+}
+
+
+
+acados_size_t ocp_nlp_scenario_tree_dims_calculate_size(int n_realizations, int n_robust, int N)
+{
+    int num_nodes = ocp_nlp_scenario_tree_num_nodes(n_realizations, n_robust, N);
+    int num_scenarios = ocp_nlp_scenario_tree_num_scenarios(n_realizations, n_robust);
+
+    acados_size_t size = 0;
+
+    size += sizeof(ocp_nlp_scenario_tree_dims);
+    size += sizeof(struct sctree);
+    size += sizeof(struct tree);
+    size += sizeof(struct d_tree_ocp_qp_dim);
+
+    size += num_scenarios * (N + 1) * sizeof(int);  // node
+    size += 2 * num_nodes * sizeof(int);  // node_stage, node_scenario
+    size += (num_scenarios + 1) * sizeof(int);  // eval_ptr
+    size += 2 * (num_nodes + num_scenarios) * sizeof(int);  // eval_stage, eval_full
+    size += 8 * num_nodes * sizeof(int);  // nx, nu, nbx, nbu, ng, nsbx, nsbu, nsg of the nodes
+
+    size += 2 * 8;
+    size += sctree_memsize(n_realizations, n_robust, N);
+    size += d_tree_ocp_qp_dim_memsize(num_nodes);
+
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+ocp_nlp_scenario_tree_dims *ocp_nlp_scenario_tree_dims_assign(ocp_nlp_dims *nlp_dims, int n_realizations,
+                                                              int n_robust, void *raw_memory)
+{
+    int N = nlp_dims->N;
+
+    if (n_realizations < 1 || n_robust < 0 || n_robust > N)
+    {
+        printf("\nerror: ocp_nlp_scenario_tree_dims_assign: got n_realizations = %d, n_robust = %d,"
+               " need n_realizations >= 1 and 0 <= n_robust <= N = %d.\n", n_realizations, n_robust, N);
+        exit(1);
+    }
+
+    int num_nodes = ocp_nlp_scenario_tree_num_nodes(n_realizations, n_robust, N);
+    int num_scenarios = ocp_nlp_scenario_tree_num_scenarios(n_realizations, n_robust);
+
+    char *c_ptr = (char *) raw_memory;
+
+    ocp_nlp_scenario_tree_dims *dims = (ocp_nlp_scenario_tree_dims *) c_ptr;
+    c_ptr += sizeof(ocp_nlp_scenario_tree_dims);
+
+    dims->sctree = (struct sctree *) c_ptr;
+    c_ptr += sizeof(struct sctree);
+    dims->tree = (struct tree *) c_ptr;
+    c_ptr += sizeof(struct tree);
+    dims->qp_dim = (struct d_tree_ocp_qp_dim *) c_ptr;
+    c_ptr += sizeof(struct d_tree_ocp_qp_dim);
+
+    assign_and_advance_int(num_scenarios * (N + 1), &dims->node, &c_ptr);
+    assign_and_advance_int(num_nodes, &dims->node_stage, &c_ptr);
+    assign_and_advance_int(num_nodes, &dims->node_scenario, &c_ptr);
+    assign_and_advance_int(num_scenarios + 1, &dims->eval_ptr, &c_ptr);
+    assign_and_advance_int(num_nodes + num_scenarios, &dims->eval_stage, &c_ptr);
+    assign_and_advance_int(num_nodes + num_scenarios, &dims->eval_full, &c_ptr);
+
+    int *nx, *nu, *nbx, *nbu, *ng, *nsbx, *nsbu, *nsg;
+    assign_and_advance_int(num_nodes, &nx, &c_ptr);
+    assign_and_advance_int(num_nodes, &nu, &c_ptr);
+    assign_and_advance_int(num_nodes, &nbx, &c_ptr);
+    assign_and_advance_int(num_nodes, &nbu, &c_ptr);
+    assign_and_advance_int(num_nodes, &ng, &c_ptr);
+    assign_and_advance_int(num_nodes, &nsbx, &c_ptr);
+    assign_and_advance_int(num_nodes, &nsbu, &c_ptr);
+    assign_and_advance_int(num_nodes, &nsg, &c_ptr);
+
+    dims->N = N;
+    dims->n_realizations = n_realizations;
+    dims->n_robust = n_robust;
+    dims->num_scenarios = num_scenarios;
+    dims->num_nodes = num_nodes;
+
+    // tree
+    align_char_to(8, &c_ptr);
+    sctree_create(n_realizations, n_robust, N, dims->sctree, c_ptr);
+    c_ptr += dims->sctree->memsize;
+    sctree_cast_to_tree(dims->sctree, dims->tree);
+
+    // map the stages of the scenarios to the nodes, the leaves are the scenarios
+    int s = 0;
+    for (int n = 0; n < num_nodes; n++)
+    {
+        struct node *leaf = dims->tree->root + n;
+        dims->node_stage[n] = leaf->stage;
+        if (leaf->nkids == 0)
+        {
+            for (int m = n; m >= 0; m = dims->tree->root[m].dad)
+                dims->node[s * (N + 1) + dims->tree->root[m].stage] = m;
+            s++;
+        }
+    }
+    assert(s == num_scenarios);
+
+    // the first scenario through a node provides its linearization
+    for (s = num_scenarios - 1; s >= 0; s--)
+        for (int k = 0; k <= N; k++)
+            dims->node_scenario[dims->node[s * (N + 1) + k]] = s;
+
+    // stage-wise linearizations: a scenario represents the nodes of its stages k0..N,
+    // stage k0-1 only provides the dynamics into the node of stage k0
+    int num_evals = 0;
+    for (s = 0; s < num_scenarios; s++)
+    {
+        dims->eval_ptr[s] = num_evals;
+        for (int k = 0; k <= N; k++)
+        {
+            int n = dims->node[s * (N + 1) + k];
+            if (dims->node_scenario[n] != s)
+                continue;
+            if (k > 0 && dims->node_scenario[dims->tree->root[n].dad] != s)
+            {
+                dims->eval_stage[num_evals] = k - 1;
+                dims->eval_full[num_evals] = 0;
+                num_evals++;
+            }
+            dims->eval_stage[num_evals] = k;
+            dims->eval_full[num_evals] = 1;
+            num_evals++;
+        }
+    }
+    dims->eval_ptr[num_scenarios] = num_evals;
+    dims->num_evals = num_evals;
+
+    dims->nv_max = 0;
+    dims->ni_max = 0;
+    for (int k = 0; k <= N; k++)
+    {
+        dims->nv_max = nlp_dims->nv[k] > dims->nv_max ? nlp_dims->nv[k] : dims->nv_max;
+        dims->ni_max = nlp_dims->ni[k] > dims->ni_max ? nlp_dims->ni[k] : dims->ni_max;
+    }
+
+    // node dimensions from the dimensions of the scenario QPs
+    ocp_qp_dims *qp_dims = nlp_dims->qp_solver->orig_dims;
+    for (int n = 0; n < num_nodes; n++)
+    {
+        int k = dims->node_stage[n];
+        nx[n] = qp_dims->nx[k];
+        nu[n] = qp_dims->nu[k];
+        nbx[n] = qp_dims->nbx[k];
+        nbu[n] = qp_dims->nbu[k];
+        ng[n] = qp_dims->ng[k];
+        nsbx[n] = qp_dims->nsbx[k];
+        nsbu[n] = qp_dims->nsbu[k];
+        nsg[n] = qp_dims->nsg[k];
+    }
+
+    align_char_to(8, &c_ptr);
+    d_tree_ocp_qp_dim_create(num_nodes, dims->qp_dim, c_ptr);
+    c_ptr += dims->qp_dim->memsize;
+    d_tree_ocp_qp_dim_set_all(dims->tree, nx, nu, nbx, nbu, ng, nsbx, nsbu, nsg, dims->qp_dim);
+
+    assert((char *) raw_memory + ocp_nlp_scenario_tree_dims_calculate_size(n_realizations, n_robust, N) >= c_ptr);
+
+    return dims;
+}
+
+
+
+/************************************************
+ * options
+ ************************************************/
+
+acados_size_t ocp_nlp_scenario_tree_opts_calculate_size(ocp_nlp_scenario_tree_dims *dims)
+{
+    acados_size_t size = 0;
+
+    size += sizeof(ocp_nlp_scenario_tree_opts);
+    size += sizeof(struct d_tree_ocp_qp_ipm_arg);
+    size += d_tree_ocp_qp_ipm_arg_memsize(dims->qp_dim);
+
+    size += 1 * 8;
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+ocp_nlp_scenario_tree_opts *ocp_nlp_scenario_tree_opts_assign(ocp_nlp_scenario_tree_dims *dims, void *raw_memory)
+{
+    char *c_ptr = (char *) raw_memory;
+
+    ocp_nlp_scenario_tree_opts *opts = (ocp_nlp_scenario_tree_opts *) c_ptr;
+    c_ptr += sizeof(ocp_nlp_scenario_tree_opts);
+
+    opts->hpipm_opts = (struct d_tree_ocp_qp_ipm_arg *) c_ptr;
+    c_ptr += sizeof(struct d_tree_ocp_qp_ipm_arg);
+
+    align_char_to(8, &c_ptr);
+    d_tree_ocp_qp_ipm_arg_create(dims->qp_dim, opts->hpipm_opts, c_ptr);
+    c_ptr += d_tree_ocp_qp_ipm_arg_memsize(dims->qp_dim);
+
+    assert((char *) raw_memory + ocp_nlp_scenario_tree_opts_calculate_size(dims) >= c_ptr);
+
+    return opts;
+}
+
+
+
+static void ocp_nlp_scenario_tree_overwrite_mode_opts(ocp_nlp_scenario_tree_opts *opts)
+{
+    // same defaults as ocp_qp_hpipm
+    opts->hpipm_opts->res_g_max = 1e-6;
+    opts->hpipm_opts->res_b_max = 1e-8;
+    opts->hpipm_opts->res_d_max = 1e-8;
+    opts->hpipm_opts->res_m_max = 1e-8;
+    opts->hpipm_opts->iter_max = 50;
+    opts->hpipm_opts->stat_max = 50;
+    opts->hpipm_opts->alpha_min = 1e-8;
+    opts->hpipm_opts->mu0 = 1e0;
+}
+
+
+
+void ocp_nlp_scenario_tree_opts_initialize_default(ocp_nlp_scenario_tree_dims *dims, ocp_nlp_scenario_tree_opts *opts)
+{
+    d_tree_ocp_qp_ipm_arg_set_default(BALANCE, opts->hpipm_opts);
+    ocp_nlp_scenario_tree_overwrite_mode_opts(opts);
+
+    opts->max_iter = 1;
+    opts->tol_stat = 1e-6;
+    opts->tol_eq = 1e-6;
+    opts->tol_ineq = 1e-6;
+    opts->tol_comp = 1e-6;
+    opts->tol_step = 1e-8;
+    opts->num_threads = 0;
+    opts->print_level = 0;
+
+    return;
+}
+
+
+
+void ocp_nlp_scenario_tree_opts_set(ocp_nlp_scenario_tree_opts *opts, const char *field, void *value)
+{
+    if (!strcmp(field, "max_iter"))
+    {
+        int *max_iter = (int *) value;
+        opts->max_iter = *max_iter;
+    }
+    else if (!strcmp(field, "nlp_tol_stat"))
+    {
+        double *tol_stat = (double *) value;
+        opts->tol_stat = *tol_stat;
+    }
+    else if (!strcmp(field, "nlp_tol_eq"))
+    {
+        double *tol_eq = (double *) value;
+        opts->tol_eq = *tol_eq;
+    }
+    else if (!strcmp(field, "nlp_tol_ineq"))
+    {
+        double *tol_ineq = (double *) value;
+        opts->tol_ineq = *tol_ineq;
+    }
+    else if (!strcmp(field, "nlp_tol_comp"))
+    {
+        double *tol_comp = (double *) value;
+        opts->tol_comp = *tol_comp;
+    }
+    else if (!strcmp(field, "tol_step"))
+    {
+        double *tol_step = (double *) value;
+        opts->tol_step = *tol_step;
+    }
+    else if (!strcmp(field, "num_threads"))
+    {
+        int *num_threads = (int *) value;
+        if (*num_threads > ACADOS_THREAD_POOL_MAX_THREADS)
+        {
+            printf("\nerror: ocp_nlp_scenario_tree_opts_set: num_threads must be <= %d, got %d.\n",
+                   ACADOS_THREAD_POOL_MAX_THREADS, *num_threads);
+            exit(1);
+        }
+#if !defined(ACADOS_WITH_THREAD_POOL)
+        if (*num_threads > 1)
+            printf("\nocp_nlp_scenario_tree_opts_set: acados was compiled without ACADOS_WITH_THREAD_POOL, ignoring num_threads.\n");
+#endif
+        opts->num_threads = *num_threads;
+    }
+    else if (!strcmp(field, "print_level"))
+    {
+        int *print_level = (int *) value;
+        opts->print_level = *print_level;
+    }
+    else if (!strcmp(field, "hpipm_mode"))
+    {
+        const char *mode = (const char *) value;
+        if (!strcmp(mode, "BALANCE"))
+            d_tree_ocp_qp_ipm_arg_set_default(BALANCE, opts->hpipm_opts);
+        else if (!strcmp(mode, "SPEED"))
+            d_tree_ocp_qp_ipm_arg_set_default(SPEED, opts->hpipm_opts);
+        else if (!strcmp(mode, "SPEED_ABS"))
+            d_tree_ocp_qp_ipm_arg_set_default(SPEED_ABS, opts->hpipm_opts);
+        else if (!strcmp(mode, "ROBUST"))
+            d_tree_ocp_qp_ipm_arg_set_default(ROBUST, opts->hpipm_opts);
+        else
+        {
+            printf("\nerror: ocp_nlp_scenario_tree_opts_set: hpipm_mode %s not supported.\n", mode);
+            exit(1);
+        }
+        ocp_nlp_scenario_tree_overwrite_mode_opts(opts);
+    }
+    else
+    {
+        d_tree_ocp_qp_ipm_arg_set((char *) field, value, opts->hpipm_opts);
+    }
+
+    return;
+}
+
+
+
+/************************************************
+ * memory
+ ************************************************/
+
+acados_size_t ocp_nlp_scenario_tree_memory_calculate_size(ocp_nlp_scenario_tree_dims *dims,
+                                                          ocp_nlp_scenario_tree_opts *opts)
+{
+    int num_scenarios = dims->num_scenarios;
+
+    acados_size_t size = 0;
+
+    size += sizeof(ocp_nlp_scenario_tree_memory);
+
+    size += num_scenarios * sizeof(ocp_nlp_in *);
+    size += num_scenarios * sizeof(ocp_nlp_out *);
+    size += num_scenarios * sizeof(ocp_nlp_opts *);
+    size += num_scenarios * sizeof(ocp_nlp_memory *);
+    size += num_scenarios * sizeof(ocp_nlp_workspace *);
+
+    size += sizeof(struct d_tree_ocp_qp);
+    size += sizeof(struct d_tree_ocp_qp_sol);
+    size += sizeof(struct d_tree_ocp_qp_ipm_ws);
+
+    size += 8;  // align doubles
+    size += num_scenarios * sizeof(double);  // probability
+    size += dims->num_nodes * sizeof(double);  // node_weight
+
+    int n_tmp = dims->nv_max > 2 * dims->ni_max ? dims->nv_max : 2 * dims->ni_max;
+    size += 64;  // align blasfeo memory
+    size += blasfeo_memsize_dvec(n_tmp);  // tmp
+
+    size += 3 * 8;
+    size += d_tree_ocp_qp_memsize(dims->qp_dim);
+    size += d_tree_ocp_qp_sol_memsize(dims->qp_dim);
+    size += d_tree_ocp_qp_ipm_ws_memsize(dims->qp_dim, opts->hpipm_opts);
+
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+static void ocp_nlp_scenario_tree_compute_node_weights(ocp_nlp_scenario_tree_dims *dims,
+                                                       ocp_nlp_scenario_tree_memory *mem)
+{
+    int N = dims->N;
+
+    for (int n = 0; n < dims->num_nodes; n++)
+        mem->node_weight[n] = 0.0;
+
+    for (int s = 0; s < dims->num_scenarios; s++)
+        for (int k = 0; k <= N; k++)
+            mem->node_weight[dims->node[s * (N + 1) + k]] += mem->probability[s];
+}
+
+
+
+ocp_nlp_scenario_tree_memory *ocp_nlp_scenario_tree_memory_assign(ocp_nlp_scenario_tree_dims *dims,
+                                        ocp_nlp_scenario_tree_opts *opts, void *raw_memory)
+{
+    int num_scenarios = dims->num_scenarios;
+
+    char *c_ptr = (char *) raw_memory;
+
+    ocp_nlp_scenario_tree_memory *mem = (ocp_nlp_scenario_tree_memory *) c_ptr;
+    c_ptr += sizeof(ocp_nlp_scenario_tree_memory);
+
+    mem->nlp_in = (ocp_nlp_in **) c_ptr;
+    c_ptr += num_scenarios * sizeof(ocp_nlp_in *);
+    mem->nlp_out = (ocp_nlp_out **) c_ptr;
+    c_ptr += num_scenarios * sizeof(ocp_nlp_out *);
+    mem->nlp_opts = (ocp_nlp_opts **) c_ptr;
+    c_ptr += num_scenarios * sizeof(ocp_nlp_opts *);
+    mem->nlp_mem = (ocp_nlp_memory **) c_ptr;
+    c_ptr += num_scenarios * sizeof(ocp_nlp_memory *);
+    mem->nlp_work = (ocp_nlp_workspace **) c_ptr;
+    c_ptr += num_scenarios * sizeof(ocp_nlp_workspace *);
+
+    mem->qp = (struct d_tree_ocp_qp *) c_ptr;
+    c_ptr += sizeof(struct d_tree_ocp_qp);
+    mem->qp_sol = (struct d_tree_ocp_qp_sol *) c_ptr;
+    c_ptr += sizeof(struct d_tree_ocp_qp_sol);
+    mem->qp_ws = (struct d_tree_ocp_qp_ipm_ws *) c_ptr;
+    c_ptr += sizeof(struct d_tree_ocp_qp_ipm_ws);
+
+    align_char_to(8, &c_ptr);
+    assign_and_advance_double(num_scenarios, &mem->probability, &c_ptr);
+    assign_and_advance_double(dims->num_nodes, &mem->node_weight, &c_ptr);
+
+    int n_tmp = dims->nv_max > 2 * dims->ni_max ? dims->nv_max : 2 * dims->ni_max;
+    align_char_to(64, &c_ptr);
+    assign_and_advance_blasfeo_dvec_mem(n_tmp, &mem->tmp, &c_ptr);
+
+    align_char_to(8, &c_ptr);
+    d_tree_ocp_qp_create(dims->qp_dim, mem->qp, c_ptr);
+    c_ptr += mem->qp->memsize;
+
+    align_char_to(8, &c_ptr);
+    d_tree_ocp_qp_sol_create(dims->qp_dim, mem->qp_sol, c_ptr);
+    c_ptr += mem->qp_sol->memsize;
+
+    align_char_to(8, &c_ptr);
+    d_tree_ocp_qp_ipm_ws_create(dims->qp_dim, opts->hpipm_opts, mem->qp_ws, c_ptr);
+    c_ptr += mem->qp_ws->memsize;
+
+    for (int s = 0; s < num_scenarios; s++)
+    {
+        mem->nlp_in[s] = NULL;
+        mem->nlp_out[s] = NULL;
+        mem->nlp_opts[s] = NULL;
+        mem->nlp_mem[s] = NULL;
+        mem->nlp_work[s] = NULL;
+        mem->probability[s] = 1.0 / num_scenarios;
+    }
+    ocp_nlp_scenario_tree_compute_node_weights(dims, mem);
+
+    mem->status = ACADOS_READY;
+    mem->iter = 0;
+    mem->qp_status = 0;
+    mem->qp_iter = 0;
+    mem->step_norm = 0.0;
+    mem->res_stat = 0.0;
+    mem->res_eq = 0.0;
+    mem->res_ineq = 0.0;
+    mem->res_comp = 0.0;
+    mem->thread_pool = NULL;
+    mem->time_tot = 0.0;
+    mem->time_lin = 0.0;
+    mem->time_qp = 0.0;
+
+    assert((char *) raw_memory + ocp_nlp_scenario_tree_memory_calculate_size(dims, opts) >= c_ptr);
+
+    return mem;
+}
+
+
+
+void ocp_nlp_scenario_tree_memory_set_scenario(ocp_nlp_scenario_tree_dims *dims, ocp_nlp_scenario_tree_memory *mem,
+                                        int scenario, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out,
+                                        ocp_nlp_opts *nlp_opts, ocp_nlp_memory *nlp_mem, ocp_nlp_workspace *nlp_work)
+{
+    if (scenario < 0 || scenario >= dims->num_scenarios)
+    {
+        printf("\nerror: ocp_nlp_scenario_tree_memory_set_scenario: scenario %d out of range [0, %d).\n",
+               scenario, dims->num_scenarios);
+        exit(1);
+    }
+
+    mem->nlp_in[scenario] = nlp_in;
+    mem->nlp_out[scenario] = nlp_out;
+    mem->nlp_opts[scenario] = nlp_opts;
+    mem->nlp_mem[scenario] = nlp_mem;
+    mem->nlp_work[scenario] = nlp_work;
+}
+
+
+
+void ocp_nlp_scenario_tree_memory_set(ocp_nlp_scenario_tree_dims *dims, ocp_nlp_scenario_tree_memory *mem,
+                                      const char *field, void *value)
+{
+    if (!strcmp(field, "probabilities"))
+    {
+        double *probabilities = (double *) value;
+        double sum = 0.0;
+        for (int s = 0; s < dims->num_scenarios; s++)
+        {
+            if (probabilities[s] <= 0.0)
+            {
+                printf("\nerror: ocp_nlp_scenario_tree_memory_set: probabilities must be positive,"
+                       " got %e for scenario %d.\n", probabilities[s], s);
+                exit(1);
+            }
+            sum += probabilities[s];
+        }
+        // normalize
+        for (int s = 0; s < dims->num_scenarios; s++)
+            mem->probability[s] = probabilities[s] / sum;
+        ocp_nlp_scenario_tree_compute_node_weights(dims, mem);
+    }
+    else
+    {
+        printf("\nerror: ocp_nlp_scenario_tree_memory_set: field %s not available.\n", field);
+        exit(1);
+    }
+}
+
+
+
+void ocp_nlp_scenario_tree_memory_get(ocp_nlp_scenario_tree_dims *dims, ocp_nlp_scenario_tree_memory *mem,
+                                      const char *field, void *value)
+{
+    if (!strcmp(field, "status"))
+    {
+        *((int *) value) = mem->status;
+    }
+    else if (!strcmp(field, "sqp_iter"))
+    {
+        *((int *) value) = mem->iter;
+    }
+    else if (!strcmp(field, "qp_status"))
+    {
+        *((int *) value) = mem->qp_status;
+    }
+    else if (!strcmp(field, "qp_iter"))
+    {
+        *((int *) value) = mem->qp_iter;
+    }
+    else if (!strcmp(field, "step_norm"))
+    {
+        *((double *) value) = mem->step_norm;
+    }
+    else if (!strcmp(field, "res_stat"))
+    {
+        *((double *) value) = mem->res_stat;
+    }
+    else if (!strcmp(field, "res_eq"))
+    {
+        *((double *) value) = mem->res_eq;
+    }
+    else if (!strcmp(field, "res_ineq"))
+    {
+        *((double *) value) = mem->res_ineq;
+    }
+    else if (!strcmp(field, "res_comp"))
+    {
+        *((double *) value) = mem->res_comp;
+    }
+    else if (!strcmp(field, "time_tot"))
+    {
+        *((double *) value) = mem->time_tot;
+    }
+    else if (!strcmp(field, "time_lin"))
+    {
+        *((double *) value) = mem->time_lin;
+    }
+    else if (!strcmp(field, "time_qp"))
+    {
+        *((double *) value) = mem->time_qp;
+    }
+    else if (!strcmp(field, "num_scenarios"))
+    {
+        *((int *) value) = dims->num_scenarios;
+    }
+    else if (!strcmp(field, "num_nodes"))
+    {
+        *((int *) value) = dims->num_nodes;
+    }
+    else
+    {
+        printf("\nerror: ocp_nlp_scenario_tree_memory_get: field %s not available.\n", field);
+        exit(1);
+    }
+}
+
+
+
+/************************************************
+ * functions
+ ************************************************/
+
+// linearizes stage k of scenario s into its QP, only the dynamics if !full
+static void ocp_nlp_scenario_tree_linearize_stage(ocp_nlp_config *config, ocp_nlp_dims *nlp_dims,
+                                                  ocp_nlp_scenario_tree_memory *mem, int s, int k, int full)
+{
+    ocp_nlp_in *nlp_in = mem->nlp_in[s];
+    ocp_nlp_opts *nlp_opts = mem->nlp_opts[s];
+    ocp_nlp_memory *nlp_mem = mem->nlp_mem[s];
+    ocp_nlp_workspace *nlp_work = mem->nlp_work[s];
+
+    int N = nlp_dims->N;
+    int *nv = nlp_dims->nv;
+    int *nx = nlp_dims->nx;
+    int *nu = nlp_dims->nu;
+
+    // dynamics: NOTE: has to be first, as it computes z, which is used in cost and constraints.
+    if (k < N)
+    {
+        config->dynamics[k]->initialize(config->dynamics[k], nlp_dims->dynamics[k], nlp_in->dynamics[k],
+                                        nlp_opts->dynamics[k], nlp_mem->dynamics[k], nlp_work->dynamics[k]);
+        config->dynamics[k]->update_qp_matrices(config->dynamics[k], nlp_dims->dynamics[k], nlp_in->dynamics[k],
+                                        nlp_opts->dynamics[k], nlp_mem->dynamics[k], nlp_work->dynamics[k]);
+        struct blasfeo_dvec *dyn_fun = config->dynamics[k]->memory_get_fun_ptr(nlp_mem->dynamics[k]);
+        blasfeo_dveccp(nx[k+1], dyn_fun, 0, nlp_mem->dyn_fun+k, 0);
+        blasfeo_dveccp(nx[k+1], nlp_mem->dyn_fun+k, 0, nlp_mem->qp_in->b+k, 0);
+    }
+    if (!full)
+        return;
+
+    // cost
+    config->cost[k]->initialize(config->cost[k], nlp_dims->cost[k], nlp_in->cost[k],
+                                nlp_opts->cost[k], nlp_mem->cost[k], nlp_work->cost[k]);
+    config->cost[k]->update_qp_matrices(config->cost[k], nlp_dims->cost[k], nlp_in->cost[k],
+                                nlp_opts->cost[k], nlp_mem->cost[k], nlp_work->cost[k]);
+    struct blasfeo_dvec *cost_grad = config->cost[k]->memory_get_grad_ptr(nlp_mem->cost[k]);
+    blasfeo_dveccp(nv[k], cost_grad, 0, nlp_mem->cost_grad+k, 0);
+    blasfeo_dveccp(nv[k], nlp_mem->cost_grad+k, 0, nlp_mem->qp_in->rqz+k, 0);
+
+    // constraints
+    config->constraints[k]->initialize(config->constraints[k], nlp_dims->constraints[k], nlp_in->constraints[k],
+                                nlp_opts->constraints[k], nlp_mem->constraints[k], nlp_work->constraints[k]);
+    config->constraints[k]->update_qp_matrices(config->constraints[k], nlp_dims->constraints[k],
+                                nlp_in->constraints[k], nlp_opts->constraints[k], nlp_mem->constraints[k],
+                                nlp_work->constraints[k]);
+    struct blasfeo_dvec *ineq_adj = config->constraints[k]->memory_get_adj_ptr(nlp_mem->constraints[k]);
+    blasfeo_dveccp(nv[k], ineq_adj, 0, nlp_mem->ineq_adj+k, 0);
+    ocp_nlp_approximate_qp_vectors_sqp_constraints(config, nlp_dims, nlp_in, nlp_opts, nlp_mem, nlp_work, k);
+
+    // Levenberg-Marquardt term
+    if (nlp_mem->compute_hess && nlp_opts->levenberg_marquardt > 0.0)
+    {
+        double scaling_factor;
+        config->cost[k]->model_get(config->cost[k], nlp_dims->cost[k], nlp_in->cost[k], "scaling", &scaling_factor);
+        blasfeo_ddiare(nu[k]+nx[k], scaling_factor*nlp_opts->levenberg_marquardt, nlp_mem->qp_in->RSQrq+k, 0, 0);
+    }
+}
+
+
+
+// linearizes the stages of scenario s that are used by the tree QP and regularizes its QP,
+// the remaining stages are stale but stage-wise regularizations do not couple them to the others
+static void ocp_nlp_scenario_tree_linearize_scenario(ocp_nlp_config *config, ocp_nlp_dims *nlp_dims,
+                                ocp_nlp_scenario_tree_dims *dims, ocp_nlp_scenario_tree_memory *mem, int s)
+{
+    for (int e = dims->eval_ptr[s]; e < dims->eval_ptr[s+1]; e++)
+        ocp_nlp_scenario_tree_linearize_stage(config, nlp_dims, mem, s, dims->eval_stage[e], dims->eval_full[e]);
+
+    config->regularize->regularize(config->regularize, nlp_dims->regularize, mem->nlp_opts[s]->regularize,
+                                   mem->nlp_mem[s]->regularize_mem);
+}
+
+
+
+// copies stage k of the QP of the scenario that represents node n into the tree QP,
+// the cost is weighted with the probability of the node
+static void ocp_nlp_scenario_tree_assemble_node(ocp_nlp_scenario_tree_dims *dims,
+                                                ocp_nlp_scenario_tree_memory *mem, int n)
+{
+    struct d_tree_ocp_qp_dim *qp_dim = dims->qp_dim;
+    struct d_tree_ocp_qp *qp = mem->qp;
+
+    int k = dims->node_stage[n];
+    ocp_qp_in *qp_in = mem->nlp_mem[dims->node_scenario[n]]->qp_in;
+    double weight = mem->node_weight[n];
+
+    int nx = qp_dim->nx[n];
+    int nu = qp_dim->nu[n];
+    int nb = qp_dim->nb[n];
+    int ng = qp_dim->ng[n];
+    int ns = qp_dim->ns[n];
+
+    // dynamics from the parent node
+    if (n > 0)
+    {
+        int nx0 = qp_in->dim->nx[k-1];
+        int nu0 = qp_in->dim->nu[k-1];
+        blasfeo_dgecp(nu0+nx0+1, nx, qp_in->BAbt+k-1, 0, 0, qp->BAbt+n-1, 0, 0);
+        blasfeo_dveccp(nx, qp_in->b+k-1, 0, qp->b+n-1, 0);
+    }
+
+    // cost
+    blasfeo_dgecpsc(nu+nx+1, nu+nx, weight, qp_in->RSQrq+k, 0, 0, qp->RSQrq+n, 0, 0);
+    blasfeo_dveccpsc(nu+nx+2*ns, weight, qp_in->rqz+k, 0, qp->rqz+n, 0);
+    blasfeo_dveccpsc(2*ns, weight, qp_in->Z+k, 0, qp->Z+n, 0);
+
+    // constraints
+    blasfeo_dgecp(nu+nx, ng, qp_in->DCt+k, 0, 0, qp->DCt+n, 0, 0);
+    blasfeo_dveccp(2*nb+2*ng+2*ns, qp_in->d+k, 0, qp->d+n, 0);
+    blasfeo_dveccp(2*nb+2*ng+2*ns, qp_in->d_mask+k, 0, qp->d_mask+n, 0);
+    blasfeo_dveccp(2*nb+2*ng+2*ns, qp_in->m+k, 0, qp->m+n, 0);
+    for (int i = 0; i < nb; i++)
+        qp->idxb[n][i] = qp_in->idxb[k][i];
+    for (int i = 0; i < nb+ng; i++)
+        qp->idxs_rev[n][i] = qp_in->idxs_rev[k][i];
+}
+
+
+
+// expands the tree QP solution to the QP solution of scenario s,
+// the multipliers are scaled back with the probabilities of the nodes
+static void ocp_nlp_scenario_tree_expand_scenario(ocp_nlp_scenario_tree_dims *dims,
+                                                  ocp_nlp_scenario_tree_memory *mem, int s)
+{
+    struct d_tree_ocp_qp_dim *qp_dim = dims->qp_dim;
+    struct d_tree_ocp_qp_sol *qp_sol = mem->qp_sol;
+    ocp_qp_out *qp_out = mem->nlp_mem[s]->qp_out;
+
+    int N = dims->N;
+    int *node = dims->node + s * (N + 1);
+
+    for (int k = 0; k <= N; k++)
+    {
+        int n = node[k];
+        int nx = qp_dim->nx[n];
+        int nu = qp_dim->nu[n];
+        int nb = qp_dim->nb[n];
+        int ng = qp_dim->ng[n];
+        int ns = qp_dim->ns[n];
+
+        blasfeo_dveccp(nu+nx+2*ns, qp_sol->ux+n, 0, qp_out->ux+k, 0);
+        blasfeo_dveccpsc(2*nb+2*ng+2*ns, 1.0/mem->node_weight[n], qp_sol->lam+n, 0, qp_out->lam+k, 0);
+        blasfeo_dveccp(2*nb+2*ng+2*ns, qp_sol->t+n, 0, qp_out->t+k, 0);
+        if (k < N)
+        {
+            int n1 = node[k+1];
+            blasfeo_dveccpsc(qp_dim->nx[n1], 1.0/mem->node_weight[n1], qp_sol->pi+n1-1, 0, qp_out->pi+k, 0);
+        }
+    }
+}
+
+
+
+// updates the iterate of scenario s with the full step of the tree QP
+static void ocp_nlp_scenario_tree_update_scenario(ocp_nlp_config *config, ocp_nlp_dims *nlp_dims,
+                                ocp_nlp_scenario_tree_dims *dims, ocp_nlp_scenario_tree_memory *mem, int s)
+{
+    ocp_nlp_scenario_tree_expand_scenario(dims, mem, s);
+    ocp_nlp_update_variables_sqp(config, nlp_dims, mem->nlp_in[s], mem->nlp_out[s], mem->nlp_mem[s]->qp_out,
+        mem->nlp_opts[s], mem->nlp_mem[s], mem->nlp_work[s], mem->nlp_out[s], NULL, 1.0, true);
+}
+
+
+
+// copies the iterate of the scenario that represents a node to all scenarios through the node,
+// such that the iterates are non-anticipative from the start
+static void ocp_nlp_scenario_tree_synchronize(ocp_nlp_dims *nlp_dims, ocp_nlp_scenario_tree_dims *dims,
+                                              ocp_nlp_scenario_tree_memory *mem)
+{
+    int N = dims->N;
+    int *nv = nlp_dims->nv;
+    int *nx = nlp_dims->nx;
+    int *ni = nlp_dims->ni;
+
+    for (int s = 0; s < dims->num_scenarios; s++)
+    {
+        ocp_nlp_out *out = mem->nlp_out[s];
+        for (int k = 0; k <= N; k++)
+        {
+            int n = dims->node[s * (N + 1) + k];
+            ocp_nlp_out *out_n = mem->nlp_out[dims->node_scenario[n]];
+            if (out_n == out)
+                continue;
+            blasfeo_dveccp(nv[k], out_n->ux+k, 0, out->ux+k, 0);
+            blasfeo_dveccp(2*ni[k], out_n->lam+k, 0, out->lam+k, 0);
+            if (k < N)
+            {
+                // pi of stage k belongs to the edge into the node of stage k+1
+                ocp_nlp_out *out_n1 = mem->nlp_out[dims->node_scenario[dims->node[s * (N + 1) + k + 1]]];
+                blasfeo_dveccp(nx[k+1], out_n1->pi+k, 0, out->pi+k, 0);
+            }
+        }
+    }
+}
+
+
+
+// KKT residuals of the tree NLP, the multipliers of the scenarios are not weighted,
+// thus the stationarity of a node is divided by its weight
+static void ocp_nlp_scenario_tree_compute_residuals(ocp_nlp_config *config, ocp_nlp_dims *nlp_dims,
+                                ocp_nlp_scenario_tree_dims *dims, ocp_nlp_scenario_tree_memory *mem)
+{
+    struct tree *tree = dims->tree;
+    struct blasfeo_dvec *tmp = &mem->tmp;
+
+    int *nv = nlp_dims->nv;
+    int *nx = nlp_dims->nx;
+    int *nu = nlp_dims->nu;
+    int *ni = nlp_dims->ni;
+
+    double norm;
+    mem->res_stat = 0.0;
+    mem->res_eq = 0.0;
+    mem->res_ineq = 0.0;
+    mem->res_comp = 0.0;
+
+    for (int n = 0; n < dims->num_nodes; n++)
+    {
+        int k = dims->node_stage[n];
+        int s = dims->node_scenario[n];
+        ocp_nlp_memory *nlp_mem = mem->nlp_mem[s];
+
+        // stationarity: cost - constraints - dynamics into the children - dynamics from the parent
+        blasfeo_daxpy(nv[k], -1.0, nlp_mem->ineq_adj+k, 0, nlp_mem->cost_grad+k, 0, tmp, 0);
+        for (int c = 0; c < tree->root[n].nkids; c++)
+        {
+            int n1 = tree->root[n].kids[c];
+            ocp_nlp_memory *nlp_mem1 = mem->nlp_mem[dims->node_scenario[n1]];
+            struct blasfeo_dvec *dyn_adj = config->dynamics[k]->memory_get_adj_ptr(nlp_mem1->dynamics[k]);
+            blasfeo_daxpy(nu[k]+nx[k], -mem->node_weight[n1]/mem->node_weight[n], dyn_adj, 0, tmp, 0, tmp, 0);
+        }
+        if (n > 0)
+        {
+            struct blasfeo_dvec *dyn_adj = config->dynamics[k-1]->memory_get_adj_ptr(nlp_mem->dynamics[k-1]);
+            blasfeo_daxpy(nx[k], -1.0, dyn_adj, nu[k-1]+nx[k-1], tmp, nu[k], tmp, nu[k]);
+        }
+        blasfeo_dvecnrm_inf(nv[k], tmp, 0, &norm);
+        mem->res_stat = norm > mem->res_stat ? norm : mem->res_stat;
+
+        // dynamics from the parent
+        if (n > 0)
+        {
+            blasfeo_dvecnrm_inf(nx[k], nlp_mem->dyn_fun+k-1, 0, &norm);
+            mem->res_eq = norm > mem->res_eq ? norm : mem->res_eq;
+        }
+
+        // inequalities
+        for (int j = 0; j < 2*ni[k]; j++)
+        {
+            double ineq = BLASFEO_DVECEL(nlp_mem->ineq_fun+k, j);
+            mem->res_ineq = ineq > mem->res_ineq ? ineq : mem->res_ineq;
+        }
+
+        // complementarity, zero for equalities
+        if (ni[k] > 0)
+        {
+            ocp_qp_in *qp_in = nlp_mem->qp_in;
+            blasfeo_dvecmul(2*ni[k], mem->nlp_out[s]->lam+k, 0, nlp_mem->ineq_fun+k, 0, tmp, 0);
+            int ne = qp_in->dim->nbue[k] + qp_in->dim->nbxe[k] + qp_in->dim->nge[k];
+            for (int j = 0; j < ne; j++)
+            {
+                BLASFEO_DVECEL(tmp, qp_in->idxe[k][j]) = 0.0;
+                BLASFEO_DVECEL(tmp, qp_in->idxe[k][j]+ni[k]) = 0.0;
+            }
+            blasfeo_dvecnrm_inf(2*ni[k], tmp, 0, &norm);
+            mem->res_comp = norm > mem->res_comp ? norm : mem->res_comp;
+        }
+    }
+}
+
+
+
+#if defined(ACADOS_WITH_THREAD_POOL)
+/* scenario-wise evaluations on the persistent worker pool */
+enum
+{
+    OCP_NLP_SCENARIO_TREE_POOL_JOB_LINEARIZE = 0,
+    OCP_NLP_SCENARIO_TREE_POOL_JOB_UPDATE,
+    OCP_NLP_SCENARIO_TREE_POOL_NUM_JOBS
+};
+
+typedef struct
+{
+    ocp_nlp_config *config;
+    ocp_nlp_dims *nlp_dims;
+    ocp_nlp_scenario_tree_dims *dims;
+    ocp_nlp_scenario_tree_memory *mem;
+} ocp_nlp_scenario_tree_pool_args;
+
+static void ocp_nlp_scenario_tree_linearize_task(void *args_, int phase, int s)
+{
+    ocp_nlp_scenario_tree_pool_args *args = args_;
+    ocp_nlp_scenario_tree_linearize_scenario(args->config, args->nlp_dims, args->dims, args->mem, s);
+}
+
+static void ocp_nlp_scenario_tree_update_task(void *args_, int phase, int s)
+{
+    ocp_nlp_scenario_tree_pool_args *args = args_;
+    ocp_nlp_scenario_tree_update_scenario(args->config, args->nlp_dims, args->dims, args->mem, s);
+}
+#endif
+
+
+
+int ocp_nlp_scenario_tree_solve(ocp_nlp_config *config, ocp_nlp_dims *nlp_dims, ocp_nlp_scenario_tree_dims *dims,
+                                ocp_nlp_scenario_tree_opts *opts, ocp_nlp_scenario_tree_memory *mem)
+{
+    acados_timer timer_tot, timer;
+    acados_tic(&timer_tot);
+
+    int num_scenarios = dims->num_scenarios;
+    int num_nodes = dims->num_nodes;
+
+    for (int s = 0; s < num_scenarios; s++)
+    {
+        if (mem->nlp_mem[s] == NULL)
+        {
+            printf("\nerror: ocp_nlp_scenario_tree_solve: scenario %d not set.\n", s);
+            exit(1);
+        }
+        if (mem->nlp_opts[s]->with_adaptive_levenberg_marquardt)
+        {
+            printf("\nerror: ocp_nlp_scenario_tree_solve: adaptive Levenberg-Marquardt not supported.\n");
+            exit(1);
+        }
+    }
+
+#if defined(ACADOS_WITH_THREAD_POOL)
+    if (mem->thread_pool != NULL && acados_thread_pool_get_num_threads(mem->thread_pool) != opts->num_threads)
+    {
+        acados_thread_pool_destroy(mem->thread_pool);
+        mem->thread_pool = NULL;
+    }
+    if (mem->thread_pool == NULL && opts->num_threads > 1)
+    {
+        mem->thread_pool = acados_thread_pool_create(opts->num_threads, NULL, ACADOS_THREAD_POOL_DEFAULT_SPIN_COUNT,
+                                OCP_NLP_SCENARIO_TREE_POOL_NUM_JOBS, num_scenarios);
+        if (mem->thread_pool == NULL)
+            printf("\nocp_nlp_scenario_tree_solve: could not create thread pool, using serial evaluation.\n");
+    }
+    ocp_nlp_scenario_tree_pool_args args = {config, nlp_dims, dims, mem};
+#endif
+
+    ocp_nlp_scenario_tree_synchronize(nlp_dims, dims, mem);
+
+    // a single iteration is a real-time iteration and succeeds with the QP
+    int rti = opts->max_iter == 1;
+    mem->status = ACADOS_MAXITER;
+    mem->time_lin = 0.0;
+    mem->time_qp = 0.0;
+    mem->qp_iter = 0;
+    mem->step_norm = 0.0;
+
+    int iter;
+    for (iter = 0; ; iter++)
+    {
+        // linearize the stages used by the nodes
+        acados_tic(&timer);
+#if defined(ACADOS_WITH_THREAD_POOL)
+        if (mem->thread_pool != NULL)
+        {
+            acados_thread_pool_run(mem->thread_pool, OCP_NLP_SCENARIO_TREE_POOL_JOB_LINEARIZE, 1, num_scenarios,
+                                   &ocp_nlp_scenario_tree_linearize_task, &args);
+        }
+        else
+#endif
+        {
+#if defined(ACADOS_WITH_OPENMP)
+            #pragma omp parallel for
+#endif
+            for (int s = 0; s < num_scenarios; s++)
+            {
+                ocp_nlp_scenario_tree_linearize_scenario(config, nlp_dims, dims, mem, s);
+            }
+        }
+        mem->time_lin += acados_toc(&timer);
+
+        if (!rti)
+        {
+            ocp_nlp_scenario_tree_compute_residuals(config, nlp_dims, dims, mem);
+            if (opts->print_level > 0)
+            {
+                printf("scenario tree iter %d: res_stat %e, res_eq %e, res_ineq %e, res_comp %e\n", iter,
+                       mem->res_stat, mem->res_eq, mem->res_ineq, mem->res_comp);
+            }
+            if (mem->res_stat < opts->tol_stat && mem->res_eq < opts->tol_eq &&
+                mem->res_ineq < opts->tol_ineq && mem->res_comp < opts->tol_comp)
+            {
+                mem->status = ACADOS_SUCCESS;
+                break;
+            }
+            if (iter == opts->max_iter)
+            {
+                mem->status = ACADOS_MAXITER;
+                break;
+            }
+        }
+
+        // tree QP
+        acados_tic(&timer);
+        for (int n = 0; n < num_nodes; n++)
+            ocp_nlp_scenario_tree_assemble_node(dims, mem, n);
+
+        d_tree_ocp_qp_ipm_solve(mem->qp, mem->qp_sol, opts->hpipm_opts, mem->qp_ws);
+        int qp_iter;
+        d_tree_ocp_qp_ipm_get_status(mem->qp_ws, &mem->qp_status);
+        d_tree_ocp_qp_ipm_get_iter(mem->qp_ws, &qp_iter);
+        mem->qp_iter += qp_iter;
+        mem->time_qp += acados_toc(&timer);
+
+        if (opts->print_level > 0)
+        {
+            printf("scenario tree iter %d: qp_status %d, qp_iter %d\n", iter, mem->qp_status, qp_iter);
+        }
+
+        if (mem->qp_status != SUCCESS && mem->qp_status != MAX_ITER)
+        {
+            mem->status = ACADOS_QP_FAILURE;
+            break;
+        }
+
+        // update the iterates of all scenarios
+        acados_tic(&timer);
+#if defined(ACADOS_WITH_THREAD_POOL)
+        if (mem->thread_pool != NULL)
+        {
+            acados_thread_pool_run(mem->thread_pool, OCP_NLP_SCENARIO_TREE_POOL_JOB_UPDATE, 1, num_scenarios,
+                                   &ocp_nlp_scenario_tree_update_task, &args);
+        }
+        else
+#endif
+        {
+#if defined(ACADOS_WITH_OPENMP)
+            #pragma omp parallel for
+#endif
+            for (int s = 0; s < num_scenarios; s++)
+            {
+                ocp_nlp_scenario_tree_update_scenario(config, nlp_dims, dims, mem, s);
+            }
+        }
+        mem->time_lin += acados_toc(&timer);
+
+        mem->step_norm = 0.0;
+        for (int n = 0; n < num_nodes; n++)
+        {
+            double norm;
+            blasfeo_dvecnrm_inf(dims->qp_dim->nu[n]+dims->qp_dim->nx[n], mem->qp_sol->ux+n, 0, &norm);
+            mem->step_norm = norm > mem->step_norm ? norm : mem->step_norm;
+        }
+
+        if (rti)
+        {
+            mem->status = ACADOS_SUCCESS;
+            iter++;
+            break;
+        }
+        if (mem->step_norm <= opts->tol_step)
+        {
+            mem->status = ACADOS_MINSTEP;
+            iter++;
+            break;
+        }
+    }
+
+    mem->iter = iter;
+    mem->time_tot = acados_toc(&timer_tot);
+
+    return mem->status;
+}
+
+
+
+void ocp_nlp_scenario_tree_terminate(ocp_nlp_scenario_tree_memory *mem)
+{
+#if defined(ACADOS_WITH_THREAD_POOL)
+    acados_thread_pool_destroy(mem->thread_pool);
+    mem->thread_pool = NULL;
+#endif
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+/// \addtogroup ocp_nlp
+/// @{
+/// \addtogroup ocp_nlp_solver
+/// @{
+/// \addtogroup ocp_nlp_scenario_tree ocp_nlp_scenario_tree
+/// @{
+
+#ifndef ACADOS_OCP_NLP_OCP_NLP_SCENARIO_TREE_H_
+#define ACADOS_OCP_NLP_OCP_NLP_SCENARIO_TREE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// hpipm
+#include "hpipm/include/hpipm_d_tree_ocp_qp.h"
+#include "hpipm/include/hpipm_d_tree_ocp_qp_dim.h"
+#include "hpipm/include/hpipm_d_tree_ocp_qp_ipm.h"
+#include "hpipm/include/hpipm_d_tree_ocp_qp_sol.h"
+#include "hpipm/include/hpipm_scenario_tree.h"
+#include "hpipm/include/hpipm_tree.h"
+// acados
+#include "acados/ocp_nlp/ocp_nlp_common.h"
+#include "acados/utils/thread_pool.h"
+#include "acados/utils/types.h"
+
+// Scenario-tree (multi-stage) OCP: every node up to stage n_robust branches into n_realizations children,
+// which gives n_realizations^n_robust scenarios. Each scenario is a chain OCP with N stages, all sharing
+// config and dims, and differing only in their parameters. Stage k of all scenarios with the same
+// realizations up to stage k is mapped to the same node of a tree-structured QP solved by HPIPM, which
+// enforces non-anticipativity without equality constraints and keeps the Riccati structure.
+// Only the stages needed by the nodes are linearized: stage k of the scenario that represents a node,
+// and the dynamics into a node if its scenario does not represent the parent node.
+// Regularization is applied to the scenario QPs, thus only stage-wise methods (MIRROR, PROJECT) are supported.
+// With an exact Hessian, the Hessian of the dynamics out of a branching node is the one of its first child.
+
+
+
+/************************************************
+ * dims
+ ************************************************/
+
+typedef struct
+{
+    int N;                  // number of stages of each scenario
+    int n_realizations;     // number of children of the nodes up to the robust horizon
+    int n_robust;           // robust horizon
+    int num_scenarios;      // n_realizations^n_robust, i.e. number of leaves
+    int num_nodes;
+
+    int *node;              // node of stage k of scenario s: node[s*(N+1)+k]
+    int *node_stage;
+    int *node_scenario;     // scenario whose linearization is used at the node
+
+    int num_evals;          // stage-wise linearizations per iteration, sorted by scenario
+    int *eval_ptr;          // evals of scenario s: eval_ptr[s] to eval_ptr[s+1]
+    int *eval_stage;
+    int *eval_full;         // 1: dynamics, cost and constraints of the stage, 0: dynamics only
+    int nv_max;             // max nv and ni of the scenario stages
+    int ni_max;
+
+    struct sctree *sctree;
+    struct tree *tree;
+    struct d_tree_ocp_qp_dim *qp_dim;
+} ocp_nlp_scenario_tree_dims;
+
+//
+acados_size_t ocp_nlp_scenario_tree_dims_calculate_size(int n_realizations, int n_robust, int N);
+// sets up the tree and the QP dimensions from the dimensions of the scenario QPs
+ocp_nlp_scenario_tree_dims *ocp_nlp_scenario_tree_dims_assign(ocp_nlp_dims *nlp_dims, int n_realizations,
+                                                              int n_robust, void *raw_memory);
+
+
+
+/************************************************
+ * options
+ ************************************************/
+
+typedef struct
+{
+    struct d_tree_ocp_qp_ipm_arg *hpipm_opts;
+    int max_iter;       // number of SQP iterations, 1 corresponds to a real-time iteration
+    double tol_stat;    // tolerances on the KKT residuals of the tree NLP, not checked for max_iter == 1
+    double tol_eq;
+    double tol_ineq;
+    double tol_comp;
+    double tol_step;    // stop with ACADOS_MINSTEP if the max norm of the primal step is below
+    int num_threads;    // size of the thread pool for the linearizations, <= 1: no pool, needs ACADOS_WITH_THREAD_POOL
+    int print_level;
+} ocp_nlp_scenario_tree_opts;
+
+//
+acados_size_t ocp_nlp_scenario_tree_opts_calculate_size(ocp_nlp_scenario_tree_dims *dims);
+//
+ocp_nlp_scenario_tree_opts *ocp_nlp_scenario_tree_opts_assign(ocp_nlp_scenario_tree_dims *dims, void *raw_memory);
+//
+void ocp_nlp_scenario_tree_opts_initialize_default(ocp_nlp_scenario_tree_dims *dims, ocp_nlp_scenario_tree_opts *opts);
+// fields: max_iter, nlp_tol_stat, nlp_tol_eq, nlp_tol_ineq, nlp_tol_comp, tol_step, num_threads, print_level,
+// hpipm_mode and the options of the HPIPM tree IPM, e.g. iter_max, tol_stat
+void ocp_nlp_scenario_tree_opts_set(ocp_nlp_scenario_tree_opts *opts, const char *field, void *value);
+
+
+
+/************************************************
+ * memory
+ ************************************************/
+
+typedef struct
+{
+    // scenarios
+    ocp_nlp_in **nlp_in;
+    ocp_nlp_out **nlp_out;
+    ocp_nlp_opts **nlp_opts;
+    ocp_nlp_memory **nlp_mem;
+    ocp_nlp_workspace **nlp_work;
+
+    double *probability;    // of the scenarios
+    double *node_weight;    // sum of the probabilities of the scenarios through the node
+
+    struct d_tree_ocp_qp *qp;
+    struct d_tree_ocp_qp_sol *qp_sol;
+    struct d_tree_ocp_qp_ipm_ws *qp_ws;
+
+    struct blasfeo_dvec tmp;  // size max(nv_max, 2*ni_max)
+
+    // persistent worker pool, created in solve, freed in terminate
+    acados_thread_pool *thread_pool;
+
+    int status;
+    int iter;
+    int qp_status;
+    int qp_iter;
+    double step_norm;
+    double res_stat;    // KKT residuals of the tree NLP at the last linearization
+    double res_eq;
+    double res_ineq;
+    double res_comp;
+
+    double time_tot;
+    double time_lin;
+    double time_qp;
+} ocp_nlp_scenario_tree_memory;
+
+//
+acados_size_t ocp_nlp_scenario_tree_memory_calculate_size(ocp_nlp_scenario_tree_dims *dims,
+                                                          ocp_nlp_scenario_tree_opts *opts);
+//
+ocp_nlp_scenario_tree_memory *ocp_nlp_scenario_tree_memory_assign(ocp_nlp_scenario_tree_dims *dims,
+                                        ocp_nlp_scenario_tree_opts *opts, void *raw_memory);
+//
+void ocp_nlp_scenario_tree_memory_set_scenario(ocp_nlp_scenario_tree_dims *dims, ocp_nlp_scenario_tree_memory *mem,
+                                        int scenario, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out,
+                                        ocp_nlp_opts *nlp_opts, ocp_nlp_memory *nlp_mem, ocp_nlp_workspace *nlp_work);
+// fields: probabilities (double, num_scenarios, positive)
+void ocp_nlp_scenario_tree_memory_set(ocp_nlp_scenario_tree_dims *dims, ocp_nlp_scenario_tree_memory *mem,
+                                      const char *field, void *value);
+// fields: status, sqp_iter, qp_status, qp_iter (int), step_norm, res_stat, res_eq, res_ineq, res_comp,
+// time_tot, time_lin, time_qp (double)
+void ocp_nlp_scenario_tree_memory_get(ocp_nlp_scenario_tree_dims *dims, ocp_nlp_scenario_tree_memory *mem,
+                                      const char *field, void *value);
+
+
+
+/************************************************
+ * functions
+ ************************************************/
+
+// SQP iterations with full steps on all scenarios: the stages needed by the nodes are linearized in parallel,
+// the tree QP is solved with HPIPM and its solution is expanded to the scenario iterates
+int ocp_nlp_scenario_tree_solve(ocp_nlp_config *config, ocp_nlp_dims *nlp_dims, ocp_nlp_scenario_tree_dims *dims,
+                                ocp_nlp_scenario_tree_opts *opts, ocp_nlp_scenario_tree_memory *mem);
+// frees the thread pool
+void ocp_nlp_scenario_tree_terminate(ocp_nlp_scenario_tree_memory *mem);
+
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // ACADOS_OCP_NLP_OCP_NLP_SCENARIO_TREE_H_
+/// @}
+/// @}
+/// @}
@@ -500,6 +500,7 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 
     // zero timers
     ocp_nlp_timings_reset(nlp_timings);
+    OCP_NLP_PROFILING_NEW_CALL(nlp_mem->profiling);
 
     int qp_status = 0;
     int qp_iter = 0;
@@ -587,6 +588,7 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
         acados_tic(&timer1);
         ocp_nlp_qpscaling_scale_qp(dims->qpscaling, nlp_opts->qpscaling, nlp_mem->qpscaling, qp_in);
         nlp_timings->time_qpscaling += acados_toc(&timer1);
+        OCP_NLP_PROFILING_TOC(nlp_mem->profiling, OCP_NLP_PROFILING_QPSCALING, 0, timer1);
 
         // regularize Hessian
         // NOTE: this is done before termination, such that we can get the QP at the stationary point that is actually solved, if we exit with success.
@@ -594,6 +596,7 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
         config->regularize->regularize(config->regularize, dims->regularize,
                                                nlp_opts->regularize, nlp_mem->regularize_mem);
         nlp_timings->time_reg += acados_toc(&timer1);
+        OCP_NLP_PROFILING_TOC(nlp_mem->profiling, OCP_NLP_PROFILING_REGULARIZE, 0, timer1);
 
         // update timeout memory based on chosen heuristic
         if (opts->timeout_max_time > 0.)
@@ -769,6 +772,7 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
         acados_tic(&timer1);
         globalization_status = config->globalization->find_acceptable_iterate(config, dims, nlp_in, nlp_out, nlp_mem, mem, nlp_work, nlp_opts, &mem->alpha);
         nlp_timings->time_glob += acados_toc(&timer1);
+        OCP_NLP_PROFILING_TOC(nlp_mem->profiling, OCP_NLP_PROFILING_GLOBALIZATION, 0, timer1);
 
         if (globalization_status != ACADOS_SUCCESS)
         {
@@ -998,6 +1002,7 @@ void ocp_nlp_sqp_terminate(void *config_, void *mem_, void *work_)
     ocp_nlp_sqp_workspace *work = work_;
 
     config->qp_solver->terminate(config->qp_solver, mem->nlp_mem->qp_solver_mem, work->nlp_work->qp_work);
+    ocp_nlp_terminate_common(mem->nlp_mem);
 }
 
 bool ocp_nlp_sqp_is_real_time_algorithm()
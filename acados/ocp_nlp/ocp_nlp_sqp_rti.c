@@ -120,6 +120,7 @@ void ocp_nlp_sqp_rti_opts_initialize_default(void *config_,
     opts->as_rti_iter = 0;
     opts->rti_log_residuals = 0;
     opts->rti_log_only_available_residuals = 0;
+    opts->rti_fast_feedback = 0;
 
     return;
 }
@@ -185,6 +186,11 @@ void ocp_nlp_sqp_rti_opts_set(void *config_, void *opts_,
             int* rti_log_only_available_residuals = (int *) value;
             opts->rti_log_only_available_residuals = *rti_log_only_available_residuals;
         }
+        else if (!strcmp(field, "rti_fast_feedback"))
+        {
+            int* rti_fast_feedback = (int *) value;
+            opts->rti_fast_feedback = *rti_fast_feedback;
+        }
         else if (!strcmp(field, "as_rti_level"))
         {
             int* as_rti_level = (int *) value;
@@ -295,6 +301,7 @@ void *ocp_nlp_sqp_rti_memory_assign(void *config_, void *dims_,
 
     mem->nlp_mem->status = ACADOS_READY;
     mem->is_first_call = true;
+    mem->qp_rhs_prepared = false;
 
     assert((char *) raw_memory+ocp_nlp_sqp_rti_memory_calculate_size(
         config, dims, opts, in) >= c_ptr);
@@ -362,6 +369,7 @@ static void reset_stats_and_sub_timers(ocp_nlp_sqp_rti_memory *mem)
     mem->nlp_mem->nlp_timings->time_qp_xcond = 0.0;
     mem->nlp_mem->nlp_timings->time_glob = 0.0;
     mem->nlp_mem->iter = 0;
+    OCP_NLP_PROFILING_NEW_CALL(mem->nlp_mem->profiling);
 }
 
 
@@ -489,12 +497,31 @@ static void ocp_nlp_sqp_rti_preparation_step(ocp_nlp_config *config, ocp_nlp_dim
         config->regularize->regularize_lhs(config->regularize,
             dims->regularize, opts->nlp_opts->regularize, nlp_mem->regularize_mem);
         timings->time_reg += acados_toc(&timer1);
+        OCP_NLP_PROFILING_TOC(nlp_mem->profiling, OCP_NLP_PROFILING_REGULARIZE, 0, timer1);
         // condense lhs
         acados_tic(&timer1);
         qp_solver->condense_lhs(qp_solver, dims->qp_solver,
             nlp_mem->qp_in, nlp_mem->qp_out, opts->nlp_opts->qp_solver_opts,
             nlp_mem->qp_solver_mem, nlp_work->qp_work);
         timings->time_qp_sol += acados_toc(&timer1);
+
+        if (opts->rti_fast_feedback)
+        {
+            // update QP rhs of all stages, only the stage 0 bounds are updated in the feedback phase
+            acados_tic(&timer1);
+            ocp_nlp_approximate_qp_vectors_sqp(config, dims, nlp_in,
+                nlp_out, nlp_opts, nlp_mem, nlp_work);
+            timings->time_lin += acados_toc(&timer1);
+
+            // NOTE: the regularization modules do not modify the bounds
+            acados_tic(&timer1);
+            config->regularize->regularize_rhs(config->regularize,
+                dims->regularize, opts->nlp_opts->regularize, nlp_mem->regularize_mem);
+            timings->time_reg += acados_toc(&timer1);
+            OCP_NLP_PROFILING_TOC(nlp_mem->profiling, OCP_NLP_PROFILING_REGULARIZE, 0, timer1);
+
+            mem->qp_rhs_prepared = true;
+        }
     }
 #if defined(ACADOS_WITH_OPENMP)
     // restore number of threads
@@ -521,9 +548,20 @@ static void ocp_nlp_sqp_rti_feedback_step(ocp_nlp_config *config, ocp_nlp_dims *
 
     // update QP rhs for SQP (step prim var, abs dual var)
     acados_tic(&timer1);
-    ocp_nlp_approximate_qp_vectors_sqp(config, dims, nlp_in,
-        nlp_out, nlp_opts, nlp_mem, nlp_work);
-    timings->time_lin += acados_toc(&timer1);
+    bool qp_rhs_prepared = mem->qp_rhs_prepared && opts->rti_phase == FEEDBACK;
+    if (qp_rhs_prepared)
+    {
+        // only the stage 0 bounds, which contain x0, changed since the preparation phase
+        ocp_nlp_approximate_qp_vectors_sqp_constraints(config, dims, nlp_in, nlp_opts, nlp_mem, nlp_work, 0);
+    }
+    else
+    {
+        ocp_nlp_approximate_qp_vectors_sqp(config, dims, nlp_in,
+            nlp_out, nlp_opts, nlp_mem, nlp_work);
+    }
+    mem->qp_rhs_prepared = false;
+    timings->time_feedback_rhs = acados_toc(&timer1);
+    timings->time_lin += timings->time_feedback_rhs;
 
     if (opts->rti_log_residuals)
     {
@@ -536,9 +574,12 @@ static void ocp_nlp_sqp_rti_feedback_step(ocp_nlp_config *config, ocp_nlp_dims *
     acados_tic(&timer1);
     if (opts->rti_phase == FEEDBACK)
     {
-        // finish regularization
-        config->regularize->regularize_rhs(config->regularize,
-            dims->regularize, opts->nlp_opts->regularize, nlp_mem->regularize_mem);
+        // finish regularization, unless done in the preparation phase
+        if (!qp_rhs_prepared)
+        {
+            config->regularize->regularize_rhs(config->regularize,
+                dims->regularize, opts->nlp_opts->regularize, nlp_mem->regularize_mem);
+        }
     }
     else if (opts->rti_phase == PREPARATION_AND_FEEDBACK)
     {
@@ -551,6 +592,7 @@ static void ocp_nlp_sqp_rti_feedback_step(ocp_nlp_config *config, ocp_nlp_dims *
         printf("ocp_nlp_sqp_rti_feedback_step: rti_phase must be FEEDBACK or PREPARATION_AND_FEEDBACK\n");
     }
     timings->time_reg += acados_toc(&timer1);
+    OCP_NLP_PROFILING_TOC(nlp_mem->profiling, OCP_NLP_PROFILING_REGULARIZE, 0, timer1);
 
     if (nlp_opts->print_level > 0) {
         printf("\n------- qp_in --------\n");
@@ -626,6 +668,7 @@ static void ocp_nlp_sqp_rti_feedback_step(ocp_nlp_config *config, ocp_nlp_dims *
     acados_tic(&timer1);
     globalization_status = config->globalization->find_acceptable_iterate(config, dims, nlp_in, nlp_out, nlp_mem, mem, nlp_work, nlp_opts, &step_size);
     timings->time_glob += acados_toc(&timer1);
+    OCP_NLP_PROFILING_TOC(nlp_mem->profiling, OCP_NLP_PROFILING_GLOBALIZATION, 0, timer1);
 
     if (globalization_status != ACADOS_SUCCESS)
     {
@@ -1407,6 +1450,7 @@ void ocp_nlp_sqp_rti_terminate(void *config_, void *mem_, void *work_)
     ocp_nlp_sqp_rti_workspace *work = work_;
 
     config->qp_solver->terminate(config->qp_solver, mem->nlp_mem->qp_solver_mem, work->nlp_work->qp_work);
+    ocp_nlp_terminate_common(mem->nlp_mem);
 }
 
 
@@ -86,6 +86,9 @@ typedef struct
     int as_rti_iter;
     int rti_log_residuals;
     int rti_log_only_available_residuals;
+    // evaluate the QP rhs in the preparation phase, such that only the stage 0 bounds
+    // are updated in the feedback phase; bounds on stages > 0 have to be set before preparation
+    int rti_fast_feedback;
 
 } ocp_nlp_sqp_rti_opts;
 
@@ -120,6 +123,7 @@ typedef struct
     int stat_n;
 
     bool is_first_call;
+    bool qp_rhs_prepared;  // QP rhs of stages > 0 evaluated in the last preparation phase
 
 } ocp_nlp_sqp_rti_memory;
 
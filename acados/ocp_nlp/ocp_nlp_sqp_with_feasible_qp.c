@@ -965,6 +965,7 @@ static int prepare_and_solve_QP(ocp_nlp_config* config, ocp_nlp_sqp_wfqp_opts* o
         // regularize Hessian
         config->regularize->regularize(config->regularize, dims->regularize, nlp_opts->regularize, nlp_mem->regularize_mem);
         nlp_timings->time_reg += acados_toc(&timer);
+        OCP_NLP_PROFILING_TOC(nlp_mem->profiling, OCP_NLP_PROFILING_REGULARIZE, 0, timer);
     }
 
     // Show input to QP
@@ -994,6 +995,7 @@ static int prepare_and_solve_QP(ocp_nlp_config* config, ocp_nlp_sqp_wfqp_opts* o
             acados_tic(&timer);
             ocp_nlp_qpscaling_rescale_solution(dims->relaxed_qpscaling, nlp_opts->qpscaling, mem->relaxed_qpscaling_mem, qp_in, qp_out);
             nlp_timings->time_qpscaling += acados_toc(&timer);
+            OCP_NLP_PROFILING_TOC(nlp_mem->profiling, OCP_NLP_PROFILING_QPSCALING, 0, timer);
         }
     }
     else
@@ -1544,6 +1546,7 @@ int ocp_nlp_sqp_wfqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 
     // zero timers
     ocp_nlp_timings_reset(nlp_timings);
+    OCP_NLP_PROFILING_NEW_CALL(nlp_mem->profiling);
 
     int qp_status = 0;
     int qp_iter = 0;
@@ -1665,11 +1668,13 @@ int ocp_nlp_sqp_wfqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
         acados_tic(&timer1);
         ocp_nlp_qpscaling_scale_qp(dims->qpscaling, nlp_opts->qpscaling, nlp_mem->qpscaling, nominal_qp_in);
         nlp_timings->time_qpscaling += acados_toc(&timer1);
+        OCP_NLP_PROFILING_TOC(nlp_mem->profiling, OCP_NLP_PROFILING_QPSCALING, 0, timer1);
         ocp_nlp_sqp_wfqp_approximate_feasibility_qp_constraint_vectors(config, dims, nlp_in, nlp_out, nlp_opts, mem, nlp_work, true);
 
         acados_tic(&timer1);
         ocp_nlp_qpscaling_scale_qp(dims->relaxed_qpscaling, nlp_opts->qpscaling, mem->relaxed_qpscaling_mem, mem->relaxed_qp_in); // ensures feasibility constraint Hessian is scaled
         nlp_timings->time_qpscaling += acados_toc(&timer1);
+        OCP_NLP_PROFILING_TOC(nlp_mem->profiling, OCP_NLP_PROFILING_QPSCALING, 0, timer1);
 
         /* Search Direction Computation */
         search_direction_status = calculate_search_direction(dims, config, opts, nlp_opts, nlp_in, nlp_out, mem, work, timer_tot);
@@ -1727,6 +1732,7 @@ int ocp_nlp_sqp_wfqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 
         mem->stat[mem->stat_n*(nlp_mem->iter+1)+10] = mem->alpha;
         nlp_timings->time_glob += acados_toc(&timer1);
+        OCP_NLP_PROFILING_TOC(nlp_mem->profiling, OCP_NLP_PROFILING_GLOBALIZATION, 0, timer1);
 
     }  // end SQP loop
 
@@ -2037,6 +2043,7 @@ void ocp_nlp_sqp_wfqp_terminate(void *config_, void *mem_, void *work_)
     ocp_nlp_sqp_wfqp_workspace *work = work_;
 
     config->qp_solver->terminate(config->qp_solver, mem->nlp_mem->qp_solver_mem, work->nlp_work->qp_work);
+    ocp_nlp_terminate_common(mem->nlp_mem);
 }
 
 
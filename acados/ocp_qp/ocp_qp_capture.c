@@ -0,0 +1,552 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// standard
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define OCP_QP_CAPTURE_MMAP
+#endif
+// blasfeo
+#include "blasfeo_d_aux.h"
+// acados
+#include "acados/ocp_qp/ocp_qp_capture.h"
+#include "acados/utils/mem.h"
+
+
+
+#define OCP_QP_CAPTURE_HEADER_SIZE 16
+#define OCP_QP_CAPTURE_RECORD_HEADER_SIZE 4  // in ints
+#define OCP_QP_CAPTURE_BYTE_ORDER_MARK 0x01020304
+
+static const char ocp_qp_capture_magic[8] = {'A', 'C', 'A', 'D', 'O', 'S', 'Q', 'P'};
+
+
+
+/************************************************
+ * serialization
+ ************************************************/
+
+static void ocp_qp_capture_dims_fields(ocp_qp_dims *dims, int **fields)
+{
+    fields[0] = dims->nx;
+    fields[1] = dims->nu;
+    fields[2] = dims->nb;
+    fields[3] = dims->nbx;
+    fields[4] = dims->nbu;
+    fields[5] = dims->ng;
+    fields[6] = dims->ns;
+    fields[7] = dims->nsbx;
+    fields[8] = dims->nsbu;
+    fields[9] = dims->nsg;
+    fields[10] = dims->nbxe;
+    fields[11] = dims->nbue;
+    fields[12] = dims->nge;
+}
+
+
+
+static void ocp_qp_capture_count(ocp_qp_dims *dims, acados_size_t *num_int, acados_size_t *num_double)
+{
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *nb = dims->nb;
+    int *ng = dims->ng;
+    int *ns = dims->ns;
+
+    *num_int = OCP_QP_CAPTURE_RECORD_HEADER_SIZE + OCP_QP_CAPTURE_NUM_DIMS * (N+1);
+    *num_double = 0;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nv = nu[ii] + nx[ii];
+        int nx1 = ii < N ? nx[ii+1] : 0;
+        int ni2 = 2*nb[ii] + 2*ng[ii] + 2*ns[ii];
+
+        // idxb, idxs_rev, idxe, diag_H_flag
+        *num_int += nb[ii] + nb[ii]+ng[ii] + dims->nbxe[ii]+dims->nbue[ii]+dims->nge[ii] + 1;
+
+        // qp_in: BAbt, RSQrq, DCt, b, rqz, d, d_mask, m, Z
+        *num_double += (nv+1)*nx1 + (nv+1)*nv + nv*ng[ii] + nx1 + nv+2*ns[ii] + 3*ni2 + 2*ns[ii];
+        // qp_out: ux, pi, lam, t
+        *num_double += nv+2*ns[ii] + nx1 + 2*ni2;
+    }
+}
+
+
+
+static acados_size_t ocp_qp_capture_record_size(ocp_qp_dims *dims)
+{
+    acados_size_t num_int, num_double;
+    ocp_qp_capture_count(dims, &num_int, &num_double);
+
+    acados_size_t size = num_int * sizeof(int);
+    make_int_multiple_of(8, &size);
+    size += num_double * sizeof(double);
+
+    return size;
+}
+
+
+
+// write == 1: copy from the blasfeo structs to the buffer, otherwise the other way round.
+// the structs may be NULL, then the buffer is skipped.
+static void ocp_qp_capture_dmat(int write, int m, int n, struct blasfeo_dmat *sA, double **ptr)
+{
+    if (sA != NULL)
+    {
+        for (int jj = 0; jj < n; jj++)
+        {
+            for (int ii = 0; ii < m; ii++)
+            {
+                if (write)
+                    (*ptr)[ii+m*jj] = BLASFEO_DMATEL(sA, ii, jj);
+                else
+                    BLASFEO_DMATEL(sA, ii, jj) = (*ptr)[ii+m*jj];
+            }
+        }
+    }
+    *ptr += m*n;
+}
+
+
+
+static void ocp_qp_capture_dvec(int write, int m, struct blasfeo_dvec *sv, double **ptr)
+{
+    if (sv != NULL)
+    {
+        for (int ii = 0; ii < m; ii++)
+        {
+            if (write)
+                (*ptr)[ii] = BLASFEO_DVECEL(sv, ii);
+            else
+                BLASFEO_DVECEL(sv, ii) = (*ptr)[ii];
+        }
+    }
+    *ptr += m;
+}
+
+
+
+static void ocp_qp_capture_int(int write, int n, int *v, int **ptr)
+{
+    if (write)
+        memcpy(*ptr, v, n*sizeof(int));
+    else
+        memcpy(v, *ptr, n*sizeof(int));
+    *ptr += n;
+}
+
+
+
+// serializes the record body after the dimensions
+static void ocp_qp_capture_data(int write, ocp_qp_dims *dims, ocp_qp_in *qp_in, ocp_qp_out *qp_out,
+                                int *i_ptr)
+{
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *nb = dims->nb;
+    int *ng = dims->ng;
+    int *ns = dims->ns;
+
+    int ii;
+
+    // ints
+    for (ii = 0; ii <= N; ii++)
+    {
+        ocp_qp_capture_int(write, nb[ii], qp_in->idxb[ii], &i_ptr);
+        ocp_qp_capture_int(write, nb[ii]+ng[ii], qp_in->idxs_rev[ii], &i_ptr);
+        ocp_qp_capture_int(write, dims->nbxe[ii]+dims->nbue[ii]+dims->nge[ii], qp_in->idxe[ii], &i_ptr);
+        ocp_qp_capture_int(write, 1, qp_in->diag_H_flag+ii, &i_ptr);
+    }
+
+    char *c_ptr = (char *) i_ptr;
+    align_char_to(8, &c_ptr);
+    double *d_ptr = (double *) c_ptr;
+
+    // qp_in
+    for (ii = 0; ii <= N; ii++)
+    {
+        int nv = nu[ii] + nx[ii];
+        int ni2 = 2*nb[ii] + 2*ng[ii] + 2*ns[ii];
+        if (ii < N)
+        {
+            ocp_qp_capture_dmat(write, nv+1, nx[ii+1], qp_in->BAbt+ii, &d_ptr);
+        }
+        ocp_qp_capture_dmat(write, nv+1, nv, qp_in->RSQrq+ii, &d_ptr);
+        ocp_qp_capture_dmat(write, nv, ng[ii], qp_in->DCt+ii, &d_ptr);
+        if (ii < N)
+        {
+            ocp_qp_capture_dvec(write, nx[ii+1], qp_in->b+ii, &d_ptr);
+        }
+        ocp_qp_capture_dvec(write, nv+2*ns[ii], qp_in->rqz+ii, &d_ptr);
+        ocp_qp_capture_dvec(write, ni2, qp_in->d+ii, &d_ptr);
+        ocp_qp_capture_dvec(write, ni2, qp_in->d_mask+ii, &d_ptr);
+        ocp_qp_capture_dvec(write, ni2, qp_in->m+ii, &d_ptr);
+        ocp_qp_capture_dvec(write, 2*ns[ii], qp_in->Z+ii, &d_ptr);
+    }
+
+    // qp_out
+    for (ii = 0; ii <= N; ii++)
+    {
+        int nv = nu[ii] + nx[ii];
+        int ni2 = 2*nb[ii] + 2*ng[ii] + 2*ns[ii];
+        ocp_qp_capture_dvec(write, nv+2*ns[ii], qp_out == NULL ? NULL : qp_out->ux+ii, &d_ptr);
+        if (ii < N)
+        {
+            ocp_qp_capture_dvec(write, nx[ii+1], qp_out == NULL ? NULL : qp_out->pi+ii, &d_ptr);
+        }
+        ocp_qp_capture_dvec(write, ni2, qp_out == NULL ? NULL : qp_out->lam+ii, &d_ptr);
+        ocp_qp_capture_dvec(write, ni2, qp_out == NULL ? NULL : qp_out->t+ii, &d_ptr);
+    }
+}
+
+
+
+/************************************************
+ * writer
+ ************************************************/
+
+static int ocp_qp_capture_open_file(ocp_qp_capture *cap)
+{
+    if (cap->file != NULL)
+        fclose(cap->file);
+
+    char filename[MAX_STR_LEN];
+    snprintf(filename, sizeof(filename), "%s_%03d.acqp", cap->prefix, cap->file_index);
+    cap->file = fopen(filename, "wb");
+    cap->num_records_file = 0;
+    if (cap->file == NULL)
+    {
+        printf("\nocp_qp_capture: could not open %s\n", filename);
+        return 1;
+    }
+
+    int header[2] = {OCP_QP_CAPTURE_VERSION, OCP_QP_CAPTURE_BYTE_ORDER_MARK};
+    if (fwrite(ocp_qp_capture_magic, 1, sizeof(ocp_qp_capture_magic), cap->file) != sizeof(ocp_qp_capture_magic) ||
+        fwrite(header, sizeof(int), 2, cap->file) != 2)
+    {
+        printf("\nocp_qp_capture: could not write the header of %s\n", filename);
+        fclose(cap->file);
+        cap->file = NULL;
+        return 1;
+    }
+
+    return 0;
+}
+
+
+
+ocp_qp_capture *ocp_qp_capture_create(ocp_qp_dims **dims, int num_dims, const char *prefix,
+                                      int num_files, int records_per_file)
+{
+    ocp_qp_capture *cap = calloc(1, sizeof(ocp_qp_capture));
+    if (cap == NULL)
+    {
+        printf("\nocp_qp_capture_create: allocation failed\n");
+        return NULL;
+    }
+
+    cap->num_files = num_files > 0 ? num_files : 1;
+    cap->records_per_file = records_per_file > 0 ? records_per_file : 1;
+
+    // size the buffer for the largest record, so that writing never allocates
+    for (int ii = 0; ii < num_dims; ii++)
+    {
+        acados_size_t record_size = ocp_qp_capture_record_size(dims[ii]);
+        if (record_size > cap->buffer_size)
+            cap->buffer_size = record_size;
+    }
+
+    cap->prefix = malloc(strlen(prefix) + 1);
+    cap->buffer = calloc(1, cap->buffer_size);
+    if (cap->prefix == NULL || cap->buffer == NULL)
+    {
+        printf("\nocp_qp_capture_create: allocation failed\n");
+        ocp_qp_capture_free(cap);
+        return NULL;
+    }
+    strcpy(cap->prefix, prefix);
+
+    if (ocp_qp_capture_open_file(cap))
+    {
+        ocp_qp_capture_free(cap);
+        return NULL;
+    }
+
+    return cap;
+}
+
+
+
+int ocp_qp_capture_write(ocp_qp_capture *cap, ocp_qp_in *qp_in, ocp_qp_out *qp_out, int status)
+{
+    if (cap->file == NULL)
+        return 1;
+
+    // rotate
+    if (cap->num_records_file >= cap->records_per_file)
+    {
+        cap->file_index = (cap->file_index + 1) % cap->num_files;
+        if (ocp_qp_capture_open_file(cap))
+            return 1;
+    }
+
+    ocp_qp_dims *dims = qp_in->dim;
+    int N = dims->N;
+
+    acados_size_t record_size = ocp_qp_capture_record_size(dims);
+    if (record_size > cap->buffer_size)
+    {
+        printf("\nocp_qp_capture_write: record of %zu bytes exceeds the buffer of %zu bytes, skipping it\n",
+               (size_t) record_size, (size_t) cap->buffer_size);
+        return 1;
+    }
+
+    int *i_ptr = (int *) cap->buffer;
+
+    i_ptr[0] = (int) record_size;
+    i_ptr[1] = N;
+    i_ptr[2] = status;
+    i_ptr[3] = cap->num_records;
+    i_ptr += OCP_QP_CAPTURE_RECORD_HEADER_SIZE;
+
+    int *fields[OCP_QP_CAPTURE_NUM_DIMS];
+    ocp_qp_capture_dims_fields(dims, fields);
+    for (int kk = 0; kk < OCP_QP_CAPTURE_NUM_DIMS; kk++)
+    {
+        memcpy(i_ptr, fields[kk], (N+1)*sizeof(int));
+        i_ptr += N+1;
+    }
+
+    ocp_qp_capture_data(1, dims, qp_in, qp_out, i_ptr);
+
+    // a short write leaves a truncated record, which the reader ignores; stop capturing,
+    // since the following records could not be indexed anyway
+    if (fwrite(cap->buffer, 1, record_size, cap->file) != record_size)
+    {
+        printf("\nocp_qp_capture_write: could not write record %d, stopping the capture\n", cap->num_records);
+        fclose(cap->file);
+        cap->file = NULL;
+        return 1;
+    }
+    cap->num_records_file++;
+    cap->num_records++;
+
+    return 0;
+}
+
+
+
+void ocp_qp_capture_free(ocp_qp_capture *cap)
+{
+    if (cap == NULL)
+        return;
+    if (cap->file != NULL)
+        fclose(cap->file);
+    free(cap->buffer);
+    free(cap->prefix);
+    free(cap);
+}
+
+
+
+/************************************************
+ * reader
+ ************************************************/
+
+ocp_qp_capture_file *ocp_qp_capture_file_open(const char *filename)
+{
+    ocp_qp_capture_file *file = calloc(1, sizeof(ocp_qp_capture_file));
+
+#if defined(OCP_QP_CAPTURE_MMAP)
+    int fd = open(filename, O_RDONLY);
+    struct stat st;
+    if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size >= OCP_QP_CAPTURE_HEADER_SIZE)
+    {
+        void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+        {
+            file->data = data;
+            file->size = st.st_size;
+            file->mapped = 1;
+        }
+    }
+    if (fd >= 0)
+        close(fd);
+#endif
+    if (file->data == NULL)
+    {
+        FILE *f = fopen(filename, "rb");
+        if (f != NULL)
+        {
+            fseek(f, 0, SEEK_END);
+            long size = ftell(f);
+            fseek(f, 0, SEEK_SET);
+            if (size >= OCP_QP_CAPTURE_HEADER_SIZE)
+            {
+                file->data = malloc(size);
+                file->size = fread(file->data, 1, size, f);
+            }
+            fclose(f);
+        }
+    }
+
+    // header
+    int *header = file->data == NULL ? NULL : (int *) (file->data + sizeof(ocp_qp_capture_magic));
+    if (header == NULL || memcmp(file->data, ocp_qp_capture_magic, sizeof(ocp_qp_capture_magic)) ||
+        header[0] != OCP_QP_CAPTURE_VERSION || header[1] != OCP_QP_CAPTURE_BYTE_ORDER_MARK)
+    {
+        printf("\nocp_qp_capture_file_open: %s is not a capture file of this version and byte order\n", filename);
+        ocp_qp_capture_file_close(file);
+        return NULL;
+    }
+
+    // index the records, a trailing incomplete record is ignored
+    size_t offset;
+    for (offset = OCP_QP_CAPTURE_HEADER_SIZE; offset + sizeof(int) <= file->size;
+         offset += *(int *) (file->data + offset))
+    {
+        int record_size = *(int *) (file->data + offset);
+        if (record_size <= 0 || offset + record_size > file->size)
+            break;
+        file->num_records++;
+    }
+    file->offsets = malloc((file->num_records > 0 ? file->num_records : 1) * sizeof(size_t));
+    offset = OCP_QP_CAPTURE_HEADER_SIZE;
+    for (int kk = 0; kk < file->num_records; kk++)
+    {
+        file->offsets[kk] = offset;
+        offset += *(int *) (file->data + offset);
+    }
+
+    return file;
+}
+
+
+
+void ocp_qp_capture_file_close(ocp_qp_capture_file *file)
+{
+    if (file == NULL)
+        return;
+#if defined(OCP_QP_CAPTURE_MMAP)
+    if (file->mapped)
+        munmap(file->data, file->size);
+    else
+        free(file->data);
+#else
+    free(file->data);
+#endif
+    free(file->offsets);
+    free(file);
+}
+
+
+
+static int *ocp_qp_capture_file_record(ocp_qp_capture_file *file, int record)
+{
+    assert(record >= 0 && record < file->num_records);
+    return (int *) (file->data + file->offsets[record]);
+}
+
+
+
+int ocp_qp_capture_file_get_N(ocp_qp_capture_file *file, int record)
+{
+    return ocp_qp_capture_file_record(file, record)[1];
+}
+
+
+
+void ocp_qp_capture_file_get_dims(ocp_qp_capture_file *file, int record, ocp_qp_dims *dims)
+{
+    int *i_ptr = ocp_qp_capture_file_record(file, record);
+    int N = i_ptr[1];
+    assert(dims->N == N);
+    i_ptr += OCP_QP_CAPTURE_RECORD_HEADER_SIZE;
+
+    int *fields[OCP_QP_CAPTURE_NUM_DIMS];
+    ocp_qp_capture_dims_fields(dims, fields);
+    for (int kk = 0; kk < OCP_QP_CAPTURE_NUM_DIMS; kk++)
+    {
+        memcpy(fields[kk], i_ptr, (N+1)*sizeof(int));
+        i_ptr += N+1;
+    }
+}
+
+
+
+int ocp_qp_capture_file_check_dims(ocp_qp_capture_file *file, int record, ocp_qp_dims *dims)
+{
+    int *i_ptr = ocp_qp_capture_file_record(file, record);
+    int N = i_ptr[1];
+    if (dims->N != N)
+        return 1;
+    i_ptr += OCP_QP_CAPTURE_RECORD_HEADER_SIZE;
+
+    int *fields[OCP_QP_CAPTURE_NUM_DIMS];
+    ocp_qp_capture_dims_fields(dims, fields);
+    for (int kk = 0; kk < OCP_QP_CAPTURE_NUM_DIMS; kk++)
+    {
+        if (memcmp(fields[kk], i_ptr, (N+1)*sizeof(int)))
+            return 1;
+        i_ptr += N+1;
+    }
+    return 0;
+}
+
+
+
+int ocp_qp_capture_file_get(ocp_qp_capture_file *file, int record, ocp_qp_in *qp_in, ocp_qp_out *qp_out)
+{
+    int *i_ptr = ocp_qp_capture_file_record(file, record);
+    int status = i_ptr[2];
+
+    if (ocp_qp_capture_file_check_dims(file, record, qp_in->dim))
+    {
+        printf("\nocp_qp_capture_file_get: dimensions of record %d do not match qp_in\n", record);
+        exit(1);
+    }
+
+    i_ptr += OCP_QP_CAPTURE_RECORD_HEADER_SIZE + OCP_QP_CAPTURE_NUM_DIMS * (qp_in->dim->N+1);
+    ocp_qp_capture_data(0, qp_in->dim, qp_in, qp_out, i_ptr);
+
+    return status;
+}
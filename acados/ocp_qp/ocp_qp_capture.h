@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#ifndef ACADOS_OCP_QP_OCP_QP_CAPTURE_H_
+#define ACADOS_OCP_QP_OCP_QP_CAPTURE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+
+#include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/utils/types.h"
+
+// Binary capture of the QPs solved by an NLP solver, for offline replay.
+//
+// File layout, native byte order:
+//   header:  char magic[8] = "ACADOSQP", int32 version, int32 byte order mark 0x01020304
+//   records: int32 record_size (bytes, including this field, multiple of 8)
+//            int32 N, int32 status (of the QP solver), int32 index (running number)
+//            int32 dims[OCP_QP_CAPTURE_NUM_DIMS][N+1]
+//            int32 idxb, idxs_rev, idxe, diag_H_flag, stage by stage, padded to 8 bytes
+//            double BAbt, RSQrq, DCt (column-major), b, rqz, d, d_mask, m, Z, stage by stage
+//            double ux, pi, lam, t of the solution, stage by stage
+// Records are written with a single fwrite from a preallocated buffer. The capture rotates
+// through num_files files <prefix>_<k>.acqp with records_per_file records each, overwriting
+// the oldest file. Files can be memory mapped for reading.
+
+#define OCP_QP_CAPTURE_VERSION 1
+#define OCP_QP_CAPTURE_NUM_DIMS 13  // nx nu nb nbx nbu ng ns nsbx nsbu nsg nbxe nbue nge
+
+typedef struct
+{
+    char *prefix;
+    FILE *file;
+    char *buffer;         // one record
+    acados_size_t buffer_size;
+    int num_files;
+    int records_per_file;
+    int file_index;       // index of the open file
+    int num_records_file; // records written to the open file
+    int num_records;      // records written since creation
+} ocp_qp_capture;
+
+typedef struct
+{
+    char *data;
+    size_t size;
+    size_t *offsets;  // byte offset of every record
+    int num_records;
+    int mapped;
+} ocp_qp_capture_file;
+
+// writer
+// the buffer is sized for the largest record of the num_dims given dims;
+// returns NULL if an allocation failed or the first file could not be opened
+ocp_qp_capture *ocp_qp_capture_create(ocp_qp_dims **dims, int num_dims, const char *prefix,
+                                      int num_files, int records_per_file);
+// returns 0 on success; QPs larger than the dims at creation are skipped,
+// a failed write closes the file and stops the capture
+int ocp_qp_capture_write(ocp_qp_capture *cap, ocp_qp_in *qp_in, ocp_qp_out *qp_out, int status);
+// flushes and closes the open file
+void ocp_qp_capture_free(ocp_qp_capture *cap);
+
+// reader
+// returns NULL if the file could not be read or is not a capture file
+ocp_qp_capture_file *ocp_qp_capture_file_open(const char *filename);
+//
+void ocp_qp_capture_file_close(ocp_qp_capture_file *file);
+//
+int ocp_qp_capture_file_get_N(ocp_qp_capture_file *file, int record);
+// dims have to be created with N = ocp_qp_capture_file_get_N
+void ocp_qp_capture_file_get_dims(ocp_qp_capture_file *file, int record, ocp_qp_dims *dims);
+// returns 0 if the dimensions of the record match the ones of qp_in
+int ocp_qp_capture_file_check_dims(ocp_qp_capture_file *file, int record, ocp_qp_dims *dims);
+// qp_out may be NULL; returns the status of the QP solver at capture time
+int ocp_qp_capture_file_get(ocp_qp_capture_file *file, int record, ocp_qp_in *qp_in, ocp_qp_out *qp_out);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // ACADOS_OCP_QP_OCP_QP_CAPTURE_H_
@@ -922,3 +922,86 @@ void ocp_qp_compute_t(ocp_qp_in *qp_in, ocp_qp_out *qp_out)
         blasfeo_daxpy(2*ns[ii], -1.0, qp_in->d+ii, 2*nb[ii]+2*ng[ii], qp_out->ux+ii, nu[ii]+nx[ii], qp_out->t+ii, 2*nb[ii]+2*ng[ii]);
     }
 }
+
+
+
+static int ocp_qp_in_lhs_stage_num_elem(ocp_qp_dims *dims, int stage)
+{
+    int nv = dims->nu[stage]+dims->nx[stage];
+
+    int num_elem = 0;
+    if (stage < dims->N)
+        num_elem += nv*dims->nx[stage+1];  // BAbt, without b
+    num_elem += nv*(nv+1)/2;  // RSQ, lower triangular
+    num_elem += nv*dims->ng[stage];  // DCt
+    num_elem += 2*dims->ns[stage];  // Z
+    num_elem += 1;  // diag_H_flag
+
+    return num_elem;
+}
+
+
+
+acados_size_t ocp_qp_in_lhs_calculate_size(ocp_qp_dims *dims)
+{
+    acados_size_t size = 0;
+    for (int ii = 0; ii <= dims->N; ii++)
+        size += ocp_qp_in_lhs_stage_num_elem(dims, ii)*sizeof(double);
+
+    return size;
+}
+
+
+
+// bitwise comparison, such that also changes between e.g. 0.0 and -0.0 are detected
+static void ocp_qp_in_lhs_update_elem(double value, double *lhs, bool *unchanged)
+{
+    if (memcmp(&value, lhs, sizeof(double)))
+    {
+        *lhs = value;
+        *unchanged = false;
+    }
+}
+
+
+
+bool ocp_qp_in_lhs_update(ocp_qp_in *qp_in, double *lhs)
+{
+    int ii, jj, kk;
+
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *ng = qp_in->dim->ng;
+    int *ns = qp_in->dim->ns;
+
+    bool unchanged = true;
+
+    for (kk = 0; kk <= N; kk++)
+    {
+        int nv = nu[kk]+nx[kk];
+
+        // BAbt, without b
+        if (kk < N)
+        {
+            for (jj = 0; jj < nx[kk+1]; jj++)
+                for (ii = 0; ii < nv; ii++)
+                    ocp_qp_in_lhs_update_elem(BLASFEO_DMATEL(qp_in->BAbt+kk, ii, jj), lhs++, &unchanged);
+        }
+        // RSQ, lower triangular
+        for (jj = 0; jj < nv; jj++)
+            for (ii = jj; ii < nv; ii++)
+                ocp_qp_in_lhs_update_elem(BLASFEO_DMATEL(qp_in->RSQrq+kk, ii, jj), lhs++, &unchanged);
+        // DCt
+        for (jj = 0; jj < ng[kk]; jj++)
+            for (ii = 0; ii < nv; ii++)
+                ocp_qp_in_lhs_update_elem(BLASFEO_DMATEL(qp_in->DCt+kk, ii, jj), lhs++, &unchanged);
+        // Z
+        for (ii = 0; ii < 2*ns[kk]; ii++)
+            ocp_qp_in_lhs_update_elem(BLASFEO_DVECEL(qp_in->Z+kk, ii), lhs++, &unchanged);
+
+        ocp_qp_in_lhs_update_elem((double) qp_in->diag_H_flag[kk], lhs++, &unchanged);
+    }
+
+    return unchanged;
+}
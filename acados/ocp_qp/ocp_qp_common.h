@@ -196,6 +196,10 @@ ocp_qp_seed *ocp_qp_seed_assign(ocp_qp_dims *dims, void *raw_memory);
 /* misc */
 //
 void ocp_qp_compute_t(ocp_qp_in *qp_in, ocp_qp_out *qp_out);
+// size of a copy of the data which enters the lhs of condensing: BAbt, RSQ, DCt, Z
+acados_size_t ocp_qp_in_lhs_calculate_size(ocp_qp_dims *dims);
+// compare the lhs data of qp_in exactly with the copy in lhs and update it, returns true if unchanged
+bool ocp_qp_in_lhs_update(ocp_qp_in *qp_in, double *lhs);
 //
 // ocp_qp_stack_slacks -> not used anymore, broken when migrating to idxs_rev
 // void ocp_qp_stack_slacks_dims(ocp_qp_dims *in, ocp_qp_dims *out);
@@ -32,12 +32,19 @@
 // external
 #include <stdlib.h>
 #include <assert.h>
+#include <math.h>
 #include <string.h>
 // hpipm
 #include "hpipm/include/hpipm_d_ocp_qp.h"
 #include "hpipm/include/hpipm_d_ocp_qp_ipm.h"
 #include "hpipm/include/hpipm_d_ocp_qp_sol.h"
 #include "hpipm/include/hpipm_common.h"
+#if defined(ACADOS_WITH_HPIPM_SINGLE)
+#include "hpipm/include/hpipm_s_ocp_qp.h"
+#include "hpipm/include/hpipm_s_ocp_qp_dim.h"
+#include "hpipm/include/hpipm_s_ocp_qp_ipm.h"
+#include "hpipm/include/hpipm_s_ocp_qp_sol.h"
+#endif
 
 // uncomment to codegen QP
 // #include "hpipm/include/hpipm_d_ocp_qp_utils.h"
@@ -50,6 +57,9 @@
 #include "acados/utils/timing.h"
 #include "acados/utils/types.h"
 
+// smallest residual tolerance of the iterations in single precision
+#define HPIPM_SINGLE_TOL_MIN 1e-5
+
 
 
 /************************************************
@@ -123,6 +133,7 @@ void ocp_qp_hpipm_opts_initialize_default(void *config_, void *dims_, void *opts
 
     ocp_qp_hpipm_opts_overwrite_mode_opts(opts);
     opts->print_level = 0;
+    opts->precision = HPIPM_PRECISION_DOUBLE;
 
     return;
 }
@@ -163,6 +174,26 @@ void ocp_qp_hpipm_opts_set(void *config_, void *opts_, const char *field, void *
         int* print_level = (int *) value;
         opts->print_level = *print_level;
     }
+    else if (!strcmp(field, "precision"))
+    {
+        const char *precision = (const char *) value;
+        if (!strcmp(precision, "DOUBLE"))
+            opts->precision = HPIPM_PRECISION_DOUBLE;
+        else if (!strcmp(precision, "SINGLE") || !strcmp(precision, "MIXED"))
+        {
+#if defined(ACADOS_WITH_HPIPM_SINGLE)
+            opts->precision = !strcmp(precision, "SINGLE") ? HPIPM_PRECISION_SINGLE : HPIPM_PRECISION_MIXED;
+#else
+            printf("\nerror: ocp_qp_hpipm_opts_set: precision %s requires acados to be compiled with ACADOS_WITH_HPIPM_SINGLE\n", precision);
+            exit(1);
+#endif
+        }
+        else
+        {
+            printf("\nerror: ocp_qp_hpipm_opts_set: precision %s not supported, use DOUBLE, SINGLE or MIXED\n", precision);
+            exit(1);
+        }
+    }
     else
     {
         d_ocp_qp_ipm_arg_set((char *) field, value, opts->hpipm_opts);
@@ -183,6 +214,197 @@ void ocp_qp_hpipm_opts_get(void *config_, void *opts_, const char *field, void *
 
 
 
+#if defined(ACADOS_WITH_HPIPM_SINGLE)
+static acados_size_t ocp_qp_hpipm_dims_single_calculate_size(ocp_qp_dims *dims)
+{
+    acados_size_t size = sizeof(struct s_ocp_qp_dim);
+    size += s_ocp_qp_dim_memsize(dims->N);
+    size += 1 * 8;
+
+    return size;
+}
+
+
+
+// creates the dimensions of the single precision solver and sets them from the double precision ones
+static struct s_ocp_qp_dim *ocp_qp_hpipm_dims_single_assign(ocp_qp_dims *dims, void *raw_memory)
+{
+    char *c_ptr = (char *) raw_memory;
+
+    struct s_ocp_qp_dim *dims_single = (struct s_ocp_qp_dim *) c_ptr;
+    c_ptr += sizeof(struct s_ocp_qp_dim);
+
+    align_char_to(8, &c_ptr);
+    s_ocp_qp_dim_create(dims->N, dims_single, c_ptr);
+
+    s_ocp_qp_dim_set_all(dims->nx, dims->nu, dims->nbx, dims->nbu, dims->ng,
+                         dims->nsbx, dims->nsbu, dims->nsg, dims_single);
+    for (int ii = 0; ii <= dims->N; ii++)
+    {
+        s_ocp_qp_dim_set_nbxe(ii, dims->nbxe[ii], dims_single);
+        s_ocp_qp_dim_set_nbue(ii, dims->nbue[ii], dims_single);
+        s_ocp_qp_dim_set_nge(ii, dims->nge[ii], dims_single);
+    }
+
+    return dims_single;
+}
+
+
+
+// copies the options of the single precision solver that determine its workspace size,
+// these are fixed once the memory is assigned
+static void ocp_qp_hpipm_single_arg_init(ocp_qp_hpipm_opts *opts, struct s_ocp_qp_ipm_arg *arg)
+{
+    arg->square_root_alg = opts->hpipm_opts->square_root_alg;
+    arg->lq_fact = opts->hpipm_opts->lq_fact;
+    arg->stat_max = opts->hpipm_opts->stat_max;
+}
+
+
+
+// copies the options that may change between calls to the single precision solver,
+// the tolerances are limited to what is attainable in single precision
+static void ocp_qp_hpipm_single_arg_update(ocp_qp_hpipm_opts *opts, struct s_ocp_qp_ipm_arg *arg)
+{
+    struct d_ocp_qp_ipm_arg *d_arg = opts->hpipm_opts;
+
+    arg->mu0 = d_arg->mu0;
+    arg->alpha_min = d_arg->alpha_min;
+    arg->res_g_max = fmax(d_arg->res_g_max, HPIPM_SINGLE_TOL_MIN);
+    arg->res_b_max = fmax(d_arg->res_b_max, HPIPM_SINGLE_TOL_MIN);
+    arg->res_d_max = fmax(d_arg->res_d_max, HPIPM_SINGLE_TOL_MIN);
+    arg->res_m_max = fmax(d_arg->res_m_max, HPIPM_SINGLE_TOL_MIN);
+    arg->reg_prim = fmax(d_arg->reg_prim, 1e-7);
+    arg->lam_min = d_arg->lam_min;
+    arg->t_min = d_arg->t_min;
+    arg->tau_min = d_arg->tau_min;
+    arg->iter_max = d_arg->iter_max;
+    arg->pred_corr = d_arg->pred_corr;
+    arg->cond_pred_corr = d_arg->cond_pred_corr;
+    arg->itref_pred_max = d_arg->itref_pred_max;
+    arg->itref_corr_max = d_arg->itref_corr_max;
+    arg->warm_start = d_arg->warm_start;
+    arg->abs_form = d_arg->abs_form;
+    arg->comp_dual_sol_eq = d_arg->comp_dual_sol_eq;
+    arg->comp_res_exit = d_arg->comp_res_exit;
+    arg->comp_res_pred = d_arg->comp_res_pred;
+    arg->split_step = d_arg->split_step;
+    arg->t_lam_min = d_arg->t_lam_min;
+    arg->var_init_scheme = d_arg->var_init_scheme;
+}
+
+
+
+static void ocp_qp_hpipm_dmat_to_single(int m, int n, struct blasfeo_dmat *A, struct blasfeo_smat *B)
+{
+    for (int jj = 0; jj < n; jj++)
+        for (int ii = 0; ii < m; ii++)
+            BLASFEO_SMATEL(B, ii, jj) = (float) BLASFEO_DMATEL(A, ii, jj);
+}
+
+
+
+static void ocp_qp_hpipm_dvec_to_single(int m, struct blasfeo_dvec *x, struct blasfeo_svec *y)
+{
+    for (int ii = 0; ii < m; ii++)
+        BLASFEO_SVECEL(y, ii) = (float) BLASFEO_DVECEL(x, ii);
+}
+
+
+
+static void ocp_qp_hpipm_svec_to_double(int m, struct blasfeo_svec *x, struct blasfeo_dvec *y)
+{
+    for (int ii = 0; ii < m; ii++)
+        BLASFEO_DVECEL(y, ii) = (double) BLASFEO_SVECEL(x, ii);
+}
+
+
+
+static void ocp_qp_hpipm_qp_in_to_single(ocp_qp_in *qp_in, struct s_ocp_qp *qp)
+{
+    ocp_qp_dims *dims = qp_in->dim;
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *nb = dims->nb;
+    int *ng = dims->ng;
+    int *ns = dims->ns;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nv = nu[ii] + nx[ii];
+        int ni2 = 2*nb[ii] + 2*ng[ii] + 2*ns[ii];
+        if (ii < N)
+        {
+            ocp_qp_hpipm_dmat_to_single(nv+1, nx[ii+1], qp_in->BAbt+ii, qp->BAbt+ii);
+            ocp_qp_hpipm_dvec_to_single(nx[ii+1], qp_in->b+ii, qp->b+ii);
+        }
+        ocp_qp_hpipm_dmat_to_single(nv+1, nv, qp_in->RSQrq+ii, qp->RSQrq+ii);
+        ocp_qp_hpipm_dmat_to_single(nv, ng[ii], qp_in->DCt+ii, qp->DCt+ii);
+        ocp_qp_hpipm_dvec_to_single(nv+2*ns[ii], qp_in->rqz+ii, qp->rqz+ii);
+        ocp_qp_hpipm_dvec_to_single(ni2, qp_in->d+ii, qp->d+ii);
+        ocp_qp_hpipm_dvec_to_single(ni2, qp_in->d_mask+ii, qp->d_mask+ii);
+        ocp_qp_hpipm_dvec_to_single(ni2, qp_in->m+ii, qp->m+ii);
+        ocp_qp_hpipm_dvec_to_single(2*ns[ii], qp_in->Z+ii, qp->Z+ii);
+
+        for (int jj = 0; jj < nb[ii]; jj++)
+            qp->idxb[ii][jj] = qp_in->idxb[ii][jj];
+        for (int jj = 0; jj < nb[ii]+ng[ii]; jj++)
+            qp->idxs_rev[ii][jj] = qp_in->idxs_rev[ii][jj];
+        for (int jj = 0; jj < dims->nbxe[ii]+dims->nbue[ii]+dims->nge[ii]; jj++)
+            qp->idxe[ii][jj] = qp_in->idxe[ii][jj];
+        qp->diag_H_flag[ii] = qp_in->diag_H_flag[ii];
+    }
+}
+
+
+
+static void ocp_qp_hpipm_sol_to_double(ocp_qp_dims *dims, struct s_ocp_qp_sol *sol, ocp_qp_out *qp_out)
+{
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *nb = dims->nb;
+    int *ng = dims->ng;
+    int *ns = dims->ns;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int ni2 = 2*nb[ii] + 2*ng[ii] + 2*ns[ii];
+        ocp_qp_hpipm_svec_to_double(nu[ii]+nx[ii]+2*ns[ii], sol->ux+ii, qp_out->ux+ii);
+        if (ii < N)
+            ocp_qp_hpipm_svec_to_double(nx[ii+1], sol->pi+ii, qp_out->pi+ii);
+        ocp_qp_hpipm_svec_to_double(ni2, sol->lam+ii, qp_out->lam+ii);
+        ocp_qp_hpipm_svec_to_double(ni2, sol->t+ii, qp_out->t+ii);
+    }
+}
+
+
+
+// the previous solution is the initial guess for warm starting in single precision
+static void ocp_qp_hpipm_sol_to_single(ocp_qp_dims *dims, ocp_qp_out *qp_out, struct s_ocp_qp_sol *sol)
+{
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *nb = dims->nb;
+    int *ng = dims->ng;
+    int *ns = dims->ns;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int ni2 = 2*nb[ii] + 2*ng[ii] + 2*ns[ii];
+        ocp_qp_hpipm_dvec_to_single(nu[ii]+nx[ii]+2*ns[ii], qp_out->ux+ii, sol->ux+ii);
+        if (ii < N)
+            ocp_qp_hpipm_dvec_to_single(nx[ii+1], qp_out->pi+ii, sol->pi+ii);
+        ocp_qp_hpipm_dvec_to_single(ni2, qp_out->lam+ii, sol->lam+ii);
+        ocp_qp_hpipm_dvec_to_single(ni2, qp_out->t+ii, sol->t+ii);
+    }
+}
+#endif
+
+
+
 /************************************************
  * memory
  ************************************************/
@@ -199,6 +421,32 @@ acados_size_t ocp_qp_hpipm_memory_calculate_size(void *config_, void *dims_, voi
 
     size += d_ocp_qp_ipm_ws_memsize(dims, opts->hpipm_opts);
 
+#if defined(ACADOS_WITH_HPIPM_SINGLE)
+    if (opts->precision != HPIPM_PRECISION_DOUBLE)
+    {
+        // temporary dimensions to compute the sizes of the single precision structures
+        void *dims_single_mem = acados_malloc(1, ocp_qp_hpipm_dims_single_calculate_size(dims));
+        struct s_ocp_qp_dim *dims_single = ocp_qp_hpipm_dims_single_assign(dims, dims_single_mem);
+        struct s_ocp_qp_ipm_arg arg_single;
+        memset(&arg_single, 0, sizeof(arg_single));
+        ocp_qp_hpipm_single_arg_init(opts, &arg_single);
+
+        size += ocp_qp_hpipm_dims_single_calculate_size(dims);
+        size += sizeof(struct s_ocp_qp) + s_ocp_qp_memsize(dims_single);
+        size += sizeof(struct s_ocp_qp_sol) + s_ocp_qp_sol_memsize(dims_single);
+        size += sizeof(struct s_ocp_qp_ipm_arg) + s_ocp_qp_ipm_arg_memsize(dims_single);
+        size += sizeof(struct s_ocp_qp_ipm_ws) + s_ocp_qp_ipm_ws_memsize(dims_single, &arg_single);
+        size += 4 * 8;
+
+        free(dims_single_mem);
+    }
+    if (opts->precision == HPIPM_PRECISION_MIXED)
+    {
+        size += ocp_qp_res_calculate_size(dims);
+        size += ocp_qp_res_workspace_calculate_size(dims);
+    }
+#endif
+
     size += 1 * 8;
     make_int_multiple_of(8, &size);
 
@@ -231,6 +479,62 @@ void *ocp_qp_hpipm_memory_assign(void *config_, void *dims_, void *opts_, void *
     d_ocp_qp_ipm_ws_create(dims, opts->hpipm_opts, ipm_workspace, c_ptr);
     c_ptr += ipm_workspace->memsize;
 
+    mem->iter_single = 0;
+    mem->riccati_double = opts->precision == HPIPM_PRECISION_DOUBLE;
+
+#if defined(ACADOS_WITH_HPIPM_SINGLE)
+    mem->dims_single = NULL;
+    mem->qp_single = NULL;
+    mem->sol_single = NULL;
+    mem->arg_single = NULL;
+    mem->ws_single = NULL;
+    mem->res = NULL;
+    mem->res_ws = NULL;
+
+    if (opts->precision != HPIPM_PRECISION_DOUBLE)
+    {
+        align_char_to(8, &c_ptr);
+        mem->dims_single = ocp_qp_hpipm_dims_single_assign(dims, c_ptr);
+        c_ptr += ocp_qp_hpipm_dims_single_calculate_size(dims);
+        struct s_ocp_qp_dim *dims_single = mem->dims_single;
+
+        mem->qp_single = (struct s_ocp_qp *) c_ptr;
+        c_ptr += sizeof(struct s_ocp_qp);
+        mem->sol_single = (struct s_ocp_qp_sol *) c_ptr;
+        c_ptr += sizeof(struct s_ocp_qp_sol);
+        mem->arg_single = (struct s_ocp_qp_ipm_arg *) c_ptr;
+        c_ptr += sizeof(struct s_ocp_qp_ipm_arg);
+        mem->ws_single = (struct s_ocp_qp_ipm_ws *) c_ptr;
+        c_ptr += sizeof(struct s_ocp_qp_ipm_ws);
+
+        align_char_to(8, &c_ptr);
+        s_ocp_qp_create(dims_single, mem->qp_single, c_ptr);
+        c_ptr += s_ocp_qp_memsize(dims_single);
+
+        align_char_to(8, &c_ptr);
+        s_ocp_qp_sol_create(dims_single, mem->sol_single, c_ptr);
+        c_ptr += s_ocp_qp_sol_memsize(dims_single);
+
+        align_char_to(8, &c_ptr);
+        s_ocp_qp_ipm_arg_create(dims_single, mem->arg_single, c_ptr);
+        c_ptr += s_ocp_qp_ipm_arg_memsize(dims_single);
+        s_ocp_qp_ipm_arg_set_default(BALANCE, mem->arg_single);
+        ocp_qp_hpipm_single_arg_init(opts, mem->arg_single);
+
+        align_char_to(8, &c_ptr);
+        s_ocp_qp_ipm_ws_create(dims_single, mem->arg_single, mem->ws_single, c_ptr);
+        c_ptr += mem->ws_single->memsize;
+    }
+    if (opts->precision == HPIPM_PRECISION_MIXED)
+    {
+        mem->res = ocp_qp_res_assign(dims, c_ptr);
+        c_ptr += ocp_qp_res_calculate_size(dims);
+
+        mem->res_ws = ocp_qp_res_workspace_assign(dims, c_ptr);
+        c_ptr += ocp_qp_res_workspace_calculate_size(dims);
+    }
+#endif
+
     assert((char *) raw_memory + ocp_qp_hpipm_memory_calculate_size(config_, dims, opts_) >= c_ptr);
 
     return mem;
@@ -258,6 +562,16 @@ void ocp_qp_hpipm_memory_get(void *config_, void *mem_, const char *field, void*
         int *tmp_ptr = value;
         *tmp_ptr = mem->status;
     }
+    else if (!strcmp(field, "iter_single"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->iter_single;
+    }
+    else if (!strcmp(field, "riccati_double"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->riccati_double;
+    }
     else if (!strcmp(field, "tau_iter"))
     {
         double *tmp_ptr = value;
@@ -290,6 +604,67 @@ acados_size_t ocp_qp_hpipm_workspace_calculate_size(void *config_, void *dims_,
  * functions
  ************************************************/
 
+#if defined(ACADOS_WITH_HPIPM_SINGLE)
+// solves the QP in single precision, in MIXED mode the solution is refined in double precision
+// if the residuals w.r.t. the QP in double precision are above the tolerances
+static void ocp_qp_hpipm_solve_single(ocp_qp_in *qp_in, ocp_qp_out *qp_out, ocp_qp_hpipm_opts *opts,
+                                      ocp_qp_hpipm_memory *mem, double *interface_time)
+{
+    struct d_ocp_qp_ipm_arg *d_arg = opts->hpipm_opts;
+    acados_timer timer;
+
+    if (mem->qp_single == NULL || (opts->precision == HPIPM_PRECISION_MIXED && mem->res == NULL))
+    {
+        printf("\nerror: ocp_qp_hpipm: precision has to be set before the solver memory is created\n");
+        exit(1);
+    }
+
+    acados_tic(&timer);
+    ocp_qp_hpipm_qp_in_to_single(qp_in, mem->qp_single);
+    ocp_qp_hpipm_single_arg_update(opts, mem->arg_single);
+    if (d_arg->warm_start > 0)
+        ocp_qp_hpipm_sol_to_single(qp_in->dim, qp_out, mem->sol_single);
+    *interface_time = acados_toc(&timer);
+
+    s_ocp_qp_ipm_solve(mem->qp_single, mem->sol_single, mem->arg_single, mem->ws_single);
+    s_ocp_qp_ipm_get_status(mem->ws_single, &mem->status);
+    mem->iter_single = mem->ws_single->iter;
+    mem->iter = mem->iter_single;
+    mem->riccati_double = 0;
+
+    acados_tic(&timer);
+    ocp_qp_hpipm_sol_to_double(qp_in->dim, mem->sol_single, qp_out);
+    *interface_time += acados_toc(&timer);
+
+    if (opts->precision != HPIPM_PRECISION_MIXED)
+        return;
+
+    double res[4];
+    acados_tic(&timer);
+    ocp_qp_res_compute(qp_in, qp_out, mem->res, mem->res_ws);
+    ocp_qp_res_compute_nrm_inf(mem->res, res);
+    *interface_time += acados_toc(&timer);
+
+    // NOTE: negated comparisons to refine NaN residuals
+    if (mem->status == NAN_SOL || !(res[0] <= d_arg->res_g_max && res[1] <= d_arg->res_b_max &&
+                                     res[2] <= d_arg->res_d_max && res[3] <= d_arg->res_m_max))
+    {
+        // warm start the iterations in double precision from the single precision solution
+        int warm_start = d_arg->warm_start;
+        d_arg->warm_start = mem->status == NAN_SOL ? 0 : 2;
+        d_ocp_qp_ipm_solve(qp_in, qp_out, d_arg, mem->hpipm_workspace);
+        d_arg->warm_start = warm_start;
+
+        d_ocp_qp_ipm_get_status(mem->hpipm_workspace, &mem->status);
+        mem->iter += mem->hpipm_workspace->iter;
+        mem->riccati_double = 1;
+    }
+}
+#endif
+
+
+
+
 int ocp_qp_hpipm(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_, void *work_)
 {
     ocp_qp_in *qp_in = qp_in_;
@@ -316,10 +691,22 @@ int ocp_qp_hpipm(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *
     }
 
     // solve ipm
+    double interface_time = 0;
     acados_tic(&qp_timer);
-    // print_ocp_qp_in(qp_in);
-    d_ocp_qp_ipm_solve(qp_in, qp_out, opts->hpipm_opts, mem->hpipm_workspace);
-    d_ocp_qp_ipm_get_status(mem->hpipm_workspace, &mem->status);
+#if defined(ACADOS_WITH_HPIPM_SINGLE)
+    if (opts->precision != HPIPM_PRECISION_DOUBLE)
+    {
+        ocp_qp_hpipm_solve_single(qp_in, qp_out, opts, mem, &interface_time);
+    }
+    else
+#endif
+    {
+        // print_ocp_qp_in(qp_in);
+        d_ocp_qp_ipm_solve(qp_in, qp_out, opts->hpipm_opts, mem->hpipm_workspace);
+        d_ocp_qp_ipm_get_status(mem->hpipm_workspace, &mem->status);
+        mem->iter = mem->hpipm_workspace->iter;
+        mem->riccati_double = 1;
+    }
 
     /* use this to send some QPs to Gianluca :) */
     // printf("\ncodegen HPIPM QP\n");
@@ -327,18 +714,17 @@ int ocp_qp_hpipm(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *
     // d_ocp_qp_codegen("failing_ocp_data.c", "a", qp_in->dim, qp_in);
     // d_ocp_qp_ipm_arg_codegen("failing_ocp_data.c", "a", qp_in->dim, opts->hpipm_opts);
 
-    info->solve_QP_time = acados_toc(&qp_timer);
-    info->interface_time = 0;  // there are no conversions for hpipm
+    info->solve_QP_time = acados_toc(&qp_timer) - interface_time;
+    info->interface_time = interface_time;  // conversions to and from single precision
     info->total_time = acados_toc(&tot_timer);
-    info->num_iter = mem->hpipm_workspace->iter;
+    info->num_iter = mem->iter;
     info->t_computed = 1;
 
     mem->time_qp_solver_call = info->solve_QP_time;
-    mem->iter = mem->hpipm_workspace->iter;
 
     // print HPIPM statistics:
 #ifndef BLASFEO_EXT_DEP_OFF
-    if (opts->print_level > 0)
+    if (opts->print_level > 0 && opts->precision == HPIPM_PRECISION_DOUBLE)
     {
         double *stat; d_ocp_qp_ipm_get_stat(mem->hpipm_workspace, &stat);
         int stat_m; d_ocp_qp_ipm_get_stat_m(mem->hpipm_workspace, &stat_m);
@@ -399,6 +785,14 @@ void ocp_qp_hpipm_solver_get(void *config_, void *qp_in_, void *qp_out_, void *o
     int nx = qp_in->dim->nx[stage];
     int nu = qp_in->dim->nu[stage];
 
+    if (!mem->riccati_double && (!strcmp(field, "P") || !strcmp(field, "p") || !strcmp(field, "K")
+                                 || !strcmp(field, "k") || !strcmp(field, "Lr")))
+    {
+        printf("\nerror: ocp_qp_hpipm_solver_get: field %s is only available after a solve in double precision,\n", field);
+        printf("the last QP was solved in single precision only.\n");
+        exit(1);
+    }
+
     if (!strcmp(field, "P"))
     {
         if ((size1 != nx) || (size2 != nx))
@@ -460,6 +854,13 @@ void ocp_qp_hpipm_eval_forw_sens(void *config_, void *param_qp_in_, void *seed,
     ocp_qp_hpipm_opts *opts = opts_;
     ocp_qp_hpipm_memory *mem = mem_;
 
+    if (!mem->riccati_double)
+    {
+        printf("\nerror: ocp_qp_hpipm_eval_forw_sens: sensitivities are only available after a solve in double precision,\n");
+        printf("the last QP was solved in single precision only.\n");
+        exit(1);
+    }
+
     d_ocp_qp_ipm_sens_frw(param_qp_in, seed, sens_qp_out, opts->hpipm_opts, mem->hpipm_workspace);
 
     return;
@@ -474,6 +875,13 @@ void ocp_qp_hpipm_eval_adj_sens(void *config_, void *param_qp_in_, void *seed, v
     ocp_qp_hpipm_opts *opts = opts_;
     ocp_qp_hpipm_memory *mem = mem_;
 
+    if (!mem->riccati_double)
+    {
+        printf("\nerror: ocp_qp_hpipm_eval_adj_sens: sensitivities are only available after a solve in double precision,\n");
+        printf("the last QP was solved in single precision only.\n");
+        exit(1);
+    }
+
     d_ocp_qp_ipm_sens_adj(param_qp_in, seed, sens_qp_out, opts->hpipm_opts, mem->hpipm_workspace);
 
     return;
@@ -38,17 +38,35 @@ extern "C" {
 
 // hpipm
 #include "hpipm/include/hpipm_d_ocp_qp_ipm.h"
+#if defined(ACADOS_WITH_HPIPM_SINGLE)
+#include "hpipm/include/hpipm_s_ocp_qp.h"
+#include "hpipm/include/hpipm_s_ocp_qp_dim.h"
+#include "hpipm/include/hpipm_s_ocp_qp_ipm.h"
+#include "hpipm/include/hpipm_s_ocp_qp_sol.h"
+#endif
 // acados
 #include "acados/ocp_qp/ocp_qp_common.h"
 #include "acados/utils/types.h"
 
 
 
+// floating point precision of the interior point iterations
+typedef enum
+{
+    HPIPM_PRECISION_DOUBLE,
+    // requires ACADOS_WITH_HPIPM_SINGLE:
+    HPIPM_PRECISION_SINGLE,  // solve in single precision, cast the solution to double
+    HPIPM_PRECISION_MIXED,   // solve in single precision, refine in double if the residuals are above tolerance
+} ocp_qp_hpipm_precision;
+
+
+
 // struct of arguments to the solver
 typedef struct ocp_qp_hpipm_opts_
 {
     struct d_ocp_qp_ipm_arg *hpipm_opts;
     int print_level;
+    ocp_qp_hpipm_precision precision;
 } ocp_qp_hpipm_opts;
 
 
@@ -61,6 +79,21 @@ typedef struct ocp_qp_hpipm_memory_
     int iter;
     int status;
 
+    int iter_single;  // iterations in single precision, included in iter
+    int riccati_double;  // 1 if the last QP was (also) solved in double precision, i.e. the Riccati factors and sensitivities are available
+#if defined(ACADOS_WITH_HPIPM_SINGLE)
+    // only allocated if (opts->precision != HPIPM_PRECISION_DOUBLE);
+    // NOTE: the Riccati factors and sensitivities are only available after a solve in double precision
+    struct s_ocp_qp_dim *dims_single;
+    struct s_ocp_qp *qp_single;
+    struct s_ocp_qp_sol *sol_single;
+    struct s_ocp_qp_ipm_arg *arg_single;
+    struct s_ocp_qp_ipm_ws *ws_single;
+    // only allocated if (opts->precision == HPIPM_PRECISION_MIXED)
+    ocp_qp_res *res;
+    ocp_qp_res_ws *res_ws;
+#endif
+
 } ocp_qp_hpipm_memory;
 
 
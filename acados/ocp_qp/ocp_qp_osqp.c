@@ -400,7 +400,7 @@ static void update_hessian_structure(const ocp_qp_in *in, ocp_qp_osqp_memory *me
 
 
 
-static void update_hessian_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
+static void update_hessian_scatter_map(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
 {
     ocp_qp_dims *dims = in->dim;
 
@@ -409,26 +409,52 @@ static void update_hessian_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
     int *nu = dims->nu;
     int *ns = dims->ns;
 
-    int ii, kk;
+    int ii, jj, kk;
 
-    // Traversing the matrix in column-major order
+    // all nonzeros of P are data, store their location in qp_in,
+    // traversing the matrix in column-major order
     c_int nn = 0;
     for (kk = 0; kk <= N; kk++)
     {
-        // writing RSQ[kk]
-        // we write the lower triangular part in row-major order
-        // that's the same as writing the upper triangular part in
-        // column-major order
+        // RSQ[kk]: the upper triangular part in column-major order
+        // is the lower triangular part in row-major order
         for (ii = 0; ii < nx[kk] + nu[kk]; ii++)
         {
-            blasfeo_unpack_dmat(1, ii+1, in->RSQrq+kk, ii, 0, mem->P_x+nn, 1);
-            nn += ii+1;
+            for (jj = 0; jj <= ii; jj++)
+            {
+                mem->P_src[nn] = &BLASFEO_DMATEL(in->RSQrq+kk, ii, jj);
+                nn++;
+            }
         }
 
-        // write Z[kk]
-        blasfeo_unpack_dvec(2*ns[kk], in->Z+kk, 0, mem->P_x+nn, 1);
-        nn += 2*ns[kk];
+        // Z[kk]
+        for (ii = 0; ii < 2*ns[kk]; ii++)
+        {
+            mem->P_src[nn] = &BLASFEO_DVECEL(in->Z+kk, ii);
+            nn++;
+        }
     }
+    mem->P_ndata = nn;
+}
+
+
+
+static void update_hessian_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
+{
+    // gather P from qp_in, keep track of the nonzeros which changed since the last call
+    c_int n_upd = 0;
+    for (c_int nn = 0; nn < mem->P_ndata; nn++)
+    {
+        c_float val = *mem->P_src[nn];
+        if (val != mem->P_x[nn])
+        {
+            mem->P_x[nn] = val;
+            mem->P_upd_x[n_upd] = val;
+            mem->P_upd_idx[n_upd] = nn;
+            n_upd++;
+        }
+    }
+    mem->P_nupd = n_upd;
 }
 
 
@@ -682,8 +708,9 @@ static void update_constraints_matrix_structure(const ocp_qp_in *in, ocp_qp_osqp
 
 
 
-// TODO move constant stuff like I to structure routine
-static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
+// writes the constant nonzeros of A, i.e. identities of bounds, dynamics and slacks,
+// and stores the location in qp_in of all other nonzeros
+static void update_constraints_matrix_scatter_map(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
 {
     ocp_qp_dims *dims = in->dim;
 
@@ -696,9 +723,8 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
 
     int ii, jj, kk;
 
-
     // Traverse matrix in column-major order
-    c_int nn = 0;
+    c_int nn = 0, nd = 0;
     for (kk = 0; kk <= N; kk++)
     {
 
@@ -707,12 +733,17 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
         {
             if (kk < dims->N)
             {
-                // write column from B
-                blasfeo_unpack_dmat(1, nx[kk+1], in->BAbt+kk, jj, 0, mem->A_x+nn, 1);
-                nn += nx[kk+1];
+                // column from B
+                for (ii = 0; ii < nx[kk+1]; ii++)
+                {
+                    mem->A_src[nd] = &BLASFEO_DMATEL(in->BAbt+kk, jj, ii);
+                    mem->A_data_idx[nd] = nn;
+                    nd++;
+                    nn++;
+                }
             }
 
-            // write bound on u
+            // bound on u
             for (ii = 0; ii < dims->nb[kk]; ii++)
             {
                 if (in->idxb[kk][ii] == jj)
@@ -724,9 +755,14 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             }
             int idxbu = ii;
 
-            // write column from D
-            blasfeo_unpack_dmat(1, ng[kk], in->DCt+kk, jj, 0, mem->A_x+nn, 1);
-            nn += ng[kk];
+            // column from D
+            for (ii = 0; ii < ng[kk]; ii++)
+            {
+                mem->A_src[nd] = &BLASFEO_DMATEL(in->DCt+kk, jj, ii);
+                mem->A_data_idx[nd] = nn;
+                nd++;
+                nn++;
+            }
 
             // replicated softed bound on u
             if (idxbu<nb[kk]) // bounded input
@@ -743,7 +779,9 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             {
                 if (in->idxs_rev[kk][nb[kk]+ii]>=0) // softed
                 {
-                    mem->A_x[nn] = BLASFEO_DMATEL(in->DCt+kk, jj, ii);
+                    mem->A_src[nd] = &BLASFEO_DMATEL(in->DCt+kk, jj, ii);
+                    mem->A_data_idx[nd] = nn;
+                    nd++;
                     nn++;
                 }
             }
@@ -755,19 +793,24 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
         {
             if (kk > 0)
             {
-                // write column from -I
+                // column from -I
                 mem->A_x[nn] = -1.0;
                 nn++;
             }
 
             if (kk < N)
             {
-                // write column from A
-                blasfeo_unpack_dmat(1, nx[kk+1], in->BAbt+kk, nu[kk]+jj, 0, mem->A_x+nn, 1);
-                nn += nx[kk+1];
+                // column from A
+                for (ii = 0; ii < nx[kk+1]; ii++)
+                {
+                    mem->A_src[nd] = &BLASFEO_DMATEL(in->BAbt+kk, nu[kk]+jj, ii);
+                    mem->A_data_idx[nd] = nn;
+                    nd++;
+                    nn++;
+                }
             }
 
-            // write bound on x
+            // bound on x
             for (ii = 0; ii < dims->nb[kk]; ii++)
             {
                 if (in->idxb[kk][ii] == dims->nu[kk] + jj)
@@ -779,9 +822,14 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             }
             int idxbx = ii;
 
-            // write column from C
-            blasfeo_unpack_dmat(1, ng[kk], in->DCt+kk, nu[kk]+jj, 0, mem->A_x+nn, 1);
-            nn += ng[kk];
+            // column from C
+            for (ii = 0; ii < ng[kk]; ii++)
+            {
+                mem->A_src[nd] = &BLASFEO_DMATEL(in->DCt+kk, nu[kk]+jj, ii);
+                mem->A_data_idx[nd] = nn;
+                nd++;
+                nn++;
+            }
 
             // replicated softed bound on x
             if (idxbx<nb[kk]) // bounded input
@@ -798,7 +846,9 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             {
                 if (in->idxs_rev[kk][nb[kk]+ii]>=0) // softed
                 {
-                    mem->A_x[nn] = BLASFEO_DMATEL(in->DCt+kk, nu[kk]+jj, ii);
+                    mem->A_src[nd] = &BLASFEO_DMATEL(in->DCt+kk, nu[kk]+jj, ii);
+                    mem->A_data_idx[nd] = nn;
+                    nd++;
                     nn++;
                 }
             }
@@ -846,7 +896,28 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
         }
 
     }
+    mem->A_ndata = nd;
+}
 
+
+
+static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
+{
+    // gather the data nonzeros of A from qp_in, keep track of the ones which changed since the last call
+    c_int n_upd = 0;
+    for (c_int nd = 0; nd < mem->A_ndata; nd++)
+    {
+        c_float val = *mem->A_src[nd];
+        c_int idx = mem->A_data_idx[nd];
+        if (val != mem->A_x[idx])
+        {
+            mem->A_x[idx] = val;
+            mem->A_upd_x[n_upd] = val;
+            mem->A_upd_idx[n_upd] = idx;
+            n_upd++;
+        }
+    }
+    mem->A_nupd = n_upd;
 }
 
 
@@ -939,6 +1010,14 @@ static void ocp_qp_osqp_update_memory(const ocp_qp_in *in, const ocp_qp_osqp_opt
         update_constraints_matrix_structure(in, mem);
     }
 
+    // the scatter maps point into the memory of qp_in
+    if (mem->first_run || in != mem->qp_in_map)
+    {
+        update_hessian_scatter_map(in, mem);
+        update_constraints_matrix_scatter_map(in, mem);
+        mem->qp_in_map = in;
+    }
+
     update_bounds(in, mem);
     update_gradient(in, mem);
     update_hessian_data(in, mem);
@@ -1180,11 +1259,20 @@ acados_size_t ocp_qp_osqp_memory_calculate_size(void *config_, void *dims_, void
     size += A_nnzmax * sizeof(c_int);    // A_i
     size += (n + 1) * sizeof(c_int);     // A_p
 
+    // scatter maps
+    size += P_nnzmax * sizeof(c_float *);  // P_src
+    size += P_nnzmax * sizeof(c_float);    // P_upd_x
+    size += P_nnzmax * sizeof(c_int);      // P_upd_idx
+    size += A_nnzmax * sizeof(c_float *);  // A_src
+    size += A_nnzmax * sizeof(c_int);      // A_data_idx
+    size += A_nnzmax * sizeof(c_float);    // A_upd_x
+    size += A_nnzmax * sizeof(c_int);      // A_upd_idx
+
     size += sizeof(OSQPData);
     size += 2 * sizeof(csc);  // matrices P and A
     size += osqp_workspace_calculate_size(n, m, P_nnzmax, A_nnzmax);
 
-    size += 1 * 8;
+    size += 2 * 8;
 
     return size;
 }
@@ -1495,9 +1583,21 @@ void *ocp_qp_osqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
     mem->P_nnzmax = P_nnzmax;
     mem->A_nnzmax = A_nnzmax;
     mem->first_run = 1;
+    mem->qp_in_map = NULL;
+    mem->P_ndata = 0;
+    mem->A_ndata = 0;
+    mem->P_nupd = 0;
+    mem->A_nupd = 0;
 
     align_char_to(8, &c_ptr);
 
+    // pointers
+    mem->P_src = (c_float **) c_ptr;
+    c_ptr += (mem->P_nnzmax) * sizeof(c_float *);
+
+    mem->A_src = (c_float **) c_ptr;
+    c_ptr += (mem->A_nnzmax) * sizeof(c_float *);
+
     // doubles
     mem->q = (c_float *) c_ptr;
     c_ptr += n * sizeof(c_float);
@@ -1514,6 +1614,12 @@ void *ocp_qp_osqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
     mem->A_x = (c_float *) c_ptr;
     c_ptr += (mem->A_nnzmax) * sizeof(c_float);
 
+    mem->P_upd_x = (c_float *) c_ptr;
+    c_ptr += (mem->P_nnzmax) * sizeof(c_float);
+
+    mem->A_upd_x = (c_float *) c_ptr;
+    c_ptr += (mem->A_nnzmax) * sizeof(c_float);
+
     // ints
     mem->P_i = (c_int *) c_ptr;
     c_ptr += (mem->P_nnzmax) * sizeof(c_int);
@@ -1527,6 +1633,17 @@ void *ocp_qp_osqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
     mem->A_p = (c_int *) c_ptr;
     c_ptr += (n + 1) * sizeof(c_int);
 
+    mem->P_upd_idx = (c_int *) c_ptr;
+    c_ptr += (mem->P_nnzmax) * sizeof(c_int);
+
+    mem->A_data_idx = (c_int *) c_ptr;
+    c_ptr += (mem->A_nnzmax) * sizeof(c_int);
+
+    mem->A_upd_idx = (c_int *) c_ptr;
+    c_ptr += (mem->A_nnzmax) * sizeof(c_int);
+
+    align_char_to(8, &c_ptr);
+
     mem->osqp_data = (OSQPData *) c_ptr;
     c_ptr += sizeof(OSQPData);
 
@@ -1580,6 +1697,16 @@ void ocp_qp_osqp_memory_get(void *config_, void *mem_, const char *field, void*
         int *tmp_ptr = value;
         *tmp_ptr = mem->status;
     }
+    else if (!strcmp(field, "P_nnz_update"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->P_nupd;
+    }
+    else if (!strcmp(field, "A_nnz_update"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->A_nupd;
+    }
     else
     {
         printf("\nerror: ocp_qp_osqp_memory_get: field %s not available\n", field);
@@ -1734,8 +1861,20 @@ int ocp_qp_osqp(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *m
     if (!mem->first_run)
     {
         osqp_update_lin_cost(mem->osqp_work, mem->q);
-        osqp_update_P_A(mem->osqp_work, mem->P_x, NULL, mem->P_nnzmax, mem->A_x, NULL,
-                        mem->A_nnzmax);
+        // only pass the changed nonzeros, skip the matrix update (and refactorization) if none changed
+        if (mem->P_nupd > 0 && mem->A_nupd > 0)
+        {
+            osqp_update_P_A(mem->osqp_work, mem->P_upd_x, mem->P_upd_idx, mem->P_nupd,
+                            mem->A_upd_x, mem->A_upd_idx, mem->A_nupd);
+        }
+        else if (mem->P_nupd > 0)
+        {
+            osqp_update_P(mem->osqp_work, mem->P_upd_x, mem->P_upd_idx, mem->P_nupd);
+        }
+        else if (mem->A_nupd > 0)
+        {
+            osqp_update_A(mem->osqp_work, mem->A_upd_x, mem->A_upd_idx, mem->A_nupd);
+        }
         osqp_update_bounds(mem->osqp_work, mem->l, mem->u);
         cpy_osqp_settings(opts->osqp_opts, mem->osqp_work->settings);
     }
@@ -67,6 +67,22 @@ typedef struct ocp_qp_osqp_memory_
     c_int *A_p;
     c_float *A_x;
 
+    // scatter maps from qp_in to the nonzeros of P and A, built on the first call
+    const ocp_qp_in *qp_in_map;  // qp_in the maps point into
+    c_int P_ndata;
+    c_float **P_src;    // location in qp_in of the nonzeros of P
+    c_int A_ndata;      // number of nonzeros of A which are not constant
+    c_float **A_src;    // location in qp_in of the non-constant nonzeros of A
+    c_int *A_data_idx;  // index of the non-constant nonzeros in A_x
+
+    // nonzeros which changed since the last call
+    c_int P_nupd;
+    c_float *P_upd_x;
+    c_int *P_upd_idx;
+    c_int A_nupd;
+    c_float *A_upd_x;
+    c_int *A_upd_idx;
+
     OSQPData *osqp_data;
     OSQPWorkspace *osqp_work;
 
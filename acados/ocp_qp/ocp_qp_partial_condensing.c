@@ -261,6 +261,8 @@ void ocp_qp_partial_condensing_opts_initialize_default(void *dims_, void *opts_)
 
     opts->mem_qp_in = 1;
 
+    opts->num_threads = 1;
+
     return;
 }
 
@@ -311,6 +313,11 @@ void ocp_qp_partial_condensing_opts_set(void *opts_, const char *field, void* va
         }
         opts->block_size_was_set = true;
     }
+    else if(!strcmp(field, "num_threads"))
+    {
+        int *tmp_ptr = value;
+        opts->num_threads = *tmp_ptr;
+    }
     // TODO dual_sol ???
     else
     {
@@ -323,6 +330,579 @@ void ocp_qp_partial_condensing_opts_set(void *opts_, const char *field, void* va
 
 
 
+/************************************************
+ * segments (parallel condensing)
+ ************************************************/
+
+static int ocp_qp_partial_condensing_num_segments(ocp_qp_partial_condensing_dims *dims, ocp_qp_partial_condensing_opts *opts)
+{
+#if defined(ACADOS_WITH_OPENMP)
+    int N2 = dims->pcond_dims->N;
+    int num_segments = opts->num_threads < N2 ? opts->num_threads : N2;
+    return num_segments > 1 ? num_segments : 0;
+#else
+    return 0;
+#endif
+}
+
+
+
+static void ocp_qp_partial_condensing_dims_alias(ocp_qp_dims *dims, int idx, int N, ocp_qp_dims *alias)
+{
+    *alias = *dims;
+    alias->N = N;
+    alias->nx = dims->nx+idx;
+    alias->nu = dims->nu+idx;
+    alias->nb = dims->nb+idx;
+    alias->nbx = dims->nbx+idx;
+    alias->nbu = dims->nbu+idx;
+    alias->ng = dims->ng+idx;
+    alias->ns = dims->ns+idx;
+    alias->nsbx = dims->nsbx+idx;
+    alias->nsbu = dims->nsbu+idx;
+    alias->nsg = dims->nsg+idx;
+    alias->nbxe = dims->nbxe+idx;
+    alias->nbue = dims->nbue+idx;
+    alias->nge = dims->nge+idx;
+}
+
+
+
+// segment ss gets blocks [k0, k1) and stages [n0, n1] of the reduced qp
+static void ocp_qp_partial_condensing_segment_set_dims(ocp_qp_partial_condensing_dims *dims, int num_segments,
+                                                       int ss, ocp_qp_partial_condensing_segment *seg)
+{
+    int ii;
+    int N2 = dims->pcond_dims->N;
+    int k0 = ss*N2/num_segments;
+    int k1 = (ss+1)*N2/num_segments;
+
+    int n0 = 0;
+    for (ii = 0; ii < k0; ii++)
+        n0 += dims->block_size[ii];
+    int n1 = n0;
+    for (ii = k0; ii < k1; ii++)
+        n1 += dims->block_size[ii];
+    if (ss == num_segments-1)
+        n1 = dims->red_dims->N;
+
+    seg->idx_block = k0;
+    seg->N2 = k1-k0;
+    seg->idx_stage = n0;
+    seg->N = n1-n0;
+
+    ocp_qp_partial_condensing_dims_alias(dims->red_dims, n0, n1-n0, &seg->red_dims);
+    ocp_qp_partial_condensing_dims_alias(dims->red_dims, n1, 0, &seg->term_dims);
+}
+
+
+
+// size of the dimensions, block sizes and hpipm arguments of a segment, which determine its workspace size
+static acados_size_t ocp_qp_partial_condensing_segment_setup_calculate_size(ocp_qp_partial_condensing_segment *seg)
+{
+    int N2 = seg->N2;
+
+    acados_size_t size = 0;
+
+    size += ocp_qp_dims_calculate_size(N2);  // pcond_dims
+    size += sizeof(struct d_part_cond_qp_arg) + d_part_cond_qp_arg_memsize(N2);  // hpipm_pcond_opts
+    size += (N2+1)*sizeof(int);  // block_size
+
+    size += 3*8;  // aligns
+
+    return size;
+}
+
+
+
+static void ocp_qp_partial_condensing_segment_setup_assign(ocp_qp_partial_condensing_dims *dims,
+                            ocp_qp_partial_condensing_opts *opts, ocp_qp_partial_condensing_segment *seg,
+                            bool last, char **c_ptr)
+{
+    int ii;
+    int N2 = seg->N2;
+    int N2_full = dims->pcond_dims->N;
+
+    align_char_to(8, c_ptr);
+
+    // pcond_dims
+    seg->pcond_dims = ocp_qp_dims_assign(N2, *c_ptr);
+    *c_ptr += ocp_qp_dims_calculate_size(N2);
+
+    align_char_to(8, c_ptr);
+
+    // hpipm_pcond_opts, same options as the ones of the full problem
+    seg->hpipm_pcond_opts = (struct d_part_cond_qp_arg *) *c_ptr;
+    *c_ptr += sizeof(struct d_part_cond_qp_arg);
+    align_char_to(8, c_ptr);
+    d_part_cond_qp_arg_create(N2, seg->hpipm_pcond_opts, *c_ptr);
+    *c_ptr += seg->hpipm_pcond_opts->memsize;
+    d_part_cond_qp_arg_set_default(seg->hpipm_pcond_opts);
+    d_part_cond_qp_arg_set_ric_alg(opts->ric_alg, seg->hpipm_pcond_opts);
+
+    // block_size, the last block of a segment which is not the last one is its scratch last stage
+    assign_and_advance_int(N2+1, &seg->block_size, c_ptr);
+    for (ii = 0; ii < N2; ii++)
+        seg->block_size[ii] = dims->block_size[seg->idx_block+ii];
+    seg->block_size[N2] = last ? dims->block_size[N2_full] : 0;
+    d_part_cond_qp_compute_dim(&seg->red_dims, seg->block_size, seg->pcond_dims);
+}
+
+
+
+static acados_size_t ocp_qp_partial_condensing_segment_calculate_size(ocp_qp_partial_condensing_dims *dims,
+                            ocp_qp_partial_condensing_opts *opts, ocp_qp_partial_condensing_segment *seg, bool last)
+{
+    int N = seg->N;
+    int N2 = seg->N2;
+
+    acados_size_t size = 0;
+
+    // pcond_dims, hpipm_pcond_opts, block_size
+    acados_size_t setup_size = ocp_qp_partial_condensing_segment_setup_calculate_size(seg);
+    size += setup_size;
+
+    // hpipm_pcond_work, its size is computed on a temporary setup of the segment
+    char *setup_mem = acados_malloc(1, setup_size);
+    char *c_ptr = setup_mem;
+    ocp_qp_partial_condensing_segment_setup_assign(dims, opts, seg, last, &c_ptr);
+    size += sizeof(struct d_part_cond_qp_ws);
+    size += d_part_cond_qp_ws_memsize(&seg->red_dims, seg->block_size, seg->pcond_dims, seg->hpipm_pcond_opts);
+    free(setup_mem);
+
+    // aliases into the partially condensed qp
+    size += (3*N2+2)*sizeof(struct blasfeo_dmat);  // BAbt RSQrq DCt
+    size += (6*N2+5)*sizeof(struct blasfeo_dvec);  // b rqz d d_mask m Z
+    size += 3*(N2+1)*sizeof(int *);  // idxb idxs_rev idxe
+
+    // aliases into the solutions
+    size += (4*N2+3)*sizeof(struct blasfeo_dvec);  // pcond_sol: ux pi lam t
+    size += (4*N+3)*sizeof(struct blasfeo_dvec);  // red_sol: ux pi lam t
+
+    // aliases into the seeds
+    size += (4*N2+3)*sizeof(struct blasfeo_dvec);  // pcond_seed: seed_g seed_b seed_d seed_m
+    size += (4*N+3)*sizeof(struct blasfeo_dvec);  // red_seed: seed_g seed_b seed_d seed_m
+
+    size += (N2+1)*sizeof(int);  // diag_H_flag
+
+    // scratch last stage
+    if (!last)
+    {
+        size += ocp_qp_in_calculate_size(&seg->term_dims);
+        size += 2*ocp_qp_out_calculate_size(&seg->term_dims);
+        size += ocp_qp_seed_calculate_size(&seg->term_dims);
+    }
+
+    size += 3*8;  // aligns
+
+    return size;
+}
+
+
+
+static void ocp_qp_partial_condensing_segment_assign(ocp_qp_partial_condensing_dims *dims,
+                            ocp_qp_partial_condensing_opts *opts, ocp_qp_partial_condensing_segment *seg,
+                            bool last, char **c_ptr)
+{
+    int N = seg->N;
+    int N2 = seg->N2;
+
+    memset(&seg->red_qp, 0, sizeof(ocp_qp_in));
+    memset(&seg->pcond_qp, 0, sizeof(ocp_qp_in));
+    memset(&seg->red_sol, 0, sizeof(ocp_qp_out));
+    memset(&seg->pcond_sol, 0, sizeof(ocp_qp_out));
+    memset(&seg->red_seed, 0, sizeof(ocp_qp_seed));
+    memset(&seg->pcond_seed, 0, sizeof(ocp_qp_seed));
+
+    // pcond_dims, hpipm_pcond_opts, block_size
+    ocp_qp_partial_condensing_segment_setup_assign(dims, opts, seg, last, c_ptr);
+
+    align_char_to(8, c_ptr);
+
+    // hpipm_pcond_work, owned by the segment
+    seg->hpipm_pcond_work = (struct d_part_cond_qp_ws *) *c_ptr;
+    *c_ptr += sizeof(struct d_part_cond_qp_ws);
+    align_char_to(8, c_ptr);
+    d_part_cond_qp_ws_create(&seg->red_dims, seg->block_size, seg->pcond_dims, seg->hpipm_pcond_opts,
+                             seg->hpipm_pcond_work, *c_ptr);
+    *c_ptr += seg->hpipm_pcond_work->memsize;
+
+    // aliases into the partially condensed qp
+    seg->pcond_qp.BAbt = (struct blasfeo_dmat *) *c_ptr;
+    *c_ptr += N2*sizeof(struct blasfeo_dmat);
+    seg->pcond_qp.RSQrq = (struct blasfeo_dmat *) *c_ptr;
+    *c_ptr += (N2+1)*sizeof(struct blasfeo_dmat);
+    seg->pcond_qp.DCt = (struct blasfeo_dmat *) *c_ptr;
+    *c_ptr += (N2+1)*sizeof(struct blasfeo_dmat);
+    seg->pcond_qp.b = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += N2*sizeof(struct blasfeo_dvec);
+    seg->pcond_qp.rqz = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += (N2+1)*sizeof(struct blasfeo_dvec);
+    seg->pcond_qp.d = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += (N2+1)*sizeof(struct blasfeo_dvec);
+    seg->pcond_qp.d_mask = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += (N2+1)*sizeof(struct blasfeo_dvec);
+    seg->pcond_qp.m = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += (N2+1)*sizeof(struct blasfeo_dvec);
+    seg->pcond_qp.Z = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += (N2+1)*sizeof(struct blasfeo_dvec);
+    seg->pcond_qp.idxb = (int **) *c_ptr;
+    *c_ptr += (N2+1)*sizeof(int *);
+    seg->pcond_qp.idxs_rev = (int **) *c_ptr;
+    *c_ptr += (N2+1)*sizeof(int *);
+    seg->pcond_qp.idxe = (int **) *c_ptr;
+    *c_ptr += (N2+1)*sizeof(int *);
+    seg->pcond_qp.dim = seg->pcond_dims;
+
+    // aliases into the solutions
+    seg->pcond_sol.ux = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += (N2+1)*sizeof(struct blasfeo_dvec);
+    seg->pcond_sol.pi = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += N2*sizeof(struct blasfeo_dvec);
+    seg->pcond_sol.lam = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += (N2+1)*sizeof(struct blasfeo_dvec);
+    seg->pcond_sol.t = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += (N2+1)*sizeof(struct blasfeo_dvec);
+    seg->pcond_sol.dim = seg->pcond_dims;
+
+    seg->red_sol.ux = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += (N+1)*sizeof(struct blasfeo_dvec);
+    seg->red_sol.pi = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += N*sizeof(struct blasfeo_dvec);
+    seg->red_sol.lam = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += (N+1)*sizeof(struct blasfeo_dvec);
+    seg->red_sol.t = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += (N+1)*sizeof(struct blasfeo_dvec);
+    seg->red_sol.dim = &seg->red_dims;
+
+    // aliases into the seeds
+    seg->pcond_seed.seed_g = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += (N2+1)*sizeof(struct blasfeo_dvec);
+    seg->pcond_seed.seed_b = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += N2*sizeof(struct blasfeo_dvec);
+    seg->pcond_seed.seed_d = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += (N2+1)*sizeof(struct blasfeo_dvec);
+    seg->pcond_seed.seed_m = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += (N2+1)*sizeof(struct blasfeo_dvec);
+    seg->pcond_seed.dim = seg->pcond_dims;
+
+    seg->red_seed.seed_g = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += (N+1)*sizeof(struct blasfeo_dvec);
+    seg->red_seed.seed_b = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += N*sizeof(struct blasfeo_dvec);
+    seg->red_seed.seed_d = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += (N+1)*sizeof(struct blasfeo_dvec);
+    seg->red_seed.seed_m = (struct blasfeo_dvec *) *c_ptr;
+    *c_ptr += (N+1)*sizeof(struct blasfeo_dvec);
+    seg->red_seed.dim = &seg->red_dims;
+
+    // ints
+    assign_and_advance_int(N2+1, &seg->pcond_qp.diag_H_flag, c_ptr);
+
+    align_char_to(8, c_ptr);
+
+    // scratch last stage
+    seg->term_qp = NULL;
+    seg->term_sol = NULL;
+    seg->term_red_sol = NULL;
+    seg->term_seed = NULL;
+    if (!last)
+    {
+        seg->term_qp = ocp_qp_in_assign(&seg->term_dims, *c_ptr);
+        *c_ptr += ocp_qp_in_calculate_size(&seg->term_dims);
+        seg->term_sol = ocp_qp_out_assign(&seg->term_dims, *c_ptr);
+        *c_ptr += ocp_qp_out_calculate_size(&seg->term_dims);
+        seg->term_red_sol = ocp_qp_out_assign(&seg->term_dims, *c_ptr);
+        *c_ptr += ocp_qp_out_calculate_size(&seg->term_dims);
+        seg->term_seed = ocp_qp_seed_assign(&seg->term_dims, *c_ptr);
+        *c_ptr += ocp_qp_seed_calculate_size(&seg->term_dims);
+    }
+}
+
+
+
+// point the segment to the current qps; blasfeo headers are copied, data is shared
+static void ocp_qp_partial_condensing_segment_alias(ocp_qp_partial_condensing_segment *seg,
+                            ocp_qp_in *red_qp, ocp_qp_in *pcond_qp, ocp_qp_out *red_sol, ocp_qp_out *pcond_sol,
+                            ocp_qp_seed *red_seed, ocp_qp_seed *pcond_seed)
+{
+    int ii;
+    int n0 = seg->idx_stage;
+    int k0 = seg->idx_block;
+    int N = seg->N;
+    int N2 = seg->N2;
+    bool last = seg->term_qp == NULL;
+
+    // reduced qp, stages [n0, n0+N]
+    seg->red_qp.dim = &seg->red_dims;
+    seg->red_qp.BAbt = red_qp->BAbt+n0;
+    seg->red_qp.RSQrq = red_qp->RSQrq+n0;
+    seg->red_qp.DCt = red_qp->DCt+n0;
+    seg->red_qp.b = red_qp->b+n0;
+    seg->red_qp.rqz = red_qp->rqz+n0;
+    seg->red_qp.d = red_qp->d+n0;
+    seg->red_qp.d_mask = red_qp->d_mask+n0;
+    seg->red_qp.m = red_qp->m+n0;
+    seg->red_qp.Z = red_qp->Z+n0;
+    seg->red_qp.idxb = red_qp->idxb+n0;
+    seg->red_qp.idxs_rev = red_qp->idxs_rev+n0;
+    seg->red_qp.idxe = red_qp->idxe+n0;
+    seg->red_qp.diag_H_flag = red_qp->diag_H_flag+n0;
+    seg->red_qp.memsize = red_qp->memsize;
+
+    // partially condensed qp, blocks [k0, k0+N2)
+    if (pcond_qp != NULL)
+    {
+        for (ii = 0; ii < N2; ii++)
+        {
+            seg->pcond_qp.BAbt[ii] = pcond_qp->BAbt[k0+ii];
+            seg->pcond_qp.b[ii] = pcond_qp->b[k0+ii];
+        }
+        for (ii = 0; ii <= N2; ii++)
+        {
+            ocp_qp_in *src = (ii < N2 || last) ? pcond_qp : seg->term_qp;
+            int jj = (ii < N2 || last) ? k0+ii : 0;
+            seg->pcond_qp.RSQrq[ii] = src->RSQrq[jj];
+            seg->pcond_qp.DCt[ii] = src->DCt[jj];
+            seg->pcond_qp.rqz[ii] = src->rqz[jj];
+            seg->pcond_qp.d[ii] = src->d[jj];
+            seg->pcond_qp.d_mask[ii] = src->d_mask[jj];
+            seg->pcond_qp.m[ii] = src->m[jj];
+            seg->pcond_qp.Z[ii] = src->Z[jj];
+            seg->pcond_qp.idxb[ii] = src->idxb[jj];
+            seg->pcond_qp.idxs_rev[ii] = src->idxs_rev[jj];
+            seg->pcond_qp.idxe[ii] = src->idxe[jj];
+            seg->pcond_qp.diag_H_flag[ii] = src->diag_H_flag[jj];
+        }
+        seg->pcond_qp.memsize = pcond_qp->memsize;
+    }
+
+    // solution of the partially condensed qp
+    if (pcond_sol != NULL)
+    {
+        for (ii = 0; ii < N2; ii++)
+            seg->pcond_sol.pi[ii] = pcond_sol->pi[k0+ii];
+        for (ii = 0; ii <= N2; ii++)
+        {
+            ocp_qp_out *src = (ii < N2 || last) ? pcond_sol : seg->term_sol;
+            int jj = (ii < N2 || last) ? k0+ii : 0;
+            seg->pcond_sol.ux[ii] = src->ux[jj];
+            seg->pcond_sol.lam[ii] = src->lam[jj];
+            seg->pcond_sol.t[ii] = src->t[jj];
+        }
+        seg->pcond_sol.misc = pcond_sol->misc;
+        seg->pcond_sol.memsize = pcond_sol->memsize;
+    }
+
+    // solution of the reduced qp
+    if (red_sol != NULL)
+    {
+        for (ii = 0; ii < N; ii++)
+            seg->red_sol.pi[ii] = red_sol->pi[n0+ii];
+        for (ii = 0; ii <= N; ii++)
+        {
+            ocp_qp_out *src = (ii < N || last) ? red_sol : seg->term_red_sol;
+            int jj = (ii < N || last) ? n0+ii : 0;
+            seg->red_sol.ux[ii] = src->ux[jj];
+            seg->red_sol.lam[ii] = src->lam[jj];
+            seg->red_sol.t[ii] = src->t[jj];
+        }
+        seg->red_sol.misc = red_sol->misc;
+        seg->red_sol.memsize = red_sol->memsize;
+    }
+
+    // seed of the reduced qp, only read
+    if (red_seed != NULL)
+    {
+        for (ii = 0; ii < N; ii++)
+            seg->red_seed.seed_b[ii] = red_seed->seed_b[n0+ii];
+        for (ii = 0; ii <= N; ii++)
+        {
+            seg->red_seed.seed_g[ii] = red_seed->seed_g[n0+ii];
+            seg->red_seed.seed_d[ii] = red_seed->seed_d[n0+ii];
+            seg->red_seed.seed_m[ii] = red_seed->seed_m[n0+ii];
+        }
+        seg->red_seed.memsize = red_seed->memsize;
+    }
+
+    // seed of the partially condensed qp
+    if (pcond_seed != NULL)
+    {
+        for (ii = 0; ii < N2; ii++)
+            seg->pcond_seed.seed_b[ii] = pcond_seed->seed_b[k0+ii];
+        for (ii = 0; ii <= N2; ii++)
+        {
+            ocp_qp_seed *src = (ii < N2 || last) ? pcond_seed : seg->term_seed;
+            int jj = (ii < N2 || last) ? k0+ii : 0;
+            seg->pcond_seed.seed_g[ii] = src->seed_g[jj];
+            seg->pcond_seed.seed_d[ii] = src->seed_d[jj];
+            seg->pcond_seed.seed_m[ii] = src->seed_m[jj];
+        }
+        seg->pcond_seed.memsize = pcond_seed->memsize;
+    }
+}
+
+
+
+// copy back headers and flags written by hpipm, except for the scratch last stage
+static void ocp_qp_partial_condensing_segment_write_back(ocp_qp_partial_condensing_segment *seg,
+                            ocp_qp_in *pcond_qp, ocp_qp_out *red_sol)
+{
+    int ii;
+    int n0 = seg->idx_stage;
+    int k0 = seg->idx_block;
+    int N = seg->N;
+    int N2 = seg->N2;
+    bool last = seg->term_qp == NULL;
+    int N2_out = last ? N2+1 : N2;
+    int N_out = last ? N+1 : N;
+
+    if (pcond_qp != NULL)
+    {
+        for (ii = 0; ii < N2; ii++)
+        {
+            pcond_qp->BAbt[k0+ii] = seg->pcond_qp.BAbt[ii];
+            pcond_qp->b[k0+ii] = seg->pcond_qp.b[ii];
+        }
+        for (ii = 0; ii < N2_out; ii++)
+        {
+            pcond_qp->RSQrq[k0+ii] = seg->pcond_qp.RSQrq[ii];
+            pcond_qp->DCt[k0+ii] = seg->pcond_qp.DCt[ii];
+            pcond_qp->rqz[k0+ii] = seg->pcond_qp.rqz[ii];
+            pcond_qp->d[k0+ii] = seg->pcond_qp.d[ii];
+            pcond_qp->d_mask[k0+ii] = seg->pcond_qp.d_mask[ii];
+            pcond_qp->m[k0+ii] = seg->pcond_qp.m[ii];
+            pcond_qp->Z[k0+ii] = seg->pcond_qp.Z[ii];
+            pcond_qp->diag_H_flag[k0+ii] = seg->pcond_qp.diag_H_flag[ii];
+        }
+    }
+
+    if (red_sol != NULL)
+    {
+        for (ii = 0; ii < N; ii++)
+            red_sol->pi[n0+ii] = seg->red_sol.pi[ii];
+        for (ii = 0; ii < N_out; ii++)
+        {
+            red_sol->ux[n0+ii] = seg->red_sol.ux[ii];
+            red_sol->lam[n0+ii] = seg->red_sol.lam[ii];
+            red_sol->t[n0+ii] = seg->red_sol.t[ii];
+        }
+    }
+}
+
+
+
+static void ocp_qp_partial_condensing_segments_cond(ocp_qp_partial_condensing_memory *mem, ocp_qp_in *pcond_qp_in,
+                            void (*cond)(struct d_ocp_qp *, struct d_ocp_qp *, struct d_part_cond_qp_arg *, struct d_part_cond_qp_ws *))
+{
+    int ss;
+    ocp_qp_partial_condensing_segment *seg;
+
+    for (ss = 0; ss < mem->num_segments; ss++)
+        ocp_qp_partial_condensing_segment_alias(mem->segments+ss, mem->red_qp, pcond_qp_in, NULL, NULL, NULL, NULL);
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for private(seg) num_threads(mem->num_segments)
+#endif
+    for (ss = 0; ss < mem->num_segments; ss++)
+    {
+        seg = mem->segments+ss;
+        cond(&seg->red_qp, &seg->pcond_qp, seg->hpipm_pcond_opts, seg->hpipm_pcond_work);
+    }
+
+    for (ss = 0; ss < mem->num_segments; ss++)
+        ocp_qp_partial_condensing_segment_write_back(mem->segments+ss, pcond_qp_in, NULL);
+}
+
+
+
+static void ocp_qp_partial_condensing_segments_cond_sol(ocp_qp_partial_condensing_memory *mem,
+                            ocp_qp_in *pcond_qp_in, ocp_qp_out *pcond_qp_out)
+{
+    int ss;
+    ocp_qp_partial_condensing_segment *seg;
+
+    for (ss = 0; ss < mem->num_segments; ss++)
+        ocp_qp_partial_condensing_segment_alias(mem->segments+ss, mem->red_qp, pcond_qp_in, mem->red_sol, pcond_qp_out, NULL, NULL);
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for private(seg) num_threads(mem->num_segments)
+#endif
+    for (ss = 0; ss < mem->num_segments; ss++)
+    {
+        seg = mem->segments+ss;
+        d_part_cond_qp_cond_sol(&seg->red_qp, &seg->pcond_qp, &seg->red_sol, &seg->pcond_sol, seg->hpipm_pcond_opts, seg->hpipm_pcond_work);
+    }
+}
+
+
+
+static void ocp_qp_partial_condensing_segments_cond_seed(ocp_qp_partial_condensing_memory *mem, ocp_qp_seed *pcond_seed)
+{
+    int ss;
+    ocp_qp_partial_condensing_segment *seg;
+
+    for (ss = 0; ss < mem->num_segments; ss++)
+        ocp_qp_partial_condensing_segment_alias(mem->segments+ss, mem->red_qp, NULL, NULL, NULL, mem->red_seed, pcond_seed);
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for private(seg) num_threads(mem->num_segments)
+#endif
+    for (ss = 0; ss < mem->num_segments; ss++)
+    {
+        seg = mem->segments+ss;
+        d_part_cond_qp_cond_seed(&seg->red_qp, &seg->red_seed, &seg->pcond_seed, seg->hpipm_pcond_opts, seg->hpipm_pcond_work);
+    }
+}
+
+
+
+static void ocp_qp_partial_condensing_segments_expand_sol(ocp_qp_partial_condensing_memory *mem, ocp_qp_out *pcond_qp_out)
+{
+    int ss;
+    ocp_qp_partial_condensing_segment *seg;
+
+    for (ss = 0; ss < mem->num_segments; ss++)
+        ocp_qp_partial_condensing_segment_alias(mem->segments+ss, mem->red_qp, NULL, mem->red_sol, pcond_qp_out, NULL, NULL);
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for private(seg) num_threads(mem->num_segments)
+#endif
+    for (ss = 0; ss < mem->num_segments; ss++)
+    {
+        seg = mem->segments+ss;
+        d_part_cond_qp_expand_sol(&seg->red_qp, &seg->pcond_sol, &seg->red_sol, seg->hpipm_pcond_opts, seg->hpipm_pcond_work);
+    }
+
+    for (ss = 0; ss < mem->num_segments; ss++)
+        ocp_qp_partial_condensing_segment_write_back(mem->segments+ss, NULL, mem->red_sol);
+}
+
+
+
+static void ocp_qp_partial_condensing_segments_expand_sol_seed(ocp_qp_partial_condensing_memory *mem, ocp_qp_out *pcond_qp_out)
+{
+    int ss;
+    ocp_qp_partial_condensing_segment *seg;
+
+    for (ss = 0; ss < mem->num_segments; ss++)
+        ocp_qp_partial_condensing_segment_alias(mem->segments+ss, mem->red_qp, NULL, mem->red_sol, pcond_qp_out, mem->red_seed, NULL);
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for private(seg) num_threads(mem->num_segments)
+#endif
+    for (ss = 0; ss < mem->num_segments; ss++)
+    {
+        seg = mem->segments+ss;
+        d_part_cond_qp_expand_sol_seed(&seg->red_qp, &seg->red_seed, &seg->pcond_sol, &seg->red_sol, seg->hpipm_pcond_opts, seg->hpipm_pcond_work);
+    }
+
+    for (ss = 0; ss < mem->num_segments; ss++)
+        ocp_qp_partial_condensing_segment_write_back(mem->segments+ss, NULL, mem->red_sol);
+}
+
+
+
 /************************************************
  * memory
  ************************************************/
@@ -389,14 +969,27 @@ acados_size_t ocp_qp_partial_condensing_memory_calculate_size(void *dims_, void
     size += ocp_qp_out_calculate_size(dims->red_dims);
     size += ocp_qp_seed_calculate_size(dims->red_dims);
 
-    // hpipm_pcond_work
-    size += sizeof(struct d_part_cond_qp_ws);
-    size += d_part_cond_qp_ws_memsize(dims->red_dims, dims->block_size, dims->pcond_dims, opts->hpipm_pcond_opts);
+    // hpipm_pcond_work, the segments have their own
+    int num_segments = ocp_qp_partial_condensing_num_segments(dims, opts);
+    if (num_segments == 0)
+    {
+        size += sizeof(struct d_part_cond_qp_ws);
+        size += d_part_cond_qp_ws_memsize(dims->red_dims, dims->block_size, dims->pcond_dims, opts->hpipm_pcond_opts);
+    }
 
     size += sizeof(struct d_ocp_qp_reduce_eq_dof_ws);
     size += d_ocp_qp_reduce_eq_dof_ws_memsize(dims->orig_dims);
 
-    size += 3*8;  // aligns
+    // segments
+    ocp_qp_partial_condensing_segment seg;
+    size += num_segments*sizeof(ocp_qp_partial_condensing_segment);
+    for (int ss = 0; ss < num_segments; ss++)
+    {
+        ocp_qp_partial_condensing_segment_set_dims(dims, num_segments, ss, &seg);
+        size += ocp_qp_partial_condensing_segment_calculate_size(dims, opts, &seg, ss == num_segments-1);
+    }
+
+    size += 4*8;  // aligns
     make_int_multiple_of(8, &size);
 
     return size;
@@ -419,18 +1012,27 @@ void *ocp_qp_partial_condensing_memory_assign(void *dims_, void *opts_, void *ra
 
     align_char_to(8, &c_ptr);
 
+    mem->num_segments = ocp_qp_partial_condensing_num_segments(dims, opts);
+
     // hpipm_pcond_work struct
-    mem->hpipm_pcond_work = (struct d_part_cond_qp_ws *) c_ptr;
-    c_ptr += sizeof(struct d_part_cond_qp_ws);
+    mem->hpipm_pcond_work = NULL;
+    if (mem->num_segments == 0)
+    {
+        mem->hpipm_pcond_work = (struct d_part_cond_qp_ws *) c_ptr;
+        c_ptr += sizeof(struct d_part_cond_qp_ws);
+    }
     // hpipm_red_work struct
     mem->hpipm_red_work = (struct d_ocp_qp_reduce_eq_dof_ws *) c_ptr;
     c_ptr += sizeof(struct d_ocp_qp_reduce_eq_dof_ws);
     align_char_to(8, &c_ptr);
 
     // hpipm_pcond_work
-    d_part_cond_qp_ws_create(dims->red_dims, dims->block_size, dims->pcond_dims,
-                             opts->hpipm_pcond_opts, mem->hpipm_pcond_work, c_ptr);
-    c_ptr += mem->hpipm_pcond_work->memsize;
+    if (mem->num_segments == 0)
+    {
+        d_part_cond_qp_ws_create(dims->red_dims, dims->block_size, dims->pcond_dims,
+                                 opts->hpipm_pcond_opts, mem->hpipm_pcond_work, c_ptr);
+        c_ptr += mem->hpipm_pcond_work->memsize;
+    }
     // hpipm_red_work
     d_ocp_qp_reduce_eq_dof_ws_create(dims->orig_dims, mem->hpipm_red_work, c_ptr);
     c_ptr += mem->hpipm_red_work->memsize;
@@ -457,6 +1059,17 @@ void *ocp_qp_partial_condensing_memory_assign(void *dims_, void *opts_, void *ra
 
     mem->dims = dims;
 
+    // segments
+    align_char_to(8, &c_ptr);
+    mem->segments = (ocp_qp_partial_condensing_segment *) c_ptr;
+    c_ptr += mem->num_segments*sizeof(ocp_qp_partial_condensing_segment);
+    for (int ss = 0; ss < mem->num_segments; ss++)
+    {
+        ocp_qp_partial_condensing_segment_set_dims(dims, mem->num_segments, ss, mem->segments+ss);
+        ocp_qp_partial_condensing_segment_assign(dims, opts, mem->segments+ss,
+                                                 ss == mem->num_segments-1, &c_ptr);
+    }
+
     assert((char *) raw_memory + ocp_qp_partial_condensing_memory_calculate_size(dims, opts) >= c_ptr);
 
     return mem;
@@ -547,7 +1160,10 @@ int ocp_qp_partial_condensing(void *qp_in_, void *pcond_qp_in_, void *opts_, voi
     // d_ocp_qp_print(pcond_qp_in->dim, pcond_qp_in);
 
     // convert to partially condensed qp structure
-    d_part_cond_qp_cond(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+    if (mem->num_segments > 0)
+        ocp_qp_partial_condensing_segments_cond(mem, pcond_qp_in, &d_part_cond_qp_cond);
+    else
+        d_part_cond_qp_cond(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
 
     // stop timer
     mem->time_qp_xcond = acados_toc(&timer);
@@ -566,7 +1182,10 @@ int ocp_qp_partial_condensing_condense_qp_out(void *qp_in_, void *pcond_qp_in_,
     ocp_qp_partial_condensing_memory *mem = mem_;
 
     d_ocp_qp_reduce_eq_dof_sol(qp_in, qp_out, mem->red_sol, opts->hpipm_red_opts, mem->hpipm_red_work);
-    d_part_cond_qp_cond_sol(mem->red_qp, pcond_qp_in, mem->red_sol, pcond_qp_out, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+    if (mem->num_segments > 0)
+        ocp_qp_partial_condensing_segments_cond_sol(mem, pcond_qp_in, pcond_qp_out);
+    else
+        d_part_cond_qp_cond_sol(mem->red_qp, pcond_qp_in, mem->red_sol, pcond_qp_out, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
 
     return ACADOS_SUCCESS;
 }
@@ -590,7 +1209,10 @@ int ocp_qp_partial_condensing_condense_lhs(void *qp_in_, void *pcond_qp_in_, voi
     acados_tic(&timer);
 
     d_ocp_qp_reduce_eq_dof_lhs(qp_in, mem->red_qp, opts->hpipm_red_opts, mem->hpipm_red_work);
-    d_part_cond_qp_cond_lhs(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+    if (mem->num_segments > 0)
+        ocp_qp_partial_condensing_segments_cond(mem, pcond_qp_in, &d_part_cond_qp_cond_lhs);
+    else
+        d_part_cond_qp_cond_lhs(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
 
     mem->time_qp_xcond = acados_toc(&timer);
 
@@ -621,7 +1243,10 @@ int ocp_qp_partial_condensing_condense_rhs(void *qp_in_, void *pcond_qp_in_, voi
     d_ocp_qp_reduce_eq_dof_rhs(qp_in, mem->red_qp, opts->hpipm_red_opts, mem->hpipm_red_work);
 
     // convert to partially condensed qp structure
-    d_part_cond_qp_cond_rhs(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+    if (mem->num_segments > 0)
+        ocp_qp_partial_condensing_segments_cond(mem, pcond_qp_in, &d_part_cond_qp_cond_rhs);
+    else
+        d_part_cond_qp_cond_rhs(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
 
     // stop timer
     mem->time_qp_xcond += acados_toc(&timer);
@@ -652,7 +1277,10 @@ int ocp_qp_partial_condensing_condense_rhs_seed(void *qp_in_, void *qp_seed, voi
     d_ocp_qp_reduce_eq_dof_seed(qp_in, qp_seed, mem->red_seed, opts->hpipm_red_opts, mem->hpipm_red_work);
 
     // convert to partially condensed qp structure
-    d_part_cond_qp_cond_seed(mem->red_qp, mem->red_seed, pcond_seed, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+    if (mem->num_segments > 0)
+        ocp_qp_partial_condensing_segments_cond_seed(mem, pcond_seed);
+    else
+        d_part_cond_qp_cond_seed(mem->red_qp, mem->red_seed, pcond_seed, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
 
     // stop timer
     mem->time_qp_xcond += acados_toc(&timer);
@@ -677,7 +1305,10 @@ int ocp_qp_partial_expansion(void *pcond_qp_out_, void *qp_out_, void *opts_, vo
 
     // expand solution
     // TODO only if N2<N
-    d_part_cond_qp_expand_sol(mem->red_qp, pcond_qp_out, mem->red_sol, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+    if (mem->num_segments > 0)
+        ocp_qp_partial_condensing_segments_expand_sol(mem, pcond_qp_out);
+    else
+        d_part_cond_qp_expand_sol(mem->red_qp, pcond_qp_out, mem->red_sol, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
 
     // restore solution
     d_ocp_qp_restore_eq_dof(mem->ptr_qp_in, mem->red_sol, qp_out, opts->hpipm_red_opts, mem->hpipm_red_work);
@@ -703,7 +1334,10 @@ int ocp_qp_partial_condensing_expand_sol_seed(void *pcond_qp_out_, void *qp_out_
     acados_tic(&timer);
 
     // expand solution
-    d_part_cond_qp_expand_sol_seed(mem->red_qp, mem->red_seed, pcond_qp_out, mem->red_sol, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+    if (mem->num_segments > 0)
+        ocp_qp_partial_condensing_segments_expand_sol_seed(mem, pcond_qp_out);
+    else
+        d_part_cond_qp_expand_sol_seed(mem->red_qp, mem->red_seed, pcond_qp_out, mem->red_sol, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
 
     // restore solution
     d_ocp_qp_restore_eq_dof_seed(mem->ptr_qp_in, mem->ptr_qp_seed, mem->red_sol, qp_out, opts->hpipm_red_opts, mem->hpipm_red_work);
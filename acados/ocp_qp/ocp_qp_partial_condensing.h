@@ -65,13 +65,49 @@ typedef struct ocp_qp_partial_condensing_opts_
     bool block_size_was_set;
     int ric_alg;
     int mem_qp_in; // allocate qp_in in memory
+    int num_threads; // number of segments condensed and expanded in parallel, the QP solve stays sequential
 } ocp_qp_partial_condensing_opts;
 
 
 
-typedef struct ocp_qp_partial_condensing_memory_
+// NOTE: only condensing and expansion run in parallel over segments. A parallel-in-time solve of the
+// partially condensed QP (e.g. a cyclic-reduction or tree Riccati recursion) is not implemented,
+// the QP solvers, including the HPIPM Riccati recursion, run sequentially over the N2 blocks.
+
+// contiguous range of condensing blocks, condensed and expanded independently of the other segments;
+// each segment has its own hpipm arguments and workspace, the qps and solutions alias the ones of the
+// full problem, except for the last stage of the segment, which is the first stage of the next segment
+// and is kept in scratch memory (unless last segment)
+typedef struct
 {
+    int N;  // number of stages of the reduced qp
+    int N2;  // number of blocks
+    int idx_stage;  // first stage in the reduced qp
+    int idx_block;  // first block in the partially condensed qp
+    int *block_size;
+    ocp_qp_dims red_dims;  // alias into red_dims
+    ocp_qp_dims term_dims;  // alias into red_dims, last stage only
+    ocp_qp_dims *pcond_dims;
+    struct d_part_cond_qp_arg *hpipm_pcond_opts;
     struct d_part_cond_qp_ws *hpipm_pcond_work;
+    ocp_qp_in red_qp;
+    ocp_qp_in pcond_qp;
+    ocp_qp_out red_sol;
+    ocp_qp_out pcond_sol;
+    ocp_qp_seed red_seed;
+    ocp_qp_seed pcond_seed;
+    // scratch last stage, NULL for last segment
+    ocp_qp_in *term_qp;
+    ocp_qp_out *term_sol;
+    ocp_qp_out *term_red_sol;
+    ocp_qp_seed *term_seed;
+} ocp_qp_partial_condensing_segment;
+
+
+
+typedef struct ocp_qp_partial_condensing_memory_
+{
+    struct d_part_cond_qp_ws *hpipm_pcond_work; // NULL if condensing is in segments
     struct d_ocp_qp_reduce_eq_dof_ws *hpipm_red_work;
     // in memory
     ocp_qp_in *pcond_qp_in;
@@ -87,6 +123,8 @@ typedef struct ocp_qp_partial_condensing_memory_
     qp_info *qp_out_info; // info in pcond_qp_in
     ocp_qp_partial_condensing_dims *dims;
     double time_qp_xcond;
+    int num_segments; // 0 if condensing is serial
+    ocp_qp_partial_condensing_segment *segments;
 } ocp_qp_partial_condensing_memory;
 
 
@@ -246,6 +246,7 @@ void ocp_qp_xcond_solver_opts_initialize_default(void *config_, ocp_qp_xcond_sol
     qp_solver->opts_initialize_default(qp_solver, xcond_qp_dims, opts->qp_solver_opts);
 
     opts->initialize_next_xcond_qp_from_qp_out = false;
+    opts->reuse_constant_lhs = false;
 }
 
 
@@ -290,6 +291,11 @@ void ocp_qp_xcond_solver_opts_set_(void *config_, void *opts_, const char *field
         bool* initialize_next_xcond_qp_from_qp_out = (bool *) value;
         opts->initialize_next_xcond_qp_from_qp_out = *initialize_next_xcond_qp_from_qp_out;
     }
+    else if (!strcmp(field, "reuse_constant_lhs"))
+    {
+        int* reuse_constant_lhs = (int *) value;
+        opts->reuse_constant_lhs = *reuse_constant_lhs;
+    }
     else // pass options to QP module
     {
         qp_solver->opts_set(qp_solver, opts->qp_solver_opts, field, value);
@@ -337,6 +343,9 @@ acados_size_t ocp_qp_xcond_solver_memory_calculate_size(void *config_, ocp_qp_xc
 
     size += qp_solver->memory_calculate_size(qp_solver, xcond_qp_dims, opts->qp_solver_opts);
 
+    if (opts->reuse_constant_lhs)
+        size += ocp_qp_in_lhs_calculate_size(dims->orig_dims);  // lhs_data
+
     size += 8;
 
     return size;
@@ -371,6 +380,16 @@ void *ocp_qp_xcond_solver_memory_assign(void *config_, ocp_qp_xcond_solver_dims
     mem->solver_memory = qp_solver->memory_assign(qp_solver, xcond_qp_dims, opts->qp_solver_opts, c_ptr);
     c_ptr += qp_solver->memory_calculate_size(qp_solver, xcond_qp_dims, opts->qp_solver_opts);
 
+    align_char_to(8, &c_ptr);
+    mem->lhs_data = NULL;
+    if (opts->reuse_constant_lhs)
+    {
+        mem->lhs_data = (double *) c_ptr;
+        c_ptr += ocp_qp_in_lhs_calculate_size(dims->orig_dims);
+    }
+    mem->lhs_qp_in = NULL;
+    mem->time_qp_xcond_offset = 0.0;
+
     xcond->memory_get(xcond, mem->xcond_memory, "xcond_qp_in", &mem->xcond_qp_in);
     xcond->memory_get(xcond, mem->xcond_memory, "xcond_qp_out", &mem->xcond_qp_out);
     xcond->memory_get(xcond, mem->xcond_memory, "xcond_seed", &mem->xcond_seed);
@@ -397,6 +416,7 @@ void ocp_qp_xcond_solver_memory_reset(void *config_, ocp_qp_xcond_solver_dims *d
     xcond->dims_get(xcond, dims->xcond_dims, "xcond_dims", &xcond_qp_dims);
 
     mem->solver_memory = qp_solver->memory_assign(qp_solver, xcond_qp_dims, opts->qp_solver_opts, mem->solver_memory);
+    mem->lhs_qp_in = NULL;
 
     return;
 }
@@ -436,13 +456,15 @@ void ocp_qp_xcond_solver_memory_get(void *config_, void *mem_, const char *field
     {
         qp_solver->memory_get(qp_solver, mem->solver_memory, field, value);
     }
-    else if (!strcmp(field, "status"))
+    else if (!strcmp(field, "status") || !strcmp(field, "riccati_double"))
     {
         qp_solver->memory_get(qp_solver, mem->solver_memory, field, value);
     }
     else if (!strcmp(field, "time_qp_xcond"))
     {
-        xcond->memory_get(xcond, mem->xcond_memory, field, value);
+        double *time_qp_xcond = value;
+        xcond->memory_get(xcond, mem->xcond_memory, field, time_qp_xcond);
+        *time_qp_xcond -= mem->time_qp_xcond_offset;
     }
     else
     {
@@ -515,6 +537,23 @@ static void cast_workspace(void *config_, ocp_qp_xcond_solver_dims *dims,
  * functions
  ************************************************/
 
+// store a copy of the lhs data of qp_in, returns true if it matches the last condensed lhs exactly
+static bool ocp_qp_xcond_solver_update_lhs(ocp_qp_xcond_solver_memory *mem, ocp_qp_in *qp_in)
+{
+    // no copy if reuse_constant_lhs was not set before the memory was created
+    if (mem->lhs_data == NULL)
+        return false;
+
+    bool unchanged = mem->lhs_qp_in == qp_in;
+
+    if (!ocp_qp_in_lhs_update(qp_in, mem->lhs_data))
+        unchanged = false;
+    mem->lhs_qp_in = qp_in;
+
+    return unchanged;
+}
+
+
 int ocp_qp_xcond_solve(void *config_, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *qp_in, ocp_qp_out *qp_out,
                                      void *opts_, void *mem_, void *work_)
 {
@@ -537,7 +576,17 @@ int ocp_qp_xcond_solve(void *config_, ocp_qp_xcond_solver_dims *dims, ocp_qp_in
     int solver_status = ACADOS_SUCCESS;
     // condensing
     acados_tic(&cond_timer);
-    xcond->condensing(qp_in, memory->xcond_qp_in, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+    memory->time_qp_xcond_offset = 0.0;
+    if (opts->reuse_constant_lhs && ocp_qp_xcond_solver_update_lhs(memory, qp_in))
+    {
+        // lhs of the condensed qp is still valid, condense_rhs adds to the time of the last lhs
+        xcond->memory_get(xcond, memory->xcond_memory, "time_qp_xcond", &memory->time_qp_xcond_offset);
+        xcond->condense_rhs(qp_in, memory->xcond_qp_in, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+    }
+    else
+    {
+        xcond->condensing(qp_in, memory->xcond_qp_in, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+    }
     info->condensing_time = acados_toc(&cond_timer);
 
     if (opts->initialize_next_xcond_qp_from_qp_out)
@@ -600,7 +649,10 @@ int ocp_qp_xcond_condense_lhs(void *config_, ocp_qp_xcond_solver_dims *dims, ocp
 
     // condensing
     acados_tic(&cond_timer);
+    memory->time_qp_xcond_offset = 0.0;
     xcond->condense_lhs(qp_in, memory->xcond_qp_in, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+    if (opts->reuse_constant_lhs)
+        ocp_qp_xcond_solver_update_lhs(memory, qp_in);
     info->condensing_time = acados_toc(&cond_timer);
 
     info->total_time = acados_toc(&tot_timer);
@@ -632,7 +684,14 @@ int ocp_qp_xcond_condense_rhs_and_solve(void *config_, ocp_qp_xcond_solver_dims
 
     // condensing
     acados_tic(&cond_timer);
+    memory->time_qp_xcond_offset = 0.0;
     xcond->condense_rhs(qp_in, memory->xcond_qp_in, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+
+    if (opts->initialize_next_xcond_qp_from_qp_out)
+    {
+        xcond->condense_qp_out(qp_in, memory->xcond_qp_in, qp_out, memory->xcond_qp_out, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+        opts->initialize_next_xcond_qp_from_qp_out = false;
+    }
     info->condensing_time += acados_toc(&cond_timer);
 
     // solve qp
@@ -55,6 +55,7 @@ typedef struct ocp_qp_xcond_solver_opts_
     void *xcond_opts;
     void *qp_solver_opts;
     bool initialize_next_xcond_qp_from_qp_out;
+    bool reuse_constant_lhs; // only condense the rhs if the lhs data of qp_in did not change
 } ocp_qp_xcond_solver_opts;
 
 
@@ -66,6 +67,9 @@ typedef struct ocp_qp_xcond_solver_memory_
     void *xcond_qp_in;
     void *xcond_qp_out;
     void *xcond_seed;
+    double *lhs_data; // copy of the lhs data of the last condensed qp_in
+    ocp_qp_in *lhs_qp_in; // qp_in of the last condensed lhs, NULL if invalid
+    double time_qp_xcond_offset; // condensing time of a reused lhs, not counted again
 } ocp_qp_xcond_solver_memory;
 
 
@@ -534,6 +534,42 @@ void calculate_butcher_tableau_from_nodes(int ns, double *nodes, double *b, doub
 }
 
 
+// computes weights e, such that sum_i e_i nodes_i^k = 0 for k < ns-1 and 1/ns for k = ns-1,
+// i.e. b - e is a quadrature rule of order ns-1 and step * sum_i e_i k_i is an
+// embedded estimate of the local error of the collocation step, which is O(step^ns).
+void calculate_embedded_error_weights(int ns, double *nodes, double *e, void *work)
+{
+    int i, j;
+
+    char *c_ptr = work;
+
+    // transposed vandermonde matrix
+    double *vm_tran = (double *) c_ptr;
+    c_ptr += ns * ns * sizeof(double);
+    // lu_work
+    double *lu_work = (double *) c_ptr;
+    c_ptr += ns * ns * sizeof(double);
+    // perm
+    int *perm = (int *) c_ptr;
+    c_ptr += ns * sizeof(int);
+
+    assert((char *) work + butcher_tableau_work_calculate_size(ns) >= c_ptr);
+
+    for (i = 0; i < ns; i++)
+    {
+        for (j = 0; j < ns; j++) vm_tran[j + i * ns] = pow(nodes[i], j);
+    }
+
+    for (i = 0; i < ns - 1; i++) e[i] = 0.0;
+    e[ns - 1] = 1.0 / ns;
+
+    lu_system_solve(vm_tran, e, perm, ns, 1, lu_work);
+
+    return;
+}
+
+
+
 void calculate_butcher_tableau(int ns, sim_collocation_type collocation_type, double *c_vec, double *b_vec, double *A_mat, void *work)
 {
     // compute collocation nodes
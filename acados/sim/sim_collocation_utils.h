@@ -89,6 +89,8 @@ acados_size_t butcher_tableau_work_calculate_size(int ns);
 void calculate_butcher_tableau(int ns, sim_collocation_type collocation_type, double *c_vec,
                                double *b_vec, double *A_mat, void *work);
 
+//
+void calculate_embedded_error_weights(int ns, double *nodes, double *e, void *work);
 //
 void get_explicit_butcher_tableau(int ns, double *A, double *b, double *c);
 
@@ -440,6 +440,21 @@ int sim_out_get_(void *config_, void *dims_, sim_out *out, const char *field, vo
         double *time = value;
         *time = out->info->LAtime;
     }
+    else if (!strcmp(field, "num_steps"))
+    {
+        int *num_steps = value;
+        *num_steps = out->info->num_steps;
+    }
+    else if (!strcmp(field, "num_rejected_steps"))
+    {
+        int *num_rejected_steps = value;
+        *num_rejected_steps = out->info->num_rejected_steps;
+    }
+    else if (!strcmp(field, "num_factorizations"))
+    {
+        int *num_factorizations = value;
+        *num_factorizations = out->info->num_factorizations;
+    }
     else
     {
         printf("sim_out_get_: field %s not supported \n", field);
@@ -478,6 +493,16 @@ void sim_opts_set_(sim_opts *opts, const char *field, void *value)
         bool *jac_reuse = (bool *) value;
         opts->jac_reuse = *jac_reuse;
     }
+    else if (!strcmp(field, "jac_reuse_across_calls"))
+    {
+        bool *jac_reuse_across_calls = (bool *) value;
+        opts->jac_reuse_across_calls = *jac_reuse_across_calls;
+    }
+    else if (!strcmp(field, "jac_reuse_contraction_max"))
+    {
+        double *jac_reuse_contraction_max = value;
+        opts->jac_reuse_contraction_max = *jac_reuse_contraction_max;
+    }
     else if (!strcmp(field, "cost_computation"))
     {
         bool *cost_computation = (bool *) value;
@@ -528,6 +553,26 @@ void sim_opts_set_(sim_opts *opts, const char *field, void *value)
         double *newton_tol = value;
         opts->newton_tol = *newton_tol;
     }
+    else if (!strcmp(field, "step_size_control"))
+    {
+        bool *step_size_control = (bool *) value;
+        opts->step_size_control = *step_size_control;
+    }
+    else if (!strcmp(field, "max_num_steps"))
+    {
+        int *max_num_steps = (int *) value;
+        opts->max_num_steps = *max_num_steps;
+    }
+    else if (!strcmp(field, "step_abs_tol"))
+    {
+        double *step_abs_tol = value;
+        opts->step_abs_tol = *step_abs_tol;
+    }
+    else if (!strcmp(field, "step_rel_tol"))
+    {
+        double *step_rel_tol = value;
+        opts->step_rel_tol = *step_rel_tol;
+    }
     else
     {
         printf("\nerror: field %s not available in sim_opts_set_\n", field);
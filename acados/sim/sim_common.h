@@ -95,6 +95,10 @@ typedef struct
     double LAtime;   // in seconds
     double ADtime;   // in seconds
 
+    int num_steps;           // number of integration steps used (accepted steps if adaptive)
+    int num_rejected_steps;  // number of rejected steps (only with step_size_control)
+    int num_factorizations;  // number of factorizations of the Newton matrix (IRK, GNSF)
+
 } sim_info;
 
 
@@ -131,6 +135,7 @@ typedef struct
     double *A_mat;
     double *c_vec;
     double *b_vec;
+    double *e_vec;  // weights of embedded error estimate, only used by IRK with step_size_control
 
     bool sens_forw;
     bool sens_adj;
@@ -147,10 +152,22 @@ typedef struct
     // && jac_reuse=false
     int newton_iter;
     bool jac_reuse;
+    // keep the factorization of the Newton matrix across calls (simplified Newton),
+    // refactorize if the contraction rate of the Newton steps exceeds jac_reuse_contraction_max;
+    // currently supported by IRK and GNSF, requires jac_reuse and newton_iter > 1
+    bool jac_reuse_across_calls;
+    double jac_reuse_contraction_max;
     // Newton_scheme *scheme;
 
     double newton_tol; // optinally used in implicit integrators
 
+    // adaptive step size, currently only supported by IRK:
+    // num_steps is used for the initial step size, at most max_num_steps steps are accepted
+    bool step_size_control;
+    int max_num_steps;
+    double step_abs_tol;
+    double step_rel_tol;
+
     // workspace
     void *work;
 
@@ -125,6 +125,11 @@ void sim_erk_dims_get(void *config_, void *dims_, const char *field, int *value)
     {
         *value = 0;
     }
+    else if (!strcmp(field, "n_guesses"))
+    {
+        // size of the initial guess of the integration variables, see memory_set "guesses_blasfeo"
+        *value = 0;
+    }
     else
     {
         printf("\nerror: sim_erk_dims_get: dim type not available: %s\n", field);
@@ -389,6 +394,11 @@ void sim_erk_memory_get(void *config_, void *dims_, void *mem_, const char *fiel
         double *ptr = value;
         *ptr = mem->time_la;
     }
+    else if (!strcmp(field, "num_factorizations"))
+    {
+        int *ptr = value;
+        *ptr = 0;
+    }
     else
     {
         printf("sim_erk_memory_get field %s is not supported! \n", field);
@@ -924,10 +934,223 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     mem->time_ad = out->info->ADtime;
     mem->time_la = out->info->LAtime;
 
+    out->info->num_steps = opts->num_steps;
+    out->info->num_rejected_steps = 0;
+    out->info->num_factorizations = 0;
+
+    return 0;
+}
+
+
+/************************************************
+ * lockstep batch
+ ************************************************/
+
+acados_size_t sim_erk_batch_workspace_calculate_size(void *config_, void *dims_, void *opts_, int n_batch)
+{
+    sim_opts *opts = opts_;
+    sim_erk_dims *dims = (sim_erk_dims *) dims_;
+
+    int ns = opts->ns;
+    int nx = dims->nx;
+    int nu = dims->nu;
+
+    acados_size_t size = sizeof(sim_erk_batch_workspace);
+
+    size += nx * n_batch * sizeof(double);       // x
+    size += nx * n_batch * sizeof(double);       // x_stage
+    size += ns * nx * n_batch * sizeof(double);  // K
+    size += n_batch * sizeof(double);            // step
+    size += (nx + nu) * sizeof(double);          // lane_in
+    size += nx * sizeof(double);                 // lane_out
+
+    make_int_multiple_of(8, &size);
+    size += 1 * 8;
+
+    return size;
+}
+
+
+
+static sim_erk_batch_workspace *sim_erk_batch_cast_workspace(sim_erk_dims *dims, sim_opts *opts,
+                                                             void *raw_memory, int n_batch)
+{
+    int ns = opts->ns;
+    int nx = dims->nx;
+    int nu = dims->nu;
+
+    char *c_ptr = (char *) raw_memory;
+
+    sim_erk_batch_workspace *work = (sim_erk_batch_workspace *) c_ptr;
+    c_ptr += sizeof(sim_erk_batch_workspace);
+
+    align_char_to(8, &c_ptr);
+
+    assign_and_advance_double(nx * n_batch, &work->x, &c_ptr);
+    assign_and_advance_double(nx * n_batch, &work->x_stage, &c_ptr);
+    assign_and_advance_double(ns * nx * n_batch, &work->K, &c_ptr);
+    assign_and_advance_double(n_batch, &work->step, &c_ptr);
+    assign_and_advance_double(nx + nu, &work->lane_in, &c_ptr);
+    assign_and_advance_double(nx, &work->lane_out, &c_ptr);
+
+    assert((char *) raw_memory + sim_erk_batch_workspace_calculate_size(NULL, dims, opts, n_batch) >= c_ptr);
+
+    return work;
+}
+
+
+
+/* Simulates n_batch trajectories of the same model in lockstep.
+ * All lanes share config, dims and opts; initial state, control, parameters (inside the
+ * model functions) and simulation time are taken from each lane's sim_in.
+ * The state and stage vectors are stored as structure of arrays, i.e. entry i of lane l
+ * is at [i*n_batch + l], such that the Butcher tableau updates are contiguous loops over
+ * the batch, which the compiler can vectorize for the target instruction set.
+ * Only the simulation is computed, sensitivities have to be disabled in opts. */
+int sim_erk_batch(void *config_, sim_in **in, sim_out **out, void *opts_, void *work_, int n_batch)
+{
+    acados_timer timer, timer_ad;
+    acados_tic(&timer);
+
+    sim_opts *opts = opts_;
+
+    if (n_batch <= 0)
+        return 0;
+
+    if ( opts->ns != opts->tableau_size )
+    {
+        printf("Error in sim_erk_batch: the Butcher tableau size does not match ns\n");
+        exit(1);
+    }
+    if (opts->sens_forw || opts->sens_adj || opts->sens_hess || opts->sens_algebraic)
+    {
+        printf("sim_erk_batch: sensitivities are not supported in lockstep batch mode\n");
+        exit(1);
+    }
+
+    sim_erk_dims *dims = (sim_erk_dims *) in[0]->dims;
+    if (dims->nz != 0)
+    {
+        printf("sim_erk: nz should be zero - DAEs are not supported by the ERK integrator\n");
+        exit(1);
+    }
+
+    sim_erk_batch_workspace *work = sim_erk_batch_cast_workspace(dims, opts, work_, n_batch);
+
+    int i, j, l, s, istep;
+    double a, b;
+
+    int ns = opts->ns;
+    int nx = dims->nx;
+    int nu = dims->nu;
+    int num_steps = opts->num_steps;
+
+    double *A_mat = opts->A_mat;
+    double *b_vec = opts->b_vec;
+
+    double *x = work->x;
+    double *x_stage = work->x_stage;
+    double *step = work->step;
+    double *lane_in = work->lane_in;
+    double *lane_out = work->lane_out;
+    double *K_s;
+
+    ext_fun_arg_t ext_fun_type_in[2];
+    void *ext_fun_in[2];
+    ext_fun_arg_t ext_fun_type_out[1];
+    void *ext_fun_out[1];
+
+    ext_fun_type_in[0] = COLMAJ;
+    ext_fun_in[0] = lane_in;  // x: nx
+    ext_fun_type_in[1] = COLMAJ;
+    ext_fun_in[1] = lane_in + nx;  // u: nu
+    ext_fun_type_out[0] = COLMAJ;
+    ext_fun_out[0] = lane_out;  // fun: nx
+
+    // gather initial states
+    for (l = 0; l < n_batch; l++)
+    {
+        step[l] = in[l]->T / num_steps;
+        for (i = 0; i < nx; i++)
+            x[i * n_batch + l] = in[l]->x[i];
+    }
+
+    double timing_ad = 0.0;
+
+    for (istep = 0; istep < num_steps; istep++)
+    {
+        for (s = 0; s < ns; s++)
+        {
+            for (i = 0; i < nx * n_batch; i++)
+                x_stage[i] = x[i];
+
+            for (j = 0; j < s; j++)
+            {
+                a = A_mat[j * ns + s];
+                if (a != 0)
+                {
+                    K_s = work->K + j * nx * n_batch;
+                    for (i = 0; i < nx; i++)
+                        for (l = 0; l < n_batch; l++)
+                            x_stage[i * n_batch + l] += a * step[l] * K_s[i * n_batch + l];
+                }
+            }
+
+            // ODE evaluation, each lane with its own model functions
+            K_s = work->K + s * nx * n_batch;
+            acados_tic(&timer_ad);
+            for (l = 0; l < n_batch; l++)
+            {
+                erk_model *model = in[l]->model;
+
+                for (i = 0; i < nx; i++)
+                    lane_in[i] = x_stage[i * n_batch + l];
+                for (i = 0; i < nu; i++)
+                    lane_in[nx + i] = in[l]->u[i];
+
+                model->expl_ode_fun->evaluate(model->expl_ode_fun, ext_fun_type_in, ext_fun_in,
+                                              ext_fun_type_out, ext_fun_out);
+
+                for (i = 0; i < nx; i++)
+                    K_s[i * n_batch + l] = lane_out[i];
+            }
+            timing_ad += acados_toc(&timer_ad);
+        }
+
+        for (s = 0; s < ns; s++)
+        {
+            b = b_vec[s];
+            K_s = work->K + s * nx * n_batch;
+            for (i = 0; i < nx; i++)
+                for (l = 0; l < n_batch; l++)
+                    x[i * n_batch + l] += step[l] * b * K_s[i * n_batch + l];  // ERK step
+        }
+    }
+
+    // scatter results
+    for (l = 0; l < n_batch; l++)
+    {
+        for (i = 0; i < nx; i++)
+            out[l]->xn[i] = x[i * n_batch + l];
+    }
+
+    // store timings, averaged over the batch
+    double time_tot = acados_toc(&timer);
+    for (l = 0; l < n_batch; l++)
+    {
+        out[l]->info->CPUtime = time_tot / n_batch;
+        out[l]->info->LAtime = 0.0;
+        out[l]->info->ADtime = timing_ad / n_batch;
+        out[l]->info->num_steps = num_steps;
+        out[l]->info->num_rejected_steps = 0;
+        out[l]->info->num_factorizations = 0;
+    }
+
     return 0;
 }
 
 
+
 void sim_erk_config_initialize_default(void *config_)
 {
     sim_config *config = config_;
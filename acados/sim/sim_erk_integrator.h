@@ -94,6 +94,20 @@ typedef struct
 
 
 
+typedef struct
+{
+    // lockstep batch workspace, structure of arrays: entry i of lane l at [i*n_batch + l]
+    double *x;        // nx*n_batch
+    double *x_stage;  // nx*n_batch
+    double *K;        // ns*nx*n_batch
+    double *step;     // n_batch
+    double *lane_in;  // x + u of a single lane
+    double *lane_out; // nx
+
+} sim_erk_batch_workspace;
+
+
+
 // dims
 acados_size_t sim_erk_dims_calculate_size();
 void *sim_erk_dims_assign(void *config_, void *raw_memory);
@@ -133,6 +147,10 @@ void sim_erk_set_external_fun_workspaces(void *config_, void *dims_, void *opts_
 
 //
 int sim_erk(void *config, sim_in *in, sim_out *out, void *opts_, void *mem_, void *work_);
+// lockstep simulation of n_batch trajectories, no sensitivities
+acados_size_t sim_erk_batch_workspace_calculate_size(void *config, void *dims, void *opts_, int n_batch);
+//
+int sim_erk_batch(void *config, sim_in **in, sim_out **out, void *opts_, void *work_, int n_batch);
 //
 void sim_erk_config_initialize_default(void *config);
 
@@ -158,7 +158,7 @@ void sim_gnsf_dims_get(void *config_, void *dims_, const char *field, int *value
     {
         *value = dims->nz;
     }
-    else if (!strcmp(field, "nout") || !strcmp(field, "gnsf_nout"))
+    else if (!strcmp(field, "nout") || !strcmp(field, "gnsf_nout") || !strcmp(field, "n_guesses"))
     {
         *value = dims->n_out;
     }
@@ -323,6 +323,8 @@ void sim_gnsf_opts_initialize_default(void *config_, void *dims_, void *opts_)
     opts->sens_adj = false;
     opts->sens_hess = false;
     opts->jac_reuse = true;
+    opts->jac_reuse_across_calls = false;
+    opts->jac_reuse_contraction_max = 0.5;
     opts->exact_z_output = false;
     opts->ns = 3;
     opts->collocation_type = GAUSS_LEGENDRE;
@@ -1220,6 +1222,12 @@ acados_size_t sim_gnsf_memory_calculate_size(void *config, void *dims_, void *op
 
     size += nK2 * sizeof(int);      // ipivM2
 
+    if (opts->jac_reuse_across_calls)
+    {
+        size += nvv * sizeof(int);  // ipiv_fact
+        size += blasfeo_memsize_dmat(nvv, nvv);  // J_r_vv_fact
+    }
+
     if (opts->sens_algebraic)
     {
         size += nxz2 * sizeof(int); // ipiv_ELO
@@ -1328,6 +1336,10 @@ void *sim_gnsf_memory_assign(void *config, void *dims_, void *opts_, void *raw_m
     //     assign_and_advance_int(nxz2, &mem->ipiv_ELO, &c_ptr);
     // }
     assign_and_advance_int(nK2, &mem->ipivM2, &c_ptr);
+    if (opts->jac_reuse_across_calls)
+    {
+        assign_and_advance_int(nvv, &mem->ipiv_fact, &c_ptr);
+    }
     align_char_to(8, &c_ptr);
 
     // assign doubles
@@ -1392,6 +1404,13 @@ void *sim_gnsf_memory_assign(void *config, void *dims_, void *opts_, void *raw_m
     assign_and_advance_blasfeo_dmat_mem(nx, nx + nu, &mem->S_forw, &c_ptr);
     assign_and_advance_blasfeo_dmat_mem(nz, nx + nu, &mem->S_algebraic, &c_ptr);
 
+    if (opts->jac_reuse_across_calls)
+    {
+        assign_and_advance_blasfeo_dmat_mem(nvv, nvv, &mem->J_r_vv_fact, &c_ptr);
+    }
+    mem->jac_fact_available = false;
+    mem->num_factorizations = 0;
+
     // if (opts->sens_algebraic){
     //     // for algebraic sensitivity propagation
     //     assign_and_advance_blasfeo_dmat_mem(ny, nx1, mem->Lx, &c_ptr);
@@ -1495,6 +1514,16 @@ void sim_gnsf_memory_get(void *config_, void *dims_, void *mem_, const char *fie
         double *ptr = value;
         *ptr = mem->time_la;
     }
+    else if (!strcmp(field, "num_factorizations"))
+    {
+        int *ptr = value;
+        *ptr = mem->num_factorizations;
+    }
+    else if (!strcmp(field, "guesses_blasfeo"))
+    {
+        sim_gnsf_dims *dims = dims_;
+        blasfeo_pack_dvec(dims->n_out, mem->phi_guess, 1, value, 0);
+    }
     else
     {
         printf("sim_gnsf_memory_get field %s is not supported! \n", field);
@@ -2314,6 +2343,13 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
 
     double tmp_double;
 
+    // simplified Newton across calls: J_r_vv holds the factorization of a previous call
+    bool update_jac;
+    bool jac_from_mem = false;
+    bool refactorize = false;
+    double newton_step_nrm, newton_step_nrm_prev = 0.0;
+    int num_factorizations = 0;
+
     // ONLY available for algebraic sensitivity propagation
     // struct blasfeo_dmat *Z0x = mem->Z0x;
     // struct blasfeo_dmat *Z0u = mem->Z0u;
@@ -2527,15 +2563,31 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                 blasfeo_dgemv_n(nyy, nx1, 1.0, YYx, 0, 0, x0_traj, ss*nx, 1.0, yyu, 0, yyss, nyy*ss);
 
                 y_in.x = &yy_traj[ss];
+
+                // start from the factorization of a previous call
+                jac_from_mem = false;
+                refactorize = false;
+                if (ss == 0 && opts->jac_reuse_across_calls && opts->jac_reuse && newton_iter > 1
+                    && mem->jac_fact_available)
+                {
+                    blasfeo_dgecp(nvv, nvv, &mem->J_r_vv_fact, 0, 0, J_r_vv, 0, 0);
+                    for (int ii = 0; ii < nvv; ii++)
+                        ipiv[ii] = mem->ipiv_fact[ii];
+                    jac_from_mem = true;
+                }
+
                 for (int iter = 0; iter < newton_iter; iter++)
                 {  // NEWTON-ITERATION
+                    update_jac = !opts->jac_reuse || refactorize ||
+                                 (ss == 0 && iter == 0 && !jac_from_mem);
+
                     /* EVALUATE RESIDUAL FUNCTION & JACOBIAN */
 
                     blasfeo_dgemv_n(nyy, nvv, 1.0, YYv, 0, 0, &vv_traj[ss], 0, 1.0, yyss, nyy * ss,
                                     &yy_traj[ss], 0);
                     // printf("yy =  \n");
                     // blasfeo_print_exp_dvec(nyy, &yy_traj[ss], 0);
-                    if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+                    if (update_jac)
                     {
                         // set J_r_vv to unit matrix
                         blasfeo_dgese(nvv, nvv, 0.0, J_r_vv, 0, 0);
@@ -2550,7 +2602,7 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                         y_in.xi = ii * ny;
                         phi_fun_val_arg.xi = ii * n_out;
                         phi_jac_y_arg.ai = ii * n_out;
-                        if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+                        if (update_jac)
                         {
                             // evaluate
                             acados_tic(&casadi_timer);
@@ -2581,9 +2633,12 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                             // this is the actual value of the residual function!
                     acados_tic(&la_timer);
                     // factorize J_r_vv
-                    if ((opts->jac_reuse && (ss == 0) & (iter == 0)) || (!opts->jac_reuse))
+                    if (update_jac)
                     {
                         blasfeo_dgetrf_rp(nvv, nvv, J_r_vv, 0, 0, J_r_vv, 0, 0, ipiv);
+                        num_factorizations++;
+                        jac_from_mem = false;
+                        refactorize = false;
                     }
 
                     /* Solve linear system and update vv */
@@ -2594,6 +2649,15 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
 
                     blasfeo_daxpy(nvv, -1.0, res_val, 0, &vv_traj[ss], 0, &vv_traj[ss], 0);
 
+                    // monitor contraction of the simplified Newton iterations
+                    if (jac_from_mem)
+                    {
+                        blasfeo_dvecnrm_inf(nvv, res_val, 0, &newton_step_nrm);
+                        if (iter > 0 && !(newton_step_nrm <= opts->jac_reuse_contraction_max * newton_step_nrm_prev))
+                            refactorize = true;
+                        newton_step_nrm_prev = newton_step_nrm;
+                    }
+
                     // check early termination based on tolerance
                     if (opts->newton_tol > 0)
                     {
@@ -2603,8 +2667,34 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                             break;
                         }
                     }
+
+                    // contraction too slow in the last iteration: the result of the factorization of a
+                    // previous call is not accepted, redo the Newton iterations with a fresh factorization
+                    if (refactorize && iter == newton_iter - 1)
+                    {
+                        jac_from_mem = false;
+                        iter = -1;
+                    }
                 }  // END NEWTON-ITERATION
 
+                // keep the factorization of J_r_vv for the next call,
+                // with forward sensitivities the exact one at the solution is stored below
+                if (ss == 0 && opts->jac_reuse_across_calls && !opts->sens_forw)
+                {
+                    if (refactorize)
+                    {
+                        // converged, but with too slow contraction, refactorize in the next call
+                        mem->jac_fact_available = false;
+                    }
+                    else if (!jac_from_mem)
+                    {
+                        blasfeo_dgecp(nvv, nvv, J_r_vv, 0, 0, &mem->J_r_vv_fact, 0, 0);
+                        for (int ii = 0; ii < nvv; ii++)
+                            mem->ipiv_fact[ii] = ipiv[ii];
+                        mem->jac_fact_available = true;
+                    }
+                }
+
                 // compute K1 and Z values
                 blasfeo_dgemv_n(nK1, nvv, 1.0, KKv, 0, 0, &vv_traj[ss], 0, 1.0, K1u, 0, K1_val,
                                 0);  // K1u contains KKu * u0 + KK0;
@@ -2734,6 +2824,14 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                     acados_tic(&la_timer);
                     blasfeo_dgetrf_rp(nvv, nvv, J_r_vv, 0, 0, J_r_vv, 0, 0,
                                             ipiv);        // factorize J_r_vv
+                    num_factorizations++;
+                    if (ss == 0 && opts->jac_reuse_across_calls)
+                    {
+                        blasfeo_dgecp(nvv, nvv, J_r_vv, 0, 0, &mem->J_r_vv_fact, 0, 0);
+                        for (int ii = 0; ii < nvv; ii++)
+                            mem->ipiv_fact[ii] = ipiv[ii];
+                        mem->jac_fact_available = true;
+                    }
                     // printf("dPHI_dyuhat = (forward, ss = %d) \n", ss);
                     // blasfeo_print_exp_dmat(nvv, ny+nuhat, dPHI_dyuhat, 0, 0);
 
@@ -2989,6 +3087,7 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                     acados_tic(&la_timer);
                     blasfeo_dgetrf_rp(nvv, nvv, J_r_vv, 0, 0, J_r_vv, 0, 0,
                                             ipiv);  // factorize J_r_vv
+                    num_factorizations++;
                     out->info->LAtime += acados_toc(&la_timer);
 
                     blasfeo_dgemv_t(nx, nvv, 1.0, dPsi_dvv, 0, 0, lambda, 0, 0.0, res_val, 0, res_val,
@@ -3052,6 +3151,11 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
     mem->time_ad = out->info->ADtime;
     mem->time_la = out->info->LAtime;
 
+    out->info->num_steps = opts->num_steps;
+    out->info->num_rejected_steps = 0;
+    out->info->num_factorizations = num_factorizations;
+    mem->num_factorizations = num_factorizations;
+
     return ACADOS_SUCCESS;
 }
 
@@ -312,6 +312,13 @@ typedef struct
     double time_ad;
     double time_la;
 
+    int num_factorizations;  // factorizations of J_r_vv in the last call
+
+    // only allocated if (opts->jac_reuse_across_calls)
+    struct blasfeo_dmat J_r_vv_fact;  // LU factors of J_r_vv kept across calls (nvv, nvv)
+    int *ipiv_fact;                   // corresponding pivot vector (nvv)
+    bool jac_fact_available;          // J_r_vv_fact holds a factorization from a previous call
+
 } sim_gnsf_memory;
 
 
@@ -50,6 +50,14 @@
 #include "blasfeo_common.h"
 
 
+// step size control
+#define IRK_STEP_SAFETY 0.9
+#define IRK_STEP_FAC_MIN 0.2
+#define IRK_STEP_FAC_MAX 5.0
+#define IRK_STEP_MIN_REL 1e-10  // minimum step size relative to T
+#define IRK_STEP_MAX_REJECT 20  // maximum number of consecutive rejections of a step
+
+
 /************************************************
  * dims
  ************************************************/
@@ -133,6 +141,11 @@ void sim_irk_dims_get(void *config_, void *dims_, const char *field, int *value)
     {
         *value = dims->nz;
     }
+    else if (!strcmp(field, "n_guesses"))
+    {
+        // size of the initial guess of the integration variables, see memory_set "guesses_blasfeo"
+        *value = dims->nx + dims->nz;
+    }
     else
     {
         printf("\nerror: sim_irk_dims_get: field not available: %s\n", field);
@@ -248,6 +261,7 @@ acados_size_t sim_irk_opts_calculate_size(void *config_, void *dims)
     size += ns_max * ns_max * sizeof(double);  // A_mat
     size += ns_max * sizeof(double);           // b_vec
     size += ns_max * sizeof(double);           // c_vec
+    size += ns_max * sizeof(double);           // e_vec
 
     size += butcher_tableau_work_calculate_size(ns_max);
 
@@ -275,6 +289,7 @@ void *sim_irk_opts_assign(void *config_, void *dims, void *raw_memory)
     assign_and_advance_double(ns_max * ns_max, &opts->A_mat, &c_ptr);
     assign_and_advance_double(ns_max, &opts->b_vec, &c_ptr);
     assign_and_advance_double(ns_max, &opts->c_vec, &c_ptr);
+    assign_and_advance_double(ns_max, &opts->e_vec, &c_ptr);
 
     assert((char *) raw_memory + sim_irk_opts_calculate_size(config_, dims) >= c_ptr);
 
@@ -297,15 +312,23 @@ void sim_irk_opts_initialize_default(void *config_, void *dims_, void *opts_)
     opts->sens_adj = false;
     opts->sens_hess = false;
     opts->jac_reuse = true;
+    opts->jac_reuse_across_calls = false;
+    opts->jac_reuse_contraction_max = 0.5;
     opts->exact_z_output = false;
     opts->ns = 3;
     opts->collocation_type = GAUSS_LEGENDRE;
     opts->newton_tol = 0.0;
 
+    opts->step_size_control = false;
+    opts->max_num_steps = 50;
+    opts->step_abs_tol = 1e-6;
+    opts->step_rel_tol = 1e-6;
+
     assert(opts->ns <= NS_MAX && "ns > NS_MAX!");
 
     // butcher tableau
     calculate_butcher_tableau(opts->ns, opts->collocation_type, opts->c_vec, opts->b_vec, opts->A_mat, opts->work);
+    calculate_embedded_error_weights(opts->ns, opts->c_vec, opts->e_vec, opts->work);
     // for consistency check
     opts->tableau_size = opts->ns;
     opts->cost_computation = false;
@@ -334,6 +357,9 @@ void sim_irk_opts_update(void *config_, void *dims, void *opts_)
     assert(opts->ns <= NS_MAX && "ns > NS_MAX!");
 
     calculate_butcher_tableau(opts->ns, opts->collocation_type, opts->c_vec, opts->b_vec, opts->A_mat, opts->work);
+    // embedded error estimate requires distinct nodes, i.e. a collocation method
+    if (opts->collocation_type != EXPLICIT_RUNGE_KUTTA)
+        calculate_embedded_error_weights(opts->ns, opts->c_vec, opts->e_vec, opts->work);
 
     opts->tableau_size = opts->ns;
 
@@ -388,6 +414,8 @@ acados_size_t sim_irk_memory_calculate_size(void *config, void *dims_, void *opt
     int nz = dims->nz;
     int nu = dims->nu;
 
+    int nK = (nx + nz) * opts->ns;
+
     acados_size_t size = sizeof(sim_irk_memory);
 
     size += nx * sizeof(double); // xdot
@@ -400,6 +428,13 @@ acados_size_t sim_irk_memory_calculate_size(void *config, void *dims_, void *opt
         size += 1 * blasfeo_memsize_dmat(nx+nu, nx+nu);  // cost_hess
     }
 
+    if (opts->jac_reuse_across_calls)
+    {
+        size += nK * sizeof(int);  // ipiv_fact
+        size += blasfeo_memsize_dmat(nK, nK);  // dG_dK_fact
+        size += 64;  // corresponds to memory alignment
+    }
+
     make_int_multiple_of(8, &size);
 
     return size;
@@ -439,12 +474,27 @@ void *sim_irk_memory_assign(void *config, void *dims_, void *opts_, void *raw_me
         assign_and_advance_blasfeo_dmat_mem(nx+nu, nx+nu, mem->cost_hess, &c_ptr);
     }
 
+    if (opts->jac_reuse_across_calls)
+    {
+        int nK = (nx + nz) * opts->ns;
+        assign_and_advance_int(nK, &mem->ipiv_fact, &c_ptr);
+        align_char_to(64, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nK, nK, &mem->dG_dK_fact, &c_ptr);
+    }
+
     // initialization of xdot, z is 0 if not changed
     for (int ii = 0; ii < nx; ii++)
         mem->xdot[ii] = 0.0;
     for (int ii = 0; ii < nz; ii++)
         mem->z[ii] = 0.0;
 
+    // no previous step size, use T / num_steps
+    mem->step_prev = 0.0;
+
+    // no factorization available from a previous call
+    mem->step_fact = 0.0;
+    mem->num_factorizations = 0;
+
     return mem;
 }
 
@@ -569,11 +619,27 @@ void sim_irk_memory_get(void *config_, void *dims_, void *mem_, const char *fiel
         double *ptr = value;
         *ptr = mem->time_la;
     }
+    else if (!strcmp(field, "num_factorizations"))
+    {
+        int *ptr = value;
+        *ptr = mem->num_factorizations;
+    }
     else if (!strcmp(field, "cost_hess"))
     {
         struct blasfeo_dmat **ptr = value;
         *ptr = mem->cost_hess;
     }
+    else if (!strcmp(field, "guesses_blasfeo"))
+    {
+        sim_config *config = config_;
+        int nx, nz;
+        config->dims_get(config_, dims_, "nx", &nx);
+        config->dims_get(config_, dims_, "nz", &nz);
+
+        struct blasfeo_dvec *sim_guess = value;
+        blasfeo_pack_dvec(nx, mem->xdot, 1, sim_guess, 0);
+        blasfeo_pack_dvec(nz, mem->z, 1, sim_guess, nx);
+    }
     else
     {
         printf("sim_irk_memory_get field %s is not supported! \n", field);
@@ -601,10 +667,13 @@ acados_size_t sim_irk_workspace_calculate_size(void *config_, void *dims_, void
 
     int nK = (nx + nz) * ns;
 
-    int steps = opts->num_steps;
+    // maximum number of steps to store intermediate results for
+    int steps = opts->step_size_control ? opts->max_num_steps : opts->num_steps;
 
     acados_size_t size = sizeof(sim_irk_workspace);
 
+    size += 2 * steps * sizeof(double);     // step_traj, t_traj
+
     if (opts->sens_algebraic || opts->output_z)
     {
         size += (nx + nz) * sizeof(int);    // ipiv_one_stage
@@ -659,6 +728,13 @@ acados_size_t sim_irk_workspace_calculate_size(void *config_, void *dims_, void
     size += 1 * blasfeo_memsize_dvec(nx + nu);      // lambda
     size += 1 * blasfeo_memsize_dvec(nK);           // lambdaK
 
+    if (opts->step_size_control)
+    {
+        size += 2 * sizeof(struct blasfeo_dvec);  // K_init, err
+        size += blasfeo_memsize_dvec(nK);         // K_init
+        size += blasfeo_memsize_dvec(nx);         // err
+    }
+
     if (!opts->sens_hess){
         size += 1 * blasfeo_memsize_dmat(nK, nx + nu);  // dG_dxu
         size += 1 * blasfeo_memsize_dmat(nK, nK);       // dG_dK
@@ -714,7 +790,7 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
     int ny = dims->ny;
     int nK = (nx + nz) * ns;
 
-    int steps = opts->num_steps;
+    int steps = opts->step_size_control ? opts->max_num_steps : opts->num_steps;
 
     char *c_ptr = (char *) raw_memory;
 
@@ -733,6 +809,11 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
     assign_and_advance_blasfeo_dvec_structs(1, &workspace->K, &c_ptr);
     assign_and_advance_blasfeo_dvec_structs(1, &workspace->lambda, &c_ptr);
     assign_and_advance_blasfeo_dvec_structs(1, &workspace->lambdaK, &c_ptr);
+    if (opts->step_size_control)
+    {
+        assign_and_advance_blasfeo_dvec_structs(1, &workspace->K_init, &c_ptr);
+        assign_and_advance_blasfeo_dvec_structs(1, &workspace->err, &c_ptr);
+    }
 
     // dG_dxu, dG_dK, dK_dxu, S_forw
     if (!opts->sens_hess){
@@ -828,6 +909,11 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
     assign_and_advance_blasfeo_dvec_mem(nx, &workspace->xtdot, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nx + nu, workspace->lambda, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nK, workspace->lambdaK, &c_ptr);
+    if (opts->step_size_control)
+    {
+        assign_and_advance_blasfeo_dvec_mem(nK, workspace->K_init, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nx, workspace->err, &c_ptr);
+    }
 
 
     if ( opts->sens_adj || opts->sens_hess ){
@@ -838,6 +924,9 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
         }
     }
 
+    assign_and_advance_double(steps, &workspace->step_traj, &c_ptr);
+    assign_and_advance_double(steps, &workspace->t_traj, &c_ptr);
+
     if (opts->sens_algebraic || opts->output_z){
         assign_and_advance_double(ns, &workspace->Z_work, &c_ptr);
         assign_and_advance_int((nx + nz), &workspace->ipiv_one_stage, &c_ptr);
@@ -1163,9 +1252,53 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     int newton_iter = opts->newton_iter;
     double *A_mat = opts->A_mat;
     double *b_vec = opts->b_vec;
+    double *e_vec = opts->e_vec;
     int num_steps = opts->num_steps;
     double step = in->T / num_steps;
 
+    // step size control
+    int max_steps = opts->step_size_control ? opts->max_num_steps : num_steps;
+    double t_end = t0 + in->T;
+    double t_ss = t0;  // start time of current step
+    double step_frac = 1.0 / num_steps;  // fraction of T covered by current step
+    double step_jac = step;  // step size corresponding to current dG_dK_ss
+    double step_next = step;
+    double err_nrm, sc;
+    double fac = 1.0;
+    bool update_jac;
+    // simplified Newton across calls: dG_dK_ss holds the factorization of a previous call
+    bool jac_from_mem = false;
+    bool refactorize = false;
+    double newton_step_nrm, newton_step_nrm_prev = 0.0;
+    int num_factorizations = 0;
+    bool last_step = false;
+    bool prev_rejected = false;
+    int num_rejected = 0;
+    int num_rejected_step = 0;  // consecutive rejections of the current step
+    int status = ACADOS_SUCCESS;
+
+    double *step_traj = workspace->step_traj;
+    double *t_traj = workspace->t_traj;
+    struct blasfeo_dvec *K_init = workspace->K_init;
+    struct blasfeo_dvec *err = workspace->err;
+
+    if (opts->step_size_control)
+    {
+        if (ns < 2 || opts->collocation_type == EXPLICIT_RUNGE_KUTTA)
+        {
+            printf("\nerror: sim_irk: step_size_control requires a collocation method with ns >= 2.\n");
+            exit(1);
+        }
+        if (opts->max_num_steps < 1)
+        {
+            printf("\nerror: sim_irk: max_num_steps must be positive, got %d.\n", opts->max_num_steps);
+            exit(1);
+        }
+        // warm start with step size proposed in the last call
+        if (mem->step_prev > 0.0)
+            step = fmin(mem->step_prev, in->T);
+    }
+
     int *ipiv = workspace->ipiv;
 
     struct blasfeo_dmat *dG_dK = workspace->dG_dK;
@@ -1351,8 +1484,24 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     impl_ode_z_in.x = K;
 
     // start the loop
-    for (int ss = 0; ss < num_steps; ss++)
+    for (int ss = 0; ss < max_steps; ss++)
     {
+        if (opts->step_size_control)
+        {
+            // clip the step to the end of the interval, avoid tiny last steps;
+            // the last step that can be stored covers the remaining interval.
+            last_step = (1.01 * step >= t_end - t_ss) || (ss == max_steps - 1);
+            if (last_step)
+                step = t_end - t_ss;
+            step_frac = step / in->T;
+            // initial guess for retrying the step if it is rejected
+            blasfeo_dveccp(nK, K, 0, K_init, 0);
+        }
+        else
+        {
+            t_ss = t0 + ss * step;
+            last_step = (ss == num_steps - 1);
+        }
 
         // decide whether results from forward sensitivity propagation are stored,
         // or if memory has to be reused --> set pointers accordingly
@@ -1386,9 +1535,25 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
         if ( opts->sens_adj || opts->sens_hess )  // store current xn
             blasfeo_dveccp(nx, xn, 0, &xn_traj[ss], 0);
 
+        // start from the factorization of a previous call, if it corresponds to the current step size
+        jac_from_mem = false;
+        refactorize = false;
+        if (ss == 0 && opts->jac_reuse_across_calls && opts->jac_reuse && newton_iter > 1
+            && mem->step_fact == step)
+        {
+            blasfeo_dgecp(nK, nK, &mem->dG_dK_fact, 0, 0, dG_dK_ss, 0, 0);
+            for (int ii = 0; ii < nK; ii++)
+                ipiv_ss[ii] = mem->ipiv_fact[ii];
+            step_jac = step;
+            jac_from_mem = true;
+        }
+
         for (int iter = 0; iter < newton_iter; iter++)
         {
-            if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+            // reuse jacobian only if it corresponds to the current step size
+            update_jac = !opts->jac_reuse || refactorize ||
+                         (iter == 0 && ((ss == 0 && !jac_from_mem) || step != step_jac));
+            if (update_jac)
             {
                 // if new jacobian gets computed, initialize dG_dK_ss with zeros
                 blasfeo_dgese(nK, nK, 0.0, dG_dK_ss, 0, 0);
@@ -1398,7 +1563,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             {  // ii-th row of tableau
                 // take x(n); copy a strvec into a strvec
                 blasfeo_dveccp(nx, xn, 0, xt, 0);
-                t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                t_current = t_ss + opts->c_vec[ii] * step;
 
                 for (int jj = 0; jj < ns; jj++)
                 {  // jj-th col of tableau
@@ -1413,7 +1578,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 impl_ode_res_out.xi = ii * (nx + nz);  // store output in this position of rG
 
                 // compute the residual of implicit ode at time t_ii
-                if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+                if (update_jac)
                 {   // evaluate the ode function & jacobian w.r.t. x, xdot;
                     // &  compute jacobian dG_dK_ss;
                     acados_tic(&timer_ad);
@@ -1452,9 +1617,13 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             // using partial pivoting with row interchanges.
             // printf("dG_dK_ss = (IRK) \n");
             // blasfeo_print_exp_dmat((nz+nx) *ns, (nz+nx) *ns, dG_dK_ss, 0, 0);
-            if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+            if (update_jac)
             {
                 blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
+                step_jac = step;
+                num_factorizations++;
+                jac_from_mem = false;
+                refactorize = false;
             }
 
             // permute also the r.h.s
@@ -1474,6 +1643,15 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             // [DeltaK, DeltaZ]
             blasfeo_daxpy(nK, -1.0, rG, 0, K, 0, K, 0);
 
+            // monitor contraction of the simplified Newton iterations
+            if (jac_from_mem)
+            {
+                blasfeo_dvecnrm_inf(nK, rG, 0, &newton_step_nrm);
+                if (iter > 0 && !(newton_step_nrm <= opts->jac_reuse_contraction_max * newton_step_nrm_prev))
+                    refactorize = true;
+                newton_step_nrm_prev = newton_step_nrm;
+            }
+
             // check early termination based on tolerance
             if (opts->newton_tol > 0)
             {
@@ -1483,8 +1661,102 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     break;
                 }
             }
+
+            // contraction too slow in the last iteration: the result of the factorization of a
+            // previous call is not accepted, redo the Newton iterations with a fresh factorization
+            if (refactorize && iter == newton_iter - 1)
+            {
+                jac_from_mem = false;
+                iter = -1;
+            }
         } // end newton_iter
 
+        // keep the Newton matrix factorization for the next call,
+        // with sensitivities the exact one at the solution is stored below
+        if (ss == 0 && opts->jac_reuse_across_calls && !(opts->sens_forw || opts->sens_hess))
+        {
+            if (refactorize)
+            {
+                // converged, but with too slow contraction, refactorize in the next call
+                mem->step_fact = 0.0;
+            }
+            else if (!jac_from_mem)
+            {
+                blasfeo_dgecp(nK, nK, dG_dK_ss, 0, 0, &mem->dG_dK_fact, 0, 0);
+                for (int ii = 0; ii < nK; ii++)
+                    mem->ipiv_fact[ii] = ipiv_ss[ii];
+                mem->step_fact = step_jac;
+            }
+        }
+
+        if (opts->step_size_control)
+        {
+            // embedded error estimate err = step * sum_i e_i k_i,
+            // scaled with tolerances w.r.t. x(n) and x(n+1) (stored in xt)
+            blasfeo_dveccp(nx, xn, 0, xt, 0);
+            blasfeo_dvecse(nx, 0.0, err, 0);
+            for (int ii = 0; ii < ns; ii++)
+            {
+                blasfeo_daxpy(nx, step * b_vec[ii], K, ii * nx, xt, 0, xt, 0);
+                blasfeo_daxpy(nx, step * e_vec[ii], K, ii * nx, err, 0, err, 0);
+            }
+            err_nrm = 0.0;
+            for (int ii = 0; ii < nx; ii++)
+            {
+                sc = opts->step_abs_tol + opts->step_rel_tol *
+                     fmax(fabs(BLASFEO_DVECEL(xn, ii)), fabs(BLASFEO_DVECEL(xt, ii)));
+                a = BLASFEO_DVECEL(err, ii) / sc;
+                err_nrm += a * a;
+            }
+            err_nrm = sqrt(err_nrm / nx);
+
+            // the estimated error is O(step^ns); a NaN error, e.g. from a diverging Newton method,
+            // results in the minimum factor, only a zero error in the maximum one
+            if (isnan(err_nrm))
+                fac = IRK_STEP_FAC_MIN;
+            else if (err_nrm == 0.0)
+                fac = IRK_STEP_FAC_MAX;
+            else
+                fac = IRK_STEP_SAFETY * pow(err_nrm, -1.0 / ns);
+            fac = fmin(IRK_STEP_FAC_MAX, fmax(IRK_STEP_FAC_MIN, fac));
+
+            if (!(err_nrm <= 1.0))
+            {
+                if (ss == max_steps - 1)
+                {
+                    // no more steps can be stored, accept
+                    status = isnan(err_nrm) ? ACADOS_NAN_DETECTED : ACADOS_MAXITER;
+                }
+                else if (fac * step < IRK_STEP_MIN_REL * in->T || num_rejected_step >= IRK_STEP_MAX_REJECT)
+                {
+                    status = isnan(err_nrm) ? ACADOS_NAN_DETECTED : ACADOS_MINSTEP;
+                }
+                else
+                {
+                    // reject: retry step ss with reduced step size
+                    num_rejected++;
+                    num_rejected_step++;
+                    prev_rejected = true;
+                    step *= fac;
+                    blasfeo_dveccp(nK, K_init, 0, K, 0);
+                    ss--;
+                    continue;
+                }
+            }
+
+            // no step size increase directly after a rejection
+            if (prev_rejected && fac > 1.0)
+                fac = 1.0;
+            prev_rejected = false;
+            num_rejected_step = 0;
+            step_next = fac * step;
+            // the clipped last step is not representative, unless it is the only one
+            if (!last_step || ss == 0)
+                mem->step_prev = step_next;
+        }
+        step_traj[ss] = step;
+        t_traj[ss] = t_ss;
+
         if ( opts->sens_adj || opts->sens_hess )
         {
             blasfeo_dveccp(nK, K, 0, &K_traj[ss], 0);
@@ -1509,7 +1781,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     // xt = xt + T_int * a[i,j]*K_j
                     blasfeo_daxpy(nx, a, K, jj * nx, xt, 0, xt, 0);
                 }
-                t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                t_current = t_ss + opts->c_vec[ii] * step;
 
                 acados_tic(&timer_ad);
                 model->impl_ode_jac_x_xdot_u_z->evaluate(
@@ -1539,6 +1811,15 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             // factorize dG_dK_ss
             acados_tic(&timer_la);
             blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
+            step_jac = step;
+            num_factorizations++;
+            if (ss == 0 && opts->jac_reuse_across_calls)
+            {
+                blasfeo_dgecp(nK, nK, dG_dK_ss, 0, 0, &mem->dG_dK_fact, 0, 0);
+                for (int ii = 0; ii < nK; ii++)
+                    mem->ipiv_fact[ii] = ipiv_ss[ii];
+                mem->step_fact = step;
+            }
             timing_la += acados_toc(&timer_la);
 
             // obtain dK_dxu
@@ -1596,7 +1877,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 {
                     impl_ode_z_in.xi = ns * nx + ii * nz;
 
-                    t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                    t_current = t_ss + opts->c_vec[ii] * step;
                     // compute x at stage (xt) and sensitivity (S_forw_stage)
                     blasfeo_dveccp(nx, xn, 0, xt, 0);
                     blasfeo_dgecp(nx, nx+nu, S_forw_ss, 0, 0, S_forw_stage, 0, 0);
@@ -1651,17 +1932,17 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     }
 
                     // cost_grad += b * tmp_ny^T * tmp_ny_nux = b * tmp_ny_nux^T * tmp_ny
-                    blasfeo_dgemv_n(nx+nu, ny, cost_scaling * b_vec[ii]/num_steps, tmp_nux_ny2, 0, 0, tmp_ny, 0,
+                    blasfeo_dgemv_n(nx+nu, ny, cost_scaling * b_vec[ii] * step_frac, tmp_nux_ny2, 0, 0, tmp_ny, 0,
                                     1.0, cost_grad, 0, cost_grad, 0);
 
                     // cost_hess += b * tmp_nux_ny_2 * tmp_nux_ny_2^T
                     // TODO: use syrk (exploit symmetry)
-                    blasfeo_dgemm_nt(nx+nu, nx+nu, ny, b_vec[ii]/num_steps, tmp_nux_ny2, 0, 0, tmp_nux_ny2, 0, 0,
+                    blasfeo_dgemm_nt(nx+nu, nx+nu, ny, b_vec[ii] * step_frac, tmp_nux_ny2, 0, 0, tmp_nux_ny2, 0, 0,
                                     1.0, cost_hess, 0, 0, cost_hess, 0, 0);
 
                     // cost function value
                     // NOTE: slack contribution and scaling done in cost module
-                    mem->cost_fun[0] += 0.5 * b_vec[ii]/num_steps * blasfeo_ddot(ny, tmp_ny, 0, tmp_ny, 0);
+                    mem->cost_fun[0] += 0.5 * b_vec[ii] * step_frac * blasfeo_ddot(ny, tmp_ny, 0, tmp_ny, 0);
                 } // end ii
             } // end cost propagation NLS COST
             else if (opts->cost_computation && opts->cost_type == CONVEX_OVER_NONLINEAR)
@@ -1703,7 +1984,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 {
                     impl_ode_z_in.xi = ns * nx + ii * nz;
 
-                    t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                    t_current = t_ss + opts->c_vec[ii] * step;
                     // compute x at stage (xt) and sensitivity (S_forw_stage)
                     blasfeo_dveccp(nx, xn, 0, xt, 0);
                     blasfeo_dgecp(nx, nx+nu, S_forw_ss, 0, 0, S_forw_stage, 0, 0);
@@ -1741,7 +2022,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                         //         &workspace->Jt_z, 0, 0, 1.0, &workspace->tmp_nux_ny, 0, 0, &Jt_ux_tilde, 0, 0);
 
                         // // cost_grad += b * Jt_ux_tilde * tmp_ny
-                        // blasfeo_dgemv_n(nu+nx, ny, cost_scaling * b_vec[ii]/num_steps, &Jt_ux_tilde, 0, 0, tmp_ny, 0,
+                        // blasfeo_dgemv_n(nu+nx, ny, cost_scaling * b_vec[ii] * step_frac, &Jt_ux_tilde, 0, 0, tmp_ny, 0,
                         //                 1.0, cost_grad, 0, cost_grad, 0);
 
                         // // tmp_nv_ny = Jt_ux_tilde * W_chol
@@ -1779,15 +2060,15 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                         }
 
                         // cost_grad += b * J_y_tilde^T * tmp_ny
-                        blasfeo_dgemv_t(ny, nx+nu, cost_scaling * b_vec[ii]/num_steps, J_y_tilde, 0, 0, tmp_ny, 0,
+                        blasfeo_dgemv_t(ny, nx+nu, cost_scaling * b_vec[ii] * step_frac, J_y_tilde, 0, 0, tmp_ny, 0,
                                         1.0, cost_grad, 0, cost_grad, 0);
                     }
                     // cost_hess += b * tmp_nux_ny2 * tmp_nux_ny2^T
-                    blasfeo_dsyrk_ln(nu+nx, ny, b_vec[ii]/num_steps, tmp_nux_ny2, 0, 0, tmp_nux_ny2, 0, 0,
+                    blasfeo_dsyrk_ln(nu+nx, ny, b_vec[ii] * step_frac, tmp_nux_ny2, 0, 0, tmp_nux_ny2, 0, 0,
                             1.0, cost_hess, 0, 0, cost_hess, 0, 0);
                     // cost function value
                     // NOTE: slack contribution and scaling done in cost module
-                    mem->cost_fun[0] += b_vec[ii]/num_steps * a;
+                    mem->cost_fun[0] += b_vec[ii] * step_frac * a;
                 }
             }
 
@@ -1822,7 +2103,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             {
                 impl_ode_z_in.xi = ns * nx + ii * nz;
 
-                t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                t_current = t_ss + opts->c_vec[ii] * step;
                 // compute x at stage (xt)
                 blasfeo_dveccp(nx, xn, 0, xt, 0);
                 for (int jj = 0; jj < ns; jj++)
@@ -1850,7 +2131,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
 
                 // cost function value
                 // NOTE: slack contribution and scaling done in cost module
-                mem->cost_fun[0] += 0.5 * b_vec[ii]/num_steps * blasfeo_ddot(ny, tmp_ny, 0, tmp_ny, 0);
+                mem->cost_fun[0] += 0.5 * b_vec[ii] * step_frac * blasfeo_ddot(ny, tmp_ny, 0, tmp_ny, 0);
             }
         } // end NLS cost_computation without sens
         else if (opts->cost_computation && opts->cost_type == CONVEX_OVER_NONLINEAR)
@@ -1882,7 +2163,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             {
                 impl_ode_z_in.xi = ns * nx + ii * nz;
 
-                t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                t_current = t_ss + opts->c_vec[ii] * step;
                 // compute x at stage (xt)
                 blasfeo_dveccp(nx, xn, 0, xt, 0);
                 for (int jj = 0; jj < ns; jj++)
@@ -1897,7 +2178,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
 
                 // cost function value
                 // NOTE: slack contribution and scaling done in cost module
-                mem->cost_fun[0] += b_vec[ii]/num_steps * a;
+                mem->cost_fun[0] += b_vec[ii] * step_frac * a;
             }
         } // end NLS cost_computation without sens
 
@@ -1914,11 +2195,19 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             sim_irk_compute_z_and_algebraic_sens(dims, opts, in, out, mem, workspace, model);
         }
 
-        if (ss == num_steps-1)
+        if (last_step)
         {
             // store last xdot, z values for next initialization
             blasfeo_unpack_dvec(nx, K, (ns-1) * nx, mem->xdot, 1);
             blasfeo_unpack_dvec(nz, K, (ns-1) * nz + ns*nx, mem->z, 1);
+            num_steps = ss + 1;
+            break;
+        }
+
+        if (opts->step_size_control)
+        {
+            t_ss += step;
+            step = step_next;
         }
     }  // end step loop (ss)
 
@@ -1944,6 +2233,10 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     {
         for (int ss = num_steps - 1; ss > -1; ss--)
         {
+            // step sequence of forward sweep
+            step = step_traj[ss];
+            t_ss = t_traj[ss];
+
             if (opts->sens_hess){
                 dK_dxu_ss = &dK_dxu[ss];
                 dG_dK_ss = &dG_dK[ss];
@@ -1977,7 +2270,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     // use k_i of K = (k_1,..., k_{ns},z_1,..., z_{ns})
                     impl_ode_z_in.xi    = ns * nx + ii * nz;
                     // use z_i of K = (k_1,..., k_{ns},z_1,..., z_{ns})
-                    t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                    t_current = t_ss + opts->c_vec[ii] * step;
 
                     // build stage value
                     blasfeo_dveccp(nx, &xn_traj[ss], 0, xt, 0);
@@ -2016,6 +2309,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 // factorize dG_dK_ss - already done in forw if hessian is active
                 acados_tic(&timer_la);
                 blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
+                num_factorizations++;
                 timing_la += acados_toc(&timer_la);
 
             }  // end if( !opts->sens_hess )
@@ -2086,7 +2380,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     // use z_i of K = (k_1,..., k_{ns},z_1,..., z_{ns})
                     impl_ode_hess_lambda_in.xi = ii * (nx + nz);
 
-                    t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                    t_current = t_ss + opts->c_vec[ii] * step;
 
                     // eval hessian function at stage ii
                     // printf("dxkzu_dw0 = (IRK, ss = %d) \n", ss);
@@ -2134,7 +2428,12 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     mem->time_ad = out->info->ADtime;
     mem->time_la = out->info->LAtime;
 
-    return ACADOS_SUCCESS;
+    out->info->num_steps = num_steps;
+    out->info->num_rejected_steps = num_rejected;
+    out->info->num_factorizations = num_factorizations;
+    mem->num_factorizations = num_factorizations;
+
+    return status;
 }
 
 
@@ -87,6 +87,13 @@ typedef struct
     struct blasfeo_dvec *lambda;    // adjoint sensitivities (nx + nu)
     struct blasfeo_dvec *lambdaK;   // auxiliary variable ((nx+nz)*ns) for adjoint propagation
 
+    double *step_traj;  // size of each integration step
+    double *t_traj;     // start time of each integration step
+
+    // only allocated if (opts->step_size_control)
+    struct blasfeo_dvec *K_init;  // initial guess for K, restored if step is rejected (nx+nz)*ns
+    struct blasfeo_dvec *err;     // embedded local error estimate (nx)
+
     struct blasfeo_dmat df_dx;     // temporary Jacobian of ode w.r.t x (nx+nz, nx)
     struct blasfeo_dmat df_dxdot;  // temporary Jacobian of ode w.r.t xdot (nx+nz, nx)
     struct blasfeo_dmat df_du;     // temporary Jacobian of ode w.r.t u (nx+nz, nu)
@@ -164,6 +171,15 @@ typedef struct
     double time_ad;
     double time_la;
 
+    double step_prev;  // last accepted step size, initial guess if opts->step_size_control
+
+    int num_factorizations;  // factorizations of dG_dK in the last call
+
+    // only allocated if (opts->jac_reuse_across_calls)
+    struct blasfeo_dmat dG_dK_fact;  // LU factors of dG_dK kept across calls ((nx+nz)*ns, (nx+nz)*ns)
+    int *ipiv_fact;                  // corresponding pivot vector ((nx+nz)*ns)
+    double step_fact;                // step size corresponding to dG_dK_fact, 0 if not available
+
     double *cost_fun;
     double *outer_hess_is_diag;
     double *cost_scaling_ptr;
@@ -127,6 +127,11 @@ void sim_lifted_irk_dims_get(void *config_, void *dims_, const char *field, int
     {
         *value = dims->nz;
     }
+    else if (!strcmp(field, "n_guesses"))
+    {
+        // size of the initial guess of the integration variables, see memory_set "guesses_blasfeo"
+        *value = 0;
+    }
     else
     {
         printf("\nerror: sim_lifted_irk_dims_get: field not available: %s\n", field);
@@ -419,6 +424,7 @@ void *sim_lifted_irk_memory_assign(void *config, void *dims_, void *opts_, void
 
     // TODO(andrea): need to move this to options.
     memory->update_sens = 1;
+    memory->num_factorizations = 0;
 
     assert((char *) raw_memory + sim_lifted_irk_memory_calculate_size(config, dims, opts_) >=
            c_ptr);
@@ -513,6 +519,11 @@ void sim_lifted_irk_memory_get(void *config_, void *dims_, void *mem_, const cha
         double *ptr = value;
         *ptr = mem->time_la;
     }
+    else if (!strcmp(field, "num_factorizations"))
+    {
+        int *ptr = value;
+        *ptr = mem->num_factorizations;
+    }
     else
     {
         printf("sim_lifted_irk_memory_get field %s is not supported! \n", field);
@@ -992,6 +1003,11 @@ int sim_lifted_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *m
     mem->time_ad = out->info->ADtime;
     mem->time_la = out->info->LAtime;
 
+    out->info->num_steps = opts->num_steps;
+    out->info->num_rejected_steps = 0;
+    out->info->num_factorizations = update_sens ? opts->num_steps : 0;
+    mem->num_factorizations = out->info->num_factorizations;
+
     return 0;
 }
 
@@ -99,6 +99,8 @@ typedef struct
     double time_ad;
     double time_la;
 
+    int num_factorizations;  // factorizations of JGK in the last call
+
 } sim_lifted_irk_memory;
 
 
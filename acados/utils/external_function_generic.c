@@ -31,6 +31,7 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "acados/utils/external_function_generic.h"
 #include "acados/utils/mem.h"
@@ -281,39 +282,80 @@ static int casadi_is_dense(const int *sparsity)
 
 
 
-static void d_cvt_casadi_to_colmaj(double *in, int *sparsity_in, double *out, int is_dense)
+static acados_size_t casadi_sparsity_map_calculate_size(const int *sparsity)
 {
-    int ii, jj, idx;
+    // row/col index lists are only needed for truly sparse patterns
+    if (casadi_is_dense(sparsity))
+        return 0;
+
+    return 2 * casadi_nnz(sparsity) * sizeof(int);
+}
+
+
+
+static void casadi_sparsity_map_assign(const int *sparsity, casadi_sparsity_map *map, char **c_ptr)
+{
+    int jj, idx;
+
+    map->nrow = 0;
+    map->ncol = 0;
+    map->nnz = 0;
+    map->row = NULL;
+    map->col = NULL;
+
+    if (sparsity == NULL)
+        return;
+
+    map->nrow = sparsity[0];
+    map->ncol = sparsity[1];
+    map->nnz = casadi_nnz(sparsity);
+
+    if (casadi_is_dense(sparsity))
+        return;
 
-    int nrow = sparsity_in[0];
-    int ncol = sparsity_in[1];
+    assign_and_advance_int(map->nnz, &map->row, c_ptr);
+    assign_and_advance_int(map->nnz, &map->col, c_ptr);
+
+    // flatten compressed column storage into (row, col) pairs in casadi order
+    const int *idxcol = sparsity + 2;
+    const int *row = sparsity + map->ncol + 3;
+    for (jj = 0; jj < map->ncol; jj++)
+    {
+        for (idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
+        {
+            map->row[idx] = row[idx];
+            map->col[idx] = jj;
+        }
+    }
+
+    return;
+}
+
+
+
+static void d_cvt_casadi_to_colmaj(double *in, const casadi_sparsity_map *map, double *out)
+{
+    int ii;
+
+    int nrow = map->nrow;
+    int ncol = map->ncol;
 
     if ((nrow<=0 )| (ncol<=0))
         return;
 
-    if (is_dense)
+    if (map->row == NULL)
     {
-        // printf("d_cvt_casadi_to_colmaj: dense\n");
-        for (ii = 0; ii < ncol * nrow; ii++) out[ii] = in[ii];
+        memcpy(out, in, nrow * ncol * sizeof(double));
     }
     else
     {
-        // printf("d_cvt_casadi_to_colmaj: sparse\n");
-        double *ptr = in;
-        int *idxcol = sparsity_in + 2;
-        int *row = sparsity_in + ncol + 3;
+        const int *row = map->row;
+        const int *col = map->col;
         // Fill with zeros
-        for (jj = 0; jj < ncol; jj++)
-            for (ii = 0; ii < nrow; ii++) out[ii + jj * nrow] = 0.0;
+        for (ii = 0; ii < ncol * nrow; ii++) out[ii] = 0.0;
         // Copy nonzeros
-        for (jj = 0; jj < ncol; jj++)
-        {
-            for (idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
-            {
-                out[row[idx] + jj * nrow] = ptr[0];
-                ptr++;
-            }
-        }
+        for (ii = 0; ii < map->nnz; ii++)
+            out[row[ii] + col[ii] * nrow] = in[ii];
     }
 
     return;
@@ -321,36 +363,27 @@ static void d_cvt_casadi_to_colmaj(double *in, int *sparsity_in, double *out, in
 
 
 
-static void d_cvt_colmaj_to_casadi(double *in, double *out, int *sparsity_out, int is_dense)
+static void d_cvt_colmaj_to_casadi(double *in, double *out, const casadi_sparsity_map *map)
 {
-    int ii, jj, idx;
+    int ii;
 
-    int nrow = sparsity_out[0];
-    int ncol = sparsity_out[1];
+    int nrow = map->nrow;
+    int ncol = map->ncol;
 
     if ((nrow<=0 )| (ncol<=0))
         return;
 
-    if (is_dense)
+    if (map->row == NULL)
     {
-        // printf("d_cvt_colmaj_to_casadi: dense\n");
-        for (ii = 0; ii < ncol * nrow; ii++) out[ii] = in[ii];
+        memcpy(out, in, nrow * ncol * sizeof(double));
     }
     else
     {
-        // printf("d_cvt_colmaj_to_casadi: sparse\n");
-        double *ptr = out;
-        int *idxcol = sparsity_out + 2;
-        int *row = sparsity_out + ncol + 3;
+        const int *row = map->row;
+        const int *col = map->col;
         // Copy nonzeros
-        for (jj = 0; jj < ncol; jj++)
-        {
-            for (idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
-            {
-                ptr[0] = in[row[idx] + jj * nrow];
-                ptr++;
-            }
-        }
+        for (ii = 0; ii < map->nnz; ii++)
+            out[ii] = in[row[ii] + col[ii] * nrow];
     }
 
     return;
@@ -358,36 +391,29 @@ static void d_cvt_colmaj_to_casadi(double *in, double *out, int *sparsity_out, i
 
 
 
-static void d_cvt_casadi_to_dmat(double *in, int *sparsity_in, struct blasfeo_dmat *out, int is_dense)
+static void d_cvt_casadi_to_dmat(double *in, const casadi_sparsity_map *map, struct blasfeo_dmat *out)
 {
-    int jj, idx;
+    int ii;
 
-    int nrow = sparsity_in[0];
-    int ncol = sparsity_in[1];
+    int nrow = map->nrow;
+    int ncol = map->ncol;
 
     if ((nrow<=0 )| (ncol<=0))
         return;
 
-    if (is_dense)
+    if (map->row == NULL)
     {
         blasfeo_pack_dmat(nrow, ncol, in, nrow, out, 0, 0);
     }
     else
     {
-        double *ptr = in;
-        int *idxcol = sparsity_in + 2;
-        int *row = sparsity_in + ncol + 3;
+        const int *row = map->row;
+        const int *col = map->col;
         // Fill with zeros
         blasfeo_dgese(nrow, ncol, 0.0, out, 0, 0);
         // Copy nonzeros
-        for (jj = 0; jj < ncol; jj++)
-        {
-            for (idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
-            {
-                BLASFEO_DMATEL(out, row[idx], jj) = ptr[0];
-                ptr++;
-            }
-        }
+        for (ii = 0; ii < map->nnz; ii++)
+            BLASFEO_DMATEL(out, row[ii], col[ii]) = in[ii];
     }
 
     return;
@@ -395,34 +421,27 @@ static void d_cvt_casadi_to_dmat(double *in, int *sparsity_in, struct blasfeo_dm
 
 
 
-static void d_cvt_dmat_to_casadi(struct blasfeo_dmat *in, double *out, int *sparsity_out, int is_dense)
+static void d_cvt_dmat_to_casadi(struct blasfeo_dmat *in, double *out, const casadi_sparsity_map *map)
 {
-    int jj, idx;
+    int ii;
 
-    int nrow = sparsity_out[0];
-    int ncol = sparsity_out[1];
+    int nrow = map->nrow;
+    int ncol = map->ncol;
 
     if ((nrow<=0 )| (ncol<=0))
         return;
 
-    if (is_dense)
+    if (map->row == NULL)
     {
         blasfeo_unpack_dmat(nrow, ncol, in, 0, 0, out, nrow);
     }
     else
     {
-        double *ptr = out;
-        int *idxcol = sparsity_out + 2;
-        int *row = sparsity_out + ncol + 3;
+        const int *row = map->row;
+        const int *col = map->col;
         // Copy nonzeros
-        for (jj = 0; jj < ncol; jj++)
-        {
-            for (idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
-            {
-                ptr[0] = BLASFEO_DMATEL(in, row[idx], jj);
-                ptr++;
-            }
-        }
+        for (ii = 0; ii < map->nnz; ii++)
+            out[ii] = BLASFEO_DMATEL(in, row[ii], col[ii]);
     }
 
     return;
@@ -430,38 +449,33 @@ static void d_cvt_dmat_to_casadi(struct blasfeo_dmat *in, double *out, int *spar
 
 
 
-static void d_cvt_casadi_to_dvec(double *in, int *sparsity_in, struct blasfeo_dvec *out, int is_dense)
+static void d_cvt_casadi_to_dvec(double *in, const casadi_sparsity_map *map, struct blasfeo_dvec *out)
 {
-    int idx;
+    int ii;
 
-    if (!((sparsity_in[1] == 1) | (sparsity_in[0] == 0) | (sparsity_in[1] == 0)))
+    if (!((map->ncol == 1) | (map->nrow == 0) | (map->ncol == 0)))
     {
         printf("\nd_cvt_casadi_to_dvec: expected column vector or empty vector. Exiting.\n\n");
         exit(1);
     }
 
-    int n = sparsity_in[0];
+    int n = map->nrow;
 
     if (n<=0)
         return;
 
-    if (is_dense)
+    if (map->row == NULL)
     {
         blasfeo_pack_dvec(n, in, 1, out, 0);
     }
     else
     {
-        double *ptr = in;
-        int *idxcol = sparsity_in + 2;
-        int *row = sparsity_in + 1 + 3;
+        const int *row = map->row;
         // Fill with zeros
         blasfeo_dvecse(n, 0.0, out, 0);
         // Copy nonzeros
-        for (idx = idxcol[0]; idx != idxcol[1]; idx++)
-        {
-            BLASFEO_DVECEL(out, row[idx]) = ptr[0];
-            ptr++;
-        }
+        for (ii = 0; ii < map->nnz; ii++)
+            BLASFEO_DVECEL(out, row[ii]) = in[ii];
     }
 
     return;
@@ -469,35 +483,30 @@ static void d_cvt_casadi_to_dvec(double *in, int *sparsity_in, struct blasfeo_dv
 
 
 
-static void d_cvt_dvec_to_casadi(struct blasfeo_dvec *in, double *out, int *sparsity_out, int is_dense)
+static void d_cvt_dvec_to_casadi(struct blasfeo_dvec *in, double *out, const casadi_sparsity_map *map)
 {
-    int idx;
+    int ii;
 
-    if (!((sparsity_out[1] == 1) | (sparsity_out[0] == 0) | (sparsity_out[1] == 0)))
+    if (!((map->ncol == 1) | (map->nrow == 0) | (map->ncol == 0)))
     {
         printf("\nd_cvt_dvec_to_casadi: expected column vector or empty vector. Exiting.\n\n");
         exit(1);
     }
-    int n = sparsity_out[0];
+    int n = map->nrow;
 
     if (n<=0)
         return;
 
-    if (is_dense)
+    if (map->row == NULL)
     {
         blasfeo_unpack_dvec(n, in, 0, out, 1);
     }
     else
     {
-        double *ptr = out;
-        int *idxcol = sparsity_out + 2;
-        int *row = sparsity_out + 1 + 3;
+        const int *row = map->row;
         // Copy nonzeros
-        for (idx = idxcol[0]; idx != idxcol[1]; idx++)
-        {
-            ptr[0] = BLASFEO_DVECEL(in, row[idx]);
-            ptr++;
-        }
+        for (ii = 0; ii < map->nnz; ii++)
+            out[ii] = BLASFEO_DVECEL(in, row[ii]);
     }
 
     return;
@@ -505,12 +514,12 @@ static void d_cvt_dvec_to_casadi(struct blasfeo_dvec *in, double *out, int *spar
 
 
 
-static void d_cvt_casadi_to_colmaj_args(double *in, int *sparsity_in, struct colmaj_args *out, int is_dense)
+static void d_cvt_casadi_to_colmaj_args(double *in, const casadi_sparsity_map *map, struct colmaj_args *out)
 {
-    int ii, jj, idx;
+    int ii, jj;
 
-    int nrow = sparsity_in[0];
-    int ncol = sparsity_in[1];
+    int nrow = map->nrow;
+    int ncol = map->ncol;
 
     if ((nrow<=0 )| (ncol<=0))
         return;
@@ -518,28 +527,21 @@ static void d_cvt_casadi_to_colmaj_args(double *in, int *sparsity_in, struct col
     double *A = out->A;
     int lda = out->lda;
 
-    if (is_dense)
+    if (map->row == NULL)
     {
         for (ii = 0; ii < ncol; ii++)
             for (jj = 0; jj < nrow; jj++) A[ii + jj * lda] = in[ii + ncol * jj];
     }
     else
     {
-        double *ptr = in;
-        int *idxcol = sparsity_in + 2;
-        int *row = sparsity_in + ncol + 3;
+        const int *row = map->row;
+        const int *col = map->col;
         // Fill with zeros
         for (jj = 0; jj < ncol; jj++)
             for (ii = 0; ii < nrow; ii++) A[ii + jj * lda] = 0.0;
         // Copy nonzeros
-        for (jj = 0; jj < ncol; jj++)
-        {
-            for (idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
-            {
-                A[row[idx] + jj * lda] = ptr[0];
-                ptr++;
-            }
-        }
+        for (ii = 0; ii < map->nnz; ii++)
+            A[row[ii] + col[ii] * lda] = in[ii];
     }
 
     return;
@@ -547,12 +549,12 @@ static void d_cvt_casadi_to_colmaj_args(double *in, int *sparsity_in, struct col
 
 
 
-static void d_cvt_colmaj_args_to_casadi(struct colmaj_args *in, double *out, int *sparsity_out, int is_dense)
+static void d_cvt_colmaj_args_to_casadi(struct colmaj_args *in, double *out, const casadi_sparsity_map *map)
 {
-    int ii, jj, idx;
+    int ii, jj;
 
-    int nrow = sparsity_out[0];
-    int ncol = sparsity_out[1];
+    int nrow = map->nrow;
+    int ncol = map->ncol;
 
     if ((nrow<=0 )| (ncol<=0))
         return;
@@ -560,25 +562,18 @@ static void d_cvt_colmaj_args_to_casadi(struct colmaj_args *in, double *out, int
     double *A = in->A;
     int lda = in->lda;
 
-    if (is_dense)
+    if (map->row == NULL)
     {
         for (ii = 0; ii < ncol; ii++)
             for (jj = 0; jj < nrow; jj++) out[ii + ncol * jj] = A[ii + jj * lda];
     }
     else
     {
-        double *ptr = out;
-        int *idxcol = sparsity_out + 2;
-        int *row = sparsity_out + ncol + 3;
+        const int *row = map->row;
+        const int *col = map->col;
         // Copy nonzeros
-        for (jj = 0; jj < ncol; jj++)
-        {
-            for (idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
-            {
-                ptr[0] = A[row[idx] + jj * lda];
-                ptr++;
-            }
-        }
+        for (ii = 0; ii < map->nnz; ii++)
+            out[ii] = A[row[ii] + col[ii] * lda];
     }
 
     return;
@@ -586,12 +581,12 @@ static void d_cvt_colmaj_args_to_casadi(struct colmaj_args *in, double *out, int
 
 
 
-static void d_cvt_casadi_to_dmat_args(double *in, int *sparsity_in, struct blasfeo_dmat_args *out, int is_dense)
+static void d_cvt_casadi_to_dmat_args(double *in, const casadi_sparsity_map *map, struct blasfeo_dmat_args *out)
 {
-    int jj, idx;
+    int ii;
 
-    int nrow = sparsity_in[0];
-    int ncol = sparsity_in[1];
+    int nrow = map->nrow;
+    int ncol = map->ncol;
 
     if ((nrow<=0 )| (ncol<=0))
         return;
@@ -600,26 +595,19 @@ static void d_cvt_casadi_to_dmat_args(double *in, int *sparsity_in, struct blasf
     int ai = out->ai;
     int aj = out->aj;
 
-    if (is_dense)
+    if (map->row == NULL)
     {
         blasfeo_pack_dmat(nrow, ncol, in, nrow, A, ai, aj);
     }
     else
     {
-        double *ptr = in;
-        int *idxcol = sparsity_in + 2;
-        int *row = sparsity_in + ncol + 3;
+        const int *row = map->row;
+        const int *col = map->col;
         // Fill with zeros
         blasfeo_dgese(nrow, ncol, 0.0, A, ai, aj);
         // Copy nonzeros
-        for (jj = 0; jj < ncol; jj++)
-        {
-            for (idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
-            {
-                BLASFEO_DMATEL(A, ai + row[idx], aj + jj) = ptr[0];
-                ptr++;
-            }
-        }
+        for (ii = 0; ii < map->nnz; ii++)
+            BLASFEO_DMATEL(A, ai + row[ii], aj + col[ii]) = in[ii];
     }
 
     return;
@@ -627,12 +615,12 @@ static void d_cvt_casadi_to_dmat_args(double *in, int *sparsity_in, struct blasf
 
 
 
-static void d_cvt_dmat_args_to_casadi(struct blasfeo_dmat_args *in, double *out, int *sparsity_out, int is_dense)
+static void d_cvt_dmat_args_to_casadi(struct blasfeo_dmat_args *in, double *out, const casadi_sparsity_map *map)
 {
-    int jj, idx;
+    int ii;
 
-    int nrow = sparsity_out[0];
-    int ncol = sparsity_out[1];
+    int nrow = map->nrow;
+    int ncol = map->ncol;
 
     if ((nrow<=0 )| (ncol<=0))
         return;
@@ -641,24 +629,17 @@ static void d_cvt_dmat_args_to_casadi(struct blasfeo_dmat_args *in, double *out,
     int ai = in->ai;
     int aj = in->aj;
 
-    if (is_dense)
+    if (map->row == NULL)
     {
         blasfeo_unpack_dmat(nrow, ncol, A, ai, aj, out, nrow);
     }
     else
     {
-        double *ptr = out;
-        int *idxcol = sparsity_out + 2;
-        int *row = sparsity_out + ncol + 3;
+        const int *row = map->row;
+        const int *col = map->col;
         // Copy nonzeros
-        for (jj = 0; jj < ncol; jj++)
-        {
-            for (idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
-            {
-                ptr[0] = BLASFEO_DMATEL(A, ai + row[idx], aj + jj);
-                ptr++;
-            }
-        }
+        for (ii = 0; ii < map->nnz; ii++)
+            out[ii] = BLASFEO_DMATEL(A, ai + row[ii], aj + col[ii]);
     }
 
     return;
@@ -666,17 +647,17 @@ static void d_cvt_dmat_args_to_casadi(struct blasfeo_dmat_args *in, double *out,
 
 
 
-static void d_cvt_casadi_to_dvec_args(double *in, int *sparsity_in, struct blasfeo_dvec_args *out, int is_dense)
+static void d_cvt_casadi_to_dvec_args(double *in, const casadi_sparsity_map *map, struct blasfeo_dvec_args *out)
 {
-    int idx;
+    int ii;
 
-    if (!((sparsity_in[1] == 1) | (sparsity_in[0] == 0) | (sparsity_in[1] == 0)))
+    if (!((map->ncol == 1) | (map->nrow == 0) | (map->ncol == 0)))
     {
         printf("\nd_cvt_casadi_to_dvec_args: expected column vector or empty vector. Exiting.\n\n");
         exit(1);
     }
 
-    int n = sparsity_in[0];
+    int n = map->nrow;
 
     if (n<=0)
         return;
@@ -684,23 +665,18 @@ static void d_cvt_casadi_to_dvec_args(double *in, int *sparsity_in, struct blasf
     struct blasfeo_dvec *x = out->x;
     int xi = out->xi;
 
-    if (is_dense)
+    if (map->row == NULL)
     {
         blasfeo_pack_dvec(n, in, 1, x, xi);
     }
     else
     {
-        double *ptr = in;
-        int *idxcol = sparsity_in + 2;
-        int *row = sparsity_in + 1 + 3;
+        const int *row = map->row;
         // Fill with zeros
         blasfeo_dvecse(n, 0.0, x, xi);
         // Copy nonzeros
-        for (idx = idxcol[0]; idx != idxcol[1]; idx++)
-        {
-            BLASFEO_DVECEL(x, xi + row[idx]) = ptr[0];
-            ptr++;
-        }
+        for (ii = 0; ii < map->nnz; ii++)
+            BLASFEO_DVECEL(x, xi + row[ii]) = in[ii];
     }
 
     return;
@@ -708,16 +684,16 @@ static void d_cvt_casadi_to_dvec_args(double *in, int *sparsity_in, struct blasf
 
 
 
-static void d_cvt_dvec_args_to_casadi(struct blasfeo_dvec_args *in, double *out, int *sparsity_out, int is_dense)
+static void d_cvt_dvec_args_to_casadi(struct blasfeo_dvec_args *in, double *out, const casadi_sparsity_map *map)
 {
-    int idx;
+    int ii;
 
-    if (!((sparsity_out[1] == 1) | (sparsity_out[0] == 0) | (sparsity_out[1] == 0)))
+    if (!((map->ncol == 1) | (map->nrow == 0) | (map->ncol == 0)))
     {
         printf("\nd_cvt_dvec_args_to_casadi: expected column vector or empty vector. Exiting.\n\n");
         exit(1);
     }
-    int n = sparsity_out[0];
+    int n = map->nrow;
 
     if (n<=0)
         return;
@@ -725,52 +701,47 @@ static void d_cvt_dvec_args_to_casadi(struct blasfeo_dvec_args *in, double *out,
     struct blasfeo_dvec *x = in->x;
     int xi = in->xi;
 
-    if (is_dense)
+    if (map->row == NULL)
     {
         blasfeo_unpack_dvec(n, x, xi, out, 1);
     }
     else
     {
-        double *ptr = out;
-        int *idxcol = sparsity_out + 2;
-        int *row = sparsity_out + 1 + 3;
+        const int *row = map->row;
         // Copy nonzeros
-        for (idx = idxcol[0]; idx != idxcol[1]; idx++)
-        {
-            ptr[0] = BLASFEO_DVECEL(x, xi + row[idx]);
-            ptr++;
-        }
+        for (ii = 0; ii < map->nnz; ii++)
+            out[ii] = BLASFEO_DVECEL(x, xi + row[ii]);
     }
 
     return;
 }
 
 
-static int d_cvt_casadi_to_ext_fun_arg(ext_fun_arg_t type, double *in, int *sparsity, void *out, int is_dense)
+static int d_cvt_casadi_to_ext_fun_arg(ext_fun_arg_t type, double *in, const casadi_sparsity_map *map, void *out)
 {
     switch (type)
     {
         case COLMAJ:
-            d_cvt_casadi_to_colmaj(in, sparsity, out, is_dense);
+            d_cvt_casadi_to_colmaj(in, map, out);
             break;
 
         case BLASFEO_DMAT:
-            d_cvt_casadi_to_dmat(in, sparsity, out, is_dense);
+            d_cvt_casadi_to_dmat(in, map, out);
             break;
 
         case BLASFEO_DVEC:
-            d_cvt_casadi_to_dvec(in, sparsity, out, is_dense);
+            d_cvt_casadi_to_dvec(in, map, out);
             break;
         case COLMAJ_ARGS:
-            d_cvt_casadi_to_colmaj_args(in, sparsity, out, is_dense);
+            d_cvt_casadi_to_colmaj_args(in, map, out);
             break;
 
         case BLASFEO_DMAT_ARGS:
-            d_cvt_casadi_to_dmat_args(in, sparsity, out, is_dense);
+            d_cvt_casadi_to_dmat_args(in, map, out);
             break;
 
         case BLASFEO_DVEC_ARGS:
-            d_cvt_casadi_to_dvec_args(in, sparsity, out, is_dense);
+            d_cvt_casadi_to_dvec_args(in, map, out);
             break;
 
         case IGNORE_ARGUMENT:
@@ -784,32 +755,32 @@ static int d_cvt_casadi_to_ext_fun_arg(ext_fun_arg_t type, double *in, int *spar
     return 0;
 }
 
-static int d_cvt_ext_fun_arg_to_casadi(ext_fun_arg_t type, void *in, double *out, int *sparsity, int is_dense)
+static int d_cvt_ext_fun_arg_to_casadi(ext_fun_arg_t type, void *in, double *out, const casadi_sparsity_map *map)
 {
     switch (type)
     {
         case COLMAJ:
-            d_cvt_colmaj_to_casadi(in, out, sparsity, is_dense);
+            d_cvt_colmaj_to_casadi(in, out, map);
             break;
 
         case BLASFEO_DMAT:
-            d_cvt_dmat_to_casadi(in, out, sparsity, is_dense);
+            d_cvt_dmat_to_casadi(in, out, map);
             break;
 
         case BLASFEO_DVEC:
-            d_cvt_dvec_to_casadi(in, out, sparsity, is_dense);
+            d_cvt_dvec_to_casadi(in, out, map);
             break;
 
         case COLMAJ_ARGS:
-            d_cvt_colmaj_args_to_casadi(in, out, sparsity, is_dense);
+            d_cvt_colmaj_args_to_casadi(in, out, map);
             break;
 
         case BLASFEO_DMAT_ARGS:
-            d_cvt_dmat_args_to_casadi(in, out, sparsity, is_dense);
+            d_cvt_dmat_args_to_casadi(in, out, map);
             break;
 
         case BLASFEO_DVEC_ARGS:
-            d_cvt_dvec_args_to_casadi(in, out, sparsity, is_dense);
+            d_cvt_dvec_args_to_casadi(in, out, map);
             break;
 
         case IGNORE_ARGUMENT:
@@ -874,10 +845,18 @@ acados_size_t external_function_casadi_calculate_size(external_function_casadi *
     size += fun->args_num * sizeof(double *);  // args
     size += fun->res_num * sizeof(double *);   // res
 
+    // sparsity maps
+    size += fun->in_num * sizeof(casadi_sparsity_map);  // args_map
+    size += fun->out_num * sizeof(casadi_sparsity_map);  // res_map
+
     // ints
     size += 2 * fun->args_num * sizeof(int);  // args_size, args_dense
     size += 2 * fun->res_num * sizeof(int);   // res_size, res_dense
     size += fun->int_work_size * sizeof(int);   // int_work
+    for (ii = 0; ii < fun->in_num; ii++)  // args_map row, col
+        size += casadi_sparsity_map_calculate_size(fun->casadi_sparsity_in(ii));
+    for (ii = 0; ii < fun->out_num; ii++)  // res_map row, col
+        size += casadi_sparsity_map_calculate_size(fun->casadi_sparsity_out(ii));
 
     // doubles
     size += fun->args_size_tot * sizeof(double);  // args
@@ -918,6 +897,12 @@ void external_function_casadi_assign(external_function_casadi *fun, void *raw_me
     // res
     assign_and_advance_double_ptrs(fun->res_num, &fun->res, &c_ptr);
 
+    // args_map, res_map
+    fun->args_map = (casadi_sparsity_map *) c_ptr;
+    c_ptr += fun->in_num * sizeof(casadi_sparsity_map);
+    fun->res_map = (casadi_sparsity_map *) c_ptr;
+    c_ptr += fun->out_num * sizeof(casadi_sparsity_map);
+
     // args_size, args_dense
     assign_and_advance_int(fun->args_num, &fun->args_size, &c_ptr);
     assign_and_advance_int(fun->args_num, &fun->args_dense, &c_ptr);
@@ -936,6 +921,11 @@ void external_function_casadi_assign(external_function_casadi *fun, void *raw_me
     }
     // int_work
     assign_and_advance_int(fun->int_work_size, &fun->int_work, &c_ptr);
+    // sparsity maps, computed once here instead of on every evaluation
+    for (ii = 0; ii < fun->in_num; ii++)
+        casadi_sparsity_map_assign(fun->casadi_sparsity_in(ii), &fun->args_map[ii], &c_ptr);
+    for (ii = 0; ii < fun->out_num; ii++)
+        casadi_sparsity_map_assign(fun->casadi_sparsity_out(ii), &fun->res_map[ii], &c_ptr);
 
     // align to double
     align_char_to(8, &c_ptr);
@@ -971,8 +961,7 @@ void external_function_casadi_wrapper(void *self, ext_fun_arg_t *type_in, void *
     // in as args
     for (ii = 0; ii < fun->in_num; ii++)
     {
-        status = d_cvt_ext_fun_arg_to_casadi(type_in[ii], in[ii], (double *) fun->args[ii],
-                                    (int *) fun->casadi_sparsity_in(ii), fun->args_dense[ii]);
+        status = d_cvt_ext_fun_arg_to_casadi(type_in[ii], in[ii], (double *) fun->args[ii], &fun->args_map[ii]);
         if (status)
         {
             printf("\nexternal_function_casadi_wrapper: Unknown external function argument type %d for input %d\n\n", type_in[ii], ii);
@@ -985,8 +974,8 @@ void external_function_casadi_wrapper(void *self, ext_fun_arg_t *type_in, void *
 
     for (ii = 0; ii < fun->out_num; ii++)
     {
-        status = d_cvt_casadi_to_ext_fun_arg(type_out[ii], (double *) fun->res[ii], (int *) fun->casadi_sparsity_out(ii),
-                                     out[ii], fun->res_dense[ii]);
+        status = d_cvt_casadi_to_ext_fun_arg(type_out[ii], (double *) fun->res[ii], &fun->res_map[ii],
+                                     out[ii]);
         if (status)
         {
             printf("\nexternal_function_casadi_wrapper: Unknown external function argument type %d for output %d\n\n", type_out[ii], ii);
@@ -1030,9 +1019,7 @@ static void external_function_param_casadi_set_param(void *self, double *p)
     external_function_param_casadi *fun = self;
 
     // set value for all parameters
-    int* sparsity = (int *) fun->casadi_sparsity_in(fun->idx_in_p);
-    d_cvt_colmaj_to_casadi(p, (double *) fun->args[fun->idx_in_p],
-                            sparsity, fun->args_dense[fun->idx_in_p]);
+    d_cvt_colmaj_to_casadi(p, (double *) fun->args[fun->idx_in_p], &fun->args_map[fun->idx_in_p]);
 
     return;
 }
@@ -1111,10 +1098,18 @@ acados_size_t external_function_param_casadi_calculate_size(external_function_pa
     size += fun->args_num * sizeof(double *);  // args
     size += fun->res_num * sizeof(double *);   // res
 
+    // sparsity maps
+    size += fun->in_num * sizeof(casadi_sparsity_map);  // args_map
+    size += fun->out_num * sizeof(casadi_sparsity_map);  // res_map
+
     // ints
     size += 2 * fun->args_num * sizeof(int);  // args_size, args_dense
     size += 2 * fun->res_num * sizeof(int);   // res_size, res_dense
     size += fun->int_work_size * sizeof(int);   // int_work
+    for (ii = 0; ii < fun->in_num; ii++)  // args_map row, col
+        size += casadi_sparsity_map_calculate_size(fun->casadi_sparsity_in(ii));
+    for (ii = 0; ii < fun->out_num; ii++)  // res_map row, col
+        size += casadi_sparsity_map_calculate_size(fun->casadi_sparsity_out(ii));
 
     // doubles
     size += fun->args_size_tot * sizeof(double);  // args
@@ -1155,6 +1150,12 @@ void external_function_param_casadi_assign(external_function_param_casadi *fun,
     // res
     assign_and_advance_double_ptrs(fun->res_num, &fun->res, &c_ptr);
 
+    // args_map, res_map
+    fun->args_map = (casadi_sparsity_map *) c_ptr;
+    c_ptr += fun->in_num * sizeof(casadi_sparsity_map);
+    fun->res_map = (casadi_sparsity_map *) c_ptr;
+    c_ptr += fun->out_num * sizeof(casadi_sparsity_map);
+
     // args_size, args_dense
     assign_and_advance_int(fun->args_num, &fun->args_size, &c_ptr);
     assign_and_advance_int(fun->args_num, &fun->args_dense, &c_ptr);
@@ -1173,6 +1174,11 @@ void external_function_param_casadi_assign(external_function_param_casadi *fun,
     }
     // int_work
     assign_and_advance_int(fun->int_work_size, &fun->int_work, &c_ptr);
+    // sparsity maps, computed once here instead of on every evaluation
+    for (ii = 0; ii < fun->in_num; ii++)
+        casadi_sparsity_map_assign(fun->casadi_sparsity_in(ii), &fun->args_map[ii], &c_ptr);
+    for (ii = 0; ii < fun->out_num; ii++)
+        casadi_sparsity_map_assign(fun->casadi_sparsity_out(ii), &fun->res_map[ii], &c_ptr);
 
     // align to double
     align_char_to(8, &c_ptr);
@@ -1210,8 +1216,7 @@ void external_function_param_casadi_wrapper(void *self, ext_fun_arg_t *type_in,
         // skip parameter argument
         if (ii != fun->idx_in_p)
         {
-            status = d_cvt_ext_fun_arg_to_casadi(type_in[ii], in[ii], (double *) fun->args[ii],
-                                        (int *) fun->casadi_sparsity_in(ii), fun->args_dense[ii]);
+            status = d_cvt_ext_fun_arg_to_casadi(type_in[ii], in[ii], (double *) fun->args[ii], &fun->args_map[ii]);
         }
         if (status)
         {
@@ -1226,8 +1231,8 @@ void external_function_param_casadi_wrapper(void *self, ext_fun_arg_t *type_in,
 
     for (ii = 0; ii < fun->out_num; ii++)
     {
-        status = d_cvt_casadi_to_ext_fun_arg(type_out[ii], (double *) fun->res[ii], (int *) fun->casadi_sparsity_out(ii),
-                                     out[ii], fun->res_dense[ii]);
+        status = d_cvt_casadi_to_ext_fun_arg(type_out[ii], (double *) fun->res[ii], &fun->res_map[ii],
+                                     out[ii]);
         if (status)
         {
             printf("\nexternal_function_param_casadi_wrapper: Unknown external function argument type %d for output %d\n\n", type_out[ii], ii);
@@ -1469,10 +1474,18 @@ acados_size_t external_function_external_param_casadi_calculate_size(external_fu
     size += fun->args_num * sizeof(double *);  // args
     size += fun->res_num * sizeof(double *);   // res
 
+    // sparsity maps
+    size += fun->in_num * sizeof(casadi_sparsity_map);  // args_map
+    size += fun->out_num * sizeof(casadi_sparsity_map);  // res_map
+
     // ints
     size += 2 * fun->args_num * sizeof(int);  // args_size, args_dense
     size += 2 * fun->res_num * sizeof(int);   // res_size, res_dense
     size += fun->int_work_size * sizeof(int);   // int_work
+    for (ii = 0; ii < fun->in_num; ii++)  // args_map row, col
+        size += casadi_sparsity_map_calculate_size(fun->casadi_sparsity_in(ii));
+    for (ii = 0; ii < fun->out_num; ii++)  // res_map row, col
+        size += casadi_sparsity_map_calculate_size(fun->casadi_sparsity_out(ii));
 
     // doubles
     size += fun->args_size_tot * sizeof(double);  // args
@@ -1513,6 +1526,12 @@ void external_function_external_param_casadi_assign(external_function_external_p
     // res
     assign_and_advance_double_ptrs(fun->res_num, &fun->res, &c_ptr);
 
+    // args_map, res_map
+    fun->args_map = (casadi_sparsity_map *) c_ptr;
+    c_ptr += fun->in_num * sizeof(casadi_sparsity_map);
+    fun->res_map = (casadi_sparsity_map *) c_ptr;
+    c_ptr += fun->out_num * sizeof(casadi_sparsity_map);
+
     // args_size, args_dense
     assign_and_advance_int(fun->args_num, &fun->args_size, &c_ptr);
     assign_and_advance_int(fun->args_num, &fun->args_dense, &c_ptr);
@@ -1531,6 +1550,11 @@ void external_function_external_param_casadi_assign(external_function_external_p
     }
     // int_work
     assign_and_advance_int(fun->int_work_size, &fun->int_work, &c_ptr);
+    // sparsity maps, computed once here instead of on every evaluation
+    for (ii = 0; ii < fun->in_num; ii++)
+        casadi_sparsity_map_assign(fun->casadi_sparsity_in(ii), &fun->args_map[ii], &c_ptr);
+    for (ii = 0; ii < fun->out_num; ii++)
+        casadi_sparsity_map_assign(fun->casadi_sparsity_out(ii), &fun->res_map[ii], &c_ptr);
 
     // align to double
     align_char_to(8, &c_ptr);
@@ -1602,8 +1626,7 @@ void external_function_external_param_casadi_wrapper(void *self, ext_fun_arg_t *
     {
         // skip parameter arguments
         if (ii != fun->idx_in_p && ii != fun->idx_in_global_data)
-            status = d_cvt_ext_fun_arg_to_casadi(type_in[ii], in[ii], (double *) fun->args[ii],
-                                    (int *) fun->casadi_sparsity_in(ii), fun->args_dense[ii]);
+            status = d_cvt_ext_fun_arg_to_casadi(type_in[ii], in[ii], (double *) fun->args[ii], &fun->args_map[ii]);
         if (status)
         {
             printf("\nexternal_function_external_param_casadi_wrapper: Unknown external function argument type %d for input %d\n\n", type_in[ii], ii);
@@ -1616,8 +1639,8 @@ void external_function_external_param_casadi_wrapper(void *self, ext_fun_arg_t *
 
     for (ii = 0; ii < fun->out_num; ii++)
     {
-        status = d_cvt_casadi_to_ext_fun_arg(type_out[ii], (double *) fun->res[ii], (int *) fun->casadi_sparsity_out(ii),
-                                     out[ii], fun->res_dense[ii]);
+        status = d_cvt_casadi_to_ext_fun_arg(type_out[ii], (double *) fun->res[ii], &fun->res_map[ii],
+                                     out[ii]);
         if (status)
         {
             printf("\nexternal_function_external_param_casadi_wrapper: Unknown external function argument type %d for output %d\n\n", type_out[ii], ii);
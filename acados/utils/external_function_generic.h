@@ -148,6 +148,17 @@ void external_function_param_generic_set_external_workspace(void *self, void *wo
  * casadi external function
  ************************************************/
 
+// casadi sparsity pattern flattened at assign time:
+// nonzero k sits at (row[k], col[k]); row = col = NULL if the pattern is dense
+typedef struct
+{
+    int nrow;
+    int ncol;
+    int nnz;
+    int *row;
+    int *col;
+} casadi_sparsity_map;
+
 typedef struct
 {
     // public members (have to be the same as in the prototype, and before the private ones)
@@ -170,6 +181,8 @@ typedef struct
     int *res_size;      // size of res[i]
     int *args_dense;    // indicates if args[i] is dense
     int *res_dense;     // indicates if res[i] is dense
+    casadi_sparsity_map *args_map;  // precomputed sparsity of input i
+    casadi_sparsity_map *res_map;   // precomputed sparsity of output i
     int args_num;       // number of args arrays
     int args_size_tot;  // total size of args arrays
     int res_num;        // number of res arrays
@@ -225,6 +238,8 @@ typedef struct
     int *res_size;      // size of res[i]
     int *args_dense;    // indicates if args[i] is dense
     int *res_dense;     // indicates if res[i] is dense
+    casadi_sparsity_map *args_map;  // precomputed sparsity of input i
+    casadi_sparsity_map *res_map;   // precomputed sparsity of output i
     int args_num;       // number of args arrays
     int args_size_tot;  // total size of args arrays
     int res_num;        // number of res arrays
@@ -284,6 +299,8 @@ typedef struct
     int *res_size;      // size of res[i]
     int *args_dense;    // indicates if args[i] is dense
     int *res_dense;     // indicates if res[i] is dense
+    casadi_sparsity_map *args_map;  // precomputed sparsity of input i
+    casadi_sparsity_map *res_map;   // precomputed sparsity of output i
     int args_num;       // number of args arrays
     int args_size_tot;  // total size of args arrays
     int res_num;        // number of res arrays
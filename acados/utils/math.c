@@ -1110,6 +1110,110 @@ void acados_eigen_decomposition(int dim, double *A, double *V, double *d, double
 }
 
 
+
+// eigen decomposition A = V * diag(d) * V' by cyclic Jacobi sweeps, started from the orthogonal basis
+// passed in V, e.g. the eigenvectors of a nearby matrix from a previous call;
+// work has size 2*dim*dim; returns 0 on convergence and 1 if max_sweeps were not enough
+int acados_eigen_decomposition_warm(int dim, double *A, double *V, double *d, double *work,
+                                    int max_sweeps, double tol)
+{
+    int i, j, k, p, q, sweep;
+    double tmp, off, nrm, theta, t, c, s, bkp, bkq;
+
+    double *B = work;
+    double *T = work + dim*dim;
+
+    // T = A * V
+    for (i=0; i<dim; i++)
+    {
+        for (q=0; q<dim; q++)
+        {
+            tmp = 0.0;
+            for (j=0; j<dim; j++)
+                tmp += A[i*dim+j] * V[j*dim+q];
+            T[i*dim+q] = tmp;
+        }
+    }
+    // B = V' * T, symmetric
+    for (p=0; p<dim; p++)
+    {
+        for (q=0; q<=p; q++)
+        {
+            tmp = 0.0;
+            for (i=0; i<dim; i++)
+                tmp += V[i*dim+p] * T[i*dim+q];
+            B[p*dim+q] = tmp;
+            B[q*dim+p] = tmp;
+        }
+    }
+
+    for (sweep=0; sweep<=max_sweeps; sweep++)
+    {
+        off = 0.0;
+        nrm = 0.0;
+        for (p=0; p<dim; p++)
+        {
+            nrm += B[p*dim+p] * B[p*dim+p];
+            for (q=p+1; q<dim; q++)
+                off += 2.0 * B[p*dim+q] * B[p*dim+q];
+        }
+        nrm += off;
+
+        if (off <= tol*tol*nrm)
+        {
+            for (p=0; p<dim; p++)
+                d[p] = B[p*dim+p];
+            return 0;
+        }
+        if (sweep == max_sweeps)
+            break;
+
+        for (p=0; p<dim-1; p++)
+        {
+            for (q=p+1; q<dim; q++)
+            {
+                if (B[p*dim+q] == 0.0)
+                    continue;
+
+                // rotation annihilating B[p,q]
+                theta = (B[q*dim+q] - B[p*dim+p]) / (2.0 * B[p*dim+q]);
+                t = 1.0 / (fabs(theta) + sqrt(theta*theta + 1.0));
+                if (theta < 0.0)
+                    t = -t;
+                c = 1.0 / sqrt(t*t + 1.0);
+                s = t * c;
+
+                // B = J' * B * J
+                for (k=0; k<dim; k++)
+                {
+                    bkp = B[k*dim+p];
+                    bkq = B[k*dim+q];
+                    B[k*dim+p] = c*bkp - s*bkq;
+                    B[k*dim+q] = s*bkp + c*bkq;
+                }
+                for (k=0; k<dim; k++)
+                {
+                    bkp = B[p*dim+k];
+                    bkq = B[q*dim+k];
+                    B[p*dim+k] = c*bkp - s*bkq;
+                    B[q*dim+k] = s*bkp + c*bkq;
+                }
+                // V = V * J
+                for (k=0; k<dim; k++)
+                {
+                    bkp = V[k*dim+p];
+                    bkq = V[k*dim+q];
+                    V[k*dim+p] = c*bkp - s*bkq;
+                    V[k*dim+q] = s*bkp + c*bkq;
+                }
+            }
+        }
+    }
+
+    return 1;
+}
+
+
 void compute_gershgorin_max_abs_eig_estimate(int n, struct blasfeo_dmat *A, double *out)
 {
     double max_abs_eig = 0.0;
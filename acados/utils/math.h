@@ -97,6 +97,9 @@ void expm(int row, double *A);
 
 void acados_eigen_decomposition(int dim, double *A, double *V, double *d, double *e);
 
+int acados_eigen_decomposition_warm(int dim, double *A, double *V, double *d, double *work,
+                                    int max_sweeps, double tol);
+
 double minimum_of_doubles(double *x, int n);
 
 void neville_algorithm(double xx, int n, double *x, double *Q, double *out);
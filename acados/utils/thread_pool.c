@@ -0,0 +1,531 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#if defined(ACADOS_WITH_THREAD_POOL)
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  // pthread_setaffinity_np
+#endif
+
+// external
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// acados
+#include "acados/utils/thread_pool.h"
+
+
+
+typedef struct
+{
+    acados_thread_pool *pool;
+    pthread_t thread;
+    int id;
+    int core;
+} acados_thread_pool_worker;
+
+
+
+struct acados_thread_pool_
+{
+    int num_threads;  // including the calling thread
+    int spin_count;
+    int max_jobs;
+    int max_tasks;
+
+    acados_thread_pool_worker *workers;
+
+    // current job
+    acados_thread_pool_task task;
+    void *ctx;
+    int num_phases;
+    int num_tasks;
+    int *bounds;  // chunk boundaries, num_phases x (num_threads+1)
+    double *task_time;  // of current job, num_phases x max_tasks
+
+    // task times of all jobs, max_jobs x ACADOS_THREAD_POOL_MAX_PHASES x max_tasks
+    double *task_time_all;
+
+    // synchronization
+    int generation;
+    int stop;
+    int barrier_count;
+    int barrier_sense;
+    int main_sense;
+    int num_parked;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+};
+
+
+
+static double thread_pool_clock()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + 1e-9 * (double) ts.tv_nsec;
+}
+
+
+
+static inline void thread_pool_cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+
+
+static void thread_pool_pin_to_core(pthread_t thread, int core)
+{
+#if defined(__linux__)
+    if (core < 0)
+        return;
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core, &cpuset);
+    if (pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpuset) != 0)
+        printf("\nacados_thread_pool: could not pin thread to core %d.\n", core);
+#endif
+}
+
+
+
+// spin for a while, then park on the condition variable until *flag != value
+static void thread_pool_wait_while_equal(acados_thread_pool *pool, int *flag, int value)
+{
+    for (int k = 0; k < pool->spin_count; k++)
+    {
+        if (__atomic_load_n(flag, __ATOMIC_ACQUIRE) != value)
+            return;
+        thread_pool_cpu_relax();
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    __atomic_add_fetch(&pool->num_parked, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(flag, __ATOMIC_SEQ_CST) == value)
+        pthread_cond_wait(&pool->cond, &pool->mutex);
+    __atomic_sub_fetch(&pool->num_parked, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+
+
+// set *flag = value and wake up parked threads
+static void thread_pool_publish(acados_thread_pool *pool, int *flag, int value)
+{
+    __atomic_store_n(flag, value, __ATOMIC_SEQ_CST);
+    // NOTE: parked threads increment num_parked before checking the flag under the mutex,
+    // thus either they see the new value or they are woken up here.
+    if (__atomic_load_n(&pool->num_parked, __ATOMIC_SEQ_CST) > 0)
+    {
+        pthread_mutex_lock(&pool->mutex);
+        pthread_cond_broadcast(&pool->cond);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
+
+
+
+// sense reversing barrier over all threads of the pool
+static void thread_pool_barrier(acados_thread_pool *pool, int *local_sense)
+{
+    int sense = !*local_sense;
+    *local_sense = sense;
+
+    if (__atomic_add_fetch(&pool->barrier_count, 1, __ATOMIC_ACQ_REL) == pool->num_threads)
+    {
+        __atomic_store_n(&pool->barrier_count, 0, __ATOMIC_RELAXED);
+        thread_pool_publish(pool, &pool->barrier_sense, sense);
+    }
+    else
+    {
+        thread_pool_wait_while_equal(pool, &pool->barrier_sense, !sense);
+    }
+}
+
+
+
+static void thread_pool_execute(acados_thread_pool *pool, int id, int *local_sense)
+{
+    int num_threads = pool->num_threads;
+    // NOTE: the job is read before the first barrier, after the last one the calling thread
+    // may already be setting up the next run.
+    int num_phases = pool->num_phases;
+    acados_thread_pool_task task = pool->task;
+    void *ctx = pool->ctx;
+    double *task_time_job = pool->task_time;
+    double t0, t1;
+
+    for (int phase = 0; phase < num_phases; phase++)
+    {
+        int *bounds = pool->bounds + phase * (num_threads + 1);
+        double *task_time = task_time_job + phase * pool->max_tasks;
+
+        t0 = thread_pool_clock();
+        for (int i = bounds[id]; i < bounds[id+1]; i++)
+        {
+            task(ctx, phase, i);
+            t1 = thread_pool_clock();
+            task_time[i] = t1 - t0;
+            t0 = t1;
+        }
+        thread_pool_barrier(pool, local_sense);
+    }
+}
+
+
+
+static void *thread_pool_worker_main(void *worker_)
+{
+    acados_thread_pool_worker *worker = worker_;
+    acados_thread_pool *pool = worker->pool;
+
+    int generation = 0;
+    int local_sense = 0;
+
+    thread_pool_pin_to_core(pthread_self(), worker->core);
+
+    while (1)
+    {
+        thread_pool_wait_while_equal(pool, &pool->generation, generation);
+        generation = __atomic_load_n(&pool->generation, __ATOMIC_ACQUIRE);
+
+        if (__atomic_load_n(&pool->stop, __ATOMIC_ACQUIRE))
+            break;
+
+        thread_pool_execute(pool, worker->id, &local_sense);
+    }
+
+    return NULL;
+}
+
+
+
+// split the tasks of every phase in contiguous chunks of approximately equal measured time
+static void thread_pool_partition(acados_thread_pool *pool)
+{
+    int num_threads = pool->num_threads;
+    int num_tasks = pool->num_tasks;
+
+    for (int phase = 0; phase < pool->num_phases; phase++)
+    {
+        int *bounds = pool->bounds + phase * (num_threads + 1);
+        double *task_time = pool->task_time + phase * pool->max_tasks;
+
+        double total = 0.0;
+        for (int i = 0; i < num_tasks; i++)
+            total += task_time[i];
+
+        bounds[0] = 0;
+        bounds[num_threads] = num_tasks;
+
+        if (total <= 0.0)
+        {
+            // no measurements yet: uniform split
+            for (int t = 1; t < num_threads; t++)
+                bounds[t] = (t * num_tasks) / num_threads;
+            continue;
+        }
+
+        int i = 0;
+        double acc = 0.0;
+        for (int t = 1; t < num_threads; t++)
+        {
+            double target = (t * total) / num_threads;
+            // take task i if it brings the accumulated time closer to the target
+            while (i < num_tasks && acc + 0.5 * task_time[i] < target)
+            {
+                acc += task_time[i];
+                i++;
+            }
+            bounds[t] = i;
+        }
+    }
+}
+
+
+
+acados_thread_pool *acados_thread_pool_create(int num_threads, const int *cores, int spin_count,
+                                              int max_jobs, int max_tasks)
+{
+    if (num_threads < 1 || num_threads > ACADOS_THREAD_POOL_MAX_THREADS || max_jobs < 1 || max_tasks < 1)
+    {
+        printf("\nacados_thread_pool_create: invalid arguments: num_threads %d, max_jobs %d, max_tasks %d.\n",
+                num_threads, max_jobs, max_tasks);
+        return NULL;
+    }
+
+    acados_thread_pool *pool = calloc(1, sizeof(acados_thread_pool));
+    if (pool == NULL)
+        return NULL;
+
+    pool->num_threads = num_threads;
+    pool->spin_count = spin_count < 0 ? 0 : spin_count;
+    pool->max_jobs = max_jobs;
+    pool->max_tasks = max_tasks;
+
+    pool->bounds = calloc(ACADOS_THREAD_POOL_MAX_PHASES * (num_threads + 1), sizeof(int));
+    pool->task_time_all = calloc(max_jobs * ACADOS_THREAD_POOL_MAX_PHASES * max_tasks, sizeof(double));
+    pool->workers = calloc(num_threads, sizeof(acados_thread_pool_worker));
+    if (pool->bounds == NULL || pool->task_time_all == NULL || pool->workers == NULL)
+    {
+        free(pool->bounds);
+        free(pool->task_time_all);
+        free(pool->workers);
+        free(pool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->cond, NULL);
+
+    for (int t = 1; t < num_threads; t++)
+    {
+        acados_thread_pool_worker *worker = pool->workers + t;
+        worker->pool = pool;
+        worker->id = t;
+        worker->core = cores != NULL ? cores[t] : -1;
+        if (pthread_create(&worker->thread, NULL, thread_pool_worker_main, worker) != 0)
+        {
+            printf("\nacados_thread_pool_create: could not create worker thread %d.\n", t);
+            // shut down the workers created so far
+            pool->num_threads = t;
+            acados_thread_pool_destroy(pool);
+            return NULL;
+        }
+    }
+
+    return pool;
+}
+
+
+
+void acados_thread_pool_destroy(acados_thread_pool *pool)
+{
+    if (pool == NULL)
+        return;
+
+    __atomic_store_n(&pool->stop, 1, __ATOMIC_SEQ_CST);
+    thread_pool_publish(pool, &pool->generation, pool->generation + 1);
+
+    for (int t = 1; t < pool->num_threads; t++)
+        pthread_join(pool->workers[t].thread, NULL);
+
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->cond);
+
+    free(pool->bounds);
+    free(pool->task_time_all);
+    free(pool->workers);
+    free(pool);
+}
+
+
+
+int acados_thread_pool_get_num_threads(acados_thread_pool *pool)
+{
+    return pool->num_threads;
+}
+
+
+
+void acados_thread_pool_run(acados_thread_pool *pool, int job, int num_phases, int num_tasks,
+                            acados_thread_pool_task task, void *ctx)
+{
+    // empty job: nothing to do, do not wake the workers
+    if (num_phases <= 0 || num_tasks <= 0)
+        return;
+
+    if (job < 0 || job >= pool->max_jobs || num_phases > ACADOS_THREAD_POOL_MAX_PHASES
+        || num_tasks > pool->max_tasks || pool->num_threads == 1)
+    {
+        // not covered by the pool: run serially on the calling thread
+        for (int phase = 0; phase < num_phases; phase++)
+            for (int i = 0; i < num_tasks; i++)
+                task(ctx, phase, i);
+        return;
+    }
+
+    pool->task = task;
+    pool->ctx = ctx;
+    pool->num_phases = num_phases;
+    pool->num_tasks = num_tasks;
+    pool->task_time = pool->task_time_all + job * ACADOS_THREAD_POOL_MAX_PHASES * pool->max_tasks;
+
+    thread_pool_partition(pool);
+
+    // start workers, NOTE: only the calling thread writes the generation counter
+    thread_pool_publish(pool, &pool->generation, pool->generation + 1);
+
+    // the calling thread is thread 0; returns after the barrier of the last phase
+    thread_pool_execute(pool, 0, &pool->main_sense);
+}
+
+
+
+double acados_thread_pool_get_task_time(acados_thread_pool *pool, int job, int phase, int index)
+{
+    if (job < 0 || job >= pool->max_jobs || phase < 0 || phase >= ACADOS_THREAD_POOL_MAX_PHASES
+        || index < 0 || index >= pool->max_tasks)
+        return 0.0;
+    return pool->task_time_all[(job * ACADOS_THREAD_POOL_MAX_PHASES + phase) * pool->max_tasks + index];
+}
+
+
+
+
+/************************************************
+ * single background worker
+ ************************************************/
+
+struct acados_worker_
+{
+    pthread_t thread;
+    int core;
+    acados_worker_fun fun;
+    void *ctx;
+    int busy;  // fun started and not yet done
+    int stop;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+};
+
+
+
+static void *acados_worker_main(void *worker_)
+{
+    acados_worker *worker = worker_;
+
+    thread_pool_pin_to_core(pthread_self(), worker->core);
+
+    pthread_mutex_lock(&worker->mutex);
+    while (1)
+    {
+        while (!worker->busy && !worker->stop)
+            pthread_cond_wait(&worker->cond, &worker->mutex);
+        if (!worker->busy)
+            break;
+
+        pthread_mutex_unlock(&worker->mutex);
+        worker->fun(worker->ctx);
+        pthread_mutex_lock(&worker->mutex);
+
+        worker->busy = 0;
+        pthread_cond_broadcast(&worker->cond);
+    }
+    pthread_mutex_unlock(&worker->mutex);
+
+    return NULL;
+}
+
+
+
+acados_worker *acados_worker_create(int core)
+{
+    acados_worker *worker = calloc(1, sizeof(acados_worker));
+    if (worker == NULL)
+        return NULL;
+
+    worker->core = core;
+    pthread_mutex_init(&worker->mutex, NULL);
+    pthread_cond_init(&worker->cond, NULL);
+
+    if (pthread_create(&worker->thread, NULL, acados_worker_main, worker) != 0)
+    {
+        printf("\nacados_worker_create: could not create worker thread.\n");
+        pthread_mutex_destroy(&worker->mutex);
+        pthread_cond_destroy(&worker->cond);
+        free(worker);
+        return NULL;
+    }
+
+    return worker;
+}
+
+
+
+void acados_worker_destroy(acados_worker *worker)
+{
+    if (worker == NULL)
+        return;
+
+    pthread_mutex_lock(&worker->mutex);
+    worker->stop = 1;
+    pthread_cond_broadcast(&worker->cond);
+    pthread_mutex_unlock(&worker->mutex);
+    // a running function is finished first
+    pthread_join(worker->thread, NULL);
+
+    pthread_mutex_destroy(&worker->mutex);
+    pthread_cond_destroy(&worker->cond);
+    free(worker);
+}
+
+
+
+void acados_worker_start(acados_worker *worker, acados_worker_fun fun, void *ctx)
+{
+    pthread_mutex_lock(&worker->mutex);
+    while (worker->busy)
+        pthread_cond_wait(&worker->cond, &worker->mutex);
+    worker->fun = fun;
+    worker->ctx = ctx;
+    worker->busy = 1;
+    pthread_cond_broadcast(&worker->cond);
+    pthread_mutex_unlock(&worker->mutex);
+}
+
+
+
+int acados_worker_wait(acados_worker *worker)
+{
+    int was_busy = 0;
+
+    pthread_mutex_lock(&worker->mutex);
+    if (worker->busy)
+    {
+        was_busy = 1;
+        while (worker->busy)
+            pthread_cond_wait(&worker->cond, &worker->mutex);
+    }
+    pthread_mutex_unlock(&worker->mutex);
+
+    return was_busy;
+}
+
+#endif  // ACADOS_WITH_THREAD_POOL
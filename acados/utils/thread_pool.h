@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#ifndef ACADOS_UTILS_THREAD_POOL_H_
+#define ACADOS_UTILS_THREAD_POOL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Persistent worker pool for stage-parallel evaluations.
+// Compiled in with ACADOS_WITH_THREAD_POOL (POSIX threads only).
+//
+// A job consists of num_phases phases over the same num_tasks tasks (e.g. stages).
+// Within a phase, tasks are distributed to the threads in contiguous chunks;
+// phases are separated by a spin/park barrier. The calling thread takes part
+// as thread 0. The execution time of every task is recorded and used to
+// balance the chunks in the next run of the same job.
+
+#define ACADOS_THREAD_POOL_MAX_THREADS 64
+#define ACADOS_THREAD_POOL_MAX_PHASES 4
+#define ACADOS_THREAD_POOL_DEFAULT_SPIN_COUNT 20000
+
+typedef struct acados_thread_pool_ acados_thread_pool;
+
+// task executed for every (phase, index) pair of a job
+typedef void (*acados_thread_pool_task)(void *ctx, int phase, int index);
+
+// creates num_threads-1 workers; cores (length num_threads or NULL) are the cpu ids
+// the workers are pinned to, -1 means no pinning. cores[0] refers to the calling thread, which is
+// not pinned by the pool, since that would change the affinity of the application thread.
+// returns NULL if the pool could not be created.
+acados_thread_pool *acados_thread_pool_create(int num_threads, const int *cores, int spin_count,
+                                              int max_jobs, int max_tasks);
+//
+void acados_thread_pool_destroy(acados_thread_pool *pool);
+//
+int acados_thread_pool_get_num_threads(acados_thread_pool *pool);
+// runs the job, blocks until all tasks of all phases are done; returns immediately for an empty job
+void acados_thread_pool_run(acados_thread_pool *pool, int job, int num_phases, int num_tasks,
+                            acados_thread_pool_task task, void *ctx);
+// execution time of a task in the last run of a job [s]
+double acados_thread_pool_get_task_time(acados_thread_pool *pool, int job, int phase, int index);
+
+
+
+// Single background worker, running one function at a time asynchronously to the calling thread,
+// e.g. the RTI preparation phase while the caller waits for the next sample.
+
+typedef struct acados_worker_ acados_worker;
+
+typedef void (*acados_worker_fun)(void *ctx);
+
+// core: cpu id the worker is pinned to, -1 means no pinning; returns NULL if the thread could not be created.
+acados_worker *acados_worker_create(int core);
+// waits for a running function
+void acados_worker_destroy(acados_worker *worker);
+// runs fun(ctx) on the worker and returns immediately, waits for a running function first
+void acados_worker_start(acados_worker *worker, acados_worker_fun fun, void *ctx);
+// blocks until the last started function is done, returns 1 if it was still running, 0 otherwise
+int acados_worker_wait(acados_worker *worker);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // ACADOS_UTILS_THREAD_POOL_H_
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// standard
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+// bench
+#include "bench/bench_utils.h"
+
+
+
+static void print_usage(const char *name)
+{
+    printf("usage: %s [-n reps] [-w warmup] [-f filter] [-o results.json]\n\n", name);
+    printf("  -n reps      number of timed repetitions per benchmark (default 100)\n");
+    printf("  -w warmup    number of untimed repetitions per benchmark (default 10)\n");
+    printf("  -f filter    only run benchmarks whose name contains filter, e.g. sim/ or qp/\n");
+    printf("  -o file      write results as JSON to file\n");
+}
+
+
+
+int main(int argc, char **argv)
+{
+    int reps = 100;
+    int warmup = 10;
+    const char *filter = NULL;
+    const char *json_file = NULL;
+
+    for (int ii = 1; ii < argc; ii++)
+    {
+        if (!strcmp(argv[ii], "-h") || !strcmp(argv[ii], "--help"))
+        {
+            print_usage(argv[0]);
+            return 0;
+        }
+        else if (ii + 1 < argc && !strcmp(argv[ii], "-n"))
+        {
+            reps = atoi(argv[++ii]);
+        }
+        else if (ii + 1 < argc && !strcmp(argv[ii], "-w"))
+        {
+            warmup = atoi(argv[++ii]);
+        }
+        else if (ii + 1 < argc && !strcmp(argv[ii], "-f"))
+        {
+            filter = argv[++ii];
+        }
+        else if (ii + 1 < argc && !strcmp(argv[ii], "-o"))
+        {
+            json_file = argv[++ii];
+        }
+        else
+        {
+            printf("\nerror: acados_bench: unknown argument %s\n\n", argv[ii]);
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    FILE *json = NULL;
+    if (json_file != NULL)
+    {
+        json = fopen(json_file, "w");
+        if (json == NULL)
+        {
+            printf("\nerror: acados_bench: cannot open %s\n", json_file);
+            return 1;
+        }
+    }
+
+    bench_suite suite;
+    bench_suite_init(&suite, reps, warmup, filter, json);
+    bench_suite_begin(&suite);
+
+    bench_sim(&suite);
+    bench_ocp_qp(&suite);
+    bench_ocp_nlp(&suite);
+
+    bench_suite_end(&suite);
+
+    printf("\n%d benchmarks, %d with nonzero status\n", suite.num_results, suite.num_failed);
+    if (json != NULL)
+    {
+        printf("results written to %s\n", json_file);
+        fclose(json);
+    }
+
+    bench_suite_free(&suite);
+
+    return 0;
+}
@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// standard
+#include <stdio.h>
+#include <stdlib.h>
+// blasfeo
+#include "blasfeo_d_aux.h"
+// acados
+#include "acados/ocp_nlp/ocp_nlp_common.h"
+#include "acados_c/external_function_interface.h"
+#include "acados_c/ocp_nlp_interface.h"
+// models
+#include "examples/c/chain_model/chain_model.h"
+#include "examples/c/chain_model/x0_nm3.c"
+#include "examples/c/chain_model/xN_nm3.c"
+// bench
+#include "bench/bench_utils.h"
+
+// chain with 3 masses (2 free), as in examples/c/nonlinear_chain_ocp_nlp.c
+#define BENCH_NLP_NMF 2
+#define BENCH_NLP_NX 12
+#define BENCH_NLP_NU 3
+#define BENCH_NLP_N 15
+#define BENCH_NLP_TF 3.75
+
+
+
+typedef struct
+{
+    ocp_nlp_plan_t *plan;
+    ocp_nlp_config *config;
+    ocp_nlp_dims *dims;
+    ocp_nlp_in *nlp_in;
+    ocp_nlp_out *nlp_out;
+    void *nlp_opts;
+    ocp_nlp_solver *solver;
+    external_function_casadi *expl_vde_for;
+} bench_nlp_data;
+
+
+
+static void bench_nlp_reset(void *data_)
+{
+    bench_nlp_data *data = data_;
+    ocp_nlp_dims *dims = data->dims;
+    ocp_nlp_out *nlp_out = data->nlp_out;
+    int N = dims->N;
+
+    // same initial guess for every call: u = 0, x = xN, zero multipliers
+    for (int ii = 0; ii <= N; ii++)
+    {
+        blasfeo_dvecse(dims->nu[ii], 0.0, nlp_out->ux + ii, 0);
+        blasfeo_pack_dvec(dims->nx[ii], xN_nm3, 1, nlp_out->ux + ii, dims->nu[ii]);
+        blasfeo_dvecse(2 * dims->ni[ii], 0.0, nlp_out->lam + ii, 0);
+    }
+    for (int ii = 0; ii < N; ii++)
+        blasfeo_dvecse(dims->nx[ii + 1], 0.0, nlp_out->pi + ii, 0);
+}
+
+
+
+static int bench_nlp_run(void *data_)
+{
+    bench_nlp_data *data = data_;
+    return ocp_nlp_solve(data->solver, data->nlp_in, data->nlp_out);
+}
+
+
+
+static void bench_nlp_chain(bench_suite *suite, ocp_nlp_solver_t nlp_solver, const char *solver_name)
+{
+    char name[MAX_STR_LEN];
+    snprintf(name, sizeof(name), "nlp/chain_nm3/%s", solver_name);
+    if (!bench_enabled(suite, name))
+        return;
+
+    const int N = BENCH_NLP_N;
+    const int NX = BENCH_NLP_NX;
+    const int NU = BENCH_NLP_NU;
+    const int NMF = BENCH_NLP_NMF;
+    const double umax = 10.0;
+    const double wall_pos = -0.01;
+    const double x_pos_inf = 1e4;
+
+    bench_nlp_data data;
+
+    /* plan & config */
+    data.plan = ocp_nlp_plan_create(N);
+    ocp_nlp_plan_t *plan = data.plan;
+    plan->nlp_solver = nlp_solver;
+    plan->regularization = NO_REGULARIZE;
+    plan->ocp_qp_solver_plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+    for (int ii = 0; ii <= N; ii++)
+    {
+        plan->nlp_cost[ii] = LINEAR_LS;
+        plan->nlp_constraints[ii] = BGH;
+    }
+    for (int ii = 0; ii < N; ii++)
+    {
+        plan->nlp_dynamics[ii] = CONTINUOUS_MODEL;
+        plan->sim_solver_plan[ii].sim_solver = ERK;
+    }
+    data.config = ocp_nlp_config_create(*plan);
+    ocp_nlp_config *config = data.config;
+
+    /* dims */
+    int nx[BENCH_NLP_N + 1];
+    int nu[BENCH_NLP_N + 1];
+    int nz[BENCH_NLP_N + 1];
+    int ns[BENCH_NLP_N + 1];
+    int ny[BENCH_NLP_N + 1];
+    int nbx[BENCH_NLP_N + 1];
+    int nbu[BENCH_NLP_N + 1];
+    int zero = 0;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        nx[ii] = NX;
+        nu[ii] = ii < N ? NU : 0;
+        nz[ii] = 0;
+        ns[ii] = 0;
+        ny[ii] = nx[ii] + nu[ii];
+        nbu[ii] = nu[ii];
+        nbx[ii] = ii == 0 ? NX : (ii < N ? NMF : 0);
+    }
+
+    data.dims = ocp_nlp_dims_create(config);
+    ocp_nlp_dims *dims = data.dims;
+    ocp_nlp_dims_set_opt_vars(config, dims, "nx", nx);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nu", nu);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nz", nz);
+    ocp_nlp_dims_set_opt_vars(config, dims, "ns", ns);
+    for (int ii = 0; ii <= N; ii++)
+    {
+        ocp_nlp_dims_set_cost(config, dims, ii, "ny", &ny[ii]);
+        ocp_nlp_dims_set_constraints(config, dims, ii, "nbx", &nbx[ii]);
+        ocp_nlp_dims_set_constraints(config, dims, ii, "nbu", &nbu[ii]);
+        ocp_nlp_dims_set_constraints(config, dims, ii, "ng", &zero);
+        ocp_nlp_dims_set_constraints(config, dims, ii, "nh", &zero);
+    }
+
+    /* dynamics */
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+    ext_fun_opts.external_workspace = false;
+
+    data.expl_vde_for = malloc(N * sizeof(external_function_casadi));
+    for (int ii = 0; ii < N; ii++)
+        BENCH_CASADI_CREATE(&data.expl_vde_for[ii], vde_chain_nm3, &ext_fun_opts);
+
+    data.nlp_in = ocp_nlp_in_create(config, dims);
+    data.nlp_out = ocp_nlp_out_create(config, dims);
+    ocp_nlp_in *nlp_in = data.nlp_in;
+    ocp_nlp_out *nlp_out = data.nlp_out;
+
+    double Ts = BENCH_NLP_TF / N;
+    for (int ii = 0; ii < N; ii++)
+    {
+        ocp_nlp_in_set(config, dims, nlp_in, ii, "Ts", &Ts);
+        ocp_nlp_dynamics_model_set(config, dims, nlp_in, ii, "expl_vde_for", &data.expl_vde_for[ii]);
+    }
+
+    /* cost: y = [x; u], tracking of the resting position */
+    double Cyt[(BENCH_NLP_NX + BENCH_NLP_NU) * (BENCH_NLP_NX + BENCH_NLP_NU)] = {0};
+    double W[(BENCH_NLP_NX + BENCH_NLP_NU) * (BENCH_NLP_NX + BENCH_NLP_NU)] = {0};
+    double yref[BENCH_NLP_NX + BENCH_NLP_NU] = {0};
+
+    for (int jj = 0; jj < NU; jj++)
+        Cyt[jj + (NX + NU) * (jj + NX)] = 1.0;
+    for (int jj = 0; jj < NX; jj++)
+        Cyt[NU + jj + (NX + NU) * jj] = 1.0;
+    for (int jj = 0; jj < NX; jj++)
+        W[jj + (NX + NU) * jj] = 1e-2;
+    for (int jj = 0; jj < NU; jj++)
+        W[NX + jj + (NX + NU) * (NX + jj)] = 1.0;
+    for (int jj = 0; jj < NX; jj++)
+        yref[jj] = xN_nm3[jj];
+
+    double CytN[BENCH_NLP_NX * BENCH_NLP_NX] = {0};
+    double WN[BENCH_NLP_NX * BENCH_NLP_NX] = {0};
+    for (int jj = 0; jj < NX; jj++)
+    {
+        CytN[jj * (NX + 1)] = 1.0;
+        WN[jj * (NX + 1)] = 1e-2;
+    }
+
+    for (int ii = 0; ii < N; ii++)
+    {
+        ocp_nlp_cost_model_set(config, dims, nlp_in, ii, "Cyt", Cyt);
+        ocp_nlp_cost_model_set(config, dims, nlp_in, ii, "W", W);
+        ocp_nlp_cost_model_set(config, dims, nlp_in, ii, "yref", yref);
+    }
+    ocp_nlp_cost_model_set(config, dims, nlp_in, N, "Cyt", CytN);
+    ocp_nlp_cost_model_set(config, dims, nlp_in, N, "W", WN);
+    ocp_nlp_cost_model_set(config, dims, nlp_in, N, "yref", yref);
+
+    /* constraints: input bounds, initial state, wall on the y positions of the free masses */
+    int idxbu[BENCH_NLP_NU];
+    double lbu[BENCH_NLP_NU];
+    double ubu[BENCH_NLP_NU];
+    for (int jj = 0; jj < NU; jj++)
+    {
+        idxbu[jj] = jj;
+        lbu[jj] = -umax;
+        ubu[jj] = umax;
+    }
+
+    int idxbx0[BENCH_NLP_NX];
+    for (int jj = 0; jj < NX; jj++)
+        idxbx0[jj] = jj;
+
+    int idxbx[BENCH_NLP_NMF];
+    double lbx[BENCH_NLP_NMF];
+    double ubx[BENCH_NLP_NMF];
+    for (int jj = 0; jj < NMF; jj++)
+    {
+        idxbx[jj] = 6 * jj + 1;
+        lbx[jj] = wall_pos;
+        ubx[jj] = x_pos_inf;
+    }
+
+    for (int ii = 0; ii < N; ii++)
+    {
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, ii, "idxbu", idxbu);
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, ii, "lbu", lbu);
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, ii, "ubu", ubu);
+    }
+    ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, 0, "idxbx", idxbx0);
+    ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, 0, "lbx", x0_nm3);
+    ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, 0, "ubx", x0_nm3);
+    for (int ii = 1; ii < N; ii++)
+    {
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, ii, "idxbx", idxbx);
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, ii, "lbx", lbx);
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, ii, "ubx", ubx);
+    }
+
+    /* opts */
+    data.nlp_opts = ocp_nlp_solver_opts_create(config, dims);
+    int ns_erk = 4;
+    for (int ii = 0; ii < N; ii++)
+        ocp_nlp_solver_opts_set_at_stage(config, data.nlp_opts, ii, "dynamics_ns", &ns_erk);
+
+    if (nlp_solver == SQP)
+    {
+        int max_iter = 20;
+        double tol = 1e-8;
+        ocp_nlp_solver_opts_set(config, data.nlp_opts, "max_iter", &max_iter);
+        ocp_nlp_solver_opts_set(config, data.nlp_opts, "tol_stat", &tol);
+        ocp_nlp_solver_opts_set(config, data.nlp_opts, "tol_eq", &tol);
+        ocp_nlp_solver_opts_set(config, data.nlp_opts, "tol_ineq", &tol);
+        ocp_nlp_solver_opts_set(config, data.nlp_opts, "tol_comp", &tol);
+    }
+
+    /* solver */
+    data.solver = ocp_nlp_solver_create(config, dims, data.nlp_opts, nlp_in);
+    ocp_nlp_precompute(data.solver, nlp_in, nlp_out);
+
+    bench_run(suite, name, &data, &bench_nlp_reset, &bench_nlp_run);
+
+    /* free */
+    ocp_nlp_solver_destroy(data.solver);
+    ocp_nlp_solver_opts_destroy(data.nlp_opts);
+    ocp_nlp_out_destroy(data.nlp_out);
+    ocp_nlp_in_destroy(data.nlp_in);
+    external_function_casadi_free_array(N, data.expl_vde_for);
+    free(data.expl_vde_for);
+    ocp_nlp_dims_destroy(data.dims);
+    ocp_nlp_config_destroy(data.config);
+    ocp_nlp_plan_destroy(data.plan);
+}
+
+
+
+void bench_ocp_nlp(bench_suite *suite)
+{
+    bench_nlp_chain(suite, SQP, "SQP");
+    bench_nlp_chain(suite, SQP_RTI, "SQP_RTI");
+}
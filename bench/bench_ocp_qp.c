@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// standard
+#include <stdio.h>
+#include <stdlib.h>
+// blasfeo
+#include "blasfeo_d_aux.h"
+// acados
+#include "acados/ocp_nlp/ocp_nlp_reg_common.h"
+#include "acados/ocp_nlp/ocp_nlp_reg_convexify.h"
+#include "acados/ocp_nlp/ocp_nlp_reg_glm.h"
+#include "acados/ocp_nlp/ocp_nlp_reg_mirror.h"
+#include "acados/ocp_nlp/ocp_nlp_reg_project.h"
+#include "acados/ocp_nlp/ocp_nlp_reg_project_reduc_hess.h"
+#include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/ocp_qp/ocp_qp_xcond_solver.h"
+#include "acados_c/ocp_qp_interface.h"
+// bench
+#include "bench/bench_utils.h"
+
+// mass spring test problem, see examples/c/no_interface_examples/mass_spring_model
+ocp_qp_xcond_solver_dims *create_ocp_qp_dims_mass_spring(ocp_qp_xcond_solver_config *config, int N,
+                                                         int nx_, int nu_, int nb_, int ng_, int ngN);
+ocp_qp_in *create_ocp_qp_in_mass_spring(ocp_qp_dims *dims);
+
+// problem size, as in the QP solver unit test but with a longer horizon
+#define BENCH_QP_N 20
+#define BENCH_QP_NX 8
+#define BENCH_QP_NU 3
+#define BENCH_QP_NB 11
+#define BENCH_QP_N2 5
+
+
+
+typedef struct
+{
+    ocp_qp_xcond_solver_config *config;
+    ocp_qp_xcond_solver_dims *dims;
+    ocp_qp_in *qp_in;
+    ocp_qp_out *qp_out;
+    void *opts;
+    ocp_qp_solver *solver;
+} bench_qp_data;
+
+
+
+typedef struct
+{
+    ocp_nlp_reg_config *config;
+    ocp_nlp_reg_dims *dims;
+    void *opts;
+    void *mem;
+    ocp_qp_in *qp_in;       // regularized in place
+    ocp_qp_in *qp_in_orig;  // restored before every call
+    ocp_qp_out *qp_out;
+} bench_reg_data;
+
+
+
+/************************************************
+ * qp solvers
+ ************************************************/
+
+static void bench_qp_setup(bench_qp_data *data, ocp_qp_solver_t qp_solver, int N2)
+{
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = qp_solver;
+
+    data->config = ocp_qp_xcond_solver_config_create(plan);
+    data->dims = create_ocp_qp_dims_mass_spring(data->config, BENCH_QP_N, BENCH_QP_NX, BENCH_QP_NU,
+                                                BENCH_QP_NB, 0, 0);
+    data->qp_in = create_ocp_qp_in_mass_spring(data->dims->orig_dims);
+    data->qp_out = ocp_qp_out_create(data->dims->orig_dims);
+
+    data->opts = ocp_qp_xcond_solver_opts_create(data->config, data->dims);
+    if (N2 > 0)
+        ocp_qp_xcond_solver_opts_set(data->config, data->opts, "cond_N", &N2);
+
+    data->solver = ocp_qp_create(data->config, data->dims, data->opts);
+}
+
+
+
+static void bench_qp_free(bench_qp_data *data)
+{
+    ocp_qp_solver_destroy(data->solver);
+    ocp_qp_xcond_solver_opts_free(data->opts);
+    ocp_qp_out_free(data->qp_out);
+    ocp_qp_in_free(data->qp_in);
+    ocp_qp_xcond_solver_dims_free(data->dims);
+    ocp_qp_xcond_solver_config_free(data->config);
+}
+
+
+
+static int bench_qp_solve(void *data_)
+{
+    bench_qp_data *data = data_;
+    return ocp_qp_solve(data->solver, data->qp_in, data->qp_out);
+}
+
+
+
+static void bench_qp_solver(bench_suite *suite, ocp_qp_solver_t qp_solver, const char *solver_name,
+                            int N2)
+{
+    char name[MAX_STR_LEN];
+    if (N2 > 0)
+        snprintf(name, sizeof(name), "qp/mass_spring/%s/N2=%d", solver_name, N2);
+    else
+        snprintf(name, sizeof(name), "qp/mass_spring/%s", solver_name);
+    if (!bench_enabled(suite, name))
+        return;
+
+    bench_qp_data data;
+    bench_qp_setup(&data, qp_solver, N2);
+    bench_run(suite, name, &data, NULL, &bench_qp_solve);
+    bench_qp_free(&data);
+}
+
+
+
+/************************************************
+ * condensing
+ ************************************************/
+
+static int bench_cond_condensing(void *data_)
+{
+    bench_qp_data *data = data_;
+    ocp_qp_xcond_config *xcond = data->config->xcond;
+    ocp_qp_xcond_solver_opts *opts = data->opts;
+    ocp_qp_xcond_solver_memory *mem = data->solver->mem;
+    ocp_qp_xcond_solver_workspace *work = data->solver->work;
+    return xcond->condensing(data->qp_in, mem->xcond_qp_in, opts->xcond_opts, mem->xcond_memory,
+                             work->xcond_work);
+}
+
+
+
+static int bench_cond_condense_lhs(void *data_)
+{
+    bench_qp_data *data = data_;
+    ocp_qp_xcond_config *xcond = data->config->xcond;
+    ocp_qp_xcond_solver_opts *opts = data->opts;
+    ocp_qp_xcond_solver_memory *mem = data->solver->mem;
+    ocp_qp_xcond_solver_workspace *work = data->solver->work;
+    return xcond->condense_lhs(data->qp_in, mem->xcond_qp_in, opts->xcond_opts, mem->xcond_memory,
+                               work->xcond_work);
+}
+
+
+
+static int bench_cond_condense_rhs(void *data_)
+{
+    bench_qp_data *data = data_;
+    ocp_qp_xcond_config *xcond = data->config->xcond;
+    ocp_qp_xcond_solver_opts *opts = data->opts;
+    ocp_qp_xcond_solver_memory *mem = data->solver->mem;
+    ocp_qp_xcond_solver_workspace *work = data->solver->work;
+    return xcond->condense_rhs(data->qp_in, mem->xcond_qp_in, opts->xcond_opts, mem->xcond_memory,
+                               work->xcond_work);
+}
+
+
+
+static int bench_cond_expansion(void *data_)
+{
+    bench_qp_data *data = data_;
+    ocp_qp_xcond_config *xcond = data->config->xcond;
+    ocp_qp_xcond_solver_opts *opts = data->opts;
+    ocp_qp_xcond_solver_memory *mem = data->solver->mem;
+    ocp_qp_xcond_solver_workspace *work = data->solver->work;
+    return xcond->expansion(mem->xcond_qp_out, data->qp_out, opts->xcond_opts, mem->xcond_memory,
+                            work->xcond_work);
+}
+
+
+
+static void bench_cond(bench_suite *suite, ocp_qp_solver_t qp_solver, const char *cond_name, int N2)
+{
+    const char *parts[4] = {"condensing", "condense_lhs", "condense_rhs", "expansion"};
+    bench_run_fun runs[4] = {&bench_cond_condensing, &bench_cond_condense_lhs,
+                             &bench_cond_condense_rhs, &bench_cond_expansion};
+
+    char names[4][MAX_STR_LEN];
+    bool any_enabled = false;
+    for (int ii = 0; ii < 4; ii++)
+    {
+        snprintf(names[ii], MAX_STR_LEN, "cond/mass_spring/%s/%s", cond_name, parts[ii]);
+        any_enabled = any_enabled || bench_enabled(suite, names[ii]);
+    }
+    if (!any_enabled)
+        return;
+
+    bench_qp_data data;
+    bench_qp_setup(&data, qp_solver, N2);
+    // one solve to set up the condensing workspace and the condensed qp
+    bench_qp_solve(&data);
+
+    for (int ii = 0; ii < 4; ii++)
+        bench_run(suite, names[ii], &data, NULL, runs[ii]);
+
+    bench_qp_free(&data);
+}
+
+
+
+/************************************************
+ * regularization
+ ************************************************/
+
+static void bench_reg_reset(void *data_)
+{
+    bench_reg_data *data = data_;
+    ocp_qp_in *qp_in = data->qp_in;
+    ocp_qp_in *qp_orig = data->qp_in_orig;
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *ns = qp_in->dim->ns;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        blasfeo_dgecp(nu[ii] + nx[ii] + 1, nu[ii] + nx[ii], qp_orig->RSQrq + ii, 0, 0,
+                      qp_in->RSQrq + ii, 0, 0);
+        blasfeo_dveccp(nu[ii] + nx[ii] + 2 * ns[ii], qp_orig->rqz + ii, 0, qp_in->rqz + ii, 0);
+    }
+    for (int ii = 0; ii < N; ii++)
+    {
+        blasfeo_dgecp(nu[ii] + nx[ii] + 1, nx[ii + 1], qp_orig->BAbt + ii, 0, 0,
+                      qp_in->BAbt + ii, 0, 0);
+        blasfeo_dveccp(nx[ii + 1], qp_orig->b + ii, 0, qp_in->b + ii, 0);
+    }
+}
+
+
+
+static int bench_reg_run(void *data_)
+{
+    bench_reg_data *data = data_;
+    data->config->regularize(data->config, data->dims, data->opts, data->mem);
+    return ACADOS_SUCCESS;
+}
+
+
+
+static void bench_reg(bench_suite *suite, void (*config_initialize_default)(ocp_nlp_reg_config *),
+                      const char *reg_name)
+{
+    char name[MAX_STR_LEN];
+    snprintf(name, sizeof(name), "reg/mass_spring/%s", reg_name);
+    if (!bench_enabled(suite, name))
+        return;
+
+    // the qp solver is only used to build the test problem
+    bench_qp_data qp;
+    bench_qp_setup(&qp, PARTIAL_CONDENSING_HPIPM, 0);
+
+    bench_reg_data data;
+    data.qp_in = qp.qp_in;
+    data.qp_out = qp.qp_out;
+    data.qp_in_orig = create_ocp_qp_in_mass_spring(qp.dims->orig_dims);
+
+    ocp_qp_dims *qp_dims = qp.dims->orig_dims;
+    int N = qp_dims->N;
+
+    // make the state hessian indefinite, so that every module has work to do
+    for (int ii = 0; ii <= N; ii++)
+        blasfeo_ddiare(qp_dims->nx[ii], -1.5, data.qp_in_orig->RSQrq + ii, qp_dims->nu[ii],
+                       qp_dims->nu[ii]);
+
+    // config
+    void *config_mem = calloc(1, ocp_nlp_reg_config_calculate_size());
+    data.config = ocp_nlp_reg_config_assign(config_mem);
+    config_initialize_default(data.config);
+    ocp_nlp_reg_config *config = data.config;
+
+    // dims
+    void *dims_mem = calloc(1, config->dims_calculate_size(N));
+    data.dims = config->dims_assign(N, dims_mem);
+    for (int ii = 0; ii <= N; ii++)
+    {
+        config->dims_set(config, data.dims, ii, "nx", &qp_dims->nx[ii]);
+        config->dims_set(config, data.dims, ii, "nu", &qp_dims->nu[ii]);
+        config->dims_set(config, data.dims, ii, "nbu", &qp_dims->nbu[ii]);
+        config->dims_set(config, data.dims, ii, "nbx", &qp_dims->nbx[ii]);
+        config->dims_set(config, data.dims, ii, "ng", &qp_dims->ng[ii]);
+    }
+
+    // opts
+    void *opts_mem = calloc(1, config->opts_calculate_size());
+    data.opts = config->opts_assign(opts_mem);
+    config->opts_initialize_default(config, data.dims, data.opts);
+
+    // memory
+    void *mem_mem = calloc(1, config->memory_calculate_size(config, data.dims, data.opts));
+    data.mem = config->memory_assign(config, data.dims, data.opts, mem_mem);
+
+    config->memory_set_RSQrq_ptr(data.dims, data.qp_in->RSQrq, data.mem);
+    config->memory_set_rq_ptr(data.dims, data.qp_in->rqz, data.mem);
+    config->memory_set_BAbt_ptr(data.dims, data.qp_in->BAbt, data.mem);
+    config->memory_set_b_ptr(data.dims, data.qp_in->b, data.mem);
+    config->memory_set_idxb_ptr(data.dims, data.qp_in->idxb, data.mem);
+    config->memory_set_DCt_ptr(data.dims, data.qp_in->DCt, data.mem);
+    config->memory_set_ux_ptr(data.dims, data.qp_out->ux, data.mem);
+    config->memory_set_pi_ptr(data.dims, data.qp_out->pi, data.mem);
+    config->memory_set_lam_ptr(data.dims, data.qp_out->lam, data.mem);
+
+    bench_run(suite, name, &data, &bench_reg_reset, &bench_reg_run);
+
+    free(mem_mem);
+    free(opts_mem);
+    free(dims_mem);
+    free(config_mem);
+    ocp_qp_in_free(data.qp_in_orig);
+    bench_qp_free(&qp);
+}
+
+
+
+/************************************************
+ * all
+ ************************************************/
+
+void bench_ocp_qp(bench_suite *suite)
+{
+    // qp solvers, all available backends through ocp_qp_xcond_solver
+    bench_qp_solver(suite, PARTIAL_CONDENSING_HPIPM, "PARTIAL_CONDENSING_HPIPM", BENCH_QP_N);
+    bench_qp_solver(suite, PARTIAL_CONDENSING_HPIPM, "PARTIAL_CONDENSING_HPIPM", BENCH_QP_N2);
+    bench_qp_solver(suite, FULL_CONDENSING_HPIPM, "FULL_CONDENSING_HPIPM", 0);
+#ifdef ACADOS_WITH_HPMPC
+    bench_qp_solver(suite, PARTIAL_CONDENSING_HPMPC, "PARTIAL_CONDENSING_HPMPC", BENCH_QP_N);
+#endif
+#ifdef ACADOS_WITH_QPOASES
+    bench_qp_solver(suite, FULL_CONDENSING_QPOASES, "FULL_CONDENSING_QPOASES", 0);
+#endif
+#ifdef ACADOS_WITH_DAQP
+    bench_qp_solver(suite, FULL_CONDENSING_DAQP, "FULL_CONDENSING_DAQP", 0);
+#endif
+#ifdef ACADOS_WITH_QPDUNES
+    bench_qp_solver(suite, PARTIAL_CONDENSING_QPDUNES, "PARTIAL_CONDENSING_QPDUNES", BENCH_QP_N);
+#endif
+#ifdef ACADOS_WITH_OOQP
+    bench_qp_solver(suite, PARTIAL_CONDENSING_OOQP, "PARTIAL_CONDENSING_OOQP", BENCH_QP_N);
+    bench_qp_solver(suite, FULL_CONDENSING_OOQP, "FULL_CONDENSING_OOQP", 0);
+#endif
+#ifdef ACADOS_WITH_OSQP
+    bench_qp_solver(suite, PARTIAL_CONDENSING_OSQP, "PARTIAL_CONDENSING_OSQP", BENCH_QP_N);
+#endif
+#ifdef ACADOS_WITH_QORE
+    bench_qp_solver(suite, FULL_CONDENSING_QORE, "FULL_CONDENSING_QORE", 0);
+#endif
+#ifdef ACADOS_WITH_CLARABEL
+    bench_qp_solver(suite, PARTIAL_CONDENSING_CLARABEL, "PARTIAL_CONDENSING_CLARABEL", BENCH_QP_N);
+#endif
+
+    // condensing modules
+    bench_cond(suite, PARTIAL_CONDENSING_HPIPM, "partial_N2=5", BENCH_QP_N2);
+    bench_cond(suite, FULL_CONDENSING_HPIPM, "full", 0);
+
+    // regularization modules
+    bench_reg(suite, &ocp_nlp_reg_mirror_config_initialize_default, "MIRROR");
+    bench_reg(suite, &ocp_nlp_reg_project_config_initialize_default, "PROJECT");
+    bench_reg(suite, &ocp_nlp_reg_project_reduc_hess_config_initialize_default, "PROJECT_REDUC_HESS");
+    bench_reg(suite, &ocp_nlp_reg_convexify_config_initialize_default, "CONVEXIFY");
+    bench_reg(suite, &ocp_nlp_reg_glm_config_initialize_default, "GERSHGORIN_LEVENBERG_MARQUARDT");
+}
@@ -0,0 +1,463 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+// Replays QPs captured with ocp_nlp_qp_capture_start (see acados/ocp_qp/ocp_qp_capture.h)
+// against the available QP solvers and reports the timing distribution over the captured QPs.
+
+// standard
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+// acados
+#include "acados/ocp_qp/ocp_qp_capture.h"
+#include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/ocp_qp/ocp_qp_xcond_solver.h"
+#include "acados_c/ocp_qp_interface.h"
+// bench
+#include "bench/bench_utils.h"
+
+#define REPLAY_MAX_SOLVERS 32
+#define REPLAY_MAX_FILES 256
+#define REPLAY_N2_DEFAULT 5
+
+
+
+typedef struct
+{
+    const char *name;
+    ocp_qp_solver_t qp_solver;
+    int partial;  // uses cond_N
+} replay_solver_entry;
+
+static const replay_solver_entry replay_solver_table[] = {
+    {"PARTIAL_CONDENSING_HPIPM", PARTIAL_CONDENSING_HPIPM, 1},
+    {"FULL_CONDENSING_HPIPM", FULL_CONDENSING_HPIPM, 0},
+#ifdef ACADOS_WITH_HPMPC
+    {"PARTIAL_CONDENSING_HPMPC", PARTIAL_CONDENSING_HPMPC, 1},
+#endif
+#ifdef ACADOS_WITH_QPOASES
+    {"FULL_CONDENSING_QPOASES", FULL_CONDENSING_QPOASES, 0},
+#endif
+#ifdef ACADOS_WITH_DAQP
+    {"FULL_CONDENSING_DAQP", FULL_CONDENSING_DAQP, 0},
+#endif
+#ifdef ACADOS_WITH_QPDUNES
+    {"PARTIAL_CONDENSING_QPDUNES", PARTIAL_CONDENSING_QPDUNES, 1},
+#endif
+#ifdef ACADOS_WITH_OOQP
+    {"PARTIAL_CONDENSING_OOQP", PARTIAL_CONDENSING_OOQP, 1},
+    {"FULL_CONDENSING_OOQP", FULL_CONDENSING_OOQP, 0},
+#endif
+#ifdef ACADOS_WITH_OSQP
+    {"PARTIAL_CONDENSING_OSQP", PARTIAL_CONDENSING_OSQP, 1},
+#endif
+#ifdef ACADOS_WITH_QORE
+    {"FULL_CONDENSING_QORE", FULL_CONDENSING_QORE, 0},
+#endif
+#ifdef ACADOS_WITH_CLARABEL
+    {"PARTIAL_CONDENSING_CLARABEL", PARTIAL_CONDENSING_CLARABEL, 1},
+#endif
+};
+
+#define REPLAY_NUM_SOLVERS ((int) (sizeof(replay_solver_table) / sizeof(replay_solver_table[0])))
+
+
+
+typedef struct
+{
+    const replay_solver_entry *entry;
+    int N2;  // cond_N for partial condensing, 0: default
+    const char *precision;  // HPIPM precision mode, NULL: default
+} replay_solver_spec;
+
+
+
+typedef struct
+{
+    ocp_qp_capture_file *file;
+    int record;
+} replay_record;
+
+
+
+typedef struct
+{
+    // captured QPs
+    replay_record *records;
+    int num_records;
+    int next;
+    // solver
+    ocp_qp_xcond_solver_config *config;
+    ocp_qp_xcond_solver_dims *dims;
+    ocp_qp_in *qp_in;
+    ocp_qp_out *qp_out;
+    void *opts;
+    ocp_qp_solver *solver;
+    // statistics
+    int num_nonzero_status;
+    int num_status_changed;  // status differs from the captured one
+    int captured_status;
+    int solved;  // qp_out holds the solution of qp_in
+    double max_res;  // max inf-norm of the KKT residuals, computed in double
+} replay_data;
+
+
+
+static void print_usage(const char *name)
+{
+    printf("usage: %s [-s solver[:N2]]... [-p precision] [-n passes] [-w warmup] [-o results.json] "
+           "file.acqp...\n\n", name);
+    printf("  -s solver    QP solver to replay, repeatable; for partial condensing, N2 sets cond_N\n");
+    printf("               (default: all available solvers, partial condensing with N2 = N and %d)\n",
+           REPLAY_N2_DEFAULT);
+    printf("  -p precision HPIPM precision mode DOUBLE, SINGLE or MIXED (default DOUBLE),\n");
+    printf("               SINGLE and MIXED require ACADOS_WITH_HPIPM_SINGLE\n");
+    printf("  -n passes    number of timed passes over the captured QPs (default 1)\n");
+    printf("  -w warmup    number of untimed solves before timing (default 0)\n");
+    printf("  -o file      write results as JSON to file\n\n");
+    printf("available solvers:\n");
+    for (int ii = 0; ii < REPLAY_NUM_SOLVERS; ii++)
+        printf("  %s\n", replay_solver_table[ii].name);
+}
+
+
+
+static int parse_solver_spec(const char *arg, replay_solver_spec *spec)
+{
+    char name[MAX_STR_LEN];
+    snprintf(name, sizeof(name), "%s", arg);
+
+    spec->N2 = 0;
+    char *colon = strchr(name, ':');
+    if (colon != NULL)
+    {
+        *colon = '\0';
+        spec->N2 = atoi(colon + 1);
+    }
+
+    for (int ii = 0; ii < REPLAY_NUM_SOLVERS; ii++)
+    {
+        if (!strcmp(name, replay_solver_table[ii].name))
+        {
+            spec->entry = replay_solver_table + ii;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+
+/************************************************
+ * replay
+ ************************************************/
+
+static void replay_residuals(replay_data *data)
+{
+    if (!data->solved)
+        return;
+
+    double res[4];
+    ocp_qp_inf_norm_residuals(data->dims->orig_dims, data->qp_in, data->qp_out, res);
+    for (int ii = 0; ii < 4; ii++)
+    {
+        if (isnan(res[ii]))
+            data->max_res = INFINITY;
+        else if (res[ii] > data->max_res)
+            data->max_res = res[ii];
+    }
+    data->solved = 0;
+}
+
+
+
+static void replay_reset(void *data_)
+{
+    replay_data *data = data_;
+    replay_record *rec = data->records + data->next;
+
+    // residuals of the previous solve, outside of the timed region
+    replay_residuals(data);
+
+    data->captured_status = ocp_qp_capture_file_get(rec->file, rec->record, data->qp_in, NULL);
+
+    data->next = (data->next + 1) % data->num_records;
+}
+
+
+
+static int replay_solve(void *data_)
+{
+    replay_data *data = data_;
+    int status = ocp_qp_solve(data->solver, data->qp_in, data->qp_out);
+    data->solved = 1;
+
+    if (status != ACADOS_SUCCESS)
+        data->num_nonzero_status++;
+    if (status != data->captured_status)
+        data->num_status_changed++;
+
+    return status;
+}
+
+
+
+static void replay_setup(replay_data *data, replay_solver_spec *spec, ocp_qp_dims *qp_dims)
+{
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = spec->entry->qp_solver;
+
+    data->config = ocp_qp_xcond_solver_config_create(plan);
+    data->dims = ocp_qp_xcond_solver_dims_create_from_ocp_qp_dims(data->config, qp_dims);
+    data->qp_in = ocp_qp_in_create(data->dims->orig_dims);
+    data->qp_out = ocp_qp_out_create(data->dims->orig_dims);
+
+    data->opts = ocp_qp_xcond_solver_opts_create(data->config, data->dims);
+    if (spec->entry->partial && spec->N2 > 0)
+        ocp_qp_xcond_solver_opts_set(data->config, data->opts, "cond_N", &spec->N2);
+    if (spec->entry->qp_solver == PARTIAL_CONDENSING_HPIPM && spec->precision != NULL)
+        ocp_qp_xcond_solver_opts_set(data->config, data->opts, "precision", (void *) spec->precision);
+
+    data->solver = ocp_qp_create(data->config, data->dims, data->opts);
+
+    data->next = 0;
+    data->num_nonzero_status = 0;
+    data->num_status_changed = 0;
+    data->solved = 0;
+    data->max_res = 0.0;
+}
+
+
+
+static void replay_free(replay_data *data)
+{
+    ocp_qp_solver_destroy(data->solver);
+    ocp_qp_xcond_solver_opts_free(data->opts);
+    ocp_qp_out_free(data->qp_out);
+    ocp_qp_in_free(data->qp_in);
+    ocp_qp_xcond_solver_dims_free(data->dims);
+    ocp_qp_xcond_solver_config_free(data->config);
+}
+
+
+
+int main(int argc, char **argv)
+{
+    int passes = 1;
+    int warmup = 0;
+    const char *json_file = NULL;
+    const char *precision = NULL;
+
+    replay_solver_spec specs[REPLAY_MAX_SOLVERS];
+    int num_specs = 0;
+    const char *files[REPLAY_MAX_FILES];
+    int num_files = 0;
+
+    for (int ii = 1; ii < argc; ii++)
+    {
+        if (!strcmp(argv[ii], "-h") || !strcmp(argv[ii], "--help"))
+        {
+            print_usage(argv[0]);
+            return 0;
+        }
+        else if (ii + 1 < argc && !strcmp(argv[ii], "-s"))
+        {
+            ii++;
+            if (num_specs == REPLAY_MAX_SOLVERS || parse_solver_spec(argv[ii], specs + num_specs))
+            {
+                printf("\nerror: acados_qp_replay: unknown or unavailable solver %s\n\n", argv[ii]);
+                print_usage(argv[0]);
+                return 1;
+            }
+            num_specs++;
+        }
+        else if (ii + 1 < argc && !strcmp(argv[ii], "-p"))
+        {
+            precision = argv[++ii];
+            if (strcmp(precision, "DOUBLE") && strcmp(precision, "SINGLE") && strcmp(precision, "MIXED"))
+            {
+                printf("\nerror: acados_qp_replay: unknown precision %s\n\n", precision);
+                print_usage(argv[0]);
+                return 1;
+            }
+        }
+        else if (ii + 1 < argc && !strcmp(argv[ii], "-n"))
+        {
+            passes = atoi(argv[++ii]);
+        }
+        else if (ii + 1 < argc && !strcmp(argv[ii], "-w"))
+        {
+            warmup = atoi(argv[++ii]);
+        }
+        else if (ii + 1 < argc && !strcmp(argv[ii], "-o"))
+        {
+            json_file = argv[++ii];
+        }
+        else if (argv[ii][0] != '-' && num_files < REPLAY_MAX_FILES)
+        {
+            files[num_files++] = argv[ii];
+        }
+        else
+        {
+            printf("\nerror: acados_qp_replay: unknown argument %s\n\n", argv[ii]);
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (num_files == 0)
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (passes < 1)
+        passes = 1;
+
+    // open the capture files
+    ocp_qp_capture_file *cap_files[REPLAY_MAX_FILES];
+    int num_records_total = 0;
+    for (int ii = 0; ii < num_files; ii++)
+    {
+        cap_files[ii] = ocp_qp_capture_file_open(files[ii]);
+        if (cap_files[ii] == NULL)
+        {
+            printf("\nerror: acados_qp_replay: cannot read %s\n", files[ii]);
+            return 1;
+        }
+        num_records_total += cap_files[ii]->num_records;
+    }
+    if (num_records_total == 0)
+    {
+        printf("\nerror: acados_qp_replay: no QPs in the capture files\n");
+        return 1;
+    }
+
+    // the dimensions of the first record define the solver,
+    // records with other dimensions (e.g. relaxed QPs) are skipped
+    int i_first = 0;
+    while (cap_files[i_first]->num_records == 0)
+        i_first++;
+    ocp_qp_dims *qp_dims = ocp_qp_dims_create(ocp_qp_capture_file_get_N(cap_files[i_first], 0));
+    ocp_qp_capture_file_get_dims(cap_files[i_first], 0, qp_dims);
+
+    replay_data data;
+    data.records = malloc(num_records_total * sizeof(replay_record));
+    data.num_records = 0;
+    for (int ii = 0; ii < num_files; ii++)
+    {
+        for (int jj = 0; jj < cap_files[ii]->num_records; jj++)
+        {
+            if (ocp_qp_capture_file_check_dims(cap_files[ii], jj, qp_dims))
+                continue;
+            data.records[data.num_records].file = cap_files[ii];
+            data.records[data.num_records].record = jj;
+            data.num_records++;
+        }
+    }
+    printf("%d captured QPs with N = %d, %d skipped due to different dimensions\n",
+           data.num_records, qp_dims->N, num_records_total - data.num_records);
+
+    // default solvers
+    if (num_specs == 0)
+    {
+        for (int ii = 0; ii < REPLAY_NUM_SOLVERS; ii++)
+        {
+            specs[num_specs].entry = replay_solver_table + ii;
+            specs[num_specs].N2 = replay_solver_table[ii].partial ? qp_dims->N : 0;
+            num_specs++;
+            if (replay_solver_table[ii].qp_solver == PARTIAL_CONDENSING_HPIPM
+                && REPLAY_N2_DEFAULT < qp_dims->N)
+            {
+                specs[num_specs].entry = replay_solver_table + ii;
+                specs[num_specs].N2 = REPLAY_N2_DEFAULT;
+                num_specs++;
+            }
+        }
+    }
+
+    FILE *json = NULL;
+    if (json_file != NULL)
+    {
+        json = fopen(json_file, "w");
+        if (json == NULL)
+        {
+            printf("\nerror: acados_qp_replay: cannot open %s\n", json_file);
+            return 1;
+        }
+    }
+
+    for (int ii = 0; ii < num_specs; ii++)
+        specs[ii].precision = precision;
+
+    // one timed sample per captured QP and pass
+    bench_suite suite;
+    bench_suite_init(&suite, data.num_records * passes, warmup, NULL, json);
+    bench_suite_begin(&suite);
+
+    for (int ii = 0; ii < num_specs; ii++)
+    {
+        char name[MAX_STR_LEN];
+        if (specs[ii].entry->partial && specs[ii].N2 > 0)
+            snprintf(name, sizeof(name), "replay/%s/N2=%d", specs[ii].entry->name, specs[ii].N2);
+        else
+            snprintf(name, sizeof(name), "replay/%s", specs[ii].entry->name);
+        if (specs[ii].entry->qp_solver == PARTIAL_CONDENSING_HPIPM && specs[ii].precision != NULL)
+        {
+            size_t len = strlen(name);
+            snprintf(name + len, sizeof(name) - len, "/%s", specs[ii].precision);
+        }
+
+        replay_setup(&data, specs + ii, qp_dims);
+        bench_run(&suite, name, &data, &replay_reset, &replay_solve);
+        replay_residuals(&data);
+        // including the warmup solves
+        printf("    %d solves with nonzero status, %d with status different from the captured one\n",
+               data.num_nonzero_status, data.num_status_changed);
+        printf("    max KKT residual (inf-norm, double) %e\n", data.max_res);
+        replay_free(&data);
+    }
+
+    bench_suite_end(&suite);
+
+    if (json != NULL)
+    {
+        printf("results written to %s\n", json_file);
+        fclose(json);
+    }
+
+    bench_suite_free(&suite);
+    free(data.records);
+    ocp_qp_dims_free(qp_dims);
+    for (int ii = 0; ii < num_files; ii++)
+        ocp_qp_capture_file_close(cap_files[ii]);
+
+    return 0;
+}
@@ -0,0 +1,536 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// standard
+#include <stdio.h>
+#include <stdlib.h>
+// acados
+#include "acados/sim/sim_common.h"
+#include "acados/sim/sim_erk_integrator.h"
+#include "acados_c/external_function_interface.h"
+#include "acados_c/sim_interface.h"
+// models
+#include "examples/c/wt_model_nx3/wt_model.h"
+#include "examples/c/crane_dae_model/crane_dae_model.h"
+#include "examples/c/pendulum_dae_model/pendulum_dae_model.h"
+// x0 and u_sim for the wind turbine
+#include "examples/c/wt_model_nx3/u_x0.c"
+// bench
+#include "bench/bench_utils.h"
+
+
+
+typedef struct
+{
+    const char *name;
+    int nx;
+    int nu;
+    int nz;
+    // gnsf split
+    int nx1;
+    int nz1;
+    int nout;
+    int ny;
+    int nuhat;
+    double T;
+    double x0[9];
+    double u0[4];
+    // available model functions
+    bool has_expl;
+    bool has_gnsf;
+    external_function_casadi expl_ode_fun;
+    external_function_casadi expl_vde_for;
+    external_function_casadi expl_vde_adj;
+    external_function_casadi impl_ode_fun;
+    external_function_casadi impl_ode_fun_jac_x_xdot;
+    external_function_casadi impl_ode_jac_x_xdot_u;
+    external_function_casadi impl_ode_fun_jac_x_xdot_u;
+    external_function_casadi phi_fun;
+    external_function_casadi phi_fun_jac_y;
+    external_function_casadi phi_jac_y_uhat;
+    external_function_casadi f_lo_fun_jac_x1k1uz;
+    external_function_casadi get_matrices_fun;
+} bench_sim_model;
+
+
+
+typedef struct
+{
+    bench_sim_model *model;
+    sim_config *config;
+    void *dims;
+    sim_opts *opts;
+    sim_in *in;
+    sim_out *out;
+    sim_solver *solver;
+} bench_sim_data;
+
+
+
+/************************************************
+ * models
+ ************************************************/
+
+static void bench_sim_model_wt_nx3(bench_sim_model *model, external_function_opts *ext_fun_opts)
+{
+    model->name = "wt_nx3";
+    model->nx = 3;
+    model->nu = 4;
+    model->nz = 0;
+    model->nx1 = 3;
+    model->nz1 = 0;
+    model->nout = 1;
+    model->ny = 3;
+    model->nuhat = 4;
+    model->T = 0.05;
+    for (int ii = 0; ii < model->nx; ii++)
+        model->x0[ii] = x0[ii];
+    for (int ii = 0; ii < model->nu; ii++)
+        model->u0[ii] = u_sim[ii];
+
+    model->has_expl = true;
+    BENCH_CASADI_CREATE(&model->expl_ode_fun, casadi_expl_ode_fun, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->expl_vde_for, casadi_expl_vde_for, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->expl_vde_adj, casadi_expl_vde_adj, ext_fun_opts);
+
+    BENCH_CASADI_CREATE(&model->impl_ode_fun, casadi_impl_ode_fun, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->impl_ode_fun_jac_x_xdot, casadi_impl_ode_fun_jac_x_xdot, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->impl_ode_jac_x_xdot_u, casadi_impl_ode_jac_x_xdot_u, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->impl_ode_fun_jac_x_xdot_u, casadi_impl_ode_fun_jac_x_xdot_u, ext_fun_opts);
+
+    model->has_gnsf = true;
+    BENCH_CASADI_CREATE(&model->phi_fun, casadi_phi_fun, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->phi_fun_jac_y, casadi_phi_fun_jac_y, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->phi_jac_y_uhat, casadi_phi_jac_y_uhat, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->f_lo_fun_jac_x1k1uz, casadi_f_lo_fun_jac_x1k1uz, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->get_matrices_fun, casadi_get_matrices_fun, ext_fun_opts);
+}
+
+
+
+static void bench_sim_model_crane_dae(bench_sim_model *model, external_function_opts *ext_fun_opts)
+{
+    model->name = "crane_dae";
+    model->nx = 9;
+    model->nu = 2;
+    model->nz = 2;
+    model->nx1 = 5;
+    model->nz1 = 0;
+    model->nout = 1;
+    model->ny = 4;
+    model->nuhat = 1;
+    model->T = 0.01;
+    for (int ii = 0; ii < model->nx; ii++)
+        model->x0[ii] = 0.0;
+    model->x0[0] = 0.8;  // xL
+    model->u0[0] = 40.108149413030752;
+    model->u0[1] = -50.446662212534974;
+
+    model->has_expl = false;
+
+    BENCH_CASADI_CREATE(&model->impl_ode_fun, crane_dae_impl_ode_fun, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->impl_ode_fun_jac_x_xdot, crane_dae_impl_ode_fun_jac_x_xdot, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->impl_ode_jac_x_xdot_u, crane_dae_impl_ode_jac_x_xdot_u, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->impl_ode_fun_jac_x_xdot_u, crane_dae_impl_ode_fun_jac_x_xdot_u, ext_fun_opts);
+
+    model->has_gnsf = true;
+    BENCH_CASADI_CREATE(&model->phi_fun, crane_dae_phi_fun, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->phi_fun_jac_y, crane_dae_phi_fun_jac_y, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->phi_jac_y_uhat, crane_dae_phi_jac_y_uhat, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->f_lo_fun_jac_x1k1uz, crane_dae_f_lo_fun_jac_x1k1uz, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->get_matrices_fun, crane_dae_get_matrices_fun, ext_fun_opts);
+}
+
+
+
+static void bench_sim_model_pendulum_dae(bench_sim_model *model, external_function_opts *ext_fun_opts)
+{
+    model->name = "pendulum_dae";
+    model->nx = 6;
+    model->nu = 1;
+    model->nz = 5;
+    model->nx1 = 5;
+    model->nz1 = 5;
+    model->nout = 3;
+    model->ny = 8;
+    model->nuhat = 1;
+    model->T = 0.1;
+    model->x0[0] = 0.049999166670833;  // xpos
+    model->x0[1] = -4.999750002083326;  // ypos
+    model->x0[2] = 0.010000000000000;  // alpha
+    model->x0[3] = 0.0;  // vx
+    model->x0[4] = 0.0;  // vy
+    model->x0[5] = 0.0;  // valpha
+    model->u0[0] = 3.5;
+
+    model->has_expl = false;
+
+    BENCH_CASADI_CREATE(&model->impl_ode_fun, pendulum_dae_dyn_impl_ode_fun, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->impl_ode_fun_jac_x_xdot, pendulum_dae_dyn_impl_ode_fun_jac_x_xdot,
+                        ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->impl_ode_jac_x_xdot_u, pendulum_dae_dyn_impl_ode_jac_x_xdot_u,
+                        ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->impl_ode_fun_jac_x_xdot_u,
+                        pendulum_dae_dyn_impl_ode_fun_jac_x_xdot_u, ext_fun_opts);
+
+    model->has_gnsf = true;
+    BENCH_CASADI_CREATE(&model->phi_fun, pendulum_dae_dyn_gnsf_phi_fun, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->phi_fun_jac_y, pendulum_dae_dyn_gnsf_phi_fun_jac_y, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->phi_jac_y_uhat, pendulum_dae_dyn_gnsf_phi_jac_y_uhat, ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->f_lo_fun_jac_x1k1uz, pendulum_dae_dyn_gnsf_f_lo_fun_jac_x1k1uz,
+                        ext_fun_opts);
+    BENCH_CASADI_CREATE(&model->get_matrices_fun, pendulum_dae_dyn_gnsf_get_matrices_fun,
+                        ext_fun_opts);
+}
+
+
+
+static void bench_sim_model_free(bench_sim_model *model)
+{
+    if (model->has_expl)
+    {
+        external_function_casadi_free(&model->expl_ode_fun);
+        external_function_casadi_free(&model->expl_vde_for);
+        external_function_casadi_free(&model->expl_vde_adj);
+    }
+
+    external_function_casadi_free(&model->impl_ode_fun);
+    external_function_casadi_free(&model->impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&model->impl_ode_jac_x_xdot_u);
+    external_function_casadi_free(&model->impl_ode_fun_jac_x_xdot_u);
+
+    if (model->has_gnsf)
+    {
+        external_function_casadi_free(&model->phi_fun);
+        external_function_casadi_free(&model->phi_fun_jac_y);
+        external_function_casadi_free(&model->phi_jac_y_uhat);
+        external_function_casadi_free(&model->f_lo_fun_jac_x1k1uz);
+        external_function_casadi_free(&model->get_matrices_fun);
+    }
+}
+
+
+
+/************************************************
+ * integrator benchmarks
+ ************************************************/
+
+static void bench_sim_reset(void *data_)
+{
+    bench_sim_data *data = data_;
+    bench_sim_model *model = data->model;
+
+    for (int ii = 0; ii < model->nx; ii++)
+        data->in->x[ii] = model->x0[ii];
+    for (int ii = 0; ii < model->nu; ii++)
+        data->in->u[ii] = model->u0[ii];
+}
+
+
+
+static int bench_sim_run(void *data_)
+{
+    bench_sim_data *data = data_;
+    return sim_solve(data->solver, data->in, data->out);
+}
+
+
+
+static void bench_sim_integrator(bench_suite *suite, bench_sim_model *model,
+                                 sim_solver_t solver_type, const char *solver_name)
+{
+    char name[MAX_STR_LEN];
+    snprintf(name, sizeof(name), "sim/%s/%s", model->name, solver_name);
+    if (!bench_enabled(suite, name))
+        return;
+
+    int nx = model->nx;
+    int nu = model->nu;
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = solver_type;
+
+    bench_sim_data data;
+    data.model = model;
+    data.config = sim_config_create(plan);
+    sim_config *config = data.config;
+
+    data.dims = sim_dims_create(config);
+    sim_dims_set(config, data.dims, "nx", &nx);
+    sim_dims_set(config, data.dims, "nu", &nu);
+    sim_dims_set(config, data.dims, "nz", &model->nz);
+    if (solver_type == GNSF)
+    {
+        sim_dims_set(config, data.dims, "nx1", &model->nx1);
+        sim_dims_set(config, data.dims, "nz1", &model->nz1);
+        sim_dims_set(config, data.dims, "nout", &model->nout);
+        sim_dims_set(config, data.dims, "ny", &model->ny);
+        sim_dims_set(config, data.dims, "nuhat", &model->nuhat);
+    }
+
+    data.opts = sim_opts_create(config, data.dims);
+    sim_opts *opts = data.opts;
+    opts->ns = solver_type == ERK ? 4 : 2;
+    opts->num_steps = 2;
+    opts->newton_iter = 3;
+    opts->jac_reuse = false;
+    opts->sens_forw = true;
+    opts->sens_adj = solver_type != LIFTED_IRK;
+    opts->sens_hess = false;
+    opts->output_z = model->nz > 0;
+    opts->sens_algebraic = false;
+
+    data.in = sim_in_create(config, data.dims);
+    data.out = sim_out_create(config, data.dims);
+    sim_in *in = data.in;
+    in->T = model->T;
+
+    switch (solver_type)
+    {
+        case ERK:
+            sim_in_set(config, data.dims, in, "expl_ode_fun", &model->expl_ode_fun);
+            sim_in_set(config, data.dims, in, "expl_vde_for", &model->expl_vde_for);
+            sim_in_set(config, data.dims, in, "expl_vde_adj", &model->expl_vde_adj);
+            break;
+        case IRK:
+            sim_in_set(config, data.dims, in, "impl_ode_fun", &model->impl_ode_fun);
+            sim_in_set(config, data.dims, in, "impl_ode_fun_jac_x_xdot",
+                       &model->impl_ode_fun_jac_x_xdot);
+            sim_in_set(config, data.dims, in, "impl_ode_jac_x_xdot_u",
+                       &model->impl_ode_jac_x_xdot_u);
+            break;
+        case GNSF:
+            sim_in_set(config, data.dims, in, "phi_fun", &model->phi_fun);
+            sim_in_set(config, data.dims, in, "phi_fun_jac_y", &model->phi_fun_jac_y);
+            sim_in_set(config, data.dims, in, "phi_jac_y_uhat", &model->phi_jac_y_uhat);
+            sim_in_set(config, data.dims, in, "f_lo_jac_x1_x1dot_u_z", &model->f_lo_fun_jac_x1k1uz);
+            sim_in_set(config, data.dims, in, "get_gnsf_matrices", &model->get_matrices_fun);
+            break;
+        case LIFTED_IRK:
+            sim_in_set(config, data.dims, in, "impl_ode_fun", &model->impl_ode_fun);
+            sim_in_set(config, data.dims, in, "impl_ode_fun_jac_x_xdot_u",
+                       &model->impl_ode_fun_jac_x_xdot_u);
+            break;
+        default:
+            printf("\nerror: bench_sim: unsupported integrator\n");
+            exit(1);
+    }
+
+    // seeds
+    for (int ii = 0; ii < nx * (nx + nu); ii++)
+        in->S_forw[ii] = 0.0;
+    for (int ii = 0; ii < nx; ii++)
+        in->S_forw[ii * (nx + 1)] = 1.0;
+    for (int ii = 0; ii < nx; ii++)
+        in->S_adj[ii] = 1.0;
+    for (int ii = nx; ii < nx + nu; ii++)
+        in->S_adj[ii] = 0.0;
+
+    data.solver = sim_solver_create(config, data.dims, opts, in);
+    sim_precompute(data.solver, in, data.out);
+
+    bench_sim_reset(&data);
+    bench_run(suite, name, &data, &bench_sim_reset, &bench_sim_run);
+
+    sim_solver_destroy(data.solver);
+    sim_out_destroy(data.out);
+    sim_in_destroy(data.in);
+    sim_opts_destroy(data.opts);
+    sim_dims_destroy(data.dims);
+    sim_config_destroy(data.config);
+}
+
+
+
+/************************************************
+ * batch ERK benchmarks
+ ************************************************/
+
+#define BENCH_SIM_N_BATCH 256
+
+typedef struct
+{
+    bench_sim_model *model;
+    sim_config *config;
+    void *dims;
+    sim_opts *opts;
+    sim_in *in[BENCH_SIM_N_BATCH];
+    sim_out *out[BENCH_SIM_N_BATCH];
+    sim_solver *solver;
+    void *batch_work;
+} bench_sim_batch_data;
+
+
+
+static void bench_sim_batch_reset(void *data_)
+{
+    bench_sim_batch_data *data = data_;
+    bench_sim_model *model = data->model;
+
+    for (int jj = 0; jj < BENCH_SIM_N_BATCH; jj++)
+    {
+        // spread the initial states slightly over the batch
+        for (int ii = 0; ii < model->nx; ii++)
+            data->in[jj]->x[ii] = model->x0[ii] * (1.0 + 1e-3 * jj);
+        for (int ii = 0; ii < model->nu; ii++)
+            data->in[jj]->u[ii] = model->u0[ii];
+    }
+}
+
+
+
+static int bench_sim_batch_run_loop(void *data_)
+{
+    bench_sim_batch_data *data = data_;
+    int status = 0;
+    for (int jj = 0; jj < BENCH_SIM_N_BATCH; jj++)
+        status |= sim_solve(data->solver, data->in[jj], data->out[jj]);
+    return status;
+}
+
+
+
+static int bench_sim_batch_run_lockstep(void *data_)
+{
+    bench_sim_batch_data *data = data_;
+    return sim_erk_batch(data->config, data->in, data->out, data->opts, data->batch_work,
+                         BENCH_SIM_N_BATCH);
+}
+
+
+
+// simulation only throughput of BENCH_SIM_N_BATCH trajectories:
+// per trajectory calls of the ERK integrator vs. the lockstep batch ERK
+static void bench_sim_erk_batch(bench_suite *suite, bench_sim_model *model)
+{
+    char name_loop[MAX_STR_LEN];
+    char name_lockstep[MAX_STR_LEN];
+    snprintf(name_loop, sizeof(name_loop), "sim/%s/ERK_batch%d_loop", model->name,
+             BENCH_SIM_N_BATCH);
+    snprintf(name_lockstep, sizeof(name_lockstep), "sim/%s/ERK_batch%d_lockstep", model->name,
+             BENCH_SIM_N_BATCH);
+    if (!bench_enabled(suite, name_loop) && !bench_enabled(suite, name_lockstep))
+        return;
+
+    int nx = model->nx;
+    int nu = model->nu;
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = ERK;
+
+    bench_sim_batch_data data;
+    data.model = model;
+    data.config = sim_config_create(plan);
+    sim_config *config = data.config;
+
+    data.dims = sim_dims_create(config);
+    sim_dims_set(config, data.dims, "nx", &nx);
+    sim_dims_set(config, data.dims, "nu", &nu);
+    sim_dims_set(config, data.dims, "nz", &model->nz);
+
+    data.opts = sim_opts_create(config, data.dims);
+    sim_opts *opts = data.opts;
+    opts->ns = 4;
+    opts->num_steps = 2;
+    opts->sens_forw = false;
+    opts->sens_adj = false;
+    opts->sens_hess = false;
+    opts->sens_algebraic = false;
+    opts->output_z = false;
+
+    for (int jj = 0; jj < BENCH_SIM_N_BATCH; jj++)
+    {
+        data.in[jj] = sim_in_create(config, data.dims);
+        data.out[jj] = sim_out_create(config, data.dims);
+        data.in[jj]->T = model->T;
+        sim_in_set(config, data.dims, data.in[jj], "expl_ode_fun", &model->expl_ode_fun);
+    }
+
+    data.solver = sim_solver_create(config, data.dims, opts, data.in[0]);
+    data.batch_work = malloc(sim_erk_batch_workspace_calculate_size(config, data.dims, opts,
+                                                                    BENCH_SIM_N_BATCH));
+
+    bench_sim_batch_reset(&data);
+    if (bench_enabled(suite, name_loop))
+        bench_run(suite, name_loop, &data, &bench_sim_batch_reset, &bench_sim_batch_run_loop);
+    if (bench_enabled(suite, name_lockstep))
+        bench_run(suite, name_lockstep, &data, &bench_sim_batch_reset,
+                  &bench_sim_batch_run_lockstep);
+
+    free(data.batch_work);
+    sim_solver_destroy(data.solver);
+    for (int jj = 0; jj < BENCH_SIM_N_BATCH; jj++)
+    {
+        sim_out_destroy(data.out[jj]);
+        sim_in_destroy(data.in[jj]);
+    }
+    sim_opts_destroy(data.opts);
+    sim_dims_destroy(data.dims);
+    sim_config_destroy(data.config);
+}
+
+
+
+static void bench_sim_model_all(bench_suite *suite, bench_sim_model *model)
+{
+    if (model->has_expl)
+        bench_sim_integrator(suite, model, ERK, "ERK");
+    if (model->has_expl)
+        bench_sim_erk_batch(suite, model);
+    bench_sim_integrator(suite, model, IRK, "IRK");
+    if (model->has_gnsf)
+        bench_sim_integrator(suite, model, GNSF, "GNSF");
+    if (model->nz == 0)
+        bench_sim_integrator(suite, model, LIFTED_IRK, "LIFTED_IRK");
+}
+
+
+
+void bench_sim(bench_suite *suite)
+{
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+    ext_fun_opts.external_workspace = false;
+
+    bench_sim_model model;
+
+    bench_sim_model_wt_nx3(&model, &ext_fun_opts);
+    bench_sim_model_all(suite, &model);
+    bench_sim_model_free(&model);
+
+    bench_sim_model_crane_dae(&model, &ext_fun_opts);
+    bench_sim_model_all(suite, &model);
+    bench_sim_model_free(&model);
+
+    bench_sim_model_pendulum_dae(&model, &ext_fun_opts);
+    bench_sim_model_all(suite, &model);
+    bench_sim_model_free(&model);
+}
@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// standard
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+// acados
+#include "acados/utils/timing.h"
+// bench
+#include "bench/bench_utils.h"
+
+
+
+/************************************************
+ * heap allocation counting
+ ************************************************/
+
+// The allocator entry points are interposed in the benchmark executable and forwarded to the
+// glibc implementation, so that allocations inside the acados shared library are counted too.
+#if defined(__GLIBC__) && !defined(BENCH_NO_ALLOC_COUNT)
+
+#define BENCH_ALLOC_COUNT
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void *ptr);
+
+static int bench_alloc_active = 0;
+static long bench_alloc_num = 0;
+static long bench_alloc_bytes = 0;
+
+
+
+static void bench_alloc_record(size_t size)
+{
+    if (__atomic_load_n(&bench_alloc_active, __ATOMIC_RELAXED))
+    {
+        __atomic_fetch_add(&bench_alloc_num, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&bench_alloc_bytes, (long) size, __ATOMIC_RELAXED);
+    }
+}
+
+
+
+void *malloc(size_t size)
+{
+    bench_alloc_record(size);
+    return __libc_malloc(size);
+}
+
+
+
+void *calloc(size_t nmemb, size_t size)
+{
+    bench_alloc_record(nmemb * size);
+    return __libc_calloc(nmemb, size);
+}
+
+
+
+void *realloc(void *ptr, size_t size)
+{
+    bench_alloc_record(size);
+    return __libc_realloc(ptr, size);
+}
+
+
+
+int posix_memalign(void **memptr, size_t alignment, size_t size)
+{
+    bench_alloc_record(size);
+    void *ptr = __libc_memalign(alignment, size);
+    if (ptr == NULL)
+        return ENOMEM;
+    *memptr = ptr;
+    return 0;
+}
+
+
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    bench_alloc_record(size);
+    return __libc_memalign(alignment, size);
+}
+
+
+
+void free(void *ptr)
+{
+    __libc_free(ptr);
+}
+
+#endif  // __GLIBC__
+
+
+
+bool bench_alloc_count_available(void)
+{
+#if defined(BENCH_ALLOC_COUNT)
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+
+void bench_alloc_count_start(void)
+{
+#if defined(BENCH_ALLOC_COUNT)
+    __atomic_store_n(&bench_alloc_num, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&bench_alloc_bytes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&bench_alloc_active, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+
+
+void bench_alloc_count_stop(long *count, long *bytes)
+{
+#if defined(BENCH_ALLOC_COUNT)
+    __atomic_store_n(&bench_alloc_active, 0, __ATOMIC_RELAXED);
+    *count = __atomic_load_n(&bench_alloc_num, __ATOMIC_RELAXED);
+    *bytes = __atomic_load_n(&bench_alloc_bytes, __ATOMIC_RELAXED);
+#else
+    *count = -1;
+    *bytes = -1;
+#endif
+}
+
+
+
+/************************************************
+ * suite
+ ************************************************/
+
+void bench_suite_init(bench_suite *suite, int reps, int warmup, const char *filter, FILE *json)
+{
+    suite->reps = reps > 0 ? reps : 1;
+    suite->warmup = warmup > 0 ? warmup : 0;
+    suite->filter = filter;
+    suite->json = json;
+    suite->num_results = 0;
+    suite->num_failed = 0;
+    suite->samples = malloc(suite->reps * sizeof(double));
+}
+
+
+
+void bench_suite_free(bench_suite *suite)
+{
+    free(suite->samples);
+    suite->samples = NULL;
+}
+
+
+
+bool bench_enabled(bench_suite *suite, const char *name)
+{
+    if (suite->filter == NULL || suite->filter[0] == '\0')
+        return true;
+    return strstr(name, suite->filter) != NULL;
+}
+
+
+
+static int bench_compare_double(const void *a, const void *b)
+{
+    double da = *(const double *) a;
+    double db = *(const double *) b;
+    return (da > db) - (da < db);
+}
+
+
+
+// nearest-rank percentile of sorted samples, p in (0, 1]
+static double bench_percentile(const double *sorted, int n, double p)
+{
+    int idx = (int) ceil(p * n) - 1;
+    if (idx < 0)
+        idx = 0;
+    if (idx > n - 1)
+        idx = n - 1;
+    return sorted[idx];
+}
+
+
+
+static void bench_statistics(double *samples, int n, bench_result *result)
+{
+    qsort(samples, n, sizeof(double), bench_compare_double);
+
+    double sum = 0.0;
+    for (int ii = 0; ii < n; ii++)
+        sum += samples[ii];
+
+    result->min = samples[0];
+    if (n % 2 == 1)
+        result->median = samples[n / 2];
+    else
+        result->median = 0.5 * (samples[n / 2 - 1] + samples[n / 2]);
+    result->p99 = bench_percentile(samples, n, 0.99);
+    result->mean = sum / n;
+}
+
+
+
+static void bench_json_result(bench_suite *suite, const char *name, bench_result *result)
+{
+    FILE *json = suite->json;
+    if (json == NULL)
+        return;
+
+    fprintf(json, "%s\n    {\n", suite->num_results > 0 ? "," : "");
+    fprintf(json, "      \"name\": \"%s\",\n", name);
+    fprintf(json, "      \"status\": %d,\n", result->status);
+    fprintf(json, "      \"reps\": %d,\n", suite->reps);
+    fprintf(json, "      \"min_us\": %.3f,\n", 1e6 * result->min);
+    fprintf(json, "      \"median_us\": %.3f,\n", 1e6 * result->median);
+    fprintf(json, "      \"p99_us\": %.3f,\n", 1e6 * result->p99);
+    fprintf(json, "      \"mean_us\": %.3f,\n", 1e6 * result->mean);
+    if (result->allocs >= 0)
+    {
+        fprintf(json, "      \"allocs_per_call\": %.2f,\n", result->allocs);
+        fprintf(json, "      \"alloc_bytes_per_call\": %.1f\n", result->alloc_bytes);
+    }
+    else
+    {
+        fprintf(json, "      \"allocs_per_call\": null,\n");
+        fprintf(json, "      \"alloc_bytes_per_call\": null\n");
+    }
+    fprintf(json, "    }");
+    fflush(json);
+}
+
+
+
+void bench_run(bench_suite *suite, const char *name, void *data, bench_reset_fun reset,
+               bench_run_fun run)
+{
+    if (!bench_enabled(suite, name))
+        return;
+
+    acados_timer timer;
+    bench_result result;
+    long count, bytes;
+    long count_tot = 0;
+    long bytes_tot = 0;
+
+    for (int ii = 0; ii < suite->warmup; ii++)
+    {
+        if (reset != NULL)
+            reset(data);
+        run(data);
+    }
+
+    for (int ii = 0; ii < suite->reps; ii++)
+    {
+        if (reset != NULL)
+            reset(data);
+
+        bench_alloc_count_start();
+        acados_tic(&timer);
+        int status = run(data);
+        suite->samples[ii] = acados_toc(&timer);
+        bench_alloc_count_stop(&count, &bytes);
+
+        if (ii == 0)
+            result.status = status;
+        count_tot += count;
+        bytes_tot += bytes;
+    }
+
+    bench_statistics(suite->samples, suite->reps, &result);
+    if (bench_alloc_count_available())
+    {
+        result.allocs = (double) count_tot / suite->reps;
+        result.alloc_bytes = (double) bytes_tot / suite->reps;
+    }
+    else
+    {
+        result.allocs = -1.0;
+        result.alloc_bytes = -1.0;
+    }
+
+    printf("%-56s %12.2f %12.2f %12.2f", name, 1e6 * result.min, 1e6 * result.median,
+           1e6 * result.p99);
+    if (result.allocs >= 0)
+        printf(" %10.1f", result.allocs);
+    else
+        printf(" %10s", "-");
+    if (result.status != 0)
+        printf("   (status %d)", result.status);
+    printf("\n");
+
+    if (result.status != 0)
+        suite->num_failed++;
+
+    bench_json_result(suite, name, &result);
+    suite->num_results++;
+}
+
+
+
+void bench_suite_begin(bench_suite *suite)
+{
+    printf("%-56s %12s %12s %12s %10s\n", "benchmark", "min [us]", "median [us]", "p99 [us]",
+           "allocs");
+
+    FILE *json = suite->json;
+    if (json == NULL)
+        return;
+
+    fprintf(json, "{\n");
+    fprintf(json, "  \"suite\": \"acados_bench\",\n");
+    fprintf(json, "  \"format_version\": 1,\n");
+    fprintf(json, "  \"config\": {\n");
+    fprintf(json, "    \"reps\": %d,\n", suite->reps);
+    fprintf(json, "    \"warmup\": %d,\n", suite->warmup);
+    fprintf(json, "    \"filter\": \"%s\",\n", suite->filter != NULL ? suite->filter : "");
+#if defined(ACADOS_WITH_OPENMP)
+    fprintf(json, "    \"openmp\": true,\n");
+#else
+    fprintf(json, "    \"openmp\": false,\n");
+#endif
+    fprintf(json, "    \"alloc_count\": %s\n", bench_alloc_count_available() ? "true" : "false");
+    fprintf(json, "  },\n");
+    fprintf(json, "  \"results\": [");
+}
+
+
+
+void bench_suite_end(bench_suite *suite)
+{
+    FILE *json = suite->json;
+    if (json == NULL)
+        return;
+
+    fprintf(json, "\n  ]\n}\n");
+    fflush(json);
+}
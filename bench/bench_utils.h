@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#ifndef BENCH_BENCH_UTILS_H_
+#define BENCH_BENCH_UTILS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "acados_c/external_function_interface.h"
+
+
+
+typedef struct
+{
+    int reps;             // number of timed repetitions per benchmark
+    int warmup;           // number of untimed repetitions before timing
+    const char *filter;   // only run benchmarks whose name contains this string (NULL: all)
+    FILE *json;           // results file (NULL: no JSON output)
+    int num_results;
+    int num_failed;
+    double *samples;      // reps samples [s]
+} bench_suite;
+
+typedef struct
+{
+    double min;           // [s]
+    double median;        // [s]
+    double p99;           // [s]
+    double mean;          // [s]
+    double allocs;        // heap allocations per call (-1: not available)
+    double alloc_bytes;   // heap bytes per call (-1: not available)
+    int status;           // return value of the first timed call
+} bench_result;
+
+// reset is called before every run and is not timed (may be NULL);
+// run returns an acados status, nonzero values are reported but do not stop the suite
+typedef void (*bench_reset_fun)(void *data);
+typedef int (*bench_run_fun)(void *data);
+
+
+
+//
+void bench_suite_init(bench_suite *suite, int reps, int warmup, const char *filter, FILE *json);
+//
+void bench_suite_free(bench_suite *suite);
+// returns true if the benchmark passes the name filter; check before expensive setup
+bool bench_enabled(bench_suite *suite, const char *name);
+//
+void bench_run(bench_suite *suite, const char *name, void *data, bench_reset_fun reset,
+               bench_run_fun run);
+// prints the table header and writes the JSON header, results are streamed by bench_run
+void bench_suite_begin(bench_suite *suite);
+//
+void bench_suite_end(bench_suite *suite);
+
+// heap allocation counting, only available with glibc
+bool bench_alloc_count_available(void);
+//
+void bench_alloc_count_start(void);
+//
+void bench_alloc_count_stop(long *count, long *bytes);
+
+
+
+// benchmark groups
+void bench_sim(bench_suite *suite);
+//
+void bench_ocp_qp(bench_suite *suite);
+//
+void bench_ocp_nlp(bench_suite *suite);
+
+
+
+// fills the casadi function pointers of an external_function_casadi from the generated prefix
+#define BENCH_CASADI_CREATE(fun, prefix, opts)                 \
+    do                                                         \
+    {                                                          \
+        (fun)->casadi_fun = &prefix;                           \
+        (fun)->casadi_work = &prefix##_work;                   \
+        (fun)->casadi_sparsity_in = &prefix##_sparsity_in;     \
+        (fun)->casadi_sparsity_out = &prefix##_sparsity_out;   \
+        (fun)->casadi_n_in = &prefix##_n_in;                   \
+        (fun)->casadi_n_out = &prefix##_n_out;                 \
+        external_function_casadi_create(fun, opts);            \
+    } while (0)
+
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // BENCH_BENCH_UTILS_H_
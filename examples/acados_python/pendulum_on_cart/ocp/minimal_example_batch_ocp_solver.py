@@ -94,6 +94,16 @@ def setup_ocp(tol=1e-7):
     return ocp
 
 
+def get_peak_rss_kb():
+    # peak resident set size of the process in kB, not available on Windows
+    try:
+        import resource
+    except ImportError:
+        return 0
+    rss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    return rss / 1024 if sys.platform == 'darwin' else rss
+
+
 def main_sequential(x0, N_sim, tol):
 
     ocp = setup_ocp(tol=tol)
@@ -123,7 +133,12 @@ def main_batch(Xinit, simU, tol, num_threads_in_batch_solve=1):
     ocp = setup_ocp(tol)
     N_batch_max = N_batch + 3 # to test with more than N_batch
 
+    rss_before = get_peak_rss_kb()
     batch_solver = AcadosOcpBatchSolver(ocp, N_batch_max, num_threads_in_batch_solve=num_threads_in_batch_solve, verbose=False)
+    rss_after = get_peak_rss_kb()
+
+    print(f"main_batch: creation of {N_batch_max} solvers: {1e3*batch_solver.time_create:.3f}ms, "
+          f"batch memory {batch_solver.memsize/1e6:.3f}MB, increase of peak resident memory {(rss_after-rss_before)/1e3:.3f}MB")
 
     assert batch_solver.num_threads_in_batch_solve == num_threads_in_batch_solve
     batch_solver.num_threads_in_batch_solve = 1337
@@ -150,6 +165,14 @@ def main_batch(Xinit, simU, tol, num_threads_in_batch_solve=1):
 
     print(f"main_batch: with {num_threads_in_batch_solve} threads, solve: {t_elapsed:.3f}ms")
 
+    # per solve statistics
+    nlp_iter = batch_solver.nlp_iter[:N_batch]
+    for n in range(N_batch):
+        if nlp_iter[n] != batch_solver.ocp_solvers[n].get_stats("nlp_iter"):
+            raise Exception(f"nlp_iter of {n}th batch solve does not match get_stats")
+    time_per_thread = np.bincount(batch_solver.thread_id[:N_batch], weights=batch_solver.time_solve[:N_batch])
+    print(f"main_batch: nlp_iter min {nlp_iter.min()} max {nlp_iter.max()}, busy time per thread [ms]: {1e3*time_per_thread}")
+
     U_batch = batch_solver.get_flat("u", N_batch)
 
     for n in range(N_batch):
@@ -0,0 +1,139 @@
+#
+# Copyright (c) The acados authors.
+#
+# This file is part of acados.
+#
+# The 2-Clause BSD License
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+# this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.;
+
+import sys
+sys.path.insert(0, '../pendulum_on_cart/common')
+
+import time
+import numpy as np
+import scipy.linalg
+from acados_template import AcadosOcp, AcadosOcpSolver
+from pendulum_model import export_pendulum_ode_model
+
+# Checks that the asynchronous RTI iterations, prepare_async / feedback_async, give the same
+# closed loop as the synchronous preparation and feedback phases, and checks the overrun counter.
+# Requires acados to be compiled with ACADOS_WITH_THREAD_POOL, skipped otherwise.
+
+N = 20
+N_SIM = 30
+
+
+def create_ocp():
+    ocp = AcadosOcp()
+    ocp.model = export_pendulum_ode_model()
+    nx = ocp.model.x.rows()
+    nu = ocp.model.u.rows()
+
+    ocp.solver_options.N_horizon = N
+    ocp.solver_options.tf = 1.0
+
+    Q = 2 * np.diag([1e3, 1e3, 1e-2, 1e-2])
+    R = 2 * np.diag([1e-2])
+    ocp.cost.cost_type = 'LINEAR_LS'
+    ocp.cost.cost_type_e = 'LINEAR_LS'
+    ocp.cost.W = scipy.linalg.block_diag(Q, R)
+    ocp.cost.W_e = Q
+    ocp.cost.Vx = np.vstack((np.eye(nx), np.zeros((nu, nx))))
+    ocp.cost.Vu = np.vstack((np.zeros((nx, nu)), np.eye(nu)))
+    ocp.cost.Vx_e = np.eye(nx)
+    ocp.cost.yref = np.zeros((nx + nu,))
+    ocp.cost.yref_e = np.zeros((nx,))
+
+    ocp.constraints.lbu = np.array([-80.0])
+    ocp.constraints.ubu = np.array([80.0])
+    ocp.constraints.idxbu = np.array([0])
+    ocp.constraints.x0 = np.array([0.0, 0.5, 0.0, 0.0])
+
+    ocp.solver_options.qp_solver = 'PARTIAL_CONDENSING_HPIPM'
+    ocp.solver_options.hessian_approx = 'GAUSS_NEWTON'
+    ocp.solver_options.integrator_type = 'ERK'
+    ocp.solver_options.nlp_solver_type = 'SQP_RTI'
+    ocp.solver_options.as_rti_level = 4
+    ocp.code_export_directory = 'c_generated_code_async_rti'
+    return ocp
+
+
+def main():
+    ocp = create_ocp()
+    json_file = 'acados_ocp_async_rti.json'
+    solver_sync = AcadosOcpSolver(ocp, json_file=json_file, verbose=False)
+    solver_async = AcadosOcpSolver(ocp, json_file=json_file, build=False, generate=False, verbose=False)
+
+    try:
+        solver_async.prepare_async()
+    except RuntimeError:
+        print('test_async_rti: acados compiled without ACADOS_WITH_THREAD_POOL, skipping.')
+        return
+
+    x0 = ocp.constraints.lbx_0.copy()
+    for k in range(N_SIM):
+        # synchronous RTI iteration
+        solver_sync.options_set('rti_phase', 1)
+        solver_sync.solve()
+        solver_sync.set(0, 'lbx', x0)
+        solver_sync.set(0, 'ubx', x0)
+        solver_sync.options_set('rti_phase', 2)
+        status_sync = solver_sync.solve()
+
+        # asynchronous RTI iteration, the preparation was started at the end of the last iteration
+        status_async = solver_async.feedback_async(x0)
+        u_async = solver_async.get(0, 'u')
+        x1_async = solver_async.get(1, 'x')
+        solver_async.prepare_async()
+
+        if status_sync != status_async:
+            raise AssertionError(f'test_async_rti: status {status_async} of feedback_async differs from {status_sync} in iteration {k}.')
+        err = np.max(np.abs(u_async - solver_sync.get(0, 'u')))
+        err = max(err, np.max(np.abs(x1_async - solver_sync.get(1, 'x'))))
+        if err > 1e-10:
+            raise AssertionError(f'test_async_rti: asynchronous iterate differs by {err:.2e} from the synchronous one in iteration {k}.')
+
+        # closed loop on the predicted state
+        x0 = solver_sync.get(1, 'x')
+
+    stats = solver_async.get_async_stats()
+    print(f'test_async_rti: {stats}')
+    if stats['num_preparations'] != N_SIM + 1:
+        raise AssertionError(f"test_async_rti: expected {N_SIM + 1} preparations, got {stats['num_preparations']}.")
+    if stats['num_overruns'] > N_SIM:
+        raise AssertionError(f"test_async_rti: got {stats['num_overruns']} overruns in {N_SIM} feedback calls.")
+
+    # a preparation that finished before the feedback call is not an overrun
+    num_overruns = stats['num_overruns']
+    time.sleep(0.5)
+    solver_async.feedback_async(x0)
+    stats = solver_async.get_async_stats()
+    if stats['num_overruns'] != num_overruns:
+        raise AssertionError('test_async_rti: feedback_async after a finished preparation counted as overrun.')
+
+    print('test_async_rti: success')
+
+
+if __name__ == '__main__':
+    main()
@@ -137,6 +137,22 @@ def main(interface_type='ctypes'):
         simU0[i, :] = ocp_solver.get(i, "u")
     simX0[N_horizon, :] = ocp_solver.get(N_horizon, "x")
 
+    if interface_type == 'ctypes':
+        # views onto the solver memory and preallocated output buffers
+        x_buffer = np.zeros((nx,))
+        for i in range(N_horizon + 1):
+            assert np.array_equal(ocp_solver.get_view(i, "x"), simX0[i, :])
+            assert np.array_equal(ocp_solver.get(i, "x", out=x_buffer), simX0[i, :])
+        x_flat = ocp_solver.get_flat("x")
+        assert np.array_equal(ocp_solver.get_flat("x", out=np.empty_like(x_flat)), x_flat)
+        assert np.array_equal(ocp_solver.get_view(1, "b"), ocp_solver.get_from_qp_in(1, "b").flatten())
+
+        # writing to a writeable view changes the iterate
+        u_view = ocp_solver.get_view(0, "u", writeable=True)
+        u_view[:] = 1.0
+        assert np.array_equal(ocp_solver.get(0, "u"), np.ones((nu,)))
+        ocp_solver.set(0, "u", simU0[0, :])
+
     ocp_solver.store_iterate(filename=f'final_iterate_{interface_type}_variant{nvariant}.json', overwrite=True)
 
     if PLOT:# plot but don't halt
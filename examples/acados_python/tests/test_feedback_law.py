@@ -0,0 +1,128 @@
+#
+# Copyright (c) The acados authors.
+#
+# This file is part of acados.
+#
+# The 2-Clause BSD License
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+# this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.;
+
+import numpy as np
+import casadi as ca
+from acados_template import AcadosOcp, AcadosOcpSolver, AcadosModel
+
+# Checks the stage 0 feedback gain of AcadosOcpSolver.update_feedback_law() against finite differences
+# of the optimal u0 w.r.t. x0, with x0 eliminated from the QP, with and without an active
+# general constraint at stage 0 that couples x and u.
+
+N = 20
+NX = 2
+NU = 1
+A = np.array([[1.0, 0.1], [-0.2, 0.9]])
+B = np.array([[0.0], [0.1]])
+X0 = np.array([1.0, 0.5])
+# h_0 = u + 0.5 * x[0] >= LH_0, active at X0
+H_X = 0.5
+LH_0 = 0.6
+
+
+def create_solver(with_h_0: bool):
+    model = AcadosModel()
+    model.name = 'feedback_law_test_h' if with_h_0 else 'feedback_law_test'
+    model.x = ca.SX.sym('x', NX)
+    model.u = ca.SX.sym('u', NU)
+    model.disc_dyn_expr = A @ model.x + B @ model.u
+
+    ocp = AcadosOcp()
+    ocp.model = model
+    ocp.solver_options.N_horizon = N
+    ocp.solver_options.tf = 1.0
+    ocp.solver_options.integrator_type = 'DISCRETE'
+    ocp.solver_options.nlp_solver_type = 'SQP'
+    ocp.solver_options.qp_solver = 'PARTIAL_CONDENSING_HPIPM'
+    ocp.solver_options.hessian_approx = 'EXACT'
+    ocp.solver_options.nlp_solver_max_iter = 50
+    ocp.solver_options.tol = 1e-10
+    ocp.solver_options.qp_tol = 1e-12
+
+    ocp.cost.cost_type = 'EXTERNAL'
+    ocp.cost.cost_type_e = 'EXTERNAL'
+    ocp.model.cost_expr_ext_cost = ca.sumsqr(model.x) + 0.1 * ca.sumsqr(model.u)
+    ocp.model.cost_expr_ext_cost_e = 10 * ca.sumsqr(model.x)
+
+    ocp.constraints.x0 = X0
+    ocp.constraints.idxbu = np.array([0])
+    ocp.constraints.lbu = np.array([-10.0])
+    ocp.constraints.ubu = np.array([10.0])
+    if with_h_0:
+        model.con_h_expr_0 = model.u[0] + H_X * model.x[0]
+        ocp.constraints.lh_0 = np.array([LH_0])
+        ocp.constraints.uh_0 = np.array([100.0])
+
+    ocp.code_export_directory = f'c_generated_code_{model.name}'
+    return AcadosOcpSolver(ocp, json_file=f'acados_ocp_{model.name}.json', verbose=False)
+
+
+def solve_u0(solver, x0):
+    solver.set(0, 'lbx', x0)
+    solver.set(0, 'ubx', x0)
+    status = solver.solve()
+    if status != 0:
+        raise RuntimeError(f'test_feedback_law: solver returned status {status}.')
+    return solver.get(0, 'u')
+
+
+def main():
+    eps = 1e-5
+    for with_h_0 in [False, True]:
+        solver = create_solver(with_h_0)
+        u0 = solve_u0(solver, X0)
+        solver.update_feedback_law()
+
+        if with_h_0 and abs(u0[0] + H_X * X0[0] - LH_0) > 1e-8:
+            raise AssertionError('test_feedback_law: h_0 should be active at the solution.')
+
+        # K from the feedback law, column by column
+        K = np.zeros((NU, NX))
+        for j in range(NX):
+            K[:, j] = solver.eval_feedback_law(X0 + np.eye(NX)[j], clip=False) - u0
+
+        # finite differences of the solution map
+        K_fd = np.zeros((NU, NX))
+        for j in range(NX):
+            K_fd[:, j] = (solve_u0(solver, X0 + eps * np.eye(NX)[j]) - u0) / eps
+
+        err = np.max(np.abs(K - K_fd))
+        print(f'with_h_0 = {with_h_0}: K = {K}, K_fd = {K_fd}, max error {err:.2e}')
+        if err > 1e-5:
+            raise AssertionError(f'test_feedback_law: feedback gain does not match finite differences, with_h_0 = {with_h_0}.')
+        if with_h_0 and np.max(np.abs(K - np.array([[-H_X, 0.0]]))) > 1e-5:
+            raise AssertionError('test_feedback_law: feedback gain should keep h_0 active.')
+
+        del solver
+
+    print('test_feedback_law: success')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,137 @@
+#
+# Copyright (c) The acados authors.
+#
+# This file is part of acados.
+#
+# The 2-Clause BSD License
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+# this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.;
+
+import numpy as np
+import casadi as ca
+from acados_template import AcadosOcp, AcadosOcpSolver, AcadosModel
+
+# Runs the same closed loop with split RTI phases and rti_fast_feedback 0 and 1. With
+# rti_fast_feedback the QP rhs of the stages > 0 is evaluated in the preparation phase instead of the
+# feedback phase; as the iterate does not change in between, the iterates have to be identical.
+
+N = 20
+NX = 2
+NU = 1
+DT = 0.05
+N_SIM = 30
+TOL = 1e-10
+
+
+def disc_dyn(x, u):
+    # nonlinear damped pendulum, explicit Euler
+    return ca.vertcat(x[0] + DT * x[1], x[1] + DT * (-10 * ca.sin(x[0]) - 0.1 * x[1] + u[0]))
+
+
+def create_solver(rti_fast_feedback):
+    model = AcadosModel()
+    model.name = f'rti_fast_feedback_{rti_fast_feedback}'
+    model.x = ca.SX.sym('x', NX)
+    model.u = ca.SX.sym('u', NU)
+    model.disc_dyn_expr = disc_dyn(model.x, model.u)
+    # nonlinear constraint, its rhs depends on the linearization point
+    model.con_h_expr = model.x[0]**2 + model.x[1]**2
+
+    ocp = AcadosOcp()
+    ocp.model = model
+    ocp.solver_options.N_horizon = N
+    ocp.solver_options.tf = N * DT
+    ocp.solver_options.integrator_type = 'DISCRETE'
+    ocp.solver_options.nlp_solver_type = 'SQP_RTI'
+    ocp.solver_options.hessian_approx = 'GAUSS_NEWTON'
+    ocp.solver_options.qp_solver = 'PARTIAL_CONDENSING_HPIPM'
+    ocp.solver_options.qp_solver_cond_N = N // 4
+    ocp.solver_options.rti_fast_feedback = rti_fast_feedback
+
+    ocp.cost.cost_type = 'LINEAR_LS'
+    ocp.cost.cost_type_e = 'LINEAR_LS'
+    ocp.cost.W = np.diag([10.0, 1.0, 0.1])
+    ocp.cost.W_e = np.diag([10.0, 1.0])
+    ocp.cost.Vx = np.vstack((np.eye(NX), np.zeros((NU, NX))))
+    ocp.cost.Vu = np.vstack((np.zeros((NX, NU)), np.eye(NU)))
+    ocp.cost.Vx_e = np.eye(NX)
+    ocp.cost.yref = np.zeros(NX + NU)
+    ocp.cost.yref_e = np.zeros(NX)
+
+    ocp.constraints.x0 = np.array([1.0, 0.0])
+    ocp.constraints.idxbu = np.array([0])
+    ocp.constraints.lbu = np.array([-8.0])
+    ocp.constraints.ubu = np.array([8.0])
+    ocp.constraints.lh = np.array([-1e3])
+    ocp.constraints.uh = np.array([1.5])
+
+    ocp.code_export_directory = f'c_generated_code_{model.name}'
+    return AcadosOcpSolver(ocp, json_file=f'acados_ocp_{model.name}.json', verbose=False)
+
+
+def get_iterate(solver):
+    fields = []
+    for k in range(N+1):
+        fields += [solver.get(k, 'x'), solver.get(k, 'lam')]
+        if k < N:
+            fields += [solver.get(k, 'u'), solver.get(k, 'pi')]
+    return np.concatenate(fields)
+
+
+def main():
+    solvers = [create_solver(rti_fast_feedback) for rti_fast_feedback in [0, 1]]
+    x_plant = ca.SX.sym('x', NX)
+    u_plant = ca.SX.sym('u', NU)
+    plant = ca.Function('plant', [x_plant, u_plant], [disc_dyn(x_plant, u_plant)])
+
+    x0 = np.array([1.0, 0.0])
+    max_diff = 0.0
+    for i in range(N_SIM):
+        iterates = []
+        for solver in solvers:
+            solver.options_set('rti_phase', 1)
+            status = solver.solve()
+            if status != 0:
+                raise RuntimeError(f'test_rti_fast_feedback: preparation phase returned status {status} at step {i}.')
+            solver.set(0, 'lbx', x0)
+            solver.set(0, 'ubx', x0)
+            solver.options_set('rti_phase', 2)
+            status = solver.solve()
+            if status != 0:
+                raise RuntimeError(f'test_rti_fast_feedback: feedback phase returned status {status} at step {i}.')
+            iterates.append(get_iterate(solver))
+
+        diff = np.max(np.abs(iterates[0] - iterates[1]))
+        max_diff = max(max_diff, diff)
+        if diff > TOL:
+            raise AssertionError(f'test_rti_fast_feedback: iterates differ by {diff:.2e} at step {i}.')
+
+        u0 = solvers[0].get(0, 'u')
+        x0 = np.array(plant(x0, u0)).flatten()
+
+    print(f'test_rti_fast_feedback: max deviation of the iterates {max_diff:.2e}')
+    print('test_rti_fast_feedback: success')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,189 @@
+#
+# Copyright (c) The acados authors.
+#
+# This file is part of acados.
+#
+# The 2-Clause BSD License
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+# this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.;
+
+import numpy as np
+import casadi as ca
+from acados_template import AcadosOcp, AcadosOcpSolver, AcadosOcpBatchSolver, AcadosModel, AcadosOcpScenarioTreeSolver
+
+# Compares the scenario-tree solver with n_robust = 1, n_realizations = 2 to the same problem
+# formulated as a single OCP over two copies of the system, with equal controls at stage 0.
+
+N = 10
+NX = 2
+NU = 1
+X0 = np.array([1.0, 0.0])
+P = [0.5, 2.0]
+PROBABILITIES = np.array([0.3, 0.7])
+W = np.diag([1.0, 1.0, 0.1])
+W_E = 10 * np.eye(NX)
+U_MAX = 1.5
+TOL = 1e-9
+
+
+def dynamics(x, u, p):
+    return ca.vertcat(x[0] + 0.1 * x[1], x[1] + 0.1 * (-p * ca.sin(x[0]) + u[0]))
+
+
+def set_options(ocp: AcadosOcp):
+    ocp.solver_options.N_horizon = N
+    ocp.solver_options.tf = 1.0
+    ocp.solver_options.integrator_type = 'DISCRETE'
+    ocp.solver_options.nlp_solver_type = 'SQP'
+    ocp.solver_options.qp_solver = 'PARTIAL_CONDENSING_HPIPM'
+    ocp.solver_options.hessian_approx = 'GAUSS_NEWTON'
+    ocp.solver_options.nlp_solver_max_iter = 100
+    ocp.solver_options.tol = TOL
+    ocp.solver_options.qp_tol = 1e-12
+
+
+def create_scenario_ocp():
+    model = AcadosModel()
+    model.name = 'scenario_tree_test'
+    model.x = ca.SX.sym('x', NX)
+    model.u = ca.SX.sym('u', NU)
+    model.p = ca.SX.sym('p')
+    model.disc_dyn_expr = dynamics(model.x, model.u, model.p)
+
+    ocp = AcadosOcp()
+    ocp.model = model
+    ocp.parameter_values = np.array([P[0]])
+    set_options(ocp)
+
+    ocp.cost.cost_type = 'NONLINEAR_LS'
+    ocp.cost.cost_type_e = 'NONLINEAR_LS'
+    model.cost_y_expr = ca.vertcat(model.x, model.u)
+    model.cost_y_expr_e = model.x
+    ocp.cost.W = W
+    ocp.cost.W_e = W_E
+    ocp.cost.yref = np.zeros(NX + NU)
+    ocp.cost.yref_e = np.zeros(NX)
+
+    ocp.constraints.x0 = X0
+    ocp.constraints.idxbu = np.array([0])
+    ocp.constraints.lbu = np.array([-U_MAX])
+    ocp.constraints.ubu = np.array([U_MAX])
+
+    ocp.code_export_directory = f'c_generated_code_{model.name}'
+    return ocp
+
+
+def create_duplicated_solver():
+    model = AcadosModel()
+    model.name = 'scenario_tree_test_duplicated'
+    x = [ca.SX.sym(f'x_{s}', NX) for s in range(2)]
+    u = [ca.SX.sym(f'u_{s}', NU) for s in range(2)]
+    model.x = ca.vertcat(*x)
+    model.u = ca.vertcat(*u)
+    model.disc_dyn_expr = ca.vertcat(*[dynamics(x[s], u[s], P[s]) for s in range(2)])
+    # non-anticipativity
+    model.con_h_expr_0 = u[0] - u[1]
+
+    ocp = AcadosOcp()
+    ocp.model = model
+    set_options(ocp)
+
+    weights = PROBABILITIES / np.sum(PROBABILITIES)
+    ocp.cost.cost_type = 'NONLINEAR_LS'
+    ocp.cost.cost_type_e = 'NONLINEAR_LS'
+    model.cost_y_expr = ca.vertcat(x[0], u[0], x[1], u[1])
+    model.cost_y_expr_e = ca.vertcat(x[0], x[1])
+    ocp.cost.W = np.block([[weights[0] * W, np.zeros((NX + NU, NX + NU))],
+                           [np.zeros((NX + NU, NX + NU)), weights[1] * W]])
+    ocp.cost.W_e = np.block([[weights[0] * W_E, np.zeros((NX, NX))],
+                             [np.zeros((NX, NX)), weights[1] * W_E]])
+    ocp.cost.yref = np.zeros(2 * (NX + NU))
+    ocp.cost.yref_e = np.zeros(2 * NX)
+
+    ocp.constraints.x0 = np.concatenate([X0, X0])
+    ocp.constraints.idxbu = np.array([0, 1])
+    ocp.constraints.lbu = -U_MAX * np.ones(2)
+    ocp.constraints.ubu = U_MAX * np.ones(2)
+    ocp.constraints.lh_0 = np.zeros(NU)
+    ocp.constraints.uh_0 = np.zeros(NU)
+
+    ocp.code_export_directory = f'c_generated_code_{model.name}'
+    return AcadosOcpSolver(ocp, json_file=f'acados_ocp_{model.name}.json', verbose=False)
+
+
+def main():
+    # reference
+    duplicated_solver = create_duplicated_solver()
+    status = duplicated_solver.solve()
+    if status != 0:
+        raise RuntimeError(f'test_scenario_tree: duplicated-chain solver returned status {status}.')
+    X_ref = np.array([duplicated_solver.get(k, 'x') for k in range(N + 1)])
+    U_ref = np.array([duplicated_solver.get(k, 'u') for k in range(N)])
+    if np.max(np.abs(U_ref)) < U_MAX - 1e-6:
+        raise AssertionError('test_scenario_tree: the control bounds should be active at the solution.')
+
+    # scenario tree
+    ocp = create_scenario_ocp()
+    batch_solver = AcadosOcpBatchSolver(ocp, 2, json_file=f'acados_ocp_{ocp.model.name}.json', verbose=False)
+    tree_solver = AcadosOcpScenarioTreeSolver(batch_solver, n_realizations=2, n_robust=1, probabilities=PROBABILITIES)
+    for s, scenario_solver in enumerate(tree_solver.scenario_solvers):
+        for k in range(N + 1):
+            scenario_solver.set(k, 'p', np.array([P[s]]))
+    tree_solver.options_set('max_iter', 100)
+    for field in ['nlp_tol_stat', 'nlp_tol_eq', 'nlp_tol_ineq', 'nlp_tol_comp']:
+        tree_solver.options_set(field, TOL)
+    tree_solver.options_set('tol_step', 1e-14)
+    tree_solver.options_set('num_threads', 2)
+
+    status = tree_solver.solve()
+    sqp_iter = tree_solver.get_stats('sqp_iter')
+    res = [tree_solver.get_stats(field) for field in ['res_stat', 'res_eq', 'res_ineq', 'res_comp']]
+    print(f'scenario tree: status {status}, sqp_iter {sqp_iter}, residuals {res}, num_nodes {tree_solver.get_stats("num_nodes")}')
+    if status != 0:
+        raise RuntimeError(f'test_scenario_tree: scenario-tree solver returned status {status}.')
+    if tree_solver.get_stats('num_nodes') != 1 + 2 * N:
+        raise AssertionError('test_scenario_tree: wrong number of nodes.')
+
+    err = 0.0
+    for s, scenario_solver in enumerate(tree_solver.scenario_solvers):
+        X = np.array([scenario_solver.get(k, 'x') for k in range(N + 1)])
+        U = np.array([scenario_solver.get(k, 'u') for k in range(N)])
+        err = max(err, np.max(np.abs(X - X_ref[:, s * NX:(s + 1) * NX])), np.max(np.abs(U - U_ref[:, s * NU:(s + 1) * NU])))
+    print(f'max deviation from the duplicated-chain solution: {err:.2e}')
+    if err > 1e-6:
+        raise AssertionError('test_scenario_tree: scenario-tree solution does not match the duplicated-chain solution.')
+
+    # non-anticipativity
+    u0 = [scenario_solver.get(0, 'u') for scenario_solver in tree_solver.scenario_solvers]
+    if np.max(np.abs(u0[0] - u0[1])) > 1e-12:
+        raise AssertionError('test_scenario_tree: controls at stage 0 differ between the scenarios.')
+
+    del tree_solver
+    del batch_solver
+    del duplicated_solver
+
+    print('test_scenario_tree: success')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,228 @@
+#
+# Copyright (c) The acados authors.
+#
+# This file is part of acados.
+#
+# The 2-Clause BSD License
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+# this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.;
+
+import numpy as np
+import casadi as ca
+from acados_template import AcadosOcp, AcadosOcpSolver, AcadosModel
+
+# Checks AcadosOcpSolver.shift() against the expected shifted iterate, on an OCP whose stage 0 has
+# the x0 bounds and therefore other constraint dimensions than the remaining stages, including the
+# shifted QP warm start and its use in the split RTI phases.
+
+N = 10
+NX = 2
+NU = 1
+A = np.array([[1.0, 0.1], [-0.2, 0.9]])
+B = np.array([[0.0], [0.1]])
+
+
+def create_solver(time_steps, nlp_solver_type='SQP'):
+    model = AcadosModel()
+    model.name = f'shift_test_{nlp_solver_type.lower()}'
+    model.x = ca.SX.sym('x', NX)
+    model.u = ca.SX.sym('u', NU)
+    model.disc_dyn_expr = A @ model.x + B @ model.u
+
+    ocp = AcadosOcp()
+    ocp.model = model
+    ocp.solver_options.N_horizon = N
+    ocp.solver_options.time_steps = time_steps
+    ocp.solver_options.tf = float(np.sum(time_steps))
+    ocp.solver_options.integrator_type = 'DISCRETE'
+    ocp.solver_options.nlp_solver_type = nlp_solver_type
+    ocp.solver_options.qp_solver = 'PARTIAL_CONDENSING_HPIPM'
+    # condensed QP, so that the shifted QP solution has to be condensed for the warm start
+    ocp.solver_options.qp_solver_cond_N = N // 2
+    ocp.solver_options.qp_solver_warm_start = 2
+
+    ocp.cost.cost_type = 'EXTERNAL'
+    ocp.cost.cost_type_e = 'EXTERNAL'
+    ocp.model.cost_expr_ext_cost = ca.sumsqr(model.x) + 0.1 * ca.sumsqr(model.u)
+    ocp.model.cost_expr_ext_cost_e = 10 * ca.sumsqr(model.x)
+
+    ocp.constraints.x0 = np.array([1.0, 0.5])
+    ocp.constraints.idxbu = np.array([0])
+    ocp.constraints.lbu = np.array([-2.0])
+    ocp.constraints.ubu = np.array([2.0])
+    # state bound on the intermediate stages only
+    ocp.constraints.idxbx = np.array([1])
+    ocp.constraints.lbx = np.array([-5.0])
+    ocp.constraints.ubx = np.array([5.0])
+
+    ocp.code_export_directory = f'c_generated_code_{model.name}'
+    return AcadosOcpSolver(ocp, json_file=f'acados_ocp_{model.name}.json', verbose=False)
+
+
+def get_iterate(solver):
+    x = np.array([solver.get(k, 'x') for k in range(N+1)])
+    u = np.array([solver.get(k, 'u') for k in range(N)])
+    pi = np.array([solver.get(k, 'pi') for k in range(N)])
+    return x, u, pi
+
+
+def get_qp_iterate(solver):
+    qp_x = [solver.get_from_qp_out(k, 'x') for k in range(N+1)]
+    qp_u = [solver.get_from_qp_out(k, 'u') for k in range(N)]
+    qp_pi = [solver.get_from_qp_out(k, 'pi') for k in range(N)]
+    qp_lam = [solver.get_from_qp_out(k, 'lam') for k in range(N+1)]
+    return qp_x, qp_u, qp_pi, qp_lam
+
+
+def set_iterate(solver, x, u, pi):
+    for k in range(N+1):
+        solver.set(k, 'x', x[k])
+    for k in range(N):
+        solver.set(k, 'u', u[k])
+        solver.set(k, 'pi', pi[k])
+
+
+def expected_shift(x, u, pi, strategy, time_steps):
+    x_s, u_s, pi_s = x.copy(), u.copy(), pi.copy()
+    if strategy in ['REPEAT_LAST', 'SIMULATE_TERMINAL']:
+        x_s[:N] = x[1:]
+        u_s[:N-1] = u[1:]
+        pi_s[:N-1] = pi[1:]
+        if strategy == 'SIMULATE_TERMINAL':
+            x_s[N] = A @ x_s[N-1] + B @ u_s[N-1]
+    else:
+        t_grid = np.concatenate(([0.0], np.cumsum(time_steps)))
+        for i in range(N+1):
+            t = t_grid[i] + time_steps[0]
+            j = np.searchsorted(t_grid, t + 1e-10 * time_steps[0], side='right') - 1
+            if j >= N:
+                x_s[i] = x[N]
+                if i < N:
+                    u_s[i] = u[N-1]
+                    pi_s[i] = pi[N-1]
+            else:
+                theta = (t - t_grid[j]) / time_steps[j]
+                x_s[i] = (1 - theta) * x[j] + theta * x[j+1]
+                if i < N:
+                    u_s[i] = u[j]
+                    pi_s[i] = pi[j]
+    return x_s, u_s, pi_s
+
+
+def source_stages(strategy, time_steps):
+    # stage whose QP solution is the warm start of stage i < N after the shift
+    if strategy in ['REPEAT_LAST', 'SIMULATE_TERMINAL']:
+        return [min(i+1, N-1) for i in range(N)]
+    t_grid = np.concatenate(([0.0], np.cumsum(time_steps)))
+    src = []
+    for i in range(N):
+        t = t_grid[i] + time_steps[0]
+        j = np.searchsorted(t_grid, t + 1e-10 * time_steps[0], side='right') - 1
+        src.append(j if j < N else N-1)
+    return src
+
+
+def check_qp_shift(qp, qp_s, strategy, time_steps):
+    # the QP solution is copied stage-wise, fields with other dimensions (lam at stage 0) are kept
+    qp_x, qp_u, qp_pi, qp_lam = qp
+    qp_x_s, qp_u_s, qp_pi_s, qp_lam_s = qp_s
+    src = source_stages(strategy, time_steps)
+    for i in range(N):
+        j = src[i]
+        ok = np.array_equal(qp_x_s[i], qp_x[j]) and np.array_equal(qp_u_s[i], qp_u[j]) \
+            and np.array_equal(qp_pi_s[i], qp_pi[j])
+        lam_ref = qp_lam[j] if qp_lam[j].size == qp_lam[i].size else qp_lam[i]
+        ok = ok and np.array_equal(qp_lam_s[i], lam_ref)
+        if not ok:
+            raise AssertionError(f'test_shift: {strategy} QP warm start of stage {i} is not the QP solution of stage {j}.')
+    if not (np.array_equal(qp_x_s[N], qp_x[N]) and np.array_equal(qp_lam_s[N], qp_lam[N])):
+        raise AssertionError(f'test_shift: {strategy} QP warm start of the terminal stage changed.')
+    print(f'{strategy}: QP warm start shifted')
+
+
+def main():
+    time_steps = np.concatenate((0.05 * np.ones(N // 2), 0.1 * np.ones(N - N // 2)))
+    solver = create_solver(time_steps)
+    status = solver.solve()
+    if status != 0:
+        raise RuntimeError(f'test_shift: solver returned status {status}.')
+    x, u, pi = get_iterate(solver)
+    qp = get_qp_iterate(solver)
+
+    for strategy in ['REPEAT_LAST', 'SIMULATE_TERMINAL', 'INTERPOLATE']:
+        set_iterate(solver, x, u, pi)
+        solver.shift(1, strategy)
+        x_s, u_s, pi_s = get_iterate(solver)
+        check_qp_shift(qp, get_qp_iterate(solver), strategy, time_steps)
+        x_ref, u_ref, pi_ref = expected_shift(x, u, pi, strategy, time_steps)
+        for name, val, ref in [('x', x_s, x_ref), ('u', u_s, u_ref), ('pi', pi_s, pi_ref)]:
+            err = np.max(np.abs(val - ref))
+            print(f'{strategy}: max error in shifted {name}: {err:.2e}')
+            if err > 1e-12:
+                raise AssertionError(f'test_shift: {strategy} shifted {name} does not match the expected iterate.')
+
+        # the shifted iterate is a warm start, the next solve converges
+        set_iterate(solver, x, u, pi)
+        solver.shift(1, strategy)
+        solver.set(0, 'lbx', x[1])
+        solver.set(0, 'ubx', x[1])
+        status = solver.solve()
+        if status != 0:
+            raise RuntimeError(f'test_shift: solve after {strategy} shift returned status {status}.')
+        solver.set(0, 'lbx', x[0])
+        solver.set(0, 'ubx', x[0])
+        qp = get_qp_iterate(solver)
+
+    # split RTI phases: the feedback phase condenses only the QP rhs and has to use the shifted
+    # warm start as well; its solution has to match the one of the combined phases
+    solvers = [create_solver(time_steps, 'SQP_RTI') for _ in range(2)]
+    for rti_solver in solvers:
+        for _ in range(3):
+            status = rti_solver.solve()
+            if status != 0:
+                raise RuntimeError(f'test_shift: RTI solve returned status {status}.')
+        qp = get_qp_iterate(rti_solver)
+        rti_solver.shift(1, 'REPEAT_LAST')
+        check_qp_shift(qp, get_qp_iterate(rti_solver), 'REPEAT_LAST', time_steps)
+        rti_solver.set(0, 'lbx', x[1])
+        rti_solver.set(0, 'ubx', x[1])
+    status = solvers[0].solve()
+    if status != 0:
+        raise RuntimeError(f'test_shift: RTI solve after shift returned status {status}.')
+    for phase in [1, 2]:
+        solvers[1].options_set('rti_phase', phase)
+        status = solvers[1].solve()
+        if status != 0:
+            raise RuntimeError(f'test_shift: RTI phase {phase} after shift returned status {status}.')
+    x_0, u_0, pi_0 = get_iterate(solvers[0])
+    x_1, u_1, pi_1 = get_iterate(solvers[1])
+    err = max(np.max(np.abs(x_0 - x_1)), np.max(np.abs(u_0 - u_1)), np.max(np.abs(pi_0 - pi_1)))
+    print(f'split RTI phases after shift: max deviation from combined phases: {err:.2e}')
+    if err > 1e-6:
+        raise AssertionError('test_shift: split RTI phases after shift do not match the combined phases.')
+
+    print('test_shift: success')
+
+
+if __name__ == '__main__':
+    main()
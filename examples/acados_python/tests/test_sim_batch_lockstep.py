@@ -0,0 +1,107 @@
+#
+# Copyright (c) The acados authors.
+#
+# This file is part of acados.
+#
+# The 2-Clause BSD License
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+# this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.;
+
+import numpy as np
+import casadi as ca
+from acados_template import AcadosSim, AcadosSimBatchSolver, AcadosModel
+
+# Checks that the lockstep ERK integration of AcadosSimBatchSolver (no sensitivities) is bitwise
+# identical to solving every integrator of the batch separately with sim_erk.
+
+N_BATCH = 13
+NX = 3
+NU = 1
+
+
+def create_batch_solver(num_threads: int):
+    model = AcadosModel()
+    model.name = 'sim_batch_lockstep_test'
+    model.x = ca.SX.sym('x', NX)
+    model.u = ca.SX.sym('u', NU)
+    model.p = ca.SX.sym('p')
+    x = model.x
+    model.f_expl_expr = ca.vertcat(x[1], -model.p * ca.sin(x[0]) - 0.1 * x[1] + model.u[0], x[0] * x[1] - x[2] ** 3)
+
+    sim = AcadosSim()
+    sim.model = model
+    sim.parameter_values = np.array([1.0])
+    sim.solver_options.T = 0.1
+    sim.solver_options.integrator_type = 'ERK'
+    sim.solver_options.num_stages = 4
+    sim.solver_options.num_steps = 5
+    sim.solver_options.sens_forw = False
+    sim.solver_options.sens_adj = False
+    sim.solver_options.sens_hess = False
+    sim.solver_options.sens_algebraic = False
+    sim.solver_options.with_batch_functionality = True
+    sim.code_export_directory = f'c_generated_code_{model.name}'
+
+    return AcadosSimBatchSolver(sim, N_BATCH, num_threads_in_batch_solve=num_threads,
+                                json_file=f'acados_sim_{model.name}.json', verbose=False)
+
+
+def main():
+    rng = np.random.default_rng(0)
+    X0 = rng.standard_normal((N_BATCH, NX))
+    U = rng.standard_normal((N_BATCH, NU))
+    P = 1.0 + rng.random((N_BATCH, 1))
+
+    batch_solver = create_batch_solver(num_threads=3)
+    for i, solver in enumerate(batch_solver.sim_solvers):
+        solver.set('x', X0[i])
+        solver.set('u', U[i])
+        solver.set('p', P[i])
+
+    # the batch is split into a different number of chunks for every thread count
+    for num_threads in [3, 1, 4, N_BATCH + 2]:
+        batch_solver.num_threads_in_batch_solve = num_threads
+        batch_solver.solve()
+        X_batch = np.array([solver.get('x') for solver in batch_solver.sim_solvers])
+
+        # per integrator, same inputs
+        X_single = np.zeros((N_BATCH, NX))
+        for i, solver in enumerate(batch_solver.sim_solvers):
+            status = solver.solve()
+            if status != 0:
+                raise RuntimeError(f'test_sim_batch_lockstep: integrator {i} returned status {status}.')
+            X_single[i] = solver.get('x')
+
+        print(f'num_threads = {num_threads}: max deviation {np.max(np.abs(X_batch - X_single)):.2e}')
+        if not np.array_equal(X_batch, X_single):
+            raise AssertionError(f'test_sim_batch_lockstep: lockstep batch differs from sim_erk with {num_threads} threads.')
+        if np.allclose(X_batch, X0):
+            raise AssertionError('test_sim_batch_lockstep: the states did not change.')
+
+    del batch_solver
+
+    print('test_sim_batch_lockstep: success')
+
+
+if __name__ == '__main__':
+    main()
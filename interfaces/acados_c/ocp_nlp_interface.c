@@ -61,10 +61,14 @@
 #include "acados/ocp_nlp/ocp_nlp_sqp_with_feasible_qp.h"
 #include "acados/ocp_nlp/ocp_nlp_sqp_rti.h"
 #include "acados/ocp_nlp/ocp_nlp_ddp.h"
+#include "acados/ocp_nlp/ocp_nlp_scenario_tree.h"
 #include "acados/utils/mem.h"
 #include "acados/utils/strsep.h"
+#include "acados/utils/thread_pool.h"
+#include "acados/utils/timing.h"
 
 // blasfeo
+#include "blasfeo/include/blasfeo_d_aux.h"
 #include "blasfeo/include/blasfeo_d_blas.h"
 
 
@@ -1057,6 +1061,27 @@ void ocp_nlp_qp_dims_get_from_attr(ocp_nlp_config *config, ocp_nlp_dims *dims, o
         dims_out[0] = dims->nx[stage];
         dims_out[1] = 1;
     }
+    // qp solution
+    else if (!strcmp(field, "qp_x"))
+    {
+        dims_out[0] = dims->nx[stage];
+        dims_out[1] = 1;
+    }
+    else if (!strcmp(field, "qp_u"))
+    {
+        dims_out[0] = dims->nu[stage];
+        dims_out[1] = 1;
+    }
+    else if (!strcmp(field, "qp_pi"))
+    {
+        dims_out[0] = dims->nx[stage+1];
+        dims_out[1] = 1;
+    }
+    else if (!strcmp(field, "qp_lam"))
+    {
+        dims_out[0] = 2*dims->ni[stage];
+        dims_out[1] = 1;
+    }
     // constraints
     else if (!strcmp(field, "C"))
     {
@@ -1366,6 +1391,171 @@ void ocp_nlp_solver_destroy(ocp_nlp_solver *solver)
 }
 
 
+/************************************************
+* batch
+************************************************/
+
+static acados_size_t ocp_nlp_solver_batch_instance_size(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                                        acados_size_t solver_memsize)
+{
+    acados_size_t bytes = 0;
+
+    bytes += config->opts_calculate_size(config, dims);
+    bytes += ocp_nlp_in_calculate_size(config, dims);
+    bytes += 2 * ocp_nlp_out_calculate_size(config, dims);
+    bytes += solver_memsize;
+
+    bytes += 5 * 64; // align each block
+
+    return bytes;
+}
+
+
+
+acados_size_t ocp_nlp_solver_batch_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                                  void *opts_, ocp_nlp_in *nlp_in, int N_batch)
+{
+    acados_size_t bytes = sizeof(ocp_nlp_solver_batch);
+
+    bytes += 4 * N_batch * sizeof(void *); // opts, nlp_in, nlp_out, sens_out
+    bytes += 2 * N_batch * sizeof(void *); // solver, solver_raw_memory
+
+    // NOTE: opts_calculate_size populates the dims of the condensed qp based on default options,
+    // the solver memory has to be sized afterwards.
+    config->opts_calculate_size(config, dims);
+    acados_size_t solver_memsize = ocp_nlp_calculate_size(config, dims, opts_, nlp_in);
+
+    bytes += N_batch * ocp_nlp_solver_batch_instance_size(config, dims, solver_memsize);
+
+    bytes += 8;
+
+    return bytes;
+}
+
+
+
+ocp_nlp_solver_batch *ocp_nlp_solver_batch_create(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                                  void *opts_, ocp_nlp_in *nlp_in, int N_batch)
+{
+    acados_size_t bytes = ocp_nlp_solver_batch_calculate_size(config, dims, opts_, nlp_in, N_batch);
+    acados_size_t solver_memsize = ocp_nlp_calculate_size(config, dims, opts_, nlp_in);
+
+    void *ptr = acados_calloc(1, bytes);
+    assert(ptr != 0);
+
+    char *c_ptr = (char *) ptr;
+
+    ocp_nlp_solver_batch *batch = (ocp_nlp_solver_batch *) c_ptr;
+    c_ptr += sizeof(ocp_nlp_solver_batch);
+
+    batch->config = config;
+    batch->dims = dims;
+    batch->N_batch = N_batch;
+    batch->solver_memsize = solver_memsize;
+    batch->memsize = bytes;
+    batch->raw_memory = ptr;
+
+    align_char_to(8, &c_ptr);
+
+    batch->opts = (void **) c_ptr;
+    c_ptr += N_batch * sizeof(void *);
+    batch->nlp_in = (ocp_nlp_in **) c_ptr;
+    c_ptr += N_batch * sizeof(ocp_nlp_in *);
+    batch->nlp_out = (ocp_nlp_out **) c_ptr;
+    c_ptr += N_batch * sizeof(ocp_nlp_out *);
+    batch->sens_out = (ocp_nlp_out **) c_ptr;
+    c_ptr += N_batch * sizeof(ocp_nlp_out *);
+    batch->solver = (ocp_nlp_solver **) c_ptr;
+    c_ptr += N_batch * sizeof(ocp_nlp_solver *);
+    batch->solver_raw_memory = (void **) c_ptr;
+    c_ptr += N_batch * sizeof(void *);
+
+    for (int i = 0; i < N_batch; i++)
+    {
+        // opts
+        align_char_to(64, &c_ptr);
+        batch->opts[i] = config->opts_assign(config, dims, c_ptr);
+        c_ptr += config->opts_calculate_size(config, dims);
+        config->opts_initialize_default(config, dims, batch->opts[i]);
+
+        // nlp_in
+        align_char_to(64, &c_ptr);
+        batch->nlp_in[i] = ocp_nlp_in_assign(config, dims, c_ptr);
+        batch->nlp_in[i]->raw_memory = NULL;
+        c_ptr += ocp_nlp_in_calculate_size(config, dims);
+
+        // nlp_out, sens_out
+        align_char_to(64, &c_ptr);
+        batch->nlp_out[i] = ocp_nlp_out_assign(config, dims, c_ptr);
+        batch->nlp_out[i]->raw_memory = NULL;
+        c_ptr += ocp_nlp_out_calculate_size(config, dims);
+
+        align_char_to(64, &c_ptr);
+        batch->sens_out[i] = ocp_nlp_out_assign(config, dims, c_ptr);
+        batch->sens_out[i]->raw_memory = NULL;
+        c_ptr += ocp_nlp_out_calculate_size(config, dims);
+
+        // solver, assigned in ocp_nlp_solver_batch_assign_solver
+        align_char_to(64, &c_ptr);
+        batch->solver[i] = NULL;
+        batch->solver_raw_memory[i] = c_ptr;
+        c_ptr += solver_memsize;
+    }
+
+    assert((char *) ptr + bytes >= c_ptr);
+
+    return batch;
+}
+
+
+
+int ocp_nlp_solver_batch_assign_solver(ocp_nlp_solver_batch *batch, int i)
+{
+    if (i < 0 || i >= batch->N_batch)
+    {
+        printf("\nocp_nlp_solver_batch_assign_solver: index %d out of range [0, %d).\n", i, batch->N_batch);
+        return 1;
+    }
+
+    ocp_nlp_config *config = batch->config;
+    ocp_nlp_dims *dims = batch->dims;
+    void *opts = batch->opts[i];
+    ocp_nlp_in *nlp_in = batch->nlp_in[i];
+
+    config->opts_update(config, dims, opts);
+
+    acados_size_t bytes = ocp_nlp_calculate_size(config, dims, opts, nlp_in);
+    if (bytes > batch->solver_memsize)
+    {
+        printf("\nocp_nlp_solver_batch_assign_solver: options of instance %d require %zu bytes, " \
+               "only %zu bytes reserved. The options of all instances have to match the prototype.\n",
+               i, (size_t) bytes, (size_t) batch->solver_memsize);
+        return 1;
+    }
+
+    if (batch->solver[i] != NULL)
+        config->terminate(config, batch->solver[i]->mem, batch->solver[i]->work);
+
+    memset(batch->solver_raw_memory[i], 0, bytes);
+    batch->solver[i] = ocp_nlp_assign(config, dims, opts, nlp_in, batch->solver_raw_memory[i]);
+
+    return 0;
+}
+
+
+
+void ocp_nlp_solver_batch_destroy(ocp_nlp_solver_batch *batch)
+{
+    for (int i = 0; i < batch->N_batch; i++)
+    {
+        if (batch->solver[i] != NULL)
+            batch->config->terminate(batch->config, batch->solver[i]->mem, batch->solver[i]->work);
+    }
+    free(batch->raw_memory);
+}
+
+
+
 void ocp_nlp_solver_reset_qp_memory(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out)
 {
     solver->config->memory_reset_qp_solver(solver->config, solver->dims, nlp_in, nlp_out,
@@ -1463,6 +1653,22 @@ void ocp_nlp_eval_params_jac(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp
 }
 
 
+void ocp_nlp_shift(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out, int n_shift, int strategy)
+{
+    ocp_nlp_config *config = solver->config;
+    ocp_nlp_memory *nlp_mem;
+    ocp_nlp_opts *nlp_opts;
+    ocp_nlp_workspace *nlp_work;
+    ocp_nlp_dims *dims = solver->dims;
+
+    config->get(config, solver->dims, solver->mem, "nlp_mem", &nlp_mem);
+    config->opts_get(config, solver->opts, "nlp_opts", &nlp_opts);
+    config->work_get(config, solver->dims, solver->work, "nlp_work", &nlp_work);
+
+    ocp_nlp_shift_iterate(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work, n_shift, strategy);
+}
+
+
 void ocp_nlp_eval_solution_sens_adj_p(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *sens_nlp_out, const char *field, int stage, double *out)
 {
     solver->config->eval_solution_sens_adj_p(solver->config, solver->dims, solver->opts, solver->mem, solver->work, sens_nlp_out, field, stage, out);
@@ -1475,6 +1681,555 @@ void ocp_nlp_get(ocp_nlp_solver *solver, const char *field, void *return_value_)
 }
 
 
+int ocp_nlp_profiling_dump_trace(ocp_nlp_solver *solver, const char *filename)
+{
+    ocp_nlp_memory *nlp_mem;
+    ocp_nlp_get(solver, "nlp_mem", &nlp_mem);
+    return ocp_nlp_profiling_write_trace(nlp_mem->profiling, filename);
+}
+
+
+int ocp_nlp_qp_capture_start(ocp_nlp_solver *solver, const char *prefix,
+                             int num_files, int records_per_file)
+{
+    ocp_nlp_memory *nlp_mem;
+    ocp_nlp_get(solver, "nlp_mem", &nlp_mem);
+
+    // the relaxed QPs of SQP_WITH_FEASIBLE_QP have additional slacks
+    ocp_qp_dims *qp_dims[2] = {solver->dims->qp_solver->orig_dims, solver->dims->relaxed_qp_solver->orig_dims};
+
+    ocp_qp_capture_free(nlp_mem->qp_capture);
+    nlp_mem->qp_capture = ocp_qp_capture_create(qp_dims, 2, prefix, num_files, records_per_file);
+
+    return nlp_mem->qp_capture == NULL ? 1 : 0;
+}
+
+
+void ocp_nlp_qp_capture_stop(ocp_nlp_solver *solver)
+{
+    ocp_nlp_memory *nlp_mem;
+    ocp_nlp_get(solver, "nlp_mem", &nlp_mem);
+
+    ocp_qp_capture_free(nlp_mem->qp_capture);
+    nlp_mem->qp_capture = NULL;
+}
+
+
+
+static acados_size_t ocp_nlp_feedback_law_calculate_size(int nx, int nu, int nbu, int nx1, int ng)
+{
+    acados_size_t size = sizeof(ocp_nlp_feedback_law);
+
+    size += (nx + nu + nu*nx + 2*nbu) * sizeof(double);  // x_ref, u_ref, K, lbu, ubu
+    size += (nx1*nx1 + nx1*nx + nx1*nu + nu*nu + nx1*nx) * sizeof(double);  // P, A, B, Lr, tmp
+    size += (ng*nx + ng*nu + ng) * sizeof(double);  // C, D, sigma
+    size += nbu * sizeof(int);  // idxbu
+
+    size += 8;  // initial align
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+ocp_nlp_feedback_law *ocp_nlp_feedback_law_create(ocp_nlp_solver *solver, ocp_nlp_in *in)
+{
+    ocp_nlp_config *config = solver->config;
+    ocp_nlp_dims *dims = solver->dims;
+    ocp_nlp_memory *nlp_mem;
+    config->get(config, dims, solver->mem, "nlp_mem", &nlp_mem);
+
+    int nx = dims->nx[0];
+    int nu = dims->nu[0];
+    int nx1 = dims->N > 0 ? dims->nx[1] : 0;
+    int ng = nlp_mem->qp_in->dim->ng[0];
+    int nbu;
+    config->constraints[0]->dims_get(config->constraints[0], dims->constraints[0], "nbu", &nbu);
+
+    acados_size_t bytes = ocp_nlp_feedback_law_calculate_size(nx, nu, nbu, nx1, ng);
+    void *ptr = acados_calloc(1, bytes);
+    assert(ptr != 0);
+
+    char *c_ptr = (char *) ptr;
+    ocp_nlp_feedback_law *law = (ocp_nlp_feedback_law *) c_ptr;
+    c_ptr += sizeof(ocp_nlp_feedback_law);
+
+    align_char_to(8, &c_ptr);
+
+    assign_and_advance_double(nx, &law->x_ref, &c_ptr);
+    assign_and_advance_double(nu, &law->u_ref, &c_ptr);
+    assign_and_advance_double(nu*nx, &law->K, &c_ptr);
+    assign_and_advance_double(nbu, &law->lbu, &c_ptr);
+    assign_and_advance_double(nbu, &law->ubu, &c_ptr);
+    assign_and_advance_double(nx1*nx1, &law->P, &c_ptr);
+    assign_and_advance_double(nx1*nx, &law->A, &c_ptr);
+    assign_and_advance_double(nx1*nu, &law->B, &c_ptr);
+    assign_and_advance_double(nu*nu, &law->Lr, &c_ptr);
+    assign_and_advance_double(nx1*nx, &law->tmp, &c_ptr);
+    assign_and_advance_double(ng*nx, &law->C, &c_ptr);
+    assign_and_advance_double(ng*nu, &law->D, &c_ptr);
+    assign_and_advance_double(ng, &law->sigma, &c_ptr);
+    assign_and_advance_int(nbu, &law->idxbu, &c_ptr);
+
+    assert((char *) ptr + bytes >= c_ptr);
+
+    law->nx = nx;
+    law->nu = nu;
+    law->nbu = nbu;
+    law->ng = ng;
+    law->raw_memory = ptr;
+
+    // input bounds, updated in ocp_nlp_feedback_law_update
+    if (nbu > 0)
+    {
+        ocp_nlp_constraints_model_get(config, dims, in, 0, "idxbu", law->idxbu);
+        ocp_nlp_constraints_model_get(config, dims, in, 0, "lbu", law->lbu);
+        ocp_nlp_constraints_model_get(config, dims, in, 0, "ubu", law->ubu);
+    }
+
+    return law;
+}
+
+
+
+void ocp_nlp_feedback_law_destroy(ocp_nlp_feedback_law *law)
+{
+    free(law->raw_memory);
+}
+
+
+
+int ocp_nlp_feedback_law_update(ocp_nlp_solver *solver, ocp_nlp_in *in, ocp_nlp_out *out,
+                                ocp_nlp_feedback_law *law)
+{
+    ocp_nlp_config *config = solver->config;
+    ocp_nlp_dims *dims = solver->dims;
+    ocp_nlp_memory *nlp_mem;
+    config->get(config, dims, solver->mem, "nlp_mem", &nlp_mem);
+
+    int nx = law->nx;
+    int nu = law->nu;
+    int ng = law->ng;
+    int ii, jj, kk;
+
+    // the Riccati factors of a QP solved in single precision only are not available
+    int riccati_double;
+    config->qp_solver->memory_get(config->qp_solver, nlp_mem->qp_solver_mem, "riccati_double", &riccati_double);
+    if (!riccati_double)
+    {
+        printf("\nocp_nlp_feedback_law_update: the last QP was solved in single precision only, law not updated.\n");
+        return 1;
+    }
+
+    int x0_eliminated = nlp_mem->qp_in->dim->nbxe[0] > 0 && dims->N > 0;
+    if (x0_eliminated)
+    {
+        // the cross term of soft general constraints would need the slack elimination, not supported
+        ocp_qp_in *qp_in = nlp_mem->scaled_qp_in;
+        int nb = qp_in->dim->nb[0];
+        for (ii = 0; ii < ng; ii++)
+        {
+            if (qp_in->idxs_rev[0][nb+ii] >= 0)
+            {
+                printf("\nocp_nlp_feedback_law_update: soft general constraints at stage 0 with eliminated x0 not supported, law not updated.\n");
+                return 2;
+            }
+        }
+    }
+
+    ocp_nlp_out_get(config, dims, out, 0, "x", law->x_ref);
+    ocp_nlp_out_get(config, dims, out, 0, "u", law->u_ref);
+
+    if (!x0_eliminated)
+    {
+        ocp_nlp_get_at_stage(solver, 0, "K", law->K);
+    }
+    else
+    {
+        // x0 is eliminated from the QP, the stage 0 factorization only covers the inputs:
+        // K = - (Lr Lr^T)^{-1} (S + B^T P_1 A + D^T Sigma C), where Lr Lr^T = R + B^T P_1 B + barrier terms
+        // and Sigma = lam / t are the barrier weights of the general constraints of stage 0.
+        // NOTE: bounds do not couple x and u, their barrier terms are contained in Lr.
+        ocp_qp_in *qp_in = nlp_mem->scaled_qp_in;
+        ocp_qp_out *qp_out = nlp_mem->scaled_qp_out;
+        int nx1 = dims->nx[1];
+        ocp_nlp_get_at_stage(solver, 1, "P", law->P);
+        ocp_nlp_get_at_stage(solver, 0, "Lr", law->Lr);
+        d_ocp_qp_get_A(0, qp_in, law->A);
+        d_ocp_qp_get_B(0, qp_in, law->B);
+        d_ocp_qp_get_S(0, qp_in, law->K);
+
+        double *P = law->P;
+        double *A = law->A;
+        double *B = law->B;
+        double *Lr = law->Lr;
+        double *K = law->K;
+        double *tmp = law->tmp;
+
+        // tmp = P_1 A
+        for (jj = 0; jj < nx; jj++)
+        {
+            for (ii = 0; ii < nx1; ii++)
+            {
+                tmp[ii+nx1*jj] = 0.0;
+                for (kk = 0; kk < nx1; kk++)
+                    tmp[ii+nx1*jj] += P[ii+nx1*kk] * A[kk+nx1*jj];
+            }
+        }
+        // K = S + B^T tmp
+        for (jj = 0; jj < nx; jj++)
+        {
+            for (ii = 0; ii < nu; ii++)
+            {
+                for (kk = 0; kk < nx1; kk++)
+                    K[ii+nu*jj] += B[kk+nx1*ii] * tmp[kk+nx1*jj];
+            }
+        }
+        // K += D^T Sigma C
+        if (ng > 0)
+        {
+            int nb = qp_in->dim->nb[0];
+            double *C = law->C;
+            double *D = law->D;
+            double *sigma = law->sigma;
+            d_ocp_qp_get_C(0, qp_in, C);
+            d_ocp_qp_get_D(0, qp_in, D);
+            // lam and t are ordered as [lb, lg, ub, ug, ls, us]
+            for (kk = 0; kk < ng; kk++)
+            {
+                sigma[kk] = BLASFEO_DVECEL(qp_out->lam, nb+kk) / BLASFEO_DVECEL(qp_out->t, nb+kk)
+                          + BLASFEO_DVECEL(qp_out->lam, 2*nb+ng+kk) / BLASFEO_DVECEL(qp_out->t, 2*nb+ng+kk);
+            }
+            for (jj = 0; jj < nx; jj++)
+            {
+                for (ii = 0; ii < nu; ii++)
+                {
+                    for (kk = 0; kk < ng; kk++)
+                        K[ii+nu*jj] += D[kk+ng*ii] * sigma[kk] * C[kk+ng*jj];
+                }
+            }
+        }
+        // K = - Lr^{-T} Lr^{-1} K, columnwise; only the lower triangle of Lr is referenced
+        for (jj = 0; jj < nx; jj++)
+        {
+            double *k = K + nu*jj;
+            for (ii = 0; ii < nu; ii++)
+            {
+                for (kk = 0; kk < ii; kk++)
+                    k[ii] -= Lr[ii+nu*kk] * k[kk];
+                k[ii] /= Lr[ii+nu*ii];
+            }
+            for (ii = nu-1; ii >= 0; ii--)
+            {
+                for (kk = ii+1; kk < nu; kk++)
+                    k[ii] -= Lr[kk+nu*ii] * k[kk];
+                k[ii] /= Lr[ii+nu*ii];
+            }
+            for (ii = 0; ii < nu; ii++)
+                k[ii] = -k[ii];
+        }
+    }
+
+    if (law->nbu > 0)
+    {
+        ocp_nlp_constraints_model_get(config, dims, in, 0, "idxbu", law->idxbu);
+        ocp_nlp_constraints_model_get(config, dims, in, 0, "lbu", law->lbu);
+        ocp_nlp_constraints_model_get(config, dims, in, 0, "ubu", law->ubu);
+    }
+
+    return 0;
+}
+
+
+
+void ocp_nlp_feedback_law_eval(const ocp_nlp_feedback_law *law, const double *x, double *u, int clip)
+{
+    int nx = law->nx;
+    int nu = law->nu;
+    int ii, jj;
+
+    for (ii = 0; ii < nu; ii++)
+        u[ii] = law->u_ref[ii];
+
+    for (jj = 0; jj < nx; jj++)
+    {
+        double dx = x[jj] - law->x_ref[jj];
+        for (ii = 0; ii < nu; ii++)
+            u[ii] += law->K[ii+nu*jj] * dx;
+    }
+
+    if (clip)
+    {
+        for (ii = 0; ii < law->nbu; ii++)
+        {
+            jj = law->idxbu[ii];
+            if (u[jj] < law->lbu[ii])
+                u[jj] = law->lbu[ii];
+            else if (u[jj] > law->ubu[ii])
+                u[jj] = law->ubu[ii];
+        }
+    }
+}
+
+
+
+static void ocp_nlp_async_rti_set_phase(ocp_nlp_async_rti *async, int rti_phase)
+{
+    ocp_nlp_solver_opts_set(async->solver->config, async->solver->opts, "rti_phase", &rti_phase);
+}
+
+
+
+static void ocp_nlp_async_rti_prepare(void *async_)
+{
+    ocp_nlp_async_rti *async = async_;
+
+    ocp_nlp_async_rti_set_phase(async, PREPARATION);
+    async->status_preparation = ocp_nlp_solve(async->solver, async->in, async->out);
+    async->num_preparations++;
+}
+
+
+
+ocp_nlp_async_rti *ocp_nlp_async_rti_create(ocp_nlp_solver *solver, ocp_nlp_in *in,
+                                            ocp_nlp_out *out, int core)
+{
+#if defined(ACADOS_WITH_THREAD_POOL)
+    ocp_nlp_config *config = solver->config;
+    if (!config->is_real_time_algorithm())
+    {
+        printf("\nerror: ocp_nlp_async_rti_create: only available for SQP_RTI.\n");
+        return NULL;
+    }
+    int as_rti_level;
+    config->opts_get(config, solver->opts, "as_rti_level", &as_rti_level);
+    if (as_rti_level != STANDARD_RTI)
+    {
+        printf("\nerror: ocp_nlp_async_rti_create: only available for as_rti_level = %d, got %d.\n",
+               STANDARD_RTI, as_rti_level);
+        return NULL;
+    }
+
+    ocp_nlp_async_rti *async = acados_calloc(1, sizeof(ocp_nlp_async_rti));
+    assert(async != 0);
+
+    async->worker = acados_worker_create(core);
+    if (async->worker == NULL)
+    {
+        free(async);
+        return NULL;
+    }
+    async->solver = solver;
+    async->in = in;
+    async->out = out;
+
+    return async;
+#else
+    printf("\nerror: ocp_nlp_async_rti_create: acados was compiled without ACADOS_WITH_THREAD_POOL.\n");
+    return NULL;
+#endif
+}
+
+
+
+void ocp_nlp_async_rti_destroy(ocp_nlp_async_rti *async)
+{
+#if defined(ACADOS_WITH_THREAD_POOL)
+    if (async == NULL)
+        return;
+    acados_worker_destroy(async->worker);
+    free(async);
+#endif
+}
+
+
+
+void ocp_nlp_prepare_async(ocp_nlp_async_rti *async)
+{
+#if defined(ACADOS_WITH_THREAD_POOL)
+    if (async->pending)
+    {
+        // preparation already running or done, not consumed yet
+        return;
+    }
+    async->pending = 1;
+    acados_worker_start(async->worker, &ocp_nlp_async_rti_prepare, async);
+#endif
+}
+
+
+
+int ocp_nlp_feedback_async(ocp_nlp_async_rti *async, double *x0)
+{
+    async->time_wait = 0.0;
+    if (async->pending)
+    {
+#if defined(ACADOS_WITH_THREAD_POOL)
+        acados_timer timer;
+        acados_tic(&timer);
+        if (acados_worker_wait(async->worker))
+            async->num_overruns++;
+        async->time_wait = acados_toc(&timer);
+#endif
+        async->pending = 0;
+    }
+    else
+    {
+        ocp_nlp_async_rti_prepare(async);
+    }
+
+    if (async->status_preparation != ACADOS_SUCCESS && async->status_preparation != ACADOS_READY)
+        return async->status_preparation;
+
+    ocp_nlp_solver *solver = async->solver;
+    if (x0 != NULL)
+    {
+        ocp_nlp_constraints_model_set(solver->config, solver->dims, async->in, async->out, 0, "lbx", x0);
+        ocp_nlp_constraints_model_set(solver->config, solver->dims, async->in, async->out, 0, "ubx", x0);
+    }
+
+    ocp_nlp_async_rti_set_phase(async, FEEDBACK);
+    return ocp_nlp_solve(solver, async->in, async->out);
+}
+
+
+
+void ocp_nlp_async_rti_get(ocp_nlp_async_rti *async, const char *field, void *value)
+{
+    if (!strcmp(field, "num_preparations"))
+    {
+        *((int *) value) = async->num_preparations;
+    }
+    else if (!strcmp(field, "num_overruns"))
+    {
+        *((int *) value) = async->num_overruns;
+    }
+    else if (!strcmp(field, "status_preparation"))
+    {
+        *((int *) value) = async->status_preparation;
+    }
+    else if (!strcmp(field, "time_wait"))
+    {
+        *((double *) value) = async->time_wait;
+    }
+    else
+    {
+        printf("\nerror: ocp_nlp_async_rti_get: field %s not available\n", field);
+        exit(1);
+    }
+}
+
+
+
+ocp_nlp_scenario_tree_solver *ocp_nlp_scenario_tree_solver_create(ocp_nlp_solver **solvers,
+                        ocp_nlp_in **in, ocp_nlp_out **out, int n_realizations, int n_robust)
+{
+    ocp_nlp_config *config = solvers[0]->config;
+    ocp_nlp_dims *nlp_dims = solvers[0]->dims;
+
+    // the tree QP is regularized stage-wise on the scenario QPs, which is only valid for
+    // regularizations that act on the Hessian blocks of the stages independently
+    void (*regularize)(void *, ocp_nlp_reg_dims *, void *, void *) = config->regularize->regularize;
+    if (regularize != &ocp_nlp_reg_noreg_regularize && regularize != &ocp_nlp_reg_mirror_regularize &&
+        regularize != &ocp_nlp_reg_project_regularize)
+    {
+        printf("\nerror: ocp_nlp_scenario_tree_solver_create: only available for the regularizations"
+               " NO_REGULARIZE, MIRROR and PROJECT.\n");
+        return NULL;
+    }
+
+    // dims
+    acados_size_t dims_size = ocp_nlp_scenario_tree_dims_calculate_size(n_realizations, n_robust, nlp_dims->N);
+    void *dims_mem = acados_calloc(1, dims_size);
+    assert(dims_mem != NULL);
+    ocp_nlp_scenario_tree_dims *dims = ocp_nlp_scenario_tree_dims_assign(nlp_dims, n_realizations,
+                                                                         n_robust, dims_mem);
+
+    // opts
+    acados_size_t opts_size = ocp_nlp_scenario_tree_opts_calculate_size(dims);
+    void *opts_mem = acados_calloc(1, opts_size);
+    assert(opts_mem != NULL);
+    ocp_nlp_scenario_tree_opts *opts = ocp_nlp_scenario_tree_opts_assign(dims, opts_mem);
+    ocp_nlp_scenario_tree_opts_initialize_default(dims, opts);
+
+    // memory
+    acados_size_t mem_size = ocp_nlp_scenario_tree_memory_calculate_size(dims, opts);
+    void *mem_mem = acados_calloc(1, mem_size);
+    assert(mem_mem != NULL);
+    ocp_nlp_scenario_tree_memory *mem = ocp_nlp_scenario_tree_memory_assign(dims, opts, mem_mem);
+
+    for (int s = 0; s < dims->num_scenarios; s++)
+    {
+        if (solvers[s]->config != config || solvers[s]->dims != nlp_dims)
+        {
+            printf("\nerror: ocp_nlp_scenario_tree_solver_create: scenario %d does not share config and dims"
+                   " with scenario 0, use solvers of the same batch.\n", s);
+            exit(1);
+        }
+        ocp_nlp_memory *nlp_mem;
+        ocp_nlp_opts *nlp_opts;
+        ocp_nlp_workspace *nlp_work;
+        config->get(config, nlp_dims, solvers[s]->mem, "nlp_mem", &nlp_mem);
+        config->opts_get(config, solvers[s]->opts, "nlp_opts", &nlp_opts);
+        config->work_get(config, nlp_dims, solvers[s]->work, "nlp_work", &nlp_work);
+        ocp_nlp_scenario_tree_memory_set_scenario(dims, mem, s, in[s], out[s], nlp_opts, nlp_mem, nlp_work);
+    }
+
+    ocp_nlp_scenario_tree_solver *solver = acados_calloc(1, sizeof(ocp_nlp_scenario_tree_solver));
+    assert(solver != NULL);
+    solver->config = config;
+    solver->nlp_dims = nlp_dims;
+    solver->dims = dims;
+    solver->opts = opts;
+    solver->mem = mem;
+    solver->raw_memory = mem_mem;
+
+    return solver;
+}
+
+
+
+void ocp_nlp_scenario_tree_solver_destroy(ocp_nlp_scenario_tree_solver *solver)
+{
+    if (solver == NULL)
+        return;
+    ocp_nlp_scenario_tree_terminate(solver->mem);
+    free(solver->raw_memory);
+    free(solver->opts);
+    free(solver->dims);
+    free(solver);
+}
+
+
+
+void ocp_nlp_scenario_tree_solver_opts_set(ocp_nlp_scenario_tree_solver *solver, const char *field, void *value)
+{
+    ocp_nlp_scenario_tree_opts_set(solver->opts, field, value);
+}
+
+
+
+void ocp_nlp_scenario_tree_solver_set(ocp_nlp_scenario_tree_solver *solver, const char *field, void *value)
+{
+    ocp_nlp_scenario_tree_memory_set(solver->dims, solver->mem, field, value);
+}
+
+
+
+int ocp_nlp_scenario_tree_solver_solve(ocp_nlp_scenario_tree_solver *solver)
+{
+    return ocp_nlp_scenario_tree_solve(solver->config, solver->nlp_dims, solver->dims, solver->opts, solver->mem);
+}
+
+
+
+void ocp_nlp_scenario_tree_solver_get(ocp_nlp_scenario_tree_solver *solver, const char *field, void *value)
+{
+    ocp_nlp_scenario_tree_memory_get(solver->dims, solver->mem, field, value);
+}
+
+
 
 static void get_from_qp_in(ocp_qp_in *qp_in, int stage, const char *field, void *value)
 {
@@ -1518,6 +2273,22 @@ static void get_from_qp_in(ocp_qp_in *qp_in, int stage, const char *field, void
         double *double_values = value;
         d_ocp_qp_get_q(stage, qp_in, double_values);
     }
+    // pointers to the data of the vectors which are stored contiguously and with the same sign
+    else if (!strcmp(field, "b_ptr"))
+    {
+        double **ptr = value;
+        ptr[0] = qp_in->b[stage].pa;
+    }
+    else if (!strcmp(field, "r_ptr"))
+    {
+        double **ptr = value;
+        ptr[0] = qp_in->rqz[stage].pa;
+    }
+    else if (!strcmp(field, "q_ptr"))
+    {
+        double **ptr = value;
+        ptr[0] = qp_in->rqz[stage].pa + qp_in->dim->nu[stage];
+    }
     else if (!strcmp(field, "lbx"))
     {
         double *double_values = value;
@@ -1643,6 +2414,22 @@ void ocp_nlp_get_at_stage(ocp_nlp_solver *solver, int stage, const char *field,
     {
         ocp_nlp_memory_get_at_stage(config, dims, nlp_mem, stage, field, value);
     }
+    else if (!strcmp(field, "qp_x"))
+    {
+        blasfeo_unpack_dvec(dims->nx[stage], nlp_mem->qp_out->ux+stage, dims->nu[stage], value, 1);
+    }
+    else if (!strcmp(field, "qp_u"))
+    {
+        blasfeo_unpack_dvec(dims->nu[stage], nlp_mem->qp_out->ux+stage, 0, value, 1);
+    }
+    else if (!strcmp(field, "qp_pi"))
+    {
+        blasfeo_unpack_dvec(dims->nx[stage+1], nlp_mem->qp_out->pi+stage, 0, value, 1);
+    }
+    else if (!strcmp(field, "qp_lam"))
+    {
+        blasfeo_unpack_dvec(2*dims->ni[stage], nlp_mem->qp_out->lam+stage, 0, value, 1);
+    }
     else if (!strcmp(field, "pcond_Q"))
     {
         ocp_qp_in *pcond_qp_in;
@@ -1995,6 +2782,381 @@ void ocp_nlp_set_all(ocp_nlp_solver *solver, ocp_nlp_in *in, ocp_nlp_out *out, c
 }
 
 
+/************************************************
+* field handles
+************************************************/
+
+static acados_size_t ocp_nlp_field_handle_calculate_size(int num_stages)
+{
+    acados_size_t size = sizeof(ocp_nlp_field_handle);
+
+    size += 3*num_stages*sizeof(struct blasfeo_dvec *);  // vec, dmask, lam
+    size += 1*num_stages*sizeof(double *);  // param
+    size += 2*num_stages*sizeof(void *);  // constr_config, constr_model
+    size += 2*num_stages*sizeof(int);  // size, offset
+
+    size += 8;  // initial align
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+static ocp_nlp_field_handle *ocp_nlp_field_handle_assign(int num_stages, void *raw_memory)
+{
+    char *c_ptr = (char *) raw_memory;
+
+    ocp_nlp_field_handle *handle = (ocp_nlp_field_handle *) c_ptr;
+    c_ptr += sizeof(ocp_nlp_field_handle);
+
+    align_char_to(8, &c_ptr);
+
+    handle->vec = (struct blasfeo_dvec **) c_ptr;
+    c_ptr += num_stages*sizeof(struct blasfeo_dvec *);
+    handle->dmask = (struct blasfeo_dvec **) c_ptr;
+    c_ptr += num_stages*sizeof(struct blasfeo_dvec *);
+    handle->lam = (struct blasfeo_dvec **) c_ptr;
+    c_ptr += num_stages*sizeof(struct blasfeo_dvec *);
+    assign_and_advance_double_ptrs(num_stages, &handle->param, &c_ptr);
+    handle->constr_config = (ocp_nlp_constraints_config **) c_ptr;
+    c_ptr += num_stages*sizeof(ocp_nlp_constraints_config *);
+    handle->constr_model = (void **) c_ptr;
+    c_ptr += num_stages*sizeof(void *);
+
+    assign_and_advance_int(num_stages, &handle->size, &c_ptr);
+    assign_and_advance_int(num_stages, &handle->offset, &c_ptr);
+
+    assert((char *) raw_memory + ocp_nlp_field_handle_calculate_size(num_stages) >= c_ptr);
+
+    return handle;
+}
+
+
+
+// resolves field at stage into the handle entry jj, returns the storage type or -1 if not available
+static int ocp_nlp_field_handle_resolve(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+        ocp_nlp_out *out, const char *field, int stage, ocp_nlp_field_handle *handle, int jj)
+{
+    int nx = dims->nx[stage];
+    int nu = dims->nu[stage];
+    int ns = dims->ns[stage];
+
+    handle->vec[jj] = NULL;
+    handle->dmask[jj] = NULL;
+    handle->lam[jj] = NULL;
+    handle->param[jj] = NULL;
+    handle->constr_config[jj] = NULL;
+    handle->constr_model[jj] = NULL;
+    handle->offset[jj] = 0;
+    handle->size[jj] = 0;
+
+    // ocp_nlp_out
+    if (!strcmp(field, "x"))
+    {
+        handle->vec[jj] = &out->ux[stage];
+        handle->offset[jj] = nu;
+        handle->size[jj] = nx;
+        return OCP_NLP_FIELD_VEC;
+    }
+    else if (!strcmp(field, "u"))
+    {
+        handle->vec[jj] = &out->ux[stage];
+        handle->size[jj] = nu;
+        return OCP_NLP_FIELD_VEC;
+    }
+    else if (!strcmp(field, "sl"))
+    {
+        handle->vec[jj] = &out->ux[stage];
+        handle->offset[jj] = nu + nx;
+        handle->size[jj] = ns;
+        return OCP_NLP_FIELD_VEC;
+    }
+    else if (!strcmp(field, "su"))
+    {
+        handle->vec[jj] = &out->ux[stage];
+        handle->offset[jj] = nu + nx + ns;
+        handle->size[jj] = ns;
+        return OCP_NLP_FIELD_VEC;
+    }
+    else if (!strcmp(field, "z"))
+    {
+        handle->vec[jj] = &out->z[stage];
+        handle->size[jj] = dims->nz[stage];
+        return OCP_NLP_FIELD_VEC;
+    }
+    else if (!strcmp(field, "pi"))
+    {
+        if (stage >= dims->N)
+            return -1;
+        handle->vec[jj] = &out->pi[stage];
+        handle->size[jj] = dims->nx[stage+1];
+        return OCP_NLP_FIELD_VEC;
+    }
+    else if (!strcmp(field, "lam"))
+    {
+        handle->vec[jj] = &out->lam[stage];
+        handle->dmask[jj] = &in->dmask[stage];
+        handle->size[jj] = 2*dims->ni[stage];
+        return OCP_NLP_FIELD_LAM;
+    }
+    // ocp_nlp_in
+    else if (!strcmp(field, "p") || !strcmp(field, "parameter_values"))
+    {
+        handle->param[jj] = in->parameter_values[stage];
+        handle->size[jj] = dims->np[stage];
+        return OCP_NLP_FIELD_PARAM;
+    }
+    // cost
+    else if (!strcmp(field, "yref") || !strcmp(field, "y_ref"))
+    {
+        ocp_nlp_cost_config *cost_config = config->cost[stage];
+        if (cost_config->model_get_y_ref_ptr == NULL)
+            return -1;
+        handle->vec[jj] = cost_config->model_get_y_ref_ptr(in->cost[stage]);
+        cost_config->dims_get(cost_config, dims->cost[stage], "ny", &handle->size[jj]);
+        return OCP_NLP_FIELD_VEC;
+    }
+
+    // constraints, d = [lbu lbx lg lh ubu ubx ug uh ls us], nonlinear block is h or phi
+    ocp_nlp_constraints_config *constr_config = config->constraints[stage];
+    if (constr_config->model_get_d_ptr == NULL)
+        return -1;
+
+    int nbu, nbx, ng, nnl;
+    constr_config->dims_get(constr_config, dims->constraints[stage], "nbu", &nbu);
+    constr_config->dims_get(constr_config, dims->constraints[stage], "nbx", &nbx);
+    constr_config->dims_get(constr_config, dims->constraints[stage], "ng", &ng);
+    constr_config->dims_get(constr_config, dims->constraints[stage], "ni_nl", &nnl);
+    int nb = nbu + nbx;
+    int type;
+
+    if (!strcmp(field, "lbu"))
+    {
+        handle->offset[jj] = 0;
+        handle->size[jj] = nbu;
+        type = OCP_NLP_FIELD_BOUND_LOWER;
+    }
+    else if (!strcmp(field, "lbx"))
+    {
+        handle->offset[jj] = nbu;
+        handle->size[jj] = nbx;
+        type = OCP_NLP_FIELD_BOUND_LOWER;
+    }
+    else if (!strcmp(field, "lg"))
+    {
+        handle->offset[jj] = nb;
+        handle->size[jj] = ng;
+        type = OCP_NLP_FIELD_BOUND_LOWER;
+    }
+    else if (!strcmp(field, "lh") || !strcmp(field, "lphi"))
+    {
+        handle->offset[jj] = nb + ng;
+        handle->size[jj] = nnl;
+        type = OCP_NLP_FIELD_BOUND_LOWER;
+    }
+    else if (!strcmp(field, "ubu"))
+    {
+        handle->offset[jj] = nb + ng + nnl;
+        handle->size[jj] = nbu;
+        type = OCP_NLP_FIELD_BOUND_UPPER;
+    }
+    else if (!strcmp(field, "ubx"))
+    {
+        handle->offset[jj] = nb + ng + nnl + nbu;
+        handle->size[jj] = nbx;
+        type = OCP_NLP_FIELD_BOUND_UPPER;
+    }
+    else if (!strcmp(field, "ug"))
+    {
+        handle->offset[jj] = 2*nb + ng + nnl;
+        handle->size[jj] = ng;
+        type = OCP_NLP_FIELD_BOUND_UPPER;
+    }
+    else if (!strcmp(field, "uh") || !strcmp(field, "uphi"))
+    {
+        handle->offset[jj] = 2*nb + 2*ng + nnl;
+        handle->size[jj] = nnl;
+        type = OCP_NLP_FIELD_BOUND_UPPER;
+    }
+    else
+    {
+        return -1;
+    }
+
+    handle->vec[jj] = constr_config->model_get_d_ptr(in->constraints[stage]);
+    handle->dmask[jj] = &in->dmask[stage];
+    handle->lam[jj] = &out->lam[stage];
+    handle->constr_config[jj] = constr_config;
+    handle->constr_model[jj] = in->constraints[stage];
+
+    return type;
+}
+
+
+
+ocp_nlp_field_handle *ocp_nlp_field_handle_create(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        ocp_nlp_in *in, ocp_nlp_out *out, const char *field, int stage_first, int stage_last)
+{
+    if (stage_first < 0 || stage_last > dims->N || stage_first > stage_last)
+    {
+        printf("\nerror: ocp_nlp_field_handle_create: invalid stage range [%d, %d]\n", stage_first, stage_last);
+        exit(1);
+    }
+
+    int num_stages = stage_last - stage_first + 1;
+
+    acados_size_t bytes = ocp_nlp_field_handle_calculate_size(num_stages);
+    void *ptr = acados_calloc(1, bytes);
+    assert(ptr != 0);
+
+    ocp_nlp_field_handle *handle = ocp_nlp_field_handle_assign(num_stages, ptr);
+    handle->raw_memory = ptr;
+
+    handle->stage_first = stage_first;
+    handle->stage_last = stage_last;
+    handle->size_total = 0;
+
+    for (int jj = 0; jj < num_stages; jj++)
+    {
+        int type = ocp_nlp_field_handle_resolve(config, dims, in, out, field, stage_first + jj, handle, jj);
+        // all stages have to resolve to the same storage type
+        if (type < 0 || (jj > 0 && type != (int) handle->type))
+        {
+            free(ptr);
+            return NULL;
+        }
+        handle->type = type;
+        handle->size_total += handle->size[jj];
+    }
+
+    return handle;
+}
+
+
+
+void ocp_nlp_field_handle_destroy(ocp_nlp_field_handle *handle)
+{
+    free(handle->raw_memory);
+}
+
+
+
+static void ocp_nlp_field_handle_set_at(ocp_nlp_field_handle *handle, int jj, const double *value)
+{
+    int size = handle->size[jj];
+    int offset = handle->offset[jj];
+    struct blasfeo_dvec *vec = handle->vec[jj];
+    struct blasfeo_dvec *dmask = handle->dmask[jj];
+    int ii;
+
+    switch (handle->type)
+    {
+        case OCP_NLP_FIELD_VEC:
+            blasfeo_pack_dvec(size, (double *) value, 1, vec, offset);
+            break;
+
+        case OCP_NLP_FIELD_LAM:
+            blasfeo_pack_dvec(size, (double *) value, 1, vec, offset);
+            // multiply with mask to ensure that multiplier associated with masked constraints are zero
+            blasfeo_dvecmul(size, dmask, offset, vec, offset, vec, offset);
+            break;
+
+        case OCP_NLP_FIELD_BOUND_LOWER:
+            blasfeo_pack_dvec(size, (double *) value, 1, vec, offset);
+            handle->constr_config[jj]->model_update_mask_lower(handle->constr_model[jj], size, offset);
+            // lam and d share the layout
+            blasfeo_dvecmul(size, dmask, offset, handle->lam[jj], offset, handle->lam[jj], offset);
+            break;
+
+        case OCP_NLP_FIELD_BOUND_UPPER:
+            blasfeo_pack_dvec(size, (double *) value, 1, vec, offset);
+            handle->constr_config[jj]->model_update_mask_upper(handle->constr_model[jj], size, offset);
+            // lam and d share the layout
+            blasfeo_dvecmul(size, dmask, offset, handle->lam[jj], offset, handle->lam[jj], offset);
+            break;
+
+        case OCP_NLP_FIELD_PARAM:
+            for (ii = 0; ii < size; ii++)
+                handle->param[jj][ii] = value[ii];
+            break;
+    }
+}
+
+
+
+static void ocp_nlp_field_handle_get_at(ocp_nlp_field_handle *handle, int jj, double *value)
+{
+    int ii;
+
+    if (handle->type == OCP_NLP_FIELD_PARAM)
+    {
+        for (ii = 0; ii < handle->size[jj]; ii++)
+            value[ii] = handle->param[jj][ii];
+    }
+    else
+    {
+        blasfeo_unpack_dvec(handle->size[jj], handle->vec[jj], handle->offset[jj], value, 1);
+    }
+}
+
+
+
+void ocp_nlp_field_handle_set(ocp_nlp_field_handle *handle, int stage, const double *value)
+{
+    ocp_nlp_field_handle_set_at(handle, stage - handle->stage_first, value);
+}
+
+
+
+void ocp_nlp_field_handle_get(ocp_nlp_field_handle *handle, int stage, double *value)
+{
+    ocp_nlp_field_handle_get_at(handle, stage - handle->stage_first, value);
+}
+
+
+
+void ocp_nlp_field_handle_set_all(ocp_nlp_field_handle *handle, const double *value)
+{
+    int num_stages = handle->stage_last - handle->stage_first + 1;
+    int tmp_offset = 0;
+
+    for (int jj = 0; jj < num_stages; jj++)
+    {
+        ocp_nlp_field_handle_set_at(handle, jj, value + tmp_offset);
+        tmp_offset += handle->size[jj];
+    }
+}
+
+
+
+void ocp_nlp_field_handle_get_all(ocp_nlp_field_handle *handle, double *value)
+{
+    int num_stages = handle->stage_last - handle->stage_first + 1;
+    int tmp_offset = 0;
+
+    for (int jj = 0; jj < num_stages; jj++)
+    {
+        ocp_nlp_field_handle_get_at(handle, jj, value + tmp_offset);
+        tmp_offset += handle->size[jj];
+    }
+}
+
+
+
+double *ocp_nlp_field_handle_get_ptr(ocp_nlp_field_handle *handle, int stage)
+{
+    int jj = stage - handle->stage_first;
+
+    if (handle->type == OCP_NLP_FIELD_PARAM)
+        return handle->param[jj];
+
+    // blasfeo vectors are stored contiguously
+    return handle->vec[jj]->pa + handle->offset[jj];
+}
+
+
+
 void ocp_nlp_set(ocp_nlp_solver *solver, int stage, const char *field, void *value)
 {
     ocp_nlp_memory *mem;
@@ -152,6 +152,113 @@ typedef struct ocp_nlp_solver
 } ocp_nlp_solver;
 
 
+/// Structure to store a batch of solver instances, which share the configuration and dimensions
+/// of a prototype solver. The options, inputs, outputs, memory and workspace of all instances are
+/// placed in a single contiguous memory block.
+typedef struct ocp_nlp_solver_batch
+{
+    ocp_nlp_config *config;
+    ocp_nlp_dims *dims;
+    int N_batch;
+    void **opts;
+    ocp_nlp_in **nlp_in;
+    ocp_nlp_out **nlp_out;
+    ocp_nlp_out **sens_out;
+    ocp_nlp_solver **solver;
+    void **solver_raw_memory;
+    acados_size_t solver_memsize;
+    acados_size_t memsize;
+    void *raw_memory;
+} ocp_nlp_solver_batch;
+
+
+/// Affine feedback law u = u_ref + K (x - x_ref) at stage 0, obtained from the Riccati recursion of
+/// the last QP solve. Evaluating it costs O(nx*nu) and does not touch the solver,
+/// e.g. to act on new state estimates between two RTI iterations.
+typedef struct ocp_nlp_feedback_law
+{
+    int nx;
+    int nu;
+    int nbu;
+    int ng;         // general constraints of the stage 0 QP, including the linearized nonlinear ones
+    double *x_ref;
+    double *u_ref;
+    double *K;      // nu x nx, column major
+    double *lbu;    // input bounds of stage 0, for clipping
+    double *ubu;
+    int *idxbu;
+    // workspace
+    double *P;
+    double *A;
+    double *B;
+    double *Lr;
+    double *tmp;
+    double *C;
+    double *D;
+    double *sigma;  // barrier weights of the general constraints
+    void *raw_memory;
+} ocp_nlp_feedback_law;
+
+
+/// Runs the preparation phase of an SQP_RTI solver on a background thread, see ocp_nlp_prepare_async.
+typedef struct ocp_nlp_async_rti
+{
+    ocp_nlp_solver *solver;
+    ocp_nlp_in *in;
+    ocp_nlp_out *out;
+    void *worker;
+    int pending;             // preparation started and not yet consumed by a feedback call
+    int status_preparation;  // status of the last preparation phase
+    int num_preparations;
+    int num_overruns;        // feedback calls that had to wait for the preparation
+    double time_wait;        // time the last feedback call waited for the preparation [s]
+} ocp_nlp_async_rti;
+
+
+/// Scenario-tree (multi-stage) solver over the scenarios of a batch of solvers, see ocp_nlp_scenario_tree.h.
+typedef struct ocp_nlp_scenario_tree_solver
+{
+    ocp_nlp_config *config;
+    ocp_nlp_dims *nlp_dims;
+    void *dims;
+    void *opts;
+    void *mem;
+    void *raw_memory;
+} ocp_nlp_scenario_tree_solver;
+
+
+/// Storage kinds a field handle can resolve to.
+typedef enum
+{
+    OCP_NLP_FIELD_VEC,          ///< segment of a vector, e.g. x, u, yref
+    OCP_NLP_FIELD_LAM,          ///< multipliers, masked after setting
+    OCP_NLP_FIELD_BOUND_LOWER,  ///< lower bounds of the constraints, mask updated after setting
+    OCP_NLP_FIELD_BOUND_UPPER,  ///< upper bounds of the constraints, mask updated after setting
+    OCP_NLP_FIELD_PARAM,        ///< parameter values
+} ocp_nlp_field_handle_t;
+
+
+/// Field of the nlp inputs or outputs, resolved once for a range of stages.
+/// Setting and getting values through the handle avoids the string dispatch of the
+/// generic setters and getters, the handle stays valid as long as in and out.
+typedef struct ocp_nlp_field_handle
+{
+    ocp_nlp_field_handle_t type;
+    int stage_first;
+    int stage_last;
+    int size_total;     // sum of size over all stages, length of the buffer in set_all/get_all
+    int *size;          // per stage, indexed with stage - stage_first
+    int *offset;
+    struct blasfeo_dvec **vec;
+    struct blasfeo_dvec **dmask;
+    struct blasfeo_dvec **lam;
+    double **param;
+    ocp_nlp_constraints_config **constr_config;  // bounds: updates dmask through the module
+    void **constr_model;
+    void *raw_memory;
+} ocp_nlp_field_handle;
+
+
 /// Constructs an empty plan struct (user nlp configuration), all fields are set to a
 /// default/invalid state.
 ///
@@ -324,6 +431,47 @@ ACADOS_SYMBOL_EXPORT void ocp_nlp_get_all(ocp_nlp_solver *solver, ocp_nlp_in *in
 ACADOS_SYMBOL_EXPORT void ocp_nlp_set_all(ocp_nlp_solver *solver, ocp_nlp_in *in, ocp_nlp_out *out, const char *field, void *value);
 
 
+/// Resolves a field for the stages stage_first, ..., stage_last.
+/// Supported fields: x, u, z, sl, su, pi, lam (out), p (in), yref (cost),
+/// lbx, ubx, lbu, ubu, lg, ug, lh, uh, lphi, uphi (constraints).
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param in The inputs struct.
+/// \param out The output struct.
+/// \param field The name of the field.
+/// \param stage_first First stage.
+/// \param stage_last Last stage.
+/// \return The handle, NULL if the field is not available on all the stages.
+ACADOS_SYMBOL_EXPORT ocp_nlp_field_handle *ocp_nlp_field_handle_create(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        ocp_nlp_in *in, ocp_nlp_out *out, const char *field, int stage_first, int stage_last);
+
+/// Destructor of the field handle.
+///
+/// \param handle The field handle.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_field_handle_destroy(ocp_nlp_field_handle *handle);
+
+/// Sets the field at one stage, same semantics as the corresponding string based setter.
+///
+/// \param handle The field handle.
+/// \param stage Stage number, in [stage_first, stage_last].
+/// \param value Values, of length size[stage - stage_first].
+ACADOS_SYMBOL_EXPORT void ocp_nlp_field_handle_set(ocp_nlp_field_handle *handle, int stage, const double *value);
+
+/// Gets the field at one stage.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_field_handle_get(ocp_nlp_field_handle *handle, int stage, double *value);
+
+/// Sets the field at all stages of the handle from a contiguous buffer of length size_total.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_field_handle_set_all(ocp_nlp_field_handle *handle, const double *value);
+
+/// Gets the field at all stages of the handle into a contiguous buffer of length size_total.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_field_handle_get_all(ocp_nlp_field_handle *handle, double *value);
+
+/// Returns a pointer to the storage of the field at one stage, size[stage - stage_first] values are
+/// contiguous from there. Writing through it bypasses the mask updates of lam and the bounds.
+ACADOS_SYMBOL_EXPORT double *ocp_nlp_field_handle_get_ptr(ocp_nlp_field_handle *handle, int stage);
+
+
 // TODO(andrea): remove this once/if the MATLAB interface uses the new setters below?
 ACADOS_SYMBOL_EXPORT int ocp_nlp_dims_get_from_attr(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
         int stage, const char *field);
@@ -382,6 +530,42 @@ ACADOS_SYMBOL_EXPORT ocp_nlp_solver *ocp_nlp_solver_create(ocp_nlp_config *confi
 /// \param solver The solver struct.
 ACADOS_SYMBOL_EXPORT void ocp_nlp_solver_destroy(ocp_nlp_solver *solver);
 
+/* batch */
+
+/// Returns the size of the memory block needed for a batch of N_batch solver instances.
+///
+/// \param config The configuration struct, shared by all instances.
+/// \param dims The dimension struct, shared by all instances.
+/// \param opts_ The options struct of the prototype solver, after ocp_nlp_solver_create.
+/// \param nlp_in The inputs struct of the prototype solver.
+/// \param N_batch Number of instances.
+ACADOS_SYMBOL_EXPORT acados_size_t ocp_nlp_solver_batch_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims, void *opts_, ocp_nlp_in *nlp_in, int N_batch);
+
+/// Creates a batch of solver instances in a single memory block.
+/// The options of each instance are initialized with default values, nlp_in, nlp_out and sens_out are
+/// zero-initialized. The solvers are not assigned yet: after setting the options and inputs of instance i,
+/// call ocp_nlp_solver_batch_assign_solver.
+///
+/// \param config The configuration struct, shared by all instances.
+/// \param dims The dimension struct, shared by all instances.
+/// \param opts_ The options struct of the prototype solver, used to size the solver memory of the instances.
+/// \param nlp_in The inputs struct of the prototype solver.
+/// \param N_batch Number of instances.
+/// \return The batch struct.
+ACADOS_SYMBOL_EXPORT ocp_nlp_solver_batch *ocp_nlp_solver_batch_create(ocp_nlp_config *config, ocp_nlp_dims *dims, void *opts_, ocp_nlp_in *nlp_in, int N_batch);
+
+/// Assigns the solver memory and workspace of instance i of the batch, using the options and inputs of this instance.
+///
+/// \param batch The batch struct.
+/// \param i Index of the instance.
+/// \return 0 on success, 1 if the options of the instance need more memory than reserved.
+ACADOS_SYMBOL_EXPORT int ocp_nlp_solver_batch_assign_solver(ocp_nlp_solver_batch *batch, int i);
+
+/// Destructor of the batch, terminates all assigned solvers and frees the memory block.
+///
+/// \param batch The batch struct.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_solver_batch_destroy(ocp_nlp_solver_batch *batch);
+
 /// Solves the optimal control problem. Call ocp_nlp_precompute before
 /// calling this function.
 ///
@@ -431,6 +615,21 @@ ACADOS_SYMBOL_EXPORT void ocp_nlp_eval_constraints(ocp_nlp_solver *solver, ocp_n
 ACADOS_SYMBOL_EXPORT void ocp_nlp_eval_params_jac(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out);
 
 
+/// Shifts the iterate by n_shift stages in place to warm start the next MPC cycle:
+/// primal and dual variables in nlp_out, the initial guesses of the integrators and the QP solver warm start.
+/// The parameters and references in nlp_in are not shifted.
+///
+/// \param solver The solver struct.
+/// \param nlp_in The inputs struct.
+/// \param nlp_out The output struct.
+/// \param n_shift Number of stages, in [0, N].
+/// \param strategy Initialization of the new tail, see ocp_nlp_shift_strategy_t:
+///        0: repeat the last stage, 1: simulate x forward from x_N with the last control,
+///        2: shift by the time of the first n_shift intervals with interpolation, for non-uniform time grids.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_shift(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out,
+                                        int n_shift, int strategy);
+
+
 /// Computes the residuals.
 ///
 /// \param solver The solver struct.
@@ -454,6 +653,146 @@ ACADOS_SYMBOL_EXPORT void ocp_nlp_eval_solution_sens_adj_p(ocp_nlp_solver *solve
 /// \param return_value_ Pointer to the output memory.
 ACADOS_SYMBOL_EXPORT void ocp_nlp_get(ocp_nlp_solver *solver, const char *field, void *return_value_);
 
+/// Writes the per-stage, per-module timings recorded with ACADOS_WITH_PROFILING
+/// as Chrome trace events (JSON), which can be loaded in chrome://tracing or Perfetto.
+/// The raw data is available via ocp_nlp_get with the fields "profiling_num_records",
+/// "profiling_num_slots", "profiling_start", "profiling_duration", "profiling_call", "profiling_iter".
+///
+/// \param solver The solver struct.
+/// \param filename Name of the output file.
+/// \return 0 on success.
+ACADOS_SYMBOL_EXPORT int ocp_nlp_profiling_dump_trace(ocp_nlp_solver *solver, const char *filename);
+
+/// Starts writing every QP passed to the QP solver, together with its solution and status,
+/// in the binary format described in ocp_qp_capture.h. The records are written to
+/// <prefix>_000.acqp, <prefix>_001.acqp, ..., with at most records_per_file records per file;
+/// after num_files files the oldest one is overwritten.
+/// A running capture is stopped first.
+///
+/// \param solver The solver struct.
+/// \param prefix Prefix of the capture files.
+/// \param num_files Number of files in the rotation.
+/// \param records_per_file Number of QPs per file.
+/// \return 0 on success.
+ACADOS_SYMBOL_EXPORT int ocp_nlp_qp_capture_start(ocp_nlp_solver *solver, const char *prefix,
+                                                  int num_files, int records_per_file);
+
+/// Stops the QP capture and closes the current file.
+///
+/// \param solver The solver struct.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_qp_capture_stop(ocp_nlp_solver *solver);
+
+/// Constructor of the stage 0 feedback law.
+/// Requires the QP solver PARTIAL_CONDENSING_HPIPM with qp_solver_cond_N == N.
+///
+/// \param solver The solver struct.
+/// \param in The inputs struct.
+ACADOS_SYMBOL_EXPORT ocp_nlp_feedback_law *ocp_nlp_feedback_law_create(ocp_nlp_solver *solver, ocp_nlp_in *in);
+
+/// Destructor of the feedback law.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_feedback_law_destroy(ocp_nlp_feedback_law *law);
+
+/// Updates the feedback law after a (feedback) solve: the reference is the stage 0 iterate in out,
+/// K is the stage 0 Riccati gain of the last QP. The input bounds are read from in.
+/// If x0 is eliminated from the QP (nbxe_0 > 0), K is recovered from the Riccati factors of stage 0 and 1
+/// and the barrier terms of the general constraints of stage 0.
+/// The law is a copy, it can be evaluated while the solver runs the next iteration.
+///
+/// \param solver The solver struct.
+/// \param in The inputs struct.
+/// \param out The output struct.
+/// \param law The feedback law.
+/// \return 0 on success; 1 if the last QP was solved in single precision only, 2 if x0 is eliminated
+///         and stage 0 has soft general constraints. The law is not changed in these cases.
+ACADOS_SYMBOL_EXPORT int ocp_nlp_feedback_law_update(ocp_nlp_solver *solver, ocp_nlp_in *in, ocp_nlp_out *out,
+                                                     ocp_nlp_feedback_law *law);
+
+/// Evaluates u = u_ref + K (x - x_ref).
+/// With clip, the result is saturated at the stage 0 input bounds: the interior point gain is close to zero
+/// in the directions of the active bounds, the clipping takes care of bounds that become active.
+///
+/// \param law The feedback law.
+/// \param x State, of length nx.
+/// \param u Output, input of length nu.
+/// \param clip Saturate u at the input bounds.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_feedback_law_eval(const ocp_nlp_feedback_law *law, const double *x, double *u, int clip);
+
+/// Constructor of the asynchronous RTI driver for an SQP_RTI solver with as_rti_level 4 (standard RTI).
+/// Requires acados to be compiled with ACADOS_WITH_THREAD_POOL.
+///
+/// \param solver The solver struct.
+/// \param in The inputs struct.
+/// \param out The output struct.
+/// \param core Cpu id the background thread is pinned to, -1 means no pinning.
+/// \return The driver, NULL if not available.
+ACADOS_SYMBOL_EXPORT ocp_nlp_async_rti *ocp_nlp_async_rti_create(ocp_nlp_solver *solver, ocp_nlp_in *in,
+                                                                 ocp_nlp_out *out, int core);
+
+/// Destructor of the asynchronous RTI driver, waits for a running preparation phase.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_async_rti_destroy(ocp_nlp_async_rti *async);
+
+/// Starts the preparation phase (linearization, regularization, lhs condensing) of the next
+/// RTI iteration on the background thread and returns immediately.
+/// Until the next ocp_nlp_feedback_async call, in, out and the solver must not be accessed.
+///
+/// \param async The asynchronous RTI driver.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_prepare_async(ocp_nlp_async_rti *async);
+
+/// Feedback phase: waits for the preparation phase only if it is not done yet (counted in num_overruns),
+/// sets x0 as lower and upper bound of the stage 0 state bounds and solves the QP.
+/// Without a preceding ocp_nlp_prepare_async, the preparation is run on the calling thread.
+///
+/// \param async The asynchronous RTI driver.
+/// \param x0 Values of the stage 0 state bounds, of length nbx at stage 0, NULL to keep the bounds in in.
+/// \return The status of the feedback phase, or of the preparation phase if it failed.
+ACADOS_SYMBOL_EXPORT int ocp_nlp_feedback_async(ocp_nlp_async_rti *async, double *x0);
+
+/// Gets a statistic of the asynchronous RTI driver.
+///
+/// \param async The asynchronous RTI driver.
+/// \param field Supports "num_preparations", "num_overruns", "status_preparation" (int), "time_wait" (double).
+/// \param value Output.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_async_rti_get(ocp_nlp_async_rti *async, const char *field, void *value);
+
+/// Constructor of the scenario-tree solver. The scenarios are solvers of the same batch, i.e. they share
+/// config and dims, and differ in their parameters: scenario s takes realization (s / n_realizations^(n_robust-1-k))
+/// % n_realizations in the dynamics of stage k < n_robust. The stages of the scenarios with equal realizations
+/// up to stage k are the same node of the tree, which enforces non-anticipativity of the controls.
+/// Cost and constraints of a node are those of the first scenario through it.
+///
+/// \param solvers The scenario solvers, n_realizations^n_robust of them, SQP or SQP_RTI.
+/// \param in The inputs of the scenarios.
+/// \param out The outputs of the scenarios, the solution is written to them.
+/// \param n_realizations Number of children of the nodes up to the robust horizon.
+/// \param n_robust Robust horizon, 0 <= n_robust <= N.
+/// \return The scenario-tree solver, NULL if the regularization is not NO_REGULARIZE, MIRROR or PROJECT.
+ACADOS_SYMBOL_EXPORT ocp_nlp_scenario_tree_solver *ocp_nlp_scenario_tree_solver_create(ocp_nlp_solver **solvers,
+                        ocp_nlp_in **in, ocp_nlp_out **out, int n_realizations, int n_robust);
+
+/// Destructor of the scenario-tree solver, the scenario solvers are not freed.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_scenario_tree_solver_destroy(ocp_nlp_scenario_tree_solver *solver);
+
+/// Sets an option of the scenario-tree solver.
+///
+/// \param field Supports "max_iter", "print_level" (int), "tol_step" (double), "hpipm_mode" (char *)
+///              and the options of the HPIPM tree IPM, e.g. "iter_max".
+ACADOS_SYMBOL_EXPORT void ocp_nlp_scenario_tree_solver_opts_set(ocp_nlp_scenario_tree_solver *solver,
+                        const char *field, void *value);
+
+/// Sets the probabilities of the scenarios (double, one per scenario), uniform by default.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_scenario_tree_solver_set(ocp_nlp_scenario_tree_solver *solver,
+                        const char *field, void *value);
+
+/// Solves the scenario-tree OCP starting from the current iterates of the scenarios.
+ACADOS_SYMBOL_EXPORT int ocp_nlp_scenario_tree_solver_solve(ocp_nlp_scenario_tree_solver *solver);
+
+/// Gets a statistic of the scenario-tree solver.
+///
+/// \param field Supports "status", "sqp_iter", "qp_status", "qp_iter", "num_scenarios", "num_nodes" (int),
+///              "step_norm", "time_tot", "time_lin", "time_qp" (double).
+ACADOS_SYMBOL_EXPORT void ocp_nlp_scenario_tree_solver_get(ocp_nlp_scenario_tree_solver *solver,
+                        const char *field, void *value);
+
 /* set */
 /// Sets the initial guesses for the integrator for the given stage.
 ///
@@ -70,12 +70,15 @@ classdef AcadosOcpOptions < handle
         qp_solver_cond_block_size
         qp_solver_warm_start
         qp_solver_cond_ric_alg
+        qp_solver_cond_num_threads
+        qp_solver_reuse_constant_lhs
         qp_solver_ric_alg
         qp_solver_mu0
         qp_solver_t0_init
         tau_min
         rti_log_residuals
         rti_log_only_available_residuals
+        rti_fast_feedback
         print_level
         cost_discretization
         regularize_method
@@ -83,6 +86,7 @@ classdef AcadosOcpOptions < handle
         reg_max_cond_block
         reg_min_epsilon
         reg_adaptive_eps
+        reg_warm_start
         qpscaling_ub_max_abs_eig
         qpscaling_lb_norm_inf_grad_obj
         qpscaling_scale_objective
@@ -132,6 +136,8 @@ classdef AcadosOcpOptions < handle
         log_primal_step_norm
         log_dual_step_norm
         store_iterates
+        thread_pool_num_threads
+        thread_pool_cores
         eval_residual_at_max_iter
         with_anderson_acceleration
 
@@ -192,12 +198,15 @@ classdef AcadosOcpOptions < handle
             obj.qp_solver_cond_N = [];
             obj.qp_solver_cond_block_size = [];
             obj.qp_solver_cond_ric_alg = 1;
+            obj.qp_solver_cond_num_threads = 1;
+            obj.qp_solver_reuse_constant_lhs = false;
             obj.qp_solver_ric_alg = 1;
             obj.qp_solver_mu0 = 0;
             obj.qp_solver_t0_init = 2;
             obj.tau_min = 0;
             obj.rti_log_residuals = 0;
             obj.rti_log_only_available_residuals = 0;
+            obj.rti_fast_feedback = 0;
             obj.print_level = 0;
             obj.cost_discretization = 'EULER';
             obj.regularize_method = 'NO_REGULARIZE';
@@ -216,6 +225,7 @@ classdef AcadosOcpOptions < handle
             obj.reg_adaptive_eps = false;
             obj.reg_max_cond_block = 1e7;
             obj.reg_min_epsilon = 1e-8;
+            obj.reg_warm_start = false;
             obj.shooting_nodes = [];
             obj.cost_scaling = [];
             obj.exact_hess_cost = 1;
@@ -259,6 +269,8 @@ classdef AcadosOcpOptions < handle
             obj.log_primal_step_norm = 0;
             obj.log_dual_step_norm = 0;
             obj.store_iterates = false;
+            obj.thread_pool_num_threads = 0;
+            obj.thread_pool_cores = [];
             obj.eval_residual_at_max_iter = [];
             obj.with_anderson_acceleration = 0;
             obj.timeout_max_time = 0.;
@@ -301,7 +313,7 @@ classdef AcadosOcpOptions < handle
 
         function s = convert_to_struct_for_json_dump(self, N)
             s = self.struct();
-            s = prepare_struct_for_json_dump(s, {'time_steps', 'shooting_nodes', 'cost_scaling', 'sim_method_num_stages', 'sim_method_num_steps', 'sim_method_jac_reuse', 'custom_templates'}, {});
+            s = prepare_struct_for_json_dump(s, {'time_steps', 'shooting_nodes', 'cost_scaling', 'sim_method_num_stages', 'sim_method_num_steps', 'sim_method_jac_reuse', 'custom_templates', 'thread_pool_cores'}, {});
         end
     end
 end
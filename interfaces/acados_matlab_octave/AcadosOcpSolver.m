@@ -394,6 +394,23 @@ classdef AcadosOcpSolver < handle
             obj.t_ocp.reset();
         end
 
+        function shift(obj, n_shift, strategy)
+            % Shifts the current iterate, the integrator guesses and the QP warm start by n_shift stages.
+            % strategy: 'REPEAT_LAST' (default), 'SIMULATE_TERMINAL' or 'INTERPOLATE', see ocp_nlp_shift.
+            if nargin < 2
+                n_shift = 1;
+            end
+            if nargin < 3
+                strategy = 'REPEAT_LAST';
+            end
+            strategies = {'REPEAT_LAST', 'SIMULATE_TERMINAL', 'INTERPOLATE'};
+            idx = find(strcmp(strategy, strategies));
+            if isempty(idx)
+                error(['shift: strategy must be one of REPEAT_LAST, SIMULATE_TERMINAL, INTERPOLATE, got ', strategy]);
+            end
+            obj.t_ocp.set('shift', [n_shift, idx-1]);
+        end
+
 
         function result = qp_diagnostics(obj, varargin)
             % Compute some diagnostic values for the last QP.
@@ -37,6 +37,7 @@ from .acados_ocp_cost import AcadosOcpCost
 from .acados_ocp_constraints import AcadosOcpConstraints
 from .acados_ocp_options import AcadosOcpOptions
 from .acados_ocp_batch_solver import AcadosOcpBatchSolver
+from .acados_ocp_scenario_tree_solver import AcadosOcpScenarioTreeSolver
 from .acados_ocp_iterate import AcadosOcpIterate, AcadosOcpIterates, AcadosOcpFlattenedIterate
 
 from .acados_sim import AcadosSim, AcadosSimOptions
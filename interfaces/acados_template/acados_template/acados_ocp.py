@@ -1261,6 +1261,10 @@ class AcadosOcp:
             if opts.globalization != "FIXED_STEP":
                 raise NotImplementedError('Anderson acceleration only supported for FIXED_STEP globalization for now.')
 
+        # thread pool
+        if len(opts.thread_pool_cores) not in [0, opts.thread_pool_num_threads]:
+            raise ValueError(f'thread_pool_cores should be empty or of length thread_pool_num_threads = {opts.thread_pool_num_threads}, got {len(opts.thread_pool_cores)}.')
+
         # check terminal stage
         for field in ('cost_expr_ext_cost_e', 'cost_expr_ext_cost_custom_hess_e',
                       'cost_y_expr_e', 'cost_psi_expr_e', 'cost_conl_custom_outer_hess_e',
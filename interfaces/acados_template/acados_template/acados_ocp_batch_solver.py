@@ -32,7 +32,7 @@ from .acados_ocp_solver import AcadosOcpSolver
 from .acados_ocp import AcadosOcp
 from .acados_ocp_iterate import AcadosOcpFlattenedBatchIterate
 from typing import Optional, List, Tuple, Sequence, Union
-from ctypes import (POINTER, c_int, c_void_p, cast, c_double, c_char_p)
+from ctypes import (POINTER, c_int, c_void_p, cast, c_double, c_char_p, c_size_t)
 import numpy as np
 import time
 import warnings
@@ -43,6 +43,7 @@ class AcadosOcpBatchSolver():
 
         :param ocp: type :py:class:`~acados_template.acados_ocp.AcadosOcp`
         :param num_threads_in_batch_solve: number of threads used for parallelizing the batch methods. Default: 1
+        :param chunk_size_in_batch_solve: number of solves a thread takes at once in the dynamically scheduled batch solve, non-positive values result in a static distribution of the solves. Default: 1
         :param N_batch_max: maximum batch size, positive integer
         :param json_file: Default: 'acados_ocp.json'
         :param build: Flag indicating whether solver should be (re)compiled. If False an attempt is made to load an already compiled shared library for the solver. Default: True
@@ -54,9 +55,12 @@ class AcadosOcpBatchSolver():
 
     def __init__(self, ocp: AcadosOcp, N_batch_max: int,
                  num_threads_in_batch_solve: Union[int, None] = None,
+                 chunk_size_in_batch_solve: int = 1,
                  json_file: str = 'acados_ocp.json',
                  build: bool = True, generate: bool = True, verbose: bool=True):
 
+        self.__nlp_batch = None
+
         if not isinstance(N_batch_max, int) or N_batch_max <= 0:
             raise ValueError("AcadosOcpBatchSolver: argument N_batch_max should be a positive integer.")
         if num_threads_in_batch_solve is None:
@@ -68,20 +72,40 @@ class AcadosOcpBatchSolver():
             warnings.warn("Using AcadosOcpBatchSolver, but ocp.solver_options.with_batch_functionality is False. Attempting to compile with openmp nonetheless.")
             ocp.solver_options.with_batch_functionality = True
 
+        if not isinstance(chunk_size_in_batch_solve, int):
+            raise ValueError("AcadosOcpBatchSolver: argument chunk_size_in_batch_solve should be an integer.")
+
         self.__num_threads_in_batch_solve = num_threads_in_batch_solve
+        self.__chunk_size_in_batch_solve = chunk_size_in_batch_solve
 
         self.__N_batch_max = N_batch_max
-        self.__ocp_solvers = [AcadosOcpSolver(ocp,
-                                              json_file=json_file,
-                                              build=n==0 if build else False,
-                                              generate=n==0 if generate else False,
-                                              verbose=verbose if n==0 else False,
-                                              )
-                               for n in range(self.N_batch_max)]
-
-        self.__shared_lib = self.ocp_solvers[0].shared_lib
-        self.__acados_lib = self.ocp_solvers[0].acados_lib
-        self.__name = self.ocp_solvers[0].name
+
+        t0 = time.perf_counter()
+
+        # the first solver is a full AcadosOcpSolver, all other solvers share its plan, config and dims,
+        # their options, inputs, outputs, memory and workspace are allocated in one memory block
+        prototype = AcadosOcpSolver(ocp, json_file=json_file, build=build, generate=generate, verbose=verbose)
+
+        self.__shared_lib = prototype.shared_lib
+        self.__acados_lib = prototype.acados_lib
+        self.__name = prototype.name
+
+        getattr(self.__shared_lib, f"{self.__name}_acados_batch_create").argtypes = [c_void_p, POINTER(c_void_p), c_int]
+        getattr(self.__shared_lib, f"{self.__name}_acados_batch_create").restype = c_void_p
+        getattr(self.__shared_lib, f"{self.__name}_acados_batch_free").argtypes = [c_void_p, POINTER(c_void_p), c_int]
+        getattr(self.__shared_lib, f"{self.__name}_acados_batch_free").restype = c_int
+        getattr(self.__shared_lib, f"{self.__name}_acados_batch_get_memsize").argtypes = [c_void_p]
+        getattr(self.__shared_lib, f"{self.__name}_acados_batch_get_memsize").restype = c_size_t
+
+        self.__batch_capsules = (c_void_p * (self.N_batch_max - 1))()
+        self.__nlp_batch = getattr(self.__shared_lib, f"{self.__name}_acados_batch_create")(prototype.capsule, self.__batch_capsules, self.N_batch_max - 1)
+        self.__memsize = getattr(self.__shared_lib, f"{self.__name}_acados_batch_get_memsize")(self.__nlp_batch)
+
+        self.__ocp_solvers = [prototype] + [AcadosOcpSolver._create_from_batch_capsule(prototype, capsule)
+                                            for capsule in self.__batch_capsules]
+
+        self.__time_create = time.perf_counter() - t0
+
         self.__ocp_solvers_pointer = (c_void_p * self.N_batch_max)()
 
         for i in range(self.N_batch_max):
@@ -91,9 +115,21 @@ class AcadosOcpBatchSolver():
         self.__status = np.zeros((self.N_batch_max,), dtype=np.intc, order="C")
         self.__status_p = cast(self.__status.ctypes.data, POINTER(c_int))
 
+        # per solve statistics
+        self.__time_solve = np.zeros((self.N_batch_max,), dtype=np.float64, order="C")
+        self.__time_solve_p = cast(self.__time_solve.ctypes.data, POINTER(c_double))
+        self.__thread_id = np.zeros((self.N_batch_max,), dtype=np.intc, order="C")
+        self.__thread_id_p = cast(self.__thread_id.ctypes.data, POINTER(c_int))
+        self.__nlp_iter = np.zeros((self.N_batch_max,), dtype=np.intc, order="C")
+        self.__nlp_iter_p = cast(self.__nlp_iter.ctypes.data, POINTER(c_int))
+
         getattr(self.__shared_lib, f"{self.__name}_acados_batch_solve").argtypes = [POINTER(c_void_p), POINTER(c_int), c_int, c_int]
         getattr(self.__shared_lib, f"{self.__name}_acados_batch_solve").restype = c_void_p
 
+        getattr(self.__shared_lib, f"{self.__name}_acados_batch_solve_with_stats").argtypes = [POINTER(c_void_p), POINTER(c_int), c_int, c_int, c_int,
+                                                                                             POINTER(c_double), POINTER(c_int), POINTER(c_int)]
+        getattr(self.__shared_lib, f"{self.__name}_acados_batch_solve_with_stats").restype = c_void_p
+
         getattr(self.__shared_lib, f"{self.__name}_acados_batch_eval_params_jac").argtypes = [POINTER(c_void_p), c_int, c_int]
         getattr(self.__shared_lib, f"{self.__name}_acados_batch_eval_params_jac").restype = c_void_p
 
@@ -118,9 +154,16 @@ class AcadosOcpBatchSolver():
             print(msg)
 
 
+    def __del__(self):
+        if self.__nlp_batch is not None:
+            getattr(self.__shared_lib, f"{self.__name}_acados_batch_free")(self.__nlp_batch, self.__batch_capsules, self.N_batch_max - 1)
+            self.__nlp_batch = None
+
+
     @property
     def ocp_solvers(self):
-        """List of AcadosOcpSolvers."""
+        """List of AcadosOcpSolvers.
+        All solvers except the first one are part of the batch memory, they must not be used after the batch solver is deleted."""
         return self.__ocp_solvers
 
     @property
@@ -128,6 +171,16 @@ class AcadosOcpBatchSolver():
         """Maximum batch size."""
         return self.__N_batch_max
 
+    @property
+    def time_create(self) -> float:
+        """Wall time in seconds needed to create the batch solver, including code generation and compilation if requested."""
+        return self.__time_create
+
+    @property
+    def memsize(self) -> int:
+        """Size in bytes of the memory block holding options, inputs, outputs, memory and workspace of the solvers 1, ..., N_batch_max-1."""
+        return self.__memsize
+
     @property
     def num_threads_in_batch_solve(self):
         """Number of threads used for parallelizing the batch methods."""
@@ -137,6 +190,32 @@ class AcadosOcpBatchSolver():
     def num_threads_in_batch_solve(self, num_threads_in_batch_solve):
         self.__num_threads_in_batch_solve = num_threads_in_batch_solve
 
+    @property
+    def chunk_size_in_batch_solve(self):
+        """Number of solves a thread takes at once in the dynamically scheduled batch solve. Non-positive values result in a static distribution."""
+        return self.__chunk_size_in_batch_solve
+
+    @chunk_size_in_batch_solve.setter
+    def chunk_size_in_batch_solve(self, chunk_size_in_batch_solve):
+        if not isinstance(chunk_size_in_batch_solve, int):
+            raise ValueError("AcadosOcpBatchSolver: chunk_size_in_batch_solve should be an integer.")
+        self.__chunk_size_in_batch_solve = chunk_size_in_batch_solve
+
+    @property
+    def time_solve(self) -> np.ndarray:
+        """Wall time in seconds of each solve in the last call to `solve`, array of shape (N_batch_max,)."""
+        return self.__time_solve
+
+    @property
+    def thread_id(self) -> np.ndarray:
+        """Id of the thread that executed each solve in the last call to `solve`, array of shape (N_batch_max,)."""
+        return self.__thread_id
+
+    @property
+    def nlp_iter(self) -> np.ndarray:
+        """Number of NLP iterations of each solve in the last call to `solve`, array of shape (N_batch_max,)."""
+        return self.__nlp_iter
+
 
     def solve(self, n_batch: Optional[int] = None) -> None:
         """
@@ -144,7 +223,8 @@ class AcadosOcpBatchSolver():
         """
         n_batch = self.__check_n_batch(n_batch)
 
-        getattr(self.__shared_lib, f"{self.__name}_acados_batch_solve")(self.__ocp_solvers_pointer, self.__status_p, n_batch, self.__num_threads_in_batch_solve)
+        getattr(self.__shared_lib, f"{self.__name}_acados_batch_solve_with_stats")(self.__ocp_solvers_pointer, self.__status_p, n_batch, self.__num_threads_in_batch_solve,
+                                                                                   self.__chunk_size_in_batch_solve, self.__time_solve_p, self.__thread_id_p, self.__nlp_iter_p)
 
         # to be consistent with non-batched solve
         for s, solver in zip(self.__status, self.ocp_solvers):
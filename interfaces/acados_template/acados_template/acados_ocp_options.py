@@ -79,6 +79,8 @@ class AcadosOcpOptions:
         self.__qp_solver_cond_block_size = None
         self.__qp_solver_warm_start = 0
         self.__qp_solver_cond_ric_alg = 1
+        self.__qp_solver_cond_num_threads = 1
+        self.__qp_solver_reuse_constant_lhs = False
         self.__qp_solver_ric_alg = 1
         self.__qp_solver_mu0 = 0.0
         self.__qp_solver_t0_init = 2
@@ -86,6 +88,7 @@ class AcadosOcpOptions:
         self.__solution_sens_qp_t_lam_min = 1e-9
         self.__rti_log_residuals = 0
         self.__rti_log_only_available_residuals = 0
+        self.__rti_fast_feedback = 0
         self.__print_level = 0
         self.__cost_discretization = 'EULER'
         self.__regularize_method = 'NO_REGULARIZE'
@@ -93,6 +96,7 @@ class AcadosOcpOptions:
         self.__reg_max_cond_block = 1e7
         self.__reg_adaptive_eps = False
         self.__reg_min_epsilon = 1e-8
+        self.__reg_warm_start = False
         self.__exact_hess_cost = 1
         self.__exact_hess_dyn = 1
         self.__exact_hess_constr = 1
@@ -162,6 +166,8 @@ class AcadosOcpOptions:
         self.__num_threads_in_batch_solve: int = 1
         self.__with_batch_functionality: bool = False
         self.__with_anderson_acceleration: bool = False
+        self.__thread_pool_num_threads: int = 0
+        self.__thread_pool_cores: list = []
 
 
     @property
@@ -700,6 +706,27 @@ class AcadosOcpOptions:
         """
         return self.__qp_solver_cond_ric_alg
 
+    @property
+    def qp_solver_cond_num_threads(self):
+        """
+        QP solver: Number of threads used in partial condensing.
+        The condensing blocks are split into this many contiguous segments, which are condensed and expanded in parallel.
+        Only used with PARTIAL_CONDENSING_* QP solvers and if acados is compiled with OpenMP.
+        The solve of the partially condensed QP itself stays sequential, a parallel-in-time Riccati recursion is not available.
+        Default: 1
+        """
+        return self.__qp_solver_cond_num_threads
+
+    @property
+    def qp_solver_reuse_constant_lhs(self):
+        """
+        QP solver: If True, the matrices of the QP (dynamics and constraint Jacobians, Hessian) are hashed before each QP solve
+        and the lhs condensing is skipped if they did not change since the last condensing, only the rhs is condensed.
+        Useful e.g. for linear dynamics and constraints in combination with `fixed_hess`.
+        Default: False
+        """
+        return self.__qp_solver_reuse_constant_lhs
+
     @property
     def qp_solver_ric_alg(self):
         """
@@ -1030,6 +1057,20 @@ class AcadosOcpOptions:
         """
         return self.__reg_min_epsilon
 
+    @property
+    def reg_warm_start(self):
+        """Warm start the eigen decomposition in regularization from the eigenvectors of the previous call,
+        used if regularize_method == 'PROJECT'.
+
+        Jacobi sweeps started from the previous eigenvectors are used instead of a full decomposition;
+        this pays off if the Hessian blocks change little between iterations, e.g. in RTI.
+        Blocks with all eigenvalues above epsilon are detected with a Cholesky test and skipped independently of this option.
+
+        Type: bool
+        Default: False
+        """
+        return self.__reg_warm_start
+
     @property
     def globalization_alpha_reduction(self):
         """Step size reduction factor for globalization MERIT_BACKTRACKING and
@@ -1292,6 +1333,19 @@ class AcadosOcpOptions:
         """
         return self.__rti_log_only_available_residuals
 
+    @property
+    def rti_fast_feedback(self):
+        """
+        Relevant for SQP_RTI with as_rti_level 4 (standard RTI) and separate preparation and feedback calls.
+        If rti_fast_feedback is set to 1, the QP right hand side of all stages is evaluated in the preparation phase
+        and the feedback phase only updates the bounds of stage 0, i.e. the initial state.
+        Bounds on stages > 0 then have to be set before the preparation phase.
+
+        Type: int; 0 or 1;
+        Default: 0.
+        """
+        return self.__rti_fast_feedback
+
     @property
     def nlp_solver_tol_comp(self):
         """NLP solver complementarity tolerance"""
@@ -1472,6 +1526,25 @@ class AcadosOcpOptions:
         """
         return self.__with_batch_functionality
 
+    @property
+    def thread_pool_num_threads(self):
+        """
+        Number of threads of the persistent worker pool used for the stage-wise evaluations within one solver, including the calling thread.
+        Only used if acados was compiled with ACADOS_WITH_THREAD_POOL, values <= 1 disable the pool.
+        Default: 0.
+        """
+        return self.__thread_pool_num_threads
+
+    @property
+    def thread_pool_cores(self):
+        """
+        List of cpu ids the threads of the worker pool are pinned to, of length thread_pool_num_threads, -1 means no pinning.
+        The first entry refers to the calling thread, which is not pinned.
+        Empty list: no pinning.
+        Default: [].
+        """
+        return self.__thread_pool_cores
+
 
     @qp_solver.setter
     def qp_solver(self, qp_solver):
@@ -1671,6 +1744,12 @@ class AcadosOcpOptions:
             raise ValueError(f'Invalid reg_min_epsilon value, expected float > 0, got {reg_min_epsilon}')
         self.__reg_min_epsilon = reg_min_epsilon
 
+    @reg_warm_start.setter
+    def reg_warm_start(self, reg_warm_start):
+        if not isinstance(reg_warm_start, bool):
+            raise TypeError(f'Invalid reg_warm_start value, expected bool, got {reg_warm_start}')
+        self.__reg_warm_start = reg_warm_start
+
     @globalization_alpha_min.setter
     def globalization_alpha_min(self, globalization_alpha_min):
         self.__globalization_alpha_min = globalization_alpha_min
@@ -2100,6 +2179,20 @@ class AcadosOcpOptions:
         else:
             raise ValueError(f'Invalid qp_solver_cond_ric_alg value. qp_solver_cond_ric_alg must be in [0, 1], got {qp_solver_cond_ric_alg}.')
 
+    @qp_solver_cond_num_threads.setter
+    def qp_solver_cond_num_threads(self, qp_solver_cond_num_threads):
+        if isinstance(qp_solver_cond_num_threads, int) and qp_solver_cond_num_threads > 0:
+            self.__qp_solver_cond_num_threads = qp_solver_cond_num_threads
+        else:
+            raise ValueError(f'Invalid qp_solver_cond_num_threads value. qp_solver_cond_num_threads must be a positive int, got {qp_solver_cond_num_threads}.')
+
+    @qp_solver_reuse_constant_lhs.setter
+    def qp_solver_reuse_constant_lhs(self, qp_solver_reuse_constant_lhs):
+        if isinstance(qp_solver_reuse_constant_lhs, bool):
+            self.__qp_solver_reuse_constant_lhs = qp_solver_reuse_constant_lhs
+        else:
+            raise TypeError(f'Invalid qp_solver_reuse_constant_lhs value, expected bool, got {qp_solver_reuse_constant_lhs}.')
+
 
     @qp_solver_cond_N.setter
     def qp_solver_cond_N(self, qp_solver_cond_N):
@@ -2221,6 +2314,13 @@ class AcadosOcpOptions:
         else:
             raise ValueError('Invalid rti_log_only_available_residuals value. rti_log_only_available_residuals must be in [0, 1].')
 
+    @rti_fast_feedback.setter
+    def rti_fast_feedback(self, rti_fast_feedback):
+        if rti_fast_feedback in [0, 1]:
+            self.__rti_fast_feedback = rti_fast_feedback
+        else:
+            raise ValueError('Invalid rti_fast_feedback value. rti_fast_feedback must be in [0, 1].')
+
     @nlp_solver_tol_comp.setter
     def nlp_solver_tol_comp(self, nlp_solver_tol_comp):
         if isinstance(nlp_solver_tol_comp, float) and nlp_solver_tol_comp > 0:
@@ -2313,6 +2413,20 @@ class AcadosOcpOptions:
         else:
             raise TypeError('Invalid with_batch_functionality value. Expected bool.')
 
+    @thread_pool_num_threads.setter
+    def thread_pool_num_threads(self, thread_pool_num_threads):
+        if isinstance(thread_pool_num_threads, int) and 0 <= thread_pool_num_threads <= 64:
+            self.__thread_pool_num_threads = thread_pool_num_threads
+        else:
+            raise ValueError('Invalid thread_pool_num_threads value. thread_pool_num_threads must be an integer in [0, 64].')
+
+    @thread_pool_cores.setter
+    def thread_pool_cores(self, thread_pool_cores):
+        if isinstance(thread_pool_cores, (list, tuple)) and all(isinstance(c, int) and c >= -1 for c in thread_pool_cores):
+            self.__thread_pool_cores = list(thread_pool_cores)
+        else:
+            raise TypeError('Invalid thread_pool_cores value. Expected list of integers >= -1.')
+
 
     def set(self, attr, value):
         setattr(self, attr, value)
@@ -0,0 +1,206 @@
+#
+# Copyright (c) The acados authors.
+#
+# This file is part of acados.
+#
+# The 2-Clause BSD License
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+# this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.;
+#
+
+from .acados_ocp_batch_solver import AcadosOcpBatchSolver
+from typing import Optional, Union
+from ctypes import (POINTER, c_int, c_void_p, cast, c_double, c_char_p, byref)
+import numpy as np
+
+
+class AcadosOcpScenarioTreeSolver():
+    """
+    Scenario-tree (multi-stage) OCP solver on top of the solvers of an AcadosOcpBatchSolver.
+
+    Each node up to the robust horizon `n_robust` branches into `n_realizations` children, which gives
+    `n_realizations**n_robust` scenarios, taken from the first solvers of the batch.
+    Scenario `s` takes realization `(s // n_realizations**(n_robust-1-k)) % n_realizations` in the dynamics of stage `k < n_robust`,
+    the realizations are set as parameters of the scenario solvers, e.g. with `batch_solver.ocp_solvers[s].set(k, 'p', p)`.
+    Stages of scenarios with equal realizations up to stage k are the same node of a tree-structured QP solved with HPIPM,
+    such that the controls are non-anticipative. Cost and constraints of a node are those of the first scenario through it.
+    Only the stages used by the nodes are linearized, in parallel over the scenarios if acados is compiled with
+    ACADOS_WITH_THREAD_POOL and option 'num_threads' > 1, or with OpenMP.
+    Only the stage-wise regularizations 'NO_REGULARIZE', 'MIRROR' and 'PROJECT' are supported.
+
+        :param batch_solver: type :py:class:`~acados_template.acados_ocp_batch_solver.AcadosOcpBatchSolver`, with SQP or SQP_RTI solvers
+        :param n_realizations: number of realizations of the uncertainty per stage
+        :param n_robust: robust horizon, 0 <= n_robust <= N_horizon
+        :param probabilities: probabilities of the scenarios, weights of their costs; uniform if None
+    """
+
+    def __init__(self, batch_solver: AcadosOcpBatchSolver, n_realizations: int, n_robust: int,
+                 probabilities: Optional[np.ndarray] = None):
+
+        self.__solver = None
+
+        if not isinstance(n_realizations, int) or n_realizations < 1:
+            raise ValueError("AcadosOcpScenarioTreeSolver: n_realizations should be a positive integer.")
+        N_horizon = batch_solver.ocp_solvers[0].acados_ocp.solver_options.N_horizon
+        if not isinstance(n_robust, int) or n_robust < 0 or n_robust > N_horizon:
+            raise ValueError(f"AcadosOcpScenarioTreeSolver: n_robust should be an integer in [0, {N_horizon}].")
+
+        self.__num_scenarios = n_realizations ** n_robust
+        if self.__num_scenarios > batch_solver.N_batch_max:
+            raise ValueError(f"AcadosOcpScenarioTreeSolver: {self.__num_scenarios} scenarios need a batch solver with N_batch_max >= {self.__num_scenarios}, got {batch_solver.N_batch_max}.")
+        if batch_solver.ocp_solvers[0].acados_ocp.solver_options.nlp_solver_type not in ['SQP', 'SQP_RTI']:
+            raise ValueError("AcadosOcpScenarioTreeSolver: only available for nlp_solver_type SQP and SQP_RTI.")
+        if batch_solver.ocp_solvers[0].acados_ocp.solver_options.regularize_method not in ['NO_REGULARIZE', 'MIRROR', 'PROJECT']:
+            raise ValueError("AcadosOcpScenarioTreeSolver: only available for regularize_method NO_REGULARIZE, MIRROR and PROJECT.")
+
+        # keep the batch solver alive, it owns the scenario solvers
+        self.__batch_solver = batch_solver
+        self.__n_realizations = n_realizations
+        self.__n_robust = n_robust
+
+        scenarios = batch_solver.ocp_solvers[:self.__num_scenarios]
+        self.__acados_lib = scenarios[0].acados_lib
+
+        self.__acados_lib.ocp_nlp_scenario_tree_solver_create.argtypes = [POINTER(c_void_p), POINTER(c_void_p), POINTER(c_void_p), c_int, c_int]
+        self.__acados_lib.ocp_nlp_scenario_tree_solver_create.restype = c_void_p
+        self.__acados_lib.ocp_nlp_scenario_tree_solver_destroy.argtypes = [c_void_p]
+        self.__acados_lib.ocp_nlp_scenario_tree_solver_destroy.restype = None
+        self.__acados_lib.ocp_nlp_scenario_tree_solver_opts_set.argtypes = [c_void_p, c_char_p, c_void_p]
+        self.__acados_lib.ocp_nlp_scenario_tree_solver_opts_set.restype = None
+        self.__acados_lib.ocp_nlp_scenario_tree_solver_set.argtypes = [c_void_p, c_char_p, c_void_p]
+        self.__acados_lib.ocp_nlp_scenario_tree_solver_set.restype = None
+        self.__acados_lib.ocp_nlp_scenario_tree_solver_solve.argtypes = [c_void_p]
+        self.__acados_lib.ocp_nlp_scenario_tree_solver_solve.restype = c_int
+        self.__acados_lib.ocp_nlp_scenario_tree_solver_get.argtypes = [c_void_p, c_char_p, c_void_p]
+        self.__acados_lib.ocp_nlp_scenario_tree_solver_get.restype = None
+
+        nlp_solvers = (c_void_p * self.__num_scenarios)(*[s.nlp_solver for s in scenarios])
+        nlp_in = (c_void_p * self.__num_scenarios)(*[s.nlp_in for s in scenarios])
+        nlp_out = (c_void_p * self.__num_scenarios)(*[s.nlp_out for s in scenarios])
+
+        self.__solver = self.__acados_lib.ocp_nlp_scenario_tree_solver_create(nlp_solvers, nlp_in, nlp_out, n_realizations, n_robust)
+        if self.__solver is None:
+            raise RuntimeError("AcadosOcpScenarioTreeSolver: creating the scenario-tree solver failed.")
+
+        if probabilities is not None:
+            self.set_probabilities(probabilities)
+
+        self.status = 0
+
+
+    def __del__(self):
+        if self.__solver is not None:
+            self.__acados_lib.ocp_nlp_scenario_tree_solver_destroy(self.__solver)
+            self.__solver = None
+
+
+    @property
+    def scenario_solvers(self):
+        """The AcadosOcpSolvers of the scenarios, the solution of scenario `s` is obtained with `scenario_solvers[s].get(...)`."""
+        return self.__batch_solver.ocp_solvers[:self.__num_scenarios]
+
+    @property
+    def num_scenarios(self) -> int:
+        """Number of scenarios, `n_realizations**n_robust`."""
+        return self.__num_scenarios
+
+    @property
+    def n_realizations(self) -> int:
+        """Number of realizations of the uncertainty per stage."""
+        return self.__n_realizations
+
+    @property
+    def n_robust(self) -> int:
+        """Robust horizon."""
+        return self.__n_robust
+
+
+    def set_probabilities(self, probabilities: np.ndarray) -> None:
+        """
+        Set the probabilities of the scenarios, they are normalized to sum up to one.
+
+            :param probabilities: positive values, array of shape (num_scenarios,)
+        """
+        probabilities = np.ascontiguousarray(probabilities, dtype=np.float64).reshape((-1,))
+        if probabilities.shape != (self.__num_scenarios,):
+            raise ValueError(f"AcadosOcpScenarioTreeSolver.set_probabilities(): expected shape ({self.__num_scenarios},), got {probabilities.shape}.")
+        if np.any(probabilities <= 0):
+            raise ValueError("AcadosOcpScenarioTreeSolver.set_probabilities(): probabilities should be positive.")
+        self.__acados_lib.ocp_nlp_scenario_tree_solver_set(self.__solver, "probabilities".encode('utf-8'),
+                                                           cast(probabilities.ctypes.data, c_void_p))
+
+
+    def options_set(self, field_: str, value_: Union[int, float, str]) -> None:
+        """
+        Set options of the scenario-tree solver.
+
+            :param field_: string in ['max_iter', 'nlp_tol_stat', 'nlp_tol_eq', 'nlp_tol_ineq', 'nlp_tol_comp', 'tol_step', 'num_threads', 'print_level', 'hpipm_mode'] or an option of the HPIPM tree IPM, e.g. 'iter_max', 'mu0', 'tol_stat'
+            :param value_: value of the option
+
+        With 'max_iter' > 1, the SQP iterations stop if the KKT residuals of the tree NLP are below 'nlp_tol_*',
+        with status 3 (ACADOS_MINSTEP) if the max norm of the step is below 'tol_step', or with status 2 after 'max_iter' iterations.
+        'num_threads' is the size of the thread pool for the linearizations, only used if acados is compiled with ACADOS_WITH_THREAD_POOL.
+        """
+        int_fields = ['max_iter', 'num_threads', 'print_level', 'iter_max', 'warm_start', 'pred_corr', 'cond_pred_corr', 'split_step']
+        string_fields = ['hpipm_mode']
+
+        field = field_.encode('utf-8')
+        if field_ in string_fields:
+            self.__acados_lib.ocp_nlp_scenario_tree_solver_opts_set(self.__solver, field, c_char_p(value_.encode('utf-8')))
+        elif field_ in int_fields:
+            value = c_int(value_)
+            self.__acados_lib.ocp_nlp_scenario_tree_solver_opts_set(self.__solver, field, byref(value))
+        else:
+            value = c_double(value_)
+            self.__acados_lib.ocp_nlp_scenario_tree_solver_opts_set(self.__solver, field, byref(value))
+
+
+    def solve(self) -> int:
+        """
+        Solve the scenario-tree OCP, starting from the current iterates of the scenario solvers.
+        The solution is written to the iterates of the scenario solvers.
+
+            :returns: status
+        """
+        self.status = self.__acados_lib.ocp_nlp_scenario_tree_solver_solve(self.__solver)
+        return self.status
+
+
+    def get_stats(self, field_: str) -> Union[int, float]:
+        """
+        Get the information of the last solve.
+
+            :param field_: string in ['status', 'sqp_iter', 'qp_status', 'qp_iter', 'num_scenarios', 'num_nodes', 'step_norm', 'res_stat', 'res_eq', 'res_ineq', 'res_comp', 'time_tot', 'time_lin', 'time_qp']
+        """
+        int_fields = ['status', 'sqp_iter', 'qp_status', 'qp_iter', 'num_scenarios', 'num_nodes']
+        double_fields = ['step_norm', 'res_stat', 'res_eq', 'res_ineq', 'res_comp', 'time_tot', 'time_lin', 'time_qp']
+
+        field = field_.encode('utf-8')
+        if field_ in int_fields:
+            out = c_int(0)
+        elif field_ in double_fields:
+            out = c_double(0)
+        else:
+            raise ValueError(f"AcadosOcpScenarioTreeSolver.get_stats(): '{field_}' is not a valid argument, possible values are {int_fields + double_fields}.")
+        self.__acados_lib.ocp_nlp_scenario_tree_solver_get(self.__solver, field, byref(out))
+        return out.value
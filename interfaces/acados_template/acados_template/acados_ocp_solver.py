@@ -213,6 +213,9 @@ class AcadosOcpSolver:
     def __init__(self, acados_ocp: Union[AcadosOcp, AcadosMultiphaseOcp, None], json_file=None, simulink_opts=None, build=True, generate=True, cmake_builder: CMakeBuilder = None, verbose=True, save_p_global=False):
 
         self.solver_created = False
+        self.__owned_by_batch = False
+        self.__feedback_law = None
+        self.__async_rti = None
         self.__save_p_global = save_p_global
         if save_p_global:
             self.__p_global_values = acados_ocp.p_global_values
@@ -335,6 +338,12 @@ class AcadosOcpSolver:
         self.__acados_lib.ocp_nlp_solver_opts_set.argtypes = [c_void_p, c_void_p, c_char_p, c_void_p]
         self.__acados_lib.ocp_nlp_solver_opts_get.argtypes = [c_void_p, c_void_p, c_char_p, c_void_p]
         self.__acados_lib.ocp_nlp_get.argtypes = [c_void_p, c_char_p, c_void_p]
+        self.__acados_lib.ocp_nlp_profiling_dump_trace.argtypes = [c_void_p, c_char_p]
+        self.__acados_lib.ocp_nlp_profiling_dump_trace.restype = c_int
+        self.__acados_lib.ocp_nlp_qp_capture_start.argtypes = [c_void_p, c_char_p, c_int, c_int]
+        self.__acados_lib.ocp_nlp_qp_capture_start.restype = c_int
+        self.__acados_lib.ocp_nlp_qp_capture_stop.argtypes = [c_void_p]
+        self.__acados_lib.ocp_nlp_qp_capture_stop.restype = None
 
         self.__acados_lib.ocp_nlp_eval_cost.argtypes = [c_void_p, c_void_p, c_void_p]
         self.__acados_lib.ocp_nlp_eval_residuals.argtypes = [c_void_p, c_void_p, c_void_p]
@@ -371,6 +380,31 @@ class AcadosOcpSolver:
 
         self.__acados_lib.ocp_nlp_out_set_values_to_zero.argtypes = [c_void_p, c_void_p, c_void_p]
 
+        self.__acados_lib.ocp_nlp_field_handle_create.argtypes = [c_void_p, c_void_p, c_void_p, c_void_p, c_char_p, c_int, c_int]
+        self.__acados_lib.ocp_nlp_field_handle_create.restype = c_void_p
+        self.__acados_lib.ocp_nlp_field_handle_destroy.argtypes = [c_void_p]
+        self.__acados_lib.ocp_nlp_field_handle_destroy.restype = None
+        self.__acados_lib.ocp_nlp_feedback_law_create.argtypes = [c_void_p, c_void_p]
+        self.__acados_lib.ocp_nlp_feedback_law_create.restype = c_void_p
+        self.__acados_lib.ocp_nlp_feedback_law_destroy.argtypes = [c_void_p]
+        self.__acados_lib.ocp_nlp_feedback_law_destroy.restype = None
+        self.__acados_lib.ocp_nlp_feedback_law_update.argtypes = [c_void_p, c_void_p, c_void_p, c_void_p]
+        self.__acados_lib.ocp_nlp_feedback_law_update.restype = c_int
+        self.__acados_lib.ocp_nlp_feedback_law_eval.argtypes = [c_void_p, POINTER(c_double), POINTER(c_double), c_int]
+        self.__acados_lib.ocp_nlp_feedback_law_eval.restype = None
+        self.__acados_lib.ocp_nlp_async_rti_create.argtypes = [c_void_p, c_void_p, c_void_p, c_int]
+        self.__acados_lib.ocp_nlp_async_rti_create.restype = c_void_p
+        self.__acados_lib.ocp_nlp_async_rti_destroy.argtypes = [c_void_p]
+        self.__acados_lib.ocp_nlp_async_rti_destroy.restype = None
+        self.__acados_lib.ocp_nlp_prepare_async.argtypes = [c_void_p]
+        self.__acados_lib.ocp_nlp_prepare_async.restype = None
+        self.__acados_lib.ocp_nlp_feedback_async.argtypes = [c_void_p, POINTER(c_double)]
+        self.__acados_lib.ocp_nlp_feedback_async.restype = c_int
+        self.__acados_lib.ocp_nlp_async_rti_get.argtypes = [c_void_p, c_char_p, c_void_p]
+        self.__acados_lib.ocp_nlp_async_rti_get.restype = None
+        self.__acados_lib.ocp_nlp_field_handle_get_ptr.argtypes = [c_void_p, c_int]
+        self.__acados_lib.ocp_nlp_field_handle_get_ptr.restype = POINTER(c_double)
+
         getattr(self.shared_lib, f"{self.name}_acados_solve").argtypes = [c_void_p]
         getattr(self.shared_lib, f"{self.name}_acados_solve").restype = c_int
 
@@ -380,6 +414,9 @@ class AcadosOcpSolver:
         getattr(self.shared_lib, f"{self.name}_acados_reset").argtypes = [c_void_p, c_int]
         getattr(self.shared_lib, f"{self.name}_acados_reset").restype = c_int
 
+        getattr(self.shared_lib, f"{self.name}_acados_shift").argtypes = [c_void_p, c_int, c_int]
+        getattr(self.shared_lib, f"{self.name}_acados_shift").restype = c_int
+
         getattr(self.shared_lib, f"{self.name}_acados_custom_update").argtypes = [c_void_p, POINTER(c_double), c_int]
         getattr(self.shared_lib, f"{self.name}_acados_custom_update").restype = c_int
 
@@ -410,6 +447,28 @@ class AcadosOcpSolver:
 
         return
 
+    @classmethod
+    def _create_from_batch_capsule(cls, prototype: 'AcadosOcpSolver', capsule: c_void_p) -> 'AcadosOcpSolver':
+        """
+        Private function to create a solver object for a capsule created by `<name>_acados_batch_create` from the capsule of `prototype`.
+        The shared library, ctypes bindings and options are taken from `prototype`.
+        The capsule is owned by the batch and is not freed by this object.
+        """
+        solver = cls.__new__(cls)
+        solver.__dict__.update(prototype.__dict__)
+        solver.__solver_options = prototype.__solver_options.copy()
+        solver.__owned_by_batch = True
+        solver.__field_handles = {}
+        solver.__feedback_law = None
+        solver.__async_rti = None
+        solver.capsule = capsule
+        solver.status = 0
+        solver.time_solution_sens_solve = 0.0
+        solver.time_solution_sens_lin = 0.0
+        solver.__get_pointers_solver()
+        return solver
+
+
     def __get_pointers_solver(self):
         """
         Private function to get the pointers for solver
@@ -443,6 +502,33 @@ class AcadosOcpSolver:
         getattr(self.shared_lib, f"{self.name}_acados_get_nlp_solver").restype = c_void_p
         self.nlp_solver = getattr(self.shared_lib, f"{self.name}_acados_get_nlp_solver")(self.capsule)
 
+        # field handles point into nlp_in and nlp_out, resolve them again on first use
+        self.__destroy_field_handles()
+
+
+    def __destroy_field_handles(self):
+        """
+        Private function to free the field handles used for the views
+        """
+        for handle in getattr(self, '_AcadosOcpSolver__field_handles', {}).values():
+            if handle is not None:
+                self.__acados_lib.ocp_nlp_field_handle_destroy(handle)
+        self.__field_handles = {}
+
+
+    def __get_field_handle(self, field: str):
+        """
+        Private function to get the field handle for all stages of field, created on first use, None if not available
+        """
+        if field not in self.__field_handles:
+            stage_last = self.N - 1 if field == 'pi' else self.N
+            handle = None
+            if stage_last >= 0:
+                handle = self.__acados_lib.ocp_nlp_field_handle_create(self.nlp_config, self.nlp_dims,
+                                            self.nlp_in, self.nlp_out, field.encode('utf-8'), 0, stage_last)
+            self.__field_handles[field] = handle
+        return self.__field_handles[field]
+
 
     def solve_for_x0(self, x0_bar, fail_on_nonzero_status=True, print_stats_on_failure=True):
         """
@@ -528,6 +614,26 @@ class AcadosOcpSolver:
         getattr(self.shared_lib, f"{self.name}_acados_reset")(self.capsule, reset_qp_solver_mem)
 
 
+    def shift(self, n_shift: int = 1, strategy: str = 'REPEAT_LAST'):
+        """
+        Shifts the current iterate by `n_shift` stages in place to warm start the next MPC cycle:
+        primal and dual variables, the initial guesses of the integrators and the QP solver warm start.
+        Parameters and references are not shifted.
+
+        :param n_shift: number of stages, in [0, N]
+        :param strategy: initialization of the new tail:
+            - 'REPEAT_LAST': repeat x_N and the controls and multipliers of the last stage,
+            - 'SIMULATE_TERMINAL': as 'REPEAT_LAST', with the states simulated forward from x_N,
+            - 'INTERPOLATE': shift by the duration of the first `n_shift` intervals, with linear interpolation of the states, for non-uniform time grids.
+        """
+        strategies = ['REPEAT_LAST', 'SIMULATE_TERMINAL', 'INTERPOLATE']
+        if strategy not in strategies:
+            raise ValueError(f"shift: strategy must be one of {strategies}, got {strategy}.")
+        if n_shift < 0 or n_shift > self.N:
+            raise ValueError(f"shift: n_shift must be in [0, {self.N}], got {n_shift}.")
+        getattr(self.shared_lib, f"{self.name}_acados_shift")(self.capsule, n_shift, strategies.index(strategy))
+
+
     def set_new_time_steps(self, new_time_steps):
         """
         Set new time steps.
@@ -545,6 +651,8 @@ class AcadosOcpSolver:
         # unlikely but still possible
         if not self.solver_created:
             raise RuntimeError('Solver was not yet created!')
+        if self.__owned_by_batch:
+            raise RuntimeError('This function can not be used for solvers which are part of an AcadosOcpBatchSolver!')
 
         # check if time steps really changed in value
         if np.array_equal(self.__solver_options['time_steps'], new_time_steps):
@@ -596,6 +704,8 @@ class AcadosOcpSolver:
         # unlikely but still possible
         if not self.solver_created:
             raise RuntimeError('Solver was not yet created!')
+        if self.__owned_by_batch:
+            raise RuntimeError('This function can not be used for solvers which are part of an AcadosOcpBatchSolver!')
         if self.N < qp_solver_cond_N:
             raise ValueError('Setting qp_solver_cond_N to be larger than N does not work!')
         if self.__solver_options['qp_solver_cond_N'] != qp_solver_cond_N:
@@ -936,12 +1046,13 @@ class AcadosOcpSolver:
             raise NotImplementedError(f"with_respect_to {with_respect_to} not implemented.")
 
 
-    def get(self, stage_: int, field_: str):
+    def get(self, stage_: int, field_: str, out: Optional[np.ndarray] = None):
         """
         Get the last solution of the solver.
 
         :param stage: integer corresponding to shooting node
         :param field: string in ['x', 'u', 'z', 'pi', 'lam', 'sl', 'su', 'p', 'sens_u', 'sens_pi', 'sens_x', 'sens_lam', 'sens_sl', 'sens_su']
+        :param out: optional preallocated float64 array of matching size, which is filled and returned instead of a new array
 
         .. note:: regarding lam: \n
                 the inequalities are internally organized in the following order: \n
@@ -977,7 +1088,7 @@ class AcadosOcpSolver:
 
         dims = self.__acados_lib.ocp_nlp_dims_get_from_attr(self.nlp_config, self.nlp_dims, self.nlp_out, stage_, field)
 
-        out = np.zeros((dims,), dtype=np.float64, order="C")
+        out = self.__check_out_buffer(out, (dims,), np.float64, 'get')
         out_data = cast(out.ctypes.data, POINTER(c_double))
 
         if field_ in in_fields:
@@ -989,11 +1100,12 @@ class AcadosOcpSolver:
         return out
 
 
-    def get_flat(self, field_: str) -> np.ndarray:
+    def get_flat(self, field_: str, out: Optional[np.ndarray] = None) -> np.ndarray:
         """
         Get concatenation of all stages of last solution of the solver.
 
         :param field: string in ['x', 'u', 'z', 'pi', 'lam', 'sl', 'su', 'p', 'p_global']
+        :param out: optional preallocated float64 array of matching size, which is filled and returned instead of a new array
 
         .. note:: The parameter 'p_global' has no stage-wise structure and is processed in a memory saving manner by default. \n
                 In order to read the 'p_global' parameter, the option 'save_p_global' must be set to 'True' upon instantiation. \n
@@ -1010,7 +1122,7 @@ class AcadosOcpSolver:
 
         dims = self.__acados_lib.ocp_nlp_dims_get_total_from_attr(self.nlp_config, self.nlp_dims, self.nlp_out, field)
 
-        out = np.zeros((dims,), dtype=np.float64, order="C")
+        out = self.__check_out_buffer(out, (dims,), np.float64, 'get_flat')
         out_data = cast(out.ctypes.data, POINTER(c_double))
 
         self.__acados_lib.ocp_nlp_get_all(self.nlp_solver, self.nlp_in, self.nlp_out, field, out_data)
@@ -1032,7 +1144,8 @@ class AcadosOcpSolver:
         if len(value_) != dims:
             raise ValueError(f'AcadosOcpSolver.set_flat(field={field_}, value): value has wrong length, expected {dims}, got {len(value_)}.')
 
-        value_ = value_.astype(float)
+        # only copies if value_ is not a contiguous float64 array already
+        value_ = np.ascontiguousarray(value_, dtype=np.float64)
         value_data = cast(value_.ctypes.data, POINTER(c_double))
         value_data_p = cast((value_data), c_void_p)
 
@@ -1040,6 +1153,72 @@ class AcadosOcpSolver:
         return
 
 
+    def get_view(self, stage: int, field: str, writeable: bool = False) -> np.ndarray:
+        """
+        Get a view onto the memory of the solver, without copying.
+        The values of the view change with every call to `solve()`, copy them to keep them.
+        The view is only valid as long as the solver is not freed or recreated, e.g. by `set_new_time_steps()`.
+
+        :param stage: integer corresponding to shooting node
+        :param field: string in ['x', 'u', 'z', 'pi', 'lam', 'sl', 'su', 'p'] for the iterate and the parameters,
+                      ['b', 'q', 'r'] for the current QP.
+        :param writeable: if True, writing to the view modifies the solver memory directly.
+                          Not supported for 'lam' and the QP fields.
+
+        .. note:: The matrices of the QP are stored in the panel-major format of blasfeo and can not be viewed,
+                  use `get_from_qp_in()` with a preallocated `out` array instead.
+        """
+        out_fields = ['x', 'u', 'z', 'pi', 'lam', 'sl', 'su', 'p']
+        qp_fields = ['b', 'q', 'r']
+
+        if field not in out_fields + qp_fields:
+            raise ValueError(f'AcadosOcpSolver.get_view(stage={stage}, field={field}): \'{field}\' is an invalid argument.'
+                             f'\n Possible values are {out_fields + qp_fields}.')
+        if not isinstance(stage, int):
+            raise TypeError(f'AcadosOcpSolver.get_view(stage={stage}, field={field}): stage index must be an integer, got type {type(stage)}.')
+        if stage < 0 or stage > self.N:
+            raise ValueError(f'AcadosOcpSolver.get_view(stage={stage}, field={field}): stage index must be in [0, {self.N}], got: {stage}.')
+        if stage == self.N and field in ['pi', 'b']:
+            raise KeyError(f'AcadosOcpSolver.get_view(stage={stage}, field={field}): field \'{field}\' does not exist at final stage {stage}.')
+        if writeable and field not in ['x', 'u', 'z', 'pi', 'sl', 'su', 'p']:
+            raise ValueError(f'AcadosOcpSolver.get_view(stage={stage}, field={field}): writeable views are not supported for field \'{field}\', use set() instead.')
+
+        if field in out_fields:
+            handle = self.__get_field_handle(field)
+            if handle is None:
+                raise ValueError(f'AcadosOcpSolver.get_view(stage={stage}, field={field}): field \'{field}\' can not be viewed.')
+            dims = self.__acados_lib.ocp_nlp_dims_get_from_attr(self.nlp_config, self.nlp_dims, self.nlp_out, stage, field.encode('utf-8'))
+            if dims == 0:
+                return np.zeros((0,), dtype=np.float64)
+            data = self.__acados_lib.ocp_nlp_field_handle_get_ptr(handle, stage)
+        else:
+            qp_dims = np.zeros((2,), dtype=np.intc, order="C")
+            self.__acados_lib.ocp_nlp_qp_dims_get_from_attr(self.nlp_config, self.nlp_dims, self.nlp_out,
+                                                            stage, field.encode('utf-8'), cast(qp_dims.ctypes.data, POINTER(c_int)))
+            dims = int(qp_dims[0])
+            if dims == 0:
+                return np.zeros((0,), dtype=np.float64)
+            data = POINTER(c_double)()
+            self.__acados_lib.ocp_nlp_get_at_stage(self.nlp_solver, stage, f'{field}_ptr'.encode('utf-8'), byref(data))
+
+        view = np.ctypeslib.as_array(data, shape=(dims,))
+        view.flags.writeable = writeable
+        return view
+
+
+    def __check_out_buffer(self, out: Optional[np.ndarray], shape: tuple, dtype, caller: str, order: str = 'C') -> np.ndarray:
+        """
+        Private function to check a preallocated output buffer, or to allocate a new one if out is None
+        """
+        if out is None:
+            return np.zeros(shape, dtype=dtype, order=order)
+        contiguous = out.flags.c_contiguous if order == 'C' else out.flags.f_contiguous
+        if out.dtype != dtype or out.shape != tuple(shape) or not contiguous or not out.flags.writeable:
+            raise ValueError(f'AcadosOcpSolver.{caller}(): out must be a writeable {order}-contiguous {np.dtype(dtype).name} '
+                             f'array of shape {tuple(shape)}, got {out.dtype} array of shape {out.shape}.')
+        return out
+
+
     def print_statistics(self):
         """
         prints statistics of previous solver run as a table:
@@ -1293,6 +1472,145 @@ class AcadosOcpSolver:
         return qp_diagnostic
 
 
+    def dump_profiling_trace(self, filename: str = ''):
+        """
+        Writes the per-stage, per-module timings of the last recorded iterations in Chrome trace event format,
+        which can be opened in chrome://tracing or https://ui.perfetto.dev.
+        Requires acados to be compiled with ACADOS_WITH_PROFILING.
+
+        :param filename: if not set, use name + '_trace.json'
+        """
+        if filename == '':
+            filename = f'{self.name}_trace.json'
+        status = self.__acados_lib.ocp_nlp_profiling_dump_trace(self.nlp_solver, filename.encode('utf-8'))
+        if status != 0:
+            raise RuntimeError(f'dump_profiling_trace: could not write {filename}.')
+
+
+    def update_feedback_law(self):
+        """
+        Updates the stage 0 affine feedback law u = u_ref + K (x - x_ref) from the last solver call,
+        with x_ref, u_ref the stage 0 iterate and K the stage 0 Riccati gain of the last QP.
+        Requires the QP solver PARTIAL_CONDENSING_HPIPM with qp_solver_cond_N == N.
+        If x0 is eliminated from the QP, soft general constraints at stage 0 are not supported.
+        The law is a copy, evaluate it with `eval_feedback_law`, e.g. between two RTI iterations.
+        """
+        if self.__solver_options["qp_solver"] != "PARTIAL_CONDENSING_HPIPM" or self.__solver_options["qp_solver_cond_N"] != self.N:
+            raise ValueError("update_feedback_law only works for PARTIAL_CONDENSING_HPIPM QP solver with qp_solver_cond_N == N.")
+        if self.__feedback_law is None:
+            self.__feedback_law = self.__acados_lib.ocp_nlp_feedback_law_create(self.nlp_solver, self.nlp_in)
+        status = self.__acados_lib.ocp_nlp_feedback_law_update(self.nlp_solver, self.nlp_in, self.nlp_out, self.__feedback_law)
+        if status != 0:
+            raise RuntimeError(f"update_feedback_law: feedback law could not be updated, status {status}.")
+
+
+    def eval_feedback_law(self, x: np.ndarray, clip: bool = True) -> np.ndarray:
+        """
+        Evaluates the stage 0 feedback law set up by the last call to `update_feedback_law`.
+
+        :param x: state, of length nx at stage 0
+        :param clip: saturate the result at the stage 0 input bounds
+        :return: u, of length nu at stage 0
+        """
+        if self.__feedback_law is None:
+            raise RuntimeError("eval_feedback_law: call update_feedback_law first.")
+        nx = self.__acados_lib.ocp_nlp_dims_get_from_attr(self.nlp_config, self.nlp_dims, self.nlp_out, 0, "x".encode('utf-8'))
+        nu = self.__acados_lib.ocp_nlp_dims_get_from_attr(self.nlp_config, self.nlp_dims, self.nlp_out, 0, "u".encode('utf-8'))
+        x = np.ascontiguousarray(x, dtype=np.float64).ravel()
+        if x.shape[0] != nx:
+            raise ValueError(f"eval_feedback_law: x should have length {nx}, got {x.shape[0]}.")
+        u = np.zeros((nu,))
+        self.__acados_lib.ocp_nlp_feedback_law_eval(self.__feedback_law,
+            cast(x.ctypes.data, POINTER(c_double)), cast(u.ctypes.data, POINTER(c_double)), int(clip))
+        return u
+
+
+    def prepare_async(self, core: int = -1):
+        """
+        Starts the preparation phase of the next RTI iteration on a background thread and returns immediately.
+        The next call to `feedback_async` waits for it only if it is not finished yet.
+        Between the two calls, the solver must not be accessed, e.g. with `set`, `get` or `solve`.
+        Only available for SQP_RTI with as_rti_level 4 and acados compiled with ACADOS_WITH_THREAD_POOL.
+
+        :param core: cpu id the background thread is pinned to, only used on the first call, -1 means no pinning
+        """
+        if self.__solver_options["nlp_solver_type"] != "SQP_RTI":
+            raise ValueError("prepare_async is only available for SQP_RTI.")
+        if self.__async_rti is None:
+            self.__async_rti = self.__acados_lib.ocp_nlp_async_rti_create(self.nlp_solver, self.nlp_in, self.nlp_out, core)
+            if self.__async_rti is None:
+                raise RuntimeError("prepare_async: could not create the background worker, see the error message above.")
+        self.__acados_lib.ocp_nlp_prepare_async(self.__async_rti)
+
+
+    def feedback_async(self, x0: Optional[np.ndarray] = None) -> int:
+        """
+        Feedback phase of an RTI iteration started with `prepare_async`.
+        Waits for the preparation phase if it is still running; otherwise, or without a preceding
+        `prepare_async`, the preparation is run on the calling thread.
+
+        :param x0: initial state, set as lower and upper bound of the stage 0 state bounds; if None, the bounds are kept
+        :return: status of the feedback phase
+        """
+        if self.__async_rti is None:
+            self.prepare_async()
+        if x0 is None:
+            x0_ptr = None
+        else:
+            x0 = np.ascontiguousarray(x0, dtype=np.float64).ravel()
+            x0_ptr = cast(x0.ctypes.data, POINTER(c_double))
+        self.status = self.__acados_lib.ocp_nlp_feedback_async(self.__async_rti, x0_ptr)
+        return self.status
+
+
+    def get_async_stats(self) -> dict:
+        """
+        Returns statistics of the asynchronous RTI iterations:
+        - num_preparations: number of preparation phases run,
+        - num_overruns: number of `feedback_async` calls that had to wait for the preparation phase,
+        - status_preparation: status of the last preparation phase,
+        - time_wait: time the last `feedback_async` call waited for the preparation phase [s].
+        """
+        if self.__async_rti is None:
+            raise RuntimeError("get_async_stats: call prepare_async first.")
+        stats = {}
+        for field in ['num_preparations', 'num_overruns', 'status_preparation']:
+            value = c_int(0)
+            self.__acados_lib.ocp_nlp_async_rti_get(self.__async_rti, field.encode('utf-8'), byref(value))
+            stats[field] = value.value
+        value = c_double(0)
+        self.__acados_lib.ocp_nlp_async_rti_get(self.__async_rti, 'time_wait'.encode('utf-8'), byref(value))
+        stats['time_wait'] = value.value
+        return stats
+
+
+    def start_qp_capture(self, prefix: str = '', num_files: int = 4, records_per_file: int = 1000):
+        """
+        Starts writing every QP passed to the QP solver, together with its solution and status, to binary files
+        <prefix>_000.acqp, <prefix>_001.acqp, ...
+        After `num_files` files with `records_per_file` QPs each, the oldest file is overwritten.
+        The captured QPs can be replayed against all QP solvers with the `acados_qp_replay` tool in bench/.
+
+        :param prefix: if not set, use name + '_qp'
+        :param num_files: number of files in the rotation
+        :param records_per_file: number of QPs per file
+        """
+        if prefix == '':
+            prefix = f'{self.name}_qp'
+        if num_files < 1 or records_per_file < 1:
+            raise ValueError('start_qp_capture: num_files and records_per_file must be positive.')
+        status = self.__acados_lib.ocp_nlp_qp_capture_start(self.nlp_solver, prefix.encode('utf-8'), num_files, records_per_file)
+        if status != 0:
+            raise RuntimeError(f'start_qp_capture: could not open {prefix}_000.acqp.')
+
+
+    def stop_qp_capture(self):
+        """
+        Stops the QP capture started with `start_qp_capture` and closes the current file.
+        """
+        self.__acados_lib.ocp_nlp_qp_capture_stop(self.nlp_solver)
+
+
     def dump_last_qp_to_json(self, filename: str = '', overwrite=False):
         """
         Dumps the latest QP data into a json file
@@ -1462,7 +1780,7 @@ class AcadosOcpSolver:
         """
         Get the information of the last solver call.
 
-        :param field: string in ['statistics', 'time_tot', 'time_lin', 'time_sim', 'time_sim_ad', 'time_sim_la', 'time_qp', 'time_qp_solver_call', 'time_reg',  'time_qpscaling', 'nlp_iter', 'sqp_iter', 'residuals', 'qp_iter', 'alpha']
+        :param field: string in ['statistics', 'time_tot', 'time_lin', 'time_sim', 'time_sim_ad', 'time_sim_la', 'sim_num_factorizations', 'time_qp', 'time_qp_solver_call', 'time_reg',  'time_qpscaling', 'nlp_iter', 'sqp_iter', 'residuals', 'qp_iter', 'alpha']
 
         Available fields:
             - time_tot: total CPU time previous call
@@ -1470,6 +1788,7 @@ class AcadosOcpSolver:
             - time_sim: CPU time for integrator
             - time_sim_ad: CPU time for integrator contribution of external function calls
             - time_sim_la: CPU time for integrator contribution of linear algebra
+            - sim_num_factorizations: number of Newton matrix factorizations in the integrators (IRK, GNSF)
             - time_qp: CPU time qp solution
             - time_qp_solver_call: CPU time inside qp solver (without converting the QP)
             - time_qp_xcond: time_glob: CPU time globalization
@@ -1480,6 +1799,7 @@ class AcadosOcpSolver:
             - time_reg: CPU time regularization
             - time_preparation: CPU time for last preparation phase, relevant for (AS-)RTI, zero otherwise
             - time_feedback: CPU time for last feedback phase, relevant for (AS-)RTI, otherwise returns total compuation time.
+            - time_feedback_rhs: CPU time for the QP rhs update within the last feedback phase, relevant for (AS-)RTI, see rti_fast_feedback
             - sqp_iter: number of SQP iterations
             - nlp_iter: number of NLP solver iterations (DDP or SQP)
             - qp_stat: vector of QP solver status for last NLP solver call
@@ -1490,6 +1810,12 @@ class AcadosOcpSolver:
             - stat_n: number of columns in statistics matrix
             - residuals: residuals of current iterate
             - alpha: step sizes of SQP iterations
+            - profiling_num_records: number of iterations kept in the profiling buffer
+            - profiling: per-stage, per-module timings of the last recorded iterations, requires acados to be compiled with ACADOS_WITH_PROFILING.
+                Dict with entries 'call' and 'iter' of shape (n_rec,) and
+                'dynamics', 'cost', 'constraints' of shape (n_rec, N+1) and
+                'regularize', 'qpscaling', 'qp_solver', 'globalization' of shape (n_rec,), containing durations in seconds,
+                as well as 'start' and 'duration' of shape (n_rec, n_slots) with the raw data.
         """
 
         if field_ == "time_solution_sens_lin":
@@ -1511,9 +1837,11 @@ class AcadosOcpSolver:
                   'time_reg',
                   'time_preparation',
                   'time_feedback',
+                  'time_feedback_rhs',
                   'qp_tau_iter',
         ]
-        int_fields = ['ddp_iter', 'sqp_iter', 'nlp_iter', 'stat_m', 'stat_n', 'qpscaling_status']
+        int_fields = ['ddp_iter', 'sqp_iter', 'nlp_iter', 'stat_m', 'stat_n', 'qpscaling_status', 'profiling_num_records',
+                      'sim_num_factorizations']
         fields = double_fields + int_fields + [
                   'qp_stat',
                   'qp_iter',
@@ -1546,6 +1874,28 @@ class AcadosOcpSolver:
             self.__acados_lib.ocp_nlp_get(self.nlp_solver, field, out_data)
             return out
 
+        elif field_ == 'profiling':
+            n_rec = self.get_stats('profiling_num_records')
+            n_slots = c_int(0)
+            self.__acados_lib.ocp_nlp_get(self.nlp_solver, b'profiling_num_slots', byref(n_slots))
+            n_slots = n_slots.value
+            stats = {}
+            for key in ['call', 'iter']:
+                out = np.zeros((n_rec,), dtype=np.intc, order="C")
+                self.__acados_lib.ocp_nlp_get(self.nlp_solver, f'profiling_{key}'.encode('utf-8'), cast(out.ctypes.data, POINTER(c_int)))
+                stats[key] = out
+            for key in ['start', 'duration']:
+                out = np.zeros((n_rec, n_slots), dtype=np.float64, order="C")
+                self.__acados_lib.ocp_nlp_get(self.nlp_solver, f'profiling_{key}'.encode('utf-8'), cast(out.ctypes.data, POINTER(c_double)))
+                stats[key] = out
+            # slot layout: stage-wise modules on stages 0..N, followed by the global modules
+            N = self.__N
+            for i, key in enumerate(['dynamics', 'cost', 'constraints']):
+                stats[key] = stats['duration'][:, i*(N+1):(i+1)*(N+1)]
+            for i, key in enumerate(['regularize', 'qpscaling', 'qp_solver', 'globalization']):
+                stats[key] = stats['duration'][:, 3*(N+1)+i]
+            return stats
+
         elif field_ in ['primal_step_norm', 'dual_step_norm']:
             nlp_iter = self.get_stats("nlp_iter")
             out = np.zeros((nlp_iter,), dtype=np.float64, order="C")
@@ -2035,12 +2385,13 @@ class AcadosOcpSolver:
         return hess_block
 
 
-    def get_from_qp_in(self, stage_: int, field_: str):
+    def get_from_qp_in(self, stage_: int, field_: str, out: Optional[np.ndarray] = None):
         """
         Get numerical data from the current QP.
 
         :param stage: integer corresponding to shooting node
         :param field: string in ['A', 'B', 'b', 'Q', 'R', 'S', 'q', 'r', 'C', 'D', 'lg', 'ug', 'lbx', 'ubx', 'lbu', 'ubu']
+        :param out: optional preallocated Fortran-contiguous array of matching shape and type, which is filled and returned instead of a new array
 
         Note:
         - additional supported fields are ['P', 'K', 'Lr'], which can be extracted form QP solver PARTIAL_CONDENSING_HPIPM.
@@ -2081,10 +2432,10 @@ class AcadosOcpSolver:
 
         # create output data
         if field_ in self.__qp_constraint_int_fields | self.__relaxed_qp_constraint_int_fields:
-            out = np.zeros((np.prod(dims),), dtype=np.int32, order="C")
+            dtype = np.int32
         else:
-            out = np.zeros((np.prod(dims),), dtype=np.float64, order="C")
-        out = out.reshape(dims[0], dims[1], order='F')
+            dtype = np.float64
+        out = self.__check_out_buffer(out, (dims[0], dims[1]), dtype, 'get_from_qp_in', order='F')
 
         out_data = cast(out.ctypes.data, POINTER(c_double))
         out_data_p = cast((out_data), c_void_p)
@@ -2093,8 +2444,40 @@ class AcadosOcpSolver:
         self.__acados_lib.ocp_nlp_get_at_stage(self.nlp_solver, stage, field, out_data_p)
 
         if field_.endswith(("Q", "R")):
-            # make symmetric: copy lower triangular part to upper triangular part
-            out = np.tril(out) + np.tril(out, -1).T
+            # make symmetric: copy lower triangular part to upper triangular part, in place
+            idx_upper = np.triu_indices(dims[0], 1)
+            out[idx_upper] = out.T[idx_upper]
+
+        return out
+
+
+    def get_from_qp_out(self, stage_: int, field_: str, out: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        Get the solution of the last QP, which is the initial guess of the next QP solve
+        if the QP solver is warm started, e.g. the shifted solution after shift().
+
+        :param stage: integer corresponding to shooting node
+        :param field: string in ['x', 'u', 'pi', 'lam']
+        :param out: optional preallocated float64 array of matching size, which is filled and returned instead of a new array
+        """
+        if field_ not in ['x', 'u', 'pi', 'lam']:
+            raise ValueError(f'AcadosOcpSolver.get_from_qp_out(stage={stage_}, field={field_}): \'{field_}\' is an invalid argument.')
+        if not isinstance(stage_, int):
+            raise TypeError("stage should be int")
+        if stage_ < 0 or stage_ > self.N:
+            raise ValueError(f"stage should be in [0, {self.N}]")
+        if stage_ == self.N and field_ == 'pi':
+            raise KeyError(f"field {field_} does not exist at final stage {stage_}.")
+
+        field = f'qp_{field_}'.encode('utf-8')
+
+        dims = np.zeros((2,), dtype=np.intc, order="C")
+        dims_data = cast(dims.ctypes.data, POINTER(c_int))
+        self.__acados_lib.ocp_nlp_qp_dims_get_from_attr(self.nlp_config, self.nlp_dims, self.nlp_out, stage_, field, dims_data)
+
+        out = self.__check_out_buffer(out, (dims[0],), np.float64, 'get_from_qp_out')
+        out_data_p = cast(out.ctypes.data, c_void_p)
+        self.__acados_lib.ocp_nlp_get_at_stage(self.nlp_solver, stage_, field, out_data_p)
 
         return out
 
@@ -2425,6 +2808,15 @@ class AcadosOcpSolver:
 
     def __del__(self):
         if self.solver_created:
+            self.__destroy_field_handles()
+            if getattr(self, '_AcadosOcpSolver__feedback_law', None) is not None:
+                self.__acados_lib.ocp_nlp_feedback_law_destroy(self.__feedback_law)
+                self.__feedback_law = None
+            if getattr(self, '_AcadosOcpSolver__async_rti', None) is not None:
+                self.__acados_lib.ocp_nlp_async_rti_destroy(self.__async_rti)
+                self.__async_rti = None
+
+        if self.solver_created and not self.__owned_by_batch:
             getattr(self.shared_lib, f"{self.name}_acados_free")(self.capsule)
             getattr(self.shared_lib, f"{self.name}_acados_free_capsule")(self.capsule)
 
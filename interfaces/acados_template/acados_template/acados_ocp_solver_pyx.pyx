@@ -47,6 +47,13 @@ from datetime import datetime
 import numpy as np
 
 
+# fields which are resolved once into field handles, index into AcadosOcpSolverCython.field_handles
+FIELD_HANDLE_INDEX = {'x': 0, 'u': 1, 'z': 2, 'pi': 3, 'lam': 4, 'sl': 5, 'su': 6, 'p': 7,
+                      'yref': 8, 'y_ref': 8, 'lbx': 9, 'ubx': 10, 'lbu': 11, 'ubu': 12}
+cdef enum:
+    N_FIELD_HANDLES = 13
+
+
 cdef class AcadosOcpSolverCython:
     """
     Class to interact with the acados ocp solver C object.
@@ -60,6 +67,7 @@ cdef class AcadosOcpSolverCython:
     cdef acados_solver_common.ocp_nlp_out *sens_out
     cdef acados_solver_common.ocp_nlp_in *nlp_in
     cdef acados_solver_common.ocp_nlp_solver *nlp_solver
+    cdef acados_solver_common.ocp_nlp_field_handle *field_handles[N_FIELD_HANDLES]
 
     cdef bint solver_created
 
@@ -106,6 +114,28 @@ cdef class AcadosOcpSolverCython:
         self.nlp_in = acados_solver.acados_get_nlp_in(self.capsule)
         self.nlp_solver = acados_solver.acados_get_nlp_solver(self.capsule)
 
+        # resolve field handles, NULL if a field is not available on all stages
+        cdef int stage_last
+        for field_, idx in FIELD_HANDLE_INDEX.items():
+            if field_ == 'y_ref':
+                continue
+            stage_last = self.N - 1 if field_ == 'pi' else self.N
+            if stage_last < 0:
+                self.field_handles[idx] = NULL
+                continue
+            self.field_handles[idx] = acados_solver_common.ocp_nlp_field_handle_create(self.nlp_config,
+                self.nlp_dims, self.nlp_in, self.nlp_out, field_.encode('utf-8'), 0, stage_last)
+
+
+    cdef acados_solver_common.ocp_nlp_field_handle *_get_field_handle(self, str field_, int stage):
+        cdef int idx = FIELD_HANDLE_INDEX.get(field_, -1)
+        if idx < 0:
+            return NULL
+        cdef acados_solver_common.ocp_nlp_field_handle *handle = self.field_handles[idx]
+        if handle == NULL or stage < handle.stage_first or stage > handle.stage_last:
+            return NULL
+        return handle
+
 
 
     def solve_for_x0(self, x0_bar, fail_on_nonzero_status=True, print_stats_on_failure=True):
@@ -147,6 +177,20 @@ cdef class AcadosOcpSolverCython:
         return acados_solver.acados_reset(self.capsule, reset_qp_solver_mem)
 
 
+    def shift(self, int n_shift=1, strategy='REPEAT_LAST'):
+        """
+        Shifts the current iterate, the integrator guesses and the QP warm start by `n_shift` stages in place.
+
+        :param strategy: one of 'REPEAT_LAST', 'SIMULATE_TERMINAL', 'INTERPOLATE', see AcadosOcpSolver.shift.
+        """
+        strategies = ['REPEAT_LAST', 'SIMULATE_TERMINAL', 'INTERPOLATE']
+        if strategy not in strategies:
+            raise ValueError(f"shift: strategy must be one of {strategies}, got {strategy}.")
+        if n_shift < 0 or n_shift > self.N:
+            raise ValueError(f"shift: n_shift must be in [0, {self.N}], got {n_shift}.")
+        return acados_solver.acados_shift(self.capsule, n_shift, strategies.index(strategy))
+
+
     def custom_update(self, data_):
         """
         A custom function that can be implemented by a user to be called between solver calls.
@@ -419,11 +463,21 @@ cdef class AcadosOcpSolverCython:
             field = field_.replace('sens_', '')
         field = field.encode('utf-8')
 
-        cdef int dims = acados_solver_common.ocp_nlp_dims_get_from_attr(self.nlp_config,
-            self.nlp_dims, self.nlp_out, stage, field)
+        cdef acados_solver_common.ocp_nlp_field_handle *handle = NULL
+        if field_ not in sens_fields:
+            handle = self._get_field_handle(field_, stage)
+
+        cdef int dims
+        if handle != NULL:
+            dims = handle.size[stage - handle.stage_first]
+        else:
+            dims = acados_solver_common.ocp_nlp_dims_get_from_attr(self.nlp_config,
+                self.nlp_dims, self.nlp_out, stage, field)
 
         cdef cnp.ndarray[cnp.float64_t, ndim=1] out = np.zeros((dims,))
-        if field_ in out_fields:
+        if handle != NULL:
+            acados_solver_common.ocp_nlp_field_handle_get(handle, stage, <double *> out.data)
+        elif field_ in out_fields:
             acados_solver_common.ocp_nlp_out_get(self.nlp_config, \
                 self.nlp_dims, self.nlp_out, stage, field, <void *> out.data)
         elif field_ in sens_fields:
@@ -436,6 +490,46 @@ cdef class AcadosOcpSolverCython:
         return out
 
 
+    def get_flat(self, str field_):
+        """
+        Get concatenation of all stages of last solution of the solver.
+
+            :param field: string in ['x', 'u', 'z', 'pi', 'lam', 'sl', 'su', 'p', 'yref', 'lbx', 'ubx', 'lbu', 'ubu']
+        """
+        if field_ not in FIELD_HANDLE_INDEX:
+            raise ValueError(f'AcadosOcpSolverCython.get_flat(field={field_}): \'{field_}\' is an invalid argument.')
+
+        cdef acados_solver_common.ocp_nlp_field_handle *handle = self.field_handles[FIELD_HANDLE_INDEX[field_]]
+        if handle == NULL:
+            raise ValueError(f'AcadosOcpSolverCython.get_flat(field={field_}): field is not available on all stages.')
+
+        cdef cnp.ndarray[cnp.float64_t, ndim=1] out = np.zeros((handle.size_total,))
+        acados_solver_common.ocp_nlp_field_handle_get_all(handle, <double *> out.data)
+
+        return out
+
+
+    def set_flat(self, str field_, value_):
+        """
+        Set concatenation of all stages, e.g. to initialize the solver.
+
+            :param field: string in ['x', 'u', 'z', 'pi', 'lam', 'sl', 'su', 'p', 'yref', 'lbx', 'ubx', 'lbu', 'ubu']
+        """
+        if field_ not in FIELD_HANDLE_INDEX:
+            raise ValueError(f'AcadosOcpSolverCython.set_flat(field={field_}): \'{field_}\' is an invalid argument.')
+
+        cdef acados_solver_common.ocp_nlp_field_handle *handle = self.field_handles[FIELD_HANDLE_INDEX[field_]]
+        if handle == NULL:
+            raise ValueError(f'AcadosOcpSolverCython.set_flat(field={field_}): field is not available on all stages.')
+
+        cdef cnp.ndarray[cnp.float64_t, ndim=1] value = np.ascontiguousarray(value_, dtype=np.float64)
+        if value.shape[0] != handle.size_total:
+            raise ValueError(f'AcadosOcpSolverCython.set_flat(field={field_}, value): value has wrong length, expected {handle.size_total}, got {value.shape[0]}.')
+
+        acados_solver_common.ocp_nlp_field_handle_set_all(handle, <double *> value.data)
+        return
+
+
     def print_statistics(self):
         """
         prints statistics of previous solver run as a table:
@@ -690,6 +784,8 @@ cdef class AcadosOcpSolverCython:
         field = field_.encode('utf-8')
 
         cdef cnp.ndarray[cnp.float64_t, ndim=1] value = np.ascontiguousarray(value_, dtype=np.float64)
+        cdef acados_solver_common.ocp_nlp_field_handle *handle
+        cdef int dims
 
         # treat parameters separately
         if field_ == 'p':
@@ -700,15 +796,21 @@ cdef class AcadosOcpSolverCython:
                     \nPossible values are {}.".format(field, \
                     constraints_fields + cost_fields + out_fields + ['p']))
 
-            dims = acados_solver_common.ocp_nlp_dims_get_from_attr(self.nlp_config,
-                self.nlp_dims, self.nlp_out, stage, field)
+            handle = self._get_field_handle(field_, stage)
+            if handle != NULL:
+                dims = handle.size[stage - handle.stage_first]
+            else:
+                dims = acados_solver_common.ocp_nlp_dims_get_from_attr(self.nlp_config,
+                    self.nlp_dims, self.nlp_out, stage, field)
 
             if value_.shape[0] != dims:
                 msg = 'AcadosOcpSolverCython.set(): mismatching dimension for field "{}" '.format(field_)
                 msg += 'with dimension {} (you have {})'.format(dims, value_.shape[0])
                 raise ValueError(msg)
 
-            if field_ in constraints_fields:
+            if handle != NULL:
+                acados_solver_common.ocp_nlp_field_handle_set(handle, stage, <double *> value.data)
+            elif field_ in constraints_fields:
                 acados_solver_common.ocp_nlp_constraints_model_set(self.nlp_config,
                     self.nlp_dims, self.nlp_in, self.nlp_out, stage, field, <void *> value.data)
             elif field_ in cost_fields:
@@ -942,5 +1044,9 @@ cdef class AcadosOcpSolverCython:
 
     def __del__(self):
         if self.solver_created:
+            for idx in range(N_FIELD_HANDLES):
+                if self.field_handles[idx] != NULL:
+                    acados_solver_common.ocp_nlp_field_handle_destroy(self.field_handles[idx])
+                    self.field_handles[idx] = NULL
             acados_solver.acados_free(self.capsule)
             acados_solver.acados_free_capsule(self.capsule)
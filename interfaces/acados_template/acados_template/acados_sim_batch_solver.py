@@ -62,6 +62,7 @@ class AcadosSimBatchSolver():
             warnings.warn("Using AcadosSimBatchSolver, but sim.solver_options.with_batch_functionality is False. Attempting to compile with openmp nonetheless.")
             sim.solver_options.with_batch_functionality = True
 
+        self.__batch_memory = None
         self.__num_threads_in_batch_solve = num_threads_in_batch_solve
         self.__N_batch = N_batch
         self.__sim_solvers = [AcadosSimSolver(sim,
@@ -79,18 +80,47 @@ class AcadosSimBatchSolver():
         for i in range(self.N_batch):
             self.__sim_solvers_pointer[i] = self.sim_solvers[i].capsule
 
-        getattr(self.__shared_lib, f"{self.__model_name}_acados_sim_batch_solve").argtypes = [POINTER(c_void_p), c_int, c_int]
-        getattr(self.__shared_lib, f"{self.__model_name}_acados_sim_batch_solve").restype = c_void_p
+        getattr(self.__shared_lib, f"{self.__model_name}_acados_sim_batch_create").argtypes = [POINTER(c_void_p), c_int, c_int]
+        getattr(self.__shared_lib, f"{self.__model_name}_acados_sim_batch_create").restype = c_void_p
+        getattr(self.__shared_lib, f"{self.__model_name}_acados_sim_batch_free").argtypes = [c_void_p]
+        getattr(self.__shared_lib, f"{self.__model_name}_acados_sim_batch_free").restype = None
+        getattr(self.__shared_lib, f"{self.__model_name}_acados_sim_batch_solve").argtypes = [POINTER(c_void_p), c_int, c_int, c_void_p]
+        getattr(self.__shared_lib, f"{self.__model_name}_acados_sim_batch_solve").restype = None
+
+        self.__create_batch_memory()
 
         if not self.sim_solvers[0].acados_lib_uses_omp:
             warnings.warn("Please compile the acados shared library with openmp and the number of threads set to 1, i.e. with the flags -DACADOS_WITH_OPENMP=ON -DACADOS_NUM_THREADS=1.")
 
 
+    def __create_batch_memory(self):
+        self.__free_batch_memory()
+        self.__batch_memory = getattr(self.__shared_lib, f"{self.__model_name}_acados_sim_batch_create")(self.__sim_solvers_pointer, self.__N_batch, self.__num_threads_in_batch_solve)
+        if self.__batch_memory is None:
+            raise MemoryError("AcadosSimBatchSolver: could not allocate the memory of the batch solve.")
+
+
+    def __free_batch_memory(self):
+        if self.__batch_memory is not None:
+            getattr(self.__shared_lib, f"{self.__model_name}_acados_sim_batch_free")(self.__batch_memory)
+            self.__batch_memory = None
+
+
+    def __del__(self):
+        if getattr(self, '_AcadosSimBatchSolver__batch_memory', None) is not None:
+            self.__free_batch_memory()
+
+
     def solve(self):
         """
         Solve the simulation problem with current input for all `N_batch` integrators.
+
+        For the ERK integrator with all sensitivities disabled, the batch is integrated in lockstep,
+        i.e. each thread advances a chunk of trajectories simultaneously using a structure-of-arrays layout.
+        The lockstep integration uses the options of the first integrator for all of them, so it is only used if
+        `num_stages` and `num_steps` are equal on all integrators; otherwise each integrator is solved separately.
         """
-        getattr(self.__shared_lib, f"{self.__model_name}_acados_sim_batch_solve")(self.__sim_solvers_pointer, self.__N_batch, self.__num_threads_in_batch_solve)
+        getattr(self.__shared_lib, f"{self.__model_name}_acados_sim_batch_solve")(self.__sim_solvers_pointer, self.__N_batch, self.__num_threads_in_batch_solve, self.__batch_memory)
 
 
     @property
@@ -111,4 +141,6 @@ class AcadosSimBatchSolver():
     @num_threads_in_batch_solve.setter
     def num_threads_in_batch_solve(self, num_threads_in_batch_solve):
         self.__num_threads_in_batch_solve = num_threads_in_batch_solve
+        # the lanes are split into one chunk per thread
+        self.__create_batch_memory()
 
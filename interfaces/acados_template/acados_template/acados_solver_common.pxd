@@ -65,6 +65,12 @@ cdef extern from "acados_c/ocp_nlp_interface.h":
     ctypedef struct ocp_nlp_solver:
         pass
 
+    ctypedef struct ocp_nlp_field_handle:
+        int stage_first
+        int stage_last
+        int size_total
+        int *size
+
     int ocp_nlp_cost_model_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in_,
         int start_stage, const char *field, void *value)
     int ocp_nlp_constraints_model_set(ocp_nlp_config *config, ocp_nlp_dims *dims,
@@ -91,6 +97,15 @@ cdef extern from "acados_c/ocp_nlp_interface.h":
     void ocp_nlp_in_get(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
         int stage, const char *field, void *value)
 
+    # field handles
+    ocp_nlp_field_handle *ocp_nlp_field_handle_create(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        ocp_nlp_in *nlp_in, ocp_nlp_out *out, const char *field, int stage_first, int stage_last)
+    void ocp_nlp_field_handle_destroy(ocp_nlp_field_handle *handle)
+    void ocp_nlp_field_handle_set(ocp_nlp_field_handle *handle, int stage, const double *value)
+    void ocp_nlp_field_handle_get(ocp_nlp_field_handle *handle, int stage, double *value)
+    void ocp_nlp_field_handle_set_all(ocp_nlp_field_handle *handle, const double *value)
+    void ocp_nlp_field_handle_get_all(ocp_nlp_field_handle *handle, double *value)
+
     # opts
     void ocp_nlp_solver_opts_set(ocp_nlp_config *config, void *opts_, const char *field, void* value)
 
@@ -2403,6 +2403,18 @@ void {{ name }}_acados_create_set_opts({{ name }}_solver_capsule* capsule)
     bool store_iterates = {{ solver_options.store_iterates }};
     ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "store_iterates", &store_iterates);
 
+{%- if solver_options.thread_pool_num_threads > 1 %}
+    int thread_pool_num_threads = {{ solver_options.thread_pool_num_threads }};
+    ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "thread_pool_num_threads", &thread_pool_num_threads);
+{%- if solver_options.thread_pool_cores | length > 0 %}
+    int thread_pool_cores[{{ solver_options.thread_pool_num_threads }}];
+    {%- for j in range(end=solver_options.thread_pool_num_threads) %}
+    thread_pool_cores[{{ j }}] = {{ solver_options.thread_pool_cores[j] }};
+    {%- endfor %}
+    ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "thread_pool_cores", thread_pool_cores);
+{%- endif %}
+{%- endif %}
+
 {%- if solver_options.nlp_solver_type == "SQP" or solver_options.nlp_solver_type == "SQP_WITH_FEASIBLE_QP" %}
     int log_primal_step_norm = {{ solver_options.log_primal_step_norm }};
     ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "log_primal_step_norm", &log_primal_step_norm);
@@ -2537,6 +2549,9 @@ ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "allow_direction_mode_switch_to_no
 
     int rti_log_only_available_residuals = {{ solver_options.rti_log_only_available_residuals }};
     ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "rti_log_only_available_residuals", &rti_log_only_available_residuals);
+
+    int rti_fast_feedback = {{ solver_options.rti_fast_feedback }};
+    ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "rti_fast_feedback", &rti_fast_feedback);
 {%- endif %}
 
     bool with_anderson_acceleration = {{ solver_options.with_anderson_acceleration }};
@@ -2875,6 +2890,14 @@ int {{ name }}_acados_reset({{ name }}_solver_capsule* capsule, int reset_qp_sol
 
 
 
+int {{ name }}_acados_shift({{ name }}_solver_capsule* capsule, int n_shift, int strategy)
+{
+    ocp_nlp_shift(capsule->nlp_solver, capsule->nlp_in, capsule->nlp_out, n_shift, strategy);
+    return 0;
+}
+
+
+
 
 int {{ name }}_acados_update_params({{ name }}_solver_capsule* capsule, int stage, double *p, int np)
 {
@@ -235,6 +235,11 @@ ACADOS_SYMBOL_EXPORT int {{ name }}_acados_free_capsule({{ name }}_solver_capsul
 ACADOS_SYMBOL_EXPORT int {{ name }}_acados_create({{ name }}_solver_capsule * capsule);
 
 ACADOS_SYMBOL_EXPORT int {{ name }}_acados_reset({{ name }}_solver_capsule* capsule, int reset_qp_solver_mem);
+/**
+ * Shifts the iterate, the integrator guesses and the QP warm start by n_shift stages, see ocp_nlp_shift.
+ * strategy: 0: repeat last stage, 1: simulate terminal stage, 2: interpolate on the time grid.
+ */
+ACADOS_SYMBOL_EXPORT int {{ name }}_acados_shift({{ name }}_solver_capsule* capsule, int n_shift, int strategy);
 ACADOS_SYMBOL_EXPORT int {{ name }}_acados_create_with_discretization({{ name }}_solver_capsule* capsule, int N, double* new_time_steps);
 
 
@@ -50,6 +50,9 @@
 #include "acados_c/external_function_interface.h"
 
 #include "acados/sim/sim_common.h"
+{%- if solver_options.with_batch_functionality and solver_options.integrator_type == "ERK" %}
+#include "acados/sim/sim_erk_integrator.h"
+{%- endif %}
 #include "acados/utils/external_function_generic.h"
 #include "acados/utils/print.h"
 
@@ -418,7 +421,95 @@ int {{ model.name }}_acados_sim_solve({{ model.name }}_sim_solver_capsule *capsu
 
 
 {% if solver_options.with_batch_functionality %}
-void {{ model.name }}_acados_sim_batch_solve({{ model.name }}_sim_solver_capsule ** capsules, int N_batch, int num_threads_in_batch_solve)
+// memory of the batch solve, allocated once for the capsules of a batch
+typedef struct
+{
+    int N_batch;
+    int n_chunks;  // 0 if the batch is not integrated in lockstep
+    int chunk_size;
+    acados_size_t chunk_work_size;
+    sim_in **in;
+    sim_out **out;
+    char *work;  // n_chunks * chunk_work_size
+} {{ model.name }}_sim_batch_memory;
+
+
+void *{{ model.name }}_acados_sim_batch_create({{ model.name }}_sim_solver_capsule ** capsules, int N_batch, int num_threads_in_batch_solve)
+{
+    int n_chunks = 0;
+    int chunk_size = 0;
+    acados_size_t chunk_work_size = 0;
+{%- if solver_options.integrator_type == "ERK" %}
+    // one chunk of lanes per thread, the workspace is sized with the options of capsules[0]
+    n_chunks = num_threads_in_batch_solve > 1 ? num_threads_in_batch_solve : 1;
+    n_chunks = n_chunks < N_batch ? n_chunks : N_batch;
+    chunk_size = (N_batch + n_chunks - 1) / n_chunks;
+    chunk_work_size = sim_erk_batch_workspace_calculate_size(capsules[0]->acados_sim_config,
+                            capsules[0]->acados_sim_dims, capsules[0]->acados_sim_opts, chunk_size);
+{%- endif %}
+
+    acados_size_t size = sizeof({{ model.name }}_sim_batch_memory);
+    size += 2 * N_batch * sizeof(void *);
+    size += n_chunks * chunk_work_size;
+    char *c_ptr = malloc(size);
+    if (c_ptr == NULL)
+    {
+        printf("\nerror: {{ model.name }}_acados_sim_batch_create: could not allocate %zu bytes.\n", (size_t) size);
+        return NULL;
+    }
+
+    {{ model.name }}_sim_batch_memory *mem = ({{ model.name }}_sim_batch_memory *) c_ptr;
+    c_ptr += sizeof({{ model.name }}_sim_batch_memory);
+    mem->in = (sim_in **) c_ptr;
+    c_ptr += N_batch * sizeof(void *);
+    mem->out = (sim_out **) c_ptr;
+    c_ptr += N_batch * sizeof(void *);
+    mem->work = c_ptr;
+
+    mem->N_batch = N_batch;
+    mem->n_chunks = n_chunks;
+    mem->chunk_size = chunk_size;
+    mem->chunk_work_size = chunk_work_size;
+    for (int i = 0; i < N_batch; i++)
+    {
+        mem->in[i] = capsules[i]->acados_sim_in;
+        mem->out[i] = capsules[i]->acados_sim_out;
+    }
+
+    return mem;
+}
+
+
+void {{ model.name }}_acados_sim_batch_free(void *batch_memory)
+{
+    free(batch_memory);
+}
+
+{% if solver_options.integrator_type == "ERK" %}
+// the lockstep integration uses the options of capsules[0] for all lanes,
+// thus it is only used if they match on all lanes and no sensitivities are requested
+static int {{ model.name }}_acados_sim_batch_lockstep({{ model.name }}_sim_solver_capsule ** capsules, int N_batch,
+                                                     {{ model.name }}_sim_batch_memory *mem)
+{
+    if (mem == NULL || mem->n_chunks == 0 || N_batch != mem->N_batch)
+        return 0;
+
+    sim_opts *opts = capsules[0]->acados_sim_opts;
+    for (int i = 0; i < N_batch; i++)
+    {
+        sim_opts *opts_i = capsules[i]->acados_sim_opts;
+        if (opts_i->sens_forw || opts_i->sens_adj || opts_i->sens_hess || opts_i->sens_algebraic ||
+            opts_i->ns != opts->ns || opts_i->num_steps != opts->num_steps)
+            return 0;
+    }
+
+    // options may have changed since the batch was created
+    return sim_erk_batch_workspace_calculate_size(capsules[0]->acados_sim_config, capsules[0]->acados_sim_dims,
+                                                  opts, mem->chunk_size) <= mem->chunk_work_size;
+}
+{% endif %}
+
+void {{ model.name }}_acados_sim_batch_solve({{ model.name }}_sim_solver_capsule ** capsules, int N_batch, int num_threads_in_batch_solve, void *batch_memory)
 {
     int num_threads_bkp;
     if (num_threads_in_batch_solve > 1){
@@ -426,11 +517,37 @@ void {{ model.name }}_acados_sim_batch_solve({{ model.name }}_sim_solver_capsule
         omp_set_num_threads({{ solver_options.num_threads_in_batch_solve }});
     }
 
+{%- if solver_options.integrator_type == "ERK" %}
+    {{ model.name }}_sim_batch_memory *mem = batch_memory;
+    if ({{ model.name }}_acados_sim_batch_lockstep(capsules, N_batch, mem))
+    {
+        // simulation only: integrate the batch in lockstep, one chunk of lanes per thread
+        #pragma omp parallel for
+        for (int c = 0; c < mem->n_chunks; c++)
+        {
+            int first = c * mem->chunk_size;
+            int n_lanes = N_batch - first < mem->chunk_size ? N_batch - first : mem->chunk_size;
+            if (n_lanes <= 0)
+                continue;
+            sim_erk_batch(capsules[0]->acados_sim_config, mem->in + first, mem->out + first,
+                          capsules[0]->acados_sim_opts, mem->work + c * mem->chunk_work_size, n_lanes);
+        }
+    }
+    else
+    {
+        #pragma omp parallel for
+        for (int i = 0; i < N_batch; i++)
+        {
+            sim_solve(capsules[i]->acados_sim_solver, capsules[i]->acados_sim_in, capsules[i]->acados_sim_out);
+        }
+    }
+{%- else %}
     #pragma omp parallel for
     for (int i = 0; i < N_batch; i++)
     {
         sim_solve(capsules[i]->acados_sim_solver, capsules[i]->acados_sim_in, capsules[i]->acados_sim_out);
     }
+{%- endif %}
 
     if (num_threads_in_batch_solve > 1){
         omp_set_num_threads( num_threads_bkp );
@@ -81,7 +81,12 @@ typedef struct {{ model.name }}_sim_solver_capsule
 ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_sim_create({{ model.name }}_sim_solver_capsule *capsule);
 ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_sim_solve({{ model.name }}_sim_solver_capsule *capsule);
 {% if solver_options.with_batch_functionality %}
-ACADOS_SYMBOL_EXPORT void {{ model.name }}_acados_sim_batch_solve({{ model.name }}_sim_solver_capsule **capsules, int N_batch, int num_threads_in_batch_solve);
+// memory of the batch solve for the N_batch capsules, returns NULL if the allocation fails
+ACADOS_SYMBOL_EXPORT void *{{ model.name }}_acados_sim_batch_create({{ model.name }}_sim_solver_capsule **capsules, int N_batch, int num_threads_in_batch_solve);
+ACADOS_SYMBOL_EXPORT void {{ model.name }}_acados_sim_batch_free(void *batch_memory);
+// for ERK without sensitivities and equal options on all capsules, the batch is integrated in lockstep
+// with the options of capsules[0], otherwise with one sim_solve per capsule; batch_memory may be NULL
+ACADOS_SYMBOL_EXPORT void {{ model.name }}_acados_sim_batch_solve({{ model.name }}_sim_solver_capsule **capsules, int N_batch, int num_threads_in_batch_solve, void *batch_memory);
 {% endif %}
 ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_sim_free({{ model.name }}_sim_solver_capsule *capsule);
 ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_sim_update_params({{ model.name }}_sim_solver_capsule *capsule, double *value, int np);
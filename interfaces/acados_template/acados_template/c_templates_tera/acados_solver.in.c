@@ -2535,12 +2535,29 @@ static void {{ model.name }}_acados_create_set_opts({{ model.name }}_solver_caps
     ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "reg_adaptive_eps", &reg_adaptive_eps);
 {%- endif %}
 
+{%- if solver_options.regularize_method == "PROJECT" and solver_options.reg_warm_start %}
+    bool reg_warm_start = true;
+    ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "reg_warm_start", &reg_warm_start);
+{%- endif %}
+
     int nlp_solver_ext_qp_res = {{ solver_options.nlp_solver_ext_qp_res }};
     ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "ext_qp_res", &nlp_solver_ext_qp_res);
 
     bool store_iterates = {{ solver_options.store_iterates }};
     ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "store_iterates", &store_iterates);
 
+{%- if solver_options.thread_pool_num_threads > 1 %}
+    int thread_pool_num_threads = {{ solver_options.thread_pool_num_threads }};
+    ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "thread_pool_num_threads", &thread_pool_num_threads);
+{%- if solver_options.thread_pool_cores | length > 0 %}
+    int thread_pool_cores[{{ solver_options.thread_pool_num_threads }}];
+    {%- for j in range(end=solver_options.thread_pool_num_threads) %}
+    thread_pool_cores[{{ j }}] = {{ solver_options.thread_pool_cores[j] }};
+    {%- endfor %}
+    ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "thread_pool_cores", thread_pool_cores);
+{%- endif %}
+{%- endif %}
+
 {%- if solver_options.nlp_solver_type == "SQP" or solver_options.nlp_solver_type == "SQP_WITH_FEASIBLE_QP" %}
     int log_primal_step_norm = {{ solver_options.log_primal_step_norm }};
     ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "log_primal_step_norm", &log_primal_step_norm);
@@ -2675,6 +2692,9 @@ static void {{ model.name }}_acados_create_set_opts({{ model.name }}_solver_caps
 
     int rti_log_only_available_residuals = {{ solver_options.rti_log_only_available_residuals }};
     ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "rti_log_only_available_residuals", &rti_log_only_available_residuals);
+
+    int rti_fast_feedback = {{ solver_options.rti_fast_feedback }};
+    ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "rti_fast_feedback", &rti_fast_feedback);
 {%- endif %}
 
     bool with_anderson_acceleration = {{ solver_options.with_anderson_acceleration }};
@@ -2709,12 +2729,22 @@ static void {{ model.name }}_acados_create_set_opts({{ model.name }}_solver_caps
     ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "qp_warm_start", &qp_solver_warm_start);
     {%- endif %}
 
+    {%- if solver_options.qp_solver_reuse_constant_lhs %}
+    int qp_solver_reuse_constant_lhs = 1;
+    ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "qp_reuse_constant_lhs", &qp_solver_reuse_constant_lhs);
+    {%- endif %}
+
     int print_level = {{ solver_options.print_level }};
     ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "print_level", &print_level);
 
 {%- if solver_options.qp_solver is containing('PARTIAL_CONDENSING') %}
     int qp_solver_cond_ric_alg = {{ solver_options.qp_solver_cond_ric_alg }};
     ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "qp_cond_ric_alg", &qp_solver_cond_ric_alg);
+
+    {%- if solver_options.qp_solver_cond_num_threads > 1 %}
+    int qp_solver_cond_num_threads = {{ solver_options.qp_solver_cond_num_threads }};
+    ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "qp_cond_num_threads", &qp_solver_cond_num_threads);
+    {%- endif %}
 {% endif %}
 
 {%- if solver_options.qp_solver == 'PARTIAL_CONDENSING_HPIPM' %}
@@ -2802,6 +2832,7 @@ int {{ model.name }}_acados_create_with_discretization({{ model.name }}_solver_c
 
     // number of expected runtime parameters
     capsule->nlp_np = NP;
+    capsule->nlp_batch = NULL;
 
     // 1) create and set nlp_solver_plan; create nlp_config
     capsule->nlp_solver_plan = ocp_nlp_plan_create(N);
@@ -2828,6 +2859,8 @@ int {{ model.name }}_acados_create_with_discretization({{ model.name }}_solver_c
     // 6) setup functions, nlp_in and default parameters
     {{ model.name }}_acados_create_setup_functions(capsule);
     {{ model.name }}_acados_setup_nlp_in(capsule, N, new_time_steps);
+    capsule->p_handle = ocp_nlp_field_handle_create(capsule->nlp_config, capsule->nlp_dims,
+                                                    capsule->nlp_in, capsule->nlp_out, "p", 0, N);
     {{ model.name }}_acados_create_set_default_parameters(capsule);
 
     // 7) create solver
@@ -2854,6 +2887,12 @@ int {{ model.name }}_acados_update_qp_solver_cond_N({{ model.name }}_solver_caps
     printf("\nacados_update_qp_solver_cond_N() not implemented, since N_horizon = 0!\n\n");
     exit(1);
 {%- elif solver_options.qp_solver is starting_with("PARTIAL_CONDENSING") %}
+    if (capsule->nlp_batch)
+    {
+        printf("\nacados_update_qp_solver_cond_N() not implemented for solvers which are part of a batch!\n\n");
+        return 1;
+    }
+
     // 1) destroy solver
     ocp_nlp_solver_destroy(capsule->nlp_solver);
 
@@ -2930,6 +2969,14 @@ int {{ model.name }}_acados_reset({{ model.name }}_solver_capsule* capsule, int
 
 
 
+int {{ model.name }}_acados_shift({{ model.name }}_solver_capsule* capsule, int n_shift, int strategy)
+{
+    ocp_nlp_shift(capsule->nlp_solver, capsule->nlp_in, capsule->nlp_out, n_shift, strategy);
+    return 0;
+}
+
+
+
 
 int {{ model.name }}_acados_update_params({{ model.name }}_solver_capsule* capsule, int stage, double *p, int np)
 {
@@ -2941,7 +2988,7 @@ int {{ model.name }}_acados_update_params({{ model.name }}_solver_capsule* capsu
             " External function has %i parameters. Exiting.\n", np, casadi_np);
         exit(1);
     }
-    ocp_nlp_in_set(capsule->nlp_config, capsule->nlp_dims, capsule->nlp_in, stage, "parameter_values", p);
+    ocp_nlp_field_handle_set(capsule->p_handle, stage, p);
 
     return solver_status;
 }
@@ -3003,20 +3050,50 @@ int {{ model.name }}_acados_setup_qp_matrices_and_factorize({{ model.name }}_sol
 
 {% if solver_options.with_batch_functionality %}
 void {{ model.name }}_acados_batch_solve({{ model.name }}_solver_capsule ** capsules, int * status_out, int N_batch, int num_threads_in_batch_solve)
+{
+    {{ model.name }}_acados_batch_solve_with_stats(capsules, status_out, N_batch, num_threads_in_batch_solve, 1, NULL, NULL, NULL);
+}
+
+
+/**
+ * Solves N_batch OCPs in parallel.
+ * The solves are distributed dynamically in chunks of chunk_size, such that threads which finish early
+ * take over remaining solves; chunk_size <= 0 results in a static distribution.
+ * If not NULL, the wall time [s], the id of the thread executing the solve and the number of NLP iterations
+ * are written to time_out, thread_id_out, nlp_iter_out, respectively, each of size N_batch.
+ */
+void {{ model.name }}_acados_batch_solve_with_stats({{ model.name }}_solver_capsule ** capsules, int * status_out, int N_batch,
+                int num_threads_in_batch_solve, int chunk_size, double * time_out, int * thread_id_out, int * nlp_iter_out)
 {
     int num_threads_bkp;
     if (num_threads_in_batch_solve > 1)
     {
-        num_threads_bkp = omp_get_num_threads();
+        num_threads_bkp = omp_get_max_threads();
         omp_set_num_threads(num_threads_in_batch_solve);
     }
 
-    #pragma omp parallel for
+    omp_sched_t schedule_bkp;
+    int chunk_size_bkp;
+    omp_get_schedule(&schedule_bkp, &chunk_size_bkp);
+    if (chunk_size > 0)
+        omp_set_schedule(omp_sched_dynamic, chunk_size);
+    else
+        omp_set_schedule(omp_sched_static, 0);
+
+    #pragma omp parallel for schedule(runtime)
     for (int i = 0; i < N_batch; i++)
     {
+        double t0 = omp_get_wtime();
         status_out[i] = ocp_nlp_solve(capsules[i]->nlp_solver, capsules[i]->nlp_in, capsules[i]->nlp_out);
+        if (time_out)
+            time_out[i] = omp_get_wtime() - t0;
+        if (thread_id_out)
+            thread_id_out[i] = omp_get_thread_num();
+        if (nlp_iter_out)
+            ocp_nlp_get(capsules[i]->nlp_solver, "nlp_iter", &nlp_iter_out[i]);
     }
 
+    omp_set_schedule(schedule_bkp, chunk_size_bkp);
     if (num_threads_in_batch_solve > 1)
     {
         omp_set_num_threads( num_threads_bkp );
@@ -3155,6 +3232,80 @@ void {{ model.name }}_acados_batch_get_flat({{ model.name }}_solver_capsule ** c
     }
     return;
 }
+
+
+ocp_nlp_solver_batch * {{ model.name }}_acados_batch_create({{ model.name }}_solver_capsule * prototype, {{ model.name }}_solver_capsule ** capsules, int N_batch)
+{
+    const int N = prototype->nlp_solver_plan->N;
+    // keep the discretization of the prototype
+    double* new_time_steps = N == {{ model.name | upper }}_N ? NULL : prototype->nlp_in->Ts;
+
+    // plan, config and dims are shared with the prototype,
+    // opts, nlp_in, nlp_out, sens_out, memory and workspace are allocated in one block
+    ocp_nlp_solver_batch *batch = ocp_nlp_solver_batch_create(prototype->nlp_config, prototype->nlp_dims,
+                                                              prototype->nlp_opts, prototype->nlp_in, N_batch);
+
+    for (int i = 0; i < N_batch; i++)
+    {
+        {{ model.name }}_solver_capsule *capsule = {{ model.name }}_acados_create_capsule();
+        capsules[i] = capsule;
+
+        capsule->nlp_np = NP;
+        capsule->nlp_batch = batch;
+        capsule->nlp_solver_plan = prototype->nlp_solver_plan;
+        capsule->nlp_config = prototype->nlp_config;
+        capsule->nlp_dims = prototype->nlp_dims;
+
+        // opts: each instance keeps its own, since they can be changed per solver and are modified during the solve
+        capsule->nlp_opts = batch->opts[i];
+        {{ model.name }}_acados_create_set_opts(capsule);
+
+        capsule->nlp_out = batch->nlp_out[i];
+        capsule->sens_out = batch->sens_out[i];
+        {{ model.name }}_acados_set_nlp_out(capsule);
+
+        capsule->nlp_in = batch->nlp_in[i];
+        {{ model.name }}_acados_create_setup_functions(capsule);
+        {{ model.name }}_acados_setup_nlp_in(capsule, N, new_time_steps);
+        capsule->p_handle = ocp_nlp_field_handle_create(capsule->nlp_config, capsule->nlp_dims,
+                                                        capsule->nlp_in, capsule->nlp_out, "p", 0, N);
+        {{ model.name }}_acados_create_set_default_parameters(capsule);
+
+        if (ocp_nlp_solver_batch_assign_solver(batch, i))
+        {
+            printf("\n{{ model.name }}_acados_batch_create: failed to assign solver %d!\n\n", i);
+            exit(1);
+        }
+        capsule->nlp_solver = batch->solver[i];
+
+        {{ model.name }}_acados_create_precompute(capsule);
+
+        {%- if custom_update_filename != "" %}
+        custom_update_init_function(capsule);
+        {%- endif %}
+    }
+
+    return batch;
+}
+
+
+int {{ model.name }}_acados_batch_free(ocp_nlp_solver_batch * batch, {{ model.name }}_solver_capsule ** capsules, int N_batch)
+{
+    for (int i = 0; i < N_batch; i++)
+    {
+        {{ model.name }}_acados_free(capsules[i]);
+        {{ model.name }}_acados_free_capsule(capsules[i]);
+    }
+    ocp_nlp_solver_batch_destroy(batch);
+
+    return 0;
+}
+
+
+size_t {{ model.name }}_acados_batch_get_memsize(ocp_nlp_solver_batch * batch)
+{
+    return (size_t) batch->memsize;
+}
 {% endif %}
 
 
@@ -3165,15 +3316,20 @@ int {{ model.name }}_acados_free({{ model.name }}_solver_capsule* capsule)
     {%- if custom_update_filename != "" %}
     custom_update_terminate_function(capsule);
     {%- endif %}
-    // free memory
-    ocp_nlp_solver_opts_destroy(capsule->nlp_opts);
-    ocp_nlp_in_destroy(capsule->nlp_in);
-    ocp_nlp_out_destroy(capsule->nlp_out);
-    ocp_nlp_out_destroy(capsule->sens_out);
-    ocp_nlp_solver_destroy(capsule->nlp_solver);
-    ocp_nlp_dims_destroy(capsule->nlp_dims);
-    ocp_nlp_config_destroy(capsule->nlp_config);
-    ocp_nlp_plan_destroy(capsule->nlp_solver_plan);
+    ocp_nlp_field_handle_destroy(capsule->p_handle);
+
+    // free memory, the acados objects of a batch instance are freed together with the batch
+    if (!capsule->nlp_batch)
+    {
+        ocp_nlp_solver_opts_destroy(capsule->nlp_opts);
+        ocp_nlp_in_destroy(capsule->nlp_in);
+        ocp_nlp_out_destroy(capsule->nlp_out);
+        ocp_nlp_out_destroy(capsule->sens_out);
+        ocp_nlp_solver_destroy(capsule->nlp_solver);
+        ocp_nlp_dims_destroy(capsule->nlp_dims);
+        ocp_nlp_config_destroy(capsule->nlp_config);
+        ocp_nlp_plan_destroy(capsule->nlp_solver_plan);
+    }
 
     /* free external function */
     // dynamics
@@ -99,6 +99,12 @@ typedef struct {{ model.name }}_solver_capsule
     // number of expected runtime parameters
     unsigned int nlp_np;
 
+    // batch that owns the acados objects above, NULL for a standalone solver
+    ocp_nlp_solver_batch *nlp_batch;
+
+    // parameter values at stages 0, ..., N, resolved once to avoid the string dispatch in update_params
+    ocp_nlp_field_handle *p_handle;
+
     /* external functions */
 {% if dims.n_global_data > 0 %}
     external_function_casadi p_global_precompute_fun;
@@ -272,6 +278,11 @@ ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_free_capsule({{ model.name }}_s
 ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_create({{ model.name }}_solver_capsule * capsule);
 
 ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_reset({{ model.name }}_solver_capsule* capsule, int reset_qp_solver_mem);
+/**
+ * Shifts the iterate, the integrator guesses and the QP warm start by n_shift stages, see ocp_nlp_shift.
+ * strategy: 0: repeat last stage, 1: simulate terminal stage, 2: interpolate on the time grid.
+ */
+ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_shift({{ model.name }}_solver_capsule* capsule, int n_shift, int strategy);
 
 /**
  * Generic version of {{ model.name }}_acados_create which allows to use a different number of shooting intervals than
@@ -297,12 +308,22 @@ ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_setup_qp_matrices_and_factorize
 
 {% if solver_options.with_batch_functionality %}
 ACADOS_SYMBOL_EXPORT void {{ model.name }}_acados_batch_solve({{ model.name }}_solver_capsule ** capsules, int * status_out, int N_batch, int num_threads_in_batch_solve);
+ACADOS_SYMBOL_EXPORT void {{ model.name }}_acados_batch_solve_with_stats({{ model.name }}_solver_capsule ** capsules, int * status_out, int N_batch,
+                int num_threads_in_batch_solve, int chunk_size, double * time_out, int * thread_id_out, int * nlp_iter_out);
 
 ACADOS_SYMBOL_EXPORT void {{ model.name }}_acados_batch_set_flat({{ model.name }}_solver_capsule ** capsules, const char *field, double *data, int N_data, int N_batch, int num_threads_in_batch_solve);
 ACADOS_SYMBOL_EXPORT void {{ model.name }}_acados_batch_get_flat({{ model.name }}_solver_capsule ** capsules, const char *field, double *data, int N_data, int N_batch, int num_threads_in_batch_solve);
 
 ACADOS_SYMBOL_EXPORT void {{ model.name }}_acados_batch_eval_solution_sens_adj_p({{ model.name }}_solver_capsule ** capsules, const char *field, int stage, double *out, int offset, int N_batch, int num_threads_in_batch_solve);
 ACADOS_SYMBOL_EXPORT void {{ model.name }}_acados_batch_eval_params_jac({{ model.name }}_solver_capsule ** capsules, int N_batch, int num_threads_in_batch_solve);
+
+/**
+ * Creates N_batch solver capsules which share plan, config and dims with the prototype capsule.
+ * Options, nlp_in, nlp_out, sens_out, memory and workspace of all instances are placed in one memory block owned by the returned batch.
+ */
+ACADOS_SYMBOL_EXPORT ocp_nlp_solver_batch * {{ model.name }}_acados_batch_create({{ model.name }}_solver_capsule * prototype, {{ model.name }}_solver_capsule ** capsules, int N_batch);
+ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_batch_free(ocp_nlp_solver_batch * batch, {{ model.name }}_solver_capsule ** capsules, int N_batch);
+ACADOS_SYMBOL_EXPORT size_t {{ model.name }}_acados_batch_get_memsize(ocp_nlp_solver_batch * batch);
 {% endif %}
 
 ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_free({{ model.name }}_solver_capsule * capsule);
@@ -698,6 +698,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     {
         {{ name }}_acados_reset(capsule, 1);
     }
+    else if (!strcmp(field, "shift"))
+    {
+        // value: [n_shift, strategy]
+        acados_size = 2;
+        MEX_DIM_CHECK_VEC(fun_name, field, matlab_size, acados_size);
+        {{ name }}_acados_shift(capsule, (int) value[0], (int) value[1]);
+    }
     else
     {
         MEX_FIELD_NOT_SUPPORTED_SUGGEST(fun_name, field, "p, constr_x0,\
@@ -705,7 +712,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
  constr_lbu, constr_ubu, cost_y_ref[_e], sl, su, x, xdot, u, pi, lam, z, \
  cost_Vu, cost_Vx, cost_Vz, cost_W, cost_Z, cost_Zl, cost_Zu, cost_z,\
  cost_zl, cost_zu, init_x, init_u, init_z, init_xdot, init_gnsf_phi,\
- init_pi, nlp_solver_max_iter, qp_warm_start, qp_solver_mu0, qp_print_level, warm_start_first_qp, print_level");
+ init_pi, nlp_solver_max_iter, qp_warm_start, qp_solver_mu0, qp_print_level, warm_start_first_qp, print_level, shift");
     }
 
     return;
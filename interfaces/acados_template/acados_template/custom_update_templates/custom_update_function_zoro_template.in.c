@@ -54,41 +54,31 @@ typedef struct custom_memory
     struct blasfeo_dmat GWG_mat;                         // shape = (nx, nx)
     // NOTE: Covariance matrix of the additive noise (used if input_W_add_diag)
     struct blasfeo_dmat W_stage_mat;  // shape = (nw, nw)
-    // sensitivity matrices
-    struct blasfeo_dmat A_mat;                           // shape = (nx, nx)
-    struct blasfeo_dmat B_mat;                           // shape = (nx, nu)
+    // closed-loop dynamics AK_k = A_k - B_k@K, computed from the QP Jacobians
+    struct blasfeo_dmat *AK_buffer;                      // shape = N * (nx, nx)
     // matrix in linear constraints
     struct blasfeo_dmat Cg_mat;                          // shape = (ng, nx)
     struct blasfeo_dmat Dg_mat;                          // shape = (ng, nu)
     struct blasfeo_dmat Cg_e_mat;                        // shape = (ng_e, nx)
-    struct blasfeo_dmat dummy_Dgh_e_mat;                 // shape = (ngh_e_max, nu)
-    // matrix in nonlinear constraints
-    struct blasfeo_dmat Ch_mat;                          // shape = (nh, nx)
-    struct blasfeo_dmat Dh_mat;                          // shape = (nh, nu)
-    struct blasfeo_dmat Ch_e_mat;                        // shape = (nh_e, nx)
+    // C + D @ K of the linear constraints, constant
+    struct blasfeo_dmat CaDK_g_mat;                      // shape = (ng, nx)
+    struct blasfeo_dmat CaDK_g_e_mat;                    // shape = (ng_e, nx)
+    // C_k + D_k @ K of the nonlinear constraints, computed from the QP Jacobians for k = 1,...,N
+    struct blasfeo_dmat *CaDK_h_buffer;                  // shape = (N+1) * (nh_me_max, nx)
     // feedback gain matrix
     struct blasfeo_dmat K_mat;                           // shape = (nu, nx)
-    // AK = A - B@K
-    struct blasfeo_dmat AK_mat;                          // shape = (nx, nx)
-    // A@P_k
+    // AK@P_k
     struct blasfeo_dmat temp_AP_mat;                     // shape = (nx, nx)
-    // K@P_k, K@P_k@K^T
+    // K@P_k
     struct blasfeo_dmat temp_KP_mat;                     // shape = (nu, nx)
-    struct blasfeo_dmat temp_KPK_mat;                    // shape = (nu, nu)
-    // C + D @ K, (C + D @ K) @ P_k
-    struct blasfeo_dmat temp_CaDK_mat;                   // shape = (ngh_me_max, nx)
+    // (C + D @ K) @ P_k
     struct blasfeo_dmat temp_CaDKmP_mat;                 // shape = (ngh_me_max, nx)
-    struct blasfeo_dmat temp_beta_mat;                   // shape = (ngh_me_max, ngh_me_max)
+    // backoff terms gamma * sqrt(diag(M @ P_k @ M^T)) of the current constraint type
+    double *d_backoff;                                   // shape = (max(nu, ngh_me_max),)
 
-    double *d_A_mat;                                     // shape = (nx, nx)
-    double *d_B_mat;                                     // shape = (nx, nu)
     double *d_Cg_mat;                                    // shape = (ng, nx)
     double *d_Dg_mat;                                    // shape = (ng, nu)
     double *d_Cg_e_mat;                                  // shape = (ng_e, nx)
-    double *d_Cgh_mat;                                   // shape = (ng+nh, nx)
-    double *d_Dgh_mat;                                   // shape = (ng+nh, nu)
-    double *d_Cgh_e_mat;                                 // shape = (ng_e+nh_e, nx)
-    double *d_state_vec;
     // upper and lower bounds on state variables
     double *d_lbx;                                       // shape = (nbx,)
     double *d_ubx;                                       // shape = (nbx,)
@@ -159,6 +149,7 @@ static int custom_memory_calculate_size(ocp_nlp_config *nlp_config, ocp_nlp_dims
     int nh_e = {{ dims.nh_e }};
     int ngh_e_max = int_max(ng_e, nh_e);
     int ngh_me_max = int_max(ngh_e_max, int_max(ng, nh));
+    int nh_me_max = int_max(nh, nh_e);
     int nbx_e = {{ dims.nbx_e }};
 
     assert({{zoro_description.nlbx_t}} <= nbx);
@@ -179,37 +170,29 @@ static int custom_memory_calculate_size(ocp_nlp_config *nlp_config, ocp_nlp_dims
     acados_size_t size = sizeof(custom_memory);
     size += nbx * sizeof(int);
     /* blasfeo structs */
-    size += (N + 1) * sizeof(struct blasfeo_dmat);
+    size += (N + 1) * sizeof(struct blasfeo_dmat);  // uncertainty_matrix_buffer
+    size += N * sizeof(struct blasfeo_dmat);        // AK_buffer
+    size += (N + 1) * sizeof(struct blasfeo_dmat);  // CaDK_h_buffer
     /* blasfeo mem: mat */
     size += (N + 1) * blasfeo_memsize_dmat(nx, nx); // uncertainty_matrix_buffer
+    size += N * blasfeo_memsize_dmat(nx, nx);       // AK_buffer
+    size += (N + 1) * blasfeo_memsize_dmat(nh_me_max, nx); // CaDK_h_buffer
     size += blasfeo_memsize_dmat(nw, nw);           // W_mat
     size += 2 * blasfeo_memsize_dmat(nx, nw);       // unc_jac_G_mat, temp_GW_mat
-    size += 4 * blasfeo_memsize_dmat(nx, nx);       // GWG_mat, A_mat, AK_mat, temp_AP_mat
-    size += blasfeo_memsize_dmat(nx, nu);           // B_mat
+    size += 2 * blasfeo_memsize_dmat(nx, nx);       // GWG_mat, temp_AP_mat
     size += 2 * blasfeo_memsize_dmat(nu, nx);       // K_mat, temp_KP_mat
-    size += blasfeo_memsize_dmat(nu, nu);           // temp_KPK_mat
-    size += blasfeo_memsize_dmat(ng, nx);           // Cg_mat
+    size += 2 * blasfeo_memsize_dmat(ng, nx);       // Cg_mat, CaDK_g_mat
     size += blasfeo_memsize_dmat(ng, nu);           // Dg_mat
-    size += blasfeo_memsize_dmat(ng_e, nx);         // Cg_e_mat
-    size += blasfeo_memsize_dmat(ngh_e_max, nu);    // dummy_Dgh_e_mat
-    size += blasfeo_memsize_dmat(nh, nx);           // Ch_mat
-    size += blasfeo_memsize_dmat(nh, nu);           // Dh_mat
-    size += blasfeo_memsize_dmat(nh_e, nx);         // Ch_e_mat
-    size += 2 * blasfeo_memsize_dmat(ngh_me_max, nx);           // temp_CaDK_mat, temp_CaDKmP_mat
-    size += blasfeo_memsize_dmat(ngh_me_max, ngh_me_max);       // temp_beta_mat
+    size += 2 * blasfeo_memsize_dmat(ng_e, nx);     // Cg_e_mat, CaDK_g_e_mat
+    size += blasfeo_memsize_dmat(ngh_me_max, nx);   // temp_CaDKmP_mat
     // NOTE: Covariance matrix of the additive noise (used if input_W_add_diag)
     size += blasfeo_memsize_dmat(nw, nw);  // W_stage_mat
 
     /* blasfeo mem: vec */
     /* Arrays */
-    size += nx*nx *sizeof(double);                  // d_A_mat
-    size += nx*nu *sizeof(double);                  // d_B_mat
     size += (ng + ng_e) * nx * sizeof(double);      // d_Cg_mat, d_Cg_e_mat
     size += (ng) * nu * sizeof(double);             // d_Dg_mat
-    size += (nh + nh_e + ng + ng_e) * nx * sizeof(double);      // d_Cgh_mat, d_Cgh_e_mat
-    size += (nh + ng) * nu * sizeof(double);        // d_Dgh_mat
-    // d_state_vec
-    size += nx *sizeof(double);
+    size += int_max(nu, ngh_me_max) * sizeof(double);  // d_backoff
     // constraints and tightened constraints
     size += 4 * (nbx + nbu + ng + nh)*sizeof(double);
     size += 4 * (nbx_e + ng_e + nh_e)*sizeof(double);
@@ -239,6 +222,7 @@ static custom_memory *custom_memory_assign(ocp_nlp_config *nlp_config, ocp_nlp_d
     int nh_e = {{ dims.nh_e }};
     int ngh_e_max = int_max(ng_e, nh_e);
     int ngh_me_max = int_max(ngh_e_max, int_max(ng, nh));
+    int nh_me_max = int_max(nh, nh_e);
     int nbx_e = {{ dims.nbx_e }};
 
     char *c_ptr = (char *) raw_memory;
@@ -247,6 +231,8 @@ static custom_memory *custom_memory_assign(ocp_nlp_config *nlp_config, ocp_nlp_d
 
     align_char_to(8, &c_ptr);
     assign_and_advance_blasfeo_dmat_structs(N+1, &mem->uncertainty_matrix_buffer, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(N, &mem->AK_buffer, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(N+1, &mem->CaDK_h_buffer, &c_ptr);
 
     align_char_to(64, &c_ptr);
 
@@ -254,6 +240,14 @@ static custom_memory *custom_memory_assign(ocp_nlp_config *nlp_config, ocp_nlp_d
     {
         assign_and_advance_blasfeo_dmat_mem(nx, nx, &mem->uncertainty_matrix_buffer[ii], &c_ptr);
     }
+    for (int ii = 0; ii < N; ii++)
+    {
+        assign_and_advance_blasfeo_dmat_mem(nx, nx, &mem->AK_buffer[ii], &c_ptr);
+    }
+    for (int ii = 0; ii <= N; ii++)
+    {
+        assign_and_advance_blasfeo_dmat_mem(nh_me_max, nx, &mem->CaDK_h_buffer[ii], &c_ptr);
+    }
     // Disturbance Dynamics
     assign_and_advance_blasfeo_dmat_mem(nw, nw, &mem->W_mat, &c_ptr);
     assign_and_advance_blasfeo_dmat_mem(nx, nw, &mem->unc_jac_G_mat, &c_ptr);
@@ -261,34 +255,21 @@ static custom_memory *custom_memory_assign(ocp_nlp_config *nlp_config, ocp_nlp_d
     assign_and_advance_blasfeo_dmat_mem(nx, nx, &mem->GWG_mat, &c_ptr);
     // NOTE: Covariance matrix of the additive noise disturbance (used if input_W_add_diag)
     assign_and_advance_blasfeo_dmat_mem(nw, nw, &mem->W_stage_mat, &c_ptr);
-    // System Dynamics
-    assign_and_advance_blasfeo_dmat_mem(nx, nx, &mem->A_mat, &c_ptr);
-    assign_and_advance_blasfeo_dmat_mem(nx, nu, &mem->B_mat, &c_ptr);
+    // Constraints
     assign_and_advance_blasfeo_dmat_mem(ng, nx, &mem->Cg_mat, &c_ptr);
     assign_and_advance_blasfeo_dmat_mem(ng, nu, &mem->Dg_mat, &c_ptr);
     assign_and_advance_blasfeo_dmat_mem(ng_e, nx, &mem->Cg_e_mat, &c_ptr);
-    assign_and_advance_blasfeo_dmat_mem(ngh_e_max, nu, &mem->dummy_Dgh_e_mat, &c_ptr);
-    assign_and_advance_blasfeo_dmat_mem(nh, nx, &mem->Ch_mat, &c_ptr);
-    assign_and_advance_blasfeo_dmat_mem(nh, nu, &mem->Dh_mat, &c_ptr);
-    assign_and_advance_blasfeo_dmat_mem(nh_e, nx, &mem->Ch_e_mat, &c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(ng, nx, &mem->CaDK_g_mat, &c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(ng_e, nx, &mem->CaDK_g_e_mat, &c_ptr);
     assign_and_advance_blasfeo_dmat_mem(nu, nx, &mem->K_mat, &c_ptr);
-    assign_and_advance_blasfeo_dmat_mem(nx, nx, &mem->AK_mat, &c_ptr);
     assign_and_advance_blasfeo_dmat_mem(nx, nx, &mem->temp_AP_mat, &c_ptr);
     assign_and_advance_blasfeo_dmat_mem(nu, nx, &mem->temp_KP_mat, &c_ptr);
-    assign_and_advance_blasfeo_dmat_mem(nu, nu, &mem->temp_KPK_mat, &c_ptr);
-    assign_and_advance_blasfeo_dmat_mem(ngh_me_max, nx, &mem->temp_CaDK_mat, &c_ptr);
     assign_and_advance_blasfeo_dmat_mem(ngh_me_max, nx, &mem->temp_CaDKmP_mat, &c_ptr);
-    assign_and_advance_blasfeo_dmat_mem(ngh_me_max, ngh_me_max, &mem->temp_beta_mat, &c_ptr);
 
-    assign_and_advance_double(nx*nx, &mem->d_A_mat, &c_ptr);
-    assign_and_advance_double(nx*nu, &mem->d_B_mat, &c_ptr);
     assign_and_advance_double(ng*nx, &mem->d_Cg_mat, &c_ptr);
     assign_and_advance_double(ng*nu, &mem->d_Dg_mat, &c_ptr);
     assign_and_advance_double(ng_e*nx, &mem->d_Cg_e_mat, &c_ptr);
-    assign_and_advance_double((ng + nh)*nx, &mem->d_Cgh_mat, &c_ptr);
-    assign_and_advance_double((ng + nh)*nu, &mem->d_Dgh_mat, &c_ptr);
-    assign_and_advance_double((ng_e + nh_e)*nx, &mem->d_Cgh_e_mat, &c_ptr);
-    assign_and_advance_double(nx, &mem->d_state_vec, &c_ptr);
+    assign_and_advance_double(int_max(nu, ngh_me_max), &mem->d_backoff, &c_ptr);
     assign_and_advance_double(nbx, &mem->d_lbx, &c_ptr);
     assign_and_advance_double(nbx, &mem->d_ubx, &c_ptr);
     assign_and_advance_double(nbx_e, &mem->d_lbx_e, &c_ptr);
@@ -366,6 +347,25 @@ static void *custom_memory_create({{ model.name }}_solver_capsule* capsule)
 }
 
 
+/**
+ * @brief Computes GWG_mat = G @ W @ G^T.
+ *
+ * The product is formed with a symmetric rank-k update, only the lower triangle is computed and mirrored.
+ */
+static void compute_GWG(custom_memory *custom_mem, struct blasfeo_dmat *W_mat, int nx, int nw)
+{
+    // temp_GW_mat = unc_jac_G_mat * W_mat
+    blasfeo_dgemm_nn(nx, nw, nw, 1.0, &custom_mem->unc_jac_G_mat, 0, 0,
+                        W_mat, 0, 0, 0.0,
+                        &custom_mem->temp_GW_mat, 0, 0, &custom_mem->temp_GW_mat, 0, 0);
+    // GWG_mat = temp_GW_mat * unc_jac_G_mat^T
+    blasfeo_dsyrk_ln(nx, nw, 1.0, &custom_mem->temp_GW_mat, 0, 0,
+                        &custom_mem->unc_jac_G_mat, 0, 0, 0.0,
+                        &custom_mem->GWG_mat, 0, 0, &custom_mem->GWG_mat, 0, 0);
+    blasfeo_dtrtr_l(nx, &custom_mem->GWG_mat, 0, 0, &custom_mem->GWG_mat, 0, 0);
+}
+
+
 static void custom_val_init_function(ocp_nlp_dims *nlp_dims, ocp_nlp_in *nlp_in, ocp_nlp_solver *nlp_solver, custom_memory *custom_mem)
 {
     int N = nlp_dims->N;
@@ -380,7 +380,6 @@ static void custom_val_init_function(ocp_nlp_dims *nlp_dims, ocp_nlp_in *nlp_in,
 
     int ng_e = {{ dims.ng_e }};
     int nh_e = {{ dims.nh_e }};
-    int ngh_e_max = int_max(ng_e, nh_e);
     int nbx_e = {{ dims.nbx_e }};
 
     /* Get the state constraint bounds */
@@ -404,7 +403,6 @@ static void custom_val_init_function(ocp_nlp_dims *nlp_dims, ocp_nlp_in *nlp_in,
     blasfeo_pack_dmat(ng, nx, custom_mem->d_Cg_mat, ng, &custom_mem->Cg_mat, 0, 0);
     blasfeo_pack_dmat(ng, nu, custom_mem->d_Dg_mat, ng, &custom_mem->Dg_mat, 0, 0);
     blasfeo_pack_dmat(ng_e, nx, custom_mem->d_Cg_e_mat, ng_e, &custom_mem->Cg_e_mat, 0, 0);
-    blasfeo_dgese(ngh_e_max, nu, 0., &custom_mem->dummy_Dgh_e_mat, 0, 0); //fill with zeros
     // NOTE: fixed lower and upper bounds of nonlinear constraints
     ocp_nlp_constraints_model_get(nlp_solver->config, nlp_dims, nlp_in, 1, "lh", custom_mem->d_lh);
     ocp_nlp_constraints_model_get(nlp_solver->config, nlp_dims, nlp_in, 1, "uh", custom_mem->d_uh);
@@ -444,14 +442,7 @@ static void custom_val_init_function(ocp_nlp_dims *nlp_dims, ocp_nlp_in *nlp_in,
 
 {%- if not zoro_description.input_W_diag %}
     // NOTE: G, W are not changing -> precompute GWG
-    // temp_GW_mat = unc_jac_G_mat * W_mat
-    blasfeo_dgemm_nn(nx, nw, nw, 1.0, &custom_mem->unc_jac_G_mat, 0, 0,
-                        &custom_mem->W_mat, 0, 0, 0.0,
-                        &custom_mem->temp_GW_mat, 0, 0, &custom_mem->temp_GW_mat, 0, 0);
-    // GWG_mat = temp_GW_mat * unc_jac_G_mat^T
-    blasfeo_dgemm_nt(nx, nx, nw, 1.0, &custom_mem->temp_GW_mat, 0, 0,
-                        &custom_mem->unc_jac_G_mat, 0, 0, 0.0,
-                        &custom_mem->GWG_mat, 0, 0, &custom_mem->GWG_mat, 0, 0);
+    compute_GWG(custom_mem, &custom_mem->W_mat, nx, nw);
 {%- endif %}
 
 {%- if zoro_description.input_W_add_diag %}
@@ -472,6 +463,12 @@ static void custom_val_init_function(ocp_nlp_dims *nlp_dims, ocp_nlp_in *nlp_in,
     blasfeo_dgein1({{zoro_description.fdbk_K_mat[ir][ic]}}, &custom_mem->K_mat, {{ir}}, {{ic}});
     {%- endfor %}
 {%- endfor %}
+
+    // NOTE: C, D of the linear constraints and K are not changing -> precompute C + D @ K
+    blasfeo_dgemm_nn(ng, nx, nu, 1.0, &custom_mem->Dg_mat, 0, 0,
+                        &custom_mem->K_mat, 0, 0, 1.0,
+                        &custom_mem->Cg_mat, 0, 0, &custom_mem->CaDK_g_mat, 0, 0);
+    blasfeo_dgecp(ng_e, nx, &custom_mem->Cg_e_mat, 0, 0, &custom_mem->CaDK_g_e_mat, 0, 0);
 }
 
 
@@ -486,67 +483,109 @@ int custom_update_init_function({{ model.name }}_solver_capsule* capsule)
     return 1;
 }
 
-static void compute_gh_beta(struct blasfeo_dmat* K_mat, struct blasfeo_dmat* C_mat,
-                         struct blasfeo_dmat* D_mat, struct blasfeo_dmat* CaDK_mat,
-                         struct blasfeo_dmat* CaDKmP_mat, struct blasfeo_dmat* beta_mat,
-                         struct blasfeo_dmat* P_mat,
-                         int n_cstr, int nx, int nu)
+/**
+ * @brief Computes the constraint backoffs gamma * sqrt(diag(M @ P @ M^T)).
+ *
+ * Only the diagonal of M @ P @ M^T is formed, as a row-wise dot product of M @ P and M.
+ */
+static void compute_backoff(struct blasfeo_dmat* M_mat, struct blasfeo_dmat* P_mat,
+                            struct blasfeo_dmat* MP_mat, double* backoff,
+                            double backoff_scaling_gamma, int n_cstr, int nx)
 {
-    // (C+DK)@P@(C^T+K^TD^T)
-    // CaDK_mat = C_mat + D_mat @ K_mat
-    blasfeo_dgemm_nn(n_cstr, nx, nu, 1.0, D_mat, 0, 0,
-                        K_mat, 0, 0, 1.0,
-                        C_mat, 0, 0, CaDK_mat, 0, 0);
-    // CaDKmP_mat = CaDK_mat @ P_mat
-    blasfeo_dgemm_nn(n_cstr, nx, nx, 1.0, CaDK_mat, 0, 0,
+    // MP_mat = M_mat @ P_mat
+    blasfeo_dgemm_nn(n_cstr, nx, nx, 1.0, M_mat, 0, 0,
                         P_mat, 0, 0, 0.0,
-                        CaDKmP_mat, 0, 0, CaDKmP_mat, 0, 0);
-    // NOTE: here we also compute cross-terms which are not needed.
-    //       Only diag(beta_mat) is used later
-    // beta_mat = CaDKmP_mat @ CaDK_mat^T
-    // blasfeo_dgemm_nt(n_cstr, n_cstr, nx, 1.0, CaDKmP_mat, 0, 0,
-    //                     CaDK_mat, 0, 0, 0.0,
-    //                     beta_mat, 0, 0, beta_mat, 0, 0);
+                        MP_mat, 0, 0, MP_mat, 0, 0);
+
     for (int ii = 0; ii < n_cstr; ii++)
+        backoff[ii] = 0.0;
+    for (int jj = 0; jj < nx; jj++)
     {
-        blasfeo_dgemm_nt(1, 1, nx, 1.0, CaDKmP_mat, ii, 0,
-                CaDK_mat, ii, 0, 0.0,
-                beta_mat, ii, ii, beta_mat, ii, ii);
+        for (int ii = 0; ii < n_cstr; ii++)
+            backoff[ii] += BLASFEO_DMATEL(MP_mat, ii, jj) * BLASFEO_DMATEL(M_mat, ii, jj);
     }
+    for (int ii = 0; ii < n_cstr; ii++)
+        backoff[ii] = backoff_scaling_gamma * sqrt(backoff[ii]);
+}
+
+/**
+ * @brief Computes AK_mat = A - B @ K, with A, B read from BAbt = [B, A, b]^T of the QP.
+ */
+static void compute_AK(struct blasfeo_dmat* BAbt, struct blasfeo_dmat* K_mat,
+                       struct blasfeo_dmat* AK_mat, int nx, int nu)
+{
+    blasfeo_dgetr(nx, nx, BAbt, nu, 0, AK_mat, 0, 0);
+    blasfeo_dgemm_tn(nx, nx, nu, -1.0, BAbt, 0, 0,
+                        K_mat, 0, 0, 1.0,
+                        AK_mat, 0, 0, AK_mat, 0, 0);
 }
 
-static void compute_KPK(struct blasfeo_dmat* K_mat, struct blasfeo_dmat* temp_KP_mat,
-                        struct blasfeo_dmat* temp_KPK_mat, struct blasfeo_dmat* P_mat,
-                        int nx, int nu)
+/**
+ * @brief Computes CaDK_mat = C + D @ K, with C, D read from DCt = [D, C]^T of the QP.
+ *
+ * ng is the column offset of the n_cstr constraints in DCt.
+ */
+static void compute_CaDK(struct blasfeo_dmat* DCt, struct blasfeo_dmat* K_mat,
+                         struct blasfeo_dmat* CaDK_mat, int ng, int n_cstr, int nx, int nu)
 {
-    // K @ P_k @ K^T
-    // temp_KP_mat = K_mat @ P_mat
-    blasfeo_dgemm_nn(nu, nx, nx, 1.0, K_mat, 0, 0,
-                     P_mat, 0, 0, 0.0,
-                     temp_KP_mat, 0, 0, temp_KP_mat, 0, 0);
-    // temp_KPK_mat = temp_KP_mat @ K_mat^T
-    blasfeo_dgemm_nt(nu, nu, nx, 1.0, temp_KP_mat, 0, 0,
-                     K_mat, 0, 0, 0.0,
-                     temp_KPK_mat, 0, 0, temp_KPK_mat, 0, 0);
+    blasfeo_dgetr(nx, n_cstr, DCt, nu, ng, CaDK_mat, 0, 0);
+    blasfeo_dgemm_tn(n_cstr, nx, nu, 1.0, DCt, 0, ng,
+                        K_mat, 0, 0, 1.0,
+                        CaDK_mat, 0, 0, CaDK_mat, 0, 0);
 }
 
 static void compute_next_P_matrix(struct blasfeo_dmat* P_mat, struct blasfeo_dmat* P_next_mat,
-                                  struct blasfeo_dmat* A_mat, struct blasfeo_dmat* B_mat,
-                                  struct blasfeo_dmat* K_mat, struct blasfeo_dmat* W_mat,
-                                  struct blasfeo_dmat* AK_mat, struct blasfeo_dmat* temp_AP_mat, int nx, int nu)
+                                  struct blasfeo_dmat* AK_mat, struct blasfeo_dmat* W_mat,
+                                  struct blasfeo_dmat* temp_AP_mat, int nx)
 {
-    // TODO: exploit symmetry of P, however, only blasfeo_dtrmm_rlnn is implemented in high-performance BLAFEO variant.
-    // AK_mat = -B@K + A
-    blasfeo_dgemm_nn(nx, nx, nu, -1.0, B_mat, 0, 0, K_mat, 0, 0,
-                        1.0, A_mat, 0, 0, AK_mat, 0, 0);
     // temp_AP_mat = AK_mat @ P_k
     blasfeo_dgemm_nn(nx, nx, nx, 1.0, AK_mat, 0, 0,
                         P_mat, 0, 0, 0.0,
                         temp_AP_mat, 0, 0, temp_AP_mat, 0, 0);
     // P_{k+1} = temp_AP_mat @ AK_mat^T + GWG_mat
-    blasfeo_dgemm_nt(nx, nx, nx, 1.0, temp_AP_mat, 0, 0,
+    // NOTE: P_{k+1} is symmetric, only the lower triangle is computed and then mirrored
+    blasfeo_dsyrk_ln(nx, nx, 1.0, temp_AP_mat, 0, 0,
                         AK_mat, 0, 0, 1.0,
                         W_mat, 0, 0, P_next_mat, 0, 0);
+    blasfeo_dtrtr_l(nx, P_next_mat, 0, 0, P_next_mat, 0, 0);
+}
+
+/**
+ * @brief Computes the Jacobian dependent products of all stages, which do not depend on P_k.
+ *
+ * AK_k = A_k - B_k @ K for k = 0,...,N-1 and C_k + D_k @ K of the nonlinear constraints for k = 1,...,N.
+ * The stages are independent and can be evaluated in parallel.
+ */
+static void compute_stage_jacobian_products(ocp_nlp_solver *solver, custom_memory *custom_mem)
+{
+    ocp_qp_in *qp_in;
+    ocp_nlp_get(solver, "qp_in", &qp_in);
+
+    int N = solver->dims->N;
+    int nx = {{ dims.nx }};
+    int nu = {{ dims.nu }};
+
+{%- if zoro_description.num_threads > 1 %}
+    #pragma omp parallel for num_threads({{ zoro_description.num_threads }})
+{%- endif %}
+    for (int ii = 0; ii < N; ii++)
+    {
+        compute_AK(&qp_in->BAbt[ii], &custom_mem->K_mat, &custom_mem->AK_buffer[ii], nx, nu);
+{%- if zoro_description.nlh_t + zoro_description.nuh_t > 0 %}
+        if (ii+1 < N)
+        {
+            compute_CaDK(&qp_in->DCt[ii+1], &custom_mem->K_mat, &custom_mem->CaDK_h_buffer[ii+1],
+                         {{ dims.ng }}, {{ dims.nh }}, nx, nu);
+        }
+{%- endif %}
+{%- if zoro_description.nlh_e_t + zoro_description.nuh_e_t > 0 %}
+        if (ii+1 == N)
+        {
+            compute_CaDK(&qp_in->DCt[N], &custom_mem->K_mat, &custom_mem->CaDK_h_buffer[N],
+                         {{ dims.ng_e }}, {{ dims.nh_e }}, nx, qp_in->dim->nu[N]);
+        }
+{%- endif %}
+    }
 }
 
 /**
@@ -625,12 +664,7 @@ static void compute_GWG_stagewise_varying(ocp_nlp_solver* solver, custom_memory*
     //   blasfeo_print_exp_dmat(nw, nw, &custom_mem->W_stage_mat, 0, 0);
 
     // NOTE: Compute G@W@G^T term with W_stage_mat
-    // temp_GW_mat = unc_jac_G_mat * W_stage_mat
-    blasfeo_dgemm_nn(nx, nw, nw, 1.0, &custom_mem->unc_jac_G_mat, 0, 0, &custom_mem->W_stage_mat, 0, 0, 0.0,
-                    &custom_mem->temp_GW_mat, 0, 0, &custom_mem->temp_GW_mat, 0, 0);
-    // GWG_mat = temp_GW_stage_mat * unc_jac_G_mat^T
-    blasfeo_dgemm_nt(nx, nx, nw, 1.0, &custom_mem->temp_GW_mat, 0, 0, &custom_mem->unc_jac_G_mat, 0, 0, 0.0,
-                    &custom_mem->GWG_mat, 0, 0, &custom_mem->GWG_mat, 0, 0);
+    compute_GWG(custom_mem, &custom_mem->W_stage_mat, nx, nw);
 }
 {% endif %}
 
@@ -644,7 +678,6 @@ static void uncertainty_propagate_and_update(ocp_nlp_solver *solver, ocp_nlp_in
     int N = nlp_dims->N;
     int nx = nlp_dims->nx[0];
     int nu = nlp_dims->nu[0];
-    int nx_sqr = nx*nx;
     int nbx = {{ dims.nbx }};
     int nbu = {{ dims.nbu }};
     int ng = {{ dims.ng }};
@@ -654,21 +687,23 @@ static void uncertainty_propagate_and_update(ocp_nlp_solver *solver, ocp_nlp_in
     int nbx_e = {{ dims.nbx_e }};
     double backoff_scaling_gamma = {{ zoro_description.backoff_scaling_gamma }};
 
+    // Jacobian dependent products of all stages
+    compute_stage_jacobian_products(solver, custom_mem);
+
     // First Stage
     // NOTE: lbx_0 and ubx_0 should not be tightened.
     // NOTE: lg_0 and ug_0 are not tightened.
     // NOTE: lh_0 and uh_0 are not tightened.
 {%- if zoro_description.nlbu_t + zoro_description.nubu_t > 0 %}
-    compute_KPK(&custom_mem->K_mat, &custom_mem->temp_KP_mat,
-                &custom_mem->temp_KPK_mat, &(custom_mem->uncertainty_matrix_buffer[0]), nx, nu);
+    // backoff = gamma * sqrt(diag(K @ P_0 @ K^T))
+    compute_backoff(&custom_mem->K_mat, &(custom_mem->uncertainty_matrix_buffer[0]),
+                    &custom_mem->temp_KP_mat, custom_mem->d_backoff, backoff_scaling_gamma, nu, nx);
 
 {%- if zoro_description.nlbu_t > 0 %}
     // backoff lbu
     {%- for it in zoro_description.idx_lbu_t %}
     custom_mem->d_lbu_tightened[{{it}}]
-        = custom_mem->d_lbu[{{it}}]
-            + backoff_scaling_gamma * sqrt(blasfeo_dgeex1(&custom_mem->temp_KPK_mat,
-                custom_mem->idxbu[{{it}}],custom_mem->idxbu[{{it}}]));
+        = custom_mem->d_lbu[{{it}}] + custom_mem->d_backoff[custom_mem->idxbu[{{it}}]];
     {%- endfor %}
     ocp_nlp_constraints_model_set(nlp_config, nlp_dims, nlp_in, nlp_out, 0, "lbu", custom_mem->d_lbu_tightened);
 {%- endif %}
@@ -676,9 +711,7 @@ static void uncertainty_propagate_and_update(ocp_nlp_solver *solver, ocp_nlp_in
     // backoff ubu
     {%- for it in zoro_description.idx_ubu_t %}
     custom_mem->d_ubu_tightened[{{it}}]
-        = custom_mem->d_ubu[{{it}}]
-            - backoff_scaling_gamma * sqrt(blasfeo_dgeex1(&custom_mem->temp_KPK_mat,
-                custom_mem->idxbu[{{it}}],custom_mem->idxbu[{{it}}]));
+        = custom_mem->d_ubu[{{it}}] - custom_mem->d_backoff[custom_mem->idxbu[{{it}}]];
     {%- endfor %}
     ocp_nlp_constraints_model_set(nlp_config, nlp_dims, nlp_in, nlp_out, 0, "ubu", custom_mem->d_ubu_tightened);
 {%- endif %}
@@ -688,21 +721,14 @@ static void uncertainty_propagate_and_update(ocp_nlp_solver *solver, ocp_nlp_in
     // P[ii+1] = (A-B@K) @ P[ii] @ (A-B@K).T + G@W@G.T
     for (int ii = 0; ii < N-1; ii++)
     {
-        // get and pack: A, B
-        ocp_nlp_get_at_stage(solver, ii, "A", custom_mem->d_A_mat);
-        blasfeo_pack_dmat(nx, nx, custom_mem->d_A_mat, nx, &custom_mem->A_mat, 0, 0);
-        ocp_nlp_get_at_stage(solver, ii, "B", custom_mem->d_B_mat);
-        blasfeo_pack_dmat(nx, nu, custom_mem->d_B_mat, nx, &custom_mem->B_mat, 0, 0);
-
 {% if zoro_description.input_W_add_diag %}
         compute_GWG_stagewise_varying(solver, custom_mem, data, ii);
 {% endif %}
 
         compute_next_P_matrix(&(custom_mem->uncertainty_matrix_buffer[ii]),
                               &(custom_mem->uncertainty_matrix_buffer[ii+1]),
-                              &custom_mem->A_mat, &custom_mem->B_mat,
-                              &custom_mem->K_mat, &custom_mem->GWG_mat,
-                              &custom_mem->AK_mat, &custom_mem->temp_AP_mat, nx, nu);
+                              &custom_mem->AK_buffer[ii], &custom_mem->GWG_mat,
+                              &custom_mem->temp_AP_mat, nx);
 
         // state constraints
 {%- if zoro_description.nlbx_t + zoro_description.nubx_t> 0 %}
@@ -729,23 +755,21 @@ static void uncertainty_propagate_and_update(ocp_nlp_solver *solver, ocp_nlp_in
 
 {%- if zoro_description.nlbu_t + zoro_description.nubu_t > 0 %}
         // input constraints
-        compute_KPK(&custom_mem->K_mat, &custom_mem->temp_KP_mat,
-            &custom_mem->temp_KPK_mat, &(custom_mem->uncertainty_matrix_buffer[ii+1]), nx, nu);
+        compute_backoff(&custom_mem->K_mat, &(custom_mem->uncertainty_matrix_buffer[ii+1]),
+                        &custom_mem->temp_KP_mat, custom_mem->d_backoff, backoff_scaling_gamma, nu, nx);
 
     {%- if zoro_description.nlbu_t > 0 %}
         {%- for it in zoro_description.idx_lbu_t %}
-        custom_mem->d_lbu_tightened[{{it}}] = custom_mem->d_lbu[{{it}}]
-                + backoff_scaling_gamma * sqrt(blasfeo_dgeex1(&custom_mem->temp_KPK_mat,
-                    custom_mem->idxbu[{{it}}], custom_mem->idxbu[{{it}}]));
+        custom_mem->d_lbu_tightened[{{it}}]
+            = custom_mem->d_lbu[{{it}}] + custom_mem->d_backoff[custom_mem->idxbu[{{it}}]];
         {%- endfor %}
 
         ocp_nlp_constraints_model_set(nlp_config, nlp_dims, nlp_in, nlp_out, ii+1, "lbu", custom_mem->d_lbu_tightened);
     {%- endif %}
     {%- if zoro_description.nubu_t > 0 %}
         {%- for it in zoro_description.idx_ubu_t %}
-        custom_mem->d_ubu_tightened[{{it}}] = custom_mem->d_ubu[{{it}}]
-                - backoff_scaling_gamma * sqrt(blasfeo_dgeex1(&custom_mem->temp_KPK_mat,
-                    custom_mem->idxbu[{{it}}], custom_mem->idxbu[{{it}}]));
+        custom_mem->d_ubu_tightened[{{it}}]
+            = custom_mem->d_ubu[{{it}}] - custom_mem->d_backoff[custom_mem->idxbu[{{it}}]];
         {%- endfor %}
         ocp_nlp_constraints_model_set(nlp_config, nlp_dims, nlp_in, nlp_out, ii+1, "ubu", custom_mem->d_ubu_tightened);
     {%- endif %}
@@ -753,24 +777,18 @@ static void uncertainty_propagate_and_update(ocp_nlp_solver *solver, ocp_nlp_in
 
 {%- if zoro_description.nlg_t + zoro_description.nug_t > 0 %}
         // Linear constraints: g
-        compute_gh_beta(&custom_mem->K_mat, &custom_mem->Cg_mat,
-                     &custom_mem->Dg_mat, &custom_mem->temp_CaDK_mat,
-                     &custom_mem->temp_CaDKmP_mat, &custom_mem->temp_beta_mat,
-                     &custom_mem->uncertainty_matrix_buffer[ii+1], ng, nx, nu);
+        compute_backoff(&custom_mem->CaDK_g_mat, &custom_mem->uncertainty_matrix_buffer[ii+1],
+                        &custom_mem->temp_CaDKmP_mat, custom_mem->d_backoff, backoff_scaling_gamma, ng, nx);
 
     {%- if zoro_description.nlg_t > 0 %}
         {%- for it in zoro_description.idx_lg_t %}
-        custom_mem->d_lg_tightened[{{it}}]
-            = custom_mem->d_lg[{{it}}]
-                + backoff_scaling_gamma * sqrt(blasfeo_dgeex1(&custom_mem->temp_beta_mat, {{it}}, {{it}}));
+        custom_mem->d_lg_tightened[{{it}}] = custom_mem->d_lg[{{it}}] + custom_mem->d_backoff[{{it}}];
         {%- endfor %}
         ocp_nlp_constraints_model_set(nlp_config, nlp_dims, nlp_in, nlp_out, ii+1, "lg", custom_mem->d_lg_tightened);
     {%- endif %}
     {%- if zoro_description.nug_t > 0 %}
         {%- for it in zoro_description.idx_ug_t %}
-        custom_mem->d_ug_tightened[{{it}}]
-            = custom_mem->d_ug[{{it}}]
-                - backoff_scaling_gamma * sqrt(blasfeo_dgeex1(&custom_mem->temp_beta_mat, {{it}}, {{it}}));
+        custom_mem->d_ug_tightened[{{it}}] = custom_mem->d_ug[{{it}}] - custom_mem->d_backoff[{{it}}];
         {%- endfor %}
         ocp_nlp_constraints_model_set(nlp_config, nlp_dims, nlp_in, nlp_out, ii+1, "ug", custom_mem->d_ug_tightened);
     {%- endif %}
@@ -778,21 +796,9 @@ static void uncertainty_propagate_and_update(ocp_nlp_solver *solver, ocp_nlp_in
 
 
 {%- if zoro_description.nlh_t + zoro_description.nuh_t > 0 %}
-        // nonlinear constraints: h
-        // Get C_{k+1} and D_{k+1}
-        ocp_nlp_get_at_stage(solver, ii+1, "C", custom_mem->d_Cgh_mat);
-        ocp_nlp_get_at_stage(solver, ii+1, "D", custom_mem->d_Dgh_mat);
-        // NOTE: the d_Cgh_mat is column-major, the first ng rows are the Jacobians of the linear constraints
-        blasfeo_pack_dmat(nh, nx, custom_mem->d_Cgh_mat+ng, ng+nh, &custom_mem->Ch_mat, 0, 0);
-        blasfeo_pack_dmat(nh, nu, custom_mem->d_Dgh_mat+ng, ng+nh, &custom_mem->Dh_mat, 0, 0);
-
-        compute_gh_beta(&custom_mem->K_mat, &custom_mem->Ch_mat,
-                     &custom_mem->Dh_mat, &custom_mem->temp_CaDK_mat,
-                     &custom_mem->temp_CaDKmP_mat, &custom_mem->temp_beta_mat,
-                     &custom_mem->uncertainty_matrix_buffer[ii+1], nh, nx, nu);
-
-        // printf("temp_CaDKmP_mat k = %d", ii);
-        // blasfeo_print_dmat(nh, nx, &custom_mem->temp_CaDKmP_mat, 0, 0);
+        // nonlinear constraints: h, C_{k+1} + D_{k+1} @ K is computed in compute_stage_jacobian_products
+        compute_backoff(&custom_mem->CaDK_h_buffer[ii+1], &custom_mem->uncertainty_matrix_buffer[ii+1],
+                        &custom_mem->temp_CaDKmP_mat, custom_mem->d_backoff, backoff_scaling_gamma, nh, nx);
 
         // TODO: eval hessian(h) -> H_hess (nh*(nx+nu)**2)
         // temp_Kt_hhess = h_i_hess[:nx, :] + K^T * h_i_hess[nx:nx+nu, :]
@@ -804,16 +810,13 @@ static void uncertainty_propagate_and_update(ocp_nlp_solver *solver, ocp_nlp_in
 
     {%- if zoro_description.nlh_t > 0 %}
         {%- for it in zoro_description.idx_lh_t %}
-        custom_mem->d_lh_tightened[{{it}}]
-            = custom_mem->d_lh[{{it}}]
-                + backoff_scaling_gamma * sqrt(blasfeo_dgeex1(&custom_mem->temp_beta_mat, {{it}}, {{it}}));
+        custom_mem->d_lh_tightened[{{it}}] = custom_mem->d_lh[{{it}}] + custom_mem->d_backoff[{{it}}];
         {%- endfor %}
         ocp_nlp_constraints_model_set(nlp_config, nlp_dims, nlp_in, nlp_out, ii+1, "lh", custom_mem->d_lh_tightened);
     {%- endif %}
     {%- if zoro_description.nuh_t > 0 %}
         {%- for it in zoro_description.idx_uh_t %}
-        custom_mem->d_uh_tightened[{{it}}] = custom_mem->d_uh[{{it}}]
-                        - backoff_scaling_gamma * sqrt(blasfeo_dgeex1(&custom_mem->temp_beta_mat, {{it}}, {{it}}));
+        custom_mem->d_uh_tightened[{{it}}] = custom_mem->d_uh[{{it}}] - custom_mem->d_backoff[{{it}}];
         {%- endfor %}
         ocp_nlp_constraints_model_set(nlp_config, nlp_dims, nlp_in, nlp_out, ii+1, "uh", custom_mem->d_uh_tightened);
     {%- endif %}
@@ -821,22 +824,14 @@ static void uncertainty_propagate_and_update(ocp_nlp_solver *solver, ocp_nlp_in
     }
 
     // Last stage
-    // get and pack: A, B
-    ocp_nlp_get_at_stage(solver, N-1, "A", custom_mem->d_A_mat);
-    blasfeo_pack_dmat(nx, nx, custom_mem->d_A_mat, nx, &custom_mem->A_mat, 0, 0);
-    ocp_nlp_get_at_stage(solver, N-1, "B", custom_mem->d_B_mat);
-    blasfeo_pack_dmat(nx, nu, custom_mem->d_B_mat, nx, &custom_mem->B_mat, 0, 0);
-
 {% if zoro_description.input_W_add_diag %}
     compute_GWG_stagewise_varying(solver, custom_mem, data, N - 1);
 {%- endif %}
 
-    // AK_mat = -B*K + A
     compute_next_P_matrix(&(custom_mem->uncertainty_matrix_buffer[N-1]),
                         &(custom_mem->uncertainty_matrix_buffer[N]),
-                        &custom_mem->A_mat, &custom_mem->B_mat,
-                        &custom_mem->K_mat, &custom_mem->GWG_mat,
-                        &custom_mem->AK_mat, &custom_mem->temp_AP_mat, nx, nu);
+                        &custom_mem->AK_buffer[N-1], &custom_mem->GWG_mat,
+                        &custom_mem->temp_AP_mat, nx);
 
     // state constraints nlbx_e_t
 {%- if zoro_description.nlbx_e_t + zoro_description.nubx_e_t> 0 %}
@@ -863,24 +858,18 @@ static void uncertainty_propagate_and_update(ocp_nlp_solver *solver, ocp_nlp_in
 
 {%- if zoro_description.nlg_e_t + zoro_description.nug_e_t > 0 %}
     // Linear constraints: g
-    compute_gh_beta(&custom_mem->K_mat, &custom_mem->Cg_mat,
-                    &custom_mem->dummy_Dgh_e_mat, &custom_mem->temp_CaDK_mat,
-                    &custom_mem->temp_CaDKmP_mat, &custom_mem->temp_beta_mat,
-                    &custom_mem->uncertainty_matrix_buffer[N], ng, nx, nu);
+    compute_backoff(&custom_mem->CaDK_g_e_mat, &custom_mem->uncertainty_matrix_buffer[N],
+                    &custom_mem->temp_CaDKmP_mat, custom_mem->d_backoff, backoff_scaling_gamma, ng_e, nx);
 
 {%- if zoro_description.nlg_e_t > 0 %}
     {%- for it in zoro_description.idx_lg_e_t %}
-    custom_mem->d_lg_e_tightened[{{it}}]
-        = custom_mem->d_lg_e[{{it}}]
-            + backoff_scaling_gamma * sqrt(blasfeo_dgeex1(&custom_mem->temp_beta_mat, {{it}}, {{it}}));
+    custom_mem->d_lg_e_tightened[{{it}}] = custom_mem->d_lg_e[{{it}}] + custom_mem->d_backoff[{{it}}];
     {%- endfor %}
     ocp_nlp_constraints_model_set(nlp_config, nlp_dims, nlp_in, nlp_out, N, "lg", custom_mem->d_lg_e_tightened);
 {%- endif %}
 {%- if zoro_description.nug_e_t > 0 %}
     {%- for it in zoro_description.idx_ug_e_t %}
-    custom_mem->d_ug_e_tightened[{{it}}]
-        = custom_mem->d_ug_e[{{it}}]
-            - backoff_scaling_gamma * sqrt(blasfeo_dgeex1(&custom_mem->temp_beta_mat, {{it}}, {{it}}));
+    custom_mem->d_ug_e_tightened[{{it}}] = custom_mem->d_ug_e[{{it}}] - custom_mem->d_backoff[{{it}}];
     {%- endfor %}
     ocp_nlp_constraints_model_set(nlp_config, nlp_dims, nlp_in, nlp_out, N, "ug", custom_mem->d_ug_e_tightened);
 {%- endif %}
@@ -888,29 +877,19 @@ static void uncertainty_propagate_and_update(ocp_nlp_solver *solver, ocp_nlp_in
 
 
 {%- if zoro_description.nlh_e_t + zoro_description.nuh_e_t > 0 %}
-    // nonlinear constraints: h
-    // Get C_{k+1} and D_{k+1}
-    ocp_nlp_get_at_stage(solver, N, "C", custom_mem->d_Cgh_mat);
-    // NOTE: the d_Cgh_mat is column-major, the first ng rows are the Jacobians of the linear constraints
-    blasfeo_pack_dmat(nh, nx, custom_mem->d_Cgh_mat+ng, ng+nh, &custom_mem->Ch_mat, 0, 0);
-
-    compute_gh_beta(&custom_mem->K_mat, &custom_mem->Ch_mat,
-                    &custom_mem->dummy_Dgh_e_mat, &custom_mem->temp_CaDK_mat,
-                    &custom_mem->temp_CaDKmP_mat, &custom_mem->temp_beta_mat,
-                    &custom_mem->uncertainty_matrix_buffer[N], nh, nx, nu);
+    // nonlinear constraints: h, C_N is computed in compute_stage_jacobian_products
+    compute_backoff(&custom_mem->CaDK_h_buffer[N], &custom_mem->uncertainty_matrix_buffer[N],
+                    &custom_mem->temp_CaDKmP_mat, custom_mem->d_backoff, backoff_scaling_gamma, nh_e, nx);
 
     {%- if zoro_description.nlh_e_t > 0 %}
         {%- for it in zoro_description.idx_lh_e_t %}
-        custom_mem->d_lh_e_tightened[{{it}}]
-            = custom_mem->d_lh_e[{{it}}]
-                + backoff_scaling_gamma * sqrt(blasfeo_dgeex1(&custom_mem->temp_beta_mat, {{it}}, {{it}}));
+        custom_mem->d_lh_e_tightened[{{it}}] = custom_mem->d_lh_e[{{it}}] + custom_mem->d_backoff[{{it}}];
         {%- endfor %}
         ocp_nlp_constraints_model_set(nlp_config, nlp_dims, nlp_in, nlp_out, N, "lh", custom_mem->d_lh_e_tightened);
     {%- endif %}
     {%- if zoro_description.nuh_e_t > 0 %}
         {%- for it in zoro_description.idx_uh_e_t %}
-        custom_mem->d_uh_e_tightened[{{it}}] = custom_mem->d_uh_e[{{it}}]
-                        - backoff_scaling_gamma * sqrt(blasfeo_dgeex1(&custom_mem->temp_beta_mat, {{it}}, {{it}}));
+        custom_mem->d_uh_e_tightened[{{it}}] = custom_mem->d_uh_e[{{it}}] - custom_mem->d_backoff[{{it}}];
         {%- endfor %}
         ocp_nlp_constraints_model_set(nlp_config, nlp_dims, nlp_in, nlp_out, N, "uh", custom_mem->d_uh_e_tightened);
     {%- endif %}
@@ -954,13 +933,7 @@ int custom_update_function({{ model.name }}_solver_capsule* capsule, double* dat
 
 {%- if zoro_description.input_W_diag and not zoro_description.input_W_add_diag %}
     // compute GWG with updated W
-    blasfeo_dgemm_nn(nx, nw, nw, 1.0, &custom_mem->unc_jac_G_mat, 0, 0,
-                        &custom_mem->W_mat, 0, 0, 0.0,
-                        &custom_mem->temp_GW_mat, 0, 0, &custom_mem->temp_GW_mat, 0, 0);
-    // GWG_mat = temp_GW_mat * unc_jac_G_mat^T
-    blasfeo_dgemm_nt(nx, nx, nw, 1.0, &custom_mem->temp_GW_mat, 0, 0,
-                        &custom_mem->unc_jac_G_mat, 0, 0, 0.0,
-                        &custom_mem->GWG_mat, 0, 0, &custom_mem->GWG_mat, 0, 0);
+    compute_GWG(custom_mem, &custom_mem->W_mat, nx, nw);
 {%- endif %}
     uncertainty_propagate_and_update(nlp_solver, nlp_in, nlp_out, custom_mem, data, data_len);
 
@@ -988,14 +961,10 @@ int custom_update_terminate_function({{ model.name }}_solver_capsule* capsule)
 // useful prints for debugging
 
 /*
-printf("A_mat:\n");
-blasfeo_print_exp_dmat(nx, nx, &custom_mem->A_mat, 0, 0);
-printf("B_mat:\n");
-blasfeo_print_exp_dmat(nx, nu, &custom_mem->B_mat, 0, 0);
 printf("K_mat:\n");
 blasfeo_print_exp_dmat(nu, nx, &custom_mem->K_mat, 0, 0);
 printf("AK_mat:\n");
-blasfeo_print_exp_dmat(nx, nx, &custom_mem->AK_mat, 0, 0);
+blasfeo_print_exp_dmat(nx, nx, &custom_mem->AK_buffer[ii], 0, 0);
 printf("temp_AP_mat:\n");
 blasfeo_print_exp_dmat(nx, nx, &custom_mem->temp_AP_mat, 0, 0);
 printf("W_mat:\n");
@@ -93,6 +93,13 @@ class ZoroDescription:
     data_size: int = 0
     """size of data vector when calling custom update, computed automatically"""
 
+    num_threads: int = 1
+    """
+    Number of OpenMP threads used for the stage-wise products which do not depend on the uncertainty matrices,
+    i.e. A_k - B_k K and C_k + D_k K of the nonlinear constraints.
+    Only effective if acados is compiled with OpenMP.
+    """
+
 
     def make_consistent(self, dims: AcadosOcpDims) -> None:
         self.nw, _ = self.W_mat.shape
@@ -116,6 +123,9 @@ class ZoroDescription:
         if self.input_P0_diag and self.input_P0:
             raise Exception("Only one of input_P0_diag and input_P0 can be True")
 
+        if not isinstance(self.num_threads, int) or self.num_threads < 1:
+            raise ValueError("ZoroDescription: num_threads should be a positive integer.")
+
         # Print input note:
         print(f"\nThe data of the generated custom update function consists of the concatenation of:")
         i_component = 1
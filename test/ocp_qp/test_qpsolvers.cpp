@@ -29,6 +29,7 @@
  */
 
 
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -37,6 +38,11 @@
 //#include "test/test_utils/eigen.h"
 
 #include "acados_c/ocp_qp_interface.h"
+#include "acados/utils/timing.h"
+
+#if defined(ACADOS_WITH_OPENMP)
+#include <omp.h>
+#endif
 
 extern "C" {
 ocp_qp_xcond_solver_dims *create_ocp_qp_dims_mass_spring(ocp_qp_xcond_solver_config *config, int N, int nx_, int nu_, int nb_, int ng_, int ngN);
@@ -266,3 +272,489 @@ TEST_CASE("mass spring example", "[QP solvers]")
     }  // END_FOR_SOLVERS
 
 }  // END_TEST_CASE
+
+
+
+#if defined(ACADOS_WITH_QPOASES) && defined(ACADOS_WITH_OPENMP)
+TEST_CASE("concurrent qpOASES solves", "[QP solvers]")
+{
+    // independent FULL_CONDENSING_QPOASES solvers on the same problem, solved serially and in
+    // parallel; the solutions have to match, since the solvers do not share any state
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 0;
+
+    int num_threads = omp_get_max_threads();
+    int num_solvers = 4 * num_threads;
+    int num_solves = 20;  // per solver
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = FULL_CONDENSING_QPOASES;
+
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+    void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+
+    vector<ocp_qp_solver *> qp_solvers(num_solvers);
+    vector<ocp_qp_out *> qp_outs(num_solvers);
+    vector<int> status(num_solvers, 0);
+    for (int jj = 0; jj < num_solvers; jj++)
+    {
+        qp_solvers[jj] = ocp_qp_create(config, qp_dims, opts);
+        qp_outs[jj] = ocp_qp_out_create(qp_dims->orig_dims);
+    }
+
+    // reference solution
+    ocp_qp_out *qp_out_ref = ocp_qp_out_create(qp_dims->orig_dims);
+    REQUIRE(ocp_qp_solve(qp_solvers[0], qp_in, qp_out_ref) == 0);
+
+    acados_timer timer;
+
+    // serial
+    acados_tic(&timer);
+    for (int jj = 0; jj < num_solvers; jj++)
+        for (int kk = 0; kk < num_solves; kk++)
+            status[jj] |= ocp_qp_solve(qp_solvers[jj], qp_in, qp_outs[jj]);
+    double time_serial = acados_toc(&timer);
+
+    // parallel
+    acados_tic(&timer);
+    #pragma omp parallel for schedule(dynamic)
+    for (int jj = 0; jj < num_solvers; jj++)
+        for (int kk = 0; kk < num_solves; kk++)
+            status[jj] |= ocp_qp_solve(qp_solvers[jj], qp_in, qp_outs[jj]);
+    double time_parallel = acados_toc(&timer);
+
+    double max_diff = 0.0;
+    for (int jj = 0; jj < num_solvers; jj++)
+    {
+        REQUIRE(status[jj] == 0);
+        for (int ii = 0; ii <= N; ii++)
+        {
+            int nv = qp_dims->orig_dims->nx[ii] + qp_dims->orig_dims->nu[ii];
+            for (int kk = 0; kk < nv; kk++)
+            {
+                double diff = fabs(BLASFEO_DVECEL(qp_outs[jj]->ux + ii, kk) -
+                                   BLASFEO_DVECEL(qp_out_ref->ux + ii, kk));
+                max_diff = (diff > max_diff) ? diff : max_diff;
+            }
+        }
+    }
+
+    int num_total = num_solvers * num_solves;
+    printf("\nconcurrent qpOASES: %d threads, %d solves, serial %.1f solves/s, parallel %.1f solves/s, "
+           "speedup %.2f, max deviation %e\n", num_threads, num_total, num_total / time_serial,
+           num_total / time_parallel, time_serial / time_parallel, max_diff);
+
+    REQUIRE(max_diff <= 1e-12);
+
+    for (int jj = 0; jj < num_solvers; jj++)
+    {
+        free(qp_outs[jj]);
+        free(qp_solvers[jj]);
+    }
+    free(qp_out_ref);
+    free(qp_in);
+    free(qp_dims);
+    free(opts);
+    free(config);
+}
+#endif
+
+
+
+#if defined(ACADOS_WITH_OPENMP)
+TEST_CASE("parallel partial condensing", "[QP solvers]")
+{
+    // the blocks of the partially condensed QP are condensed and expanded in segments on several
+    // threads if cond_num_threads > 1; the solution has to match the one of the serial path
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 20;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 2;
+
+    int N2_values[] = {10, 5, 4};
+    int num_threads_values[] = {2, 3, 4, 32};  // 32 > N2: one segment per block
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+    ocp_qp_dims *dims = qp_dims->orig_dims;
+
+    for (int N2 : N2_values)
+    {
+        // serial reference
+        int num_threads = 1;
+        void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+        config->opts_set(config, opts, "cond_N", &N2);
+        config->opts_set(config, opts, "cond_num_threads", &num_threads);
+        ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+        ocp_qp_out *qp_out_ref = ocp_qp_out_create(dims);
+        REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out_ref) == 0);
+        free(qp_solver);
+        free(opts);
+
+        for (int num_threads : num_threads_values)
+        {
+            SECTION("N2 = " + std::to_string(N2) + ", num_threads = " + std::to_string(num_threads))
+            {
+                opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+                config->opts_set(config, opts, "cond_N", &N2);
+                config->opts_set(config, opts, "cond_num_threads", &num_threads);
+                qp_solver = ocp_qp_create(config, qp_dims, opts);
+                ocp_qp_out *qp_out = ocp_qp_out_create(dims);
+
+                // twice, the second solve reuses the segments of the first one and
+                // condenses the solution of the first one in segments as initial guess
+                REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+                bool initialize_next_xcond_qp_from_qp_out = true;
+                config->opts_set(config, opts, "initialize_next_xcond_qp_from_qp_out", &initialize_next_xcond_qp_from_qp_out);
+                REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+
+                double max_diff = 0.0;
+                for (int ii = 0; ii <= N; ii++)
+                {
+                    int nv = dims->nx[ii] + dims->nu[ii] + 2 * dims->ns[ii];
+                    int ni = dims->nb[ii] + dims->ng[ii] + dims->ns[ii];
+                    for (int kk = 0; kk < nv; kk++)
+                        max_diff = fmax(max_diff, fabs(BLASFEO_DVECEL(qp_out->ux + ii, kk) -
+                                                       BLASFEO_DVECEL(qp_out_ref->ux + ii, kk)));
+                    for (int kk = 0; kk < 2 * ni; kk++)
+                        max_diff = fmax(max_diff, fabs(BLASFEO_DVECEL(qp_out->lam + ii, kk) -
+                                                       BLASFEO_DVECEL(qp_out_ref->lam + ii, kk)));
+                    if (ii < N)
+                    {
+                        for (int kk = 0; kk < dims->nx[ii + 1]; kk++)
+                            max_diff = fmax(max_diff, fabs(BLASFEO_DVECEL(qp_out->pi + ii, kk) -
+                                                           BLASFEO_DVECEL(qp_out_ref->pi + ii, kk)));
+                    }
+                }
+
+                printf("\nparallel partial condensing: N2 = %d, num_threads = %d, max deviation %e\n",
+                       N2, num_threads, max_diff);
+                REQUIRE(max_diff <= 1e-10);
+
+                free(qp_out);
+                free(qp_solver);
+                free(opts);
+            }
+        }
+        free(qp_out_ref);
+    }
+
+    free(qp_in);
+    free(qp_dims);
+    free(config);
+}
+#endif
+
+
+
+static double ocp_qp_out_max_diff(ocp_qp_dims *dims, ocp_qp_out *qp_out, ocp_qp_out *qp_out_ref)
+{
+    int N = dims->N;
+    double max_diff = 0.0;
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nv = dims->nx[ii] + dims->nu[ii] + 2 * dims->ns[ii];
+        int ni = dims->nb[ii] + dims->ng[ii] + dims->ns[ii];
+        for (int kk = 0; kk < nv; kk++)
+            max_diff = fmax(max_diff, fabs(BLASFEO_DVECEL(qp_out->ux + ii, kk) -
+                                           BLASFEO_DVECEL(qp_out_ref->ux + ii, kk)));
+        for (int kk = 0; kk < 2 * ni; kk++)
+            max_diff = fmax(max_diff, fabs(BLASFEO_DVECEL(qp_out->lam + ii, kk) -
+                                           BLASFEO_DVECEL(qp_out_ref->lam + ii, kk)));
+        if (ii < N)
+        {
+            for (int kk = 0; kk < dims->nx[ii + 1]; kk++)
+                max_diff = fmax(max_diff, fabs(BLASFEO_DVECEL(qp_out->pi + ii, kk) -
+                                               BLASFEO_DVECEL(qp_out_ref->pi + ii, kk)));
+        }
+    }
+    return max_diff;
+}
+
+
+
+TEST_CASE("reuse constant lhs", "[QP solvers]")
+{
+    // with reuse_constant_lhs only the rhs is condensed as long as the lhs data is unchanged;
+    // changing a single entry of the lhs between two solves has to trigger a full condensing
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 20;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 2;
+    int N2 = 5;
+
+    vector<std::string> solvers = {"SPARSE_HPIPM", "DENSE_HPIPM"};
+
+    for (std::string solver : solvers)
+    {
+        SECTION(solver)
+        {
+            ocp_qp_solver_plan_t plan;
+            plan.qp_solver = hashit(solver);
+
+            ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+            ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+            ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+            ocp_qp_dims *dims = qp_dims->orig_dims;
+
+            int reuse_constant_lhs = 1;
+            void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+            set_N2(solver, config, opts, N2, N);
+            config->opts_set(config, opts, "reuse_constant_lhs", &reuse_constant_lhs);
+            ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+            ocp_qp_out *qp_out = ocp_qp_out_create(dims);
+            ocp_qp_out *qp_out_first = ocp_qp_out_create(dims);
+
+            void *opts_ref = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+            set_N2(solver, config, opts_ref, N2, N);
+            ocp_qp_out *qp_out_ref = ocp_qp_out_create(dims);
+
+            // full condensing, then condensing of the rhs only
+            REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out_first) == 0);
+            REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+            REQUIRE(ocp_qp_out_max_diff(dims, qp_out, qp_out_first) <= 1e-12);
+
+            // change a single entry of the Hessian, then a single entry of the dynamics
+            for (int jj = 0; jj < 2; jj++)
+            {
+                if (jj == 0)
+                    BLASFEO_DMATEL(qp_in->RSQrq + 3, 0, 0) += 1.0;
+                else
+                    BLASFEO_DMATEL(qp_in->BAbt + 7, 0, 1) += 0.1;
+
+                REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+
+                ocp_qp_solver *qp_solver_ref = ocp_qp_create(config, qp_dims, opts_ref);
+                REQUIRE(ocp_qp_solve(qp_solver_ref, qp_in, qp_out_ref) == 0);
+                free(qp_solver_ref);
+
+                double max_diff = ocp_qp_out_max_diff(dims, qp_out, qp_out_ref);
+                printf("\nreuse constant lhs: %s, change %d, max deviation %e\n", solver.c_str(), jj, max_diff);
+                // the change has an effect on the solution, which is only matched if the lhs is condensed again
+                REQUIRE(ocp_qp_out_max_diff(dims, qp_out_ref, qp_out_first) > 1e-6);
+                REQUIRE(max_diff <= solver_tolerance(solver));
+            }
+
+            free(qp_out_ref);
+            free(opts_ref);
+            free(qp_out_first);
+            free(qp_out);
+            free(qp_solver);
+            free(opts);
+            free(qp_in);
+            free(qp_dims);
+            free(config);
+        }
+    }
+}
+
+
+
+#if defined(ACADOS_WITH_HPIPM_SINGLE)
+TEST_CASE("HPIPM mixed precision", "[QP solvers]")
+{
+    // in MIXED precision the QP is solved in single precision and refined in double precision,
+    // the solution has to match the one of the DOUBLE precision solver within the tolerances
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 20;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 2;
+
+    int N2_values[] = {20, 5};
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+    ocp_qp_dims *dims = qp_dims->orig_dims;
+
+    for (int N2 : N2_values)
+    {
+        SECTION("N2 = " + std::to_string(N2))
+        {
+            ocp_qp_out *qp_out_ref = ocp_qp_out_create(dims);
+            ocp_qp_out *qp_out = ocp_qp_out_create(dims);
+
+            char precision_double[] = "DOUBLE";
+            void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+            set_N2("SPARSE_HPIPM", config, opts, N2, N);
+            config->opts_set(config, opts, "precision", precision_double);
+            ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+            REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out_ref) == 0);
+            free(qp_solver);
+            free(opts);
+
+            char precision_mixed[] = "MIXED";
+            opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+            set_N2("SPARSE_HPIPM", config, opts, N2, N);
+            config->opts_set(config, opts, "precision", precision_mixed);
+            qp_solver = ocp_qp_create(config, qp_dims, opts);
+
+            // twice, the second solve reuses the single precision memory of the first one
+            for (int jj = 0; jj < 2; jj++)
+                REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+
+            double max_diff = ocp_qp_out_max_diff(dims, qp_out, qp_out_ref);
+            printf("\nHPIPM mixed precision: N2 = %d, max deviation %e\n", N2, max_diff);
+            REQUIRE(max_diff <= 1e-6);
+
+            free(qp_solver);
+            free(opts);
+            free(qp_out);
+            free(qp_out_ref);
+        }
+    }
+
+    free(qp_in);
+    free(qp_dims);
+    free(config);
+}
+#endif
+
+
+
+#ifdef ACADOS_WITH_OSQP
+// OSQP without condensing, such that the qp_in passed to the solver can change between calls
+typedef struct
+{
+    qp_solver_config *config;
+    void *opts_mem;
+    void *mem_mem;
+    void *work;
+    void *opts;
+    void *mem;
+} osqp_test_solver;
+
+
+
+static void osqp_test_solver_create(qp_solver_config *config, ocp_qp_dims *dims, osqp_test_solver *solver)
+{
+    solver->config = config;
+
+    solver->opts_mem = calloc(1, config->opts_calculate_size(config, dims));
+    solver->opts = config->opts_assign(config, dims, solver->opts_mem);
+    config->opts_initialize_default(config, dims, solver->opts);
+    config->opts_update(config, dims, solver->opts);
+
+    solver->mem_mem = calloc(1, config->memory_calculate_size(config, dims, solver->opts));
+    solver->mem = config->memory_assign(config, dims, solver->opts, solver->mem_mem);
+
+    solver->work = calloc(1, config->workspace_calculate_size(config, dims, solver->opts));
+}
+
+
+
+static int osqp_test_solver_solve(osqp_test_solver *solver, ocp_qp_in *qp_in, ocp_qp_out *qp_out)
+{
+    return solver->config->evaluate(solver->config, qp_in, qp_out, solver->opts, solver->mem, solver->work);
+}
+
+
+
+static void osqp_test_solver_free(osqp_test_solver *solver)
+{
+    solver->config->terminate(solver->config, solver->mem, solver->work);
+    free(solver->work);
+    free(solver->mem_mem);
+    free(solver->opts_mem);
+}
+
+
+
+// changes a few entries of the Hessian and of the constraint matrix
+static void osqp_test_change_entries(ocp_qp_in *qp_in, double delta)
+{
+    int N = qp_in->dim->N;
+    BLASFEO_DMATEL(qp_in->RSQrq + 2, 1, 1) += 5 * delta;
+    BLASFEO_DMATEL(qp_in->RSQrq + 4, 3, 0) += 0.1 * delta;
+    BLASFEO_DMATEL(qp_in->BAbt + 5, 0, 4) += 0.5 * delta;
+    BLASFEO_DMATEL(qp_in->DCt + N, 1, 0) += delta;
+}
+
+
+
+TEST_CASE("OSQP partial matrix update", "[QP solvers]")
+{
+    // after the first solve only the changed nonzeros of P and A are passed to OSQP, the solution
+    // has to match the one of a fresh OSQP setup; a new qp_in has to rebuild the scatter maps
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 2;
+
+    double tol = 1e-6;
+    double res[4];
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_OSQP;
+
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+    ocp_qp_dims *dims = qp_dims->orig_dims;
+    qp_solver_config *osqp = config->qp_solver;
+
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(dims);
+    ocp_qp_in *qp_in_other = create_ocp_qp_in_mass_spring(dims);
+    ocp_qp_out *qp_out = ocp_qp_out_create(dims);
+    ocp_qp_out *qp_out_ref = ocp_qp_out_create(dims);
+
+    osqp_test_solver solver, solver_ref;
+    osqp_test_solver_create(osqp, dims, &solver);
+
+    REQUIRE(osqp_test_solver_solve(&solver, qp_in, qp_out) == 0);
+
+    // 0: subset of the entries changed, same qp_in
+    // 1: other qp_in, the scatter maps are rebuilt
+    // 2: back to the first qp_in
+    for (int jj = 0; jj < 3; jj++)
+    {
+        ocp_qp_in *qp_in_jj = jj == 1 ? qp_in_other : qp_in;
+        if (jj == 0)
+            osqp_test_change_entries(qp_in, 1.0);
+        else if (jj == 1)
+            osqp_test_change_entries(qp_in_other, 2.0);
+
+        REQUIRE(osqp_test_solver_solve(&solver, qp_in_jj, qp_out) == 0);
+
+        osqp_test_solver_create(osqp, dims, &solver_ref);
+        REQUIRE(osqp_test_solver_solve(&solver_ref, qp_in_jj, qp_out_ref) == 0);
+        osqp_test_solver_free(&solver_ref);
+
+        double max_diff = ocp_qp_out_max_diff(dims, qp_out, qp_out_ref);
+        ocp_qp_inf_norm_residuals(dims, qp_in_jj, qp_out, res);
+        double max_res = fmax(fmax(res[0], res[1]), fmax(res[2], res[3]));
+        printf("\nOSQP partial matrix update: case %d, max deviation %e, max residual %e\n", jj, max_diff, max_res);
+        REQUIRE(max_diff <= tol);
+        REQUIRE(max_res <= solver_tolerance("SPARSE_OSQP"));
+    }
+
+    osqp_test_solver_free(&solver);
+
+    free(qp_out_ref);
+    free(qp_out);
+    free(qp_in_other);
+    free(qp_in);
+    free(qp_dims);
+    free(config);
+}
+#endif
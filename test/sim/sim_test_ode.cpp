@@ -604,3 +604,417 @@ TEST_CASE("wt_nx3_example", "[integrators]")
     external_function_casadi_free(&get_matrices_fun);
 
 }  // END_TEST_CASE
+
+
+
+TEST_CASE("wt_nx3_example_irk_step_size_control", "[integrators]")
+{
+    int ii, jj;
+
+    const int nx = 3;
+    const int nu = 4;
+    int NF = nx + nu;  // columns of forward seed
+
+    double T = 0.05;  // simulation time
+
+    double x_ref_sol[nx];
+    double S_forw_ref_sol[nx*NF];
+    double S_adj_ref_sol[NF];
+
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+    ext_fun_opts.external_workspace = true;
+
+    // impl_ode_fun
+    external_function_casadi impl_ode_fun;
+    impl_ode_fun.casadi_fun = &casadi_impl_ode_fun;
+    impl_ode_fun.casadi_work = &casadi_impl_ode_fun_work;
+    impl_ode_fun.casadi_sparsity_in = &casadi_impl_ode_fun_sparsity_in;
+    impl_ode_fun.casadi_sparsity_out = &casadi_impl_ode_fun_sparsity_out;
+    impl_ode_fun.casadi_n_in = &casadi_impl_ode_fun_n_in;
+    impl_ode_fun.casadi_n_out = &casadi_impl_ode_fun_n_out;
+    external_function_casadi_create(&impl_ode_fun, &ext_fun_opts);
+
+    // impl_ode_fun_jac_x_xdot
+    external_function_casadi impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_fun = &casadi_impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_work = &casadi_impl_ode_fun_jac_x_xdot_work;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_in = &casadi_impl_ode_fun_jac_x_xdot_sparsity_in;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_out = &casadi_impl_ode_fun_jac_x_xdot_sparsity_out;
+    impl_ode_fun_jac_x_xdot.casadi_n_in = &casadi_impl_ode_fun_jac_x_xdot_n_in;
+    impl_ode_fun_jac_x_xdot.casadi_n_out = &casadi_impl_ode_fun_jac_x_xdot_n_out;
+    external_function_casadi_create(&impl_ode_fun_jac_x_xdot, &ext_fun_opts);
+
+    // impl_ode_jac_x_xdot_u
+    external_function_casadi impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_fun = &casadi_impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_work = &casadi_impl_ode_jac_x_xdot_u_work;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_in = &casadi_impl_ode_jac_x_xdot_u_sparsity_in;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_out = &casadi_impl_ode_jac_x_xdot_u_sparsity_out;
+    impl_ode_jac_x_xdot_u.casadi_n_in = &casadi_impl_ode_jac_x_xdot_u_n_in;
+    impl_ode_jac_x_xdot_u.casadi_n_out = &casadi_impl_ode_jac_x_xdot_u_n_out;
+    external_function_casadi_create(&impl_ode_jac_x_xdot_u, &ext_fun_opts);
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = IRK;
+
+    // first run: fixed step reference solution, second run: adaptive step size
+    for (int adaptive = 0; adaptive < 2; adaptive++)
+    {
+        sim_config *config = sim_config_create(plan);
+        void *dims = sim_dims_create(config);
+        sim_dims_set(config, dims, "nx", &nx);
+        sim_dims_set(config, dims, "nu", &nu);
+
+        void *opts_ = sim_opts_create(config, dims);
+        sim_opts *opts = (sim_opts *) opts_;
+
+        opts->sens_forw = true;
+        opts->sens_adj = true;
+        opts->jac_reuse = false;
+        opts->newton_iter = 5;
+        opts->ns = 5;
+        opts->num_steps = 10;
+
+        if (adaptive)
+        {
+            bool step_size_control = true;
+            int max_num_steps = 20;
+            double tol = 1e-10;
+            sim_opts_set(config, opts, "step_size_control", &step_size_control);
+            sim_opts_set(config, opts, "max_num_steps", &max_num_steps);
+            sim_opts_set(config, opts, "step_abs_tol", &tol);
+            sim_opts_set(config, opts, "step_rel_tol", &tol);
+            opts->ns = 3;
+            opts->num_steps = 1;  // initial step size T
+        }
+
+        sim_in *in = sim_in_create(config, dims);
+        sim_out *out = sim_out_create(config, dims);
+
+        in->T = T;
+
+        sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+        sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot);
+        sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+
+        for (ii = 0; ii < nx * NF; ii++)
+            in->S_forw[ii] = 0.0;
+        for (ii = 0; ii < nx; ii++)
+            in->S_forw[ii * (nx + 1)] = 1.0;
+        in->identity_seed = true;
+
+        for (ii = 0; ii < nx; ii++)
+            in->S_adj[ii] = 1.0;
+
+        for (jj = 0; jj < nx; jj++)
+            in->x[jj] = x0[jj];
+        for (jj = 0; jj < nu; jj++)
+            in->u[jj] = u_sim[jj];
+
+        sim_solver *sim_solver = sim_solver_create(config, dims, opts, in);
+
+        int acados_return = sim_solve(sim_solver, in, out);
+        REQUIRE(acados_return == 0);
+
+        int num_steps;
+        sim_out_get(config, dims, out, "num_steps", &num_steps);
+
+        if (!adaptive)
+        {
+            REQUIRE(num_steps == 10);
+            for (jj = 0; jj < nx; jj++)
+                x_ref_sol[jj] = out->xn[jj];
+            for (jj = 0; jj < nx*NF; jj++)
+                S_forw_ref_sol[jj] = out->S_forw[jj];
+            for (jj = 0; jj < NF; jj++)
+                S_adj_ref_sol[jj] = out->S_adj[jj];
+        }
+        else
+        {
+            int num_rejected_steps;
+            sim_out_get(config, dims, out, "num_rejected_steps", &num_rejected_steps);
+            std::cout << "\n---> sim_test_ode: IRK with step size control, num_steps = "
+                      << num_steps << ", num_rejected_steps = " << num_rejected_steps << "\n";
+
+            REQUIRE(num_steps >= 1);
+            REQUIRE(num_steps <= 20);
+
+            double max_error = 0.0;
+            for (jj = 0; jj < nx; jj++)
+                max_error = fmax(max_error, fabs(out->xn[jj] - x_ref_sol[jj]));
+            double max_error_forw = 0.0;
+            for (jj = 0; jj < nx*NF; jj++)
+                max_error_forw = fmax(max_error_forw, fabs(out->S_forw[jj] - S_forw_ref_sol[jj]));
+            double max_error_adj = 0.0;
+            for (jj = 0; jj < NF; jj++)
+                max_error_adj = fmax(max_error_adj, fabs(out->S_adj[jj] - S_adj_ref_sol[jj]));
+
+            std::cout  << "error_sim   = " << max_error << "\n";
+            std::cout  << "error_forw  = " << max_error_forw << "\n";
+            std::cout  << "error_adj   = " << max_error_adj << "\n";
+
+            REQUIRE(max_error <= 1e-7);
+            REQUIRE(max_error_forw <= 1e-6);
+            REQUIRE(max_error_adj <= 1e-6);
+        }
+
+        sim_config_destroy(config);
+        sim_dims_destroy(dims);
+        sim_opts_destroy(opts);
+
+        sim_in_destroy(in);
+        sim_out_destroy(out);
+        sim_solver_destroy(sim_solver);
+    }
+
+    external_function_casadi_free(&impl_ode_fun);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&impl_ode_jac_x_xdot_u);
+
+}  // END_TEST_CASE
+
+
+
+TEST_CASE("wt_nx3_example_irk_step_size_control_nan", "[integrators]")
+{
+    // a NaN input makes the model evaluate to NaN: the step size controller has to terminate
+    const int nx = 3;
+    const int nu = 4;
+    int max_num_steps = 20;
+
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+    ext_fun_opts.external_workspace = true;
+
+    // impl_ode_fun
+    external_function_casadi impl_ode_fun;
+    impl_ode_fun.casadi_fun = &casadi_impl_ode_fun;
+    impl_ode_fun.casadi_work = &casadi_impl_ode_fun_work;
+    impl_ode_fun.casadi_sparsity_in = &casadi_impl_ode_fun_sparsity_in;
+    impl_ode_fun.casadi_sparsity_out = &casadi_impl_ode_fun_sparsity_out;
+    impl_ode_fun.casadi_n_in = &casadi_impl_ode_fun_n_in;
+    impl_ode_fun.casadi_n_out = &casadi_impl_ode_fun_n_out;
+    external_function_casadi_create(&impl_ode_fun, &ext_fun_opts);
+
+    // impl_ode_fun_jac_x_xdot
+    external_function_casadi impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_fun = &casadi_impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_work = &casadi_impl_ode_fun_jac_x_xdot_work;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_in = &casadi_impl_ode_fun_jac_x_xdot_sparsity_in;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_out = &casadi_impl_ode_fun_jac_x_xdot_sparsity_out;
+    impl_ode_fun_jac_x_xdot.casadi_n_in = &casadi_impl_ode_fun_jac_x_xdot_n_in;
+    impl_ode_fun_jac_x_xdot.casadi_n_out = &casadi_impl_ode_fun_jac_x_xdot_n_out;
+    external_function_casadi_create(&impl_ode_fun_jac_x_xdot, &ext_fun_opts);
+
+    // impl_ode_jac_x_xdot_u
+    external_function_casadi impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_fun = &casadi_impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_work = &casadi_impl_ode_jac_x_xdot_u_work;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_in = &casadi_impl_ode_jac_x_xdot_u_sparsity_in;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_out = &casadi_impl_ode_jac_x_xdot_u_sparsity_out;
+    impl_ode_jac_x_xdot_u.casadi_n_in = &casadi_impl_ode_jac_x_xdot_u_n_in;
+    impl_ode_jac_x_xdot_u.casadi_n_out = &casadi_impl_ode_jac_x_xdot_u_n_out;
+    external_function_casadi_create(&impl_ode_jac_x_xdot_u, &ext_fun_opts);
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = IRK;
+
+    sim_config *config = sim_config_create(plan);
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx);
+    sim_dims_set(config, dims, "nu", &nu);
+
+    void *opts_ = sim_opts_create(config, dims);
+    sim_opts *opts = (sim_opts *) opts_;
+
+    opts->sens_forw = false;
+    opts->sens_adj = false;
+    opts->jac_reuse = false;
+    opts->newton_iter = 5;
+    opts->ns = 3;
+    opts->num_steps = 1;
+
+    bool step_size_control = true;
+    double tol = 1e-10;
+    sim_opts_set(config, opts, "step_size_control", &step_size_control);
+    sim_opts_set(config, opts, "max_num_steps", &max_num_steps);
+    sim_opts_set(config, opts, "step_abs_tol", &tol);
+    sim_opts_set(config, opts, "step_rel_tol", &tol);
+
+    sim_in *in = sim_in_create(config, dims);
+    sim_out *out = sim_out_create(config, dims);
+
+    in->T = 0.05;
+
+    sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+    sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot);
+    sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+
+    for (int jj = 0; jj < nx; jj++)
+        in->x[jj] = x0[jj];
+    for (int jj = 0; jj < nu; jj++)
+        in->u[jj] = u_sim[jj];
+    in->u[0] = NAN;
+
+    sim_solver *sim_solver = sim_solver_create(config, dims, opts, in);
+
+    int acados_return = sim_solve(sim_solver, in, out);
+    REQUIRE(acados_return == ACADOS_NAN_DETECTED);
+
+    int num_steps, num_rejected_steps;
+    sim_out_get(config, dims, out, "num_steps", &num_steps);
+    sim_out_get(config, dims, out, "num_rejected_steps", &num_rejected_steps);
+    std::cout << "\n---> sim_test_ode: IRK with step size control and NaN input, num_steps = "
+              << num_steps << ", num_rejected_steps = " << num_rejected_steps << "\n";
+
+    REQUIRE(num_steps <= max_num_steps);
+    // bounded by the rejections per step
+    REQUIRE(num_rejected_steps <= 20 * max_num_steps);
+
+    sim_config_destroy(config);
+    sim_dims_destroy(dims);
+    sim_opts_destroy(opts);
+
+    sim_in_destroy(in);
+    sim_out_destroy(out);
+    sim_solver_destroy(sim_solver);
+
+    external_function_casadi_free(&impl_ode_fun);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&impl_ode_jac_x_xdot_u);
+
+}  // END_TEST_CASE
+
+
+
+TEST_CASE("wt_nx3_example_irk_jac_reuse_across_calls", "[integrators]")
+{
+    // closed loop simulation: with the Newton matrix factorization of the previous call,
+    // the states have to match the ones with a fresh factorization in every call
+    const int nx = 3;
+    const int nu = 4;
+    const int n_sim = 20;
+    const int i_jump = 10;  // large state jump, the stored factorization does not contract
+
+    double x_ref[n_sim][nx];
+    int num_factorizations_total[2] = {0, 0};
+
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+    ext_fun_opts.external_workspace = true;
+
+    // impl_ode_fun
+    external_function_casadi impl_ode_fun;
+    impl_ode_fun.casadi_fun = &casadi_impl_ode_fun;
+    impl_ode_fun.casadi_work = &casadi_impl_ode_fun_work;
+    impl_ode_fun.casadi_sparsity_in = &casadi_impl_ode_fun_sparsity_in;
+    impl_ode_fun.casadi_sparsity_out = &casadi_impl_ode_fun_sparsity_out;
+    impl_ode_fun.casadi_n_in = &casadi_impl_ode_fun_n_in;
+    impl_ode_fun.casadi_n_out = &casadi_impl_ode_fun_n_out;
+    external_function_casadi_create(&impl_ode_fun, &ext_fun_opts);
+
+    // impl_ode_fun_jac_x_xdot
+    external_function_casadi impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_fun = &casadi_impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_work = &casadi_impl_ode_fun_jac_x_xdot_work;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_in = &casadi_impl_ode_fun_jac_x_xdot_sparsity_in;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_out = &casadi_impl_ode_fun_jac_x_xdot_sparsity_out;
+    impl_ode_fun_jac_x_xdot.casadi_n_in = &casadi_impl_ode_fun_jac_x_xdot_n_in;
+    impl_ode_fun_jac_x_xdot.casadi_n_out = &casadi_impl_ode_fun_jac_x_xdot_n_out;
+    external_function_casadi_create(&impl_ode_fun_jac_x_xdot, &ext_fun_opts);
+
+    // impl_ode_jac_x_xdot_u
+    external_function_casadi impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_fun = &casadi_impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_work = &casadi_impl_ode_jac_x_xdot_u_work;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_in = &casadi_impl_ode_jac_x_xdot_u_sparsity_in;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_out = &casadi_impl_ode_jac_x_xdot_u_sparsity_out;
+    impl_ode_jac_x_xdot_u.casadi_n_in = &casadi_impl_ode_jac_x_xdot_u_n_in;
+    impl_ode_jac_x_xdot_u.casadi_n_out = &casadi_impl_ode_jac_x_xdot_u_n_out;
+    external_function_casadi_create(&impl_ode_jac_x_xdot_u, &ext_fun_opts);
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = IRK;
+
+    // first run: fresh factorization in every call, second run: reuse across calls
+    for (int reuse = 0; reuse < 2; reuse++)
+    {
+        sim_config *config = sim_config_create(plan);
+        void *dims = sim_dims_create(config);
+        sim_dims_set(config, dims, "nx", &nx);
+        sim_dims_set(config, dims, "nu", &nu);
+
+        void *opts_ = sim_opts_create(config, dims);
+        sim_opts *opts = (sim_opts *) opts_;
+
+        opts->sens_forw = false;
+        opts->sens_adj = false;
+        opts->jac_reuse = true;
+        opts->newton_iter = 8;
+        opts->newton_tol = 1e-12;
+        opts->ns = 3;
+        opts->num_steps = 2;
+
+        bool jac_reuse_across_calls = reuse;
+        sim_opts_set(config, opts, "jac_reuse_across_calls", &jac_reuse_across_calls);
+
+        sim_in *in = sim_in_create(config, dims);
+        sim_out *out = sim_out_create(config, dims);
+
+        in->T = 0.05;
+
+        sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+        sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot);
+        sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+
+        for (int jj = 0; jj < nx; jj++)
+            in->x[jj] = x0[jj];
+        for (int jj = 0; jj < nu; jj++)
+            in->u[jj] = u_sim[jj];
+
+        sim_solver *sim_solver = sim_solver_create(config, dims, opts, in);
+
+        for (int ii = 0; ii < n_sim; ii++)
+        {
+            if (ii == i_jump)
+            {
+                for (int jj = 0; jj < nx; jj++)
+                    in->x[jj] *= 1.5;
+            }
+
+            int acados_return = sim_solve(sim_solver, in, out);
+            REQUIRE(acados_return == 0);
+
+            int num_factorizations;
+            sim_out_get(config, dims, out, "num_factorizations", &num_factorizations);
+            num_factorizations_total[reuse] += num_factorizations;
+
+            for (int jj = 0; jj < nx; jj++)
+            {
+                if (!reuse)
+                    x_ref[ii][jj] = out->xn[jj];
+                else
+                    REQUIRE(fabs(out->xn[jj] - x_ref[ii][jj]) <= 1e-9 * (1.0 + fabs(x_ref[ii][jj])));
+                in->x[jj] = out->xn[jj];
+            }
+        }
+
+        sim_config_destroy(config);
+        sim_dims_destroy(dims);
+        sim_opts_destroy(opts);
+
+        sim_in_destroy(in);
+        sim_out_destroy(out);
+        sim_solver_destroy(sim_solver);
+    }
+
+    std::cout << "\n---> sim_test_ode: IRK jac_reuse_across_calls, num_factorizations = "
+              << num_factorizations_total[1] << " (" << num_factorizations_total[0] << " without reuse)\n";
+    REQUIRE(num_factorizations_total[1] < num_factorizations_total[0]);
+
+    external_function_casadi_free(&impl_ode_fun);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&impl_ode_jac_x_xdot_u);
+
+}  // END_TEST_CASE
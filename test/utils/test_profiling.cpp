@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "catch/include/catch.hpp"
+
+#include "acados/ocp_nlp/ocp_nlp_profiling.h"
+#include "acados/utils/timing.h"
+
+using std::string;
+using std::vector;
+
+namespace
+{
+
+const int N = 3;
+const int CAPACITY = 4;
+const int NUM_CALLS = 2;
+const int NUM_ITER = 3;
+
+// records every stage slot and every global slot of the open record, like the NLP solver
+void profiling_test_iteration(ocp_nlp_profiling *prof)
+{
+    for (int module = 0; module < OCP_NLP_PROFILING_NUM_MODULES; module++)
+    {
+        int num_stages = module < OCP_NLP_PROFILING_NUM_STAGE_MODULES ? N+1 : 1;
+        for (int i = 0; i < num_stages; i++)
+        {
+            acados_timer timer, probe;
+            acados_tic(&timer);
+            // make sure a measurable amount of time passes
+            acados_tic(&probe);
+            while (acados_toc(&probe) < 1e-6) {}
+            ocp_nlp_profiling_record(prof, (ocp_nlp_profiling_module) module, i, &timer);
+        }
+    }
+}
+
+// minimal recursive descent JSON validator
+struct json_parser
+{
+    const string &s;
+    size_t pos;
+
+    explicit json_parser(const string &s_) : s(s_), pos(0) {}
+
+    void skip_ws()
+    {
+        while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\n' || s[pos] == '\r' || s[pos] == '\t'))
+            pos++;
+    }
+
+    bool literal(const char *lit)
+    {
+        string l(lit);
+        if (s.compare(pos, l.size(), l) != 0)
+            return false;
+        pos += l.size();
+        return true;
+    }
+
+    bool string_value()
+    {
+        if (pos >= s.size() || s[pos] != '"')
+            return false;
+        pos++;
+        while (pos < s.size() && s[pos] != '"')
+        {
+            if (s[pos] == '\\')
+                pos++;
+            pos++;
+        }
+        if (pos >= s.size())
+            return false;
+        pos++;
+        return true;
+    }
+
+    bool number()
+    {
+        size_t start = pos;
+        if (pos < s.size() && s[pos] == '-')
+            pos++;
+        while (pos < s.size() && (isdigit(s[pos]) || s[pos] == '.' || s[pos] == 'e' || s[pos] == 'E'
+                                  || s[pos] == '+' || s[pos] == '-'))
+            pos++;
+        return pos > start && isdigit(s[pos-1]);
+    }
+
+    bool value()
+    {
+        skip_ws();
+        if (pos >= s.size())
+            return false;
+        char c = s[pos];
+        if (c == '{')
+            return object();
+        if (c == '[')
+            return array();
+        if (c == '"')
+            return string_value();
+        if (c == 't')
+            return literal("true");
+        if (c == 'f')
+            return literal("false");
+        if (c == 'n')
+            return literal("null");
+        return number();
+    }
+
+    bool object()
+    {
+        pos++;  // {
+        skip_ws();
+        if (pos < s.size() && s[pos] == '}')
+        {
+            pos++;
+            return true;
+        }
+        while (true)
+        {
+            skip_ws();
+            if (!string_value())
+                return false;
+            skip_ws();
+            if (pos >= s.size() || s[pos] != ':')
+                return false;
+            pos++;
+            if (!value())
+                return false;
+            skip_ws();
+            if (pos < s.size() && s[pos] == ',')
+            {
+                pos++;
+                continue;
+            }
+            if (pos < s.size() && s[pos] == '}')
+            {
+                pos++;
+                return true;
+            }
+            return false;
+        }
+    }
+
+    bool array()
+    {
+        pos++;  // [
+        skip_ws();
+        if (pos < s.size() && s[pos] == ']')
+        {
+            pos++;
+            return true;
+        }
+        while (true)
+        {
+            if (!value())
+                return false;
+            skip_ws();
+            if (pos < s.size() && s[pos] == ',')
+            {
+                pos++;
+                continue;
+            }
+            if (pos < s.size() && s[pos] == ']')
+            {
+                pos++;
+                return true;
+            }
+            return false;
+        }
+    }
+
+    bool document()
+    {
+        if (!value())
+            return false;
+        skip_ws();
+        return pos == s.size();
+    }
+};
+
+int count_occurrences(const string &s, const string &sub)
+{
+    int count = 0;
+    for (size_t p = s.find(sub); p != string::npos; p = s.find(sub, p + sub.size()))
+        count++;
+    return count;
+}
+
+}  // namespace
+
+
+
+TEST_CASE("ocp_nlp_profiling_ring_buffer", "[utils]")
+{
+    vector<char> raw(ocp_nlp_profiling_calculate_size(N, CAPACITY));
+    ocp_nlp_profiling *prof = ocp_nlp_profiling_assign(N, CAPACITY, raw.data());
+
+    int num_slots = 0, capacity = 0, num_records = -1;
+    ocp_nlp_profiling_get(prof, "num_slots", &num_slots);
+    ocp_nlp_profiling_get(prof, "capacity", &capacity);
+    ocp_nlp_profiling_get(prof, "num_records", &num_records);
+    REQUIRE(num_slots == OCP_NLP_PROFILING_NUM_STAGE_MODULES * (N+1)
+                         + OCP_NLP_PROFILING_NUM_MODULES - OCP_NLP_PROFILING_NUM_STAGE_MODULES);
+    REQUIRE(capacity == CAPACITY);
+    REQUIRE(num_records == 0);
+
+    // measurements outside of an open record are dropped
+    ocp_nlp_profiling_new_call(prof);
+    profiling_test_iteration(prof);
+    ocp_nlp_profiling_get(prof, "num_records", &num_records);
+    REQUIRE(num_records == 0);
+
+    // call 1 fills part of the buffer
+    for (int iter = 0; iter < NUM_ITER; iter++)
+    {
+        ocp_nlp_profiling_new_iter(prof, iter);
+        profiling_test_iteration(prof);
+    }
+    ocp_nlp_profiling_get(prof, "num_records", &num_records);
+    REQUIRE(num_records == NUM_ITER);
+
+    vector<int> call(CAPACITY), iter(CAPACITY);
+    ocp_nlp_profiling_get(prof, "call", call.data());
+    ocp_nlp_profiling_get(prof, "iter", iter.data());
+    for (int k = 0; k < NUM_ITER; k++)
+    {
+        REQUIRE(call[k] == 1);
+        REQUIRE(iter[k] == k);
+    }
+
+    // call 2 wraps around, the oldest records are overwritten
+    ocp_nlp_profiling_new_call(prof);
+    for (int it = 0; it < NUM_ITER; it++)
+    {
+        ocp_nlp_profiling_new_iter(prof, it);
+        profiling_test_iteration(prof);
+    }
+    ocp_nlp_profiling_get(prof, "num_records", &num_records);
+    REQUIRE(num_records == CAPACITY);
+
+    ocp_nlp_profiling_get(prof, "call", call.data());
+    ocp_nlp_profiling_get(prof, "iter", iter.data());
+    // kept: last CAPACITY of (1,0) (1,1) (1,2) (2,0) (2,1) (2,2), oldest first
+    int total = NUM_CALLS * NUM_ITER;
+    for (int k = 0; k < CAPACITY; k++)
+    {
+        int record = total - CAPACITY + k;
+        REQUIRE(call[k] == 1 + record / NUM_ITER);
+        REQUIRE(iter[k] == record % NUM_ITER);
+    }
+
+    vector<double> start(CAPACITY * num_slots), duration(CAPACITY * num_slots);
+    ocp_nlp_profiling_get(prof, "start", start.data());
+    ocp_nlp_profiling_get(prof, "duration", duration.data());
+    for (int k = 0; k < CAPACITY; k++)
+    {
+        // every stage slot and every global slot was measured
+        for (int module = 0; module < OCP_NLP_PROFILING_NUM_MODULES; module++)
+        {
+            int num_stages = module < OCP_NLP_PROFILING_NUM_STAGE_MODULES ? N+1 : 1;
+            for (int i = 0; i < num_stages; i++)
+            {
+                int slot = ocp_nlp_profiling_slot(prof, (ocp_nlp_profiling_module) module, i);
+                REQUIRE(slot >= 0);
+                REQUIRE(slot < num_slots);
+                REQUIRE(duration[k*num_slots+slot] > 0.0);
+                REQUIRE(start[k*num_slots+slot] >= 0.0);
+            }
+        }
+        // records are returned in chronological order
+        if (k > 0)
+            REQUIRE(start[k*num_slots] > start[(k-1)*num_slots]);
+    }
+}
+
+
+
+TEST_CASE("ocp_nlp_profiling_trace", "[utils]")
+{
+    vector<char> raw(ocp_nlp_profiling_calculate_size(N, CAPACITY));
+    ocp_nlp_profiling *prof = ocp_nlp_profiling_assign(N, CAPACITY, raw.data());
+
+    ocp_nlp_profiling_new_call(prof);
+    for (int iter = 0; iter < CAPACITY + 1; iter++)
+    {
+        ocp_nlp_profiling_new_iter(prof, iter);
+        profiling_test_iteration(prof);
+    }
+
+    const char *filename = "ocp_nlp_profiling_test_trace.json";
+    REQUIRE(ocp_nlp_profiling_write_trace(prof, filename) == 0);
+
+    std::ifstream file(filename);
+    REQUIRE(file.good());
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    file.close();
+    std::remove(filename);
+    string trace = buffer.str();
+
+    json_parser parser(trace);
+    REQUIRE(parser.document());
+
+    // one complete event per kept record and slot, one track per stage plus the solver track
+    int num_slots = 0;
+    ocp_nlp_profiling_get(prof, "num_slots", &num_slots);
+    REQUIRE(count_occurrences(trace, "\"ph\": \"X\"") == CAPACITY * num_slots);
+    REQUIRE(count_occurrences(trace, "\"ph\": \"M\"") == N+2);
+    REQUIRE(count_occurrences(trace, "\"iter\": 0}") == 0);
+    REQUIRE(count_occurrences(trace, "\"iter\": " + std::to_string(CAPACITY) + "}") == num_slots);
+
+    // an empty buffer gives a valid trace as well
+    vector<char> raw_empty(ocp_nlp_profiling_calculate_size(N, CAPACITY));
+    ocp_nlp_profiling *prof_empty = ocp_nlp_profiling_assign(N, CAPACITY, raw_empty.data());
+    REQUIRE(ocp_nlp_profiling_write_trace(prof_empty, filename) == 0);
+    std::ifstream file_empty(filename);
+    std::stringstream buffer_empty;
+    buffer_empty << file_empty.rdbuf();
+    file_empty.close();
+    std::remove(filename);
+    string trace_empty = buffer_empty.str();
+    json_parser parser_empty(trace_empty);
+    REQUIRE(parser_empty.document());
+    REQUIRE(count_occurrences(trace_empty, "\"ph\": \"X\"") == 0);
+}
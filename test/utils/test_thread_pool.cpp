@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+
+#include <atomic>
+#include <vector>
+
+#include "catch/include/catch.hpp"
+
+#include "acados/utils/thread_pool.h"
+
+using std::vector;
+
+namespace
+{
+
+const int NUM_TASKS = 37;
+const int NUM_PHASES = 3;
+
+struct pool_test_ctx
+{
+    std::atomic<int> count[NUM_PHASES][NUM_TASKS];
+    int value[NUM_PHASES][NUM_TASKS];
+    int missing[NUM_PHASES];  // results of the previous phase not visible when a task ran
+};
+
+void pool_test_task(void *ctx_, int phase, int index)
+{
+    pool_test_ctx *ctx = static_cast<pool_test_ctx *>(ctx_);
+    ctx->count[phase][index]++;
+    if (phase > 0)
+    {
+        // all tasks of the previous phase have to be done before any task of this phase starts
+        for (int i = 0; i < NUM_TASKS; i++)
+            if (ctx->value[phase-1][i] != (phase-1) * NUM_TASKS + i + 1)
+                __atomic_fetch_add(&ctx->missing[phase], 1, __ATOMIC_RELAXED);
+    }
+    ctx->value[phase][index] = phase * NUM_TASKS + index + 1;
+}
+
+void reset_ctx(pool_test_ctx *ctx)
+{
+    for (int p = 0; p < NUM_PHASES; p++)
+    {
+        ctx->missing[p] = 0;
+        for (int i = 0; i < NUM_TASKS; i++)
+        {
+            ctx->count[p][i] = 0;
+            ctx->value[p][i] = 0;
+        }
+    }
+}
+
+}  // namespace
+
+
+
+TEST_CASE("thread_pool_run", "[utils]")
+{
+    vector<int> num_threads_list = {1, 2, 4, 8};
+    pool_test_ctx ctx;
+
+    for (int num_threads : num_threads_list)
+    {
+        SECTION("num_threads = " + std::to_string(num_threads))
+        {
+            int max_jobs = 2;
+            acados_thread_pool *pool = acados_thread_pool_create(num_threads, NULL,
+                                ACADOS_THREAD_POOL_DEFAULT_SPIN_COUNT, max_jobs, NUM_TASKS);
+            REQUIRE(pool != NULL);
+            REQUIRE(acados_thread_pool_get_num_threads(pool) == num_threads);
+
+            // repeated runs of both jobs, the partition is rebalanced after every run
+            for (int run = 0; run < 50; run++)
+            {
+                int job = run % max_jobs;
+                reset_ctx(&ctx);
+                acados_thread_pool_run(pool, job, NUM_PHASES, NUM_TASKS, pool_test_task, &ctx);
+
+                for (int p = 0; p < NUM_PHASES; p++)
+                {
+                    // every (phase, index) task runs exactly once
+                    for (int i = 0; i < NUM_TASKS; i++)
+                    {
+                        REQUIRE(ctx.count[p][i] == 1);
+                        REQUIRE(ctx.value[p][i] == p * NUM_TASKS + i + 1);
+                    }
+                    // barrier between phases
+                    REQUIRE(ctx.missing[p] == 0);
+                }
+            }
+
+            // fewer tasks than max_tasks
+            reset_ctx(&ctx);
+            acados_thread_pool_run(pool, 0, 1, 5, pool_test_task, &ctx);
+            for (int i = 0; i < NUM_TASKS; i++)
+                REQUIRE(ctx.count[0][i] == (i < 5 ? 1 : 0));
+
+            // empty jobs return without running a task, the pool stays usable
+            reset_ctx(&ctx);
+            acados_thread_pool_run(pool, 0, 0, NUM_TASKS, pool_test_task, &ctx);
+            acados_thread_pool_run(pool, 1, NUM_PHASES, 0, pool_test_task, &ctx);
+            for (int i = 0; i < NUM_TASKS; i++)
+                REQUIRE(ctx.count[0][i] == 0);
+            acados_thread_pool_run(pool, 0, 1, NUM_TASKS, pool_test_task, &ctx);
+            for (int i = 0; i < NUM_TASKS; i++)
+                REQUIRE(ctx.count[0][i] == 1);
+
+            acados_thread_pool_destroy(pool);
+        }
+    }
+}
+
+
+
+TEST_CASE("thread_pool_serial_fallback", "[utils]")
+{
+    // jobs outside of the pool size run serially on the calling thread
+    pool_test_ctx ctx;
+    acados_thread_pool *pool = acados_thread_pool_create(4, NULL, 0, 1, NUM_TASKS);
+    REQUIRE(pool != NULL);
+
+    reset_ctx(&ctx);
+    acados_thread_pool_run(pool, 1, NUM_PHASES, NUM_TASKS, pool_test_task, &ctx);
+    for (int p = 0; p < NUM_PHASES; p++)
+    {
+        for (int i = 0; i < NUM_TASKS; i++)
+            REQUIRE(ctx.count[p][i] == 1);
+        REQUIRE(ctx.missing[p] == 0);
+    }
+
+    acados_thread_pool_destroy(pool);
+}